@@ -58,6 +58,7 @@ namespace CommandIDs
     static const int audioPlayPause     = 0x2206;
     static const int audioStemsSetup     = 0x2207;
     static const int audioStemsStartStop = 0x2208;
+    static const int audioRealtimeStatus = 0x2209;
 
     static const int appToolbar         = 0x2400;
     static const int appBrowser         = 0x2401;
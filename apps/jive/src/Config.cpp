@@ -110,6 +110,19 @@ void Config::read ()
     firstTime = config->getIntValue (T("first_time"), 1);
     realTime = config->getIntValue (T("real_time"), 0);
 
+    // realtime policy of the threads
+    for (int i = 0; i < RealtimePolicy::numThreadRoles; i++)
+    {
+        const RealtimePolicy::ThreadRole role = (RealtimePolicy::ThreadRole) i;
+        const String prefix (T("real_time_") + RealtimePolicy::getRoleName (role));
+
+        threadPriorities [i] = config->getIntValue (prefix + T("_priority"), RealtimePolicy::getRolePriority (role));
+        threadAffinities [i] = config->getIntValue (prefix + T("_affinity"), 0);
+    }
+    lockMemory = config->getBoolValue (T("real_time_lock_memory"), true);
+    prefaultStackKb = config->getIntValue (T("real_time_prefault_stack_kb"), 64);
+    prefaultHeapKb = config->getIntValue (T("real_time_prefault_heap_kb"), 4096);
+
     // toolbar set items
     toolbarSet = config->getValue (T("toolbar_set"), String::empty);
 
@@ -168,6 +181,16 @@ void Config::write ()
     config->setValue (T("version"), JucePlugin_VersionCode);
     config->setValue (T("first_time"), 0);
     config->setValue (T("real_time"), realTime);
+    for (int i = 0; i < RealtimePolicy::numThreadRoles; i++)
+    {
+        const String prefix (T("real_time_") + RealtimePolicy::getRoleName ((RealtimePolicy::ThreadRole) i));
+
+        config->setValue (prefix + T("_priority"), threadPriorities [i]);
+        config->setValue (prefix + T("_affinity"), threadAffinities [i]);
+    }
+    config->setValue (T("real_time_lock_memory"), lockMemory);
+    config->setValue (T("real_time_prefault_stack_kb"), prefaultStackKb);
+    config->setValue (T("real_time_prefault_heap_kb"), prefaultHeapKb);
     config->setValue (T("toolbar_set"), toolbarSet);
     config->setValue (T("recent_plugins"), recentPlugins.toString());
     config->setValue (T("last_plugins_directory"), lastPluginDirectory.getFullPathName());
@@ -194,6 +217,30 @@ void Config::write ()
     ApplicationProperties::getInstance()->saveIfNeeded ();
 }
 
+//==============================================================================
+void Config::applyRealtimePolicy ()
+{
+    for (int i = 0; i < RealtimePolicy::numThreadRoles; i++)
+    {
+        const RealtimePolicy::ThreadRole role = (RealtimePolicy::ThreadRole) i;
+
+        RealtimePolicy::setRolePriority (role, threadPriorities [i]);
+        RealtimePolicy::setRoleAffinity (role, (uint32) threadAffinities [i]);
+    }
+
+    RealtimePolicy::setStackPrefaultSize (prefaultStackKb * 1024);
+    RealtimePolicy::setEnabled (realTime);
+
+    if (realTime)
+    {
+        // lock before the audio threads start, so their stacks get locked too
+        if (lockMemory)
+            RealtimePolicy::lockMemory (prefaultHeapKb * 1024);
+
+        RealtimePolicy::applyToCurrentThread (RealtimePolicy::guiThread);
+    }
+}
+
 //==============================================================================
 PropertySet* Config::getGlobalSettings()
 {
@@ -239,6 +239,15 @@ public:
     /** First time & process info */
     bool firstTime;
     bool realTime;
+
+    /** Realtime policy of the threads, used when realTime is on. A priority
+        of 0 leaves a role on the normal scheduler, an affinity of 0 lets it
+        run on any cpu */
+    int threadPriorities [RealtimePolicy::numThreadRoles];
+    int threadAffinities [RealtimePolicy::numThreadRoles];
+    bool lockMemory;
+    int prefaultStackKb;
+    int prefaultHeapKb;
     
 //    /** pattern sequencer params **/
 //    int maxPatternsPerPart;
@@ -249,6 +258,11 @@ public:
     void addRecentSession (const File& file);
     void addRecentPreset (const File& file);
 
+    //==============================================================================
+    /** Sets up the threads realtime policy from the settings, and applies it
+        to the calling thread as the gui thread */
+    void applyRealtimePolicy ();
+
     //==============================================================================
     Colour getColour (const String& name, const Colour& defColour = Colours::white) const;
     void setColour (const String& name, const Colour& newColour);
@@ -138,6 +138,13 @@ HostFilterComponent::HostFilterComponent (HostFilterBase* const ownerFilter_)
     knownPluginList.addChangeListener (this);
     pluginSortMethod = (KnownPluginList::SortMethod) ApplicationProperties::getInstance()->getUserSettings()
                             ->getIntValue (T("pluginSortMethod"), KnownPluginList::sortByManufacturer);
+
+    numRejectedPoliciesShown = 0;
+
+#ifndef JOST_VST_PLUGIN
+    // threads keep applying their roles as they start, so keep an eye on refusals
+    startTimer (1000);
+#endif
 }
 
 //==============================================================================
@@ -145,6 +152,8 @@ HostFilterComponent::~HostFilterComponent()
 {
      DBG ("HostFilterComponent::~HostFilterComponent");
 
+    stopTimer ();
+
     knownPluginList.removeChangeListener (this);
 
     // register as listener to transport
@@ -250,6 +259,58 @@ void HostFilterComponent::paint (Graphics& g)
 #endif
 }
 
+//==============================================================================
+void HostFilterComponent::timerCallback ()
+{
+    const StringArray rejected (RealtimePolicy::getRejectedPolicies());
+
+    if (rejected.size() <= numRejectedPoliciesShown)
+        return;
+
+    String message (T("The system refused some of the realtime scheduling settings, "
+                      "so audio may drop out under load:\n\n"));
+
+    for (int i = numRejectedPoliciesShown; i < rejected.size(); i++)
+        message << rejected [i] << T("\n");
+
+    // the box is modal and this timer keeps ticking, so mark them shown first
+    numRejectedPoliciesShown = rejected.size();
+
+    AlertWindow::showMessageBox (AlertWindow::WarningIcon,
+                                 T("Realtime Scheduling"),
+                                 message);
+}
+
+const String HostFilterComponent::getRealtimeStatus () const
+{
+    String status;
+
+    if (! RealtimePolicy::isEnabled())
+        status << T("Realtime scheduling is disabled.\n\n");
+
+    for (int i = 0; i < RealtimePolicy::numThreadRoles; i++)
+    {
+        const RealtimePolicy::ThreadRole role = (RealtimePolicy::ThreadRole) i;
+        const int priority = RealtimePolicy::getRolePriority (role);
+        const uint32 affinity = RealtimePolicy::getRoleAffinity (role);
+
+        status << RealtimePolicy::getRoleName (role) << T(": ")
+               << (priority > 0 ? T("SCHED_FIFO ") + String (priority) : String (T("normal")))
+               << T(", cpus ")
+               << (affinity != 0 ? T("0x") + String::toHexString ((int) affinity) : String (T("any")))
+               << T("\n");
+    }
+
+    const StringArray rejected (RealtimePolicy::getRejectedPolicies());
+
+    if (rejected.size() > 0)
+        status << T("\nRefused by the system:\n") << rejected.joinIntoString (T("\n"));
+    else if (RealtimePolicy::isEnabled())
+        status << T("\nEvery request was granted.");
+
+    return status;
+}
+
 //==============================================================================
 void HostFilterComponent::loadPluginFromFile (const File& file)
 {
@@ -645,6 +706,7 @@ const PopupMenu HostFilterComponent::getMenuForIndex (int menuIndex,
         {
 #ifndef JOST_VST_PLUGIN
             menu.addCommandItem (commandManager, CommandIDs::audioOptions);
+            menu.addCommandItem (commandManager, CommandIDs::audioRealtimeStatus);
             menu.addSeparator ();
 #endif
             menu.addCommandItem (commandManager, CommandIDs::audioPlayPause);
@@ -730,6 +792,7 @@ void HostFilterComponent::getAllCommands (Array <CommandID>& commands)
                                 CommandIDs::showPluginListEditor,
 #ifndef JOST_VST_PLUGIN
                                 CommandIDs::audioOptions,
+                                CommandIDs::audioRealtimeStatus,
 #endif
                                 CommandIDs::audioPlay,
                                 CommandIDs::audioStop,
@@ -807,6 +870,12 @@ void HostFilterComponent::getCommandInfo (const CommandID commandID, Application
         result.setActive (true);
         break;
         }
+    case CommandIDs::audioRealtimeStatus:
+        {
+        result.setInfo (T("Realtime Scheduling..."), T("Show the realtime scheduling of the threads"), CommandCategories::audio, 0);
+        result.setActive (true);
+        break;
+        }
 #endif
     case CommandIDs::audioPlay:
         {
@@ -1022,6 +1091,15 @@ bool HostFilterComponent::perform (const InvocationInfo& info)
 
             break;
         }
+    case CommandIDs::audioRealtimeStatus:
+        {
+            numRejectedPoliciesShown = RealtimePolicy::getRejectedPolicies().size();
+
+            AlertWindow::showMessageBox (AlertWindow::InfoIcon,
+                                         T("Realtime Scheduling"),
+                                         getRealtimeStatus ());
+            break;
+        }
 #endif
 
     case CommandIDs::audioPlay:
@@ -1065,7 +1143,7 @@ bool HostFilterComponent::perform (const InvocationInfo& info)
             if (retValue)
             {
                closePluginEditorWindows ();
-               getFilter()->getHost ()->closeAllPlugins (true);
+               getFilter()->getHost ()->closeAllPlugins ();
 
                clearComponents ();
                Config::getInstance()->lastSessionFile = File::nonexistent;
@@ -51,7 +51,8 @@ class HostFilterComponent  : public AudioProcessorEditor,
                              public DragAndDropContainer,
                              public ApplicationCommandTarget,
                              public MenuBarModel,
-                             public PluginEditorWindowHolder
+                             public PluginEditorWindowHolder,
+                             private Timer
 {
 public:
 
@@ -137,6 +138,8 @@ public:
     
     //==============================================================================
     /** @internal */
+    void timerCallback ();
+    /** @internal */
     void paint (Graphics& g);
     /** @internal */
     void resized ();
@@ -153,6 +156,9 @@ private:
 
     void setCurrentSessionFile(const File& newFile);
 
+    /** Lists what the realtime policy asked for and what the system refused */
+    const String getRealtimeStatus () const;
+
     //==============================================================================
     friend class HostFilterBase;
 
@@ -191,6 +197,9 @@ private:
     // the file for the current session
     File currentSessionFile;
 
+    // how many refused realtime policies the user has already been warned about
+    int numRejectedPoliciesShown;
+
 public: // yep, should be behind accessor and yep, should be in app config / state class!
     KnownPluginList knownPluginList;
     KnownPluginList internalPluginList;
@@ -64,6 +64,9 @@ public:
         Process::setPriority(Process::LowPriority);
         Thread::setCurrentThreadPriority (8);
 
+        // realtime scheduling of the audio, midi and disk threads, and memory locking
+        config->applyRealtimePolicy ();
+
       AudioPluginFormatManager::getInstance()->addFormat(new VSTPluginFormat()); // for now we just support VST, keep things simple
 
         // create the window
@@ -42,6 +42,33 @@
 #define MIDIBINDING_STEPMODE_ATTRIB              T("stepMode")
 #define MIDIBINDING_VELOCITYSENSE_ATTRIB              T("velocitySensitivity")
 
+//==============================================================================
+const PropertyKey PROP_WINDOWOPEN              (T("wOpen"));
+const PropertyKey PROP_WINDOWPAGE              (T("wPage"));
+const PropertyKey PROP_WINDOWXPOS              (T("wXpos"));
+const PropertyKey PROP_WINDOWYPOS              (T("wYpos"));
+const PropertyKey PROP_WINDOWWSIZE             (T("wWsize"));
+const PropertyKey PROP_WINDOWHSIZE             (T("wHsize"));
+const PropertyKey PROP_WINDOWVISIBLEMIDIKEY    (T("wMidiKey"));
+const PropertyKey PROP_GRAPHLOCKED             (T("gLock"));
+const PropertyKey PROP_GRAPHCOLOUR             (T("gColour"));
+const PropertyKey PROP_GRAPHSELECTED           (T("gSel"));
+const PropertyKey PROP_GRAPHXPOS               (T("gXpos"));
+const PropertyKey PROP_GRAPHYPOS               (T("gYpos"));
+const PropertyKey PROP_GRAPHWSIZE              (T("gWsize"));
+const PropertyKey PROP_GRAPHHSIZE              (T("gHsize"));
+const PropertyKey PROP_GRAPHNAME               (T("gInstanceName"));
+const PropertyKey PROP_PLUGPRESETDIR           (T("pPdir"));
+const PropertyKey PROP_MIXERLABEL              (T("mLbl"));
+const PropertyKey PROP_MIXERINDEX              (T("mIdx"));
+const PropertyKey PROP_MIXERNARROW             (T("mNrw"));
+const PropertyKey PROP_MIXERPEAK               (T("mPeak"));
+const PropertyKey PROP_MIXERMETERON            (T("mMon"));
+const PropertyKey PROP_WINDOWPREFERGENERIC     (T("wPreferGeneric"));
+const PropertyKey PROP_RENDERSTEM              (T("renderStem"));
+const PropertyKey PROP_SYNTHINPUTCHANNELFILTER (T("inputFiltChan"));
+const PropertyKey PROP_OUTPUTCHANNELFILTER     (T("outputFiltChan"));
+
 //==============================================================================
 int32 BasePlugin::globalUniqueCounter = 1;
 
@@ -52,8 +79,14 @@ BasePlugin::BasePlugin ()
       parentHost (0),
       mutedOutput (false),
       bypassOutput (false),
+      denormalsAllowed (false),
+      outputMonitored (false),
+      sampleAccurateAutomation (false),
+      automationSliceSize (32),
+      denormalEvents (0),
       outputGain (1.0f),
       currentOutputGain (1.0f),
+      outputTap (0),
       outputMidiChannel(-1),
       synthInputMidiChan(-1),
       outputMidiChanFilter(0),
@@ -72,6 +105,8 @@ BasePlugin::BasePlugin ()
 BasePlugin::~BasePlugin ()
 {
     clearMidiOutputFilter();
+
+    delete outputTap;
 }
 
 String BasePlugin::getInstanceName() const
@@ -87,31 +122,31 @@ void BasePlugin::setInstanceName(const String& instanceName)
 //==============================================================================
 void BasePlugin::savePropertiesToXml (XmlElement* xml)
 {
-    xml->setAttribute (PROP_GRAPHSELECTED,           getIntValue (PROP_GRAPHSELECTED, 0));
-    xml->setAttribute (PROP_GRAPHLOCKED,             getIntValue (PROP_GRAPHLOCKED, 0));
-    xml->setAttribute (PROP_GRAPHCOLOUR,             getValue (PROP_GRAPHCOLOUR, T("0xff808080")));
-    xml->setAttribute (PROP_GRAPHNAME,               getInstanceName());
-    xml->setAttribute (PROP_GRAPHXPOS,               getIntValue (PROP_GRAPHXPOS, -1));
-    xml->setAttribute (PROP_GRAPHYPOS,               getIntValue (PROP_GRAPHYPOS, -1));
-    xml->setAttribute (PROP_GRAPHWSIZE,              getIntValue (PROP_GRAPHWSIZE, -1));
-    xml->setAttribute (PROP_GRAPHHSIZE,              getIntValue (PROP_GRAPHHSIZE, -1));
-    xml->setAttribute (PROP_WINDOWXPOS,              getIntValue (PROP_WINDOWXPOS, -1));
-    xml->setAttribute (PROP_WINDOWYPOS,              getIntValue (PROP_WINDOWYPOS, -1));
-    xml->setAttribute (PROP_WINDOWWSIZE,             getIntValue (PROP_WINDOWWSIZE, -1));
-    xml->setAttribute (PROP_WINDOWHSIZE,             getIntValue (PROP_WINDOWHSIZE, -1));
-    xml->setAttribute (PROP_WINDOWPAGE,              getIntValue (PROP_WINDOWPAGE, 0));
-    xml->setAttribute (PROP_WINDOWOPEN,              getIntValue (PROP_WINDOWOPEN, 0));
-    xml->setAttribute (PROP_WINDOWVISIBLEMIDIKEY,    getIntValue (PROP_WINDOWVISIBLEMIDIKEY, 1));
-    xml->setAttribute (PROP_PLUGPRESETDIR,           getValue (PROP_PLUGPRESETDIR, String::empty));
-    xml->setAttribute (PROP_MIXERLABEL,              getValue (PROP_MIXERLABEL, String::empty));
-    xml->setAttribute (PROP_MIXERINDEX,              getIntValue (PROP_MIXERINDEX, 0));
-    xml->setAttribute (PROP_MIXERNARROW,             getIntValue (PROP_MIXERNARROW, 0));
-    xml->setAttribute (PROP_MIXERPEAK,               getIntValue (PROP_MIXERPEAK, 1));
-    xml->setAttribute (PROP_MIXERMETERON,            getIntValue (PROP_MIXERMETERON, 1));
-    xml->setAttribute (PROP_WINDOWPREFERGENERIC,            getBoolValue (PROP_WINDOWPREFERGENERIC, false));
-    xml->setAttribute (PROP_RENDERSTEM,            getBoolValue (PROP_RENDERSTEM, false));
-    xml->setAttribute (PROP_SYNTHINPUTCHANNELFILTER, getSynthInputChannel());
-    xml->setAttribute (PROP_OUTPUTCHANNELFILTER, getMidiOutputChannel());
+    xml->setAttribute (PROP_GRAPHSELECTED.toString(),           getIntValue (PROP_GRAPHSELECTED, 0));
+    xml->setAttribute (PROP_GRAPHLOCKED.toString(),             getIntValue (PROP_GRAPHLOCKED, 0));
+    xml->setAttribute (PROP_GRAPHCOLOUR.toString(),             getValue (PROP_GRAPHCOLOUR, T("0xff808080")));
+    xml->setAttribute (PROP_GRAPHNAME.toString(),               getInstanceName());
+    xml->setAttribute (PROP_GRAPHXPOS.toString(),               getIntValue (PROP_GRAPHXPOS, -1));
+    xml->setAttribute (PROP_GRAPHYPOS.toString(),               getIntValue (PROP_GRAPHYPOS, -1));
+    xml->setAttribute (PROP_GRAPHWSIZE.toString(),              getIntValue (PROP_GRAPHWSIZE, -1));
+    xml->setAttribute (PROP_GRAPHHSIZE.toString(),              getIntValue (PROP_GRAPHHSIZE, -1));
+    xml->setAttribute (PROP_WINDOWXPOS.toString(),              getIntValue (PROP_WINDOWXPOS, -1));
+    xml->setAttribute (PROP_WINDOWYPOS.toString(),              getIntValue (PROP_WINDOWYPOS, -1));
+    xml->setAttribute (PROP_WINDOWWSIZE.toString(),             getIntValue (PROP_WINDOWWSIZE, -1));
+    xml->setAttribute (PROP_WINDOWHSIZE.toString(),             getIntValue (PROP_WINDOWHSIZE, -1));
+    xml->setAttribute (PROP_WINDOWPAGE.toString(),              getIntValue (PROP_WINDOWPAGE, 0));
+    xml->setAttribute (PROP_WINDOWOPEN.toString(),              getIntValue (PROP_WINDOWOPEN, 0));
+    xml->setAttribute (PROP_WINDOWVISIBLEMIDIKEY.toString(),    getIntValue (PROP_WINDOWVISIBLEMIDIKEY, 1));
+    xml->setAttribute (PROP_PLUGPRESETDIR.toString(),           getValue (PROP_PLUGPRESETDIR, String::empty));
+    xml->setAttribute (PROP_MIXERLABEL.toString(),              getValue (PROP_MIXERLABEL, String::empty));
+    xml->setAttribute (PROP_MIXERINDEX.toString(),              getIntValue (PROP_MIXERINDEX, 0));
+    xml->setAttribute (PROP_MIXERNARROW.toString(),             getIntValue (PROP_MIXERNARROW, 0));
+    xml->setAttribute (PROP_MIXERPEAK.toString(),               getIntValue (PROP_MIXERPEAK, 1));
+    xml->setAttribute (PROP_MIXERMETERON.toString(),            getIntValue (PROP_MIXERMETERON, 1));
+    xml->setAttribute (PROP_WINDOWPREFERGENERIC.toString(),            getBoolValue (PROP_WINDOWPREFERGENERIC, false));
+    xml->setAttribute (PROP_RENDERSTEM.toString(),            getBoolValue (PROP_RENDERSTEM, false));
+    xml->setAttribute (PROP_SYNTHINPUTCHANNELFILTER.toString(), getSynthInputChannel());
+    xml->setAttribute (PROP_OUTPUTCHANNELFILTER.toString(), getMidiOutputChannel());
    
    XmlElement* bindingsElement = new XmlElement(MIDIBINDINGS_ELEMENT_NAME);
    for (int i=0; i<getNumParameters(); i++)
@@ -147,32 +182,32 @@ void BasePlugin::savePropertiesToXml (XmlElement* xml)
 
 void BasePlugin::loadPropertiesFromXml (XmlElement* xml)
 {
-    setValue (PROP_GRAPHSELECTED,                    xml->getIntAttribute (PROP_GRAPHSELECTED, 0));
-    setValue (PROP_GRAPHLOCKED,                      xml->getIntAttribute (PROP_GRAPHLOCKED, 0));
-    setValue (PROP_GRAPHCOLOUR,                      xml->getStringAttribute (PROP_GRAPHCOLOUR, T("0xff808080")));
-    setInstanceName (xml->getStringAttribute (PROP_GRAPHNAME, getInstanceName()));
-    setValue (PROP_GRAPHXPOS,                        xml->getIntAttribute (PROP_GRAPHXPOS, -1));
-    setValue (PROP_GRAPHYPOS,                        xml->getIntAttribute (PROP_GRAPHYPOS, -1));
-    setValue (PROP_GRAPHWSIZE,                       xml->getIntAttribute (PROP_GRAPHWSIZE, 50));
-    setValue (PROP_GRAPHHSIZE,                       xml->getIntAttribute (PROP_GRAPHHSIZE, 50));
-    setValue (PROP_WINDOWXPOS,                       xml->getIntAttribute (PROP_WINDOWXPOS, -1));
-    setValue (PROP_WINDOWYPOS,                       xml->getIntAttribute (PROP_WINDOWYPOS, -1));
-    setValue (PROP_WINDOWWSIZE,                      xml->getIntAttribute (PROP_WINDOWWSIZE, -1));
-    setValue (PROP_WINDOWHSIZE,                      xml->getIntAttribute (PROP_WINDOWHSIZE, -1));
-    setValue (PROP_WINDOWPAGE,                       xml->getIntAttribute (PROP_WINDOWPAGE, 0));
-    setValue (PROP_WINDOWOPEN,                       xml->getIntAttribute (PROP_WINDOWOPEN, 0));
-    setValue (PROP_WINDOWVISIBLEMIDIKEY,             xml->getIntAttribute (PROP_WINDOWVISIBLEMIDIKEY, 1));
-    setValue (PROP_PLUGPRESETDIR,                    xml->getStringAttribute (PROP_PLUGPRESETDIR, String::empty));
-    setValue (PROP_MIXERLABEL,                       xml->getStringAttribute (PROP_MIXERLABEL, String::empty));
-    setValue (PROP_MIXERINDEX,                       xml->getIntAttribute (PROP_MIXERINDEX, 0));
-    setValue (PROP_MIXERNARROW,                      xml->getIntAttribute (PROP_MIXERNARROW, 0));
-    setValue (PROP_MIXERPEAK,                        xml->getIntAttribute (PROP_MIXERPEAK, 1));
-    setValue (PROP_MIXERMETERON,                     xml->getIntAttribute (PROP_MIXERMETERON, 1));
-    setValue (PROP_WINDOWPREFERGENERIC,                     xml->getBoolAttribute (PROP_WINDOWPREFERGENERIC, false));
-    setValue (PROP_RENDERSTEM,                     xml->getBoolAttribute (PROP_RENDERSTEM, false));
-
-    setSynthInputChannelFilter(xml->getIntAttribute(PROP_SYNTHINPUTCHANNELFILTER, -1));
-    setMidiOutputChannelFilter(xml->getIntAttribute(PROP_OUTPUTCHANNELFILTER, -1));
+    setValue (PROP_GRAPHSELECTED,                    xml->getIntAttribute (PROP_GRAPHSELECTED.toString(), 0));
+    setValue (PROP_GRAPHLOCKED,                      xml->getIntAttribute (PROP_GRAPHLOCKED.toString(), 0));
+    setValue (PROP_GRAPHCOLOUR,                      xml->getStringAttribute (PROP_GRAPHCOLOUR.toString(), T("0xff808080")));
+    setInstanceName (xml->getStringAttribute (PROP_GRAPHNAME.toString(), getInstanceName()));
+    setValue (PROP_GRAPHXPOS,                        xml->getIntAttribute (PROP_GRAPHXPOS.toString(), -1));
+    setValue (PROP_GRAPHYPOS,                        xml->getIntAttribute (PROP_GRAPHYPOS.toString(), -1));
+    setValue (PROP_GRAPHWSIZE,                       xml->getIntAttribute (PROP_GRAPHWSIZE.toString(), 50));
+    setValue (PROP_GRAPHHSIZE,                       xml->getIntAttribute (PROP_GRAPHHSIZE.toString(), 50));
+    setValue (PROP_WINDOWXPOS,                       xml->getIntAttribute (PROP_WINDOWXPOS.toString(), -1));
+    setValue (PROP_WINDOWYPOS,                       xml->getIntAttribute (PROP_WINDOWYPOS.toString(), -1));
+    setValue (PROP_WINDOWWSIZE,                      xml->getIntAttribute (PROP_WINDOWWSIZE.toString(), -1));
+    setValue (PROP_WINDOWHSIZE,                      xml->getIntAttribute (PROP_WINDOWHSIZE.toString(), -1));
+    setValue (PROP_WINDOWPAGE,                       xml->getIntAttribute (PROP_WINDOWPAGE.toString(), 0));
+    setValue (PROP_WINDOWOPEN,                       xml->getIntAttribute (PROP_WINDOWOPEN.toString(), 0));
+    setValue (PROP_WINDOWVISIBLEMIDIKEY,             xml->getIntAttribute (PROP_WINDOWVISIBLEMIDIKEY.toString(), 1));
+    setValue (PROP_PLUGPRESETDIR,                    xml->getStringAttribute (PROP_PLUGPRESETDIR.toString(), String::empty));
+    setValue (PROP_MIXERLABEL,                       xml->getStringAttribute (PROP_MIXERLABEL.toString(), String::empty));
+    setValue (PROP_MIXERINDEX,                       xml->getIntAttribute (PROP_MIXERINDEX.toString(), 0));
+    setValue (PROP_MIXERNARROW,                      xml->getIntAttribute (PROP_MIXERNARROW.toString(), 0));
+    setValue (PROP_MIXERPEAK,                        xml->getIntAttribute (PROP_MIXERPEAK.toString(), 1));
+    setValue (PROP_MIXERMETERON,                     xml->getIntAttribute (PROP_MIXERMETERON.toString(), 1));
+    setValue (PROP_WINDOWPREFERGENERIC,                     xml->getBoolAttribute (PROP_WINDOWPREFERGENERIC.toString(), false));
+    setValue (PROP_RENDERSTEM,                     xml->getBoolAttribute (PROP_RENDERSTEM.toString(), false));
+
+    setSynthInputChannelFilter(xml->getIntAttribute(PROP_SYNTHINPUTCHANNELFILTER.toString(), -1));
+    setMidiOutputChannelFilter(xml->getIntAttribute(PROP_OUTPUTCHANNELFILTER.toString(), -1));
     
    XmlElement* bindingsElement = xml->getChildByName(MIDIBINDINGS_ELEMENT_NAME);
 
@@ -268,12 +303,49 @@ void BasePlugin::clearSynthInputFilter()
    synthInputMidiChanFilter = 0;
 }
 
+//==============================================================================
+int BasePlugin::processAutomationSlice (MidiBuffer& midiBuffer, const int startSample, const int endSample)
+{
+    if (! sampleAccurateAutomation)
+    {
+        if (startSample == 0)
+            midiAutomatorManager.handleMidiMessageBuffer (midiBuffer);
+
+        return endSample;
+    }
+
+    return midiAutomatorManager.handleMidiMessageBufferSlice (midiBuffer,
+                                                              startSample,
+                                                              endSample,
+                                                              automationSliceSize);
+}
+
+//==============================================================================
+void BasePlugin::checkOutputDenormals (const int numSamples)
+{
+    AudioSampleBuffer* outBuffers = getOutputBuffers ();
+    if (! outBuffers || numSamples <= 0)
+        return;
+
+    const int numChannels = jmin (getNumOutputs (), outBuffers->getNumChannels ());
+
+    int denormals = 0;
+    for (int i = 0; i < numChannels; i++)
+        denormals += Denormals::countDenormals (outBuffers->getSampleData (i), numSamples);
+
+    if (denormals > 0 && denormals >= (numChannels * numSamples) / 4)
+        ++denormalEvents;
+}
+
 //==============================================================================
 void BasePlugin::savePresetToXml (XmlElement* xml)
 {
     xml->setAttribute (T("gain"), outputGain);
     xml->setAttribute (T("mute"), mutedOutput);
     xml->setAttribute (T("bypass"), bypassOutput);
+    xml->setAttribute (T("denormals"), denormalsAllowed);
+    xml->setAttribute (T("accurateAutomation"), sampleAccurateAutomation);
+    xml->setAttribute (T("automationSlice"), automationSliceSize);
     xml->setAttribute (T("outMidiChan"), outputMidiChannel);
 
     MemoryBlock mb;
@@ -294,6 +366,9 @@ void BasePlugin::loadPresetFromXml (XmlElement* xml)
     outputGain =  xml->getDoubleAttribute (T("gain"), 1.0);
     mutedOutput = xml->getBoolAttribute (T("mute"), 0);
     bypassOutput = xml->getBoolAttribute (T("bypass"), 0);
+    denormalsAllowed = xml->getBoolAttribute (T("denormals"), 0);
+    sampleAccurateAutomation = xml->getBoolAttribute (T("accurateAutomation"), 0);
+    setAutomationSliceSize (xml->getIntAttribute (T("automationSlice"), 32));
     outputMidiChannel = xml->getIntAttribute (T("outMidiChan"), -1);
 
     // current preset
@@ -41,31 +41,36 @@
     - programsAreChunks ?
 */
 
-#define PROP_WINDOWOPEN                       T("wOpen")
-#define PROP_WINDOWPAGE                       T("wPage")
-#define PROP_WINDOWXPOS                       T("wXpos")
-#define PROP_WINDOWYPOS                       T("wYpos")
-#define PROP_WINDOWWSIZE                      T("wWsize")
-#define PROP_WINDOWHSIZE                      T("wHsize")
-#define PROP_WINDOWVISIBLEMIDIKEY             T("wMidiKey")
-#define PROP_GRAPHLOCKED                      T("gLock")
-#define PROP_GRAPHCOLOUR                      T("gColour")
-#define PROP_GRAPHSELECTED                    T("gSel")
-#define PROP_GRAPHXPOS                        T("gXpos")
-#define PROP_GRAPHYPOS                        T("gYpos")
-#define PROP_GRAPHWSIZE                       T("gWsize")
-#define PROP_GRAPHHSIZE                       T("gHsize")
-#define PROP_GRAPHNAME                        T("gInstanceName")
-#define PROP_PLUGPRESETDIR                    T("pPdir")
-#define PROP_MIXERLABEL                       T("mLbl")
-#define PROP_MIXERINDEX                       T("mIdx")
-#define PROP_MIXERNARROW                      T("mNrw")
-#define PROP_MIXERPEAK                        T("mPeak")
-#define PROP_MIXERMETERON                     T("mMon")
-#define PROP_WINDOWPREFERGENERIC              T("wPreferGeneric")
-#define PROP_RENDERSTEM                       T("renderStem")
-#define PROP_SYNTHINPUTCHANNELFILTER          T("inputFiltChan")
-#define PROP_OUTPUTCHANNELFILTER              T("outputFiltChan")
+/*
+    The properties that every plugin keeps in its PropertySet. They're interned
+    keys, so looking them up doesn't hash or compare their names - use toString()
+    where the name itself is needed, e.g. as an xml attribute.
+*/
+extern const PropertyKey PROP_WINDOWOPEN;
+extern const PropertyKey PROP_WINDOWPAGE;
+extern const PropertyKey PROP_WINDOWXPOS;
+extern const PropertyKey PROP_WINDOWYPOS;
+extern const PropertyKey PROP_WINDOWWSIZE;
+extern const PropertyKey PROP_WINDOWHSIZE;
+extern const PropertyKey PROP_WINDOWVISIBLEMIDIKEY;
+extern const PropertyKey PROP_GRAPHLOCKED;
+extern const PropertyKey PROP_GRAPHCOLOUR;
+extern const PropertyKey PROP_GRAPHSELECTED;
+extern const PropertyKey PROP_GRAPHXPOS;
+extern const PropertyKey PROP_GRAPHYPOS;
+extern const PropertyKey PROP_GRAPHWSIZE;
+extern const PropertyKey PROP_GRAPHHSIZE;
+extern const PropertyKey PROP_GRAPHNAME;
+extern const PropertyKey PROP_PLUGPRESETDIR;
+extern const PropertyKey PROP_MIXERLABEL;
+extern const PropertyKey PROP_MIXERINDEX;
+extern const PropertyKey PROP_MIXERNARROW;
+extern const PropertyKey PROP_MIXERPEAK;
+extern const PropertyKey PROP_MIXERMETERON;
+extern const PropertyKey PROP_WINDOWPREFERGENERIC;
+extern const PropertyKey PROP_RENDERSTEM;
+extern const PropertyKey PROP_SYNTHINPUTCHANNELFILTER;
+extern const PropertyKey PROP_OUTPUTCHANNELFILTER;
 
 class BasePlugin;
 class PluginEditorComponent;
@@ -107,6 +112,43 @@ public:
     virtual int getNumMidiOutputs () const                 { return 0; }
     virtual void* getLowLevelHandle ()                     { return this; }
 
+    /** Returns the delay introduced by the plugin processing, in samples */
+    virtual int getPluginLatency () const                  { return getLatencySamples (); }
+
+    //==============================================================================
+    /** Returns true if the plugin can sum its outputs straight into other buffers
+
+        When this is true, and the plugin feeds a single node, the host will call
+        processBlockAdding instead of processBlock, saving the copy of the output
+        buffers and the mixer gain pass.
+    */
+    virtual bool canProcessAdding (const float gain) const { return false; }
+
+    /** Process a block, adding the outputs to the destinations scaled by gain
+
+        The destinations array holds one channel for every output of the plugin,
+        and the output buffers of the plugin are left untouched.
+    */
+    virtual void processBlockAdding (AudioSampleBuffer& buffer,
+                                     MidiBuffer& midiMessages,
+                                     float** destinations,
+                                     const float gain)     { }
+
+    //==============================================================================
+    /** Returns the highest factor the plugin can oversample its processing by
+
+        Plugins with saturating stages can run them at 2 or 4 times the sample
+        rate, so that the harmonics they make don't alias. This returns 1 when
+        the plugin can't oversample.
+    */
+    virtual int getMaxOversampling () const                { return 1; }
+
+    /** Returns the current oversampling factor */
+    virtual int getOversampling () const                   { return 1; }
+
+    /** Changes the oversampling factor, it can be called while processing */
+    virtual void setOversampling (const int factor)        { }
+
     //==============================================================================
     virtual bool hasEditor () const                        { return false; }
     virtual bool wantsEditor () const                      { return false; }
@@ -199,6 +241,77 @@ public:
 
     /** Set the desired mute state */
     void setBypass (const bool bypass)                 { bypassOutput = bypass; }
+
+    //==============================================================================
+    /** Returns true if someone is looking at the output buffers of this plugin
+
+        Plugins with monitored outputs are never processed with processBlockAdding,
+        so their output buffers stay valid for meters.
+    */
+    bool isOutputMonitored () const                    { return outputMonitored; }
+
+    /** Set if someone is looking at the output buffers of this plugin */
+    void setOutputMonitored (const bool monitored)     { outputMonitored = monitored; }
+
+    //==============================================================================
+    /** Returns the tap analysing the output of this plugin, if any
+
+        @see Host::enableOutputAnalysis
+    */
+    AnalysisTap* getOutputTap () const                 { return outputTap; }
+
+    /** @internal */
+    void setOutputTap (AnalysisTap* newTap)            { outputTap = newTap; }
+
+    //==============================================================================
+    /** Returns true if this plugin wants to see denormals
+
+        The host flushes denormals to zero in the audio thread, plugins that
+        rely on the exact ieee behaviour can opt out of it.
+    */
+    bool isDenormalsAllowed () const                   { return denormalsAllowed; }
+
+    /** Set if this plugin will be processed without flushing denormals */
+    void setDenormalsAllowed (const bool allowed)      { denormalsAllowed = allowed; }
+
+    /** Returns how many blocks this plugin produced with a denormal heavy output */
+    int getDenormalEvents () const                     { return denormalEvents; }
+
+    /** Reset the denormal events counter */
+    void resetDenormalEvents ()                        { denormalEvents = 0; }
+
+    /** @internal
+
+        Called by the host after processing, counts an event if a quarter
+        of the output samples of this block are denormals.
+    */
+    void checkOutputDenormals (const int numSamples);
+
+    //==============================================================================
+    /** Returns true if midi automation is applied at the exact event positions
+        When this is off, every automation event is applied before processing
+        the whole block, so automation is quantized to the block size.
+    */
+    bool isSampleAccurateAutomation () const           { return sampleAccurateAutomation; }
+    /** Set if midi automation is applied at the exact event positions */
+    void setSampleAccurateAutomation (const bool accurate) { sampleAccurateAutomation = accurate; }
+    /** Returns the shortest slice a block is split into for automation */
+    int getAutomationSliceSize () const                { return automationSliceSize; }
+    /** Set the shortest slice a block is split into for automation */
+    void setAutomationSliceSize (const int numSamples) { automationSliceSize = jmax (1, numSamples); }
+    /** @internal
+        Handle the midi automation from startSample, and returns where the
+        slice to process ends. Without sample accurate automation this is
+        the end of the block, otherwise it's the next automation event.
+        @code
+            for (int start = 0, end; start < blockSize; start = end)
+            {
+                end = processAutomationSlice (*midiBuffer, start, blockSize);
+                // process samples from start to end
+            }
+        @endcode
+    */
+    int processAutomationSlice (MidiBuffer& midiBuffer, const int startSample, const int endSample);
        
 protected:
 
@@ -214,11 +327,21 @@ protected:
 
     //==============================================================================
     bool mutedOutput           : 1,
-         bypassOutput          : 1;
+         bypassOutput          : 1,
+         denormalsAllowed      : 1,
+         outputMonitored       : 1,
+         sampleAccurateAutomation : 1;
+    int automationSliceSize;
+
+    //==============================================================================
+    volatile int denormalEvents;
 
     //==============================================================================
     float outputGain, currentOutputGain;
     float outputPan, currentOutputPan;
+
+    //==============================================================================
+    AnalysisTap* volatile outputTap;
    
    //==============================================================================
    int outputMidiChannel;
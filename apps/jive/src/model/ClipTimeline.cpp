@@ -0,0 +1,929 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2007 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU Lesser General Public License, as published by the Free Software
+ Foundation; either version 2 of the License, or (at your option) any later
+ version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+#include "ClipTimeline.h"
+
+
+//==============================================================================
+/**
+    Reads the region of a file used by a clip, unrolling its loop.
+
+    Position zero is the start of the clip on the timeline, so the buffering
+    or stretching source in front of it sees a straight stream and never
+    seeks at the loop point. When the file isn't at the host rate, the unrolled stream is read
+    at the file rate and converted, so the loop points stay sample exact in
+    the file.
+
+    A mono file is converted once and copied to the second output channel,
+    and the right channel of a stereo file played into a mono buffer is
+    converted into a spare block and dropped, so each resampler channel
+    writes its own output.
+*/
+class ClipRegionSource : public PositionableAudioSource
+{
+public:
+
+    ClipRegionSource (AudioFormatReader* const reader_,
+                      const TimelineClip& clip,
+                      const double hostSampleRate,
+                      const Resampler::Quality quality)
+        : reader (reader_),
+          ratio (reader_->sampleRate > 0.0 && hostSampleRate > 0.0 ? reader_->sampleRate / hostSampleRate : 1.0),
+          sourceOffset (roundDoubleToInt (clip.sourceOffset * ratio)),
+          loopLength (roundDoubleToInt (clip.loopLength * ratio)),
+          totalLength (clip.lengthSamples),
+          position (0),
+          readPosition (0),
+          numResampled (reader_->numChannels > 1 ? 2 : 1),
+          sourceBuffer (2, 0),
+          bufferPos (0),
+          sampsInBuffer (0)
+    {
+        if (fabs (ratio - 1.0) > 1.0e-9)
+        {
+            resampler = new Resampler (numResampled, quality);
+            resampler->setRatio (ratio);
+            sourceBuffer.setSize (numResampled, sourceBufferSize);
+
+            if (numResampled > 1)
+                spareOutput.calloc (sourceBufferSize);
+        }
+    }
+
+    ~ClipRegionSource ()
+    {
+        delete reader;
+    }
+
+    //==============================================================================
+    void prepareToPlay (int, double)                    {}
+    void releaseResources ()                            {}
+
+    void getNextAudioBlock (const AudioSourceChannelInfo& info)
+    {
+        if (resampler == 0)
+        {
+            readRegion (*info.buffer, info.startSample, info.numSamples);
+            position += info.numSamples;
+            return;
+        }
+
+        const int numOutputs = jmin (2, info.buffer->getNumChannels ());
+        const float* inputs [2];
+        float* outputs [2];
+        int numDone = 0;
+
+        while (numDone < info.numSamples)
+        {
+            if (bufferPos >= sampsInBuffer)
+            {
+                const int numWanted = jlimit (1, sourceBuffer.getNumSamples (),
+                                              resampler->getNumInputSamplesNeeded (info.numSamples - numDone));
+
+                readRegion (sourceBuffer, 0, numWanted);
+
+                bufferPos = 0;
+                sampsInBuffer = numWanted;
+            }
+
+            int numWanted = info.numSamples - numDone;
+
+            for (int ch = 0; ch < numResampled; ++ch)
+            {
+                inputs [ch] = sourceBuffer.getSampleData (ch, bufferPos);
+
+                if (ch < numOutputs)
+                {
+                    outputs [ch] = info.buffer->getSampleData (ch, info.startSample + numDone);
+                }
+                else
+                {
+                    outputs [ch] = spareOutput;
+                    numWanted = jmin (numWanted, (int) sourceBufferSize);
+                }
+            }
+
+            int numUsed = 0;
+            const int numWritten = resampler->process (inputs, sampsInBuffer - bufferPos, numUsed,
+                                                       outputs, numWanted);
+
+            if (numResampled < numOutputs)
+                info.buffer->copyFrom (1, info.startSample + numDone, *info.buffer, 0, info.startSample + numDone, numWritten);
+
+            numDone += numWritten;
+            bufferPos += numUsed;
+        }
+
+        position += info.numSamples;
+    }
+
+    //==============================================================================
+    void setNextReadPosition (int newPosition)
+    {
+        position = jmax (0, newPosition);
+        readPosition = (int) (position * ratio);
+
+        if (resampler != 0)
+        {
+            resampler->reset ();
+            bufferPos = sampsInBuffer = 0;
+        }
+    }
+
+    int getNextReadPosition () const                    { return position; }
+    int getTotalLength () const                         { return totalLength; }
+    bool isLooping () const                             { return false; }
+
+    juce_UseDebuggingNewOperator
+
+private:
+
+    /** Reads the unrolled region at the file rate, from readPosition on */
+    void readRegion (AudioSampleBuffer& buffer, int startSample, int numSamples)
+    {
+        while (numSamples > 0)
+        {
+            int sourcePosition = sourceOffset + readPosition;
+            int numThisTime = numSamples;
+
+            if (loopLength > 0)
+            {
+                const int positionInLoop = readPosition % loopLength;
+
+                sourcePosition = sourceOffset + positionInLoop;
+                numThisTime = jmin (numSamples, loopLength - positionInLoop);
+            }
+
+            numThisTime = jmin (numThisTime, (int) reader->lengthInSamples - sourcePosition);
+
+            if (numThisTime <= 0)
+            {
+                // ran past the end of the file
+                buffer.clear (startSample, numSamples);
+                readPosition += numSamples;
+                break;
+            }
+
+            buffer.readFromAudioReader (reader, startSample, numThisTime, sourcePosition, true, true);
+
+            if (reader->numChannels == 1 && buffer.getNumChannels () > 1)
+                buffer.copyFrom (1, startSample, buffer, 0, startSample, numThisTime);
+
+            startSample += numThisTime;
+            numSamples -= numThisTime;
+            readPosition += numThisTime;
+        }
+    }
+
+    AudioFormatReader* const reader;
+    const double ratio;
+    const int sourceOffset;
+    const int loopLength;
+    const int totalLength;
+    int position, readPosition;
+
+    enum { sourceBufferSize = 2048 };
+
+    const int numResampled;
+    ScopedPointer <Resampler> resampler;
+    AudioSampleBuffer sourceBuffer;
+    HeapBlock <float> spareOutput;
+    int bufferPos, sampsInBuffer;
+
+    ClipRegionSource (const ClipRegionSource&);
+    const ClipRegionSource& operator= (const ClipRegionSource&);
+};
+
+
+//==============================================================================
+/**
+    A clip as seen from the message thread, with the buffered stream that is
+    alive while the clip is near the playhead.
+*/
+class ClipStream
+{
+public:
+
+    ClipStream (const int id_, const TimelineClip& clip_)
+        : id (id_),
+          clip (clip_),
+          source (0),
+          stretcher (0),
+          unreadable (false)
+    {
+    }
+
+    ~ClipStream ()
+    {
+        delete source;
+    }
+
+    const int id;
+    const TimelineClip clip;
+    PositionableAudioSource* volatile source;
+    TimeStretchAudioSource* stretcher;      // the same as source, if the clip is synced
+    bool unreadable;
+
+    juce_UseDebuggingNewOperator
+
+private:
+
+    ClipStream (const ClipStream&);
+    const ClipStream& operator= (const ClipStream&);
+};
+
+
+//==============================================================================
+/**
+    A clip as the audio thread needs it, in a flat array.
+*/
+class ClipEntry
+{
+public:
+    int start, end, length;
+    int fadeIn, fadeOut;
+    float gain;
+    ClipStream* stream;
+};
+
+
+//==============================================================================
+/**
+    The immutable list of clips the audio thread renders from.
+*/
+class ClipList
+{
+public:
+
+    ClipList (const OwnedArray<ClipStream>& streams, const int version_)
+        : numEntries (streams.size ()),
+          maxLength (0),
+          version (version_)
+    {
+        entries.malloc (jmax (1, numEntries));
+
+        for (int i = 0; i < numEntries; ++i)
+        {
+            ClipStream* const stream = streams.getUnchecked (i);
+            const TimelineClip& clip = stream->clip;
+            ClipEntry& e = entries [i];
+
+            e.start = clip.startSample;
+            e.end = clip.getEndSample ();
+            e.length = clip.lengthSamples;
+            e.fadeIn = jlimit (0, clip.lengthSamples, clip.fadeInSamples);
+            e.fadeOut = jlimit (0, clip.lengthSamples, clip.fadeOutSamples);
+            e.gain = clip.gain;
+            e.stream = stream;
+
+            maxLength = jmax (maxLength, e.length);
+        }
+    }
+
+    HeapBlock <ClipEntry> entries;
+    const int numEntries;
+    int maxLength;
+    const int version;
+
+    juce_UseDebuggingNewOperator
+
+private:
+
+    ClipList (const ClipList&);
+    const ClipList& operator= (const ClipList&);
+};
+
+
+//==============================================================================
+class ClipTimeline::RetiredObject
+{
+public:
+
+    RetiredObject (ClipList* list_, ClipStream* stream_, PositionableAudioSource* source_, const int snapshot_)
+        : list (list_), stream (stream_), source (source_), snapshot (snapshot_)
+    {
+    }
+
+    ~RetiredObject ()
+    {
+        delete list;
+        delete stream;
+        delete source;
+    }
+
+    ClipList* list;
+    ClipStream* stream;
+    PositionableAudioSource* source;
+    const int snapshot;
+};
+
+
+//==============================================================================
+class ClipStartComparator
+{
+public:
+    static int compareElements (ClipStream* first, ClipStream* second)
+    {
+        return first->clip.startSample - second->clip.startSample;
+    }
+};
+
+static const int maxActiveClips = 256;
+static const int maxStreamsPreparedPerTimer = 4;
+
+//==============================================================================
+void TimelineClip::saveToXml (XmlElement* xml) const
+{
+    xml->setAttribute (T("file"), file.getFullPathName ());
+    xml->setAttribute (T("start"), startSample);
+    xml->setAttribute (T("length"), lengthSamples);
+    xml->setAttribute (T("offset"), sourceOffset);
+    xml->setAttribute (T("loop"), loopLength);
+    xml->setAttribute (T("fadeIn"), fadeInSamples);
+    xml->setAttribute (T("fadeOut"), fadeOutSamples);
+    xml->setAttribute (T("gain"), gain);
+
+    if (tempo > 0.0)
+        xml->setAttribute (T("tempo"), tempo);
+}
+
+void TimelineClip::loadFromXml (XmlElement* xml)
+{
+    file = File (xml->getStringAttribute (T("file")));
+    startSample = xml->getIntAttribute (T("start"), 0);
+    lengthSamples = xml->getIntAttribute (T("length"), 0);
+    sourceOffset = xml->getIntAttribute (T("offset"), 0);
+    loopLength = xml->getIntAttribute (T("loop"), 0);
+    fadeInSamples = xml->getIntAttribute (T("fadeIn"), 0);
+    fadeOutSamples = xml->getIntAttribute (T("fadeOut"), 0);
+    gain = (float) xml->getDoubleAttribute (T("gain"), 1.0);
+    tempo = xml->getDoubleAttribute (T("tempo"), 0.0);
+}
+
+//==============================================================================
+ClipTimeline::ClipTimeline (AudioFormatManager& formatManager_,
+                            const int numChannels_)
+  : formatManager (formatManager_),
+    numChannels (numChannels_),
+    sampleRate (44100.0),
+    blockSize (512),
+    nextClipId (1),
+    resamplingQuality (Resampler::polyphaseSinc),
+    publishedList (0),
+    loopStart (-1),
+    tempo (120.0),
+    playheadPosition (0),
+    missedClips (0),
+    renderedVersion (-1),
+    expectedPosition (-1),
+    nextClip (0),
+    numActiveClips (0),
+    scratch (2, 512)
+{
+    activeClips.malloc (maxActiveClips);
+}
+
+ClipTimeline::~ClipTimeline ()
+{
+    stopTimer ();
+
+    ClipList* const list = publishedList;
+    publishedList = 0;
+
+    retire (list, 0, 0);
+
+    for (int i = streams.size (); --i >= 0;)
+    {
+        retire (0, streams.getUnchecked (i), 0);
+        streams.remove (i, false);
+    }
+
+    while (deleteExpired () > 0)
+        Thread::sleep (1);
+}
+
+//==============================================================================
+int ClipTimeline::addClip (const TimelineClip& clip)
+{
+    const int clipId = nextClipId++;
+
+    ClipStartComparator comparator;
+    streams.addSorted (comparator, new ClipStream (clipId, clip));
+
+    publishClips ();
+
+    return clipId;
+}
+
+bool ClipTimeline::setClip (const int clipId, const TimelineClip& clip)
+{
+    for (int i = streams.size (); --i >= 0;)
+    {
+        if (streams.getUnchecked (i)->id == clipId)
+        {
+            // the buffered data belongs to the old clip, so the stream is replaced
+            ClipStream* const oldStream = streams.getUnchecked (i);
+            streams.remove (i, false);
+            preparedStreams.removeValue (oldStream);
+
+            ClipStartComparator comparator;
+            streams.addSorted (comparator, new ClipStream (clipId, clip));
+
+            publishClips ();
+            retire (0, oldStream, 0);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ClipTimeline::removeClip (const int clipId)
+{
+    for (int i = streams.size (); --i >= 0;)
+    {
+        if (streams.getUnchecked (i)->id == clipId)
+        {
+            ClipStream* const oldStream = streams.getUnchecked (i);
+            streams.remove (i, false);
+            preparedStreams.removeValue (oldStream);
+
+            publishClips ();
+            retire (0, oldStream, 0);
+            break;
+        }
+    }
+}
+
+void ClipTimeline::clear ()
+{
+    if (streams.size () == 0)
+        return;
+
+    Array<ClipStream*> oldStreams;
+    for (int i = 0; i < streams.size (); ++i)
+        oldStreams.add (streams.getUnchecked (i));
+
+    streams.clear (false);
+
+    preparedStreams.clear ();
+    publishClips ();
+
+    for (int i = oldStreams.size (); --i >= 0;)
+        retire (0, oldStreams.getUnchecked (i), 0);
+}
+
+//==============================================================================
+int ClipTimeline::getClipId (const int index) const
+{
+    ClipStream* const stream = streams [index];
+    return stream != 0 ? stream->id : 0;
+}
+
+const TimelineClip* ClipTimeline::getClip (const int index) const
+{
+    ClipStream* const stream = streams [index];
+    return stream != 0 ? &stream->clip : 0;
+}
+
+bool ClipTimeline::getClipStretchInfo (const int clipId, float& cpuLoad, int& latencySamples) const
+{
+    for (int i = preparedStreams.size (); --i >= 0;)
+    {
+        const ClipStream* const stream = preparedStreams.getUnchecked (i);
+
+        if (stream->id == clipId && stream->stretcher != 0)
+        {
+            cpuLoad = stream->stretcher->getCpuLoad ();
+            latencySamples = stream->stretcher->getLatencySamples ();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//==============================================================================
+void ClipTimeline::publishClips ()
+{
+    ClipList* const oldList = publishedList;
+    ClipList* const newList = new ClipList (streams, oldList != 0 ? oldList->version + 1 : 0);
+
+    Atomic::memoryBarrier ();
+    publishedList = newList;
+
+    retire (oldList, 0, 0);
+
+    if (! isTimerRunning ())
+        startTimer (40);
+}
+
+void ClipTimeline::retire (ClipList* list, ClipStream* stream, PositionableAudioSource* source)
+{
+    if (list == 0 && stream == 0 && source == 0)
+        return;
+
+    retired.add (new RetiredObject (list, stream, source, epoch.getSnapshot ()));
+
+    if (deleteExpired () > 0 && ! isTimerRunning ())
+        startTimer (40);
+}
+
+int ClipTimeline::deleteExpired ()
+{
+    for (int i = retired.size (); --i >= 0;)
+    {
+        if (epoch.hasMovedPast (retired.getUnchecked (i)->snapshot))
+            retired.remove (i, true);
+    }
+
+    return retired.size ();
+}
+
+//==============================================================================
+void ClipTimeline::prepareToPlay (const double sampleRate_, const int samplesPerBlock)
+{
+    sampleRate = sampleRate_ > 0.0 ? sampleRate_ : 44100.0;
+    blockSize = jmax (1, samplesPerBlock);
+
+    scratch.setSize (2, blockSize);
+
+    expectedPosition = -1;
+    numActiveClips = 0;
+
+    startTimer (40);
+}
+
+void ClipTimeline::releaseResources ()
+{
+    stopTimer ();
+    releaseStreams ();
+}
+
+void ClipTimeline::setResamplingQuality (const Resampler::Quality newQuality)
+{
+    if (resamplingQuality != newQuality)
+    {
+        resamplingQuality = newQuality;
+
+        // the timer opens them again, with the new quality
+        releaseStreams ();
+
+        if (streams.size () > 0 && ! isTimerRunning ())
+            startTimer (40);
+    }
+}
+
+void ClipTimeline::releaseStreams ()
+{
+    for (int i = preparedStreams.size (); --i >= 0;)
+    {
+        ClipStream* const stream = preparedStreams.getUnchecked (i);
+        PositionableAudioSource* const source = stream->source;
+
+        stream->source = 0;
+        stream->stretcher = 0;
+        retire (0, 0, source);
+    }
+
+    preparedStreams.clear ();
+    deleteExpired ();
+}
+
+//==============================================================================
+void ClipTimeline::timerCallback ()
+{
+    deleteExpired ();
+
+    const int lookahead = roundDoubleToInt (sampleRate * 4.0);
+
+    // find what should be buffered now: around the playhead and where we loop
+    Array<ClipStream*> wanted;
+    prepareStreamsNear (playheadPosition, lookahead, wanted);
+
+    if (loopStart >= 0)
+        prepareStreamsNear (loopStart, lookahead / 2, wanted);
+
+    // drop the streams that went out of the window
+    for (int i = preparedStreams.size (); --i >= 0;)
+    {
+        ClipStream* const stream = preparedStreams.getUnchecked (i);
+
+        if (! wanted.contains (stream))
+        {
+            PositionableAudioSource* const source = stream->source;
+            stream->source = 0;
+            stream->stretcher = 0;
+
+            preparedStreams.remove (i);
+            retire (0, 0, source);
+        }
+    }
+
+    // follow the transport tempo, the stretchers pick it up without locking
+    const double currentTempo = tempo;
+
+    for (int i = preparedStreams.size (); --i >= 0;)
+    {
+        ClipStream* const stream = preparedStreams.getUnchecked (i);
+        const double ratio = stream->clip.tempo / currentTempo;
+
+        if (stream->stretcher != 0 && stream->stretcher->getTimeRatio () != ratio)
+            stream->stretcher->setTimeRatio (ratio);
+    }
+
+    // and open the new ones, a few at a time so the message thread stays responsive
+    int numPrepared = 0;
+
+    for (int i = 0; i < wanted.size () && numPrepared < maxStreamsPreparedPerTimer; ++i)
+    {
+        ClipStream* const stream = wanted.getUnchecked (i);
+
+        if (stream->source != 0 || stream->unreadable)
+            continue;
+
+        AudioFormatReader* const reader = formatManager.createReaderFor (stream->clip.file);
+
+        if (reader == 0)
+        {
+            stream->unreadable = true;
+            continue;
+        }
+
+        ClipRegionSource* const region = new ClipRegionSource (reader, stream->clip, sampleRate, resamplingQuality);
+        PositionableAudioSource* source;
+
+        if (stream->clip.isTempoSynced ())
+        {
+            stream->stretcher = new TimeStretchAudioSource (region, true, 2, jmax (blockSize * 4, 16384));
+            stream->stretcher->setTimeRatio (stream->clip.tempo / tempo);
+            source = stream->stretcher;
+        }
+        else
+        {
+            source = new BufferingAudioSource (region, true, jmax (blockSize * 4, roundDoubleToInt (sampleRate)));
+        }
+
+        source->setNextReadPosition (jmax (0, playheadPosition - stream->clip.startSample));
+        source->prepareToPlay (blockSize, sampleRate);
+
+        Atomic::memoryBarrier ();
+        stream->source = source;
+
+        preparedStreams.add (stream);
+        ++numPrepared;
+    }
+
+    if (preparedStreams.size () == 0 && retired.size () == 0 && streams.size () == 0)
+        stopTimer ();
+}
+
+void ClipTimeline::prepareStreamsNear (const int position, const int lookahead, Array<ClipStream*>& wanted)
+{
+    const ClipList* const list = publishedList;
+    if (list == 0)
+        return;
+
+    const int windowEnd = position + lookahead;
+
+    // the streams are sorted like the published list, so we find the first
+    // clip starting after the window and walk back to the ones still sounding
+    int first = 0, last = list->numEntries;
+    while (first < last)
+    {
+        const int middle = (first + last) / 2;
+
+        if (list->entries [middle].start < windowEnd)
+            first = middle + 1;
+        else
+            last = middle;
+    }
+
+    for (int i = first; --i >= 0 && list->entries [i].start + list->maxLength > position;)
+    {
+        if (list->entries [i].end > position)
+            wanted.addIfNotAlreadyThere (list->entries [i].stream);
+    }
+}
+
+//==============================================================================
+void ClipTimeline::renderNextBlock (AudioSampleBuffer& output,
+                                    const int position,
+                                    const int numSamples)
+{
+    epoch.enterRender ();
+
+    const ClipList* const list = publishedList;
+
+    if (list != 0)
+    {
+        if (list->version != renderedVersion || position != expectedPosition)
+            seek (list, position);
+
+        const int blockEnd = position + numSamples;
+
+        // pick up the clips starting in this block
+        while (nextClip < list->numEntries && list->entries [nextClip].start < blockEnd)
+        {
+            if (list->entries [nextClip].end > position && numActiveClips < maxActiveClips)
+                activeClips [numActiveClips++] = nextClip;
+
+            ++nextClip;
+        }
+
+        for (int i = numActiveClips; --i >= 0;)
+        {
+            const ClipEntry& entry = list->entries [activeClips [i]];
+
+            renderClip (entry, position, numSamples, output);
+
+            if (entry.end <= blockEnd)
+                activeClips [i] = activeClips [--numActiveClips];
+        }
+
+        renderedVersion = list->version;
+    }
+
+    expectedPosition = position + numSamples;
+    playheadPosition = expectedPosition;
+
+    epoch.exitRender ();
+}
+
+void ClipTimeline::setPlayheadPosition (const int position)
+{
+    playheadPosition = position;
+}
+
+void ClipTimeline::seek (const ClipList* list, const int position)
+{
+    numActiveClips = 0;
+
+    // first clip starting at or after the position
+    int first = 0, last = list->numEntries;
+    while (first < last)
+    {
+        const int middle = (first + last) / 2;
+
+        if (list->entries [middle].start < position)
+            first = middle + 1;
+        else
+            last = middle;
+    }
+
+    nextClip = first;
+
+    // no clip is longer than maxLength, so only a few before can still be sounding
+    for (int i = first; --i >= 0 && list->entries [i].start + list->maxLength > position;)
+    {
+        if (list->entries [i].end > position && numActiveClips < maxActiveClips)
+            activeClips [numActiveClips++] = i;
+    }
+}
+
+static float getClipFadeGain (const ClipEntry& entry, const int clipPosition)
+{
+    float gain = entry.gain;
+
+    if (clipPosition < entry.fadeIn)
+        gain *= sinf ((clipPosition + 0.5f) / entry.fadeIn * float_Pi * 0.5f);
+
+    const int samplesToEnd = entry.length - clipPosition;
+
+    if (samplesToEnd <= entry.fadeOut)
+        gain *= sinf ((samplesToEnd - 0.5f) / entry.fadeOut * float_Pi * 0.5f);
+
+    return gain;
+}
+
+void ClipTimeline::renderClip (const ClipEntry& entry,
+                               const int position,
+                               const int numSamples,
+                               AudioSampleBuffer& output)
+{
+    const int from = jmax (entry.start, position);
+    const int to = jmin (entry.end, position + numSamples);
+
+    if (from >= to)
+        return;
+
+    PositionableAudioSource* const source = entry.stream->source;
+
+    if (source == 0)
+    {
+        // not buffered yet, better silent than blocking
+        ++missedClips;
+        return;
+    }
+
+    int clipPosition = from - entry.start;
+    int outputOffset = from - position;
+    int numLeft = to - from;
+
+    if (source->getNextReadPosition () != clipPosition)
+        source->setNextReadPosition (clipPosition);
+
+    const int numOutputs = jmin (numChannels, output.getNumChannels ());
+
+    while (numLeft > 0)
+    {
+        const int numThisTime = jmin (numLeft, scratch.getNumSamples ());
+
+        AudioSourceChannelInfo info;
+        info.buffer = &scratch;
+        info.startSample = 0;
+        info.numSamples = numThisTime;
+
+        source->getNextAudioBlock (info);
+
+        float gain = entry.gain;
+
+        if (clipPosition < entry.fadeIn || clipPosition + numThisTime > entry.length - entry.fadeOut)
+        {
+            float* const left = scratch.getSampleData (0);
+            float* const right = scratch.getSampleData (1);
+
+            for (int i = 0; i < numThisTime; ++i)
+            {
+                const float fade = getClipFadeGain (entry, clipPosition + i);
+                left [i] *= fade;
+                right [i] *= fade;
+            }
+
+            gain = 1.0f;
+        }
+
+        if (numOutputs == 1)
+        {
+            output.addFrom (0, outputOffset, scratch, 0, 0, numThisTime, gain * 0.5f);
+            output.addFrom (0, outputOffset, scratch, 1, 0, numThisTime, gain * 0.5f);
+        }
+        else
+        {
+            for (int ch = jmin (numOutputs, 2); --ch >= 0;)
+                output.addFrom (ch, outputOffset, scratch, ch, 0, numThisTime, gain);
+        }
+
+        clipPosition += numThisTime;
+        outputOffset += numThisTime;
+        numLeft -= numThisTime;
+    }
+}
+
+//==============================================================================
+void ClipTimeline::saveToXml (XmlElement* xml) const
+{
+    xml->setAttribute (T("resampling"), (int) resamplingQuality);
+
+    for (int i = 0; i < streams.size (); ++i)
+    {
+        XmlElement* e = new XmlElement (T("clip"));
+        streams.getUnchecked (i)->clip.saveToXml (e);
+        xml->addChildElement (e);
+    }
+}
+
+void ClipTimeline::loadFromXml (XmlElement* xml)
+{
+    clear ();
+
+    setResamplingQuality ((Resampler::Quality) jlimit ((int) Resampler::fastLinear, (int) Resampler::bestSinc,
+                                                       xml->getIntAttribute (T("resampling"), (int) Resampler::polyphaseSinc)));
+
+    ClipStartComparator comparator;
+
+    forEachXmlChildElementWithTagName (*xml, e, T("clip"))
+    {
+        TimelineClip clip;
+        clip.loadFromXml (e);
+
+        streams.addSorted (comparator, new ClipStream (nextClipId++, clip));
+    }
+
+    publishClips ();
+}
@@ -0,0 +1,265 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2007 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU Lesser General Public License, as published by the Free Software
+ Foundation; either version 2 of the License, or (at your option) any later
+ version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+#ifndef __JUCETICE_JOSTCLIPTIMELINE_HEADER__
+#define __JUCETICE_JOSTCLIPTIMELINE_HEADER__
+
+#include "RenderEpoch.h"
+
+
+//==============================================================================
+/**
+    Describes a single audio clip placed on the transport timeline.
+
+    All the positions are in samples at the host rate, even when the file
+    was recorded at another one. A looping clip repeats loopLength samples of
+    its file, starting from sourceOffset, until it has filled its length on
+    the timeline.
+
+    A clip with a tempo is synced to the transport: it is time-stretched by
+    the ratio between its tempo and the transport one, and then its length
+    and positions are in stretched samples, while sourceOffset and loopLength
+    stay in the samples of the file.
+*/
+class TimelineClip
+{
+public:
+    //==============================================================================
+    TimelineClip ()
+        : startSample (0),
+          lengthSamples (0),
+          sourceOffset (0),
+          loopLength (0),
+          fadeInSamples (0),
+          fadeOutSamples (0),
+          gain (1.0f),
+          tempo (0.0)
+    {
+    }
+
+    //==============================================================================
+    int getEndSample () const                           { return startSample + lengthSamples; }
+    bool isLooping () const                             { return loopLength > 0; }
+    bool isTempoSynced () const                         { return tempo > 0.0; }
+
+    //==============================================================================
+    /** Serialize the clip to an Xml element */
+    void saveToXml (XmlElement* xml) const;
+
+    /** Deserialize the clip from an Xml element */
+    void loadFromXml (XmlElement* xml);
+
+    //==============================================================================
+    File file;
+    int startSample;
+    int lengthSamples;
+    int sourceOffset;
+    int loopLength;
+    int fadeInSamples;
+    int fadeOutSamples;
+    float gain;
+    double tempo;
+};
+
+
+class ClipStream;
+class ClipEntry;
+class ClipList;
+
+
+//==============================================================================
+/**
+    Plays a set of audio clips aligned to the transport.
+
+    Clips are edited from the message thread, which builds a new list sorted
+    by start position and publishes it with a pointer swap: the audio thread
+    never locks, and old lists are freed when the render has moved past them.
+
+    The audio thread keeps a cursor in the sorted list and a small set of the
+    clips that are sounding, so a block only looks at the clips it overlaps.
+    Clips are streamed through buffering sources, that are created by a timer
+    only for the clips near the playhead and refilled by the shared read
+    threads, so hundreds of clips don't all hold a read-ahead buffer.
+
+    Fades are equal power, so overlapping clips whose fades line up make a
+    constant power crossfade. Files at a different sample rate than the host
+    are converted by the read threads, before buffering.
+
+    Tempo synced clips are streamed through a TimeStretchAudioSource instead,
+    whose threads stretch ahead of the playhead. A tempo change reaches them
+    through the timer, and is heard after their lookahead.
+*/
+class ClipTimeline : private Timer
+{
+public:
+
+    //==============================================================================
+    ClipTimeline (AudioFormatManager& formatManager,
+                  const int numChannels);
+
+    ~ClipTimeline ();
+
+    //==============================================================================
+    /** Add a clip, returns its identifier */
+    int addClip (const TimelineClip& clip);
+
+    /** Replace a clip keeping its identifier, returns false if it doesn't exist */
+    bool setClip (const int clipId, const TimelineClip& clip);
+
+    /** Remove a clip */
+    void removeClip (const int clipId);
+
+    /** Remove all the clips */
+    void clear ();
+
+    //==============================================================================
+    /** Returns the number of clips, sorted by start position */
+    int getNumClips () const                            { return streams.size (); }
+
+    /** Returns the identifier of a clip */
+    int getClipId (const int index) const;
+
+    /** Returns a clip description, or 0 if the index is out of range */
+    const TimelineClip* getClip (const int index) const;
+
+    //==============================================================================
+    /** Set where the transport jumps back when looping, -1 if it doesn't
+        Clips at the loop start are kept buffered so the jump doesn't drop out.
+    */
+    void setLoopStart (const int newLoopStart)          { loopStart = newLoopStart; }
+
+    /** Tells where the playhead is while the transport is stopped
+        The clips there will be buffered, ready for when it starts.
+    */
+    void setPlayheadPosition (const int position);
+
+    /** Returns the number of clips that couldn't play because they weren't buffered */
+    int getNumMissedClips () const                      { return missedClips; }
+
+    //==============================================================================
+    /** Set the transport tempo the synced clips are stretched to
+
+        This is called by the audio thread, it only stores the value.
+    */
+    void setTempo (const double bpm)                    { if (bpm > 0.0) tempo = bpm; }
+
+    /** Returns the stretching cost of a clip, if it is synced and buffered
+
+        @param cpuLoad          the time spent stretching, as a fraction of the time played
+        @param latencySamples   how long a tempo change takes to be heard
+    */
+    bool getClipStretchInfo (const int clipId, float& cpuLoad, int& latencySamples) const;
+
+    //==============================================================================
+    /** Set how files at another sample rate are converted
+        The streams already buffered are reopened with the new quality.
+    */
+    void setResamplingQuality (const Resampler::Quality newQuality);
+
+    /** Returns the quality used to convert files at another sample rate */
+    Resampler::Quality getResamplingQuality () const    { return resamplingQuality; }
+
+    //==============================================================================
+    /** Called before playback, from the message thread */
+    void prepareToPlay (const double sampleRate, const int samplesPerBlock);
+
+    /** Release every stream buffer */
+    void releaseResources ();
+
+    /** Add the clips sounding in a block to the output buffer
+
+        This is called by the audio thread. The position is the transport
+        position at the start of the block: any jump in it since the last
+        block is treated as a seek.
+    */
+    void renderNextBlock (AudioSampleBuffer& output,
+                          const int position,
+                          const int numSamples);
+
+    //==============================================================================
+    /** Serialize the clips to an Xml element */
+    void saveToXml (XmlElement* xml) const;
+
+    /** Deserialize the clips from an Xml element */
+    void loadFromXml (XmlElement* xml);
+
+    //==============================================================================
+    juce_UseDebuggingNewOperator
+
+private:
+
+    //==============================================================================
+    void timerCallback ();
+
+    void publishClips ();
+    void prepareStreamsNear (const int position, const int lookahead, Array<ClipStream*>& wanted);
+    void retire (ClipList* list, ClipStream* stream, PositionableAudioSource* source);
+    int deleteExpired ();
+    void releaseStreams ();
+
+    //==============================================================================
+    void seek (const ClipList* list, const int position);
+    void renderClip (const ClipEntry& entry, const int position, const int numSamples, AudioSampleBuffer& output);
+
+    //==============================================================================
+    AudioFormatManager& formatManager;
+    const int numChannels;
+    double sampleRate;
+    int blockSize;
+    int nextClipId;
+    Resampler::Quality resamplingQuality;
+
+    // message thread state
+    OwnedArray<ClipStream> streams;
+    Array<ClipStream*> preparedStreams;
+
+    // published to the audio thread
+    ClipList* volatile publishedList;
+    RenderEpoch epoch;
+    volatile int loopStart;
+    volatile double tempo;
+    volatile int playheadPosition;
+    volatile int missedClips;
+
+    // audio thread state
+    int renderedVersion;
+    int expectedPosition;
+    int nextClip;
+    HeapBlock <int> activeClips;
+    int numActiveClips;
+    AudioSampleBuffer scratch;
+
+    class RetiredObject;
+    OwnedArray<RetiredObject> retired;
+
+    ClipTimeline (const ClipTimeline&);
+    const ClipTimeline& operator= (const ClipTimeline&);
+};
+
+
+#endif
@@ -157,6 +157,9 @@ void StemRenderingThread::appendSamplesToBuffer(const BasePlugin* plugin, const
 
 bool StemRenderingThread::useTimeSlice()
 {
+   // this runs on our own worker thread, so mode is kept between slices
+   Denormals::setFlushToZero (true);
+
    bool needMoreTime = false;
    bool finalising = false; // true if we have stopped rendering and need to completely empty any buffers
    {
@@ -201,6 +204,8 @@ Host::Host (HostFilterBase* owner_,
   : owner (owner_),
     currentPlugin (0),
     audioGraph (0),
+    latencyCompensation (0),
+    retiredObjects (renderEpoch),
     sampleRate (44100.0),
     samplesPerBlock (512),
     renderingStems(false),
@@ -222,23 +227,34 @@ Host::Host (HostFilterBase* owner_,
    stemRenderRunner.addTimeSliceClient(&stemRenderThread);
    //int priority = 3; // default is 5, super important is 10, so let's leave lots of room for our audio thread
    stemRenderRunner.startThread(); // use default priority until we demostrate the need for lower priority
+
+    // compensate the empty graph, plugins will tell us when their latency changes
+    updateLatencyCompensation ();
 }
 
 Host::~Host()
 {
     DBG ("Host::~Host");
+
+    cancelPendingUpdate ();
     
 	// stop any stem render (i.e. if we quit while recording)
     stemRenderThread.stopRendering();
 
     // free plugins
-    closeAllPlugins (false);
+    closeAllPlugins ();
+    retiredObjects.flush ();
+
+    for (int i = plugins.size (); --i >= 0;)
+        plugins.getUnchecked (i)->removeListener (this);
+
     plugins.clear (true);
 
     // remove listeners after
     removeAllListeners ();
 
     // delete audio graph
+    deleteAndZero (latencyCompensation);
     deleteAndZero (audioGraph);
 }
 
@@ -264,6 +280,9 @@ void Host::addPlugin (BasePlugin* plugin)
 
         // add plugin to the list
         plugins.add (plugin);
+
+        // a latency change is notified through updateHostDisplay
+        plugin->addListener (this);
     }
 }
 
@@ -297,13 +316,14 @@ void Host::changePluginAudioGraph (ProcessingGraph* newAudioGraph)
 
     ProcessingGraph* oldAudioGraph = audioGraph;
 
-    {
-        const ScopedLock sl (owner->getCallbackLock());
-        audioGraph = newAudioGraph;
-    }
+    // publish the new graph only when fully built
+    Atomic::memoryBarrier ();
+    audioGraph = newAudioGraph;
+
+    if (oldAudioGraph != newAudioGraph)
+        retiredObjects.retireGraph (oldAudioGraph);
 
-    if (oldAudioGraph)
-        delete oldAudioGraph;
+    updateLatencyCompensation ();
 
     // notify listeners        
     for (int i = 0; i < listeners.size (); i++)
@@ -311,15 +331,53 @@ void Host::changePluginAudioGraph (ProcessingGraph* newAudioGraph)
 }
 
 //==============================================================================
-void Host::openPlugin (BasePlugin* plugin, const bool suspendAudio)
+int Host::getTotalLatency () const
+{
+    return latencyCompensation ? latencyCompensation->getTotalLatency () : 0;
+}
+
+void Host::updateLatencyCompensation ()
+{
+    DBG ("Host::updateLatencyCompensation");
+
+    LatencyCompensation* oldCompensation = latencyCompensation;
+
+    // the audio thread will pick it up only together with its graph
+    LatencyCompensation* newCompensation = new LatencyCompensation (audioGraph, outputPlugin);
+    Atomic::memoryBarrier ();
+    latencyCompensation = newCompensation;
+
+    retiredObjects.retireLatencyCompensation (oldCompensation);
+
+    // report what we are adding to the signal
+    transport->setLatencySamples (newCompensation->getTotalLatency ());
+    owner->setLatencySamples (newCompensation->getTotalLatency ());
+}
+
+void Host::audioProcessorParameterChanged (AudioProcessor*, int, float)
+{
+}
+
+void Host::audioProcessorChanged (AudioProcessor*)
+{
+    // this could come from the audio thread, rebuild on the message thread
+    triggerAsyncUpdate ();
+}
+
+void Host::handleAsyncUpdate ()
+{
+    // programs and names changes end up here too, recompute only when needed
+    if (latencyCompensation && latencyCompensation->isOutOfDate ())
+        updateLatencyCompensation ();
+}
+
+//==============================================================================
+void Host::openPlugin (BasePlugin* plugin)
 {
     if (plugin)
     {
         DBG ("Host::openPlugin");
 
-        if (suspendAudio)
-             owner->suspendProcessing (true);
-
         // make it a child, and allocate buffers
         plugin->setParentHost (owner);
 
@@ -337,9 +395,6 @@ void Host::openPlugin (BasePlugin* plugin, const bool suspendAudio)
         // try to open correctly the plugin
         plugin->prepareToPlay (sampleRate, samplesPerBlock);
 
-        if (suspendAudio)
-             owner->suspendProcessing (false);
-             
         // notify listeners        
         for (int i = 0; i < listeners.size (); i++)
             ((HostListener*) listeners.getUnchecked (i))->pluginAdded (this, plugin);
@@ -347,41 +402,33 @@ void Host::openPlugin (BasePlugin* plugin, const bool suspendAudio)
 }
 
 //==============================================================================
-void Host::closePlugin (BasePlugin* plugin, const bool suspendAudio)
+void Host::closePlugin (BasePlugin* plugin)
 {
     if (plugin)
     {
         DBG ("Host::closePlugin");
 
-        if (suspendAudio)
-             owner->suspendProcessing (true);
-
+        // unpublish it, the audio thread will skip the node from now on
         if (audioGraph)
             audioGraph->resetNodeData (plugin);
 
-        // release resources and close plugin
-        plugin->releaseResources ();
         plugins.removeObject (plugin, false);
-
-        if (suspendAudio)
-             owner->suspendProcessing (false);
+        plugin->removeListener (this);
 
         // notify listeners
         for (int i = 0; i < listeners.size (); i++)
             ((HostListener*) listeners.getUnchecked (i))->pluginRemoved (this, plugin);
 
-        delete plugin;
+        // release resources and close plugin when the audio thread is past it
+        retiredObjects.retirePlugin (plugin);
     }
 }
 
 //==============================================================================
-void Host::closeAllPlugins (const bool suspendAudio)
+void Host::closeAllPlugins ()
 {
     DBG ("Host::closeAllPlugins");
 
-    if (suspendAudio)
-        owner->suspendProcessing (true);
-
     // remove and close all plugins except i/o
     for (int i = plugins.size (); --i >= 0;)
     {
@@ -390,12 +437,40 @@ void Host::closeAllPlugins (const bool suspendAudio)
         if (plugin->getType() != JOST_PLUGINTYPE_INPUT
             && plugin->getType() != JOST_PLUGINTYPE_OUTPUT)
         {
-           closePlugin (plugin, false);
+           closePlugin (plugin);
         }
     }
+}
+
+//==============================================================================
+AnalysisTap* Host::enableOutputAnalysis (BasePlugin* plugin)
+{
+    if (plugin == 0 || plugin->getNumOutputs () <= 0)
+        return 0;
 
-    if (suspendAudio)
-        owner->suspendProcessing (false);
+    AnalysisTap* tap = plugin->getOutputTap ();
+    if (tap == 0)
+    {
+        tap = new AnalysisTap (jmin (2, plugin->getNumOutputs ()));
+        tap->prepare (sampleRate);
+
+        // publish it fully constructed, the audio thread starts pushing right away
+        Atomic::memoryBarrier ();
+        plugin->setOutputTap (tap);
+    }
+
+    return tap;
+}
+
+void Host::disableOutputAnalysis (BasePlugin* plugin)
+{
+    if (plugin == 0 || plugin->getOutputTap () == 0)
+        return;
+
+    AnalysisTap* tap = plugin->getOutputTap ();
+    plugin->setOutputTap (0);
+
+    retiredObjects.retireAnalysisTap (tap);
 }
 
 //==============================================================================
@@ -425,6 +500,12 @@ void Host::prepareToPlay (double sampleRate_, int samplesPerBlock_)
                                           samplesPerBlock);
 
             plugin->prepareToPlay (sampleRate, samplesPerBlock);
+
+            // the filters and bands of a tap are made for a rate, but a new
+            // block size alone doesn't need to throw away what it measured
+            AnalysisTap* const tap = plugin->getOutputTap ();
+            if (tap != 0 && tap->getSampleRate () != sampleRate)
+                tap->prepare (sampleRate);
         }
     }
 }
@@ -470,6 +551,46 @@ void Host::toggleStemRendering()
 }
 
 //==============================================================================
+bool Host::prepareDirectOutputs (ProcessingNode* node,
+                                 const int nodeIndex,
+                                 LatencyCompensation* compensation,
+                                 const float gain)
+{
+    BasePlugin* plugin = (BasePlugin*) node->getData ();
+
+    // the output buffers are needed as they are, or a gain ramp is in progress
+    if (plugin->isOutputMonitored ()
+        || plugin->getOutputTap () != 0
+        || plugin->getCurrentOutputGain () != gain
+        || (renderingStems && plugin->getBoolValue (PROP_RENDERSTEM, false))
+        || ! plugin->canProcessAdding (gain))
+        return false;
+
+    ProcessingNode* destinationNode = node->getSingleDestination (JOST_LINKTYPE_AUDIO,
+                                                                  plugin->getNumOutputs ());
+    if (! destinationNode)
+        return false;
+
+    BasePlugin* destination = (BasePlugin*) destinationNode->getData ();
+    AudioSampleBuffer* destBuffer = destination ? destination->getInputBuffers () : 0;
+    if (! destBuffer)
+        return false;
+
+    for (int i = node->getLinksCount (JOST_LINKTYPE_AUDIO); --i >= 0;)
+    {
+        ProcessingLink* link = node->getLink (JOST_LINKTYPE_AUDIO, i);
+
+        // delayed links still need to go through the compensation
+        if ((compensation && compensation->getLinkDelay (nodeIndex, i) > 0)
+            || link->destinationPort >= destBuffer->getNumChannels ())
+            return false;
+
+        directOutputs [link->sourcePort] = destBuffer->getSampleData (link->destinationPort);
+    }
+
+    return true;
+}
+
 void Host::processBlock (AudioSampleBuffer& buffer,
                          MidiBuffer& midiMessages)
 {
@@ -480,18 +601,39 @@ void Host::processBlock (AudioSampleBuffer& buffer,
     transport->processIncomingMidi (midiMessages);
     transport->processAudioPlayHead (owner->getPlayHead());
 
+    // denormals are flushed for the whole graph, unless a plugin opts out
+    const ScopedDenormalsMode flushDenormals (true);
+
+    // from now on anything retired by the message thread is kept alive
+    renderEpoch.enterRender ();
+
+    // the plugin array can change under our feet, so only walk the graph
+    ProcessingGraph* const graph = audioGraph;
+
+    // a compensation is only valid for the graph it was computed for
+    LatencyCompensation* compensation = latencyCompensation;
+    if (compensation && compensation->getGraph () != graph)
+        compensation = 0;
+
     // process midi for plugins
-    for (int j = plugins.size (); --j >= 0;)
-        plugins.getUnchecked (j)->clearMidiBuffers ();
-    
+    if (graph)
+    {
+        for (int j = graph->getNodeCount (); --j >= 0;)
+        {
+            BasePlugin* plugin = (BasePlugin*) graph->getData (j);
+            if (plugin)
+                plugin->clearMidiBuffers ();
+        }
+    }
+
     MidiManipulator manip;
     
     // process audio for plugins
-    if (audioGraph)
+    if (graph)
     {
-        for (int j = 0; j < audioGraph->getNodeCount (); j++)
+        for (int j = 0; j < graph->getNodeCount (); j++)
         {
-            ProcessingNode* node = audioGraph->getNode (j);
+            ProcessingNode* node = graph->getNode (j);
             currentPlugin = (BasePlugin*) node->getData ();
             
             if (!currentPlugin)
@@ -502,6 +644,7 @@ void Host::processBlock (AudioSampleBuffer& buffer,
             // handle logic of mapping i/o --
             AudioSampleBuffer* inBuffers = currentPlugin->getInputBuffers ();
             AudioSampleBuffer* outBuffers = currentPlugin->getOutputBuffers ();
+            bool summedToDestination = false;
 
             // process audio --
             if (currentPlugin->isBypass ()
@@ -524,7 +667,25 @@ void Host::processBlock (AudioSampleBuffer& buffer,
             }
             else
             {
-                currentPlugin->processBlock (buffer, midiMessages);
+                const float directGain = currentPlugin->isMuted () ? 0.0f
+                                                                   : currentPlugin->getOutputGain ();
+
+                // a plugin feeding a single node can sum straight into its inputs
+                summedToDestination = prepareDirectOutputs (node, j, compensation, directGain);
+
+                {
+                    // plugins that opt out get denormals back
+                    const ScopedDenormalsMode pluginDenormals (! currentPlugin->isDenormalsAllowed ());
+
+                    if (summedToDestination)
+                        currentPlugin->processBlockAdding (buffer, midiMessages, directOutputs, directGain);
+                    else
+                        currentPlugin->processBlock (buffer, midiMessages);
+                }
+
+                // catch plugins falling in a denormal storm (x87 code is not flushed)
+                if (! summedToDestination)
+                    currentPlugin->checkOutputDenormals (blockSamples);
 
 #if 0
                 // this should be keep or not ? probably it will create problems
@@ -541,7 +702,7 @@ void Host::processBlock (AudioSampleBuffer& buffer,
             
             }
 
-            if (outBuffers)
+            if (outBuffers && ! summedToDestination)
             {
                 const float currentOutputGain = currentPlugin->getCurrentOutputGain ();
                 const float desiredOutputGain = currentPlugin->isMuted() ? 0.0f
@@ -559,6 +720,11 @@ void Host::processBlock (AudioSampleBuffer& buffer,
 
                 currentPlugin->setCurrentOutputGain (desiredOutputGain);
 
+                // feed the analysers, this only copies into their rings --
+                AnalysisTap* const outputTap = currentPlugin->getOutputTap ();
+                if (outputTap)
+                    outputTap->pushSamples (*outBuffers, 0, blockSamples);
+
                 // process routing --
                 for (int i = node->getLinksCount (JOST_LINKTYPE_AUDIO); --i >= 0;)
                 {
@@ -570,13 +736,28 @@ void Host::processBlock (AudioSampleBuffer& buffer,
                         AudioSampleBuffer* destBuffer = destination->getInputBuffers();
                         if (destBuffer)
                         {
-                            destBuffer->addFrom (link->destinationPort,
-                                                 0,
-                                                 outBuffers->getSampleData (link->sourcePort),
-                                                 blockSamples);
+                            if (compensation && compensation->getLinkDelay (j, i) > 0)
+                            {
+                                compensation->addDelayed (j,
+                                                          i,
+                                                          destBuffer->getSampleData (link->destinationPort),
+                                                          outBuffers->getSampleData (link->sourcePort),
+                                                          blockSamples);
+                            }
+                            else
+                            {
+                                destBuffer->addFrom (link->destinationPort,
+                                                     0,
+                                                     outBuffers->getSampleData (link->sourcePort),
+                                                     blockSamples);
+                            }
                         }
                     }
                 }
+
+                // keep history for the delayed links --
+                if (compensation)
+                    compensation->storeHistory (j, *outBuffers, blockSamples);
             }
 
             // clear input buffers (avoid zipper noise, but can be optimized) --
@@ -616,6 +797,8 @@ void Host::processBlock (AudioSampleBuffer& buffer,
 
     currentPlugin = 0;
 
+    renderEpoch.exitRender ();
+
     // process transport
     transport->processBlock (blockSamples);
 }
@@ -766,7 +949,7 @@ void Host::loadFromXml (XmlElement* xml)
                 "Something may be broken... sorry for that! \n");
 
     // remove already added plugins
-    closeAllPlugins (false);
+    closeAllPlugins ();
 
     if (plugins.contains (inputPlugin));
         plugins.removeObject (inputPlugin, false);
@@ -849,8 +1032,8 @@ void Host::loadFromXml (XmlElement* xml)
                 XmlElement* ext = e->getChildByName (T("options"));
                 if (ext) plugin->loadPropertiesFromXml (ext);
 
-                // add plugin (do not suspend processing)
-                openPlugin (plugin, false);
+                // add plugin
+                openPlugin (plugin);
                 addPlugin (plugin);
 
                 // XXX - is this needed here ?
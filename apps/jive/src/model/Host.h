@@ -32,6 +32,7 @@
 #include "../Config.h"
 #include "../Commands.h"
 #include "ProcessingGraph.h"
+#include "RenderEpoch.h"
 #include "PluginLoader.h"
 #include "Transport.h"
 
@@ -120,7 +121,8 @@ protected:
     @see Transport
 
 */
-class Host
+class Host : private AudioProcessorListener,
+             private AsyncUpdater
 {
 public:
 
@@ -186,27 +188,47 @@ public:
     /** Open a plugin
 
         This will only call the initial functions and set initial
-        samplerate and blocksize
+        samplerate and blocksize. The plugin is not seen by the audio
+        thread until it is part of a graph, so the callback keeps running.
 
         @see closePlugin
     */
-    void openPlugin (BasePlugin* plugin, const bool suspendAudio = false);
+    void openPlugin (BasePlugin* plugin);
 
     /** Close a plugin registered with the host
 
-        This will also free any previously allocated plugin buffers.
-        Internal input / output plugins will not be freed !
+        The plugin is removed from the current graph straight away, while
+        releasing its resources and deleting it is deferred until the audio
+        thread has moved past it. Internal input / output plugins will not
+        be freed !
 
         @see addPlugin
     */
-    void closePlugin (BasePlugin* plugin, const bool suspendAudio = true);
+    void closePlugin (BasePlugin* plugin);
 
     /** Close all plugins registered with the host
 
         This will free every plugin currently playing, apart
         from in / out plugins !
     */
-    void closeAllPlugins (const bool suspendAudio = true);
+    void closeAllPlugins ();
+
+    //==============================================================================
+    /** Starts analysing the outputs of a plugin
+
+        The tap is fed by the audio thread after the mixer gain, and is
+        analysed in the background: the gui polls it for results. Calling
+        this again returns the tap already there.
+
+        @see disableOutputAnalysis, AnalysisTap
+    */
+    AnalysisTap* enableOutputAnalysis (BasePlugin* plugin);
+
+    /** Stops analysing the outputs of a plugin
+
+        The tap is deleted once the audio thread has moved past it.
+    */
+    void disableOutputAnalysis (BasePlugin* plugin);
 
     //==============================================================================
     /** Try to load a plugin given a string with the absolute path
@@ -225,7 +247,9 @@ public:
     /** This changes the AUDIO processing order of the plugins
 
         It takes as input an array of integers which are the unique hash
-        that represent every plugin.
+        that represent every plugin. The new graph is published without
+        locking the callback, and the old one is deleted once the audio
+        thread is not using it anymore.
     */
     void changePluginAudioGraph (ProcessingGraph* newAudioGraph);
 
@@ -233,6 +257,14 @@ public:
     /** Returns the current audio graph */
     ProcessingGraph* getAudioGraph () const            { return audioGraph; }
 
+    //==============================================================================
+    /** Returns the latency of the slowest path through the graph
+
+        Every other path is delayed to match it, so this is what the
+        whole host adds to the signal.
+    */
+    int getTotalLatency () const;
+
     //==============================================================================
     /** Add a listener to this host */
     void addListener (HostListener* listener);
@@ -255,6 +287,16 @@ public:
    
 private:
 
+    //==============================================================================
+    void updateLatencyCompensation ();
+    void audioProcessorParameterChanged (AudioProcessor* processor, int parameterIndex, float newValue);
+    void audioProcessorChanged (AudioProcessor* processor);
+    void handleAsyncUpdate ();
+    bool prepareDirectOutputs (ProcessingNode* node,
+                               const int nodeIndex,
+                               LatencyCompensation* compensation,
+                               const float gain);
+
     //==============================================================================
     void saveGraphToXml (XmlElement* element);
     void loadGraphFromXml (XmlElement* element,
@@ -276,6 +318,11 @@ private:
     BasePlugin* currentPlugin;
 
     ProcessingGraph* audioGraph;
+    LatencyCompensation* latencyCompensation;
+
+    float* directOutputs [32];
+    RenderEpoch renderEpoch;
+    DeferredDeletionQueue retiredObjects;
 
     VoidArray listeners;
 
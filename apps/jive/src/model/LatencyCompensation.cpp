@@ -0,0 +1,221 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2007 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU Lesser General Public License, as published by the Free Software
+ Foundation; either version 2 of the License, or (at your option) any later
+ version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+#include "LatencyCompensation.h"
+
+
+//==============================================================================
+LatencyCompensation::LatencyCompensation (ProcessingGraph* graph_, BasePlugin* output)
+  : graph (graph_),
+    numNodes (0),
+    numLinks (0),
+    numLines (0),
+    poolSize (0),
+    totalLatency (0)
+{
+    DBG ("LatencyCompensation::LatencyCompensation");
+
+    jassert (graph != 0);
+
+    numNodes = graph->getNodeCount ();
+
+    VoidArray nodes;
+    for (int j = 0; j < numNodes; j++)
+        nodes.add (graph->getNode (j));
+
+    // index links of every node in a flat array
+    firstLinkOfNode.calloc (numNodes + 1);
+    firstLineOfNode.calloc (numNodes + 1);
+    pluginLatencies.calloc (numNodes + 1);
+
+    for (int j = 0; j < numNodes; j++)
+    {
+        firstLinkOfNode [j] = numLinks;
+        numLinks += graph->getNode (j)->getLinksCount (JOST_LINKTYPE_AUDIO);
+    }
+    firstLinkOfNode [numNodes] = numLinks;
+
+    linkDelays.calloc (numLinks + 1);
+    linkLines.calloc (numLinks + 1);
+    lines.calloc (numLinks + 1);
+
+    // accumulate latencies in processing order, links going back are feedback
+    HeapBlock<int> inputLatencies, outputLatencies;
+    inputLatencies.calloc (numNodes + 1);
+    outputLatencies.calloc (numNodes + 1);
+
+    for (int j = 0; j < numNodes; j++)
+    {
+        ProcessingNode* node = graph->getNode (j);
+        BasePlugin* plugin = (BasePlugin*) node->getData ();
+
+        pluginLatencies [j] = plugin ? plugin->getPluginLatency () : 0;
+        outputLatencies [j] = inputLatencies [j] + pluginLatencies [j];
+
+        for (int i = 0; i < node->getLinksCount (JOST_LINKTYPE_AUDIO); i++)
+        {
+            const int destination = nodes.indexOf (node->getLink (JOST_LINKTYPE_AUDIO, i)->destination);
+            if (destination > j)
+                inputLatencies [destination] = jmax (inputLatencies [destination], outputLatencies [j]);
+        }
+
+        // the slowest path is the one reaching the output last, dangling nodes don't count
+        if (plugin != 0 && plugin == output)
+            totalLatency = outputLatencies [j];
+    }
+
+    // now find the lag of every link, and one delay line per output port
+    for (int j = 0; j < numNodes; j++)
+    {
+        ProcessingNode* node = graph->getNode (j);
+
+        firstLineOfNode [j] = numLines;
+
+        for (int i = 0; i < node->getLinksCount (JOST_LINKTYPE_AUDIO); i++)
+        {
+            ProcessingLink* link = node->getLink (JOST_LINKTYPE_AUDIO, i);
+            const int destination = nodes.indexOf (link->destination);
+            const int k = firstLinkOfNode [j] + i;
+
+            linkLines [k] = -1;
+
+            if (destination <= j)
+                continue;
+
+            linkDelays [k] = inputLatencies [destination] - outputLatencies [j];
+            if (linkDelays [k] <= 0)
+            {
+                linkDelays [k] = 0;
+                continue;
+            }
+
+            int line = firstLineOfNode [j];
+            while (line < numLines && lines [line].port != link->sourcePort)
+                ++line;
+
+            if (line == numLines)
+            {
+                lines [line].port = link->sourcePort;
+                lines [line].length = 0;
+                ++numLines;
+            }
+
+            lines [line].length = jmax (lines [line].length, linkDelays [k]);
+            linkLines [k] = line;
+        }
+    }
+    firstLineOfNode [numNodes] = numLines;
+
+    // lay out the lines in the pool
+    for (int line = 0; line < numLines; line++)
+    {
+        lines [line].offset = poolSize;
+        lines [line].position = 0;
+        poolSize += lines [line].length;
+    }
+
+    pool.calloc (poolSize + 1);
+}
+
+LatencyCompensation::~LatencyCompensation ()
+{
+    DBG ("LatencyCompensation::~LatencyCompensation");
+}
+
+//==============================================================================
+bool LatencyCompensation::isOutOfDate () const
+{
+    if (graph->getNodeCount () != numNodes)
+        return true;
+
+    for (int j = 0; j < numNodes; j++)
+    {
+        BasePlugin* plugin = (BasePlugin*) graph->getData (j);
+
+        if ((plugin ? plugin->getPluginLatency () : 0) != pluginLatencies [j])
+            return true;
+    }
+
+    return false;
+}
+
+//==============================================================================
+void LatencyCompensation::addDelayed (const int nodeIndex,
+                                      const int linkIndex,
+                                      float* destination,
+                                      const float* source,
+                                      const int numSamples)
+{
+    const int k = firstLinkOfNode [nodeIndex] + linkIndex;
+    const int lag = linkDelays [k];
+    const DelayLine& line = lines [linkLines [k]];
+    const float* ring = pool + line.offset;
+
+    // the first part of the block comes from the history
+    const int numFromHistory = jmin (lag, numSamples);
+
+    int readPosition = line.position - lag;
+    if (readPosition < 0)
+        readPosition += line.length;
+
+    for (int i = 0; i < numFromHistory; i++)
+    {
+        destination [i] += ring [readPosition];
+
+        if (++readPosition >= line.length)
+            readPosition = 0;
+    }
+
+    // the rest is the current block, shifted
+    for (int i = numFromHistory; i < numSamples; i++)
+        destination [i] += source [i - lag];
+}
+
+void LatencyCompensation::storeHistory (const int nodeIndex,
+                                        AudioSampleBuffer& outputs,
+                                        const int numSamples)
+{
+    for (int l = firstLineOfNode [nodeIndex]; l < firstLineOfNode [nodeIndex + 1]; l++)
+    {
+        DelayLine& line = lines [l];
+        float* ring = pool + line.offset;
+
+        // only the last samples of a block longer than the line are needed
+        const int numToStore = jmin (numSamples, line.length);
+        const float* source = outputs.getSampleData (line.port) + (numSamples - numToStore);
+
+        for (int i = 0; i < numToStore; i++)
+        {
+            ring [line.position] = source [i];
+
+            if (++line.position >= line.length)
+                line.position = 0;
+        }
+    }
+}
+
@@ -0,0 +1,141 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2007 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU Lesser General Public License, as published by the Free Software
+ Foundation; either version 2 of the License, or (at your option) any later
+ version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+#ifndef __JUCETICE_JOSTLATENCYCOMPENSATION_HEADER__
+#define __JUCETICE_JOSTLATENCYCOMPENSATION_HEADER__
+
+#include "ProcessingGraph.h"
+
+
+//==============================================================================
+/**
+    Plugin delay compensation for a processing graph.
+
+    When constructed, it walks the graph in processing order, accumulating the
+    latency reported by every plugin along each path, and finds how much every
+    audio link has to be delayed so that all the signals reaching a plugin
+    are aligned with its slowest input.
+
+    Delays are taken from a single pool: every compensated output port owns a
+    ring buffer exactly as long as the biggest lag requested by its links, and
+    each link reads its own tap out of it.
+
+    The total latency is the one of the slowest path reaching the output plugin,
+    so plugins left unconnected don't add anything to what the host reports.
+
+    The object is immutable from the graph point of view, so when the graph
+    changes or a plugin changes its latency a new one is built and swapped in.
+*/
+class LatencyCompensation
+{
+public:
+
+    //==============================================================================
+    /** Computes the compensation needed by a graph
+
+        The output is the plugin whose input latency is reported as the
+        total one, it could be null or not part of the graph yet.
+    */
+    LatencyCompensation (ProcessingGraph* graph, BasePlugin* output);
+
+    /** Destructor */
+    ~LatencyCompensation ();
+
+    //==============================================================================
+    /** Returns the graph this compensation was computed for */
+    ProcessingGraph* getGraph () const                  { return graph; }
+
+    /** Returns the latency of the slowest path reaching the output */
+    int getTotalLatency () const                        { return totalLatency; }
+
+    /** Returns the number of samples held by the delay pool */
+    int getPoolSize () const                            { return poolSize; }
+
+    //==============================================================================
+    /** Returns true if any plugin now reports a different latency
+
+        This should be called from the message thread.
+    */
+    bool isOutOfDate () const;
+
+    //==============================================================================
+    /** Returns the lag needed by a link of a node, in samples */
+    inline int getLinkDelay (const int nodeIndex, const int linkIndex) const
+    {
+        return linkDelays [firstLinkOfNode [nodeIndex] + linkIndex];
+    }
+
+    /** Adds a delayed output port to a destination buffer
+
+        This must be called for every link of a node with a delay, before
+        calling storeHistory for the same node.
+    */
+    void addDelayed (const int nodeIndex,
+                     const int linkIndex,
+                     float* destination,
+                     const float* source,
+                     const int numSamples);
+
+    /** Pushes the node outputs in the delay lines, after all the links are done */
+    void storeHistory (const int nodeIndex,
+                       AudioSampleBuffer& outputs,
+                       const int numSamples);
+
+    //==============================================================================
+    juce_UseDebuggingNewOperator
+
+private:
+
+    struct DelayLine
+    {
+        int port;
+        int offset;
+        int length;
+        int position;
+    };
+
+    ProcessingGraph* graph;
+    int numNodes, numLinks, numLines;
+
+    HeapBlock<int> pluginLatencies;
+    HeapBlock<int> firstLinkOfNode;
+    HeapBlock<int> firstLineOfNode;
+    HeapBlock<int> linkDelays;
+    HeapBlock<int> linkLines;
+    HeapBlock<DelayLine> lines;
+    HeapBlock<float> pool;
+
+    int poolSize;
+    int totalLatency;
+
+    LatencyCompensation (const LatencyCompensation&);
+    const LatencyCompensation& operator= (const LatencyCompensation&);
+};
+
+
+#endif
@@ -100,6 +100,37 @@ public:
         return (ProcessingLink*) links[type].getUnchecked (index);
     }
 
+    /** Returns the only node this one is sending to, if the links allow it
+
+        This is the case when every one of the first numPorts source ports is
+        connected exactly once, all to the same node, which is not this one.
+        Returns 0 otherwise (up to 32 ports are handled).
+    */
+    ProcessingNode* getSingleDestination (const int type, const int numPorts) const
+    {
+        if (numPorts <= 0 || numPorts > 32 || links[type].size () != numPorts)
+            return 0;
+
+        ProcessingNode* destination = getLink (type, 0)->destination;
+        if (destination == this)
+            return 0;
+
+        uint32 usedPorts = 0;
+        for (int i = 0; i < numPorts; i++)
+        {
+            ProcessingLink* link = getLink (type, i);
+
+            if (link->destination != destination
+                || link->sourcePort < 0 || link->sourcePort >= numPorts
+                || (usedPorts & (1 << link->sourcePort)) != 0)
+                return 0;
+
+            usedPorts |= (1 << link->sourcePort);
+        }
+
+        return destination;
+    }
+
     /** Clears all available connections, freeing up */
     inline void deleteAllLinks (const int type = -1)
     {
@@ -0,0 +1,203 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2007 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU Lesser General Public License, as published by the Free Software
+ Foundation; either version 2 of the License, or (at your option) any later
+ version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+#ifndef __JUCETICE_JOSTRENDEREPOCH_HEADER__
+#define __JUCETICE_JOSTRENDEREPOCH_HEADER__
+
+#include "ProcessingGraph.h"
+#include "LatencyCompensation.h"
+
+
+//==============================================================================
+/**
+    Tells other threads when the audio thread has moved past a render.
+
+    The audio thread bumps the counter when it enters and when it leaves the
+    callback, so an odd value means a render is in progress. Anything that
+    was unpublished before taking a snapshot can be freed as soon as the
+    snapshot was even (the audio thread was idle) or the counter has moved on.
+*/
+class RenderEpoch
+{
+public:
+
+    //==============================================================================
+    RenderEpoch ()
+        : counter (0)
+    {
+    }
+
+    //==============================================================================
+    /** Called by the audio thread before reading the published graph */
+    inline void enterRender ()                          { Atomic::increment (counter); }
+
+    /** Called by the audio thread after it has finished with the graph */
+    inline void exitRender ()                           { Atomic::increment (counter); }
+
+    //==============================================================================
+    /** Returns the current epoch, to be taken after having unpublished something */
+    int getSnapshot () const
+    {
+        Atomic::memoryBarrier ();
+        return *((const volatile int*) &counter);
+    }
+
+    /** Returns true if the audio thread can't see anything unpublished before the snapshot */
+    bool hasMovedPast (const int snapshot) const
+    {
+        return (snapshot & 1) == 0 || getSnapshot () != snapshot;
+    }
+
+private:
+
+    int counter;
+};
+
+
+//==============================================================================
+/**
+    Keeps objects removed from the render until they can be freed.
+
+    Objects are retired from the message thread right after being unpublished,
+    and are released when the audio thread is known to have moved past them,
+    so removing a plugin never needs to suspend the callback.
+*/
+class DeferredDeletionQueue : private Timer
+{
+public:
+
+    //==============================================================================
+    DeferredDeletionQueue (const RenderEpoch& epoch_)
+        : epoch (epoch_)
+    {
+    }
+
+    ~DeferredDeletionQueue ()
+    {
+        flush ();
+    }
+
+    //==============================================================================
+    /** Release resources and delete a plugin once the audio thread is past it */
+    void retirePlugin (BasePlugin* plugin)              { retire (plugin, 0, 0, 0); }
+
+    /** Delete a graph once the audio thread is past it */
+    void retireGraph (ProcessingGraph* graph)           { retire (0, graph, 0, 0); }
+
+    /** Delete a latency compensation once the audio thread is past it */
+    void retireLatencyCompensation (LatencyCompensation* compensation)
+    {
+        retire (0, 0, compensation, 0);
+    }
+
+    /** Delete an analysis tap once the audio thread is past it */
+    void retireAnalysisTap (AnalysisTap* tap)           { retire (0, 0, 0, tap); }
+
+    //==============================================================================
+    /** Waits until every retired object has been freed */
+    void flush ()
+    {
+        while (deleteExpired () > 0)
+            Thread::sleep (1);
+
+        stopTimer ();
+    }
+
+private:
+
+    //==============================================================================
+    class RetiredObject
+    {
+    public:
+        RetiredObject (BasePlugin* plugin_,
+                       ProcessingGraph* graph_,
+                       LatencyCompensation* compensation_,
+                       AnalysisTap* tap_,
+                       const int snapshot_)
+            : plugin (plugin_), graph (graph_), compensation (compensation_), tap (tap_), snapshot (snapshot_)
+        {
+        }
+
+        ~RetiredObject ()
+        {
+            if (plugin)
+            {
+                plugin->releaseResources ();
+                delete plugin;
+            }
+
+            delete graph;
+            delete compensation;
+            delete tap;
+        }
+
+        BasePlugin* plugin;
+        ProcessingGraph* graph;
+        LatencyCompensation* compensation;
+        AnalysisTap* tap;
+        const int snapshot;
+    };
+
+    //==============================================================================
+    void retire (BasePlugin* plugin, ProcessingGraph* graph, LatencyCompensation* compensation, AnalysisTap* tap)
+    {
+        if (plugin == 0 && graph == 0 && compensation == 0 && tap == 0)
+            return;
+
+        retired.add (new RetiredObject (plugin, graph, compensation, tap, epoch.getSnapshot ()));
+
+        if (deleteExpired () > 0)
+            startTimer (10);
+    }
+
+    int deleteExpired ()
+    {
+        for (int i = retired.size (); --i >= 0;)
+        {
+            if (epoch.hasMovedPast (retired.getUnchecked (i)->snapshot))
+                retired.remove (i, true);
+        }
+
+        return retired.size ();
+    }
+
+    void timerCallback ()
+    {
+        if (deleteExpired () == 0)
+            stopTimer ();
+    }
+
+    const RenderEpoch& epoch;
+    OwnedArray<RetiredObject> retired;
+
+    DeferredDeletionQueue (const DeferredDeletionQueue&);
+    const DeferredDeletionQueue& operator= (const DeferredDeletionQueue&);
+};
+
+
+#endif
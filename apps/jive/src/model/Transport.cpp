@@ -52,7 +52,8 @@ Transport::Transport (HostFilterBase* owner_)
     doAllNotesOff (false),
     ensureAllNotesOffGetsNoticed(0),
     externalTransport (0),
-    curAbsolute(0)
+    curAbsolute(0),
+    latencySamples (0)
 {
     DBG ("Transport::Transport");
 
@@ -473,6 +474,17 @@ void Transport::setTempo (const double newTempo)
     setTimeSignature (newTempo, numBars, divDenominator);
 }
 
+//==============================================================================
+void Transport::setLatencySamples (const int newLatency)
+{
+    if (latencySamples != newLatency)
+    {
+        latencySamples = newLatency;
+
+        sendChangeMessage (this);
+    }
+}
+
 //==============================================================================
 void Transport::setPositionAbsolute (const float newPos)
 {
@@ -192,6 +192,14 @@ public:
     void setRightLocator (const float beatNumber);
     float getRightLocator () const                   { return rightLocator / (float) framesPerBeat; }
 
+    //==============================================================================
+    /** Set the latency added by the host delay compensation
+
+        Listeners are notified only if the value changes.
+    */
+    void setLatencySamples (const int newLatency);
+    int getLatencySamples () const                   { return latencySamples; }
+
     //==============================================================================
     int getDurationInFrames () const                 { return sequenceDurationFrames; }
     int getFramesPerBeat () const                    { return framesPerBeat; }
@@ -232,6 +240,8 @@ private:
 
     double curAbsolute;
 
+    int latencySamples;
+
     // internal state bitflags
     bool playing        : 1,
          looping        : 1,
@@ -307,11 +307,8 @@ void DssiPlugin::releaseResources()
 }
 
 //==============================================================================
-void DssiPlugin::processBlock (AudioSampleBuffer& buffer,
-                               MidiBuffer& midiMessages)
+void DssiPlugin::prepareBlock (const int blockSize)
 {
-    const int blockSize = buffer.getNumSamples ();
-
     MidiBuffer* midiBuffer = midiBuffers.getUnchecked (0);
 
     // add events from keyboards
@@ -330,6 +327,18 @@ void DssiPlugin::processBlock (AudioSampleBuffer& buffer,
         // connect ports
         for (int i = 0; i < ins.size (); i++)
             ladspa->connect_port (plugin, ins [i], inputBuffer->getSampleData (i));
+    }
+}
+
+void DssiPlugin::processBlock (AudioSampleBuffer& buffer,
+                               MidiBuffer& midiMessages)
+{
+    const int blockSize = buffer.getNumSamples ();
+
+    prepareBlock (blockSize);
+
+    if (ptrPlug && ladspa)
+    {
         for (int i = 0; i < outs.size (); i++)
             ladspa->connect_port (plugin, outs [i], outputBuffer->getSampleData (i));
 
@@ -365,6 +374,8 @@ void DssiPlugin::processBlock (AudioSampleBuffer& buffer,
         else if (ptrPlug->run_synth_adding)
         {
             outputBuffer->clear ();
+            if (ladspa->set_run_adding_gain)
+                ladspa->set_run_adding_gain (plugin, 1.0f);
             ptrPlug->run_synth_adding (plugin,
                                        blockSize,
                                        midiManager.getMidiEvents (),
@@ -380,6 +391,8 @@ void DssiPlugin::processBlock (AudioSampleBuffer& buffer,
         else if (ladspa->run_adding)
         {
             outputBuffer->clear ();
+            if (ladspa->set_run_adding_gain)
+                ladspa->set_run_adding_gain (plugin, 1.0f);
             ladspa->run_adding (plugin, blockSize);
         }
         else
@@ -389,6 +402,63 @@ void DssiPlugin::processBlock (AudioSampleBuffer& buffer,
     }
 }
 
+bool DssiPlugin::canProcessAdding (const float gain) const
+{
+    if (ptrPlug == 0 || ladspa == 0)
+        return false;
+
+    if (ladspa->set_run_adding_gain == 0 && gain != 1.0f)
+        return false;
+
+    // a plain ladspa run_adding is fine only if we don't lose midi with it
+    return ptrPlug->run_synth_adding != 0
+           || (ptrPlug->run_synth == 0 && ptrPlug->run_multiple_synths_adding != 0)
+           || (ptrPlug->run_synth == 0 && ptrPlug->run_multiple_synths == 0 && ladspa->run_adding != 0);
+}
+
+void DssiPlugin::processBlockAdding (AudioSampleBuffer& buffer,
+                                     MidiBuffer& midiMessages,
+                                     float** destinations,
+                                     const float gain)
+{
+    const int blockSize = buffer.getNumSamples ();
+
+    jassert (canProcessAdding (gain));
+
+    prepareBlock (blockSize);
+
+    // outputs are summed straight into the destination inputs
+    for (int i = 0; i < outs.size (); i++)
+        ladspa->connect_port (plugin, outs [i], destinations [i]);
+
+    if (ladspa->set_run_adding_gain)
+        ladspa->set_run_adding_gain (plugin, gain);
+
+    if (ptrPlug->run_synth_adding)
+    {
+        ptrPlug->run_synth_adding (plugin,
+                                   blockSize,
+                                   midiManager.getMidiEvents (),
+                                   midiManager.getMidiEventsCount ());
+    }
+    else if (ptrPlug->run_multiple_synths_adding)
+    {
+        LADSPA_Handle instance = plugin;
+        snd_seq_event_t* events = midiManager.getMidiEvents ();
+        unsigned long eventsCount = midiManager.getMidiEventsCount ();
+
+        ptrPlug->run_multiple_synths_adding (1,
+                                             &instance,
+                                             blockSize,
+                                             &events,
+                                             &eventsCount);
+    }
+    else
+    {
+        ladspa->run_adding (plugin, blockSize);
+    }
+}
+
 //==============================================================================
 void DssiPlugin::setParameterReal (int index, float value)
 {
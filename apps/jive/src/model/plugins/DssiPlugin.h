@@ -100,6 +100,9 @@ public:
 
     //==============================================================================
     void processBlock (AudioSampleBuffer& buffer, MidiBuffer& midiMessages);
+    bool canProcessAdding (const float gain) const;
+    void processBlockAdding (AudioSampleBuffer& buffer, MidiBuffer& midiMessages,
+                             float** destinations, const float gain);
     void prepareToPlay (double sampleRate, int samplesPerBlock);
     void releaseResources();
 
@@ -133,6 +136,7 @@ public:
 private:
 
     //==============================================================================
+    void prepareBlock (const int blockSize);
     void setDefaultProgram ();
 
     //==============================================================================
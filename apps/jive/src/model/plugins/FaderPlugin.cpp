@@ -89,32 +89,37 @@ void FaderPlugin::processBlock (AudioSampleBuffer& buffer,
 
       // add events from keyboards
       keyboardState.processNextMidiBuffer(*midiBuffer, 0, blockSize, true);
-
-      // process midi automation
-      midiAutomatorManager.handleMidiMessageBuffer(*midiBuffer);
    }
    
-   if (inputBuffer && outputBuffer && blockSize)
+   // with sample accurate automation every slice ramps to the value set at its start
+   for (int sliceStart = 0, sliceEnd; sliceStart < blockSize; sliceStart = sliceEnd)
    {
-      // do the plugin work:
-      // apply 1.0-faderPosition gain to input A l+r (chs 1 & 2 in buffer)
-      float inverseStart = 1.0-prevFaderPosition;
-      float inverseEnd = 1.0-faderPosition;
-      for (int i = 0; i < 2; i++)
-         inputBuffer->applyGainRamp(i, 0, blockSize, inverseStart, inverseEnd);
-      // apply faderPosition gain to input B l+r  (chs 3 & 4 in buffer)
-      for (int i = 2; i < 4; i++)
-         inputBuffer->applyGainRamp(i, 0, blockSize, prevFaderPosition, faderPosition);
-         
-      // sum into output l+r (ch 1 & 2 of buffer)
-      for (int i=0; i<2; i++)
+      // process midi automation
+      sliceEnd = processAutomationSlice (*midiBuffer, sliceStart, blockSize);
+      const int sliceSize = sliceEnd - sliceStart;
+
+      if (inputBuffer && outputBuffer)
       {
-         outputBuffer->copyFrom(i, 0, *inputBuffer, i, 0, blockSize);
-         outputBuffer->addFrom(i, 0, *inputBuffer, i+2, 0, blockSize);
+         // do the plugin work:
+         // apply 1.0-faderPosition gain to input A l+r (chs 1 & 2 in buffer)
+         float inverseStart = 1.0-prevFaderPosition;
+         float inverseEnd = 1.0-faderPosition;
+         for (int i = 0; i < 2; i++)
+            inputBuffer->applyGainRamp(i, sliceStart, sliceSize, inverseStart, inverseEnd);
+         // apply faderPosition gain to input B l+r  (chs 3 & 4 in buffer)
+         for (int i = 2; i < 4; i++)
+            inputBuffer->applyGainRamp(i, sliceStart, sliceSize, prevFaderPosition, faderPosition);
+         
+         // sum into output l+r (ch 1 & 2 of buffer)
+         for (int i=0; i<2; i++)
+         {
+            outputBuffer->copyFrom(i, sliceStart, *inputBuffer, i, sliceStart, sliceSize);
+            outputBuffer->addFrom(i, sliceStart, *inputBuffer, i+2, sliceStart, sliceSize);
+         }
       }
+
+      prevFaderPosition = faderPosition;
    }
-   
-   prevFaderPosition = faderPosition;
 }
 
 //==============================================================================
@@ -127,9 +132,9 @@ void FaderPlugin::setParameterReal (int index, float value)
 {
    if (index == 0)
    {
-      // we will always ramp changes over one buffer length so it's smooth
+      // we will always ramp changes over one buffer length (or one automation
+      // slice) so it's smooth, starting from where the last one ended
       // note potential for long latency if buffer size is big
-      prevFaderPosition = faderPosition;
       faderPosition = value;
    }
 }
@@ -198,11 +198,8 @@ void LadspaPlugin::releaseResources()
 }
 
 //==============================================================================
-void LadspaPlugin::processBlock (AudioSampleBuffer& buffer,
-                                 MidiBuffer& midiMessages)
+void LadspaPlugin::prepareBlock (const int blockSize)
 {
-    const int blockSize = buffer.getNumSamples ();    
-    
     MidiBuffer* midiBuffer = midiBuffers.getUnchecked (0);
 
     // add events from keyboards
@@ -210,31 +207,89 @@ void LadspaPlugin::processBlock (AudioSampleBuffer& buffer,
                                          0, blockSize,
                                          true);
 
-    // process midi automation
-    midiAutomatorManager.handleMidiMessageBuffer (*midiBuffer);
+}
+
+int LadspaPlugin::prepareSlice (const int sliceStart, const int blockSize)
+{
+    // process midi automation, and see how far we can run with it
+    const int sliceEnd = processAutomationSlice (*midiBuffers.getUnchecked (0), sliceStart, blockSize);
 
+    // connect ports
     if (ptrPlug)
     {
-        // connect ports
         for (int i = 0; i < ins.size (); i++)
-            ptrPlug->connect_port (plugin, ins [i], inputBuffer->getSampleData (i));
-        for (int i = 0; i < outs.size (); i++)
-            ptrPlug->connect_port (plugin, outs [i], outputBuffer->getSampleData (i));
+            ptrPlug->connect_port (plugin, ins [i], inputBuffer->getSampleData (i, sliceStart));
+    }
 
-        // run ladspa
-        if (ptrPlug->run)
-        {
-            ptrPlug->run (plugin, blockSize);
-        }
-        else if (ptrPlug->run_adding)
+    return sliceEnd;
+}
+
+void LadspaPlugin::processBlock (AudioSampleBuffer& buffer,
+                                 MidiBuffer& midiMessages)
+{
+    const int blockSize = buffer.getNumSamples ();    
+
+    prepareBlock (blockSize);
+
+    if (ptrPlug && ! ptrPlug->run && ptrPlug->run_adding)
+    {
+        outputBuffer->clear ();
+
+        if (ptrPlug->set_run_adding_gain)
+            ptrPlug->set_run_adding_gain (plugin, 1.0f);
+    }
+
+    for (int sliceStart = 0, sliceEnd; sliceStart < blockSize; sliceStart = sliceEnd)
+    {
+        sliceEnd = prepareSlice (sliceStart, blockSize);
+
+        if (ptrPlug)
         {
-            outputBuffer->clear ();
-            
-            ptrPlug->run_adding (plugin, blockSize);
+            for (int i = 0; i < outs.size (); i++)
+                ptrPlug->connect_port (plugin, outs [i], outputBuffer->getSampleData (i, sliceStart));
+
+            // run ladspa
+            if (ptrPlug->run)
+                ptrPlug->run (plugin, sliceEnd - sliceStart);
+            else if (ptrPlug->run_adding)
+                ptrPlug->run_adding (plugin, sliceEnd - sliceStart);
         }
     }
 }
 
+bool LadspaPlugin::canProcessAdding (const float gain) const
+{
+    return ptrPlug != 0
+           && ptrPlug->run_adding != 0
+           && (ptrPlug->set_run_adding_gain != 0 || gain == 1.0f);
+}
+
+void LadspaPlugin::processBlockAdding (AudioSampleBuffer& buffer,
+                                       MidiBuffer& midiMessages,
+                                       float** destinations,
+                                       const float gain)
+{
+    const int blockSize = buffer.getNumSamples ();    
+
+    jassert (canProcessAdding (gain));
+
+    prepareBlock (blockSize);
+
+    if (ptrPlug->set_run_adding_gain)
+        ptrPlug->set_run_adding_gain (plugin, gain);
+
+    for (int sliceStart = 0, sliceEnd; sliceStart < blockSize; sliceStart = sliceEnd)
+    {
+        sliceEnd = prepareSlice (sliceStart, blockSize);
+
+        // outputs are summed straight into the destination inputs
+        for (int i = 0; i < outs.size (); i++)
+            ptrPlug->connect_port (plugin, outs [i], destinations [i] + sliceStart);
+
+        ptrPlug->run_adding (plugin, sliceEnd - sliceStart);
+    }
+}
+
 //==============================================================================
 void LadspaPlugin::setParameterReal (int index, float value)
 {
@@ -67,6 +67,9 @@ public:
 
     //==============================================================================
     void processBlock (AudioSampleBuffer& buffer, MidiBuffer& midiMessages);
+    bool canProcessAdding (const float gain) const;
+    void processBlockAdding (AudioSampleBuffer& buffer, MidiBuffer& midiMessages,
+                             float** destinations, const float gain);
     void prepareToPlay (double sampleRate, int samplesPerBlock);
     void releaseResources();
 
@@ -84,6 +87,10 @@ public:
 
 private:
 
+    //==============================================================================
+    void prepareBlock (const int blockSize);
+    int prepareSlice (const int sliceStart, const int blockSize);
+
     //==============================================================================
     File pluginFile;
 
@@ -36,6 +36,7 @@
 TrackPlugin::TrackPlugin (const int numChannels_)
   : numChannels (numChannels_),
   audioFile(0),
+  timeline (formatManager, numChannels_),
   transport(0)
 
 {
@@ -56,73 +57,98 @@ TrackPlugin::~TrackPlugin ()
 
 void TrackPlugin::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
-	//transport = getParentHost()->getTransport ();
-	//transport = getChannelHost()->getTransport ();
+	transport = getParentHost() ? getParentHost()->getTransport () : 0;
 
-	//This is using a customized version of audioDeviceAboutToStart!!!
-	// For now I commented it out, until we change the library
-
-	//  audioSourcePlayer.audioDeviceAboutToStart(sampleRate, samplesPerBlock);
+	timeline.prepareToPlay (sampleRate, samplesPerBlock);
 }
 
 void TrackPlugin::releaseResources()
 {
- 
+	timeline.releaseResources ();
 }
 
 //==============================================================================
 void TrackPlugin::processBlock (AudioSampleBuffer& buffer,
                                 MidiBuffer& midiMessages)
 {
-    int blockSize = buffer.getNumSamples ();
-	
-	
-	float* outL [1] = {0};
+    const int blockSize = buffer.getNumSamples ();
+
+	outputBuffer->clear ();
+
+	if (transport == 0)
+		return;
+
+	// the transport moves on after the plugins, so this is the block start
+	const int position = transport->getPositionInFrames ();
+
+	timeline.setTempo (transport->getTempo ());
 
-	for (int i = 0; i < numChannels; i++)
+	if (transport->isPlaying ())
 	{
-		outL[i] = outputBuffer->getSampleData (i);
-	}
-		
-	audioSourcePlayer.audioDeviceIOCallback(0, 0, outL, 1, blockSize);
+		timeline.setLoopStart (transport->isLooping ()
+		                         ? roundFloatToInt (transport->getLeftLocator () * transport->getFramesPerBeat ())
+		                         : -1);
 
+		timeline.renderNextBlock (*outputBuffer, position, blockSize);
+	}
+	else
+	{
+		timeline.setPlayheadPosition (position);
+	}
 }
 
 //==============================================================================
 void TrackPlugin::getStateInformation (MemoryBlock& destData)
 {
+	XmlElement xml (T("track"));
+	timeline.saveToXml (&xml);
 
+	copyXmlToBinary (xml, destData);
 }
 void TrackPlugin::setStateInformation (const void* data, int sizeInBytes)
 {
+	XmlElement* const xml = getXmlFromBinary (data, sizeInBytes);
 
+	if (xml != 0)
+	{
+		timeline.loadFromXml (xml);
+		delete xml;
+	}
 }
 
 //==============================================================================
 void TrackPlugin::createReader(const StringArray &files)
 {
-	audioFile = files[0];
-
-	AudioFormatReader* reader = formatManager.createReaderFor (audioFile);
-	//AudioClip* clip = getEditor()->clipsGrid->clips.getFirst();
-	//AudioFormatReader* reader = clip->getWaveFile();
-	DBG(T("Reader Created"))
+	// the files are laid out one after the other, from the playhead
+	int position = transport ? transport->getPositionInFrames () : 0;
 
-	if (reader != 0)
+	for (int i = 0; i < files.size(); ++i)
 	{
+		audioFile = files[i];
 
-	AudioFormatReaderSource* audioSource1 = new AudioFormatReaderSource (reader, true);
+		AudioFormatReader* reader = formatManager.createReaderFor (audioFile);
+		//AudioClip* clip = getEditor()->clipsGrid->clips.getFirst();
+		//AudioFormatReader* reader = clip->getWaveFile();
 
-	transportSource.setSource (audioSource1,
-									   44100,
-                                       reader->sampleRate);
-	
-	audioSourcePlayer.setSource (&transportSource);
+		if (reader != 0)
+		{
+			DBG(T("Reader Created"))
 
-playFile();
-	}
+			TimelineClip clip;
+			clip.file = File (audioFile);
+			clip.startSample = position;
+			// clips are measured at the host rate, the timeline converts the file
+			const double fileRate = reader->sampleRate > 0.0 ? reader->sampleRate : 44100.0;
+			const double hostRate = getSampleRate () > 0.0 ? getSampleRate () : fileRate;
 
+			clip.lengthSamples = roundDoubleToInt (reader->lengthInSamples * hostRate / fileRate);
 
+			delete reader;
+
+			timeline.addClip (clip);
+			position += clip.lengthSamples;
+		}
+	}
 }
 
 
@@ -140,13 +166,19 @@ AudioProcessorEditor* TrackPlugin::createEditor ()
 //==============================================================================
 void TrackPlugin::playFile()
 {
-	transportSource.setPosition(0.0);
-	transportSource.start();
+	if (transport)
+	{
+		transport->setPositionInFrames (0);
+		transport->play ();
+	}
 }
 void TrackPlugin::stopFile()
 {
-	transportSource.stop();
-	transportSource.setPosition(0.0);
+	if (transport)
+	{
+		transport->stop ();
+		transport->setPositionInFrames (0);
+	}
 }
 /*void TrackPlugin::changeListenerCallback(void *objectThatHasChanged)
 {
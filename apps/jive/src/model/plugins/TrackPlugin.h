@@ -31,6 +31,7 @@
 #define __JUCETICE_JOSTTRACKPLUGIN_HEADER__
 
 #include "../BasePlugin.h"
+#include "../ClipTimeline.h"
 //#include "ChannelHost.h"
 //#include "TrackEditor.h"
 //#include "../../HostFilterBase.h"
@@ -40,7 +41,8 @@
 /**
     This plugin will record and play audio files.
 	Its editor will be a sequencer audio track.
-	It still needs some work, so now it does nothing.
+	It plays the clips of its timeline following the host transport, recording
+	is still to be done.
 	@Spankache
 */
 class TrackPlugin : public BasePlugin
@@ -97,6 +99,9 @@ public:
     //==============================================================================
 	void createReader(const StringArray &files);
 
+	/** Returns the clips played by this track */
+	ClipTimeline& getTimeline ()                      { return timeline; }
+
 	void playFile();
 	void stopFile();
 	//==============================================================================
@@ -110,8 +115,7 @@ private:
 	AudioFormatManager formatManager;
 	String audioFile;
 
-	AudioTransportSource transportSource;
-	AudioSourcePlayer audioSourcePlayer;
+	ClipTimeline timeline;
 	Transport* transport;
 
 protected:
@@ -113,6 +113,7 @@ VstPlugin::VstPlugin ()
   : module (0),
     effect (0),
     flagsEx (0),
+    midiOutputOffset (0),
     sampleRate (44100.0),
     blockSize (512)
 {
@@ -290,6 +291,9 @@ void VstPlugin::prepareToPlay (double sampleRate_, int samplesPerBlock_)
     sampleRate = sampleRate_;
     blockSize = samplesPerBlock_;
 
+    // the slices of the incoming midi are copied here on the audio thread
+    sliceMidi.ensureSize (8192);
+
     dispatch (effSetSampleRate, 0, 0, 0, (float) sampleRate);
     dispatch (effSetBlockSize, 0, jmax (16, blockSize), 0, 0.0f);
 
@@ -333,55 +337,78 @@ void VstPlugin::processBlock (AudioSampleBuffer& buffer,
                                          0, blockSize,
                                          true);
 
-    // process midi automation
-    midiAutomatorManager.handleMidiMessageBuffer (*midiBuffer);
+    const bool receivesMidi = (flagsEx & effFlagsExCanReceiveVstMidiEvents)
+                              || (effect->flags & effFlagsIsSynth);
+
+    if (outputBuffer && ! (effect->flags & effFlagsCanReplacing))
+        outputBuffer->clear ();
 
-    if (flagsEx & effFlagsExCanReceiveVstMidiEvents
-        || effect->flags & effFlagsIsSynth)
+    // with sample accurate automation the block is split at the automation events
+    for (int sliceStart = 0, sliceEnd; sliceStart < blockSize; sliceStart = sliceEnd)
     {
-        // convert midi messages internally
-        midiManager.convertMidiMessages ((*midiBuffer), blockSize);
+        // process midi automation
+        sliceEnd = processAutomationSlice (*midiBuffer, sliceStart, blockSize);
 
-        // call processEvents
-        dispatch (effProcessEvents, 0, 0, (VstEvents*) midiManager.getMidiEvents (), 0.0f);
-    }
+        const int sliceSize = sliceEnd - sliceStart;
 
-    // do the real processing
-    if (inputBuffer)
-    {
-        int numInputs = jmin (effect->numInputs, 128);
-        for (int i = 0; i < numInputs; i++)
-            ptrInputBuffers [i] = inputBuffer->getSampleData (i);
+        if (receivesMidi)
+        {
+            // convert midi messages internally
+            if (sliceSize == blockSize)
+            {
+                midiManager.convertMidiMessages ((*midiBuffer), blockSize);
+            }
+            else
+            {
+                // only the events of this slice, the last one takes the late ones too
+                sliceMidi.clear ();
+                sliceMidi.addEvents (*midiBuffer, sliceStart, sliceEnd < blockSize ? sliceSize : -1, -sliceStart);
 
-        // effect->flags & effFlagsCanMono
-    }
+                midiManager.convertMidiMessages (sliceMidi, sliceSize);
+            }
 
-    if (outputBuffer)
-    {
-        if (! (effect->flags & effFlagsCanReplacing))
-            outputBuffer->clear ();
+            // call processEvents
+            dispatch (effProcessEvents, 0, 0, (VstEvents*) midiManager.getMidiEvents (), 0.0f);
+        }
 
-        int numOutputs = jmin (effect->numOutputs, 128);
-        for (int i = 0; i < numOutputs; i++)
-            ptrOutputBuffers [i] = outputBuffer->getSampleData (i);
-    }
+        // do the real processing
+        if (inputBuffer)
+        {
+            int numInputs = jmin (effect->numInputs, 128);
+            for (int i = 0; i < numInputs; i++)
+                ptrInputBuffers [i] = inputBuffer->getSampleData (i, sliceStart);
 
-    if (effect->flags & effFlagsCanReplacing)
-    {
-        effect->processReplacing (effect,
-                                  ptrInputBuffers,
-                                  ptrOutputBuffers,
-                                  blockSize);
-    }
+            // effect->flags & effFlagsCanMono
+        }
+
+        if (outputBuffer)
+        {
+            int numOutputs = jmin (effect->numOutputs, 128);
+            for (int i = 0; i < numOutputs; i++)
+                ptrOutputBuffers [i] = outputBuffer->getSampleData (i, sliceStart);
+        }
+
+        midiOutputOffset = sliceStart;
+
+        if (effect->flags & effFlagsCanReplacing)
+        {
+            effect->processReplacing (effect,
+                                      ptrInputBuffers,
+                                      ptrOutputBuffers,
+                                      sliceSize);
+        }
 #ifndef VST_FORCE_DEPRECATED
-    else
-    {
-        effect->process (effect,
-                         ptrInputBuffers,
-                         ptrOutputBuffers,
-                         blockSize);
-    }
+        else
+        {
+            effect->process (effect,
+                             ptrInputBuffers,
+                             ptrOutputBuffers,
+                             sliceSize);
+        }
 #endif
+    }
+
+    midiOutputOffset = 0;
 
     // send midi
     if (flagsEx & effFlagsExCanSendVstMidiEvents)
@@ -411,7 +438,7 @@ void VstPlugin::sendMidiEventToOutput (VstEvents* events)
             if (e->type == kVstMidiType)
             {
                 sendToOutMidi.addEvent ((const uint8*) ((const VstMidiEvent*) e)->midiData,
-                                        3, e->deltaFrames);
+                                        3, e->deltaFrames + midiOutputOffset);
             }
         }
     }
@@ -457,6 +484,11 @@ int VstPlugin::getNumMidiInputs () const
     return 1;
 }
 
+int VstPlugin::getPluginLatency () const
+{
+    return effect->initialDelay;
+}
+
 int VstPlugin::getNumMidiOutputs () const
 {
     return (flagsEx & effFlagsExCanSendVstMidiEvents) ? 1 : 0;
@@ -938,10 +970,14 @@ VstIntPtr VstPlugin::handleCallback (VstInt32 opcode, VstInt32 index, VstInt32 v
     case audioMasterCloseFileSelector :
         return closeFileSelector ((VstFileSelect*) ptr);
 
+    case audioMasterIOChanged:
+        // the initial delay could have changed, let the host compensate it
+        setLatencySamples (effect->initialDelay);
+        return 1;
+
     // none of these are handled (yet)..
     case audioMasterBeginEdit:
     case audioMasterEndEdit:
-    case audioMasterIOChanged:
     case audioMasterGetInputLatency:
     case audioMasterGetOutputLatency:
     case audioMasterGetCurrentProcessLevel:
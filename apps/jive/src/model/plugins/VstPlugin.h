@@ -162,6 +162,7 @@ public:
     int getNumOutputs () const;
     int getNumMidiInputs () const;
     int getNumMidiOutputs () const;
+    int getPluginLatency () const;
     bool producesMidi () const;
     bool acceptsMidi () const;
     void* getLowLevelHandle ();
@@ -221,6 +222,8 @@ private:
 
     VstPluginMidiManager midiManager;
     MidiBuffer sendToOutMidi;
+    MidiBuffer sliceMidi;
+    int midiOutputOffset;
     
     double sampleRate;
     int blockSize;
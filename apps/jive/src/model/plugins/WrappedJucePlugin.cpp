@@ -65,6 +65,10 @@ WrappedJucePlugin::WrappedJucePlugin (PluginDescription* desc, bool isInternal)
       else
          instance = AudioPluginFormatManager::getInstance()->createPluginInstance (pluginDescription, errorMessage);
 
+      // forward latency changes of the instance to whoever listens to us
+      if (instance)
+         instance->addListener (this);
+
       loadPluginStuff();
    }
 }
@@ -255,6 +259,17 @@ int WrappedJucePlugin::getNumMidiOutputs () const
     return instance && instance->producesMidi() ? 1 : 0;
 }
 
+int WrappedJucePlugin::getPluginLatency () const
+{
+    return instance ? instance->getLatencySamples () : 0;
+}
+
+void WrappedJucePlugin::audioProcessorChanged (AudioProcessor*)
+{
+    // this notifies our listeners only when the latency really changed
+    setLatencySamples (getPluginLatency ());
+}
+
 void* WrappedJucePlugin::getLowLevelHandle ()
 {
     return 0;
@@ -35,7 +35,8 @@
 /**
     Juce-handled plugin wrapper class (Juce can load and run VST and AU nicely for us).
 */
-class WrappedJucePlugin : public BasePlugin
+class WrappedJucePlugin : public BasePlugin,
+                          private AudioProcessorListener
 {
 public:
 
@@ -58,6 +59,7 @@ public:
     int getNumOutputs () const;
     int getNumMidiInputs () const;
     int getNumMidiOutputs () const;
+    int getPluginLatency () const;
     bool acceptsMidi () const;
     void* getLowLevelHandle ();
 
@@ -95,6 +97,10 @@ public:
 
 private:
 
+    //==============================================================================
+    void audioProcessorParameterChanged (AudioProcessor* processor, int parameterIndex, float newValue) {}
+    void audioProcessorChanged (AudioProcessor* processor);
+
    PluginDescription pluginDescription;
    AudioPluginInstance* instance;
    bool isInternalPlugin;
@@ -40,6 +40,8 @@ ChannelHost::ChannelHost (HostFilterBase* owner_,
 	plug (plug_),
     currentPlugin (0),
     audioGraph (0),
+    latencyCompensation (0),
+    retiredObjects (renderEpoch),
     sampleRate (44100.0),
     samplesPerBlock (512)
 {
@@ -60,21 +62,30 @@ ChannelHost::ChannelHost (HostFilterBase* owner_,
 	outputPlugin->setValue(PROP_GRAPHXPOS, 60);
 	outputPlugin->setValue(PROP_GRAPHYPOS, 200);
 	
-
+    // compensate the empty graph, plugins will tell us when their latency changes
+    updateLatencyCompensation ();
 }
 
 ChannelHost::~ChannelHost()
 {
     DBG ("ChannelHost::~ChannelHost");
 
+    cancelPendingUpdate ();
+
     // free plugins
-//    closeAllPlugins (false);
+//    closeAllPlugins ();
+    retiredObjects.flush ();
+
+    for (int i = plugins.size (); --i >= 0;)
+        plugins.getUnchecked (i)->removeListener (this);
+
     plugins.clear (true);
 
     // remove listeners after
 //    removeAllListeners ();
 
     // delete audio graph
+    deleteAndZero (latencyCompensation);
     deleteAndZero (audioGraph);
 }
 
@@ -100,6 +111,9 @@ void ChannelHost::addPlugin (BasePlugin* plugin)
 
         // add plugin to the list
         plugins.add (plugin);
+
+        // a latency change is notified through updateHostDisplay
+        plugin->addListener (this);
     }
 }
 
@@ -133,13 +147,14 @@ void ChannelHost::changePluginAudioGraph (ProcessingGraph* newAudioGraph)
 
     ProcessingGraph* oldAudioGraph = audioGraph;
 
-    {
-        const ScopedLock sl (owner->getCallbackLock());
-        audioGraph = newAudioGraph;
-    }
+    // publish the new graph only when fully built
+    Atomic::memoryBarrier ();
+    audioGraph = newAudioGraph;
 
-    if (oldAudioGraph)
-        delete oldAudioGraph;
+    if (oldAudioGraph != newAudioGraph)
+        retiredObjects.retireGraph (oldAudioGraph);
+
+    updateLatencyCompensation ();
 
     // notify listeners        
     for (int i = 0; i < listeners.size (); i++)
@@ -149,16 +164,50 @@ void ChannelHost::changePluginAudioGraph (ProcessingGraph* newAudioGraph)
 }
 
 //==============================================================================
-void ChannelHost::openPlugin (BasePlugin* plugin, const bool suspendAudio)
+int ChannelHost::getTotalLatency () const
+{
+    return latencyCompensation ? latencyCompensation->getTotalLatency () : 0;
+}
+
+void ChannelHost::updateLatencyCompensation ()
+{
+    LatencyCompensation* oldCompensation = latencyCompensation;
+
+    // the audio thread will pick it up only together with its graph
+    LatencyCompensation* newCompensation = new LatencyCompensation (audioGraph, outputPlugin);
+    Atomic::memoryBarrier ();
+    latencyCompensation = newCompensation;
+
+    retiredObjects.retireLatencyCompensation (oldCompensation);
+
+    // the parent host is listening to the channel plugin
+    if (plug)
+        plug->setLatencySamples (newCompensation->getTotalLatency ());
+}
+
+void ChannelHost::audioProcessorParameterChanged (AudioProcessor*, int, float)
+{
+}
+
+void ChannelHost::audioProcessorChanged (AudioProcessor*)
+{
+    // this could come from the audio thread, rebuild on the message thread
+    triggerAsyncUpdate ();
+}
+
+void ChannelHost::handleAsyncUpdate ()
+{
+    if (latencyCompensation && latencyCompensation->isOutOfDate ())
+        updateLatencyCompensation ();
+}
+
+//==============================================================================
+void ChannelHost::openPlugin (BasePlugin* plugin)
 {
     if (plugin)
     {
         DBG ("ChannelHost::openPlugin");
 
-        if (suspendAudio)
-             owner->suspendProcessing (true);
-		//DBG (String(T("suspend")))
-
         // make it a child, and allocate buffers
         plugin->setParentHost (owner);
 
@@ -178,9 +227,6 @@ void ChannelHost::openPlugin (BasePlugin* plugin, const bool suspendAudio)
         // try to open correctly the plugin
         plugin->prepareToPlay (sampleRate, samplesPerBlock);
 
-        if (suspendAudio)
-             owner->suspendProcessing (false);
-             
         // notify listeners        
         for (int i = 0; i < listeners.size (); i++)
             ((ChannelHostListener*) listeners.getUnchecked (i))->pluginAdded (this, plugin);
@@ -188,41 +234,33 @@ void ChannelHost::openPlugin (BasePlugin* plugin, const bool suspendAudio)
 }
 
 //==============================================================================
-void ChannelHost::closePlugin (BasePlugin* plugin, const bool suspendAudio)
+void ChannelHost::closePlugin (BasePlugin* plugin)
 {
     if (plugin)
     {
         DBG ("Host::closePlugin");
 
-        if (suspendAudio)
-             owner->suspendProcessing (true);
-
+        // unpublish it, the audio thread will skip the node from now on
         if (audioGraph)
             audioGraph->resetNodeData (plugin);
 
-        // release resources and close plugin
-        plugin->releaseResources ();
         plugins.removeObject (plugin, false);
-
-        if (suspendAudio)
-             owner->suspendProcessing (false);
+        plugin->removeListener (this);
 
         // notify listeners
         for (int i = 0; i < listeners.size (); i++)
             ((ChannelHostListener*) listeners.getUnchecked (i))->pluginRemoved (this, plugin);
 
-        delete plugin;
+        // release resources and close plugin when the audio thread is past it
+        retiredObjects.retirePlugin (plugin);
     }
 }
 
 //==============================================================================
-void ChannelHost::closeAllPlugins (const bool suspendAudio)
+void ChannelHost::closeAllPlugins ()
 {
     DBG ("ChannelHost::closeAllPlugins");
 
-    if (suspendAudio)
-        owner->suspendProcessing (true);
-
     // remove and close all plugins except i/o
     for (int i = plugins.size (); --i >= 0;)
     {
@@ -231,12 +269,9 @@ void ChannelHost::closeAllPlugins (const bool suspendAudio)
         if (plugin->getType() != JOST_PLUGINTYPE_CHANNELINPUT
             && plugin->getType() != JOST_PLUGINTYPE_CHANNELOUTPUT)
         {
-           closePlugin (plugin, false);
+           closePlugin (plugin);
         }
     }
-
-    if (suspendAudio)
-        owner->suspendProcessing (false);
 }
 
 //==============================================================================
@@ -278,23 +313,79 @@ void ChannelHost::releaseResources()
 }
 
 //==============================================================================
+bool ChannelHost::prepareDirectOutputs (ProcessingNode* node,
+                                        const int nodeIndex,
+                                        LatencyCompensation* compensation)
+{
+    BasePlugin* plugin = (BasePlugin*) node->getData ();
+
+    // the output buffers are needed as they are
+    if (plugin->isOutputMonitored ()
+        || ! plugin->canProcessAdding (1.0f))
+        return false;
+
+    ProcessingNode* destinationNode = node->getSingleDestination (JOST_LINKTYPE_AUDIO,
+                                                                  plugin->getNumOutputs ());
+    if (! destinationNode)
+        return false;
+
+    BasePlugin* destination = (BasePlugin*) destinationNode->getData ();
+    AudioSampleBuffer* destBuffer = destination ? destination->getInputBuffers () : 0;
+    if (! destBuffer)
+        return false;
+
+    for (int i = node->getLinksCount (JOST_LINKTYPE_AUDIO); --i >= 0;)
+    {
+        ProcessingLink* link = node->getLink (JOST_LINKTYPE_AUDIO, i);
+
+        // delayed links still need to go through the compensation
+        if ((compensation && compensation->getLinkDelay (nodeIndex, i) > 0)
+            || link->destinationPort >= destBuffer->getNumChannels ())
+            return false;
+
+        directOutputs [link->sourcePort] = destBuffer->getSampleData (link->destinationPort);
+    }
+
+    return true;
+}
+
 void ChannelHost::processBlock (AudioSampleBuffer& buffer,
                          MidiBuffer& midiMessages)
 {
     int blockSamples = buffer.getNumSamples();
     int currentPluginType = JOST_PLUGINTYPE_INVALID;
 
+    // denormals are flushed for the whole graph, unless a plugin opts out
+    const ScopedDenormalsMode flushDenormals (true);
+
+    // from now on anything retired by the message thread is kept alive
+    renderEpoch.enterRender ();
+
+    // the plugin array can change under our feet, so only walk the graph
+    ProcessingGraph* const graph = audioGraph;
+
+    // a compensation is only valid for the graph it was computed for
+    LatencyCompensation* compensation = latencyCompensation;
+    if (compensation && compensation->getGraph () != graph)
+        compensation = 0;
+
     // process midi for plugins
-    for (int j = plugins.size (); --j >= 0;)
-        plugins.getUnchecked (j)->clearMidiBuffers ();
+    if (graph)
+    {
+        for (int j = graph->getNodeCount (); --j >= 0;)
+        {
+            BasePlugin* plugin = (BasePlugin*) graph->getData (j);
+            if (plugin)
+                plugin->clearMidiBuffers ();
+        }
+    }
 
-    
     // process audio for plugins
-    if (audioGraph)
+    if (graph)
     {
-        for (int j = 0; j < audioGraph->getNodeCount (); j++)
+        for (int j = 0; j < graph->getNodeCount (); j++)
         {
-            ProcessingNode* node = audioGraph->getNode (j);
+            ProcessingNode* node = graph->getNode (j);
             currentPlugin = (BasePlugin*) node->getData ();
             
             if (! currentPlugin)
@@ -305,6 +396,7 @@ void ChannelHost::processBlock (AudioSampleBuffer& buffer,
             // handle logic of mapping i/o --
             AudioSampleBuffer* inBuffers = currentPlugin->getInputBuffers ();
             AudioSampleBuffer* outBuffers = currentPlugin->getOutputBuffers ();
+            bool summedToDestination = false;
 
             // process audio --
             if (currentPlugin->isBypass ()
@@ -328,7 +420,21 @@ void ChannelHost::processBlock (AudioSampleBuffer& buffer,
 
             else
             {
-                currentPlugin->processBlock (buffer, midiMessages);
+                // a plugin feeding a single node can sum straight into its inputs
+                summedToDestination = prepareDirectOutputs (node, j, compensation);
+
+                {
+                    // plugins that opt out get denormals back
+                    const ScopedDenormalsMode pluginDenormals (! currentPlugin->isDenormalsAllowed ());
+
+                    if (summedToDestination)
+                        currentPlugin->processBlockAdding (buffer, midiMessages, directOutputs, 1.0f);
+                    else
+                        currentPlugin->processBlock (buffer, midiMessages);
+                }
+
+                if (! summedToDestination)
+                    currentPlugin->checkOutputDenormals (blockSamples);
 
 				
               /*  if (currentPluginType == JOST_PLUGINTYPE_CHANNELOUTPUT)
@@ -338,7 +444,7 @@ void ChannelHost::processBlock (AudioSampleBuffer& buffer,
                 }*/
             }
 
-            if (outBuffers)
+            if (outBuffers && ! summedToDestination)
             {
 				
 				currentPlugin->setCurrentOutputGain (1.0f);
@@ -354,13 +460,28 @@ void ChannelHost::processBlock (AudioSampleBuffer& buffer,
                         AudioSampleBuffer* destBuffer = destination->getInputBuffers();
                         if (destBuffer)
                         {
-                            destBuffer->addFrom (link->destinationPort,
-                                                 0,
-                                                 outBuffers->getSampleData (link->sourcePort),
-                                                 blockSamples);
+                            if (compensation && compensation->getLinkDelay (j, i) > 0)
+                            {
+                                compensation->addDelayed (j,
+                                                          i,
+                                                          destBuffer->getSampleData (link->destinationPort),
+                                                          outBuffers->getSampleData (link->sourcePort),
+                                                          blockSamples);
+                            }
+                            else
+                            {
+                                destBuffer->addFrom (link->destinationPort,
+                                                     0,
+                                                     outBuffers->getSampleData (link->sourcePort),
+                                                     blockSamples);
+                            }
                         }
                     }
                 }
+
+                // keep history for the delayed links --
+                if (compensation)
+                    compensation->storeHistory (j, *outBuffers, blockSamples);
             }
 
             // clear input buffers (avoid zipper noise, but can be optimized) --
@@ -388,6 +509,7 @@ void ChannelHost::processBlock (AudioSampleBuffer& buffer,
 
     currentPlugin = 0;
 
+    renderEpoch.exitRender ();
 }
 
 //==============================================================================
@@ -508,7 +630,7 @@ void ChannelHost::saveGraphToXml (XmlElement* xml)
 void ChannelHost::loadFromXml (XmlElement* xml)
 {
 	// remove already added plugins
-    closeAllPlugins (false);
+    closeAllPlugins ();
 
     if (plugins.contains (inputPlugin));
         plugins.removeObject (inputPlugin, false);
@@ -553,8 +675,8 @@ void ChannelHost::loadFromXml (XmlElement* xml)
                 XmlElement* ext = e->getChildByName (T("options"));
                 if (ext) plugin->loadPropertiesFromXml (ext);
 
-                // add plugin (do not suspend processing)
-                openPlugin (plugin, false);
+                // add plugin
+                openPlugin (plugin);
                 addPlugin (plugin);
 
                 // XXX - is this needed here ?
@@ -33,6 +33,7 @@
 #include "../../../StandardHeader.h"
 
 #include "../../ProcessingGraph.h"
+#include "../../RenderEpoch.h"
 #include "../../PluginLoader.h"
 #include "../../Transport.h"
 #include "ChannelPlugin.h"
@@ -71,7 +72,8 @@ protected:
     The sub-host.
 	@Spankache
 */
-class ChannelHost
+class ChannelHost : private AudioProcessorListener,
+                    private AsyncUpdater
 {
 public:
 
@@ -143,7 +145,7 @@ public:
 
         @see closePlugin
     */
-    void openPlugin (BasePlugin* plugin, const bool suspendAudio = false);
+    void openPlugin (BasePlugin* plugin);
 
     /** Close a plugin registered with the host
 
@@ -152,14 +154,14 @@ public:
 
         @see addPlugin
     */
-    void closePlugin (BasePlugin* plugin, const bool suspendAudio = true);
+    void closePlugin (BasePlugin* plugin);
 
     /** Close all plugins registered with the host
 
         This will free every plugin currently playing, apart
         from in / out plugins !
     */
-    void closeAllPlugins (const bool suspendAudio = true);
+    void closeAllPlugins ();
 
     //==============================================================================
     /** Try to load a plugin given a string with the absolute path
@@ -186,6 +188,10 @@ public:
     /** Returns the current audio graph */
     ProcessingGraph* getAudioGraph () const            { return audioGraph; }
 
+    //==============================================================================
+    /** Returns the latency of the slowest path through the graph */
+    int getTotalLatency () const;
+
     //==============================================================================
     /** Add a listener to this host */
     void addListener (ChannelHostListener* listener);
@@ -205,6 +211,15 @@ public:
 
 private:
 
+    //==============================================================================
+    void updateLatencyCompensation ();
+    void audioProcessorParameterChanged (AudioProcessor* processor, int parameterIndex, float newValue);
+    void audioProcessorChanged (AudioProcessor* processor);
+    void handleAsyncUpdate ();
+    bool prepareDirectOutputs (ProcessingNode* node,
+                               const int nodeIndex,
+                               LatencyCompensation* compensation);
+
     //==============================================================================
     void saveGraphToXml (XmlElement* element);
     void loadGraphFromXml (XmlElement* element,
@@ -229,6 +244,11 @@ private:
     BasePlugin* currentPlugin;
 
     ProcessingGraph* audioGraph;
+    LatencyCompensation* latencyCompensation;
+
+    float* directOutputs [32];
+    RenderEpoch renderEpoch;
+    DeferredDeletionQueue retiredObjects;
 
     VoidArray listeners;
 
@@ -167,6 +167,12 @@ Transport* ChannelPlugin::getTransport()
 	return base->getTransport();
 }
 
+int ChannelPlugin::getPluginLatency () const
+{
+    // the sub graph is already compensated, so we delay by its slowest path
+    return hoster ? hoster->getTotalLatency () : 0;
+}
+
 //==============================================================================
 //Please don't touch this function
 void ChannelPlugin::autoOpenTrack(BasePlugin *plugin)
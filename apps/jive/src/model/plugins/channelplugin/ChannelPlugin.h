@@ -55,6 +55,7 @@ public:
 	int getNumInputs () const            { return numChannels; }
     int getNumMidiOutputs () const        { return (JucePlugin_WantsMidiInput) ? 1 : 0; }
 	int getNumMidiInputs () const        { return (JucePlugin_WantsMidiInput) ? 1 : 0; }
+    int getPluginLatency () const;
     bool producesMidi() const             { return JucePlugin_WantsMidiInput; }
     bool isMidiInput () const             { return JucePlugin_WantsMidiInput; }
 
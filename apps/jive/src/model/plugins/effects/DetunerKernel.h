@@ -0,0 +1,248 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2007 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU Lesser General Public License, as published by the Free Software
+ Foundation; either version 2 of the License, or (at your option) any later
+ version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+#ifndef __JUCETICE_JOSTDETUNERKERNEL_HEADER__
+#define __JUCETICE_JOSTDETUNERKERNEL_HEADER__
+
+
+//==============================================================================
+/**
+    The signal path of the Detuner, without the plugin around it.
+
+    A mono mix of the input goes into a delay line, which is read back a
+    little faster and a little slower than it is written. Each read head has
+    a second one half a buffer away, and a hanning window crossfades between
+    the two so the jump back to the write position isn't heard. The mixing
+    and the levels are done on whole blocks, the delay line a sample at a
+    time.
+
+    Everything is allocated by the constructor, so prepare(), setParameters()
+    and process() can be called from the audio thread.
+*/
+class DetunerKernel
+{
+public:
+    //==============================================================================
+    enum { maxBlockSize = 256, maxBufferLength = 4096 };
+
+    DetunerKernel (const int numChannels_)
+        : numChannels (numChannels_),
+          buflen (0), pos0 (0), pos1 (0.0f), dpos1 (1.0f), pos2 (0.0f), dpos2 (1.0f)
+    {
+        buf.calloc (maxBufferLength);
+        win.calloc (maxBufferLength);
+
+        inputChannels.malloc (numChannels);
+        outputChannels.malloc (numChannels);
+
+        mono.malloc (maxBlockSize);
+        gains.malloc (maxBlockSize);
+        up.malloc (maxBlockSize);
+        down.malloc (maxBlockSize);
+    }
+
+    //==============================================================================
+    /** Returns the number of channels the kernel was made for */
+    int getNumChannels () const                 { return numChannels; }
+
+    /** Returns the length of the delay line, set by the chunk parameter */
+    int getBufferLength () const                { return buflen; }
+
+    //==============================================================================
+    /** Sets the sample rate, the output levels ramp over 20ms */
+    void prepare (const double sampleRate)
+    {
+        wetRamp.setRampLength (roundDoubleToInt (sampleRate * 0.02));
+        dryRamp.setRampLength (roundDoubleToInt (sampleRate * 0.02));
+    }
+
+    /** Empties the delay line */
+    void reset ()
+    {
+        zeromem (buf, maxBufferLength * sizeof (float));
+        pos0 = 0; pos1 = pos2 = 0.0f;
+    }
+
+    /** Sets the plugin parameters, all of them from 0 to 1 */
+    void setParameters (const float fine, const float mix, const float output, const float chunk)
+    {
+        const float semi = 3.0f * fine * fine * fine;
+        dpos2 = (float)pow(1.0594631f, semi);
+        dpos1 = 1.0f / dpos2;
+
+        float wet = (float)pow(10.0f, 2.0f * output - 1.0f);
+        const float dry = wet - wet * mix * mix;
+        wet = (wet + wet - wet * mix) * mix;
+
+        wetRamp.setTarget (wet);
+        dryRamp.setTarget (dry);
+
+        const int tmp = 1 << (8 + (int)(4.9f * chunk));
+
+        if(tmp!=buflen) //recalculate crossfade window
+        {
+            buflen = tmp;
+
+            int i; //hanning half-overlap-and-add
+            double p=0.0, dp=6.28318530718/buflen;
+            for(i=0;i<buflen;i++) { win[i] = (float)(0.5 - 0.5 * cos(p)); p+=dp; }
+        }
+    }
+
+    /** Makes the output levels jump to their targets instead of ramping there */
+    void skipRamps ()
+    {
+        wetRamp.setValue (wetRamp.getTarget ());
+        dryRamp.setValue (dryRamp.getTarget ());
+    }
+
+    //==============================================================================
+    /** Detunes some channels, the outputs can be the same as the inputs
+
+        The upwards shift goes to the even channels and the downwards one to
+        the odd ones, a single channel gets both.
+    */
+    void process (const float* const* inputs, float* const* outputs,
+                  const int numChannelsToProcess, const int numSamples)
+    {
+        const int channelsToUse = jmin (numChannelsToProcess, numChannels);
+
+        if (channelsToUse <= 0)
+            return;
+
+        for (int pos = 0; pos < numSamples; pos += maxBlockSize)
+        {
+            for (int ch = 0; ch < channelsToUse; ++ch)
+            {
+                inputChannels [ch] = inputs [ch] + pos;
+                outputChannels [ch] = outputs [ch] + pos;
+            }
+
+            processChunk (inputChannels, outputChannels, channelsToUse, jmin ((int) maxBlockSize, numSamples - pos));
+        }
+    }
+
+    //==============================================================================
+    juce_UseDebuggingNewOperator
+
+private:
+    //==============================================================================
+    void processChunk (const float* const* inputs, float* const* outputs,
+                       const int numChannelsToProcess, const int numSamples)
+    {
+      //mono input to the delay line, the level is set for a stereo pair
+      if(numChannelsToProcess > 1) VectorOps::add (mono, inputs[0], inputs[1], numSamples);
+      else VectorOps::multiply (mono, inputs[0], 2.0f, numSamples);
+
+      for(int ch = 2; ch < numChannelsToProcess; ++ch) VectorOps::add (mono, inputs[ch], numSamples);
+      if(numChannelsToProcess > 2) VectorOps::multiply (mono, mono, 2.0f / numChannelsToProcess, numSamples);
+
+      wetRamp.getNextValues (gains, numSamples);
+      VectorOps::multiply (mono, mono, gains, numSamples);
+
+      //the delay line reads depend on the positions, so this part stays one sample at a time
+      float a, b, x, p1=pos1, p1f, d1=dpos1;
+      float          p2=pos2,      d2=dpos2;
+      int  p0=pos0, p1i, p2i;
+      int  l=buflen-1, lh=buflen>>1;
+      float lf = (float)buflen;
+
+      for(int i = 0; i < numSamples; ++i)
+      {
+        --p0 &= l;
+        *(buf + p0) = mono[i];          //input
+
+        p1 -= d1;
+        if(p1<0.0f) p1 += lf;           //output
+        p1i = (int)p1;
+        p1f = p1 - (float)p1i;
+        a = *(buf + p1i);
+        ++p1i &= l;
+        a += p1f * (*(buf + p1i) - a);  //linear interpolation
+
+        p2i = (p1i + lh) & l;           //180-degree ouptut
+        b = *(buf + p2i);
+        ++p2i &= l;
+        b += p1f * (*(buf + p2i) - b);  //linear interpolation
+
+        p2i = (p1i - p0) & l;           //crossfade
+        x = *(win + p2i);
+        up[i] = b + x * (a - b);
+
+        p2 -= d2;  //repeat for downwards shift - can't see a more efficient way?
+        if(p2<0.0f) p2 += lf;           //output
+        p1i = (int)p2;
+        p1f = p2 - (float)p1i;
+        a = *(buf + p1i);
+        ++p1i &= l;
+        a += p1f * (*(buf + p1i) - a);  //linear interpolation
+
+        p2i = (p1i + lh) & l;           //180-degree ouptut
+        b = *(buf + p2i);
+        ++p2i &= l;
+        b += p1f * (*(buf + p2i) - b);  //linear interpolation
+
+        p2i = (p1i - p0) & l;           //crossfade
+        x = *(win + p2i);
+        down[i] = b + x * (a - b);
+      }
+      pos0=p0; pos1=p1; pos2=p2;
+
+      //dry signal plus the upwards shift on the left, the downwards one on the right
+      if(numChannelsToProcess == 1)
+      {
+        VectorOps::add (up, down, numSamples);
+        VectorOps::multiply (up, up, 0.5f, numSamples);
+      }
+
+      dryRamp.getNextValues (gains, numSamples);
+
+      for(int ch = 0; ch < numChannelsToProcess; ++ch)
+        VectorOps::multiplyAdd (outputs[ch], inputs[ch], gains, (ch & 1) ? down : up, numSamples);
+    }
+
+    //==============================================================================
+    const int numChannels;
+
+    HeapBlock <float> buf, win;     //buffer, window
+    int  buflen;                    //buffer length
+    int  pos0;                      //buffer input
+    float pos1, dpos1;              //buffer output, rate
+    float pos2, dpos2;              //downwards shift
+    ParameterRamp wetRamp, dryRamp; //ouput levels
+
+    HeapBlock <const float*> inputChannels;
+    HeapBlock <float*> outputChannels;
+    HeapBlock <float> mono, gains, up, down;
+
+    DetunerKernel (const DetunerKernel&);
+    const DetunerKernel& operator= (const DetunerKernel&);
+};
+
+
+#endif
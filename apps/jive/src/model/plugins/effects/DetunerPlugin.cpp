@@ -32,14 +32,14 @@
 
 //==============================================================================
 DetunerPlugin::DetunerPlugin()
+    : parametersChanged (true)
 {
 	//Create parameter manager
 	Pars = new DetunerParMan();
 
 	///initialise...
-	buf = new float[BUFMAX];
-	win = new float[BUFMAX];
-	buflen=0;
+    // the buffers we get have one channel for each input or output
+    kernel = new DetunerKernel (jmax (getNumInputs (), getNumOutputs ()));
 
 	magnus=0;
 
@@ -59,8 +59,6 @@ DetunerPlugin::~DetunerPlugin()
 {
    removeAllParameters(true);
 	 delete Pars;
-	 if(buf) delete [] buf;
-	 if(win) delete [] win;
 }
 
 //==============================================================================
@@ -79,9 +77,8 @@ void DetunerPlugin::setParameter (int index, float newValue)
 
 	if (Pars->getParameter(index) != newValue) {Pars->setParameter(index,newValue);}
 
-	 //calcs here
-	recalc();	
-  
+    // recalc() runs on the audio thread, at the next block
+    parametersChanged = true;
 }
 
 const String DetunerPlugin::getParameterName (int index)
@@ -107,113 +104,34 @@ void DetunerPlugin::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
     // do your pre-playback setup stuff here..
     keyboardState.reset();
+
+    kernel->prepare (sampleRate);
+
+    parametersChanged = false;
 	recalc();
-	
+    kernel->skipRamps ();
+
 }
 
 void DetunerPlugin::releaseResources()
 {
-    memset(buf, 0, BUFMAX * sizeof(float));
-    pos0 = 0; pos1 = pos2 = 0.0f;
+    kernel->reset ();
 }
 void DetunerPlugin::recalc()
 {
-
-	semi = 3.0f * getParameter(0) * getParameter(0) * getParameter(0);
-  dpos2 = (float)pow(1.0594631f, semi);
-  dpos1 = 1.0f / dpos2;
-
-  wet = (float)pow(10.0f, 2.0f * getParameter(2) - 1.0f);
-  dry = wet - wet * getParameter(1) * getParameter(1);
-  wet = (wet + wet - wet * getParameter(1)) * getParameter(1);
-
-  int tmp = 1 << (8 + (int)(4.9f * getParameter(3)));
-
-  if(tmp!=buflen) //recalculate crossfade window
-  {
-    buflen = tmp;
-    bufres = 1000.0f * (float)buflen / getSampleRate();
-
-    int i; //hanning half-overlap-and-add
-    double p=0.0, dp=6.28318530718/buflen;
-    for(i=0;i<buflen;i++) { win[i] = (float)(0.5 - 0.5 * cos(p)); p+=dp; }
-  }
-
+    kernel->setParameters (getParameter (0), getParameter (1), getParameter (2), getParameter (3));
 }
 
 void DetunerPlugin::detune (AudioSampleBuffer* buffer, AudioSampleBuffer* out, int sampleFrames)
 {
-
-  float *in1 = buffer->getSampleData (0);
-  float *in2 = buffer->getSampleData (1);
-  float *out1 = out->getSampleData (0);
-  float *out2 = out->getSampleData (1);
-  float a, b, c, d;
-  float x, w=wet, y=dry, p1=pos1, p1f, d1=dpos1;
-  float                  p2=pos2,      d2=dpos2;
-  int  p0=pos0, p1i, p2i;
-  int  l=buflen-1, lh=buflen>>1;
-  float lf = (float)buflen;
-
-  --in1;
-  --in2;
-  --out1;
-  --out2;
-  while(--sampleFrames >= 0)  //had to disable optimization /Og in MSVC++5!
+  if (parametersChanged)
   {
-    a = *++in1;
-    b = *++in2;
-
-    c = y * a;
-    d = y * b;
-
-    --p0 &= l;     
-    *(buf + p0) = w * (a + b);      //input
-
-    p1 -= d1;
-    if(p1<0.0f) p1 += lf;           //output
-    p1i = (int)p1;
-    p1f = p1 - (float)p1i;
-    a = *(buf + p1i);
-    ++p1i &= l;
-    a += p1f * (*(buf + p1i) - a);  //linear interpolation
-
-    p2i = (p1i + lh) & l;           //180-degree ouptut
-    b = *(buf + p2i);
-    ++p2i &= l;
-    b += p1f * (*(buf + p2i) - b);  //linear interpolation
-
-    p2i = (p1i - p0) & l;           //crossfade
-    x = *(win + p2i);
-    //++p2i &= l;
-    //x += p1f * (*(win + p2i) - x); //linear interpolation (doesn't do much)
-    c += b + x * (a - b);
-
-    p2 -= d2;  //repeat for downwards shift - can't see a more efficient way?
-    if(p2<0.0f) p2 += lf;           //output
-    p1i = (int)p2;
-    p1f = p2 - (float)p1i;
-    a = *(buf + p1i);
-    ++p1i &= l;
-    a += p1f * (*(buf + p1i) - a);  //linear interpolation
-
-    p2i = (p1i + lh) & l;           //180-degree ouptut
-    b = *(buf + p2i);
-    ++p2i &= l;
-    b += p1f * (*(buf + p2i) - b);  //linear interpolation
-
-    p2i = (p1i - p0) & l;           //crossfade
-    x = *(win + p2i);
-    //++p2i &= l;
-    //x += p1f * (*(win + p2i) - x); //linear interpolation (doesn't do much)
-    d += b + x * (a - b);
-
-    *++out1 = c;
-    *++out2 = d;
+      parametersChanged = false;
+      recalc ();
   }
-  pos0=p0; pos1=p1; pos2=p2;
-	
 
+  kernel->process (buffer->getArrayOfChannels (), out->getArrayOfChannels (),
+                   jmin (buffer->getNumChannels (), out->getNumChannels ()), sampleFrames);
 }
 
 void DetunerPlugin::processBlock (AudioSampleBuffer& buffer,
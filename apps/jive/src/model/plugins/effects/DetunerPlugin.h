@@ -31,8 +31,7 @@
 
 #include "../../BasePlugin.h"
 #include "DetunerParameters.h"
-
-#define BUFMAX   4096
+#include "DetunerKernel.h"
 
 //==============================================================================
 /**
@@ -122,16 +121,8 @@ private:
 
 protected:
 
-	///global internal variables
-	float *buf, *win;       //buffer, window
-	int  buflen;           //buffer length
-	float bufres;           //buffer resolution display
-	float semi;             //detune display
-	int  pos0;             //buffer input
-	float pos1, dpos1;      //buffer output, rate
-	float pos2, dpos2;      //downwards shift
-	float wet, dry;         //ouput levels
- 
+    ScopedPointer <DetunerKernel> kernel;
+    volatile bool parametersChanged;
 };
 
 
@@ -0,0 +1,320 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2007 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU Lesser General Public License, as published by the Free Software
+ Foundation; either version 2 of the License, or (at your option) any later
+ version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+#ifndef __JUCETICE_JOSTOPPRESSORKERNEL_HEADER__
+#define __JUCETICE_JOSTOPPRESSORKERNEL_HEADER__
+
+#if JUCE_INTEL && (JUCE_MSVC || defined (__SSE__))
+ #include <xmmintrin.h>
+#endif
+
+//==============================================================================
+/**
+    The signal path of the Oppressor, without the plugin around it.
+
+    The peak of all the channels is followed by an envelope that sets the
+    gain of the compressor, and by a faster one that drives the limiter. The
+    envelopes are worked out one sample at a time, then the gains for the
+    whole block, 4 at a time, and all of it runs at the oversampled rate.
+
+    Everything is allocated by the constructor, so prepare(), setParameters()
+    and process() can be called from the audio thread.
+*/
+class OppressorKernel
+{
+public:
+    //==============================================================================
+    enum { maxBlockSize = 256, maxFactor = 4 };
+
+    OppressorKernel (const int numChannels_)
+        : numChannels (numChannels_),
+          thresh (0.0f), ratio (0.0f), level (0.0f), attack (0.0f), release (0.0f), limiter (1.0f),
+          thr (1.0f), rat (0.0f), env (0.0f), env2 (0.0f), att (1.0f), rel (0.0f), lthr (0.0f),
+          mode (0),
+          oversampler (numChannels_, maxBlockSize)
+    {
+        inputChannels.malloc (numChannels);
+        outputChannels.malloc (numChannels);
+
+        peaks.malloc (maxBlockSize * maxFactor);
+        envelopes.malloc (maxBlockSize * maxFactor);
+        peakEnvelopes.malloc (maxBlockSize * maxFactor);
+        gains.malloc (maxBlockSize * maxFactor);
+    }
+
+    //==============================================================================
+    /** Returns the number of channels the kernel was made for */
+    int getNumChannels () const                 { return numChannels; }
+
+    /** Returns the oversampling factor in use */
+    int getFactor () const                      { return oversampler.getFactor (); }
+
+    /** Returns the delay the oversampling adds, in samples at the host rate */
+    int getLatencySamples () const              { return oversampler.getLatencySamples (); }
+
+    //==============================================================================
+    /** Sets the sample rate and the oversampling factor
+
+        The output level ramps over 20ms, and the attack and release are worked
+        out again so they keep their times at the new rate.
+    */
+    void prepare (const double sampleRate, const int factor)
+    {
+        oversampler.setFactor (factor);
+        trimRamp.setRampLength (roundDoubleToInt (sampleRate * 0.02) * oversampler.getFactor ());
+
+        updateCoefficients ();
+    }
+
+    /** Sets the plugin parameters, all of them from 0 to 1 */
+    void setParameters (const float thresh_, const float ratio_, const float level_,
+                        const float attack_, const float release_, const float limiter_)
+    {
+        thresh = thresh_;
+        ratio = ratio_;
+        level = level_;
+        attack = attack_;
+        release = release_;
+        limiter = limiter_;
+
+        updateCoefficients ();
+    }
+
+    /** Makes the output level jump to its target instead of ramping there */
+    void skipRamps ()
+    {
+        trimRamp.setValue (trimRamp.getTarget ());
+    }
+
+    //==============================================================================
+    /** Compresses some channels, the outputs can be the same as the inputs */
+    void process (const float* const* inputs, float* const* outputs,
+                  const int numChannelsToProcess, const int numSamples)
+    {
+        const int channelsToUse = jmin (numChannelsToProcess, numChannels);
+
+        if (channelsToUse <= 0)
+            return;
+
+        for (int pos = 0; pos < numSamples; pos += maxBlockSize)
+        {
+            for (int ch = 0; ch < channelsToUse; ++ch)
+            {
+                inputChannels [ch] = inputs [ch] + pos;
+                outputChannels [ch] = outputs [ch] + pos;
+            }
+
+            processChunk (inputChannels, outputChannels, channelsToUse, jmin ((int) maxBlockSize, numSamples - pos));
+        }
+    }
+
+    //==============================================================================
+    juce_UseDebuggingNewOperator
+
+private:
+    //==============================================================================
+    void updateCoefficients ()
+    {
+        mode=0;
+        thr = (float)pow(10.f, 2.f * thresh - 2.f);
+        rat = 2.5f * ratio - 0.5f;
+        if(rat>1.0) { rat = 1.f + 16.f*(rat-1.f) * (rat - 1.f); mode = 1; }
+        if(rat<0.0) { rat = 0.6f*rat; mode=1; }
+        trimRamp.setTarget ((float)pow(10.f, 2.f * level)); //was  - 1.f);
+        att = (float)pow(10.f, -0.002f - 2.f * attack);
+        rel = (float)pow(10.f, -2.f - 3.f * release);
+
+        if(limiter>0.98)
+        {
+           lthr = 0.f; //limiter
+        }
+        else
+        {
+           lthr = 0.99f*(float)pow(10.0f,int(30.0*limiter - 20.0)/20.f);
+           mode = 1;
+        }
+
+        if(rat<0.0f && thr<0.1f) rat *= thr*15.f;
+
+        // keep the attack and release times when running oversampled
+        const int factor = oversampler.getFactor ();
+
+        if (factor > 1)
+        {
+            att = 1.0f - (float) pow (1.0 - att, 1.0 / factor);
+            rel = 1.0f - (float) pow (1.0 - rel, 1.0 / factor);
+        }
+    }
+
+    //==============================================================================
+    /*
+        Works out the gain of the vca from the envelopes, 4 samples at a time:
+
+            g = (e>th)? tr / (1.f + ra * ((e/th) - 1.f)) : tr;
+
+        and when limiting:
+
+            if(g<0.f) g=0.f;
+            if(g*e2>lth) g = lth/e2;
+
+        The gains array holds the output level on the way in.
+    */
+    static void computeGains (float* gains, const float* envelopes, const float* peakEnvelopes,
+                              const int numSamples, const float th, const float ra, const float lth)
+    {
+        int i = 0;
+
+#if JUCE_INTEL && (JUCE_MSVC || defined (__SSE__))
+        const __m128 one = _mm_set1_ps (1.0f);
+        const __m128 zero = _mm_setzero_ps ();
+        const __m128 threshold = _mm_set1_ps (th);
+        const __m128 ratio = _mm_set1_ps (ra);
+        const __m128 limit = _mm_set1_ps (lth);
+
+        for (; i <= numSamples - 4; i += 4)
+        {
+            const __m128 e = _mm_loadu_ps (envelopes + i);
+            const __m128 tr = _mm_loadu_ps (gains + i);
+
+            const __m128 compressed = _mm_div_ps (tr, _mm_add_ps (one, _mm_mul_ps (ratio, _mm_sub_ps (_mm_div_ps (e, threshold), one))));
+            const __m128 above = _mm_cmpgt_ps (e, threshold);
+            __m128 g = _mm_or_ps (_mm_and_ps (above, compressed), _mm_andnot_ps (above, tr));
+
+            if (peakEnvelopes != 0)
+            {
+                const __m128 e2 = _mm_loadu_ps (peakEnvelopes + i);
+
+                g = _mm_andnot_ps (_mm_cmplt_ps (g, zero), g);
+
+                const __m128 over = _mm_cmpgt_ps (_mm_mul_ps (g, e2), limit);
+                g = _mm_or_ps (_mm_and_ps (over, _mm_div_ps (limit, e2)), _mm_andnot_ps (over, g));
+            }
+
+            _mm_storeu_ps (gains + i, g);
+        }
+#endif
+
+        for (; i < numSamples; ++i)
+        {
+            const float e = envelopes [i];
+            const float tr = gains [i];
+            float g = (e>th)? tr / (1.f + ra * ((e/th) - 1.f)) : tr;
+
+            if (peakEnvelopes != 0)
+            {
+                const float e2 = peakEnvelopes [i];
+
+                if(g<0.f) g=0.f;
+                if(g*e2>lth) g = lth/e2; //limit
+            }
+
+            gains [i] = g;
+        }
+    }
+
+    void processChunk (const float* const* inputs, float* const* outputs,
+                       const int numChannelsToProcess, const int numSamples)
+    {
+        const int numOversampled = numSamples * oversampler.getFactor ();
+        float* const* const channels = oversampler.upsample (inputs, numChannelsToProcess, numSamples);
+
+        // the peak of the first two channels is taken in the envelope loops, a
+        // separate pass over them would cost more than the loops themselves
+        const float* const left = channels [0];
+        const float* const right = channels [numChannelsToProcess > 1 ? 1 : 0];
+        const bool hasMoreChannels = numChannelsToProcess > 2;
+
+        if (hasMoreChannels)
+        {
+            VectorOps::abs (peaks, channels [2], numOversampled);
+            for (int ch = 3; ch < numChannelsToProcess; ++ch)
+                VectorOps::absMax (peaks, channels [ch], numOversampled);
+        }
+
+        float e=env, e2=env2, re=(1.f-rel), at=att;
+
+        if(mode) //comp/gate/lim
+        {
+            for (int k = 0; k < numOversampled; ++k)
+            {
+                float i = jmax (fabsf (left [k]), fabsf (right [k]));     //get peak level
+                if (hasMoreChannels) i = jmax (i, peaks [k]);
+
+                e = (i>e)? e + at * (i - e) : e * re;
+                e2 = (i>e)? i : e2 * re; //ir;
+
+                envelopes [k] = e;
+                peakEnvelopes [k] = e2;
+            }
+        }
+        else //compressor only
+        {
+            for (int k = 0; k < numOversampled; ++k)
+            {
+                float i = jmax (fabsf (left [k]), fabsf (right [k]));     //get peak level
+                if (hasMoreChannels) i = jmax (i, peaks [k]);
+
+                e = (i>e)? e + at * (i - e) : e * re; //envelope
+
+                envelopes [k] = e;
+            }
+        }
+
+        if(e <1.0e-10) env =0.f; else env =e;
+        if(e2<1.0e-10) env2=0.f; else env2=e2;
+
+        trimRamp.getNextValues (gains, numOversampled);
+
+        computeGains (gains, envelopes, mode ? (const float*) peakEnvelopes : 0, numOversampled,
+                      thr, rat, lthr == 0.f ? 1000.f : lthr);
+
+        for (int ch = 0; ch < numChannelsToProcess; ++ch)
+            VectorOps::multiply (channels [ch], channels [ch], gains, numOversampled); //vca
+
+        oversampler.downsample (outputs, numChannelsToProcess, numSamples);
+    }
+
+    //==============================================================================
+    const int numChannels;
+    float thresh, ratio, level, attack, release, limiter;
+
+    float thr, rat, env, env2, att, rel, lthr;
+    int mode;
+    ParameterRamp trimRamp;
+
+    Oversampler oversampler;
+    HeapBlock <const float*> inputChannels;
+    HeapBlock <float*> outputChannels;
+    HeapBlock <float> peaks, envelopes, peakEnvelopes, gains;
+
+    OppressorKernel (const OppressorKernel&);
+    const OppressorKernel& operator= (const OppressorKernel&);
+};
+
+
+#endif
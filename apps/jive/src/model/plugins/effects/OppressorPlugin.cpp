@@ -31,10 +31,14 @@
 
 //==============================================================================
 OppressorPlugin::OppressorPlugin()
+    : oversampling (1),
+      parametersChanged (true)
 {
 	// Create parameter manager
 	Pars = new OppressorParMan();
 
+    kernel = new OppressorKernel (jmax (getNumInputs (), getNumOutputs ()));
+
 	magnus = 0;
 
 	cp = 0;
@@ -71,27 +75,30 @@ void OppressorPlugin::setParameter (int index, float newValue)
 {
 	if (Pars->getParameter(index) != newValue) {Pars->setParameter(index,newValue);}
 
-	//calcs here
-    mode=0;
-    thr = (float)pow(10.f, 2.f * Pars->getParameter(OppressorParMan::thresh) - 2.f);
-    rat = 2.5f * Pars->getParameter(OppressorParMan::ratio) - 0.5f; 
-    if(rat>1.0) { rat = 1.f + 16.f*(rat-1.f) * (rat - 1.f); mode = 1; }
-    if(rat<0.0) { rat = 0.6f*rat; mode=1; }
-    trim = (float)pow(10.f, 2.f * Pars->getParameter(OppressorParMan::level)); //was  - 1.f);
-    att = (float)pow(10.f, -0.002f - 2.f * Pars->getParameter(OppressorParMan::attack));
-    rel = (float)pow(10.f, -2.f - 3.f * Pars->getParameter(OppressorParMan::release));
-
-    if(Pars->getParameter(OppressorParMan::limiter)>0.98)
-    {
-       lthr = 0.f; //limiter
-    }
-    else
-    {
-       lthr = 0.99f*(float)pow(10.0f,int(30.0*Pars->getParameter(OppressorParMan::limiter) - 20.0)/20.f); 
-       mode = 1; 
-    } 
+    // the coefficients are worked out by the audio thread, at the next block
+    parametersChanged = true;
+}
 
-    if(rat<0.0f && thr<0.1f) rat *= thr*15.f;
+void OppressorPlugin::setOversampling (const int factor)
+{
+    // the audio thread picks this up at the start of its next block, and
+    // tells the host when getPluginLatency() changes
+    oversampling = factor >= 4 ? 4 : (factor >= 2 ? 2 : 1);
+}
+
+int OppressorPlugin::getPluginLatency () const
+{
+    return kernel->getLatencySamples ();
+}
+
+void OppressorPlugin::updateCoefficients ()
+{
+    kernel->setParameters (Pars->getParameter (OppressorParMan::thresh),
+                           Pars->getParameter (OppressorParMan::ratio),
+                           Pars->getParameter (OppressorParMan::level),
+                           Pars->getParameter (OppressorParMan::attack),
+                           Pars->getParameter (OppressorParMan::release),
+                           Pars->getParameter (OppressorParMan::limiter));
 }
 
 const String OppressorPlugin::getParameterName (int index)
@@ -119,6 +126,11 @@ void OppressorPlugin::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
     // do your pre-playback setup stuff here..
     keyboardState.reset();
+    kernel->prepare (sampleRate, oversampling);
+
+    parametersChanged = false;
+    updateCoefficients ();
+    kernel->skipRamps ();
 }
 
 void OppressorPlugin::releaseResources()
@@ -128,67 +140,22 @@ void OppressorPlugin::releaseResources()
 
 void OppressorPlugin::oppressor (AudioSampleBuffer* buffer, AudioSampleBuffer* out, int sampleFrames)
 {
-	float *in1 = buffer->getSampleData (0);
-	float *in2 = buffer->getSampleData (1);
-	float *out1 = out->getSampleData (0);
-	float *out2 = out->getSampleData (1);
-
-	float a, b, i, j, g, e=env, e2=env2, ra=rat, re=(1.f-rel), at=att;
-	float tr=trim, th=thr, lth=lthr; // , xth=xthr;  
-	
-	--in1;	
-	--in2;	
-	--out1;
-	--out2;
-
-	if(mode) //comp/gate/lim
-	{
-		if(lth==0.f) lth=1000.f;
-		while(--sampleFrames >= 0)
-		{
-			a = *++in1;
-			b = *++in2;
-
-			i = (a<0.f)? -a : a;
-			j = (b<0.f)? -b : b;
-			i = (j>i)? j : i;
-
-			e = (i>e)? e + at * (i - e) : e * re;
-			e2 = (i>e)? i : e2 * re; //ir;
-
-			g = (e>th)? tr / (1.f + ra * ((e/th) - 1.f)) : tr;
-
-			if(g<0.f) g=0.f; 
-			if(g*e2>lth) g = lth/e2; //limit 
-
-			//  ge = (e>xth)? ge + ga - ga * ge : ge * xrat; //gate
-
-			*++out1 = a * (g);	
-			*++out2 = b * (g);	
-		}
-	}
-	else //compressor only
-	{
-		while(--sampleFrames >= 0)
-		{
-		a = *++in1;
-		b = *++in2;
-
-		i = (a<0.f)? -a : a;
-		j = (b<0.f)? -b : b;
-		i = (j>i)? j : i; //get peak level
+    if (oversampling != kernel->getFactor ())
+    {
+        kernel->prepare (getSampleRate (), oversampling);
 
-		e = (i>e)? e + at * (i - e) : e * re; //envelope
-		g = (e>th)? tr / (1.f + ra * ((e/th) - 1.f)) : tr; //gain
+        // the latency has changed, let the host rebuild its compensation
+        updateHostDisplay ();
+    }
 
-		*++out1 = a * (g); //vca
-		*++out2 = b * (g);	
-		}
-	}
+    if (parametersChanged)
+    {
+        parametersChanged = false;
+        updateCoefficients ();
+    }
 
-	if(e <1.0e-10) env =0.f; else env =e;
-	if(e2<1.0e-10) env2=0.f; else env2=e2;
-	// if(ge<1.0e-10) genv=0.f; else genv=ge;
+    kernel->process (buffer->getArrayOfChannels (), out->getArrayOfChannels (),
+                     jmin (buffer->getNumChannels (), out->getNumChannels ()), sampleFrames);
 }
 
 void OppressorPlugin::processBlock (AudioSampleBuffer& buffer,
@@ -257,6 +224,7 @@ void OppressorPlugin::getStateInformation (MemoryBlock& destData)
 	xmlState.setAttribute (T("attack"), getParameter(OppressorParMan::attack));
 	xmlState.setAttribute (T("release"), getParameter(OppressorParMan::release));
 	xmlState.setAttribute (T("limiter"), getParameter(OppressorParMan::limiter));
+    xmlState.setAttribute (T("oversampling"), getOversampling ());
 
 	xmlState.setAttribute (T("default"), 0);
 
@@ -288,6 +256,7 @@ void OppressorPlugin::setStateInformation (const void* data, int sizeInBytes)
 				getParameter(OppressorParMan::release)));
 			setParameter(OppressorParMan::limiter,(float) xmlState->getDoubleAttribute (T("limiter"), 
 				getParameter(OppressorParMan::limiter)));
+            setOversampling (xmlState->getIntAttribute (T("oversampling"), 1));
 
             sendChangeMessage (this);
         }
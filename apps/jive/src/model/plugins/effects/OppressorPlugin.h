@@ -31,6 +31,7 @@
 
 #include "../../BasePlugin.h"
 #include "OppressorParameters.h"
+#include "OppressorKernel.h"
 
 //==============================================================================
 /**
@@ -79,6 +80,12 @@ public:
 	
 	void oppressor (AudioSampleBuffer* buffer, AudioSampleBuffer* out, int sampleFrames);
 
+    //==============================================================================
+    int getMaxOversampling () const      { return 4; }
+    int getOversampling () const         { return oversampling; }
+    void setOversampling (const int factor);
+    int getPluginLatency () const;
+
 	void processBlock (AudioSampleBuffer& buffer,
                        MidiBuffer& midiMessages);    
 
@@ -125,9 +132,11 @@ private:
 
 protected:
 
-	float thr, rat, env, env2, att, rel, trim, lthr, xthr, xrat;
-	int mode;
+    void updateCoefficients ();
 
+    ScopedPointer <OppressorKernel> kernel;
+    volatile int oversampling;
+    volatile bool parametersChanged;
 };
 
 
@@ -0,0 +1,216 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2007 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU Lesser General Public License, as published by the Free Software
+ Foundation; either version 2 of the License, or (at your option) any later
+ version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+#ifndef __JUCETICE_JOSTOVERDOSEKERNEL_HEADER__
+#define __JUCETICE_JOSTOVERDOSEKERNEL_HEADER__
+
+
+//==============================================================================
+/**
+    The signal path of the Overdose, without the plugin around it.
+
+    Each channel is mixed with its signed square root by the drive amount,
+    then goes through a one pole lowpass and the output gain. The square
+    roots and the mix are done on whole blocks, the filter a sample at a
+    time on two channels at once, and all of it at the oversampled rate.
+
+    Everything is allocated by the constructor, so prepare(), setParameters()
+    and process() can be called from the audio thread.
+*/
+class OverdoseKernel
+{
+public:
+    //==============================================================================
+    enum { maxBlockSize = 256, maxFactor = 4 };
+
+    OverdoseKernel (const int numChannels_)
+        : numChannels (numChannels_),
+          driveAmount (0.0f), muffle (0.0f), output (0.0f),
+          filt (1.0f),
+          oversampler (numChannels_, maxBlockSize)
+    {
+        filterStates.calloc (numChannels);
+        inputChannels.malloc (numChannels);
+        outputChannels.malloc (numChannels);
+
+        drive.malloc (maxBlockSize * maxFactor);
+        driven.malloc (maxBlockSize * maxFactor * 2);
+        gains.malloc (maxBlockSize);
+    }
+
+    //==============================================================================
+    /** Returns the number of channels the kernel was made for */
+    int getNumChannels () const                 { return numChannels; }
+
+    /** Returns the oversampling factor in use */
+    int getFactor () const                      { return oversampler.getFactor (); }
+
+    /** Returns the delay the oversampling adds, in samples at the host rate */
+    int getLatencySamples () const              { return oversampler.getLatencySamples (); }
+
+    //==============================================================================
+    /** Sets the sample rate and the oversampling factor
+
+        The drive and the output gain ramp over 20ms, and the filter is worked
+        out again so its cutoff stays where it was at the new rate.
+    */
+    void prepare (const double sampleRate, const int factor)
+    {
+        const int rampLength = roundDoubleToInt (sampleRate * 0.02);
+
+        oversampler.setFactor (factor);
+        gainRamp.setRampLength (rampLength);
+        driveRamp.setRampLength (rampLength * oversampler.getFactor ());
+
+        updateCoefficients ();
+    }
+
+    /** Sets the plugin parameters, all of them from 0 to 1 */
+    void setParameters (const float drive_, const float muffle_, const float output_)
+    {
+        driveAmount = drive_;
+        muffle = muffle_;
+        output = output_;
+
+        updateCoefficients ();
+    }
+
+    /** Makes the drive and output gain jump to their targets instead of ramping there */
+    void skipRamps ()
+    {
+        driveRamp.setValue (driveRamp.getTarget ());
+        gainRamp.setValue (gainRamp.getTarget ());
+    }
+
+    //==============================================================================
+    /** Drives some channels, the outputs can be the same as the inputs */
+    void process (const float* const* inputs, float* const* outputs,
+                  const int numChannelsToProcess, const int numSamples)
+    {
+        const int channelsToUse = jmin (numChannelsToProcess, numChannels);
+
+        if (channelsToUse <= 0)
+            return;
+
+        for (int pos = 0; pos < numSamples; pos += maxBlockSize)
+        {
+            for (int ch = 0; ch < channelsToUse; ++ch)
+            {
+                inputChannels [ch] = inputs [ch] + pos;
+                outputChannels [ch] = outputs [ch] + pos;
+            }
+
+            processChunk (inputChannels, outputChannels, channelsToUse, jmin ((int) maxBlockSize, numSamples - pos));
+        }
+    }
+
+    //==============================================================================
+    juce_UseDebuggingNewOperator
+
+private:
+    //==============================================================================
+    void updateCoefficients ()
+    {
+        const int factor = oversampler.getFactor ();
+
+        filt = (float)pow(10.0,-1.6 * muffle);
+
+        // keep the cutoff of the filter where it is at the oversampled rate
+        if (factor > 1)
+            filt = 1.0f - (float) pow (1.0 - filt, 1.0 / factor);
+
+        driveRamp.setTarget (driveAmount);
+        gainRamp.setTarget ((float)pow(10.0f, 2.0f * output - 1.0f));
+    }
+
+    void processChunk (const float* const* inputs, float* const* outputs,
+                       const int numChannelsToProcess, const int numSamples)
+    {
+        const int numOversampled = numSamples * oversampler.getFactor ();
+        float* const* const channels = oversampler.upsample (inputs, numChannelsToProcess, numSamples);
+
+        driveRamp.getNextValues (drive, numOversampled);
+        gainRamp.getNextValues (gains, numSamples);
+
+        const float f = filt;
+        float* const drivenB = driven + numOversampled;
+
+        for (int ch = 0; ch < numChannelsToProcess; ch += 2)
+        {
+            // each filter has to wait for its previous sample, so two of them
+            // are run side by side to keep the cpu busy
+            float* const x = channels [ch];
+            float* const y = channels [jmin (ch + 1, numChannelsToProcess - 1)];
+
+            VectorOps::signedSqrt (driven, x, numOversampled);                //overdrive
+            VectorOps::interpolate (driven, x, driven, drive, numOversampled);
+            VectorOps::signedSqrt (drivenB, y, numOversampled);
+            VectorOps::interpolate (drivenB, y, drivenB, drive, numOversampled);
+
+            float fa = filterStates [ch];
+            float fb = filterStates [jmin (ch + 1, numChannelsToProcess - 1)];
+
+            for (int i = 0; i < numOversampled; ++i)                          //filter
+            {
+                fa = fa + f * (driven [i] - fa);
+                fb = fb + f * (drivenB [i] - fb);
+                x [i] = fa;
+                y [i] = fb;
+            }
+
+            filterStates [ch] = fabs (fa) > 1.0e-10 ? fa : 0.0f;               //catch denormals
+
+            if (ch + 1 < numChannelsToProcess)
+                filterStates [ch + 1] = fabs (fb) > 1.0e-10 ? fb : 0.0f;
+        }
+
+        oversampler.downsample (outputs, numChannelsToProcess, numSamples);
+
+        for (int ch = 0; ch < numChannelsToProcess; ++ch)
+            VectorOps::multiply (outputs [ch], outputs [ch], gains, numSamples);
+    }
+
+    //==============================================================================
+    const int numChannels;
+    float driveAmount, muffle, output;
+
+    HeapBlock <float> filterStates;     // filter buffers, one per channel
+    float filt;                         // filter coeff. at the oversampled rate
+    ParameterRamp driveRamp, gainRamp;
+
+    Oversampler oversampler;
+    HeapBlock <const float*> inputChannels;
+    HeapBlock <float*> outputChannels;
+    HeapBlock <float> drive, gains, driven;
+
+    OverdoseKernel (const OverdoseKernel&);
+    const OverdoseKernel& operator= (const OverdoseKernel&);
+};
+
+
+#endif
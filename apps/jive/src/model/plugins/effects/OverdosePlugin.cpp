@@ -32,11 +32,13 @@
 
 //==============================================================================
 OverdosePlugin::OverdosePlugin()
+    : oversampling (1),
+      parametersChanged (true)
 {
 	//Create parameter manager
 	Pars = new OverdoseParMan();
-	
-	filt1 = filt2 = 0.0f;
+
+    kernel = new OverdoseKernel (jmax (getNumInputs (), getNumOutputs ()));
 
 	cp = 0;
 	temppr=1;
@@ -81,8 +83,27 @@ void OverdosePlugin::setParameter (int paramNumber, float value)
 {
 	if (Pars->getParameter(paramNumber) != value) {Pars->setParameter(paramNumber, value);}
 
-	filt = (float)pow(10.0,-1.6 * Pars->getParameter(OverdoseParMan::muffle));
-	gainer = (float)pow(10.0f, 2.0f * Pars->getParameter(OverdoseParMan::output) - 1.0f);
+    // the coefficients are worked out by the audio thread, at the next block
+    parametersChanged = true;
+}
+
+void OverdosePlugin::setOversampling (const int factor)
+{
+    // the audio thread picks this up at the start of its next block, and
+    // tells the host when getPluginLatency() changes
+    oversampling = factor >= 4 ? 4 : (factor >= 2 ? 2 : 1);
+}
+
+int OverdosePlugin::getPluginLatency () const
+{
+    return kernel->getLatencySamples ();
+}
+
+void OverdosePlugin::updateCoefficients ()
+{
+    kernel->setParameters (Pars->getParameter (OverdoseParMan::drive),
+                           Pars->getParameter (OverdoseParMan::muffle),
+                           Pars->getParameter (OverdoseParMan::output));
 }
 
 const String OverdosePlugin::getParameterName (int paramNumber)
@@ -134,6 +155,11 @@ void OverdosePlugin::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
     // do your pre-playback setup stuff here..
     keyboardState.reset();
+    kernel->prepare (sampleRate, oversampling);
+
+    parametersChanged = false;
+    updateCoefficients ();
+    kernel->skipRamps ();
 }
 
 void OverdosePlugin::releaseResources()
@@ -144,40 +170,22 @@ void OverdosePlugin::releaseResources()
 
 void OverdosePlugin::overdose (AudioSampleBuffer* buffer, AudioSampleBuffer* out, int sampleFrames)
 {
-	float *in1 = buffer->getSampleData (0);
-	float *in2 = buffer->getSampleData (1);
-	float *out1 = out->getSampleData (0);
-	float *out2 = out->getSampleData (1);
-
-
-	float a, b, c, d;
-    float i=Pars->getParameter(OverdoseParMan::drive), g=gainer, aa, bb;
-    float f=filt, fa=filt1, fb=filt2;
-  
-	--in1;	
-	--in2;
-	--out1;
-	--out2;
-	while(--sampleFrames >= 0)
-	{
-		a = *++in1;		
-		b = *++in2;
-		
-        aa = (a>0.0f)? (float)sqrt(a) : (float)-sqrt(-a); //overdrive
-        bb = (b>0.0f)? (float)sqrt(b) : (float)-sqrt(-b); 
-
-        fa = fa + f * (i*(aa-a) + a - fa);                //filter 
-        fb = fb + f * (i*(bb-b) + b - fb);   
+    if (oversampling != kernel->getFactor ())
+    {
+        kernel->prepare (getSampleRate (), oversampling);
 
-        c = fa * g; 
-	    d = fb * g;
+        // the latency has changed, let the host rebuild its compensation
+        updateHostDisplay ();
+    }
 
-        *++out1 = c;	
-		*++out2 = d;
-	}
+    if (parametersChanged)
+    {
+        parametersChanged = false;
+        updateCoefficients ();
+    }
 
-    if(fabs(fa)>1.0e-10) filt1 = fa; else filt1 = 0.0f; //catch denormals
-    if(fabs(fb)>1.0e-10) filt2 = fb; else filt2 = 0.0f;
+    kernel->process (buffer->getArrayOfChannels (), out->getArrayOfChannels (),
+                     jmin (buffer->getNumChannels (), out->getNumChannels ()), sampleFrames);
 }
 
 void OverdosePlugin::processBlock (AudioSampleBuffer& buffer, MidiBuffer& midiMessages)
@@ -212,6 +220,7 @@ void OverdosePlugin::getStateInformation (MemoryBlock& destData)
 	xmlState.setAttribute (T("drive"), getParameter(OverdoseParMan::drive));
 	xmlState.setAttribute (T("muffle"), getParameter(OverdoseParMan::muffle));
 	xmlState.setAttribute (T("output"), getParameter(OverdoseParMan::output));
+    xmlState.setAttribute (T("oversampling"), getOversampling ());
 
 
     // then use this helper function to stuff it into the binary blob and return it..
@@ -235,6 +244,7 @@ void OverdosePlugin::setStateInformation (const void* data, int sizeInBytes)
 				getParameter(OverdoseParMan::muffle)));
 			setParameter(OverdoseParMan::output,(float) xmlState->getDoubleAttribute (T("output"), 
 				getParameter(OverdoseParMan::output)));
+            setOversampling (xmlState->getIntAttribute (T("oversampling"), 1));
 
 
 
@@ -32,6 +32,7 @@
 
 #include "../../BasePlugin.h"
 #include "OverdoseParameters.h"
+#include "OverdoseKernel.h"
 
 
 //==============================================================================
@@ -79,6 +80,12 @@ public:
 	
 	void overdose (AudioSampleBuffer* buffer, AudioSampleBuffer* out, int sampleFrames);
 
+    //==============================================================================
+    int getMaxOversampling () const      { return 4; }
+    int getOversampling () const         { return oversampling; }
+    void setOversampling (const int factor);
+    int getPluginLatency () const;
+
 	void processBlock (AudioSampleBuffer& buffer, MidiBuffer& midiMessages);
 	
     //==============================================================================
@@ -123,9 +130,12 @@ private:
   float magnus;
 
 protected:
-  float filt1, filt2; //filter buffers
-  float filt;         //filter coeff.
-  float gainer;         //output gain
+
+    void updateCoefficients ();
+
+    ScopedPointer <OverdoseKernel> kernel;
+    volatile int oversampling;
+    volatile bool parametersChanged;
 };
 
 
@@ -31,7 +31,9 @@
 
 //==============================================================================
 MidiOutputPlugin::MidiOutputPlugin (const int numChannels_)
-  : midiOutput (0)
+  : midiOutput (0),
+    isScheduled (false),
+    samplePosition (0)
 {
 }
 
@@ -46,8 +48,16 @@ void MidiOutputPlugin::prepareToPlay (double sampleRate, int samplesPerBlock)
 
     String deviceName = T(JucePlugin_Name);
 
+    isScheduled = false;
+    samplePosition = 0;
+
 #if defined (LINUX)
     midiOutput = MidiOutput::createNewDevice (deviceName);
+
+    // events are played at their sample positions two blocks after the
+    // callback, which is about when the audio of that block comes out
+    if (midiOutput != 0)
+        isScheduled = midiOutput->startScheduledOutput (2.0 * samplesPerBlock / sampleRate);
 #endif
 }
 
@@ -59,8 +69,21 @@ void MidiOutputPlugin::releaseResources()
 void MidiOutputPlugin::processBlock (AudioSampleBuffer& buffer,
                                      MidiBuffer& midiMessages)
 {
+    if (midiOutput == 0)
+        return;
+
     MidiBuffer* midiBuffer = midiBuffers.getUnchecked (0);
 
+#if defined (LINUX)
+    if (isScheduled)
+    {
+        // this only queues the events, the device thread talks to alsa
+        midiOutput->scheduleBlockOfMessages (*midiBuffer, samplePosition, getSampleRate());
+        samplePosition += buffer.getNumSamples();
+        return;
+    }
+#endif
+
     if (midiBuffer->getNumEvents() > 0)
     {
         int samplePos = 0;
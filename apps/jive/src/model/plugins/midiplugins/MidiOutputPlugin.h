@@ -65,6 +65,10 @@ public:
 private:
 
     MidiOutput* midiOutput;
+
+    // true when the events go out through the device's scheduled output
+    bool isScheduled;
+    int64 samplePosition;
 };
 
 
@@ -28,6 +28,7 @@
 
 #include "GraphComponent.h"
 #include "../HostFilterComponent.h"
+#include "../model/plugins/TrackPlugin.h"
 
 //==============================================================================
 void GraphComponentSelectedModules::itemSelected (GraphNodeComponent* item)
@@ -82,6 +83,8 @@ GraphComponent::~GraphComponent()
 {
     DBG ("GraphComponent::~GraphComponent");
 
+    analysisWindows.clear (true);
+
     cleanInternalGraph ();
     
     deleteAndZero (lassoComponent);
@@ -455,7 +458,7 @@ void GraphComponent::nodePopupMenuSelected (GraphNodeComponent* node)
     currentClickedNode = node;
 
     bool addFirstSeparator = false;
-    PopupMenu menu, subMenu, synthMidiChanMenu, midiChanMenu;
+    PopupMenu menu, subMenu, synthMidiChanMenu, midiChanMenu, oversamplingMenu, resamplingMenu;
 
     BasePlugin* plugin = (BasePlugin*) node->getUserData ();
 
@@ -492,6 +495,51 @@ void GraphComponent::nodePopupMenuSelected (GraphNodeComponent* node)
     menu.addItem (5, "Mute", true, plugin->isMuted ());
     menu.addItem (6, "Bypass", true, plugin->isBypass ());
     menu.addItem (7, "Solo", false, false);
+    menu.addItem (13, "Flush denormals", true, ! plugin->isDenormalsAllowed ());
+    if (plugin->getDenormalEvents () > 0)
+        menu.addItem (14, "Reset denormal events (" + String (plugin->getDenormalEvents ()) + ")");
+    menu.addItem (15, "Sample accurate automation", true, plugin->isSampleAccurateAutomation ());
+    if (plugin->getNumOutputs () > 0)
+        menu.addItem (17, "Analyse output", true, plugin->getOutputTap () != 0);
+    if (plugin->getMaxOversampling () > 1)
+    {
+        for (int factor = 1; factor <= plugin->getMaxOversampling (); factor *= 2)
+            oversamplingMenu.addItem (3000 + factor, String (factor) + "x", true, plugin->getOversampling () == factor);
+
+        menu.addSubMenu (T("Oversampling"), oversamplingMenu);
+    }
+    if (plugin->getType () == JOST_PLUGINTYPE_TRACK)
+    {
+        ClipTimeline& timeline = ((TrackPlugin*) plugin)->getTimeline ();
+
+        const StringArray qualityNames (Resampler::getQualityNames ());
+        for (int i = 0; i < qualityNames.size (); ++i)
+            resamplingMenu.addItem (4000 + i, qualityNames [i], true, (int) timeline.getResamplingQuality () == i);
+
+        menu.addSubMenu (T("Resampling quality"), resamplingMenu);
+
+        // what the tempo synced clips that are buffered now cost
+        int numStretched = 0, maxLatency = 0;
+        float totalLoad = 0.0f;
+
+        for (int i = 0; i < timeline.getNumClips (); ++i)
+        {
+            float cpuLoad;
+            int latencySamples;
+
+            if (timeline.getClipStretchInfo (timeline.getClipId (i), cpuLoad, latencySamples))
+            {
+                ++numStretched;
+                totalLoad += cpuLoad;
+                maxLatency = jmax (maxLatency, latencySamples);
+            }
+        }
+
+        if (numStretched > 0)
+            menu.addItem (16, "Stretching " + String (numStretched) + " clips: "
+                                + String (totalLoad * 100.0f, 1) + "% cpu, "
+                                + String (maxLatency) + " samples latency", false);
+    }
     menu.addSeparator ();
 
    synthMidiChanMenu.addItem(2020, "Omni", true, !plugin->getSynthInputChannelFilter() || plugin->getSynthInputChannel() == -1);
@@ -574,6 +622,46 @@ void GraphComponent::nodePopupMenuSelected (GraphNodeComponent* node)
         break;
     case 7: // Solo (TODO)
         break;
+    case 13: // Flush denormals
+        {
+            if (plugin)
+                plugin->setDenormalsAllowed (! plugin->isDenormalsAllowed ());
+        }
+        break;
+    case 14: // Reset denormal events
+        {
+            if (plugin)
+                plugin->resetDenormalEvents ();
+        }
+        break;
+    case 15: // Sample accurate automation
+        {
+            if (plugin)
+                plugin->setSampleAccurateAutomation (! plugin->isSampleAccurateAutomation ());
+        }
+        break;
+    case 3001: // Oversampling
+    case 3002:
+    case 3004:
+        {
+            if (plugin)
+                plugin->setOversampling (result - 3000);
+        }
+        break;
+    case 17: // Output analysis
+        {
+            if (plugin)
+                openOutputAnalysisWindow (plugin);
+        }
+        break;
+    case 4000: // Resampling quality
+    case 4001:
+    case 4002:
+        {
+            if (plugin && plugin->getType () == JOST_PLUGINTYPE_TRACK)
+                ((TrackPlugin*) plugin)->getTimeline ().setResamplingQuality ((Resampler::Quality) (result - 4000));
+        }
+        break;
     case 8: // Disconnect all
         node->breakAllLinks();
         break;
@@ -799,6 +887,9 @@ void GraphComponent::setHost (Host* hostToDisplay)
 {
     DBG ("GraphComponent::setHost");
 
+    // the windows are listening to the old host
+    analysisWindows.clear (true);
+
     host = hostToDisplay;
 
     updateDisplayPlugins ();
@@ -1136,6 +1227,26 @@ bool GraphComponent::deletePluginNode (GraphNodeComponent* node)
     return false;
 }
 
+//==============================================================================
+void GraphComponent::openOutputAnalysisWindow (BasePlugin* plugin)
+{
+    for (int i = 0; i < analysisWindows.size (); i++)
+    {
+        if (analysisWindows.getUnchecked (i)->getPlugin () == plugin)
+        {
+            analysisWindows.getUnchecked (i)->toFront (true);
+            return;
+        }
+    }
+
+    analysisWindows.add (new OutputAnalysisWindow (this, host, plugin));
+}
+
+void GraphComponent::closeOutputAnalysisWindow (OutputAnalysisWindow* window)
+{
+    analysisWindows.removeObject (window, true);
+}
+
 //==============================================================================
 void GraphComponent::recalculateConnectionsRecursive (GraphNodeComponent* node,
                                                       ProcessingGraph* graph,
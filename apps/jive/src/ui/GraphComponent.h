@@ -31,6 +31,7 @@
 
 #include "../Config.h"
 #include "../model/Host.h"
+#include "utility/OutputAnalysisWindow.h"
 
 
 //==============================================================================
@@ -119,6 +120,13 @@ public:
     bool closeSelectedPlugins ();
     bool closeAllPlugins ();
 
+    //==============================================================================
+    /** Opens the analysis window of a plugin outputs, or brings it to front */
+    void openOutputAnalysisWindow (BasePlugin* plugin);
+
+    /** Closes an analysis window, which stops the analysis of its plugin */
+    void closeOutputAnalysisWindow (OutputAnalysisWindow* window);
+
     //==============================================================================
     enum ColourIds
     {
@@ -199,6 +207,7 @@ protected:
     GraphNodeComponent* inputs;
     GraphNodeComponent* outputs;
     OwnedArray<GraphNodeComponent> nodes;
+    OwnedArray<OutputAnalysisWindow> analysisWindows;
 
     GraphComponentSelectedModules selectedNodes;
     LassoComponent<GraphNodeComponent*>* lassoComponent;
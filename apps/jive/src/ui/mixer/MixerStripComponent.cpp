@@ -106,6 +106,7 @@ MixerStripComponent::MixerStripComponent (HostFilterComponent* owner_,
     muteButton->setToggleState (plugin->isMuted (), false);
     bypassButton->setToggleState (plugin->isBypass (), false);
     meter->setEnabled (plugin->getIntValue (PROP_MIXERMETERON) == 1 ? true : false);
+    plugin->setOutputMonitored (meter->isEnabled ());
 }
 
 MixerStripComponent::~MixerStripComponent()
@@ -251,6 +252,7 @@ void MixerStripComponent::mouseDown (const MouseEvent& e)
         case 9:
             meter->setEnabled (! meter->isEnabled ());
             plugin->setValue (PROP_MIXERMETERON, meter->isEnabled () ? 1 : 0);
+            plugin->setOutputMonitored (meter->isEnabled ());
             break;
         case 10:
             peakMode = ! peakMode;
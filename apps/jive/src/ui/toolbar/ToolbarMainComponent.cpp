@@ -153,6 +153,10 @@ void MainToolbarTimeDisplay::changeListenerCallback (void *objectThatHasChanged)
     else
         stopTimer ();
 
+    digitalDisplay->setTooltip (T("Latency compensation: ")
+                                + String (transport->getLatencySamples ())
+                                + T(" samples"));
+
     updateTimeDisplay ();
 }
 
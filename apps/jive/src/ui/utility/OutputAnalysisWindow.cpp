@@ -0,0 +1,193 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2007 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU Lesser General Public License, as published by the Free Software
+ Foundation; either version 2 of the License, or (at your option) any later
+ version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+#include "OutputAnalysisWindow.h"
+#include "../GraphComponent.h"
+
+
+//==============================================================================
+/**
+    Draws the latest results of a tap: the spectrum of each channel as a
+    curve, with the levels written below it.
+*/
+class OutputAnalysisWindow::AnalysisDisplay  : public Component
+{
+public:
+
+    AnalysisDisplay ()
+        : sampleRate (44100.0)
+    {
+        setOpaque (true);
+    }
+
+    void setResults (const AnalysisResults& newResults, const double newSampleRate)
+    {
+        results = newResults;
+        sampleRate = newSampleRate;
+        repaint ();
+    }
+
+    void paint (Graphics& g)
+    {
+        const int textHeight = 36;
+        const float width = (float) getWidth ();
+        const float height = (float) jmax (1, getHeight () - textHeight);
+
+        g.fillAll (Colours::black);
+
+        // a line every 12 dB
+        g.setColour (Colours::darkgrey);
+        for (int db = -12; db > minDecibels; db -= 12)
+            g.drawHorizontalLine (roundFloatToInt (decibelsToY (db, height)), 0.0f, width);
+
+        const Colour channelColours [AnalysisResults::maxChannels] = { Colours::lightgreen, Colours::orange };
+
+        for (int ch = 0; ch < results.numChannels; ++ch)
+        {
+            Path curve;
+
+            for (int band = 0; band < AnalysisResults::numSpectrumBands; ++band)
+            {
+                const float x = width * (band + 0.5f) / AnalysisResults::numSpectrumBands;
+                const float y = decibelsToY (results.spectrum [ch][band], height);
+
+                if (band == 0)
+                    curve.startNewSubPath (x, y);
+                else
+                    curve.lineTo (x, y);
+            }
+
+            g.setColour (channelColours [ch]);
+            g.strokePath (curve, PathStrokeType (1.5f));
+        }
+
+        // the levels
+        String levels, summary;
+
+        for (int ch = 0; ch < results.numChannels; ++ch)
+        {
+            levels << (ch == 0 ? "Peak " : "   ") << String (gainToDecibels (results.peak [ch]), 1)
+                   << " dB  RMS " << String (gainToDecibels (results.rms [ch]), 1) << " dB";
+        }
+
+        summary << "Loudness " << String (results.loudness, 1) << " LUFS";
+
+        if (results.numChannels > 1)
+            summary << "   Correlation " << String (results.correlation, 2);
+
+        summary << "   " << String (AnalysisResults::getBandFrequency (0, sampleRate), 0) << " to "
+                << String (AnalysisResults::getBandFrequency (AnalysisResults::numSpectrumBands - 1, sampleRate), 0) << " Hz";
+
+        g.setColour (Colours::white);
+        g.setFont (13.0f);
+        g.drawText (levels, 4, getHeight () - textHeight, getWidth () - 8, textHeight / 2, Justification::centredLeft, true);
+        g.drawText (summary, 4, getHeight () - textHeight / 2, getWidth () - 8, textHeight / 2, Justification::centredLeft, true);
+    }
+
+private:
+
+    enum { minDecibels = -96 };
+
+    static float decibelsToY (const float db, const float height)
+    {
+        return height * jlimit (0.0f, 1.0f, db / (float) minDecibels);
+    }
+
+    static float gainToDecibels (const float gain)
+    {
+        return gain > 0.0f ? jmax ((float) minDecibels, 20.0f * log10f (gain)) : (float) minDecibels;
+    }
+
+    AnalysisResults results;
+    double sampleRate;
+};
+
+
+//==============================================================================
+OutputAnalysisWindow::OutputAnalysisWindow (GraphComponent* owner_, Host* host_, BasePlugin* plugin_)
+  : DocumentWindow (T("Output analysis - ") + plugin_->getInstanceName (), Colours::black, DocumentWindow::closeButton, true),
+    owner (owner_),
+    host (host_),
+    plugin (plugin_),
+    tap (0),
+    display (0)
+{
+    setContentComponent (display = new AnalysisDisplay (), true, false);
+    setResizable (true, true);
+    centreWithSize (480, 240);
+
+    host->addListener (this);
+    tap = host->enableOutputAnalysis (plugin);
+
+    setVisible (true);
+    startTimer (1000 / 30);
+}
+
+OutputAnalysisWindow::~OutputAnalysisWindow ()
+{
+    stopTimer ();
+
+    host->removeListener (this);
+
+    if (plugin != 0)
+        host->disableOutputAnalysis (plugin);
+}
+
+//==============================================================================
+void OutputAnalysisWindow::closeButtonPressed ()
+{
+    owner->closeOutputAnalysisWindow (this);
+}
+
+void OutputAnalysisWindow::timerCallback ()
+{
+    AnalysisResults results;
+
+    if (tap != 0 && tap->getLatestResults (results))
+        display->setResults (results, tap->getSampleRate ());
+}
+
+void OutputAnalysisWindow::handleCommandMessage (int)
+{
+    owner->closeOutputAnalysisWindow (this);
+}
+
+void OutputAnalysisWindow::pluginRemoved (Host*, BasePlugin* removedPlugin)
+{
+    if (removedPlugin == plugin)
+    {
+        // the tap goes away with the plugin, and we can't delete ourselves
+        // while the host is still calling its listeners
+        stopTimer ();
+
+        plugin = 0;
+        tap = 0;
+
+        postCommandMessage (0);
+    }
+}
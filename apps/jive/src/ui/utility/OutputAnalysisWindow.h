@@ -0,0 +1,93 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2007 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU Lesser General Public License, as published by the Free Software
+ Foundation; either version 2 of the License, or (at your option) any later
+ version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+#ifndef __JUCETICE_JOSTOUTPUTANALYSISWINDOW_HEADER__
+#define __JUCETICE_JOSTOUTPUTANALYSISWINDOW_HEADER__
+
+#include "../../model/Host.h"
+
+class GraphComponent;
+
+
+//==============================================================================
+/**
+    Shows the spectrum, levels, loudness and correlation of a plugin outputs.
+
+    While the window is open the plugin has an analysis tap, which is polled
+    by a timer: closing the window removes the tap. If the plugin is removed
+    from the host first, the window closes itself.
+
+    @see Host::enableOutputAnalysis
+*/
+class OutputAnalysisWindow  : public DocumentWindow,
+                              public HostListener,
+                              public Timer
+{
+public:
+
+    //==============================================================================
+    OutputAnalysisWindow (GraphComponent* owner, Host* host, BasePlugin* plugin);
+    ~OutputAnalysisWindow ();
+
+    //==============================================================================
+    /** Returns the plugin analysed, or 0 once it was removed */
+    BasePlugin* getPlugin () const                      { return plugin; }
+
+    //==============================================================================
+    /** @internal */
+    void closeButtonPressed ();
+    /** @internal */
+    void timerCallback ();
+    /** @internal */
+    void handleCommandMessage (int commandId);
+    /** @internal */
+    void processingGraphChanged (Host* host, ProcessingGraph* audioGraph) {}
+    /** @internal */
+    void pluginAdded (Host* host, BasePlugin* plugin)   {}
+    /** @internal */
+    void pluginRemoved (Host* host, BasePlugin* plugin);
+
+    //==============================================================================
+    juce_UseDebuggingNewOperator
+
+private:
+
+    class AnalysisDisplay;
+
+    GraphComponent* owner;
+    Host* host;
+    BasePlugin* plugin;
+    AnalysisTap* tap;
+    AnalysisDisplay* display;
+
+    OutputAnalysisWindow (const OutputAnalysisWindow&);
+    const OutputAnalysisWindow& operator= (const OutputAnalysisWindow&);
+};
+
+
+#endif
@@ -37,6 +37,10 @@ public:
         startTime = endTime = 0;
         formatManager.registerBasicFormats();
         thumbnail.addChangeListener (this);
+
+        // keep the finished thumbnails on disk, so files opened again show up straight away
+        thumbnailCache.setCacheDirectory (File::getSpecialLocation (File::tempDirectory)
+                                            .getChildFile ("JuceDemo Thumbnails"));
     }
 
     ~DemoThumbnailComp()
@@ -88,7 +92,7 @@ public:
                 thumbnail.drawChannel (g, 2, 2 + heightPerChannel * i,
                                        getWidth() - 4, heightPerChannel,
                                        startTime, endTime,
-                                       i, 1.0f);
+                                       i, 1.0f, Colours::lightskyblue);
             }
         }
         else
@@ -310,6 +310,14 @@
   #define JUCETICE_INCLUDE_CURL_CODE 1
 #endif
 
+#ifndef JUCETICE_INCLUDE_LIBSAMPLERATE_CODE
+  #define JUCETICE_INCLUDE_LIBSAMPLERATE_CODE 1
+#endif
+
+#ifndef JUCETICE_INCLUDE_RUBBERBAND_CODE
+  #define JUCETICE_INCLUDE_RUBBERBAND_CODE 1
+#endif
+
 //=============================================================================
 /** Enable this to add extra memory-leak info to the new and delete operators.
 
@@ -31,6 +31,7 @@ BEGIN_JUCE_NAMESPACE
 #include "../../io/streams/juce_BufferedInputStream.h"
 #include "../../core/juce_PlatformUtilities.h"
 #include "../../text/juce_LocalisedStrings.h"
+#include "../../io/files/juce_FileInputStream.h"
 
 //==============================================================================
 static const char* const aiffFormatName = "AIFF file";
@@ -799,6 +800,31 @@ AudioFormatReader* AiffAudioFormat::createReaderFor (InputStream* sourceStream,
     return 0;
 }
 
+MemoryMappedAudioFormatReader* AiffAudioFormat::createMemoryMappedReader (const File& file)
+{
+    FileInputStream* const in = file.createInputStream();
+
+    if (in == 0)
+        return 0;
+
+    ScopedPointer <AiffAudioFormatReader> header ((AiffAudioFormatReader*) createReaderFor (in, true));
+
+    if (header == 0 || header->lengthInSamples <= 0)
+        return 0;
+
+    // aiff samples are always signed, even the 8-bit ones
+    ScopedPointer <MemoryMappedAudioFormatReader> r (new MemoryMappedAudioFormatReader (file, *header,
+                                                                                      header->dataChunkStart,
+                                                                                      header->lengthInSamples * header->bytesPerFrame,
+                                                                                      header->bytesPerFrame,
+                                                                                      header->littleEndian,
+                                                                                      false));
+    if (r->isMapped())
+        return r.release();
+
+    return 0;
+}
+
 AudioFormatWriter* AiffAudioFormat::createWriterFor (OutputStream* out,
                                                      double sampleRate,
                                                      unsigned int chans,
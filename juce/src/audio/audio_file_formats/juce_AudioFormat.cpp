@@ -555,5 +555,10 @@ const StringArray AudioFormat::getQualityOptions()
     return StringArray();
 }
 
+MemoryMappedAudioFormatReader* AudioFormat::createMemoryMappedReader (const File&)
+{
+    return 0;
+}
+
 
 END_JUCE_NAMESPACE
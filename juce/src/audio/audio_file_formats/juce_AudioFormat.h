@@ -28,6 +28,7 @@
 
 #include "juce_AudioFormatReader.h"
 #include "juce_AudioFormatWriter.h"
+#include "juce_MemoryMappedAudioFormatReader.h"
 #include "../../containers/juce_Array.h"
 
 
@@ -114,6 +115,17 @@ public:
     virtual AudioFormatReader* createReaderFor (InputStream* sourceStream,
                                                 const bool deleteStreamIfOpeningFails) = 0;
 
+    /** Tries to create a reader that accesses the file's sample data through a
+        memory-map instead of a stream.
+
+        This is only possible for formats that store uncompressed frames, and the
+        default implementation just returns 0. If the file can't be parsed or mapped,
+        this will return 0 too, and createReaderFor() should be used instead.
+
+        @see MemoryMappedAudioFormatReader, AudioFormatManager::createReaderFor
+    */
+    virtual MemoryMappedAudioFormatReader* createMemoryMappedReader (const File& file);
+
     /** Tries to create an object that can write to a stream with this audio format.
 
         The writer object that is returned can be used to write to the stream, and
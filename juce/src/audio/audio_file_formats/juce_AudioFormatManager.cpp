@@ -172,6 +172,12 @@ AudioFormatReader* AudioFormatManager::createReaderFor (const File& file)
 
         if (af->canHandleFile (file))
         {
+            // uncompressed formats are quicker to read straight out of a memory-map
+            AudioFormatReader* const mapped = af->createMemoryMappedReader (file);
+
+            if (mapped != 0)
+                return mapped;
+
             InputStream* const in = file.createInputStream();
 
             if (in != 0)
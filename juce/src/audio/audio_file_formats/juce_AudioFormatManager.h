@@ -116,6 +116,10 @@ public:
 
         If none of the registered formats can open the file, it'll return 0. If it
         returns a reader, it's the caller's responsibility to delete the reader.
+
+        Formats that can memory-map the file will return a MemoryMappedAudioFormatReader,
+        so callers that want floats can check for one of those and use its readFloat()
+        method.
     */
     AudioFormatReader* createReaderFor (const File& audioFile);
 
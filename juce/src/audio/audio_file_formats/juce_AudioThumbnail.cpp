@@ -29,24 +29,36 @@ BEGIN_JUCE_NAMESPACE
 
 #include "juce_AudioThumbnail.h"
 #include "juce_AudioThumbnailCache.h"
+#include "../dsp/juce_AudioSampleBuffer.h"
+#include "../../io/streams/juce_FileInputSource.h"
 
 const int timeBeforeDeletingReader = 2000;
 
 
 //==============================================================================
+/*  The thumbnail data is a stack of levels, each one half the resolution of the
+    one below it. The first level has one entry per samplesPerThumbSample source
+    samples, and each entry holds a min, max and rms byte for every channel.
+
+    The levels are stored one after the other, and within a level, each channel's
+    entries are stored together.
+*/
 struct AudioThumbnailDataFormat
 {
     char thumbnailMagic[4];
     int samplesPerThumbSample;
     int64 totalSamples;         // source samples
     int64 numFinishedSamples;   // source samples
-    int numThumbnailSamples;
+    int numThumbnailSamples;    // entries in the most detailed level
     int numChannels;
     int sampleRate;
-    char future[16];
+    int numLevels;
+    char future[12];
     char data[1];
 };
 
+static const int bytesPerThumbEntry = 3;    // min, max, rms
+
 #if JUCE_BIG_ENDIAN
  static void swap (int& n)   { n = (int) ByteOrder::swap ((uint32) n); }
  static void swap (int64& n) { n = (int64) ByteOrder::swap ((uint64) n); }
@@ -63,9 +75,50 @@ static void swapEndiannessIfNeeded (AudioThumbnailDataFormat* const d)
     swap (d->numThumbnailSamples);
     swap (d->numChannels);
     swap (d->sampleRate);
+    swap (d->numLevels);
 #endif
 }
 
+static int getNumLevelsFor (const int numThumbnailSamples) throw()
+{
+    int numLevels = 1;
+
+    while (numLevels < 24 && (numThumbnailSamples >> numLevels) > 0)
+        ++numLevels;
+
+    return numLevels;
+}
+
+static int getNumEntriesInLevel (const AudioThumbnailDataFormat* const d, const int level) throw()
+{
+    return (d->numThumbnailSamples + (1 << level) - 1) >> level;
+}
+
+static int getLevelDataSize (const AudioThumbnailDataFormat* const d, const int numLevels) throw()
+{
+    int total = 0;
+
+    for (int i = 0; i < numLevels; ++i)
+        total += getNumEntriesInLevel (d, i) * d->numChannels * bytesPerThumbEntry;
+
+    return total;
+}
+
+// the number of entries in a level that have all of their source samples scanned
+static int getNumFinishedEntriesInLevel (const AudioThumbnailDataFormat* const d,
+                                         const int64 numFinishedSamples, const int level) throw()
+{
+    if (numFinishedSamples >= d->totalSamples)
+        return getNumEntriesInLevel (d, level);
+
+    return (int) (numFinishedSamples / d->samplesPerThumbSample) >> level;
+}
+
+static inline char levelToChar (const float level) throw()
+{
+    return (char) jlimit (-128, 127, roundFloatToInt (level * 127.0f));
+}
+
 //==============================================================================
 AudioThumbnail::AudioThumbnail (const int orginalSamplesPerThumbnailSample_,
                                 AudioFormatManager& formatManagerToUse_,
@@ -94,7 +147,7 @@ void AudioThumbnail::setSource (InputSource* const newSource)
     clear();
 
     if (newSource != 0
-          && ! (cache.loadThumb (*this, newSource->hashCode())
+          && ! (cache.loadThumb (*this, getSourceHashCode())
                  && isFullyLoaded()))
     {
         {
@@ -121,7 +174,6 @@ bool AudioThumbnail::useTimeSlice()
         if (reader != 0)
             startTimer (timeBeforeDeletingReader);
 
-        cache.removeThumbnail (this);
         return false;
     }
 
@@ -138,7 +190,10 @@ bool AudioThumbnail::useTimeSlice()
         const bool justFinished = isFullyLoaded();
 
         if (justFinished)
-            cache.storeThumb (*this, source->hashCode());
+        {
+            startTimer (timeBeforeDeletingReader);
+            cache.storeThumb (*this, getSourceHashCode());
+        }
 
         return ! justFinished;
     }
@@ -150,6 +205,12 @@ AudioFormatReader* AudioThumbnail::createReader() const
 {
     if (source != 0)
     {
+        // files can be opened by name, so the manager gets a chance to map them
+        const FileInputSource* const fileSource = dynamic_cast <const FileInputSource*> ((InputSource*) source);
+
+        if (fileSource != 0)
+            return formatManagerToUse.createReaderFor (fileSource->getFile());
+
         InputStream* const audioFileStream = source->createInputStream();
 
         if (audioFileStream != 0)
@@ -159,6 +220,26 @@ AudioFormatReader* AudioThumbnail::createReader() const
     return 0;
 }
 
+int64 AudioThumbnail::getSourceHashCode() const
+{
+    if (source == 0)
+        return 0;
+
+    const FileInputSource* const fileSource = dynamic_cast <const FileInputSource*> ((InputSource*) source);
+
+    if (fileSource != 0)
+    {
+        // mix in the size and date, so a stored thumbnail won't be used for a
+        // file that has changed since it was made
+        const File& file = fileSource->getFile();
+
+        return (file.hashCode64() * 65599 + file.getSize()) * 65599
+                 + file.getLastModificationTime().toMilliseconds();
+    }
+
+    return source->hashCode();
+}
+
 void AudioThumbnail::timerCallback()
 {
     stopTimer();
@@ -176,7 +257,7 @@ void AudioThumbnail::clear()
     d->thumbnailMagic[0] = 'j';
     d->thumbnailMagic[1] = 'a';
     d->thumbnailMagic[2] = 't';
-    d->thumbnailMagic[3] = 'm';
+    d->thumbnailMagic[3] = 'n';
 
     d->samplesPerThumbSample = orginalSamplesPerThumbnailSample;
     d->totalSamples = 0;
@@ -184,6 +265,7 @@ void AudioThumbnail::clear()
     d->numThumbnailSamples = 0;
     d->numChannels = 0;
     d->sampleRate = 0;
+    d->numLevels = 0;
 
     numSamplesCached = 0;
     cacheNeedsRefilling = true;
@@ -197,15 +279,29 @@ void AudioThumbnail::loadFrom (InputStream& input)
     input.readIntoMemoryBlock (data);
 
     AudioThumbnailDataFormat* const d = (AudioThumbnailDataFormat*) data.getData();
-    swapEndiannessIfNeeded (d);
 
-    if (! (d->thumbnailMagic[0] == 'j'
-             && d->thumbnailMagic[1] == 'a'
-             && d->thumbnailMagic[2] == 't'
-             && d->thumbnailMagic[3] == 'm'))
+    if (data.getSize() < sizeof (AudioThumbnailDataFormat))
     {
         clear();
     }
+    else
+    {
+        swapEndiannessIfNeeded (d);
+
+        // the data may have come from a file, so make sure it's all there
+        if (! (d->thumbnailMagic[0] == 'j'
+                 && d->thumbnailMagic[1] == 'a'
+                 && d->thumbnailMagic[2] == 't'
+                 && d->thumbnailMagic[3] == 'n'
+                 && d->samplesPerThumbSample > 0
+                 && d->numChannels >= 0 && d->numChannels <= 2
+                 && d->numThumbnailSamples >= 0
+                 && d->numLevels == getNumLevelsFor (d->numThumbnailSamples)
+                 && data.getSize() >= sizeof (AudioThumbnailDataFormat) + getLevelDataSize (d, d->numLevels)))
+        {
+            clear();
+        }
+    }
 
     numSamplesCached = 0;
     cacheNeedsRefilling = true;
@@ -227,12 +323,14 @@ bool AudioThumbnail::initialiseFromAudioFile (AudioFormatReader& fileReader)
     d->numChannels = jmin ((uint32) 2, fileReader.numChannels);
     d->numFinishedSamples = 0;
     d->sampleRate = roundToInt (fileReader.sampleRate);
-    d->numThumbnailSamples = (int) (d->totalSamples / d->samplesPerThumbSample) + 1;
+    d->numThumbnailSamples = (int) ((d->totalSamples + d->samplesPerThumbSample - 1) / d->samplesPerThumbSample);
+    d->numLevels = getNumLevelsFor (d->numThumbnailSamples);
 
-    data.setSize (sizeof (AudioThumbnailDataFormat) + 3 + d->numThumbnailSamples * d->numChannels * 2);
+    const int levelDataSize = getLevelDataSize (d, d->numLevels);
+    data.setSize (sizeof (AudioThumbnailDataFormat) + 3 + levelDataSize);
 
     d = (AudioThumbnailDataFormat*) data.getData();
-    zeromem (&(d->data[0]), d->numThumbnailSamples * d->numChannels * 2);
+    zeromem (&(d->data[0]), levelDataSize);
 
     return d->totalSamples > 0;
 }
@@ -244,12 +342,15 @@ bool AudioThumbnail::readNextBlockFromAudioFile (AudioFormatReader& fileReader)
     if (d->numFinishedSamples < d->totalSamples)
     {
         const int numToDo = (int) jmin ((int64) 65536, d->totalSamples - d->numFinishedSamples);
+        const int64 previouslyFinished = d->numFinishedSamples;
 
         generateSection (fileReader,
                          d->numFinishedSamples,
                          numToDo);
 
         d->numFinishedSamples += numToDo;
+
+        generateLevels (previouslyFinished);
     }
 
     cacheNeedsRefilling = true;
@@ -282,50 +383,115 @@ void AudioThumbnail::generateSection (AudioFormatReader& fileReader,
     AudioThumbnailDataFormat* const d = (AudioThumbnailDataFormat*) data.getData();
     jassert (d != 0);
 
-    int firstDataPos = (int) (startSample / d->samplesPerThumbSample);
-    int lastDataPos = (int) ((startSample + numSamples) / d->samplesPerThumbSample);
+    const int firstDataPos = (int) (startSample / d->samplesPerThumbSample);
+    const int lastDataPos = (startSample + numSamples >= d->totalSamples)
+                                ? d->numThumbnailSamples
+                                : (int) ((startSample + numSamples) / d->samplesPerThumbSample);
+
+    if (lastDataPos <= firstDataPos)
+        return;
+
+    // read the whole section in one go, rather than asking the reader for the
+    // levels of each entry separately
+    const int64 sourceStart = firstDataPos * (int64) d->samplesPerThumbSample;
+    const int sourceLength = (int) (jmin (d->totalSamples, lastDataPos * (int64) d->samplesPerThumbSample) - sourceStart);
 
-    char* l = getChannelData (0);
-    char* r = getChannelData (1);
+    AudioSampleBuffer buffer (2, jmax (1, sourceLength));
+    buffer.readFromAudioReader (&fileReader, 0, sourceLength, (int) sourceStart, true, true);
 
-    for (int i = firstDataPos; i < lastDataPos; ++i)
+    for (int chan = 0; chan < d->numChannels; ++chan)
     {
-        const int sourceStart = i * d->samplesPerThumbSample;
-        const int sourceEnd = sourceStart + d->samplesPerThumbSample;
+        char* dest = getChannelData (chan, 0) + firstDataPos * bytesPerThumbEntry;
+        const float* src = buffer.getSampleData (chan, 0);
+        int numLeft = sourceLength;
 
-        float lowestLeft, highestLeft, lowestRight, highestRight;
+        for (int i = firstDataPos; i < lastDataPos; ++i)
+        {
+            const int num = jmin (numLeft, d->samplesPerThumbSample);
 
-        fileReader.readMaxLevels (sourceStart,
-                                  sourceEnd - sourceStart,
-                                  lowestLeft,
-                                  highestLeft,
-                                  lowestRight,
-                                  highestRight);
+            float mn = 0, mx = 0;
+            double sumOfSquares = 0;
 
-        int n = i * 2;
+            if (num > 0)
+            {
+                mn = mx = src[0];
 
-        if (r != 0)
-        {
-            l [n]   = (char) jlimit (-128.0f, 127.0f, lowestLeft * 127.0f);
-            r [n++] = (char) jlimit (-128.0f, 127.0f, lowestRight * 127.0f);
-            l [n]   = (char) jlimit (-128.0f, 127.0f, highestLeft * 127.0f);
-            r [n++] = (char) jlimit (-128.0f, 127.0f, highestRight * 127.0f);
+                for (int j = 0; j < num; ++j)
+                {
+                    const float s = src[j];
+
+                    if (s < mn)  mn = s;
+                    if (s > mx)  mx = s;
+
+                    sumOfSquares += s * s;
+                }
+
+                sumOfSquares /= num;
+            }
+
+            dest[0] = levelToChar (mn);
+            dest[1] = levelToChar (mx);
+            dest[2] = levelToChar ((float) sqrt (sumOfSquares));
+
+            dest += bytesPerThumbEntry;
+            src += num;
+            numLeft -= num;
         }
-        else
+    }
+}
+
+void AudioThumbnail::generateLevels (const int64 previouslyFinishedSamples)
+{
+    AudioThumbnailDataFormat* const d = (AudioThumbnailDataFormat*) data.getData();
+    jassert (d != 0);
+
+    // each entry of a level merges two entries of the level below, once they're both done
+    for (int level = 1; level < d->numLevels; ++level)
+    {
+        const int start = getNumFinishedEntriesInLevel (d, previouslyFinishedSamples, level);
+        const int end = getNumFinishedEntriesInLevel (d, d->numFinishedSamples, level);
+        const int numBelow = getNumEntriesInLevel (d, level - 1);
+
+        for (int chan = 0; chan < d->numChannels; ++chan)
         {
-            l [n++] = (char) jlimit (-128.0f, 127.0f, lowestLeft * 127.0f);
-            l [n++] = (char) jlimit (-128.0f, 127.0f, highestLeft * 127.0f);
+            const char* const below = getChannelData (chan, level - 1);
+            char* dest = getChannelData (chan, level) + start * bytesPerThumbEntry;
+
+            for (int i = start; i < end; ++i)
+            {
+                const char* const a = below + (i * 2) * bytesPerThumbEntry;
+
+                if (i * 2 + 1 < numBelow)
+                {
+                    const char* const b = a + bytesPerThumbEntry;
+                    const float rmsA = a[2] / 127.0f;
+                    const float rmsB = b[2] / 127.0f;
+
+                    dest[0] = jmin (a[0], b[0]);
+                    dest[1] = jmax (a[1], b[1]);
+                    dest[2] = levelToChar (sqrtf ((rmsA * rmsA + rmsB * rmsB) * 0.5f));
+                }
+                else
+                {
+                    dest[0] = a[0];
+                    dest[1] = a[1];
+                    dest[2] = a[2];
+                }
+
+                dest += bytesPerThumbEntry;
+            }
         }
     }
 }
 
-char* AudioThumbnail::getChannelData (int channel) const
+char* AudioThumbnail::getChannelData (int channel, int level) const
 {
     AudioThumbnailDataFormat* const d = (AudioThumbnailDataFormat*) data.getData();
     jassert (d != 0);
 
-    if (channel >= 0 && channel < d->numChannels)
-        return d->data + (channel * 2 * d->numThumbnailSamples);
+    if (channel >= 0 && channel < d->numChannels && level >= 0 && level < d->numLevels)
+        return d->data + getLevelDataSize (d, level)
+                       + channel * getNumEntriesInLevel (d, level) * bytesPerThumbEntry;
 
     return 0;
 }
@@ -368,9 +534,11 @@ void AudioThumbnail::refillCache (const int numSamples,
     cachedStart = startTime;
     cachedTimePerPixel = timePerPixel;
 
-    cachedLevels.ensureSize (2 * numChannelsCached * numSamples);
+    const int cacheStride = numChannelsCached * bytesPerThumbEntry;
+    cachedLevels.ensureSize (cacheStride * numSamples);
 
-    const bool needExtraDetail = (timePerPixel * d->sampleRate <= d->samplesPerThumbSample);
+    const double samplesPerPixel = timePerPixel * d->sampleRate;
+    const bool needExtraDetail = (samplesPerPixel <= d->samplesPerThumbSample);
 
     const ScopedLock sl (readerLock);
 
@@ -379,7 +547,7 @@ void AudioThumbnail::refillCache (const int numSamples,
     if (needExtraDetail && reader == 0)
         reader = createReader();
 
-    if (reader != 0 && timePerPixel * d->sampleRate <= d->samplesPerThumbSample)
+    if (reader != 0 && needExtraDetail)
     {
         startTimer (timeBeforeDeletingReader);
 
@@ -401,16 +569,19 @@ void AudioThumbnail::refillCache (const int numSamples,
                                        jmax (1, nextSample - sample),
                                        lmin, lmax, rmin, rmax);
 
-                cacheData[0] = (char) jlimit (-128, 127, roundFloatToInt (lmin * 127.0f));
-                cacheData[1] = (char) jlimit (-128, 127, roundFloatToInt (lmax * 127.0f));
+                // the rms isn't worth working out at this zoom
+                cacheData[0] = levelToChar (lmin);
+                cacheData[1] = levelToChar (lmax);
+                cacheData[2] = 0;
 
                 if (numChannelsCached > 1)
                 {
-                    cacheData[2] = (char) jlimit (-128, 127, roundFloatToInt (rmin * 127.0f));
-                    cacheData[3] = (char) jlimit (-128, 127, roundFloatToInt (rmax * 127.0f));
+                    cacheData[3] = levelToChar (rmin);
+                    cacheData[4] = levelToChar (rmax);
+                    cacheData[5] = 0;
                 }
 
-                cacheData += 2 * numChannelsCached;
+                cacheData += cacheStride;
             }
 
             startTime += timePerPixel;
@@ -419,16 +590,23 @@ void AudioThumbnail::refillCache (const int numSamples,
     }
     else
     {
+        // use the coarsest level that still has at least one entry per pixel
+        int level = 0;
+
+        while (level < d->numLevels - 1
+                && ((double) d->samplesPerThumbSample * (2 << level)) <= samplesPerPixel)
+            ++level;
+
+        const double timeToThumbSampleFactor = d->sampleRate / (double) (d->samplesPerThumbSample << level);
+        const int numFinished = getNumFinishedEntriesInLevel (d, d->numFinishedSamples, level);
+
         for (int channelNum = 0; channelNum < numChannelsCached; ++channelNum)
         {
-            char* const channelData = getChannelData (channelNum);
-            char* cacheData = ((char*) cachedLevels.getData()) + channelNum * 2;
-
-            const double timeToThumbSampleFactor = d->sampleRate / (double) d->samplesPerThumbSample;
+            const char* const channelData = getChannelData (channelNum, level);
+            char* cacheData = ((char*) cachedLevels.getData()) + channelNum * bytesPerThumbEntry;
 
             startTime = cachedStart;
             int sample = roundToInt (startTime * timeToThumbSampleFactor);
-            const int numFinished = (int) (d->numFinishedSamples / d->samplesPerThumbSample);
 
             for (int i = numSamples; --i >= 0;)
             {
@@ -438,22 +616,24 @@ void AudioThumbnail::refillCache (const int numSamples,
                 {
                     char mx = -128;
                     char mn = 127;
+                    float sumOfSquares = 0;
+                    int num = 0;
 
                     while (sample <= nextSample)
                     {
                         if (sample >= numFinished)
                             break;
 
-                        const int n = sample << 1;
-                        const char sampMin = channelData [n];
-                        const char sampMax = channelData [n + 1];
+                        const char* const entry = channelData + sample * bytesPerThumbEntry;
 
-                        if (sampMin < mn)
-                            mn = sampMin;
+                        if (entry[0] < mn)
+                            mn = entry[0];
 
-                        if (sampMax > mx)
-                            mx = sampMax;
+                        if (entry[1] > mx)
+                            mx = entry[1];
 
+                        sumOfSquares += (float) (entry[2] * entry[2]);
+                        ++num;
                         ++sample;
                     }
 
@@ -461,20 +641,23 @@ void AudioThumbnail::refillCache (const int numSamples,
                     {
                         cacheData[0] = mn;
                         cacheData[1] = mx;
+                        cacheData[2] = (char) jlimit (0, 127, roundFloatToInt (sqrtf (sumOfSquares / num)));
                     }
                     else
                     {
                         cacheData[0] = 1;
                         cacheData[1] = 0;
+                        cacheData[2] = 0;
                     }
                 }
                 else
                 {
                     cacheData[0] = 1;
                     cacheData[1] = 0;
+                    cacheData[2] = 0;
                 }
 
-                cacheData += numChannelsCached * 2;
+                cacheData += cacheStride;
                 startTime += timePerPixel;
                 sample = nextSample;
             }
@@ -488,6 +671,28 @@ void AudioThumbnail::drawChannel (Graphics& g,
                                   double endTime,
                                   int channelNum,
                                   const float verticalZoomFactor)
+{
+    drawChannelLevels (g, x, y, w, h, startTime, endTime, channelNum, verticalZoomFactor, 0);
+}
+
+void AudioThumbnail::drawChannel (Graphics& g,
+                                  int x, int y, int w, int h,
+                                  double startTime,
+                                  double endTime,
+                                  int channelNum,
+                                  const float verticalZoomFactor,
+                                  const Colour& rmsColour)
+{
+    drawChannelLevels (g, x, y, w, h, startTime, endTime, channelNum, verticalZoomFactor, &rmsColour);
+}
+
+void AudioThumbnail::drawChannelLevels (Graphics& g,
+                                        int x, int y, int w, int h,
+                                        double startTime,
+                                        double endTime,
+                                        int channelNum,
+                                        const float verticalZoomFactor,
+                                        const Colour* const rmsColour)
 {
     refillCache (w, startTime, (endTime - startTime) / w);
 
@@ -505,15 +710,20 @@ void AudioThumbnail::drawChannel (Graphics& g,
         w -= skipLeft;
         x += skipLeft;
 
-        const char* cacheData = ((const char*) cachedLevels.getData())
-                                   + (channelNum << 1)
-                                   + skipLeft * (numChannelsCached << 1);
+        const int cacheStride = numChannelsCached * bytesPerThumbEntry;
+        const char* const firstCacheData = ((const char*) cachedLevels.getData())
+                                              + channelNum * bytesPerThumbEntry
+                                              + skipLeft * cacheStride;
+
+        const char* cacheData = firstCacheData;
+        const int startX = x;
+        const int numPixels = w;
 
         while (--w >= 0)
         {
             const char mn = cacheData[0];
             const char mx = cacheData[1];
-            cacheData += numChannelsCached << 1;
+            cacheData += cacheStride;
 
             if (mn <= mx) // if the wrong way round, signifies that the sample's not yet known
                 g.drawLine ((float) x, jmax (midY - mx * vscale - 0.3f, topY),
@@ -524,6 +734,36 @@ void AudioThumbnail::drawChannel (Graphics& g,
             if (x >= clip.getRight())
                 break;
         }
+
+        if (rmsColour != 0)
+        {
+            // the rms goes on top of the peaks, in its own colour
+            g.saveState();
+            g.setColour (*rmsColour);
+
+            cacheData = firstCacheData;
+            x = startX;
+            w = numPixels;
+
+            while (--w >= 0)
+            {
+                const char mn = cacheData[0];
+                const char mx = cacheData[1];
+                const char rms = cacheData[2];
+                cacheData += cacheStride;
+
+                if (mn <= mx && rms > 0)
+                    g.drawLine ((float) x, jmax (midY - rms * vscale, topY),
+                                (float) x, jmin (midY + rms * vscale, bottomY));
+
+                ++x;
+
+                if (x >= clip.getRight())
+                    break;
+            }
+
+            g.restoreState();
+        }
     }
 }
 
@@ -53,7 +53,9 @@ class AudioThumbnailCache;
     listeners should repaint themselves.
 
     The thumbnail stores an internal low-res version of the wave data, and this can
-    be loaded and saved to avoid having to scan the file again.
+    be loaded and saved to avoid having to scan the file again. This is kept at
+    several resolutions, each half as detailed as the one before, and the drawing
+    methods pick the one that suits the zoom level.
 
     @see AudioThumbnailCache
 */
@@ -136,6 +138,20 @@ public:
                       int channelNum,
                       const float verticalZoomFactor);
 
+    /** Renders the waveform shape for a channel, with its rms level on top.
+
+        This works like the other drawChannel() method, but also draws the rms
+        level of the waveform in the colour given. The peaks are drawn in the
+        graphics context's current colour.
+    */
+    void drawChannel (Graphics& g,
+                      int x, int y, int w, int h,
+                      double startTimeSeconds,
+                      double endTimeSeconds,
+                      int channelNum,
+                      const float verticalZoomFactor,
+                      const Colour& rmsColour);
+
     /** Returns true if the low res preview is fully generated.
     */
     bool isFullyLoaded() const throw();
@@ -167,12 +183,23 @@ private:
     void clear();
 
     AudioFormatReader* createReader() const;
+    int64 getSourceHashCode() const;
 
     void generateSection (AudioFormatReader& reader,
                           int64 startSample,
                           int numSamples);
 
-    char* getChannelData (int channel) const;
+    void generateLevels (const int64 previouslyFinishedSamples);
+
+    char* getChannelData (int channel, int level) const;
+
+    void drawChannelLevels (Graphics& g,
+                            int x, int y, int w, int h,
+                            double startTimeSeconds,
+                            double endTimeSeconds,
+                            int channelNum,
+                            const float verticalZoomFactor,
+                            const Colour* const rmsColour);
 
     void refillCache (const int numSamples,
                       double startTime,
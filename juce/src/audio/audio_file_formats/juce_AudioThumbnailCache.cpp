@@ -30,6 +30,7 @@ BEGIN_JUCE_NAMESPACE
 #include "juce_AudioThumbnailCache.h"
 #include "../../io/streams/juce_MemoryInputStream.h"
 #include "../../io/streams/juce_MemoryOutputStream.h"
+#include "../../core/juce_SystemStats.h"
 
 
 //==============================================================================
@@ -42,36 +43,84 @@ struct ThumbnailCacheEntry
     juce_UseDebuggingNewOperator
 };
 
+//==============================================================================
+class ThumbnailGenerationJob  : public ThreadPoolJob
+{
+public:
+    ThumbnailGenerationJob (AudioThumbnail& thumb_)
+        : ThreadPoolJob (T("thumbnail")),
+          thumb (thumb_)
+    {
+    }
+
+    ThreadPoolJob::JobStatus runJob()
+    {
+        // each call scans one block of the file, so the other jobs get a turn in between
+        if (shouldExit() || ! thumb.useTimeSlice())
+            return jobHasFinished;
+
+        return jobNeedsRunningAgain;
+    }
+
+    AudioThumbnail& thumb;
+
+    juce_UseDebuggingNewOperator
+
+private:
+    ThumbnailGenerationJob (const ThumbnailGenerationJob&);
+    const ThumbnailGenerationJob& operator= (const ThumbnailGenerationJob&);
+};
+
 //==============================================================================
 AudioThumbnailCache::AudioThumbnailCache (const int maxNumThumbsToStore_)
-    : TimeSliceThread (T("thumb cache")),
-      maxNumThumbsToStore (maxNumThumbsToStore_)
+    : maxNumThumbsToStore (maxNumThumbsToStore_),
+      pool (jlimit (1, 4, SystemStats::getNumCpus()))
 {
-    startThread (2);
+    pool.setThreadPriorities (2);
 }
 
 AudioThumbnailCache::~AudioThumbnailCache()
 {
+    pool.removeAllJobs (true, 10000, false);
+    jobs.clear();
 }
 
 bool AudioThumbnailCache::loadThumb (AudioThumbnail& thumb, const int64 hashCode)
 {
-    for (int i = thumbs.size(); --i >= 0;)
+    MemoryBlock data;
+    bool found = false;
+
     {
-        if (thumbs[i]->hash == hashCode)
+        const ScopedLock sl (lock);
+
+        for (int i = thumbs.size(); --i >= 0;)
         {
-            MemoryInputStream in ((const char*) thumbs[i]->data.getData(),
-                                  thumbs[i]->data.getSize(),
-                                  false);
+            if (thumbs[i]->hash == hashCode)
+            {
+                data = thumbs[i]->data;
+                thumbs[i]->lastUsed = Time::getMillisecondCounter();
+                found = true;
+                break;
+            }
+        }
+    }
 
-            thumb.loadFrom (in);
+    if (! found)
+    {
+        // not in memory, so see if it was saved by an earlier session
+        const File file (getFileForHash (hashCode));
 
-            thumbs[i]->lastUsed = Time::getMillisecondCounter();
-            return true;
-        }
+        if (! (file.existsAsFile() && file.loadFileAsData (data)))
+            return false;
+
+        storeInMemory (hashCode, data);
     }
 
-    return false;
+    // (the thumb is loaded outside the lock, as it'll lock itself)
+    MemoryInputStream in ((const char*) data.getData(), data.getSize(), false);
+    thumb.loadFrom (in);
+
+    return true;
 }
 
 void AudioThumbnailCache::storeThumb (const AudioThumbnail& thumb,
@@ -80,6 +129,19 @@ void AudioThumbnailCache::storeThumb (const AudioThumbnail& thumb,
     MemoryOutputStream out;
     thumb.saveTo (out);
 
+    const MemoryBlock data (out.getData(), out.getDataSize());
+    storeInMemory (hashCode, data);
+
+    const File file (getFileForHash (hashCode));
+
+    if (file != File::nonexistent)
+        file.replaceWithData (data.getData(), data.getSize());
+}
+
+void AudioThumbnailCache::storeInMemory (const int64 hashCode, const MemoryBlock& data)
+{
+    const ScopedLock sl (lock);
+
     ThumbnailCacheEntry* te = 0;
 
     for (int i = thumbs.size(); --i >= 0;)
@@ -103,36 +165,90 @@ void AudioThumbnailCache::storeThumb (const AudioThumbnail& thumb,
         else
         {
             int oldest = 0;
-            unsigned int oldestTime = Time::getMillisecondCounter() + 1;
+            uint32 oldestTime = Time::getMillisecondCounter() + 1;
 
-            int i;
-            for (i = thumbs.size(); --i >= 0;)
+            for (int i = thumbs.size(); --i >= 0;)
+            {
                 if (thumbs[i]->lastUsed < oldestTime)
+                {
                     oldest = i;
+                    oldestTime = thumbs[i]->lastUsed;
+                }
+            }
 
-            thumbs.set (i, te);
+            thumbs.set (oldest, te);
         }
     }
 
     te->lastUsed = Time::getMillisecondCounter();
-    te->data.setSize (0);
-    te->data.append (out.getData(), out.getDataSize());
+    te->data = data;
 }
 
 void AudioThumbnailCache::clear()
 {
+    const ScopedLock sl (lock);
     thumbs.clear();
 }
 
+//==============================================================================
+void AudioThumbnailCache::setCacheDirectory (const File& directory)
+{
+    const ScopedLock sl (lock);
+
+    cacheDirectory = directory;
+
+    if (cacheDirectory != File::nonexistent)
+        cacheDirectory.createDirectory();
+}
+
+const File AudioThumbnailCache::getFileForHash (const int64 hashCode) const
+{
+    const ScopedLock sl (lock);
+
+    if (cacheDirectory == File::nonexistent)
+        return File::nonexistent;
+
+    return cacheDirectory.getChildFile (String::toHexString (hashCode) + T(".thumb"));
+}
+
 //==============================================================================
 void AudioThumbnailCache::addThumbnail (AudioThumbnail* const thumb)
 {
-    addTimeSliceClient (thumb);
+    const ScopedLock sl (lock);
+
+    for (int i = jobs.size(); --i >= 0;)
+        if (&(jobs.getUnchecked(i)->thumb) == thumb)
+            return;
+
+    ThumbnailGenerationJob* const job = new ThumbnailGenerationJob (*thumb);
+    jobs.add (job);
+    pool.addJob (job);
 }
 
 void AudioThumbnailCache::removeThumbnail (AudioThumbnail* const thumb)
 {
-    removeTimeSliceClient (thumb);
+    ThumbnailGenerationJob* job = 0;
+
+    {
+        const ScopedLock sl (lock);
+
+        for (int i = jobs.size(); --i >= 0;)
+        {
+            if (&(jobs.getUnchecked(i)->thumb) == thumb)
+            {
+                job = jobs.getUnchecked(i);
+                jobs.remove (i, false);
+                break;
+            }
+        }
+    }
+
+    if (job != 0)
+    {
+        // this waits for the job to finish its current block if it's running
+        pool.removeJob (job, true, -1);
+        delete job;
+    }
 }
 
 
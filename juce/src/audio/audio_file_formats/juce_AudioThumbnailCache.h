@@ -27,20 +27,23 @@
 #define __JUCE_AUDIOTHUMBNAILCACHE_JUCEHEADER__
 
 #include "juce_AudioThumbnail.h"
+#include "../../threads/juce_ThreadPool.h"
 struct ThumbnailCacheEntry;
+class ThumbnailGenerationJob;
 
 
 //==============================================================================
 /**
     An instance of this class is used to manage multiple AudioThumbnail objects.
 
-    The cache runs a single background thread that is shared by all the thumbnails
-    that need it, and it maintains a set of low-res previews in memory, to avoid
-    having to re-scan audio files too often.
+    The cache runs a small pool of background threads that is shared by all the
+    thumbnails that need it, so that several files can be scanned at once. It
+    maintains a set of low-res previews in memory, and can also keep them in a
+    directory on disk, to avoid having to re-scan audio files too often.
 
     @see AudioThumbnail
 */
-class JUCE_API  AudioThumbnailCache   : public TimeSliceThread
+class JUCE_API  AudioThumbnailCache
 {
 public:
     //==============================================================================
@@ -74,6 +77,25 @@ public:
     */
     void storeThumb (const AudioThumbnail& thumb, const int64 hashCode);
 
+    //==============================================================================
+    /** Sets a directory in which the thumbnails will be saved.
+
+        Once this is set, every thumbnail that gets finished is also written to a
+        file in here, and thumbnails that aren't found in memory are looked for in
+        here before their audio file gets scanned. This means that thumbnails can be
+        shown straight away when the same files are opened in a later session.
+
+        The files are named after the thumbnail's hash code, which for a file source
+        includes its size and modification date, so a thumbnail won't be used for
+        a file that has changed since.
+
+        Pass File::nonexistent to stop using a directory.
+    */
+    void setCacheDirectory (const File& directory);
+
+    /** Returns the directory set with setCacheDirectory(). */
+    const File& getCacheDirectory() const throw()           { return cacheDirectory; }
+
 
     //==============================================================================
     juce_UseDebuggingNewOperator
@@ -82,6 +104,14 @@ private:
     //==============================================================================
     OwnedArray <ThumbnailCacheEntry> thumbs;
     int maxNumThumbsToStore;
+    File cacheDirectory;
+    CriticalSection lock;
+
+    ThreadPool pool;
+    OwnedArray <ThumbnailGenerationJob> jobs;
+
+    const File getFileForHash (const int64 hashCode) const;
+    void storeInMemory (const int64 hashCode, const MemoryBlock& data);
 
     friend class AudioThumbnail;
     void addThumbnail (AudioThumbnail* const thumb);
@@ -0,0 +1,447 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-9 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+
+#include "../../core/juce_StandardHeader.h"
+
+#if JUCE_INTEL && (JUCE_MSVC || defined (__SSE2__))
+ #include <emmintrin.h>
+ #define JUCE_MAPPEDREADER_USE_SSE2 1
+#endif
+
+BEGIN_JUCE_NAMESPACE
+
+#include "juce_MemoryMappedAudioFormatReader.h"
+
+
+//==============================================================================
+MemoryMappedAudioFormatReader::MemoryMappedAudioFormatReader (const File& file,
+                                                              const AudioFormatReader& details,
+                                                              const int64 dataChunkStart,
+                                                              const int64 dataChunkLength,
+                                                              const int bytesPerFrame_,
+                                                              const bool littleEndian_,
+                                                              const bool eightBitIsUnsigned_)
+    : AudioFormatReader (0, details.getFormatName()),
+      map (file),
+      dataStart (0),
+      bytesPerFrame (bytesPerFrame_),
+      littleEndian (littleEndian_),
+      eightBitIsUnsigned (eightBitIsUnsigned_)
+{
+    sampleRate = details.sampleRate;
+    bitsPerSample = details.bitsPerSample;
+    numChannels = details.numChannels;
+    usesFloatingPointData = details.usesFloatingPointData;
+    metadataValues = details.metadataValues;
+
+    const bool knownFormat = usesFloatingPointData ? (bitsPerSample == 32)
+                                                   : (bitsPerSample == 8 || bitsPerSample == 16
+                                                       || bitsPerSample == 24 || bitsPerSample == 32);
+
+    if (map.getData() != 0
+         && knownFormat
+         && numChannels > 0
+         && bytesPerFrame >= (int) (numChannels * bitsPerSample / 8)
+         && dataChunkStart >= 0
+         && dataChunkStart < map.getSize())
+    {
+        // a truncated file just has fewer frames than its header says
+        const int64 bytesAvailable = jmin (dataChunkLength, map.getSize() - dataChunkStart);
+
+        dataStart = ((const char*) map.getData()) + dataChunkStart;
+        lengthInSamples = bytesAvailable / bytesPerFrame;
+    }
+}
+
+MemoryMappedAudioFormatReader::~MemoryMappedAudioFormatReader()
+{
+}
+
+//==============================================================================
+const void* MemoryMappedAudioFormatReader::getSampleFrames (const int64 startSample) const throw()
+{
+    if (dataStart == 0 || startSample < 0 || startSample >= lengthInSamples)
+        return 0;
+
+    return dataStart + startSample * bytesPerFrame;
+}
+
+void MemoryMappedAudioFormatReader::prefetch (const int64 startSample, const int numSamples) const throw()
+{
+    if (dataStart != 0)
+        map.prefetch ((dataStart - (const char*) map.getData()) + startSample * bytesPerFrame,
+                      (int64) numSamples * bytesPerFrame);
+}
+
+//==============================================================================
+static void convertMappedSamplesToInt (const char* src, const int stride, int* dest, int num,
+                                       const int bits, const bool isFloat,
+                                       const bool littleEndian, const bool eightBitIsUnsigned) throw()
+{
+    if (isFloat)
+    {
+        // floats are passed on as they are, like the other readers do
+        if (littleEndian)
+            for (; --num >= 0; src += stride)
+                *dest++ = (int) ByteOrder::littleEndianInt (src);
+        else
+            for (; --num >= 0; src += stride)
+                *dest++ = (int) ByteOrder::bigEndianInt (src);
+    }
+    else if (bits == 16)
+    {
+        if (littleEndian)
+            for (; --num >= 0; src += stride)
+                *dest++ = ((int) (short) ByteOrder::littleEndianShort (src)) << 16;
+        else
+            for (; --num >= 0; src += stride)
+                *dest++ = ((int) (short) ByteOrder::bigEndianShort (src)) << 16;
+    }
+    else if (bits == 24)
+    {
+        if (littleEndian)
+            for (; --num >= 0; src += stride)
+                *dest++ = ByteOrder::littleEndian24Bit (src) << 8;
+        else
+            for (; --num >= 0; src += stride)
+                *dest++ = ByteOrder::bigEndian24Bit (src) << 8;
+    }
+    else if (bits == 32)
+    {
+        if (littleEndian)
+            for (; --num >= 0; src += stride)
+                *dest++ = (int) ByteOrder::littleEndianInt (src);
+        else
+            for (; --num >= 0; src += stride)
+                *dest++ = (int) ByteOrder::bigEndianInt (src);
+    }
+    else if (bits == 8)
+    {
+        if (eightBitIsUnsigned)
+            for (; --num >= 0; src += stride)
+                *dest++ = ((int) *(const uint8*) src - 128) << 24;
+        else
+            for (; --num >= 0; src += stride)
+                *dest++ = ((int) *(const int8*) src) << 24;
+    }
+}
+
+static void convertMappedSamplesToFloat (const char* src, const int stride, float* dest, int num,
+                                         const int bits, const bool isFloat,
+                                         const bool littleEndian, const bool eightBitIsUnsigned) throw()
+{
+#if JUCE_MAPPEDREADER_USE_SSE2
+    // the common cases get converted 4 frames at a time
+    if (littleEndian && ! isFloat && bits == 16 && (stride == 2 || stride == 4))
+    {
+        const __m128 scale = _mm_set1_ps (1.0f / 0x8000);
+        const __m128i zero = _mm_setzero_si128();
+
+        if (stride == 2)
+        {
+            for (; num >= 8; num -= 8, src += 16, dest += 8)
+            {
+                const __m128i s = _mm_loadu_si128 ((const __m128i*) src);
+
+                // move every short in the top half of an int, then shift it back with sign
+                const __m128i lo = _mm_srai_epi32 (_mm_unpacklo_epi16 (zero, s), 16);
+                const __m128i hi = _mm_srai_epi32 (_mm_unpackhi_epi16 (zero, s), 16);
+
+                _mm_storeu_ps (dest, _mm_mul_ps (_mm_cvtepi32_ps (lo), scale));
+                _mm_storeu_ps (dest + 4, _mm_mul_ps (_mm_cvtepi32_ps (hi), scale));
+            }
+        }
+        else
+        {
+            // src points at the channel we want, so it's always the low short of a frame. The
+            // right channel's loads run into the next frame, so leave at least one of those
+            for (; num > 4; num -= 4, src += 16, dest += 4)
+            {
+                const __m128i s = _mm_loadu_si128 ((const __m128i*) src);
+                const __m128i v = _mm_srai_epi32 (_mm_slli_epi32 (s, 16), 16);
+
+                _mm_storeu_ps (dest, _mm_mul_ps (_mm_cvtepi32_ps (v), scale));
+            }
+        }
+    }
+    else if (littleEndian && isFloat && stride == 8)
+    {
+        // stereo floats: take every other one (leaving a frame spare, as above)
+        for (; num > 4; num -= 4, src += 32, dest += 4)
+        {
+            const __m128 a = _mm_loadu_ps ((const float*) src);
+            const __m128 b = _mm_loadu_ps ((const float*) (src + 16));
+
+            _mm_storeu_ps (dest, _mm_shuffle_ps (a, b, _MM_SHUFFLE (2, 0, 2, 0)));
+        }
+    }
+#endif
+
+    if (isFloat)
+    {
+        if (littleEndian && stride == 4 && ! ByteOrder::isBigEndian())
+        {
+            memcpy (dest, src, sizeof (float) * num);
+        }
+        else
+        {
+            for (; --num >= 0; src += stride)
+            {
+                const uint32 v = littleEndian ? ByteOrder::littleEndianInt (src)
+                                              : ByteOrder::bigEndianInt (src);
+
+                // copied rather than cast, reading an int as a float is undefined
+                memcpy (dest++, &v, sizeof (float));
+            }
+        }
+    }
+    else if (bits == 16)
+    {
+        const float scale = 1.0f / 0x8000;
+
+        if (littleEndian)
+            for (; --num >= 0; src += stride)
+                *dest++ = scale * (short) ByteOrder::littleEndianShort (src);
+        else
+            for (; --num >= 0; src += stride)
+                *dest++ = scale * (short) ByteOrder::bigEndianShort (src);
+    }
+    else if (bits == 24)
+    {
+        const float scale = 1.0f / 0x800000;
+
+        if (littleEndian)
+            for (; --num >= 0; src += stride)
+                *dest++ = scale * ByteOrder::littleEndian24Bit (src);
+        else
+            for (; --num >= 0; src += stride)
+                *dest++ = scale * ByteOrder::bigEndian24Bit (src);
+    }
+    else if (bits == 32)
+    {
+        const double scale = 1.0 / 0x80000000;
+
+        if (littleEndian)
+            for (; --num >= 0; src += stride)
+                *dest++ = (float) (scale * (int) ByteOrder::littleEndianInt (src));
+        else
+            for (; --num >= 0; src += stride)
+                *dest++ = (float) (scale * (int) ByteOrder::bigEndianInt (src));
+    }
+    else if (bits == 8)
+    {
+        const float scale = 1.0f / 0x80;
+
+        if (eightBitIsUnsigned)
+            for (; --num >= 0; src += stride)
+                *dest++ = scale * ((int) *(const uint8*) src - 128);
+        else
+            for (; --num >= 0; src += stride)
+                *dest++ = scale * *(const int8*) src;
+    }
+}
+
+//==============================================================================
+bool MemoryMappedAudioFormatReader::readSamples (int** destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                                                 int64 startSampleInFile, int numSamples)
+{
+    const int64 samplesAvailable = lengthInSamples - startSampleInFile;
+
+    if (samplesAvailable < numSamples)
+    {
+        for (int i = numDestChannels; --i >= 0;)
+            if (destSamples[i] != 0)
+                zeromem (destSamples[i] + startOffsetInDestBuffer, sizeof (int) * numSamples);
+
+        numSamples = (int) samplesAvailable;
+    }
+
+    if (numSamples <= 0)
+        return true;
+
+    const char* const frames = dataStart + startSampleInFile * bytesPerFrame;
+    const int bytesPerSample = bitsPerSample / 8;
+
+    for (int i = jmin ((int) numChannels, numDestChannels); --i >= 0;)
+    {
+        if (destSamples[i] == 0)
+            continue;
+
+        convertMappedSamplesToInt (frames + i * bytesPerSample, bytesPerFrame,
+                                   destSamples[i] + startOffsetInDestBuffer, numSamples,
+                                   bitsPerSample, usesFloatingPointData, littleEndian, eightBitIsUnsigned);
+    }
+
+    return true;
+}
+
+void MemoryMappedAudioFormatReader::readFloatSamples (float** destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                                                      int64 startSampleInFile, int numSamples) const throw()
+{
+    const int64 samplesAvailable = lengthInSamples - startSampleInFile;
+
+    if (samplesAvailable < numSamples)
+    {
+        for (int i = numDestChannels; --i >= 0;)
+            if (destSamples[i] != 0)
+                zeromem (destSamples[i] + startOffsetInDestBuffer, sizeof (float) * numSamples);
+
+        numSamples = (int) samplesAvailable;
+    }
+
+    if (numSamples <= 0 || dataStart == 0)
+        return;
+
+    const char* const frames = dataStart + startSampleInFile * bytesPerFrame;
+    const int bytesPerSample = bitsPerSample / 8;
+
+    for (int i = jmin ((int) numChannels, numDestChannels); --i >= 0;)
+    {
+        if (destSamples[i] != 0)
+            convertMappedSamplesToFloat (frames + i * bytesPerSample, bytesPerFrame,
+                                         destSamples[i] + startOffsetInDestBuffer, numSamples,
+                                         bitsPerSample, usesFloatingPointData, littleEndian, eightBitIsUnsigned);
+    }
+}
+
+bool MemoryMappedAudioFormatReader::readFloat (float** destSamples,
+                                               int numDestChannels,
+                                               int64 startSampleInSource,
+                                               int numSamplesToRead,
+                                               const bool fillLeftoverChannelsWithCopies)
+{
+    jassert (numDestChannels > 0); // you have to actually give this some channels to work with!
+
+    int startOffsetInDestBuffer = 0;
+
+    if (startSampleInSource < 0)
+    {
+        const int silence = (int) jmin (-startSampleInSource, (int64) numSamplesToRead);
+
+        for (int i = numDestChannels; --i >= 0;)
+            if (destSamples[i] != 0)
+                zeromem (destSamples[i], sizeof (float) * silence);
+
+        startOffsetInDestBuffer += silence;
+        numSamplesToRead -= silence;
+        startSampleInSource = 0;
+    }
+
+    if (numSamplesToRead <= 0)
+        return true;
+
+    readFloatSamples (destSamples, numDestChannels, startOffsetInDestBuffer,
+                      startSampleInSource, numSamplesToRead);
+
+    if (numDestChannels > (int) numChannels)
+    {
+        const int numToFill = startOffsetInDestBuffer + numSamplesToRead;
+        const float* lastFullChannel = 0;
+
+        if (fillLeftoverChannelsWithCopies)
+        {
+            for (int i = numChannels; --i >= 0;)
+            {
+                if (destSamples[i] != 0)
+                {
+                    lastFullChannel = destSamples[i];
+                    break;
+                }
+            }
+        }
+
+        for (int i = numChannels; i < numDestChannels; ++i)
+        {
+            if (destSamples[i] != 0)
+            {
+                if (lastFullChannel != 0)
+                    memcpy (destSamples[i], lastFullChannel, sizeof (float) * numToFill);
+                else
+                    zeromem (destSamples[i], sizeof (float) * numToFill);
+            }
+        }
+    }
+
+    return true;
+}
+
+//==============================================================================
+float MemoryMappedAudioFormatReader::getSampleAsFloat (const char* frame, const int channel) const throw()
+{
+    float value;
+    convertMappedSamplesToFloat (frame + channel * (bitsPerSample / 8), bytesPerFrame, &value, 1,
+                                 bitsPerSample, usesFloatingPointData, littleEndian, eightBitIsUnsigned);
+    return value;
+}
+
+void MemoryMappedAudioFormatReader::readMaxLevels (int64 startSampleInFile, int64 numSamples,
+                                                   float& lowestLeft, float& highestLeft,
+                                                   float& lowestRight, float& highestRight)
+{
+    if (startSampleInFile < 0)
+    {
+        numSamples += startSampleInFile;
+        startSampleInFile = 0;
+    }
+
+    numSamples = jmin (numSamples, lengthInSamples - startSampleInFile);
+
+    if (numSamples <= 0 || dataStart == 0)
+    {
+        lowestLeft = 0;
+        lowestRight = 0;
+        highestLeft = 0;
+        highestRight = 0;
+        return;
+    }
+
+    // scan the mapped data in place, no need to convert it all first
+    const char* frame = dataStart + startSampleInFile * bytesPerFrame;
+    const int rightChannel = numChannels > 1 ? 1 : 0;
+
+    float lmin = getSampleAsFloat (frame, 0);
+    float rmin = getSampleAsFloat (frame, rightChannel);
+    float lmax = lmin, rmax = rmin;
+
+    for (int64 i = numSamples; --i >= 0; frame += bytesPerFrame)
+    {
+        const float l = getSampleAsFloat (frame, 0);
+        const float r = getSampleAsFloat (frame, rightChannel);
+
+        if (l < lmin)  lmin = l;
+        if (l > lmax)  lmax = l;
+        if (r < rmin)  rmin = r;
+        if (r > rmax)  rmax = r;
+    }
+
+    lowestLeft = lmin;
+    highestLeft = lmax;
+    lowestRight = rmin;
+    highestRight = rmax;
+}
+
+
+END_JUCE_NAMESPACE
@@ -0,0 +1,146 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-9 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+
+#ifndef __JUCE_MEMORYMAPPEDAUDIOFORMATREADER_JUCEHEADER__
+#define __JUCE_MEMORYMAPPEDAUDIOFORMATREADER_JUCEHEADER__
+
+#include "juce_AudioFormatReader.h"
+#include "../../io/files/juce_MemoryMappedFile.h"
+
+
+//==============================================================================
+/**
+    Reads uncompressed sample frames straight out of a memory-mapped file.
+
+    Formats that store plain pcm or float frames (e.g. WAV and AIFF) can create
+    one of these with AudioFormat::createMemoryMappedReader(). There are no
+    stream seeks or temporary buffers involved: the frames can be accessed in
+    place with getSampleFrames(), or decoded straight to floats with readFloat().
+
+    If the file couldn't be mapped, isMapped() returns false and the reader
+    will only return silence, so the format will normally return 0 instead of
+    one of these.
+
+    @see AudioFormat::createMemoryMappedReader, MemoryMappedFile
+*/
+class JUCE_API  MemoryMappedAudioFormatReader  : public AudioFormatReader
+{
+public:
+    //==============================================================================
+    /** Creates a reader for the frames of a file.
+
+        @param file                 the file to map
+        @param details              a reader that has parsed the file header, which will
+                                    be used to set the sample rate, bit depth, channels and
+                                    metadata of this one. It's not kept by this object.
+        @param dataChunkStart       the byte offset of the first sample frame in the file
+        @param dataChunkLength      the number of bytes of sample frames
+        @param bytesPerFrame        the size of a frame, including all the channels
+        @param littleEndian         the byte order of the samples in the file
+        @param eightBitIsUnsigned   true if 8-bit samples are stored with an offset of 128
+    */
+    MemoryMappedAudioFormatReader (const File& file,
+                                   const AudioFormatReader& details,
+                                   const int64 dataChunkStart,
+                                   const int64 dataChunkLength,
+                                   const int bytesPerFrame,
+                                   const bool littleEndian,
+                                   const bool eightBitIsUnsigned);
+
+    /** Destructor. */
+    ~MemoryMappedAudioFormatReader();
+
+    //==============================================================================
+    /** Returns true if the file was mapped successfully. */
+    bool isMapped() const throw()                       { return dataStart != 0; }
+
+    /** Returns the file being read. */
+    const File& getFile() const throw()                 { return map.getFile(); }
+
+    /** Returns the number of bytes taken by a frame of samples. */
+    int getBytesPerFrame() const throw()                { return bytesPerFrame; }
+
+    /** Returns true if the samples are stored as little-endian. */
+    bool isLittleEndian() const throw()                 { return littleEndian; }
+
+    /** Returns a pointer to the interleaved frames in the file, starting at a sample.
+
+        The data is in the file's own format (see bitsPerSample, usesFloatingPointData,
+        isLittleEndian), and there are (lengthInSamples - startSample) frames available.
+        Returns 0 if the sample is out of range.
+    */
+    const void* getSampleFrames (const int64 startSample) const throw();
+
+    //==============================================================================
+    /** Reads samples as floats, in the range -1.0 to 1.0.
+
+        This works like AudioFormatReader::read(), but the samples are converted
+        straight from the file data to floats, without going through the fixed-point
+        format first.
+
+        @see AudioFormatReader::read
+    */
+    bool readFloat (float** destSamples,
+                    int numDestChannels,
+                    int64 startSampleInSource,
+                    int numSamplesToRead,
+                    const bool fillLeftoverChannelsWithCopies);
+
+    /** Tells the system that a range of samples is going to be read soon.
+
+        This won't block, so it can be called every time a block is played to get
+        the following one paged in before it's needed.
+    */
+    void prefetch (const int64 startSample, const int numSamples) const throw();
+
+    //==============================================================================
+    /** @internal */
+    bool readSamples (int** destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                      int64 startSampleInFile, int numSamples);
+    /** @internal */
+    void readMaxLevels (int64 startSample, int64 numSamples,
+                        float& lowestLeft, float& highestLeft,
+                        float& lowestRight, float& highestRight);
+
+    //==============================================================================
+    juce_UseDebuggingNewOperator
+
+private:
+    MemoryMappedFile map;
+    const char* dataStart;
+    int bytesPerFrame;
+    bool littleEndian, eightBitIsUnsigned;
+
+    void readFloatSamples (float** destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                           int64 startSampleInFile, int numSamples) const throw();
+    float getSampleAsFloat (const char* frame, const int channel) const throw();
+
+    MemoryMappedAudioFormatReader (const MemoryMappedAudioFormatReader&);
+    const MemoryMappedAudioFormatReader& operator= (const MemoryMappedAudioFormatReader&);
+};
+
+
+#endif   // __JUCE_MEMORYMAPPEDAUDIOFORMATREADER_JUCEHEADER__
@@ -211,6 +211,9 @@ class WavAudioFormatReader  : public AudioFormatReader
     int bytesPerFrame;
     int64 dataChunkStart, dataLength;
 
+    // maps the data chunk this has found
+    friend class WavAudioFormat;
+
     static inline int chunkName (const char* const name)   { return (int) ByteOrder::littleEndianInt (name); }
 
     WavAudioFormatReader (const WavAudioFormatReader&);
@@ -772,6 +775,29 @@ AudioFormatReader* WavAudioFormat::createReaderFor (InputStream* sourceStream,
     return 0;
 }
 
+MemoryMappedAudioFormatReader* WavAudioFormat::createMemoryMappedReader (const File& file)
+{
+    FileInputStream* const in = file.createInputStream();
+
+    if (in == 0)
+        return 0;
+
+    ScopedPointer <WavAudioFormatReader> header ((WavAudioFormatReader*) createReaderFor (in, true));
+
+    if (header == 0 || header->dataLength <= 0 || header->bytesPerFrame <= 0)
+        return 0;
+
+    ScopedPointer <MemoryMappedAudioFormatReader> r (new MemoryMappedAudioFormatReader (file, *header,
+                                                                                      header->dataChunkStart,
+                                                                                      header->dataLength,
+                                                                                      header->bytesPerFrame,
+                                                                                      true, true));
+    if (r->isMapped())
+        return r.release();
+
+    return 0;
+}
+
 AudioFormatWriter* WavAudioFormat::createWriterFor (OutputStream* out,
                                                     double sampleRate,
                                                     unsigned int numChannels,
@@ -128,6 +128,8 @@ public:
     AudioFormatReader* createReaderFor (InputStream* sourceStream,
                                         const bool deleteStreamIfOpeningFails);
 
+    MemoryMappedAudioFormatReader* createMemoryMappedReader (const File& file);
+
     AudioFormatWriter* createWriterFor (OutputStream* streamToWriteTo,
                                         double sampleRateToUse,
                                         unsigned int numberOfChannels,
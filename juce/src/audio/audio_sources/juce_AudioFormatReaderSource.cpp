@@ -35,6 +35,7 @@ BEGIN_JUCE_NAMESPACE
 AudioFormatReaderSource::AudioFormatReaderSource (AudioFormatReader* const reader_,
                                                   const bool deleteReaderWhenThisIsDeleted)
     : reader (reader_),
+      mappedReader (dynamic_cast <MemoryMappedAudioFormatReader*> (reader_)),
       deleteReader (deleteReaderWhenThisIsDeleted),
       nextPlayPos (0),
       looping (false)
@@ -128,6 +129,10 @@ void AudioFormatReaderSource::getNextAudioBlock (const AudioSourceChannelInfo& i
 
             nextPlayPos += info.numSamples;
         }
+
+        // get the next block paged in while this one is being played
+        if (mappedReader != 0 && mappedReader->lengthInSamples > 0)
+            mappedReader->prefetch (nextPlayPos % mappedReader->lengthInSamples, info.numSamples);
     }
 }
 
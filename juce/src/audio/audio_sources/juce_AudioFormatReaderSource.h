@@ -28,7 +28,7 @@
 
 #include "juce_PositionableAudioSource.h"
 #include "../../threads/juce_Thread.h"
-#include "../audio_file_formats/juce_AudioFormatReader.h"
+#include "../audio_file_formats/juce_MemoryMappedAudioFormatReader.h"
 #include "../dsp/juce_AudioSampleBuffer.h"
 
 
@@ -97,6 +97,7 @@ public:
 
 private:
     AudioFormatReader* reader;
+    MemoryMappedAudioFormatReader* mappedReader;
     bool deleteReader;
 
     int volatile nextPlayPos;
@@ -31,28 +31,57 @@ BEGIN_JUCE_NAMESPACE
 #include "../../threads/juce_ScopedLock.h"
 #include "../../core/juce_Singleton.h"
 #include "../../containers/juce_VoidArray.h"
+#include "../../containers/juce_OwnedArray.h"
+#include "../../threads/juce_WaitableEvent.h"
+#include "../../threads/juce_RealtimePolicy.h"
+#include "../../core/juce_SystemStats.h"
 #include "../../utilities/juce_DeletedAtShutdown.h"
 #include "../../events/juce_Timer.h"
 
 
 //==============================================================================
-class SharedBufferingAudioSourceThread  : public DeletedAtShutdown,
-                                          public Thread,
-                                          private Timer
+/*  The read threads that all the BufferingAudioSources share.
+
+    Rather than going round the sources in turn, each thread picks the one that
+    will run out of data soonest, so a source that's about to underrun never has
+    to wait behind ones that have plenty left. A source is only read by one thread
+    at a time, which is what its readLock is for.
+*/
+class BufferingAudioSourceScheduler  : public DeletedAtShutdown,
+                                       private Timer
 {
 public:
-    SharedBufferingAudioSourceThread()
-        : Thread ("Audio Buffer")
+    BufferingAudioSourceScheduler()
     {
     }
 
-    ~SharedBufferingAudioSourceThread()
+    ~BufferingAudioSourceScheduler()
     {
-        stopThread (10000);
+        stopThreads();
         clearSingletonInstance();
     }
 
-    juce_DeclareSingleton (SharedBufferingAudioSourceThread, false)
+    juce_DeclareSingleton (BufferingAudioSourceScheduler, false)
+
+    /* Registers with the shared instance, creating it if needed.
+
+       The singleton lock is held so the timer can't delete the instance
+       between it being returned and the source being added.
+    */
+    static void addSourceToInstance (BufferingAudioSource* source)
+    {
+        const ScopedLock sl (_singletonLock);
+        getInstance()->addSource (source);
+    }
+
+    /* Unregisters from the shared instance, if there's still one */
+    static void removeSourceFromInstance (BufferingAudioSource* source)
+    {
+        const ScopedLock sl (_singletonLock);
+
+        if (_singletonInstance != 0)
+            _singletonInstance->removeSource (source);
+    }
 
     void addSource (BufferingAudioSource* source)
     {
@@ -61,7 +90,7 @@ public:
         if (! sources.contains ((void*) source))
         {
             sources.add ((void*) source);
-            startThread();
+            startThreads();
 
             stopTimer();
         }
@@ -71,54 +100,165 @@ public:
 
     void removeSource (BufferingAudioSource* source)
     {
-        const ScopedLock sl (lock);
-        sources.removeValue ((void*) source);
+        {
+            const ScopedLock sl (lock);
+            sources.removeValue ((void*) source);
+
+            if (sources.size() == 0)
+                startTimer (5000);
+        }
+
+        // if a thread is still reading from it, wait until that's finished
+        const ScopedLock rl (source->readLock);
+    }
 
-        if (sources.size() == 0)
-            startTimer (5000);
+    void notify() const throw()
+    {
+        workAvailable.signal();
     }
 
 private:
+    //==============================================================================
+    class ReadThread  : public Thread
+    {
+    public:
+        ReadThread (BufferingAudioSourceScheduler& owner_)
+            : Thread ("Audio Buffer"),
+              owner (owner_)
+        {
+        }
+
+        void run()
+        {
+            RealtimePolicy::applyToCurrentThread (RealtimePolicy::diskThread);
+
+            while (! threadShouldExit())
+            {
+                if (! owner.readMostUrgentSource())
+                    owner.workAvailable.wait (500);
+            }
+        }
+
+    private:
+        BufferingAudioSourceScheduler& owner;
+
+        ReadThread (const ReadThread&);
+        const ReadThread& operator= (const ReadThread&);
+    };
+
     VoidArray sources;
+    OwnedArray <ReadThread> threads;
     CriticalSection lock;
+    WaitableEvent workAvailable;
 
-    void run()
+    void startThreads()
     {
-        while (! threadShouldExit())
+        if (threads.size() == 0)
         {
-            bool busy = false;
+            // disk reads don't need many threads, just enough to keep one slow
+            // file from holding up the others
+            const int numThreads = jlimit (1, 3, SystemStats::getNumCpus() - 1);
 
-            for (int i = sources.size(); --i >= 0;)
+            for (int i = 0; i < numThreads; ++i)
             {
-                if (threadShouldExit())
-                    return;
+                ReadThread* const t = new ReadThread (*this);
+                threads.add (t);
+                t->startThread();
+            }
+        }
+    }
+
+    void stopThreads()
+    {
+        for (int i = threads.size(); --i >= 0;)
+            threads.getUnchecked(i)->signalThreadShouldExit();
 
-                const ScopedLock sl (lock);
+        for (int i = threads.size(); --i >= 0;)
+        {
+            // the event only wakes one of them at a time
+            workAvailable.signal();
+            threads.getUnchecked(i)->stopThread (10000);
+        }
 
-                BufferingAudioSource* const b = (BufferingAudioSource*) sources[i];
+        threads.clear();
+    }
 
-                if (b != 0 && b->readNextBufferChunk())
-                    busy = true;
-            }
+    bool readMostUrgentSource()
+    {
+        BufferingAudioSource* mostUrgent = 0;
+        bool moreWork = false;
 
-            if (! busy)
-                wait (500);
+        {
+            const ScopedLock sl (lock);
+
+            double soonestUnderrun = 0;
+
+            for (int i = sources.size(); --i >= 0;)
+            {
+                BufferingAudioSource* const b = (BufferingAudioSource*) sources.getUnchecked (i);
+                const double secondsLeft = b->getSecondsUntilUnderrun();
+
+                if (secondsLeft >= 0)
+                {
+                    if (mostUrgent == 0 || secondsLeft < soonestUnderrun)
+                    {
+                        if (b->readLock.tryEnter())
+                        {
+                            if (mostUrgent != 0)
+                            {
+                                mostUrgent->readLock.exit();
+                                moreWork = true;
+                            }
+
+                            mostUrgent = b;
+                            soonestUnderrun = secondsLeft;
+                        }
+                    }
+                    else
+                    {
+                        moreWork = true;
+                    }
+                }
+            }
         }
+
+        if (mostUrgent == 0)
+            return false;
+
+        // get another thread going on the next source while this one's busy
+        if (moreWork)
+            notify();
+
+        const bool didRead = mostUrgent->readNextBufferChunk();
+        mostUrgent->readLock.exit();
+
+        return didRead;
     }
 
     void timerCallback()
     {
         stopTimer();
 
-        if (sources.size() == 0)
+        // nobody can register while the singleton lock is held, so nothing
+        // can be added between checking the sources and deleting ourselves
+        const ScopedLock sl (_singletonLock);
+
+        bool isUnused;
+
+        {
+            const ScopedLock sl2 (lock);
+            isUnused = (sources.size() == 0);
+        }
+
+        if (isUnused)
             deleteInstance();
     }
 
-    SharedBufferingAudioSourceThread (const SharedBufferingAudioSourceThread&);
-    const SharedBufferingAudioSourceThread& operator= (const SharedBufferingAudioSourceThread&);
+    BufferingAudioSourceScheduler (const BufferingAudioSourceScheduler&);
+    const BufferingAudioSourceScheduler& operator= (const BufferingAudioSourceScheduler&);
 };
 
-juce_ImplementSingleton (SharedBufferingAudioSourceThread)
+juce_ImplementSingleton (BufferingAudioSourceScheduler)
 
 //==============================================================================
 BufferingAudioSource::BufferingAudioSource (PositionableAudioSource* source_,
@@ -131,6 +271,7 @@ BufferingAudioSource::BufferingAudioSource (PositionableAudioSource* source_,
       bufferValidStart (0),
       bufferValidEnd (0),
       nextPlayPos (0),
+      numUnderruns (0),
       wasSourceLooping (false)
 {
     jassert (source_ != 0);
@@ -141,10 +282,7 @@ BufferingAudioSource::BufferingAudioSource (PositionableAudioSource* source_,
 
 BufferingAudioSource::~BufferingAudioSource()
 {
-    SharedBufferingAudioSourceThread* const thread = SharedBufferingAudioSourceThread::getInstanceWithoutCreating();
-
-    if (thread != 0)
-        thread->removeSource (this);
+    BufferingAudioSourceScheduler::removeSourceFromInstance (this);
 
     if (deleteSourceWhenDeleted)
         delete source;
@@ -163,22 +301,19 @@ void BufferingAudioSource::prepareToPlay (int samplesPerBlockExpected, double sa
     bufferValidStart = 0;
     bufferValidEnd = 0;
 
-    SharedBufferingAudioSourceThread::getInstance()->addSource (this);
+    BufferingAudioSourceScheduler::addSourceToInstance (this);
 
     while (bufferValidEnd - bufferValidStart < jmin (((int) sampleRate_) / 4,
                                                      buffer.getNumSamples() / 2))
     {
-        SharedBufferingAudioSourceThread::getInstance()->notify();
+        BufferingAudioSourceScheduler::getInstance()->notify();
         Thread::sleep (5);
     }
 }
 
 void BufferingAudioSource::releaseResources()
 {
-    SharedBufferingAudioSourceThread* const thread = SharedBufferingAudioSourceThread::getInstanceWithoutCreating();
-
-    if (thread != 0)
-        thread->removeSource (this);
+    BufferingAudioSourceScheduler::removeSourceFromInstance (this);
 
     buffer.setSize (2, 0);
     source->releaseResources();
@@ -191,6 +326,9 @@ void BufferingAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& info
     const int validStart = jlimit (bufferValidStart, bufferValidEnd, nextPlayPos) - nextPlayPos;
     const int validEnd   = jlimit (bufferValidStart, bufferValidEnd, nextPlayPos + info.numSamples) - nextPlayPos;
 
+    if (validStart > 0 || validEnd < info.numSamples)
+        ++numUnderruns;
+
     if (validStart == validEnd)
     {
         // total cache miss
@@ -242,10 +380,14 @@ void BufferingAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& info
             nextPlayPos %= source->getTotalLength();
     }
 
-    SharedBufferingAudioSourceThread* const thread = SharedBufferingAudioSourceThread::getInstanceWithoutCreating();
+    // only wake the read threads once there's a decent amount of space to fill
+    if (bufferValidEnd - nextPlayPos < buffer.getNumSamples() / 2)
+    {
+        BufferingAudioSourceScheduler* const scheduler = BufferingAudioSourceScheduler::getInstanceWithoutCreating();
 
-    if (thread != 0)
-        thread->notify();
+        if (scheduler != 0)
+            scheduler->notify();
+    }
 }
 
 int BufferingAudioSource::getNextReadPosition() const
@@ -261,10 +403,10 @@ void BufferingAudioSource::setNextReadPosition (int newPosition)
 
     nextPlayPos = newPosition;
 
-    SharedBufferingAudioSourceThread* const thread = SharedBufferingAudioSourceThread::getInstanceWithoutCreating();
+    BufferingAudioSourceScheduler* const scheduler = BufferingAudioSourceScheduler::getInstanceWithoutCreating();
 
-    if (thread != 0)
-        thread->notify();
+    if (scheduler != 0)
+        scheduler->notify();
 }
 
 bool BufferingAudioSource::readNextBufferChunk()
@@ -283,11 +425,14 @@ bool BufferingAudioSource::readNextBufferChunk()
     int sectionToReadStart = 0;
     int sectionToReadEnd = 0;
 
-    const int maxChunkSize = 2048;
+    // after a cache miss, read a small chunk to get playing again quickly, but
+    // top up the buffer in big sequential reads once it's going
+    const int minChunkSize = 2048;
+    const int maxChunkSize = jmax (minChunkSize, buffer.getNumSamples() / 4);
 
     if (newBVS < bufferValidStart || newBVS >= bufferValidEnd)
     {
-        newBVE = jmin (newBVE, newBVS + maxChunkSize);
+        newBVE = jmin (newBVE, newBVS + minChunkSize);
 
         sectionToReadStart = newBVS;
         sectionToReadEnd = newBVE;
@@ -346,6 +491,45 @@ bool BufferingAudioSource::readNextBufferChunk()
     }
 }
 
+int BufferingAudioSource::getNumSamplesBufferedAhead() const throw()
+{
+    const int playPos = jmax (0, nextPlayPos);
+
+    if (playPos < bufferValidStart || playPos >= bufferValidEnd)
+        return 0;
+
+    return bufferValidEnd - playPos;
+}
+
+float BufferingAudioSource::getBufferFillLevel() const throw()
+{
+    const int bufferSize = buffer.getNumSamples();
+
+    return bufferSize > 0 ? jlimit (0.0f, 1.0f, getNumSamplesBufferedAhead() / (float) bufferSize)
+                          : 0.0f;
+}
+
+double BufferingAudioSource::getSecondsUntilUnderrun() const throw()
+{
+    // this mirrors the checks in readNextBufferChunk(), and returns -1 if there's
+    // nothing that needs reading
+    if (buffer.getNumSamples() <= 0 || sampleRate <= 0)
+        return -1.0;
+
+    const int playPos = jmax (0, nextPlayPos);
+
+    if (wasSourceLooping != isLooping()
+         || playPos < bufferValidStart || playPos >= bufferValidEnd)
+        return 0.0;
+
+    const int wantedEnd = playPos + buffer.getNumSamples() - 4;
+
+    if (abs (playPos - bufferValidStart) > 512 || abs (wantedEnd - bufferValidEnd) > 512)
+        return (bufferValidEnd - playPos) / sampleRate;
+
+    return -1.0;
+}
+
 void BufferingAudioSource::readBufferSection (int start, int length, int bufferOffset)
 {
     if (source->getNextReadPosition() != start)
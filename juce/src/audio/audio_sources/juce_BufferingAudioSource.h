@@ -39,6 +39,9 @@
     a background thread to smooth out playback. You can either create one of these
     directly, or use it indirectly using an AudioTransportSource.
 
+    All the buffering sources share a small pool of read threads, which always
+    refill the source that's closest to running out of data first.
+
     @see PositionableAudioSource, AudioTransportSource
 */
 class JUCE_API  BufferingAudioSource  : public PositionableAudioSource
@@ -86,6 +89,25 @@ public:
     /** Implements the PositionableAudioSource method. */
     bool isLooping() const                      { return source->isLooping(); }
 
+    //==============================================================================
+    /** Returns the number of samples that are ready to be played from the
+        current position onwards.
+    */
+    int getNumSamplesBufferedAhead() const throw();
+
+    /** Returns how full the read-ahead buffer is, from 0 to 1. */
+    float getBufferFillLevel() const throw();
+
+    /** Returns the number of blocks that couldn't be played (or only partly) since
+        the buffer hadn't been filled in time.
+
+        @see resetUnderrunCount
+    */
+    int getNumUnderruns() const throw()         { return numUnderruns; }
+
+    /** Resets the counter returned by getNumUnderruns(). */
+    void resetUnderrunCount() throw()           { numUnderruns = 0; }
+
     //==============================================================================
     juce_UseDebuggingNewOperator
 
@@ -97,10 +119,13 @@ private:
     AudioSampleBuffer buffer;
     CriticalSection bufferStartPosLock;
     int volatile bufferValidStart, bufferValidEnd, nextPlayPos;
+    int volatile numUnderruns;
     bool wasSourceLooping;
     double volatile sampleRate;
+    CriticalSection readLock;
 
-    friend class SharedBufferingAudioSourceThread;
+    friend class BufferingAudioSourceScheduler;
+    double getSecondsUntilUnderrun() const throw();
     bool readNextBufferChunk();
     void readBufferSection (int start, int length, int bufferOffset);
 
@@ -147,6 +147,50 @@ public:
     */
     virtual void stopBackgroundThread() throw();
 
+#if JUCE_LINUX || DOXYGEN
+    //==============================================================================
+    /** Starts sending the messages given to scheduleBlockOfMessages() (Linux only).
+
+        The messages are played by an ALSA sequencer queue, so they go out at the
+        time of their sample position instead of when a thread gets round to it.
+
+        @param latencySeconds   how far behind the audio callback the messages are
+                                played. It has to cover the length of a block plus
+                                the time the sender thread takes to wake up, and
+                                matching it to the audio output latency keeps the
+                                midi in time with what is heard.
+        @returns false if the sequencer queue couldn't be set up
+        @see scheduleBlockOfMessages, stopScheduledOutput
+    */
+    bool startScheduledOutput (const double latencySeconds);
+
+    /** Stops the scheduled output, dropping the messages that haven't been played. */
+    void stopScheduledOutput();
+
+    /** Schedules a block of messages at the times of their sample positions (Linux only).
+
+        This is meant to be called from the audio callback: the messages are copied
+        into a lock-free queue, without allocating, locking or calling into the
+        driver, and a background thread timestamps them and hands them to the
+        sequencer.
+
+        The times follow the audio clock: the block's sample position is tracked
+        against the time the callbacks happen, and the event times are worked out
+        from the sample positions, so they don't pick up the callbacks' jitter.
+
+        @param buffer               the messages, with their positions relative to the block
+        @param blockStartSample     the position of the block's first sample since the
+                                    output was started; it should go up by the block size
+                                    each call, a jump re-aligns the clock
+        @param sampleRate           the sample rate of the positions
+        @returns false if some messages didn't fit in the queue and were dropped
+        @see startScheduledOutput
+    */
+    bool scheduleBlockOfMessages (const MidiBuffer& buffer,
+                                  const int64 blockStartSample,
+                                  const double sampleRate) throw();
+#endif
+
 
     //==============================================================================
     juce_UseDebuggingNewOperator
@@ -29,6 +29,7 @@ BEGIN_JUCE_NAMESPACE
 
 #include "juce_AudioSampleBuffer.h"
 #include "../audio_file_formats/juce_AudioFormatReader.h"
+#include "../audio_file_formats/juce_MemoryMappedAudioFormatReader.h"
 #include "../audio_file_formats/juce_AudioFormatWriter.h"
 
 
@@ -601,20 +602,32 @@ void AudioSampleBuffer::readFromAudioReader (AudioFormatReader* reader,
 
         chans[2] = 0;
 
-        reader->read (chans, 2, readerStartSample, numSamples, true);
+        MemoryMappedAudioFormatReader* const mappedReader = dynamic_cast <MemoryMappedAudioFormatReader*> (reader);
 
-        if (! reader->usesFloatingPointData)
+        if (mappedReader != 0)
         {
-            for (int j = 0; j < 2; ++j)
-            {
-                float* const d = (float*) (chans[j]);
+            // this one can decode straight to floats
+            float* floatChans[3] = { (float*) chans[0], (float*) chans[1], 0 };
+
+            mappedReader->readFloat (floatChans, 2, readerStartSample, numSamples, true);
+        }
+        else
+        {
+            reader->read (chans, 2, readerStartSample, numSamples, true);
 
-                if (d != 0)
+            if (! reader->usesFloatingPointData)
+            {
+                for (int j = 0; j < 2; ++j)
                 {
-                    const float multiplier = 1.0f / 0x7fffffff;
+                    float* const d = (float*) (chans[j]);
 
-                    for (int i = 0; i < numSamples; ++i)
-                        d[i] = *(int*)(d + i) * multiplier;
+                    if (d != 0)
+                    {
+                        const float multiplier = 1.0f / 0x7fffffff;
+
+                        for (int i = 0; i < numSamples; ++i)
+                            d[i] = *(int*)(d + i) * multiplier;
+                    }
                 }
             }
         }
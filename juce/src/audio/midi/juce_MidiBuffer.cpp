@@ -91,6 +91,11 @@ void MidiBuffer::clear (const int startSample,
     }
 }
 
+void MidiBuffer::ensureSize (const int minimumNumBytes)
+{
+    data.ensureSize (jmax (0, minimumNumBytes));
+}
+
 void MidiBuffer::addEvent (const MidiMessage& m,
                            const int sampleNumber) throw()
 {
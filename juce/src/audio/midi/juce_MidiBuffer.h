@@ -70,6 +70,13 @@ public:
     void clear (const int start,
                 const int numSamples) throw();
 
+    /** Preallocates some memory for the buffer to use.
+
+        Adding events never shrinks the buffer, so reserving enough space up front
+        means that it won't need to allocate when it's filled on the audio thread.
+    */
+    void ensureSize (const int minimumNumBytes);
+
     /** Returns true if the buffer is empty.
 
         To actually retrieve the events, use a MidiBuffer::Iterator object
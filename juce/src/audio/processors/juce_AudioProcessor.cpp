@@ -29,7 +29,9 @@ BEGIN_JUCE_NAMESPACE
 
 #include "juce_AudioProcessor.h"
 #include "../../threads/juce_ScopedLock.h"
-#include "../../text/juce_XmlDocument.h"
+#include "../../text/juce_XmlPullParser.h"
+#include "../../text/juce_XmlStreamWriter.h"
+#include "../../io/streams/juce_MemoryOutputStream.h"
 
 
 //==============================================================================
@@ -249,16 +251,23 @@ const uint32 magicXmlNumber = 0x21324356;
 void AudioProcessor::copyXmlToBinary (const XmlElement& xml,
                                       JUCE_NAMESPACE::MemoryBlock& destData)
 {
-    const String xmlString (xml.createDocument (String::empty, true, false));
-    const int stringLength = xmlString.length();
+    // streamed straight to bytes, without building the whole document as a String
+    MemoryOutputStream text (16384, 16384);
 
-    destData.setSize (stringLength + 10);
+    {
+        XmlStreamWriter writer (text, true);
+        writer.writeElement (xml);
+    }
+
+    const int stringLength = (int) text.getDataSize();
+
+    destData.setSize (stringLength + 10, true);
 
     char* const d = (char*) destData.getData();
     *(uint32*) d = ByteOrder::swapIfBigEndian ((const uint32) magicXmlNumber);
     *(uint32*) (d + 4) = ByteOrder::swapIfBigEndian ((const uint32) stringLength);
 
-    xmlString.copyToBuffer (d + 8, stringLength);
+    memcpy (d + 8, text.getData(), stringLength);
 }
 
 XmlElement* AudioProcessor::getXmlFromBinary (const void* data,
@@ -271,10 +280,11 @@ XmlElement* AudioProcessor::getXmlFromBinary (const void* data,
 
         if (stringLength > 0)
         {
-            XmlDocument doc (String (((const char*) data) + 8,
-                                     jmin ((sizeInBytes - 8), stringLength)));
+            // parsed in place, without making a String of the whole document
+            XmlPullParser parser (((const char*) data) + 8,
+                                  jmin ((sizeInBytes - 8), stringLength));
 
-            return doc.getDocumentElement();
+            return parser.readDocumentElement();
         }
     }
 
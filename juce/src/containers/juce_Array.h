@@ -70,7 +70,12 @@ public:
         other.lockArray();
         numUsed = other.numUsed;
         data.setAllocatedSize (other.numUsed);
-        memcpy (data.elements, other.data.elements, numUsed * sizeof (ElementType));
+
+        // an empty array has no elements to copy from, and memcpy from a null
+        // pointer lets the compiler drop the null check of the delete[] later on
+        if (numUsed > 0)
+            memcpy (data.elements, other.data.elements, numUsed * sizeof (ElementType));
+
         other.unlockArray();
     }
 
@@ -94,7 +99,9 @@ public:
        : numUsed (numValues)
     {
         data.setAllocatedSize (numValues);
-        memcpy (data.elements, values, numValues * sizeof (ElementType));
+
+        if (numValues > 0)
+            memcpy (data.elements, values, numValues * sizeof (ElementType));
     }
 
     /** Destructor. */
@@ -114,7 +121,10 @@ public:
 
             data.ensureAllocatedSize (other.size());
             numUsed = other.numUsed;
-            memcpy (data.elements, other.data.elements, numUsed * sizeof (ElementType));
+
+            if (numUsed > 0)
+                memcpy (data.elements, other.data.elements, numUsed * sizeof (ElementType));
+
             minimiseStorageOverheads();
 
             lock.exit();
@@ -0,0 +1,164 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-9 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#include "../core/juce_StandardHeader.h"
+
+BEGIN_JUCE_NAMESPACE
+
+
+#include "juce_PropertyKey.h"
+#include "juce_OwnedArray.h"
+#include "juce_HeapBlock.h"
+#include "../threads/juce_ScopedLock.h"
+
+
+//==============================================================================
+struct PropertyKey::Entry
+{
+    String name;
+    int hash, caseInsensitiveHash;
+};
+
+//==============================================================================
+class PropertyKeyPool
+{
+public:
+    PropertyKeyPool()
+        : tableSize (0)
+    {
+    }
+
+    ~PropertyKeyPool()
+    {
+    }
+
+    const PropertyKey::Entry* intern (const String& name)
+    {
+        const int hash = PropertyKey::hashName (name, false);
+
+        const ScopedLock sl (lock);
+
+        if (entries.size() * 2 >= tableSize)
+            resizeTable (jmax (256, tableSize * 2));
+
+        int i = hash & (tableSize - 1);
+
+        while (table[i] != 0)
+        {
+            if (table[i]->hash == hash && table[i]->name == name)
+                return table[i];
+
+            i = (i + 1) & (tableSize - 1);
+        }
+
+        PropertyKey::Entry* const e = new PropertyKey::Entry();
+        e->name = name;
+        e->hash = hash;
+        e->caseInsensitiveHash = PropertyKey::hashName (name, true);
+
+        entries.add (e);
+        table[i] = e;
+        return e;
+    }
+
+    static PropertyKeyPool& getInstance()
+    {
+        // a function-level static, so that keys can safely be created by
+        // static constructors in other files
+        static PropertyKeyPool pool;
+        return pool;
+    }
+
+private:
+    CriticalSection lock;
+    OwnedArray <PropertyKey::Entry> entries;
+    HeapBlock <PropertyKey::Entry*> table;
+    int tableSize;
+
+    void resizeTable (const int newSize)
+    {
+        table.calloc (newSize);
+        tableSize = newSize;
+
+        for (int j = 0; j < entries.size(); ++j)
+        {
+            PropertyKey::Entry* const e = entries.getUnchecked (j);
+            int i = e->hash & (tableSize - 1);
+
+            while (table[i] != 0)
+                i = (i + 1) & (tableSize - 1);
+
+            table[i] = e;
+        }
+    }
+
+    PropertyKeyPool (const PropertyKeyPool&);
+    const PropertyKeyPool& operator= (const PropertyKeyPool&);
+};
+
+//==============================================================================
+PropertyKey::PropertyKey (const String& name)
+    : entry (0)
+{
+    // an empty name can't be used as a property key!
+    jassert (name.isNotEmpty());
+
+    entry = PropertyKeyPool::getInstance().intern (name);
+}
+
+const String& PropertyKey::toString() const throw()
+{
+    return entry != 0 ? entry->name : String::empty;
+}
+
+int PropertyKey::getHash (const bool ignoreCase) const throw()
+{
+    if (entry == 0)
+        return 0;
+
+    return ignoreCase ? entry->caseInsensitiveHash : entry->hash;
+}
+
+int PropertyKey::hashName (const String& name, const bool ignoreCase) throw()
+{
+    const int length = name.length();
+    uint32 hash = 2166136261u;
+
+    if (ignoreCase)
+    {
+        for (int i = 0; i < length; ++i)
+            hash = (hash ^ (uint32) CharacterFunctions::toLowerCase (name[i])) * 16777619u;
+    }
+    else
+    {
+        for (int i = 0; i < length; ++i)
+            hash = (hash ^ (uint32) name[i]) * 16777619u;
+    }
+
+    return (int) (hash & 0x7fffffff);
+}
+
+
+END_JUCE_NAMESPACE
@@ -0,0 +1,110 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-9 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_PROPERTYKEY_JUCEHEADER__
+#define __JUCE_PROPERTYKEY_JUCEHEADER__
+
+#include "../text/juce_String.h"
+
+
+//==============================================================================
+/**
+    An interned name for a property in a PropertySet.
+
+    Creating a PropertyKey looks its name up in a global table, so that all the
+    keys with the same name share one entry, along with hash codes that are only
+    worked out once. Comparing two keys is then just a pointer compare, and a
+    PropertySet can find a value with a PropertyKey without touching the
+    characters of its name.
+
+    Interning takes a lock, so the best way to use these is to create them once
+    and keep them, e.g.
+
+    @code
+    static const PropertyKey volumeKey (T("volume"));
+
+    const double volume = settings.getDoubleValue (volumeKey, 1.0);
+    @endcode
+
+    The entries in the global table are never deleted, so don't use this for
+    names that are generated on the fly.
+
+    @see PropertySet
+*/
+class JUCE_API  PropertyKey
+{
+public:
+    //==============================================================================
+    /** Creates a null key, which doesn't match anything. */
+    PropertyKey() throw()                                           : entry (0) {}
+
+    /** Creates a key for a name, adding it to the global table if it's not there yet.
+
+        The name mustn't be empty.
+    */
+    explicit PropertyKey (const String& name);
+
+    /** Creates a copy of another key. */
+    PropertyKey (const PropertyKey& other) throw()                  : entry (other.entry) {}
+
+    /** Copies another key over this one. */
+    const PropertyKey& operator= (const PropertyKey& other) throw() { entry = other.entry; return *this; }
+
+    //==============================================================================
+    /** Returns true if both keys were made from exactly the same name. */
+    bool operator== (const PropertyKey& other) const throw()        { return entry == other.entry; }
+
+    /** Returns true if the keys were made from different names. */
+    bool operator!= (const PropertyKey& other) const throw()        { return entry != other.entry; }
+
+    /** Returns true if this isn't a null key. */
+    bool isValid() const throw()                                    { return entry != 0; }
+
+    /** Returns the name of the key. */
+    const String& toString() const throw();
+
+    /** Returns the hash code of the name, as worked out by hashName(). */
+    int getHash (const bool ignoreCase) const throw();
+
+    //==============================================================================
+    /** Works out the hash code that a key with this name would have.
+
+        If ignoreCase is true, names that only differ by their case get the
+        same hash code.
+    */
+    static int hashName (const String& name, const bool ignoreCase) throw();
+
+    //==============================================================================
+    juce_UseDebuggingNewOperator
+
+private:
+    friend class PropertyKeyPool;
+    struct Entry;
+
+    const Entry* entry;
+};
+
+
+#endif   // __JUCE_PROPERTYKEY_JUCEHEADER__
@@ -37,14 +37,20 @@ BEGIN_JUCE_NAMESPACE
 PropertySet::PropertySet (const bool ignoreCaseOfKeyNames) throw()
     : properties (ignoreCaseOfKeyNames),
       fallbackProperties (0),
-      ignoreCaseOfKeys (ignoreCaseOfKeyNames)
+      ignoreCaseOfKeys (ignoreCaseOfKeyNames),
+      numSlots (0),
+      numChangesIndexed (0),
+      indexIsValid (false)
 {
 }
 
 PropertySet::PropertySet (const PropertySet& other) throw()
     : properties (other.properties),
       fallbackProperties (other.fallbackProperties),
-      ignoreCaseOfKeys (other.ignoreCaseOfKeys)
+      ignoreCaseOfKeys (other.ignoreCaseOfKeys),
+      numSlots (0),
+      numChangesIndexed (0),
+      indexIsValid (false)
 {
 }
 
@@ -73,15 +79,105 @@ void PropertySet::clear()
     }
 }
 
+//==============================================================================
+void PropertySet::updateIndex() const throw()
+{
+    // the StringPairArray counts the changes made through getAllProperties(), the
+    // ones made here go straight into its arrays and keep the index up to date
+    if (indexIsValid && numChangesIndexed == properties.numChanges)
+        return;
+
+    const StringArray& keys = properties.getAllKeys();
+    const StringArray& values = properties.getAllValues();
+
+    int newSize = 16;
+    while (newSize < keys.size() * 2 + 2)
+        newSize *= 2;
+
+    slots.calloc (newSize);
+    numSlots = newSize;
+    numChangesIndexed = properties.numChanges;
+    indexIsValid = true;
+
+    for (int i = 0; i < keys.size(); ++i)
+        insertSlot (PropertyKey (keys[i]), i, values[i].getIntValue(), values[i].getDoubleValue());
+}
+
+void PropertySet::insertSlot (const PropertyKey& key, const int index,
+                              const int intValue, const double doubleValue) const throw()
+{
+    const int hash = key.getHash (ignoreCaseOfKeys);
+    int i = hash & (numSlots - 1);
+
+    while (slots[i].key.isValid())
+        i = (i + 1) & (numSlots - 1);
+
+    Slot& slot = slots[i];
+    slot.key = key;
+    slot.hash = hash;
+    slot.index = index;
+    slot.intValue = intValue;
+    slot.doubleValue = doubleValue;
+}
+
+PropertySet::Slot* PropertySet::findSlot (const String& keyName) const throw()
+{
+    updateIndex();
+
+    const int hash = PropertyKey::hashName (keyName, ignoreCaseOfKeys);
+    int i = hash & (numSlots - 1);
+
+    while (slots[i].key.isValid())
+    {
+        Slot& slot = slots[i];
+
+        if (slot.hash == hash
+             && (ignoreCaseOfKeys ? slot.key.toString().equalsIgnoreCase (keyName)
+                                  : slot.key.toString() == keyName))
+            return &slot;
+
+        i = (i + 1) & (numSlots - 1);
+    }
+
+    return 0;
+}
+
+PropertySet::Slot* PropertySet::findSlot (const PropertyKey& key) const throw()
+{
+    if (! key.isValid())
+        return 0;
+
+    updateIndex();
+
+    const int hash = key.getHash (ignoreCaseOfKeys);
+    int i = hash & (numSlots - 1);
+
+    while (slots[i].key.isValid())
+    {
+        Slot& slot = slots[i];
+
+        // keys made from the same name are the same object, so the name only
+        // has to be compared when the case is being ignored
+        if (slot.key == key
+             || (ignoreCaseOfKeys && slot.hash == hash
+                  && slot.key.toString().equalsIgnoreCase (key.toString())))
+            return &slot;
+
+        i = (i + 1) & (numSlots - 1);
+    }
+
+    return 0;
+}
+
+//==============================================================================
 const String PropertySet::getValue (const String& keyName,
                                     const String& defaultValue) const throw()
 {
     const ScopedLock sl (lock);
+    const Slot* const slot = findSlot (keyName);
 
-    const int index = properties.getAllKeys().indexOf (keyName, ignoreCaseOfKeys);
-
-    if (index >= 0)
-        return properties.getAllValues() [index];
+    if (slot != 0)
+        return properties.getAllValues() [slot->index];
 
     return fallbackProperties != 0 ? fallbackProperties->getValue (keyName, defaultValue)
                                    : defaultValue;
@@ -91,10 +187,10 @@ int PropertySet::getIntValue (const String& keyName,
                               const int defaultValue) const throw()
 {
     const ScopedLock sl (lock);
-    const int index = properties.getAllKeys().indexOf (keyName, ignoreCaseOfKeys);
+    const Slot* const slot = findSlot (keyName);
 
-    if (index >= 0)
-        return properties.getAllValues() [index].getIntValue();
+    if (slot != 0)
+        return slot->intValue;
 
     return fallbackProperties != 0 ? fallbackProperties->getIntValue (keyName, defaultValue)
                                    : defaultValue;
@@ -104,10 +200,10 @@ double PropertySet::getDoubleValue (const String& keyName,
                                     const double defaultValue) const throw()
 {
     const ScopedLock sl (lock);
-    const int index = properties.getAllKeys().indexOf (keyName, ignoreCaseOfKeys);
+    const Slot* const slot = findSlot (keyName);
 
-    if (index >= 0)
-        return properties.getAllValues()[index].getDoubleValue();
+    if (slot != 0)
+        return slot->doubleValue;
 
     return fallbackProperties != 0 ? fallbackProperties->getDoubleValue (keyName, defaultValue)
                                    : defaultValue;
@@ -117,10 +213,10 @@ bool PropertySet::getBoolValue (const String& keyName,
                                 const bool defaultValue) const throw()
 {
     const ScopedLock sl (lock);
-    const int index = properties.getAllKeys().indexOf (keyName, ignoreCaseOfKeys);
+    const Slot* const slot = findSlot (keyName);
 
-    if (index >= 0)
-        return properties.getAllValues() [index].getIntValue() != 0;
+    if (slot != 0)
+        return slot->intValue != 0;
 
     return fallbackProperties != 0 ? fallbackProperties->getBoolValue (keyName, defaultValue)
                                    : defaultValue;
@@ -133,40 +229,128 @@ XmlElement* PropertySet::getXmlValue (const String& keyName) const
     return doc.getDocumentElement();
 }
 
-void PropertySet::setValue (const String& keyName,
-                            const String& value) throw()
+//==============================================================================
+const String PropertySet::getValue (const PropertyKey& key,
+                                    const String& defaultValue) const throw()
+{
+    const ScopedLock sl (lock);
+    const Slot* const slot = findSlot (key);
+
+    if (slot != 0)
+        return properties.getAllValues() [slot->index];
+
+    return fallbackProperties != 0 ? fallbackProperties->getValue (key, defaultValue)
+                                   : defaultValue;
+}
+
+int PropertySet::getIntValue (const PropertyKey& key,
+                              const int defaultValue) const throw()
+{
+    const ScopedLock sl (lock);
+    const Slot* const slot = findSlot (key);
+
+    if (slot != 0)
+        return slot->intValue;
+
+    return fallbackProperties != 0 ? fallbackProperties->getIntValue (key, defaultValue)
+                                   : defaultValue;
+}
+
+double PropertySet::getDoubleValue (const PropertyKey& key,
+                                    const double defaultValue) const throw()
+{
+    const ScopedLock sl (lock);
+    const Slot* const slot = findSlot (key);
+
+    if (slot != 0)
+        return slot->doubleValue;
+
+    return fallbackProperties != 0 ? fallbackProperties->getDoubleValue (key, defaultValue)
+                                   : defaultValue;
+}
+
+bool PropertySet::getBoolValue (const PropertyKey& key,
+                                const bool defaultValue) const throw()
+{
+    const ScopedLock sl (lock);
+    const Slot* const slot = findSlot (key);
+
+    if (slot != 0)
+        return slot->intValue != 0;
+
+    return fallbackProperties != 0 ? fallbackProperties->getBoolValue (key, defaultValue)
+                                   : defaultValue;
+}
+
+//==============================================================================
+void PropertySet::changeValue (Slot& slot, const String& value,
+                               const int intValue, const double doubleValue) throw()
+{
+    if (properties.values [slot.index] != value)
+    {
+        properties.values.set (slot.index, value);
+        slot.intValue = intValue;
+        slot.doubleValue = doubleValue;
+        propertyChanged();
+    }
+}
+
+void PropertySet::addValue (const PropertyKey& key, const String& value,
+                            const int intValue, const double doubleValue) throw()
+{
+    const int index = properties.keys.size();
+
+    properties.keys.add (key.toString());
+    properties.values.add (value);
+
+    if ((index + 1) * 2 >= numSlots)
+        indexIsValid = false; // this will rebuild it with more room
+    else
+        insertSlot (key, index, intValue, doubleValue);
+
+    propertyChanged();
+}
+
+void PropertySet::storeValue (const String& keyName, const String& value,
+                              const int intValue, const double doubleValue) throw()
 {
     jassert (keyName.isNotEmpty()); // shouldn't use an empty key name!
 
     if (keyName.isNotEmpty())
     {
         const ScopedLock sl (lock);
+        Slot* const slot = findSlot (keyName);
 
-        const int index = properties.getAllKeys().indexOf (keyName, ignoreCaseOfKeys);
-
-        if (index < 0 || properties.getAllValues() [index] != value)
-        {
-            properties.set (keyName, value);
-            propertyChanged();
-        }
+        if (slot != 0)
+            changeValue (*slot, value, intValue, doubleValue);
+        else
+            addValue (PropertyKey (keyName), value, intValue, doubleValue);
     }
 }
 
-void PropertySet::removeValue (const String& keyName) throw()
+void PropertySet::storeValue (const PropertyKey& key, const String& value,
+                              const int intValue, const double doubleValue) throw()
 {
-    if (keyName.isNotEmpty())
+    jassert (key.isValid()); // shouldn't use a null key!
+
+    if (key.isValid())
     {
         const ScopedLock sl (lock);
-        const int index = properties.getAllKeys().indexOf (keyName, ignoreCaseOfKeys);
+        Slot* const slot = findSlot (key);
 
-        if (index >= 0)
-        {
-            properties.remove (keyName);
-            propertyChanged();
-        }
+        if (slot != 0)
+            changeValue (*slot, value, intValue, doubleValue);
+        else
+            addValue (key, value, intValue, doubleValue);
     }
 }
 
+//==============================================================================
+void PropertySet::setValue (const String& keyName, const String& value) throw()
+{
+    storeValue (keyName, value, value.getIntValue(), value.getDoubleValue());
+}
+
 void PropertySet::setValue (const String& keyName, const tchar* const value) throw()
 {
     setValue (keyName, String (value));
@@ -174,17 +358,18 @@ void PropertySet::setValue (const String& keyName, const tchar* const value) thr
 
 void PropertySet::setValue (const String& keyName, const int value) throw()
 {
-    setValue (keyName, String (value));
+    storeValue (keyName, String (value), value, (double) value);
 }
 
 void PropertySet::setValue (const String& keyName, const double value) throw()
 {
-    setValue (keyName, String (value));
+    const String text (value);
+    storeValue (keyName, text, text.getIntValue(), text.getDoubleValue());
 }
 
 void PropertySet::setValue (const String& keyName, const bool value) throw()
 {
-    setValue (keyName, String ((value) ? T("1") : T("0")));
+    storeValue (keyName, String ((value) ? T("1") : T("0")), value ? 1 : 0, value ? 1.0 : 0.0);
 }
 
 void PropertySet::setValue (const String& keyName, const XmlElement* const xml)
@@ -193,10 +378,70 @@ void PropertySet::setValue (const String& keyName, const XmlElement* const xml)
                                   : xml->createDocument (String::empty, true));
 }
 
+void PropertySet::setValue (const PropertyKey& key, const String& value) throw()
+{
+    storeValue (key, value, value.getIntValue(), value.getDoubleValue());
+}
+
+void PropertySet::setValue (const PropertyKey& key, const tchar* const value) throw()
+{
+    setValue (key, String (value));
+}
+
+void PropertySet::setValue (const PropertyKey& key, const int value) throw()
+{
+    storeValue (key, String (value), value, (double) value);
+}
+
+void PropertySet::setValue (const PropertyKey& key, const double value) throw()
+{
+    const String text (value);
+    storeValue (key, text, text.getIntValue(), text.getDoubleValue());
+}
+
+void PropertySet::setValue (const PropertyKey& key, const bool value) throw()
+{
+    storeValue (key, String ((value) ? T("1") : T("0")), value ? 1 : 0, value ? 1.0 : 0.0);
+}
+
+//==============================================================================
+void PropertySet::removeValue (const String& keyName) throw()
+{
+    if (keyName.isNotEmpty())
+    {
+        const ScopedLock sl (lock);
+        const Slot* const slot = findSlot (keyName);
+
+        if (slot != 0)
+        {
+            properties.remove (slot->index);
+            propertyChanged();
+        }
+    }
+}
+
+void PropertySet::removeValue (const PropertyKey& key) throw()
+{
+    const ScopedLock sl (lock);
+    const Slot* const slot = findSlot (key);
+
+    if (slot != 0)
+    {
+        properties.remove (slot->index);
+        propertyChanged();
+    }
+}
+
 bool PropertySet::containsKey (const String& keyName) const throw()
 {
     const ScopedLock sl (lock);
-    return properties.getAllKeys().contains (keyName, ignoreCaseOfKeys);
+    return findSlot (keyName) != 0;
+}
+
+bool PropertySet::containsKey (const PropertyKey& key) const throw()
+{
+    const ScopedLock sl (lock);
+    return findSlot (key) != 0;
 }
 
 void PropertySet::setFallbackPropertySet (PropertySet* fallbackProperties_) throw()
@@ -205,6 +450,7 @@ void PropertySet::setFallbackPropertySet (PropertySet* fallbackProperties_) thro
     fallbackProperties = fallbackProperties_;
 }
 
+//==============================================================================
 XmlElement* PropertySet::createXml (const String& nodeName) const throw()
 {
     const ScopedLock sl (lock);
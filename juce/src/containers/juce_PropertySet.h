@@ -28,6 +28,8 @@
 
 #include "../text/juce_StringPairArray.h"
 #include "../text/juce_XmlElement.h"
+#include "juce_PropertyKey.h"
+#include "juce_HeapBlock.h"
 
 
 //==============================================================================
@@ -37,6 +39,11 @@
     Effectively, this just wraps a StringPairArray in an interface that makes it easier
     to load and save types other than strings.
 
+    The keys are indexed by a hash table, which also keeps the integer and floating point
+    versions of each value, so looking up a value doesn't have to search through the keys
+    or parse the string again. A key can be given as a String, or as a PropertyKey, which
+    skips hashing and comparing the characters of the name.
+
     See the PropertiesFile class for a subclass of this, which automatically broadcasts change
     messages and saves/loads the list from a file.
 */
@@ -127,6 +134,22 @@ public:
     */
     XmlElement* getXmlValue (const String& keyName) const;
 
+    /** Returns one of the properties as a string, looking it up with an interned key. */
+    const String getValue (const PropertyKey& key,
+                           const String& defaultReturnValue = String::empty) const throw();
+
+    /** Returns one of the properties as an integer, looking it up with an interned key. */
+    int getIntValue (const PropertyKey& key,
+                     const int defaultReturnValue = 0) const throw();
+
+    /** Returns one of the properties as a double, looking it up with an interned key. */
+    double getDoubleValue (const PropertyKey& key,
+                           const double defaultReturnValue = 0.0) const throw();
+
+    /** Returns one of the properties as a boolean, looking it up with an interned key. */
+    bool getBoolValue (const PropertyKey& key,
+                       const bool defaultReturnValue = false) const throw();
+
     //==============================================================================
     /** Sets a named property as a string.
 
@@ -172,6 +195,21 @@ public:
     */
     void setValue (const String& keyName, const XmlElement* const xml);
 
+    /** Sets a named property as a string, using an interned key. */
+    void setValue (const PropertyKey& key, const String& value) throw();
+
+    /** Sets a named property as a string, using an interned key. */
+    void setValue (const PropertyKey& key, const tchar* const value) throw();
+
+    /** Sets a named property to an integer, using an interned key. */
+    void setValue (const PropertyKey& key, const int value) throw();
+
+    /** Sets a named property to a double, using an interned key. */
+    void setValue (const PropertyKey& key, const double value) throw();
+
+    /** Sets a named property to a boolean, using an interned key. */
+    void setValue (const PropertyKey& key, const bool value) throw();
+
     //==============================================================================
     /** Deletes a property.
 
@@ -179,16 +217,29 @@ public:
     */
     void removeValue (const String& keyName) throw();
 
+    /** Deletes a property, using an interned key. */
+    void removeValue (const PropertyKey& key) throw();
+
     /** Returns true if the properies include the given key. */
     bool containsKey (const String& keyName) const throw();
 
+    /** Returns true if the properies include the given key. */
+    bool containsKey (const PropertyKey& key) const throw();
+
     /** Removes all values. */
     void clear();
 
     //==============================================================================
-    /** Returns the keys/value pair array containing all the properties. */
+    /** Returns the keys/value pair array containing all the properties.
+
+        The array can be changed directly (while holding getLock()), the index of the
+        keys notices it and is rebuilt the next time a value is looked up.
+    */
     StringPairArray& getAllProperties() throw()                         { return properties; }
 
+    /** Returns the keys/value pair array containing all the properties. */
+    const StringPairArray& getAllProperties() const throw()             { return properties; }
+
     /** Returns the lock used when reading or writing to this set */
     const CriticalSection& getLock() const throw()                      { return lock; }
 
@@ -242,10 +293,31 @@ protected:
 
 private:
     //==============================================================================
+    struct Slot
+    {
+        PropertyKey key;
+        int hash, index;
+        int intValue;
+        double doubleValue;
+    };
+
     StringPairArray properties;
     PropertySet* fallbackProperties;
     CriticalSection lock;
     bool ignoreCaseOfKeys;
+
+    mutable HeapBlock <Slot> slots;
+    mutable int numSlots, numChangesIndexed;
+    mutable bool indexIsValid;
+
+    Slot* findSlot (const String& keyName) const throw();
+    Slot* findSlot (const PropertyKey& key) const throw();
+    void updateIndex() const throw();
+    void insertSlot (const PropertyKey& key, const int index, const int intValue, const double doubleValue) const throw();
+    void storeValue (const String& keyName, const String& value, const int intValue, const double doubleValue) throw();
+    void storeValue (const PropertyKey& key, const String& value, const int intValue, const double doubleValue) throw();
+    void changeValue (Slot& slot, const String& value, const int intValue, const double doubleValue) throw();
+    void addValue (const PropertyKey& key, const String& value, const int intValue, const double doubleValue) throw();
 };
 
 
@@ -64,7 +64,9 @@ public:
         other.lockArray();
         numUsed = other.numUsed;
         data.setAllocatedSize (numUsed);
-        memcpy (data.elements, other.data.elements, numUsed * sizeof (ObjectClass*));
+
+        if (numUsed > 0)
+            memcpy (data.elements, other.data.elements, numUsed * sizeof (ObjectClass*));
 
         for (int i = numUsed; --i >= 0;)
             if (data.elements[i] != 0)
@@ -88,7 +90,10 @@ public:
 
             data.ensureAllocatedSize (other.numUsed);
             numUsed = other.numUsed;
-            memcpy (data.elements, other.data.elements, numUsed * sizeof (ObjectClass*));
+
+            if (numUsed > 0)
+                memcpy (data.elements, other.data.elements, numUsed * sizeof (ObjectClass*));
+
             minimiseStorageOverheads();
 
             for (int i = numUsed; --i >= 0;)
@@ -76,7 +76,10 @@ public:
         other.lockSet();
         numUsed = other.numUsed;
         data.setAllocatedSize (other.numUsed);
-        memcpy (data.elements, other.data.elements, numUsed * sizeof (ElementType));
+
+        if (numUsed > 0)
+            memcpy (data.elements, other.data.elements, numUsed * sizeof (ElementType));
+
         other.unlockSet();
     }
 
@@ -97,7 +100,10 @@ public:
 
             data.ensureAllocatedSize (other.size());
             numUsed = other.numUsed;
-            memcpy (data.elements, other.data.elements, numUsed * sizeof (ElementType));
+
+            if (numUsed > 0)
+                memcpy (data.elements, other.data.elements, numUsed * sizeof (ElementType));
+
             minimiseStorageOverheads();
 
             lock.exit();
@@ -44,6 +44,28 @@ public:
 
     /** Decrements an integer in a thread-safe way and returns its new value. */
     static int decrementAndReturn (int& variable);
+
+    /** Sets some bits of an integer in a thread-safe way. */
+    static void bitwiseOr (int& variable, const int bits);
+
+    /** Stores a new value in an integer in a thread-safe way, and returns the old one. */
+    static int exchange (int& variable, const int newValue);
+
+    /** Replaces an integer with a new value if it still holds the expected one.
+        Returns true if the swap happened.
+    */
+    static bool compareAndSwap (int& variable, const int newValue, const int expectedValue);
+
+    /** Reads an integer so that the reads after it can't be moved before it (acquire). */
+    static int loadAcquire (const int& variable);
+
+    /** Writes an integer so that the writes before it can't be moved after it (release). */
+    static void storeRelease (int& variable, const int newValue);
+
+    /** Issues a full memory barrier, so that every read and write made before this
+        call is visible to other threads before any read or write made after it.
+    */
+    static void memoryBarrier();
 };
 
 
@@ -55,6 +77,25 @@ inline void Atomic::increment (int& variable)               { OSAtomicIncrement3
 inline int  Atomic::incrementAndReturn (int& variable)      { return OSAtomicIncrement32 ((int32_t*) &variable); }
 inline void Atomic::decrement (int& variable)               { OSAtomicDecrement32 ((int32_t*) &variable); }
 inline int  Atomic::decrementAndReturn (int& variable)      { return OSAtomicDecrement32 ((int32_t*) &variable); }
+inline void Atomic::bitwiseOr (int& variable, const int bits)   { OSAtomicOr32Barrier ((uint32_t) bits, (volatile uint32_t*) &variable); }
+inline bool Atomic::compareAndSwap (int& variable, const int newValue, const int expectedValue)
+                                                            { return OSAtomicCompareAndSwap32Barrier (expectedValue, newValue, (int32_t*) &variable); }
+inline int  Atomic::loadAcquire (const int& variable)       { const int value = *(const volatile int*) &variable; OSMemoryBarrier(); return value; }
+inline void Atomic::storeRelease (int& variable, const int newValue) { OSMemoryBarrier(); *(volatile int*) &variable = newValue; }
+inline void Atomic::memoryBarrier()                         { OSMemoryBarrier(); }
+
+inline int Atomic::exchange (int& variable, const int newValue)
+{
+    int oldValue;
+
+    do
+    {
+        oldValue = *(volatile int*) &variable;
+    }
+    while (! OSAtomicCompareAndSwap32Barrier (oldValue, newValue, (int32_t*) &variable));
+
+    return oldValue;
+}
 
 #elif JUCE_GCC
 
@@ -65,6 +106,13 @@ inline void Atomic::increment (int& variable)               { __sync_add_and_fet
 inline int  Atomic::incrementAndReturn (int& variable)      { return __sync_add_and_fetch (&variable, 1); }
 inline void Atomic::decrement (int& variable)               { __sync_add_and_fetch (&variable, -1); }
 inline int  Atomic::decrementAndReturn (int& variable)      { return __sync_add_and_fetch (&variable, -1); }
+inline void Atomic::bitwiseOr (int& variable, const int bits)   { __sync_fetch_and_or (&variable, bits); }
+inline int  Atomic::exchange (int& variable, const int newValue) { __sync_synchronize(); return __sync_lock_test_and_set (&variable, newValue); }
+inline bool Atomic::compareAndSwap (int& variable, const int newValue, const int expectedValue)
+                                                            { return __sync_bool_compare_and_swap (&variable, expectedValue, newValue); }
+inline int  Atomic::loadAcquire (const int& variable)       { const int value = *(const volatile int*) &variable; __sync_synchronize(); return value; }
+inline void Atomic::storeRelease (int& variable, const int newValue) { __sync_synchronize(); *(volatile int*) &variable = newValue; }
+inline void Atomic::memoryBarrier()                         { __sync_synchronize(); }
 
 //==============================================================================
 #else                                   //  Linux without intrinsics...
@@ -141,6 +189,68 @@ inline int Atomic::decrementAndReturn (int& variable)
     #endif
     return result;
 }
+
+inline void Atomic::bitwiseOr (int& variable, const int bits)
+{
+    __asm__ __volatile__ (
+        "lock orl %1, %0"
+        : "+m" (variable)
+        : "r" (bits)
+        : "cc", "memory");
+}
+
+inline int Atomic::exchange (int& variable, const int newValue)
+{
+    int result = newValue;
+
+    // xchg with a memory operand is always locked
+    __asm__ __volatile__ (
+        "xchgl %0, %1"
+        : "+r" (result), "+m" (variable)
+        :
+        : "memory");
+
+    return result;
+}
+
+inline bool Atomic::compareAndSwap (int& variable, const int newValue, const int expectedValue)
+{
+    int previous = expectedValue;
+
+    __asm__ __volatile__ (
+        "lock cmpxchgl %2, %1"
+        : "+a" (previous), "+m" (variable)
+        : "r" (newValue)
+        : "cc", "memory");
+
+    return previous == expectedValue;
+}
+
+// x86 doesn't reorder loads with loads or stores with stores,
+// so only the compiler has to be kept from moving things around
+inline int Atomic::loadAcquire (const int& variable)
+{
+    const int value = *(const volatile int*) &variable;
+    __asm__ __volatile__ ("" : : : "memory");
+    return value;
+}
+
+inline void Atomic::storeRelease (int& variable, const int newValue)
+{
+    __asm__ __volatile__ ("" : : : "memory");
+    *(volatile int*) &variable = newValue;
+}
+
+inline void Atomic::memoryBarrier()
+{
+    __asm__ __volatile__ (
+    #if JUCE_64BIT
+        "lock orq $0, (%%rsp)"
+    #else
+        "lock orl $0, (%%esp)"
+    #endif
+        : : : "cc", "memory");
+}
 #endif
 
 //==============================================================================
@@ -148,11 +258,22 @@ inline int Atomic::decrementAndReturn (int& variable)
 
 #pragma intrinsic (_InterlockedIncrement)
 #pragma intrinsic (_InterlockedDecrement)
+#pragma intrinsic (_InterlockedOr)
+#pragma intrinsic (_InterlockedExchange)
+#pragma intrinsic (_InterlockedCompareExchange)
+#pragma intrinsic (_ReadWriteBarrier)
 
 inline void Atomic::increment (int& variable)               { _InterlockedIncrement (reinterpret_cast <volatile long*> (&variable)); }
 inline int  Atomic::incrementAndReturn (int& variable)      { return _InterlockedIncrement (reinterpret_cast <volatile long*> (&variable)); }
 inline void Atomic::decrement (int& variable)               { _InterlockedDecrement (reinterpret_cast <volatile long*> (&variable)); }
 inline int  Atomic::decrementAndReturn (int& variable)      { return _InterlockedDecrement (reinterpret_cast <volatile long*> (&variable)); }
+inline void Atomic::bitwiseOr (int& variable, const int bits)   { _InterlockedOr (reinterpret_cast <volatile long*> (&variable), bits); }
+inline int  Atomic::exchange (int& variable, const int newValue) { return _InterlockedExchange (reinterpret_cast <volatile long*> (&variable), newValue); }
+inline bool Atomic::compareAndSwap (int& variable, const int newValue, const int expectedValue)
+                                                            { return _InterlockedCompareExchange (reinterpret_cast <volatile long*> (&variable), newValue, expectedValue) == expectedValue; }
+inline int  Atomic::loadAcquire (const int& variable)       { const int value = *(const volatile int*) &variable; _ReadWriteBarrier(); return value; }
+inline void Atomic::storeRelease (int& variable, const int newValue) { _ReadWriteBarrier(); *(volatile int*) &variable = newValue; }
+inline void Atomic::memoryBarrier()                         { long barrier = 0; _InterlockedIncrement (&barrier); }
 
 //==============================================================================
 #else                               // Windows without intrinsics...
@@ -203,6 +324,62 @@ inline int Atomic::decrementAndReturn (int& variable)
     return result;
 }
 
+inline void Atomic::bitwiseOr (int& variable, const int bits)
+{
+    __asm {
+        mov ecx, dword ptr [variable]
+        mov eax, bits
+        lock or dword ptr [ecx], eax
+    }
+}
+
+inline int Atomic::exchange (int& variable, const int newValue)
+{
+    int result;
+
+    __asm {
+        mov ecx, dword ptr [variable]
+        mov eax, newValue
+        xchg dword ptr [ecx], eax
+        mov result, eax
+    }
+
+    return result;
+}
+
+inline bool Atomic::compareAndSwap (int& variable, const int newValue, const int expectedValue)
+{
+    int previous;
+
+    __asm {
+        mov ecx, dword ptr [variable]
+        mov edx, newValue
+        mov eax, expectedValue
+        lock cmpxchg dword ptr [ecx], edx
+        mov previous, eax
+    }
+
+    return previous == expectedValue;
+}
+
+// volatile accesses are ordered on x86, these only stop the compiler
+inline int Atomic::loadAcquire (const int& variable)
+{
+    return *(const volatile int*) &variable;
+}
+
+inline void Atomic::storeRelease (int& variable, const int newValue)
+{
+    *(volatile int*) &variable = newValue;
+}
+
+inline void Atomic::memoryBarrier()
+{
+    __asm {
+        lock or dword ptr [esp], 0
+    }
+}
+
 #endif
 
 #endif   // __JUCE_ATOMIC_JUCEHEADER__
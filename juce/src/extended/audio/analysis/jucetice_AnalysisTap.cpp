@@ -0,0 +1,561 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2009 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU General Public License, as published by the Free Software Foundation;
+ either version 2 of the License, or (at your option) any later version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+#include "../../../core/juce_StandardHeader.h"
+
+BEGIN_JUCE_NAMESPACE
+
+#include "jucetice_AnalysisTap.h"
+#include "../../../threads/juce_ScopedLock.h"
+#include "../../../threads/juce_WaitableEvent.h"
+#include "../../../threads/juce_Thread.h"
+#include "../../../core/juce_Singleton.h"
+#include "../../../containers/juce_VoidArray.h"
+#include "../../../containers/juce_ScopedPointer.h"
+#include "../../../utilities/juce_DeletedAtShutdown.h"
+#include "../../../events/juce_Timer.h"
+
+static const float lowestBandFrequency = 20.0f;
+static const float highestBandFrequency = 20000.0f;
+static const float silenceDecibels = -120.0f;
+
+
+//==============================================================================
+/*  The thread that all the AnalysisTaps share.
+
+    It goes round the taps, analysing one hop of the first one that has
+    enough samples, and a tap is analysed by nobody else meanwhile, which is
+    what its analysisLock is for. The audio thread never signals anything,
+    so the thread looks at the rings again every few milliseconds.
+*/
+class AnalysisWorker  : public DeletedAtShutdown,
+                        private Timer
+{
+public:
+    AnalysisWorker()
+        : nextTap (0)
+    {
+    }
+
+    ~AnalysisWorker()
+    {
+        stopWorkerThread();
+        clearSingletonInstance();
+    }
+
+    juce_DeclareSingleton (AnalysisWorker, false)
+
+    /* Registers with the shared instance, creating it if needed.
+
+       The singleton lock is held so the timer can't delete the instance
+       between it being returned and the tap being added.
+    */
+    static void addTapToInstance (AnalysisTap* tap)
+    {
+        const ScopedLock sl (_singletonLock);
+        getInstance()->addTap (tap);
+    }
+
+    /* Unregisters from the shared instance, if there's still one */
+    static void removeTapFromInstance (AnalysisTap* tap)
+    {
+        const ScopedLock sl (_singletonLock);
+
+        if (_singletonInstance != 0)
+            _singletonInstance->removeTap (tap);
+    }
+
+    void addTap (AnalysisTap* tap)
+    {
+        const ScopedLock sl (lock);
+
+        if (! taps.contains ((void*) tap))
+        {
+            taps.add ((void*) tap);
+            startWorkerThread();
+
+            stopTimer();
+        }
+    }
+
+    void removeTap (AnalysisTap* tap)
+    {
+        {
+            const ScopedLock sl (lock);
+            taps.removeValue ((void*) tap);
+
+            if (taps.size() == 0)
+                startTimer (5000);
+        }
+
+        // if the thread is still analysing it, wait until that's finished
+        const ScopedLock al (tap->analysisLock);
+    }
+
+private:
+    //==============================================================================
+    class WorkerThread  : public Thread
+    {
+    public:
+        WorkerThread (AnalysisWorker& owner_)
+            : Thread ("Analysis"),
+              owner (owner_)
+        {
+        }
+
+        void run()
+        {
+            while (! threadShouldExit())
+            {
+                if (! owner.analyseNextTap())
+                    owner.workAvailable.wait (10);
+            }
+        }
+
+    private:
+        AnalysisWorker& owner;
+
+        WorkerThread (const WorkerThread&);
+        const WorkerThread& operator= (const WorkerThread&);
+    };
+
+    VoidArray taps;
+    ScopedPointer <WorkerThread> thread;
+    CriticalSection lock;
+    WaitableEvent workAvailable;
+    int nextTap;
+
+    void startWorkerThread()
+    {
+        if (thread == 0)
+        {
+            // the results are only for looking at, so stay behind anything else
+            thread = new WorkerThread (*this);
+            thread->startThread (2);
+        }
+    }
+
+    void stopWorkerThread()
+    {
+        if (thread != 0)
+        {
+            thread->signalThreadShouldExit();
+            workAvailable.signal();
+            thread->stopThread (10000);
+            thread = 0;
+        }
+    }
+
+    bool analyseNextTap()
+    {
+        AnalysisTap* tap = 0;
+
+        {
+            const ScopedLock sl (lock);
+
+            // round robin, so a busy tap can't starve the others
+            for (int i = 0; i < taps.size() && tap == 0; ++i)
+            {
+                const int index = (nextTap + i) % taps.size();
+                AnalysisTap* const t = (AnalysisTap*) taps.getUnchecked (index);
+
+                if (t->isHopReady() && t->analysisLock.tryEnter())
+                {
+                    tap = t;
+                    nextTap = index + 1;
+                }
+            }
+        }
+
+        if (tap == 0)
+            return false;
+
+        tap->analyseNextHop();
+        tap->analysisLock.exit();
+
+        return true;
+    }
+
+    void timerCallback()
+    {
+        stopTimer();
+
+        // nobody can register while the singleton lock is held, so nothing
+        // can be added between checking the taps and deleting ourselves
+        const ScopedLock sl (_singletonLock);
+
+        bool isUnused;
+
+        {
+            const ScopedLock sl2 (lock);
+            isUnused = (taps.size() == 0);
+        }
+
+        if (isUnused)
+            deleteInstance();
+    }
+
+    AnalysisWorker (const AnalysisWorker&);
+    const AnalysisWorker& operator= (const AnalysisWorker&);
+};
+
+juce_ImplementSingleton (AnalysisWorker)
+
+
+//==============================================================================
+float AnalysisResults::getBandFrequency (const int band, const double sampleRate)
+{
+    const float highest = jmin (highestBandFrequency, (float) sampleRate * 0.5f);
+
+    return lowestBandFrequency * powf (highest / lowestBandFrequency, (band + 0.5f) / numSpectrumBands);
+}
+
+
+//==============================================================================
+AnalysisTap::AnalysisTap (const int numChannels_,
+                          const int fftSize_,
+                          const int hopSize_)
+    : numChannels (jlimit (1, (int) AnalysisResults::maxChannels, numChannels_)),
+      fftSize (fftSize_),
+      hopSize (jlimit (1, fftSize_, hopSize_)),
+      sampleRate (0.0),
+      resultsPerSecond (30),
+      samplesDropped (0),
+      fft (fftSize_),
+      window (fftSize_),
+      history (jlimit (1, (int) AnalysisResults::maxChannels, numChannels_) * fftSize_),
+      windowed (fftSize_),
+      real (fftSize_ / 2 + 1),
+      imag (fftSize_ / 2 + 1),
+      numHopEnergies (0),
+      hopEnergyIndex (0)
+{
+    // room for a few blocks more than a window, so the worker can be late
+    for (int ch = 0; ch < numChannels; ++ch)
+        rings.add (new LockFreeQueue <float> (fftSize * 8));
+
+    // hann window, scaled so a full scale sine reads 0 dB
+    double sum = 0.0;
+
+    for (int i = 0; i < fftSize; ++i)
+    {
+        window [i] = (float) (0.5 - 0.5 * cos (2.0 * double_Pi * i / fftSize));
+        sum += window [i];
+    }
+
+    windowGain = (float) (2.0 / jmax (1.0, sum));
+
+    spectrumSum.calloc (numChannels * AnalysisResults::numSpectrumBands);
+    bandStart.calloc (AnalysisResults::numSpectrumBands);
+    bandEnd.calloc (AnalysisResults::numSpectrumBands);
+
+    prepare (44100.0);
+
+    AnalysisWorker::addTapToInstance (this);
+}
+
+AnalysisTap::~AnalysisTap ()
+{
+    AnalysisWorker::removeTapFromInstance (this);
+}
+
+//==============================================================================
+void AnalysisTap::prepare (const double newSampleRate)
+{
+    const ScopedLock sl (analysisLock);
+
+    sampleRate = newSampleRate > 0.0 ? newSampleRate : 44100.0;
+
+    // which bins each display band takes its value from
+    const int numBins = fftSize / 2 + 1;
+    const float highest = jmin (highestBandFrequency, (float) sampleRate * 0.5f);
+    const float binsPerHertz = fftSize / (float) sampleRate;
+
+    for (int band = 0; band < AnalysisResults::numSpectrumBands; ++band)
+    {
+        const float low = lowestBandFrequency * powf (highest / lowestBandFrequency, band / (float) AnalysisResults::numSpectrumBands);
+        const float high = lowestBandFrequency * powf (highest / lowestBandFrequency, (band + 1) / (float) AnalysisResults::numSpectrumBands);
+
+        bandStart [band] = jlimit (0, numBins - 1, roundFloatToInt (low * binsPerHertz));
+        bandEnd [band] = jlimit (bandStart [band] + 1, numBins, roundFloatToInt (high * binsPerHertz));
+    }
+
+    // the K-weighting of ITU BS.1770: a high shelf and a high pass, for this rate
+    {
+        double K = tan (double_Pi * 1681.974450955533 / sampleRate);
+        const double Q = 0.7071752369554196;
+        const double Vh = pow (10.0, 3.999843853973347 / 20.0);
+        const double Vb = pow (Vh, 0.4996667741545416);
+        double a0 = 1.0 + K / Q + K * K;
+
+        kCoefficients [0] = (Vh + Vb * K / Q + K * K) / a0;
+        kCoefficients [1] = 2.0 * (K * K - Vh) / a0;
+        kCoefficients [2] = (Vh - Vb * K / Q + K * K) / a0;
+        kCoefficients [3] = 2.0 * (K * K - 1.0) / a0;
+        kCoefficients [4] = (1.0 - K / Q + K * K) / a0;
+
+        K = tan (double_Pi * 38.13547087602444 / sampleRate);
+        const double Q2 = 0.5003270373238773;
+        a0 = 1.0 + K / Q2 + K * K;
+
+        kCoefficients [5] = 1.0;
+        kCoefficients [6] = -2.0;
+        kCoefficients [7] = 1.0;
+        kCoefficients [8] = 2.0 * (K * K - 1.0) / a0;
+        kCoefficients [9] = (1.0 - K / Q2 + K * K) / a0;
+    }
+
+    // momentary loudness is over 400 ms
+    numHopEnergies = jmax (1, roundDoubleToInt (0.4 * sampleRate / hopSize));
+    hopEnergies.calloc (numHopEnergies);
+
+    correlationDecay = exp (-hopSize / (0.3 * sampleRate));
+
+    // we are the reader of the rings now, throw away what is in them
+    int numToDrop = rings.getUnchecked (0)->getNumReady();
+    for (int ch = 1; ch < numChannels; ++ch)
+        numToDrop = jmin (numToDrop, rings.getUnchecked (ch)->getNumReady());
+
+    for (int ch = 0; ch < numChannels; ++ch)
+        rings.getUnchecked (ch)->finishedRead (numToDrop);
+
+    resetAnalysis();
+}
+
+void AnalysisTap::setResultsPerSecond (const int newResultsPerSecond)
+{
+    resultsPerSecond = jmax (1, newResultsPerSecond);
+}
+
+void AnalysisTap::resetAnalysis ()
+{
+    zeromem (history.getData(), numChannels * fftSize * sizeof (float));
+    zeromem (spectrumSum, numChannels * AnalysisResults::numSpectrumBands * sizeof (float));
+    zeromem (kState, sizeof (kState));
+    zeromem (squareSums, sizeof (squareSums));
+
+    hopEnergyIndex = 0;
+    sumLR = sumLL = sumRR = 0.0;
+    hopsSinceResult = samplesSinceResult = 0;
+    samplesAnalysed = 0;
+
+    pending = AnalysisResults();
+    pending.numChannels = numChannels;
+}
+
+//==============================================================================
+void AnalysisTap::pushSamples (const AudioSampleBuffer& buffer,
+                               const int startSample,
+                               const int numSamples)
+{
+    const int numInputs = buffer.getNumChannels();
+
+    if (numInputs <= 0 || numSamples <= 0)
+        return;
+
+    // push the same amount to every ring, so the channels stay in step
+    int numToPush = numSamples;
+    for (int ch = 0; ch < numChannels; ++ch)
+        numToPush = jmin (numToPush, rings.getUnchecked (ch)->getFreeSpace());
+
+    for (int ch = 0; ch < numChannels; ++ch)
+        rings.getUnchecked (ch)->push (buffer.getSampleData (jmin (ch, numInputs - 1), startSample), numToPush);
+
+    if (numToPush < numSamples)
+        samplesDropped += numSamples - numToPush;
+}
+
+bool AnalysisTap::getLatestResults (AnalysisResults& latest)
+{
+    if (! results.update())
+        return false;
+
+    latest = results.getReadBuffer();
+    return true;
+}
+
+//==============================================================================
+bool AnalysisTap::isHopReady () const
+{
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        if (rings.getUnchecked (ch)->getNumReady() < hopSize)
+            return false;
+    }
+
+    return true;
+}
+
+void AnalysisTap::analyseNextHop ()
+{
+    double hopEnergy = 0.0;
+    const float* left = 0;
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        // slide the window by a hop
+        float* const h = history + ch * fftSize;
+        memmove (h, h + hopSize, (fftSize - hopSize) * sizeof (float));
+
+        float* const samples = h + fftSize - hopSize;
+        rings.getUnchecked (ch)->pop (samples, hopSize);
+
+        // levels
+        float peak = pending.peak [ch];
+        double squares = 0.0;
+
+        for (int i = 0; i < hopSize; ++i)
+        {
+            peak = jmax (peak, fabsf (samples [i]));
+            squares += samples [i] * samples [i];
+        }
+
+        pending.peak [ch] = peak;
+        squareSums [ch] += squares;
+
+        // K-weighted energy, for the loudness
+        double* const s = kState [ch];
+        const double* const c = kCoefficients;
+        double energy = 0.0;
+
+        for (int i = 0; i < hopSize; ++i)
+        {
+            const double x = samples [i];
+            const double y = c[0] * x + c[1] * s[0] + c[2] * s[1] - c[3] * s[2] - c[4] * s[3];
+            s[1] = s[0]; s[0] = x;
+            s[3] = s[2]; s[2] = y;
+
+            const double z = c[5] * y + c[6] * s[4] + c[7] * s[5] - c[8] * s[6] - c[9] * s[7];
+            s[5] = s[4]; s[4] = y;
+            s[7] = s[6]; s[6] = z;
+
+            energy += z * z;
+        }
+
+        hopEnergy += energy / hopSize;
+
+        // correlation with the first channel
+        if (ch == 0)
+        {
+            left = samples;
+        }
+        else
+        {
+            double lr = 0.0, ll = 0.0, rr = 0.0;
+
+            for (int i = 0; i < hopSize; ++i)
+            {
+                lr += left [i] * samples [i];
+                ll += left [i] * left [i];
+                rr += samples [i] * samples [i];
+            }
+
+            sumLR = sumLR * correlationDecay + lr;
+            sumLL = sumLL * correlationDecay + ll;
+            sumRR = sumRR * correlationDecay + rr;
+        }
+
+        // spectrum, summed as power until the next result
+        for (int i = 0; i < fftSize; ++i)
+            windowed [i] = h [i] * window [i];
+
+        fft.performForward (windowed, real, imag);
+
+        float* const power = spectrumSum + ch * AnalysisResults::numSpectrumBands;
+
+        for (int band = 0; band < AnalysisResults::numSpectrumBands; ++band)
+        {
+            float highest = 0.0f;
+
+            for (int bin = bandStart [band]; bin < bandEnd [band]; ++bin)
+                highest = jmax (highest, real [bin] * real [bin] + imag [bin] * imag [bin]);
+
+            power [band] += highest;
+        }
+    }
+
+    hopEnergies [hopEnergyIndex] = hopEnergy;
+    hopEnergyIndex = (hopEnergyIndex + 1) % numHopEnergies;
+
+    samplesSinceResult += hopSize;
+    samplesAnalysed += hopSize;
+
+    // publish at the display rate, not at every hop
+    const int hopsPerResult = jmax (1, roundDoubleToInt (sampleRate / (hopSize * resultsPerSecond)));
+
+    if (++hopsSinceResult < hopsPerResult)
+        return;
+
+    const float spectrumScale = windowGain * windowGain / hopsSinceResult;
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        pending.rms [ch] = (float) sqrt (squareSums [ch] / samplesSinceResult);
+
+        float* const power = spectrumSum + ch * AnalysisResults::numSpectrumBands;
+
+        for (int band = 0; band < AnalysisResults::numSpectrumBands; ++band)
+        {
+            const float p = power [band] * spectrumScale;
+
+            pending.spectrum [ch][band] = p > 1.0e-12f ? jmax (silenceDecibels, 10.0f * log10f (p))
+                                                       : silenceDecibels;
+            power [band] = 0.0f;
+        }
+    }
+
+    double energy = 0.0;
+    for (int i = 0; i < numHopEnergies; ++i)
+        energy += hopEnergies [i];
+
+    energy /= numHopEnergies;
+
+    pending.loudness = energy > 1.0e-12 ? jmax (silenceDecibels, (float) (-0.691 + 10.0 * log10 (energy)))
+                                        : silenceDecibels;
+
+    if (numChannels < 2)
+        pending.correlation = 1.0f;
+    else if (sumLL > 1.0e-12 && sumRR > 1.0e-12)
+        pending.correlation = (float) jlimit (-1.0, 1.0, sumLR / sqrt (sumLL * sumRR));
+    else
+        pending.correlation = 0.0f;
+
+    pending.samplesAnalysed = samplesAnalysed;
+
+    results.write (pending);
+
+    // and start holding the levels again
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        pending.peak [ch] = 0.0f;
+        squareSums [ch] = 0.0;
+    }
+
+    hopsSinceResult = samplesSinceResult = 0;
+}
+
+END_JUCE_NAMESPACE
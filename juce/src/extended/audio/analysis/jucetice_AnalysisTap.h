@@ -0,0 +1,217 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2009 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU General Public License, as published by the Free Software Foundation;
+ either version 2 of the License, or (at your option) any later version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+#ifndef __JUCETICE_ANALYSISTAP_HEADER__
+#define __JUCETICE_ANALYSISTAP_HEADER__
+
+#include "../../../audio/dsp/juce_AudioSampleBuffer.h"
+#include "../../../containers/juce_OwnedArray.h"
+#include "../../../threads/juce_CriticalSection.h"
+#include "../../containers/jucetice_LockFreeQueue.h"
+#include "../../containers/jucetice_TripleBuffer.h"
+#include "../fft/jucetice_RealFFT.h"
+
+
+//==============================================================================
+/**
+    What an AnalysisTap measured, as of its last result.
+
+    Levels are linear, the spectrum is in decibels relative to a full scale
+    sine, in bands spaced logarithmically from 20 Hz to the nyquist
+    frequency (or 20 kHz, whichever is lower).
+*/
+class AnalysisResults
+{
+public:
+
+    //==============================================================================
+    enum
+    {
+        maxChannels = 2,
+        numSpectrumBands = 96
+    };
+
+    //==============================================================================
+    AnalysisResults ()
+        : numChannels (0),
+          loudness (-120.0f),
+          correlation (1.0f),
+          samplesAnalysed (0)
+    {
+        for (int ch = 0; ch < maxChannels; ++ch)
+        {
+            peak [ch] = rms [ch] = 0.0f;
+
+            for (int i = 0; i < numSpectrumBands; ++i)
+                spectrum [ch][i] = -120.0f;
+        }
+    }
+
+    //==============================================================================
+    /** Returns the centre frequency of a spectrum band */
+    static float getBandFrequency (const int band, const double sampleRate);
+
+    //==============================================================================
+    int numChannels;
+
+    /** Highest absolute sample since the previous result */
+    float peak [maxChannels];
+
+    /** Root mean square since the previous result */
+    float rms [maxChannels];
+
+    /** Magnitude spectrum, averaged over the windows since the previous result */
+    float spectrum [maxChannels][numSpectrumBands];
+
+    /** Momentary loudness in LUFS: K-weighted, over the last 400 ms */
+    float loudness;
+
+    /** Correlation between the first two channels, from -1 to 1 */
+    float correlation;
+
+    /** How many samples were analysed since the tap was prepared */
+    int64 samplesAnalysed;
+};
+
+
+//==============================================================================
+/**
+    Lets the gui look at a signal without loading the audio thread.
+
+    The audio thread only copies its samples into a lock-free ring per
+    channel with pushSamples(), which never waits: when the ring is full the
+    samples are dropped and counted. A low priority worker shared by all the
+    taps takes them out a hop at a time and computes the spectrum, levels,
+    loudness and correlation, and every few hops publishes the results,
+    which a timer in the gui picks up with getLatestResults().
+
+    So any number of analyzers can run at once, and the ones the worker
+    can't keep up with just lose hops instead of glitching the audio.
+
+    @see AnalysisResults
+*/
+class AnalysisTap
+{
+public:
+
+    //==============================================================================
+    /** Creates a tap
+
+        @param numChannels  the number of channels to analyse, 1 or 2
+        @param fftSize      the window of the spectrum, a power of two
+        @param hopSize      how many samples the window moves between two
+                            analyses, at most fftSize
+    */
+    AnalysisTap (const int numChannels = 2,
+                 const int fftSize = 2048,
+                 const int hopSize = 512);
+
+    /** Destructor */
+    ~AnalysisTap ();
+
+    //==============================================================================
+    /** Sets the sample rate of what will be pushed, and forgets the past
+
+        Call this from the message thread, the audio thread can keep pushing.
+    */
+    void prepare (const double sampleRate);
+
+    /** Sets how many results are published each second, 30 by default
+
+        Between two results the levels are held and the spectra averaged.
+    */
+    void setResultsPerSecond (const int resultsPerSecond);
+
+    //==============================================================================
+    /** Copies the samples of a block into the rings
+
+        This is meant for the audio thread, and it never locks nor allocates.
+        Missing channels are taken from the last one of the buffer.
+    */
+    void pushSamples (const AudioSampleBuffer& buffer,
+                      const int startSample,
+                      const int numSamples);
+
+    //==============================================================================
+    /** Gets the newest results, returns false if there weren't new ones
+
+        Call this from a single thread, typically a gui timer.
+    */
+    bool getLatestResults (AnalysisResults& results);
+
+    /** Returns how many samples were lost because the worker was late */
+    int getNumSamplesDropped () const                   { return samplesDropped; }
+
+    /** Returns the sample rate passed to prepare */
+    double getSampleRate () const                       { return sampleRate; }
+
+    //==============================================================================
+    juce_UseDebuggingNewOperator
+
+private:
+
+    friend class AnalysisWorker;
+
+    const int numChannels, fftSize, hopSize;
+    double sampleRate;
+    volatile int resultsPerSecond;
+
+    OwnedArray <LockFreeQueue <float> > rings;
+    volatile int samplesDropped;
+
+    // used by the worker, under analysisLock
+    CriticalSection analysisLock;
+    RealFFT fft;
+    FFTBuffer window, history, windowed, real, imag;
+    HeapBlock <float> spectrumSum;
+    HeapBlock <int> bandStart, bandEnd;
+    float windowGain;
+
+    // the two K-weighting biquads of each channel, and the energy of the last hops
+    double kState [AnalysisResults::maxChannels][8];
+    double kCoefficients [10];
+    HeapBlock <double> hopEnergies;
+    int numHopEnergies, hopEnergyIndex;
+
+    double sumLR, sumLL, sumRR, correlationDecay;
+    double squareSums [AnalysisResults::maxChannels];
+    int hopsSinceResult, samplesSinceResult;
+    int64 samplesAnalysed;
+
+    AnalysisResults pending;
+    TripleBuffer <AnalysisResults> results;
+
+    bool isHopReady () const;
+    void analyseNextHop ();
+    void resetAnalysis ();
+
+    AnalysisTap (const AnalysisTap&);
+    const AnalysisTap& operator= (const AnalysisTap&);
+};
+
+
+#endif
@@ -32,14 +32,10 @@
 
 #include "../../../core/juce_StandardHeader.h"
 
-extern "C" {
-  #include "../../dependancies/kissfft/kiss_fft.c"
-  #include "../../dependancies/kissfft/kiss_fftr.c"
-}
-
 BEGIN_JUCE_NAMESPACE
 
 #include "jucetice_FFTWrapper.h"
+#include "jucetice_RealFFT.h"
 
 //==============================================================================
 class FFTWrapperImpl
@@ -47,72 +43,46 @@ class FFTWrapperImpl
 public:
 
     FFTWrapperImpl (int fftsize_)
+        : fftsize (fftsize_),
+          fft (fftsize_),
+          real (fftsize_ / 2 + 1),
+          imag (fftsize_ / 2 + 1)
     {
-        fftsize = fftsize_;
-
-        tmpfftdata1 = new kiss_fft_scalar [fftsize + 2];
-        tmpfftdata2 = new kiss_fft_cpx [fftsize + 2];
-
-        planfftw = kiss_fftr_alloc (fftsize, 0, NULL, NULL);
-        planfftw_inv = kiss_fftr_alloc (fftsize, 1, NULL, NULL);
-    }
-
-    ~FFTWrapperImpl()
-    {
-        free (planfftw);
-        free (planfftw_inv);
-
-        kiss_fft_cleanup();
-
-        delete[] tmpfftdata1;
-        delete[] tmpfftdata2;
     }
 
     forcedinline void smps2freqs (float *smps, FFTFrequencies freqs)
     {
-        for (int i = 0; i < fftsize; i++)
-            tmpfftdata1[i] = smps[i];
-
-        kiss_fftr (planfftw, tmpfftdata1, tmpfftdata2);
+        fft.performForward (smps, real, imag);
 
         for (int i = 0; i < fftsize / 2; i++)
         {
-            freqs.c[i] = tmpfftdata2[i].r;
+            freqs.c[i] = real[i];
             if (i != 0)
-                freqs.s[i] = tmpfftdata2[i].i;
+                freqs.s[i] = imag[i];
         }
-
-    //    tmpfftdata2[fftsize/2].r=0.0;
-    //    tmpfftdata2[fftsize/2].i=0.0;
     }
 
     forcedinline void freqs2smps (FFTFrequencies freqs, float *smps)
     {
-    //    tmpfftdata2[fftsize/2].r=0.0;
-    //    tmpfftdata2[fftsize/2].i=0.0;
-
         for (int i = 0; i < fftsize / 2; i++)
         {
-            tmpfftdata2[i].r = freqs.c[i];
-            if (i != 0)
-                tmpfftdata2[i].i = freqs.s[i];
+            real[i] = freqs.c[i];
+            imag[i] = (i != 0) ? freqs.s[i] : 0.0f;
         }
 
-        kiss_fftri (planfftw_inv, tmpfftdata2, tmpfftdata1);
+        real[fftsize / 2] = 0.0f;
+        imag[fftsize / 2] = 0.0f;
 
-        for (int i = 0; i < fftsize; i++)
-            smps[i] = tmpfftdata1[i];
+        fft.performInverse (real, imag, smps);
     }
 
 
 private:
 
-    int fftsize;
-
-    kiss_fft_scalar *tmpfftdata1;
-    kiss_fft_cpx *tmpfftdata2;
+    const int fftsize;
 
-    kiss_fftr_cfg planfftw, planfftw_inv;
+    RealFFT fft;
+    FFTBuffer real, imag;
 };
 
 
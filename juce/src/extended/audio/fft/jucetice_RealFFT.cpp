@@ -0,0 +1,606 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2009 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU General Public License, as published by the Free Software Foundation;
+ either version 2 of the License, or (at your option) any later version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+#include "../../../core/juce_StandardHeader.h"
+
+#if JUCE_INTEL && (JUCE_MSVC || defined (__SSE__))
+ #include <xmmintrin.h>
+ #define JUCETICE_REALFFT_USE_SSE 1
+#endif
+
+BEGIN_JUCE_NAMESPACE
+
+#include "jucetice_RealFFT.h"
+#include "../../../threads/juce_ScopedLock.h"
+#include "../../../core/juce_Singleton.h"
+#include "../../../utilities/juce_DeletedAtShutdown.h"
+
+
+//==============================================================================
+/** Rounds a length up to a whole number of simd vectors, so arrays packed
+    one after the other stay aligned */
+static inline int getPaddedLength (const int length)
+{
+    return (length + 3) & ~3;
+}
+
+//==============================================================================
+/**
+    The tables of a size, shared by all the RealFFT of that size.
+
+    The complex transform of half the size is done in stockham passes: each
+    radix 4 pass reads a sequence of n points with stride s and writes n / 4
+    butterflies of 4 points, so after the passes the output is in natural
+    order without a bit reversal. The twiddles of each pass are stored as six
+    padded arrays, the real and imaginary parts of w^p, w^2p and w^3p.
+*/
+class RealFFTPlan
+{
+public:
+
+    RealFFTPlan (const int size)
+        : half (size / 2)
+    {
+        int total = 0;
+        for (int n = half; n >= 4; n /= 4)
+            total += 6 * getPaddedLength (n / 4);
+
+        twiddles.setSize (total);
+
+        float* w = twiddles;
+
+        for (int n = half; n >= 4; n /= 4)
+        {
+            const int n1 = n / 4;
+            const int stride = getPaddedLength (n1);
+
+            for (int p = 0; p < n1; ++p)
+            {
+                for (int k = 1; k <= 3; ++k)
+                {
+                    const double angle = -2.0 * double_Pi * k * p / n;
+
+                    w [(k - 1) * 2 * stride + p] = (float) cos (angle);
+                    w [((k - 1) * 2 + 1) * stride + p] = (float) sin (angle);
+                }
+            }
+
+            w += 6 * stride;
+        }
+
+        // used to split the half size transform into the real spectrum
+        postCos.setSize (half / 2 + 1);
+        postSin.setSize (half / 2 + 1);
+
+        for (int k = 0; k <= half / 2; ++k)
+        {
+            const double angle = double_Pi * k / half;
+
+            postCos [k] = (float) cos (angle);
+            postSin [k] = (float) sin (angle);
+        }
+    }
+
+    //==============================================================================
+    /** Does the forward complex transform of half points
+
+        The result ends in either the input or the temporary arrays, and the
+        pointers are updated to where it is.
+    */
+    void performComplex (float*& re, float*& im, float* tempRe, float* tempIm) const
+    {
+        const float* w = twiddles;
+        int n = half, s = 1;
+
+        while (n >= 4)
+        {
+            const int n1 = n / 4;
+            const int stride = getPaddedLength (n1);
+
+            performRadix4Pass (re, im, tempRe, tempIm, w, stride, n1, s);
+
+            swapVariables (re, tempRe);
+            swapVariables (im, tempIm);
+
+            w += 6 * stride;
+            n = n1;
+            s *= 4;
+        }
+
+        if (n == 2)
+        {
+            performRadix2Pass (re, im, tempRe, tempIm, s);
+
+            swapVariables (re, tempRe);
+            swapVariables (im, tempIm);
+        }
+    }
+
+    const int half;
+    FFTBuffer twiddles, postCos, postSin;
+
+    juce_UseDebuggingNewOperator
+
+private:
+
+    //==============================================================================
+    static void performRadix4Pass (const float* xr, const float* xi, float* yr, float* yi,
+                                   const float* w, const int stride, const int n1, const int s)
+    {
+        const float* const w1r = w;
+        const float* const w1i = w + stride;
+        const float* const w2r = w + stride * 2;
+        const float* const w2i = w + stride * 3;
+        const float* const w3r = w + stride * 4;
+        const float* const w3i = w + stride * 5;
+        const int sn1 = s * n1;
+
+#if JUCETICE_REALFFT_USE_SSE
+        if (s >= 4)
+        {
+            // the s interleaved sequences are contiguous, so go 4 of them at a time
+            for (int p = 0; p < n1; ++p)
+            {
+                const __m128 c1r = _mm_set1_ps (w1r [p]), c1i = _mm_set1_ps (w1i [p]);
+                const __m128 c2r = _mm_set1_ps (w2r [p]), c2i = _mm_set1_ps (w2i [p]);
+                const __m128 c3r = _mm_set1_ps (w3r [p]), c3i = _mm_set1_ps (w3i [p]);
+
+                const float* const ar = xr + s * p;
+                const float* const ai = xi + s * p;
+                float* const y0r = yr + s * 4 * p;
+                float* const y0i = yi + s * 4 * p;
+
+                for (int q = 0; q < s; q += 4)
+                {
+                    const __m128 are = _mm_load_ps (ar + q),           aim = _mm_load_ps (ai + q);
+                    const __m128 bre = _mm_load_ps (ar + q + sn1),     bim = _mm_load_ps (ai + q + sn1);
+                    const __m128 cre = _mm_load_ps (ar + q + sn1 * 2), cim = _mm_load_ps (ai + q + sn1 * 2);
+                    const __m128 dre = _mm_load_ps (ar + q + sn1 * 3), dim = _mm_load_ps (ai + q + sn1 * 3);
+
+                    const __m128 apcr = _mm_add_ps (are, cre), apci = _mm_add_ps (aim, cim);
+                    const __m128 amcr = _mm_sub_ps (are, cre), amci = _mm_sub_ps (aim, cim);
+                    const __m128 bpdr = _mm_add_ps (bre, dre), bpdi = _mm_add_ps (bim, dim);
+                    const __m128 bmdr = _mm_sub_ps (bre, dre), bmdi = _mm_sub_ps (bim, dim);
+
+                    _mm_store_ps (y0r + q, _mm_add_ps (apcr, bpdr));
+                    _mm_store_ps (y0i + q, _mm_add_ps (apci, bpdi));
+
+                    const __m128 t1r = _mm_add_ps (amcr, bmdi), t1i = _mm_sub_ps (amci, bmdr);
+                    _mm_store_ps (y0r + q + s, _mm_sub_ps (_mm_mul_ps (c1r, t1r), _mm_mul_ps (c1i, t1i)));
+                    _mm_store_ps (y0i + q + s, _mm_add_ps (_mm_mul_ps (c1r, t1i), _mm_mul_ps (c1i, t1r)));
+
+                    const __m128 t2r = _mm_sub_ps (apcr, bpdr), t2i = _mm_sub_ps (apci, bpdi);
+                    _mm_store_ps (y0r + q + s * 2, _mm_sub_ps (_mm_mul_ps (c2r, t2r), _mm_mul_ps (c2i, t2i)));
+                    _mm_store_ps (y0i + q + s * 2, _mm_add_ps (_mm_mul_ps (c2r, t2i), _mm_mul_ps (c2i, t2r)));
+
+                    const __m128 t3r = _mm_sub_ps (amcr, bmdi), t3i = _mm_add_ps (amci, bmdr);
+                    _mm_store_ps (y0r + q + s * 3, _mm_sub_ps (_mm_mul_ps (c3r, t3r), _mm_mul_ps (c3i, t3i)));
+                    _mm_store_ps (y0i + q + s * 3, _mm_add_ps (_mm_mul_ps (c3r, t3i), _mm_mul_ps (c3i, t3r)));
+                }
+            }
+
+            return;
+        }
+
+        if (s == 1 && n1 >= 4)
+        {
+            // the first pass: go 4 butterflies at a time, and transpose them
+            // so each butterfly writes its 4 points next to each other
+            for (int p = 0; p < n1; p += 4)
+            {
+                const __m128 are = _mm_load_ps (xr + p),          aim = _mm_load_ps (xi + p);
+                const __m128 bre = _mm_load_ps (xr + p + n1),     bim = _mm_load_ps (xi + p + n1);
+                const __m128 cre = _mm_load_ps (xr + p + n1 * 2), cim = _mm_load_ps (xi + p + n1 * 2);
+                const __m128 dre = _mm_load_ps (xr + p + n1 * 3), dim = _mm_load_ps (xi + p + n1 * 3);
+
+                const __m128 apcr = _mm_add_ps (are, cre), apci = _mm_add_ps (aim, cim);
+                const __m128 amcr = _mm_sub_ps (are, cre), amci = _mm_sub_ps (aim, cim);
+                const __m128 bpdr = _mm_add_ps (bre, dre), bpdi = _mm_add_ps (bim, dim);
+                const __m128 bmdr = _mm_sub_ps (bre, dre), bmdi = _mm_sub_ps (bim, dim);
+
+                const __m128 c1r = _mm_load_ps (w1r + p), c1i = _mm_load_ps (w1i + p);
+                const __m128 c2r = _mm_load_ps (w2r + p), c2i = _mm_load_ps (w2i + p);
+                const __m128 c3r = _mm_load_ps (w3r + p), c3i = _mm_load_ps (w3i + p);
+
+                const __m128 t1r = _mm_add_ps (amcr, bmdi), t1i = _mm_sub_ps (amci, bmdr);
+                const __m128 t2r = _mm_sub_ps (apcr, bpdr), t2i = _mm_sub_ps (apci, bpdi);
+                const __m128 t3r = _mm_sub_ps (amcr, bmdi), t3i = _mm_add_ps (amci, bmdr);
+
+                __m128 r0 = _mm_add_ps (apcr, bpdr);
+                __m128 r1 = _mm_sub_ps (_mm_mul_ps (c1r, t1r), _mm_mul_ps (c1i, t1i));
+                __m128 r2 = _mm_sub_ps (_mm_mul_ps (c2r, t2r), _mm_mul_ps (c2i, t2i));
+                __m128 r3 = _mm_sub_ps (_mm_mul_ps (c3r, t3r), _mm_mul_ps (c3i, t3i));
+
+                __m128 i0 = _mm_add_ps (apci, bpdi);
+                __m128 i1 = _mm_add_ps (_mm_mul_ps (c1r, t1i), _mm_mul_ps (c1i, t1r));
+                __m128 i2 = _mm_add_ps (_mm_mul_ps (c2r, t2i), _mm_mul_ps (c2i, t2r));
+                __m128 i3 = _mm_add_ps (_mm_mul_ps (c3r, t3i), _mm_mul_ps (c3i, t3r));
+
+                _MM_TRANSPOSE4_PS (r0, r1, r2, r3);
+                _MM_TRANSPOSE4_PS (i0, i1, i2, i3);
+
+                float* const outr = yr + p * 4;
+                float* const outi = yi + p * 4;
+
+                _mm_store_ps (outr, r0);      _mm_store_ps (outi, i0);
+                _mm_store_ps (outr + 4, r1);  _mm_store_ps (outi + 4, i1);
+                _mm_store_ps (outr + 8, r2);  _mm_store_ps (outi + 8, i2);
+                _mm_store_ps (outr + 12, r3); _mm_store_ps (outi + 12, i3);
+            }
+
+            return;
+        }
+#endif
+
+        for (int p = 0; p < n1; ++p)
+        {
+            const float c1r = w1r [p], c1i = w1i [p];
+            const float c2r = w2r [p], c2i = w2i [p];
+            const float c3r = w3r [p], c3i = w3i [p];
+
+            for (int q = 0; q < s; ++q)
+            {
+                const int i = q + s * p;
+                const int o = q + s * 4 * p;
+
+                const float apcr = xr [i] + xr [i + sn1 * 2], apci = xi [i] + xi [i + sn1 * 2];
+                const float amcr = xr [i] - xr [i + sn1 * 2], amci = xi [i] - xi [i + sn1 * 2];
+                const float bpdr = xr [i + sn1] + xr [i + sn1 * 3], bpdi = xi [i + sn1] + xi [i + sn1 * 3];
+                const float bmdr = xr [i + sn1] - xr [i + sn1 * 3], bmdi = xi [i + sn1] - xi [i + sn1 * 3];
+
+                yr [o] = apcr + bpdr;
+                yi [o] = apci + bpdi;
+
+                const float t1r = amcr + bmdi, t1i = amci - bmdr;
+                yr [o + s] = c1r * t1r - c1i * t1i;
+                yi [o + s] = c1r * t1i + c1i * t1r;
+
+                const float t2r = apcr - bpdr, t2i = apci - bpdi;
+                yr [o + s * 2] = c2r * t2r - c2i * t2i;
+                yi [o + s * 2] = c2r * t2i + c2i * t2r;
+
+                const float t3r = amcr - bmdi, t3i = amci + bmdr;
+                yr [o + s * 3] = c3r * t3r - c3i * t3i;
+                yi [o + s * 3] = c3r * t3i + c3i * t3r;
+            }
+        }
+    }
+
+    static void performRadix2Pass (const float* xr, const float* xi, float* yr, float* yi, const int s)
+    {
+        int q = 0;
+
+#if JUCETICE_REALFFT_USE_SSE
+        for (; q + 4 <= s; q += 4)
+        {
+            const __m128 are = _mm_load_ps (xr + q),     aim = _mm_load_ps (xi + q);
+            const __m128 bre = _mm_load_ps (xr + q + s), bim = _mm_load_ps (xi + q + s);
+
+            _mm_store_ps (yr + q, _mm_add_ps (are, bre));
+            _mm_store_ps (yi + q, _mm_add_ps (aim, bim));
+            _mm_store_ps (yr + q + s, _mm_sub_ps (are, bre));
+            _mm_store_ps (yi + q + s, _mm_sub_ps (aim, bim));
+        }
+#endif
+
+        for (; q < s; ++q)
+        {
+            const float ar = xr [q], ai = xi [q];
+            const float br = xr [q + s], bi = xi [q + s];
+
+            yr [q] = ar + br;
+            yi [q] = ai + bi;
+            yr [q + s] = ar - br;
+            yi [q + s] = ai - bi;
+        }
+    }
+
+    RealFFTPlan (const RealFFTPlan&);
+    const RealFFTPlan& operator= (const RealFFTPlan&);
+};
+
+
+//==============================================================================
+/**
+    Keeps the tables of each size, from their first use to the shutdown.
+
+    The batched transforms of a size use the tables of twice that size, for
+    a complex transform of size points, so there is room for one more.
+*/
+class RealFFTPlanCache : public DeletedAtShutdown
+{
+public:
+
+    RealFFTPlanCache ()
+    {
+        zeromem (plans, sizeof (plans));
+    }
+
+    ~RealFFTPlanCache ()
+    {
+        for (int i = 0; i < numElementsInArray (plans); ++i)
+            deleteAndZero (plans [i]);
+
+        clearSingletonInstance();
+    }
+
+    const RealFFTPlan* getPlan (const int size)
+    {
+        int order = 0;
+        while ((1 << order) < size)
+            ++order;
+
+        jassert (order < numElementsInArray (plans));
+
+        const ScopedLock sl (lock);
+
+        if (plans [order] == 0)
+            plans [order] = new RealFFTPlan (1 << order);
+
+        return plans [order];
+    }
+
+    juce_DeclareSingleton (RealFFTPlanCache, false)
+
+private:
+
+    CriticalSection lock;
+    RealFFTPlan* plans [18];
+
+    RealFFTPlanCache (const RealFFTPlanCache&);
+    const RealFFTPlanCache& operator= (const RealFFTPlanCache&);
+};
+
+juce_ImplementSingleton (RealFFTPlanCache)
+
+
+//==============================================================================
+RealFFT::RealFFT (const int size_)
+    : size (size_),
+      plan (RealFFTPlanCache::getInstance()->getPlan (size_)),
+      pairPlan (RealFFTPlanCache::getInstance()->getPlan (size_ * 2)),
+      workspace (getPaddedLength (size_) * 4)
+{
+    // only powers of two are supported
+    jassert (size_ >= 2 && size_ <= 65536 && (size_ & (size_ - 1)) == 0);
+}
+
+RealFFT::~RealFFT ()
+{
+}
+
+//==============================================================================
+void RealFFT::performForward (const float* input, float* real, float* imag)
+{
+    const int half = plan->half;
+    const int padded = getPaddedLength (half);
+
+    float* zr = workspace;
+    float* zi = zr + padded;
+
+    // the even samples are the real parts of the half size sequence, the odd ones the imaginary
+    int k = 0;
+
+#if JUCETICE_REALFFT_USE_SSE
+    for (; k + 4 <= half; k += 4)
+    {
+        const __m128 a = _mm_loadu_ps (input + k * 2);
+        const __m128 b = _mm_loadu_ps (input + k * 2 + 4);
+
+        _mm_store_ps (zr + k, _mm_shuffle_ps (a, b, _MM_SHUFFLE (2, 0, 2, 0)));
+        _mm_store_ps (zi + k, _mm_shuffle_ps (a, b, _MM_SHUFFLE (3, 1, 3, 1)));
+    }
+#endif
+
+    for (; k < half; ++k)
+    {
+        zr [k] = input [k * 2];
+        zi [k] = input [k * 2 + 1];
+    }
+
+    plan->performComplex (zr, zi, zr + padded * 2, zr + padded * 3);
+
+    // then split it into the spectra of the even and odd samples, and recombine them
+    const float* const cosines = plan->postCos;
+    const float* const sines = plan->postSin;
+
+    real [0] = zr [0] + zi [0];
+    imag [0] = 0.0f;
+    real [half] = zr [0] - zi [0];
+    imag [half] = 0.0f;
+
+    for (k = 1; k <= half / 2; ++k)
+    {
+        const float zkr = zr [k], zki = zi [k];
+        const float zcr = zr [half - k], zci = -zi [half - k];
+
+        const float evenr = 0.5f * (zkr + zcr), eveni = 0.5f * (zki + zci);
+        const float oddr = 0.5f * (zki - zci), oddi = -0.5f * (zkr - zcr);
+
+        const float c = cosines [k], s = sines [k];
+        const float wr = c * oddr + s * oddi;
+        const float wi = c * oddi - s * oddr;
+
+        real [k] = evenr + wr;
+        imag [k] = eveni + wi;
+        real [half - k] = evenr - wr;
+        imag [half - k] = wi - eveni;
+    }
+}
+
+void RealFFT::performInverse (const float* real, const float* imag, float* output)
+{
+    const int half = plan->half;
+    const int padded = getPaddedLength (half);
+
+    float* zr = workspace;
+    float* zi = zr + padded;
+
+    // merge the spectrum back into the one of a half size complex sequence
+    const float* const cosines = plan->postCos;
+    const float* const sines = plan->postSin;
+
+    zr [0] = real [0] + real [half];
+    zi [0] = real [0] - real [half];
+
+    for (int k = 1; k <= half / 2; ++k)
+    {
+        const float xkr = real [k], xki = imag [k];
+        const float xcr = real [half - k], xci = -imag [half - k];
+
+        const float evenr = xkr + xcr, eveni = xki + xci;
+        const float dr = xkr - xcr, di = xki - xci;
+
+        const float c = cosines [k], s = sines [k];
+        const float oddr = dr * c - di * s;
+        const float oddi = dr * s + di * c;
+
+        zr [k] = evenr - oddi;
+        zi [k] = eveni + oddr;
+        zr [half - k] = evenr + oddi;
+        zi [half - k] = oddr - eveni;
+    }
+
+    // an inverse transform is a forward one with real and imaginary parts swapped
+    float* outr = zi;
+    float* outi = zr;
+    plan->performComplex (outr, outi, zr + padded * 2, zr + padded * 3);
+
+    int k = 0;
+
+#if JUCETICE_REALFFT_USE_SSE
+    for (; k + 4 <= half; k += 4)
+    {
+        const __m128 re = _mm_load_ps (outi + k);
+        const __m128 im = _mm_load_ps (outr + k);
+
+        _mm_storeu_ps (output + k * 2, _mm_unpacklo_ps (re, im));
+        _mm_storeu_ps (output + k * 2 + 4, _mm_unpackhi_ps (re, im));
+    }
+#endif
+
+    for (; k < half; ++k)
+    {
+        output [k * 2] = outi [k];
+        output [k * 2 + 1] = outr [k];
+    }
+}
+
+//==============================================================================
+void RealFFT::performForward (const float* const* inputs,
+                              float* const* reals,
+                              float* const* imags,
+                              const int numChannels)
+{
+    int i = 0;
+
+    for (; i + 2 <= numChannels; i += 2)
+        performForwardPair (inputs [i], inputs [i + 1], reals [i], imags [i], reals [i + 1], imags [i + 1]);
+
+    if (i < numChannels)
+        performForward (inputs [i], reals [i], imags [i]);
+}
+
+void RealFFT::performInverse (const float* const* reals,
+                              const float* const* imags,
+                              float* const* outputs,
+                              const int numChannels)
+{
+    int i = 0;
+
+    for (; i + 2 <= numChannels; i += 2)
+        performInversePair (reals [i], imags [i], reals [i + 1], imags [i + 1], outputs [i], outputs [i + 1]);
+
+    if (i < numChannels)
+        performInverse (reals [i], imags [i], outputs [i]);
+}
+
+void RealFFT::performForwardPair (const float* input1, const float* input2,
+                                  float* real1, float* imag1, float* real2, float* imag2)
+{
+    const int padded = getPaddedLength (size);
+
+    float* zr = workspace;
+    float* zi = zr + padded;
+
+    memcpy (zr, input1, sizeof (float) * size);
+    memcpy (zi, input2, sizeof (float) * size);
+
+    pairPlan->performComplex (zr, zi, zr + padded * 2, zr + padded * 3);
+
+    // the spectrum of the real part is the even part of z, the one of the
+    // imaginary part is the odd part divided by i
+    real1 [0] = zr [0];
+    imag1 [0] = 0.0f;
+    real2 [0] = zi [0];
+    imag2 [0] = 0.0f;
+
+    for (int k = 1; k <= size / 2; ++k)
+    {
+        const float zkr = zr [k], zki = zi [k];
+        const float zcr = zr [size - k], zci = zi [size - k];
+
+        real1 [k] = 0.5f * (zkr + zcr);
+        imag1 [k] = 0.5f * (zki - zci);
+        real2 [k] = 0.5f * (zki + zci);
+        imag2 [k] = 0.5f * (zcr - zkr);
+    }
+}
+
+void RealFFT::performInversePair (const float* real1, const float* imag1, const float* real2, const float* imag2,
+                                  float* output1, float* output2)
+{
+    const int half = size / 2;
+    const int padded = getPaddedLength (size);
+
+    float* zr = workspace;
+    float* zi = zr + padded;
+
+    // z = x1 + i x2, with the upper bins rebuilt from the symmetry of real signals
+    zr [0] = real1 [0];
+    zi [0] = real2 [0];
+    zr [half] = real1 [half];
+    zi [half] = real2 [half];
+
+    for (int k = 1; k < half; ++k)
+    {
+        zr [k] = real1 [k] - imag2 [k];
+        zi [k] = imag1 [k] + real2 [k];
+        zr [size - k] = real1 [k] + imag2 [k];
+        zi [size - k] = real2 [k] - imag1 [k];
+    }
+
+    // an inverse transform is a forward one with real and imaginary parts swapped
+    float* outr = zi;
+    float* outi = zr;
+    pairPlan->performComplex (outr, outi, zr + padded * 2, zr + padded * 3);
+
+    memcpy (output1, outi, sizeof (float) * size);
+    memcpy (output2, outr, sizeof (float) * size);
+}
+
+END_JUCE_NAMESPACE
@@ -0,0 +1,184 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2009 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU General Public License, as published by the Free Software Foundation;
+ either version 2 of the License, or (at your option) any later version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+#ifndef __JUCETICE_REALFFT_HEADER__
+#define __JUCETICE_REALFFT_HEADER__
+
+#include "../../../containers/juce_HeapBlock.h"
+
+class RealFFTPlan;
+
+
+//==============================================================================
+/**
+    A block of floats aligned for simd loads and stores.
+
+    The contents are cleared when it is allocated.
+*/
+class FFTBuffer
+{
+public:
+
+    //==============================================================================
+    /** Creates an empty buffer */
+    FFTBuffer ()
+        : data (0), size (0)
+    {
+    }
+
+    /** Creates a buffer of a number of floats */
+    FFTBuffer (const int numFloats)
+        : data (0), size (0)
+    {
+        setSize (numFloats);
+    }
+
+    //==============================================================================
+    /** Reallocates the buffer, losing its contents */
+    void setSize (const int numFloats)
+    {
+        storage.calloc (jmax (1, numFloats) + alignment / sizeof (float));
+
+        data = (float*) ((((pointer_sized_int) (float*) storage) + alignment - 1) & ~(pointer_sized_int) (alignment - 1));
+        size = numFloats;
+    }
+
+    /** Returns the number of floats */
+    int getSize () const                                { return size; }
+
+    /** Returns the aligned data */
+    float* getData () const                             { return data; }
+
+    operator float* () const                            { return data; }
+
+    //==============================================================================
+    juce_UseDebuggingNewOperator
+
+private:
+
+    enum { alignment = 16 };
+
+    HeapBlock <float> storage;
+    float* data;
+    int size;
+
+    FFTBuffer (const FFTBuffer&);
+    const FFTBuffer& operator= (const FFTBuffer&);
+};
+
+
+//==============================================================================
+/**
+    Fast fourier transform of real signals, for power of two sizes.
+
+    The transform is done as a complex one of half the size, with radix 4
+    stockham passes (and a radix 2 one for odd powers) that need no bit
+    reversal, vectorised with sse where available.
+
+    The tables for each size are computed once and shared by all the
+    instances in the process, so creating one is cheap after the first of a
+    size, while each instance has its own aligned workspace: an instance
+    can't be used by two threads at the same time, two instances can.
+
+    The spectrum is in split form, with the real and imaginary parts of the
+    bins from 0 to size / 2 in two arrays of size / 2 + 1 floats. Neither
+    direction is scaled, so a forward and inverse pass multiply a signal by
+    the size, like in kissfft and fftw.
+
+    The transforms never allocate, so they can be used in the audio thread.
+*/
+class RealFFT
+{
+public:
+
+    //==============================================================================
+    /** Creates a transform of a power of two size, from 2 to 65536 */
+    RealFFT (const int size);
+
+    /** Destructor */
+    ~RealFFT ();
+
+    //==============================================================================
+    /** Returns the number of time domain samples */
+    int getSize () const                                { return size; }
+
+    /** Returns the number of bins in the spectrum, size / 2 + 1 */
+    int getNumBins () const                             { return size / 2 + 1; }
+
+    //==============================================================================
+    /** Transforms size samples into getNumBins() real and imaginary parts */
+    void performForward (const float* input, float* real, float* imag);
+
+    /** Transforms getNumBins() real and imaginary parts into size samples
+
+        The imaginary parts of the first and last bin are ignored.
+    */
+    void performInverse (const float* real, const float* imag, float* output);
+
+    //==============================================================================
+    /** Transforms a set of channels, with the same results as performForward
+
+        The channels are taken two at a time, as the real and imaginary parts
+        of one complex transform of size points, whose spectrum is then split
+        into the two real ones. An odd channel left over is done on its own.
+    */
+    void performForward (const float* const* inputs,
+                         float* const* reals,
+                         float* const* imags,
+                         const int numChannels);
+
+    /** Transforms a set of channels back, with the same results as performInverse
+
+        Like the forward one, the channels are merged in pairs into one
+        complex spectrum, and rebuilt by a single complex transform.
+    */
+    void performInverse (const float* const* reals,
+                         const float* const* imags,
+                         float* const* outputs,
+                         const int numChannels);
+
+    //==============================================================================
+    juce_UseDebuggingNewOperator
+
+private:
+
+    const int size;
+    const RealFFTPlan* const plan;
+    const RealFFTPlan* const pairPlan;
+    FFTBuffer workspace;
+
+    void performForwardPair (const float* input1, const float* input2,
+                             float* real1, float* imag1, float* real2, float* imag2);
+    void performInversePair (const float* real1, const float* imag1, const float* real2, const float* imag2,
+                             float* output1, float* output2);
+
+    RealFFT (const RealFFT&);
+    const RealFFT& operator= (const RealFFT&);
+};
+
+
+#endif
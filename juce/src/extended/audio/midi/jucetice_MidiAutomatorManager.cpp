@@ -561,5 +561,58 @@ bool MidiAutomatorManager::handleMidiMessageBuffer (MidiBuffer& buffer)
     return messageWasHandled;
 }
 
+int MidiAutomatorManager::handleMidiMessageBufferSlice (MidiBuffer& buffer,
+                                                        const int startSample,
+                                                        const int endSample,
+                                                        const int minimumSliceSize)
+{
+    int samplePosition;
+    MidiMessage message (0xf4);
+    MidiBuffer::Iterator it (buffer);
+
+    // a tail shorter than a slice is merged in this one
+    int mergeEnd = startSample + jmax (1, minimumSliceSize);
+    if (endSample - mergeEnd < minimumSliceSize)
+        mergeEnd = endSample;
+
+    if (startSample > 0)
+        it.setNextSamplePosition (startSample);
+
+    while (it.getNextEvent (message, samplePosition))
+    {
+        // the last slice also takes the events past the end, as handleMidiMessageBuffer does
+        if (samplePosition < mergeEnd || mergeEnd >= endSample)
+        {
+            handleMidiMessage (message);
+        }
+        else if (isMessageAutomated (message))
+        {
+            // keep the remaining slice at least minimumSliceSize long
+            return jmax (mergeEnd, jmin (samplePosition, endSample - minimumSliceSize));
+        }
+    }
+
+    return endSample;
+}
+
+bool MidiAutomatorManager::isMessageAutomated (const MidiMessage& message) const
+{
+    if (message.isController ())
+    {
+        return activeLearner != 0
+               || ! controllers.getUnchecked (message.getControllerNumber ())->empty ();
+    }
+    else if (message.isNoteOnOrOff ())
+    {
+        if (activeLearner != 0)
+            return true;
+
+        const Array<TriggerValBindingMap*>& maps = message.isNoteOn () ? notes : noteOffs;
+        return ! maps.getUnchecked (message.getNoteNumber ())->empty ();
+    }
+
+    return false;
+}
+
 END_JUCE_NAMESPACE
 
@@ -288,6 +288,26 @@ public:
     /** Convenience function that handle multiple midi messages */
     bool handleMidiMessageBuffer (MidiBuffer& buffer);
 
+    /** Handle the automation of a slice of a block, for sample accurate automation
+
+        The events from startSample up to the first automation event at least
+        minimumSliceSize samples later are handled, and the position of that
+        event is returned, so the caller can process the slice in between and
+        call this again from there. When there are no more automation events,
+        endSample is returned.
+
+        Events closer than minimumSliceSize are merged with the slice before, so
+        no slice is shorter than that (unless the whole block is), which bounds
+        the overhead of splitting the processing.
+    */
+    int handleMidiMessageBufferSlice (MidiBuffer& buffer,
+                                      const int startSample,
+                                      const int endSample,
+                                      const int minimumSliceSize);
+
+    /** Returns true if a message would change something when handled */
+    bool isMessageAutomated (const MidiMessage& message) const;
+
 protected:
 
     friend class MidiAutomatable;
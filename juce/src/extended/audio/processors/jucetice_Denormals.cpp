@@ -0,0 +1,180 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2009 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU General Public License, as published by the Free Software Foundation;
+ either version 2 of the License, or (at your option) any later version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+
+#include "../../../core/juce_StandardHeader.h"
+
+#if JUCE_INTEL && (JUCE_MSVC || defined (__SSE__))
+ #include <xmmintrin.h>
+ #define JUCETICE_DENORMALS_USE_SSE 1
+ #if JUCE_MSVC || defined (__SSE2__)
+  #include <emmintrin.h>
+  #define JUCETICE_DENORMALS_USE_SSE2 1
+ #endif
+#endif
+
+BEGIN_JUCE_NAMESPACE
+
+#include "jucetice_Denormals.h"
+
+//==============================================================================
+#define JUCETICE_MXCSR_FTZ      0x8000
+#define JUCETICE_MXCSR_DAZ      0x0040
+
+#if JUCETICE_DENORMALS_USE_SSE
+/*
+    Setting a bit of mxcsr the cpu doesn't have raises a general protection fault,
+    and DAZ is missing on the first sse cpus. Every x86_64 cpu has it, elsewhere
+    the MXCSR_MASK that fxsave stores says if it's there (zero means the default
+    mask, which hasn't got DAZ).
+*/
+static unsigned int getFlushToZeroBits ()
+{
+#if JUCE_64BIT
+    return JUCETICE_MXCSR_FTZ | JUCETICE_MXCSR_DAZ;
+#else
+    static unsigned int flushBits = 0;
+
+    if (flushBits == 0)
+    {
+        char buffer [512 + 16];
+        zeromem (buffer, sizeof (buffer));
+
+        // fxsave needs a 16 byte aligned area
+        char* const area = (char*) ((((pointer_sized_int) buffer) + 15) & ~(pointer_sized_int) 15);
+
+ #if JUCE_MSVC
+        __asm
+        {
+            mov eax, area
+            fxsave [eax]
+        }
+ #else
+        asm volatile ("fxsave %0" : "=m" (*(char (*)[512]) area));
+ #endif
+
+        const uint32 mxcsrMask = *(const uint32*) (area + 28);
+
+        flushBits = JUCETICE_MXCSR_FTZ | (mxcsrMask & JUCETICE_MXCSR_DAZ);
+    }
+
+    return flushBits;
+#endif
+}
+#endif
+
+//==============================================================================
+bool Denormals::isFlushingSupported ()
+{
+#if JUCETICE_DENORMALS_USE_SSE
+    return true;
+#else
+    return false;
+#endif
+}
+
+unsigned int Denormals::getState ()
+{
+#if JUCETICE_DENORMALS_USE_SSE
+    return _mm_getcsr ();
+#else
+    return 0;
+#endif
+}
+
+void Denormals::setState (const unsigned int state)
+{
+#if JUCETICE_DENORMALS_USE_SSE
+    if (_mm_getcsr () != state)
+        _mm_setcsr (state);
+#endif
+}
+
+void Denormals::setFlushToZero (const bool shouldFlush)
+{
+#if JUCETICE_DENORMALS_USE_SSE
+    const unsigned int state = getState ();
+
+    if (shouldFlush)
+        setState (state | getFlushToZeroBits ());
+    else
+        setState (state & ~getFlushToZeroBits ());
+#endif
+}
+
+bool Denormals::isFlushingToZero ()
+{
+#if JUCETICE_DENORMALS_USE_SSE
+    return (getState () & JUCETICE_MXCSR_FTZ) != 0;
+#else
+    return false;
+#endif
+}
+
+//==============================================================================
+int Denormals::countDenormals (const float* samples, const int numSamples)
+{
+    // a denormal has all exponent bits cleared, but not the mantissa
+    const uint32 exponentMask = 0x7f800000;
+    const uint32 mantissaMask = 0x007fffff;
+
+    int i = 0, count = 0;
+
+#if JUCETICE_DENORMALS_USE_SSE2
+    const __m128i exponents = _mm_set1_epi32 (exponentMask);
+    const __m128i mantissas = _mm_set1_epi32 (mantissaMask);
+    const __m128i zero = _mm_setzero_si128 ();
+    __m128i counts = zero;
+
+    for (; i + 4 <= numSamples; i += 4)
+    {
+        const __m128i bits = _mm_castps_si128 (_mm_loadu_ps (samples + i));
+
+        const __m128i isTiny = _mm_cmpeq_epi32 (_mm_and_si128 (bits, exponents), zero);
+        const __m128i isZero = _mm_cmpeq_epi32 (_mm_and_si128 (bits, mantissas), zero);
+
+        // lanes are all ones (-1) where a denormal is found
+        counts = _mm_sub_epi32 (counts, _mm_andnot_si128 (isZero, isTiny));
+    }
+
+    int lanes [4];
+    _mm_storeu_si128 ((__m128i*) lanes, counts);
+    count = lanes [0] + lanes [1] + lanes [2] + lanes [3];
+#endif
+
+    const uint32* bits = (const uint32*) samples;
+
+    for (; i < numSamples; ++i)
+    {
+        if ((bits [i] & exponentMask) == 0 && (bits [i] & mantissaMask) != 0)
+            ++count;
+    }
+
+    return count;
+}
+
+END_JUCE_NAMESPACE
@@ -0,0 +1,110 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2009 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU General Public License, as published by the Free Software Foundation;
+ either version 2 of the License, or (at your option) any later version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+
+#ifndef __JUCETICE_DENORMALS_HEADER__
+#define __JUCETICE_DENORMALS_HEADER__
+
+
+//==============================================================================
+/**
+    Control over denormal numbers handling of the floating point unit.
+
+    Denormals are very small numbers that can appear in the tails of recursive
+    filters and reverbs, and that are processed by the cpu in microcode, taking
+    tens of times more than a normal number. On sse capable cpus we can ask the
+    hardware to flush them to zero (FTZ) and to treat denormal inputs as zero
+    (DAZ): this is a per thread setting, so it should be done in every thread
+    doing audio processing.
+*/
+class Denormals
+{
+public:
+
+    //==============================================================================
+    /** Returns true if this build can flush denormals in hardware */
+    static bool isFlushingSupported ();
+
+    /** Returns the denormals handling state of the calling thread */
+    static unsigned int getState ();
+
+    /** Restores a state previously returned by getState */
+    static void setState (const unsigned int state);
+
+    /** Turn on or off flush to zero and denormals are zero for the calling thread */
+    static void setFlushToZero (const bool shouldFlush);
+
+    /** Returns true if the calling thread is flushing denormals to zero */
+    static bool isFlushingToZero ();
+
+    //==============================================================================
+    /** Counts how many denormal numbers are in a block of samples
+
+        This only looks at the exponent bits, 4 samples at a time when
+        sse2 is available, so it is cheap enough to be done in the callback.
+    */
+    static int countDenormals (const float* samples, const int numSamples);
+};
+
+
+//==============================================================================
+/**
+    Sets the denormals handling of the calling thread, restoring it when done.
+
+    @code
+        {
+            const ScopedDenormalsMode flush (true);
+
+            // process audio here...
+        }
+    @endcode
+*/
+class ScopedDenormalsMode
+{
+public:
+
+    ScopedDenormalsMode (const bool shouldFlush)
+        : previousState (Denormals::getState ())
+    {
+        Denormals::setFlushToZero (shouldFlush);
+    }
+
+    ~ScopedDenormalsMode ()
+    {
+        Denormals::setState (previousState);
+    }
+
+private:
+
+    const unsigned int previousState;
+
+    ScopedDenormalsMode (const ScopedDenormalsMode&);
+    const ScopedDenormalsMode& operator= (const ScopedDenormalsMode&);
+};
+
+
+#endif
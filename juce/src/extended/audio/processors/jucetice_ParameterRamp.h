@@ -0,0 +1,136 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2009 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU General Public License, as published by the Free Software Foundation;
+ either version 2 of the License, or (at your option) any later version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+
+#ifndef __JUCETICE_PARAMETERRAMP_HEADER__
+#define __JUCETICE_PARAMETERRAMP_HEADER__
+
+
+//==============================================================================
+/**
+    A value that moves linearly towards its target over a number of samples.
+
+    Effects use this for the gains and mixes that are applied to the audio,
+    so that moving a knob doesn't step the gain at the start of a block. The
+    target is set from the audio thread, usually once per block when the
+    parameters have changed, and the values are then read a block at a time.
+
+    @code
+        outputGain.setTarget (newGain);
+
+        outputGain.getNextValues (gains, numSamples);
+        VectorOps::multiply (samples, samples, gains, numSamples);
+    @endcode
+*/
+class ParameterRamp
+{
+public:
+
+    //==============================================================================
+    /** Creates a ramp sitting at a value */
+    ParameterRamp (const float initialValue = 0.0f)
+        : current (initialValue),
+          target (initialValue),
+          step (0.0f),
+          rampLength (64),
+          samplesLeft (0)
+    {
+    }
+
+    //==============================================================================
+    /** Sets how many samples it takes to reach a new target */
+    void setRampLength (const int numSamples)
+    {
+        rampLength = jmax (1, numSamples);
+    }
+
+    /** Jumps straight to a value, stopping any ramp */
+    void setValue (const float newValue)
+    {
+        current = target = newValue;
+        step = 0.0f;
+        samplesLeft = 0;
+    }
+
+    /** Starts moving towards a new target from the current value */
+    void setTarget (const float newTarget)
+    {
+        if (newTarget != target)
+        {
+            target = newTarget;
+            samplesLeft = rampLength;
+            step = (target - current) / rampLength;
+        }
+    }
+
+    //==============================================================================
+    /** Returns the value the ramp is moving to */
+    float getTarget () const                   { return target; }
+
+    /** Returns the value the next sample will get */
+    float getCurrentValue () const             { return current; }
+
+    /** Returns true if the value will change in the next samples */
+    bool isRamping () const                    { return samplesLeft > 0; }
+
+    //==============================================================================
+    /** Returns the value for the next sample and advances */
+    float getNextValue ()
+    {
+        if (samplesLeft <= 0)
+            return target;
+
+        const float value = current;
+
+        if (--samplesLeft == 0)
+            current = target;
+        else
+            current += step;
+
+        return value;
+    }
+
+    /** Writes the values for the next samples and advances */
+    void getNextValues (float* dest, const int numSamples)
+    {
+        int i = 0;
+
+        for (; i < numSamples && samplesLeft > 0; ++i)
+            dest [i] = getNextValue ();
+
+        for (; i < numSamples; ++i)
+            dest [i] = target;
+    }
+
+private:
+
+    float current, target, step;
+    int rampLength, samplesLeft;
+};
+
+
+#endif
@@ -0,0 +1,179 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2009 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU General Public License, as published by the Free Software Foundation;
+ either version 2 of the License, or (at your option) any later version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+
+#include "../../../core/juce_StandardHeader.h"
+
+#if JUCE_INTEL && (JUCE_MSVC || defined (__SSE__))
+ #include <xmmintrin.h>
+ #define JUCETICE_VECTOROPS_USE_SSE 1
+#endif
+
+BEGIN_JUCE_NAMESPACE
+
+#include "jucetice_VectorOps.h"
+
+
+//==============================================================================
+#if JUCETICE_VECTOROPS_USE_SSE
+static inline __m128 absMask ()
+{
+    union { int i; float f; } bits;
+    bits.i = 0x7fffffff;
+    return _mm_set1_ps (bits.f);
+}
+#endif
+
+//==============================================================================
+void VectorOps::multiply (float* dest, const float* src, const float gain, const int numSamples)
+{
+    int i = 0;
+
+#if JUCETICE_VECTOROPS_USE_SSE
+    const __m128 g = _mm_set1_ps (gain);
+
+    for (; i <= numSamples - 4; i += 4)
+        _mm_storeu_ps (dest + i, _mm_mul_ps (_mm_loadu_ps (src + i), g));
+#endif
+
+    for (; i < numSamples; ++i)
+        dest [i] = src [i] * gain;
+}
+
+void VectorOps::multiply (float* dest, const float* src, const float* gains, const int numSamples)
+{
+    int i = 0;
+
+#if JUCETICE_VECTOROPS_USE_SSE
+    for (; i <= numSamples - 4; i += 4)
+        _mm_storeu_ps (dest + i, _mm_mul_ps (_mm_loadu_ps (src + i), _mm_loadu_ps (gains + i)));
+#endif
+
+    for (; i < numSamples; ++i)
+        dest [i] = src [i] * gains [i];
+}
+
+void VectorOps::multiplyAdd (float* dest, const float* src, const float* gains, const float* add, const int numSamples)
+{
+    int i = 0;
+
+#if JUCETICE_VECTOROPS_USE_SSE
+    for (; i <= numSamples - 4; i += 4)
+        _mm_storeu_ps (dest + i, _mm_add_ps (_mm_mul_ps (_mm_loadu_ps (src + i), _mm_loadu_ps (gains + i)),
+                                             _mm_loadu_ps (add + i)));
+#endif
+
+    for (; i < numSamples; ++i)
+        dest [i] = src [i] * gains [i] + add [i];
+}
+
+void VectorOps::interpolate (float* dest, const float* a, const float* b, const float* amounts, const int numSamples)
+{
+    int i = 0;
+
+#if JUCETICE_VECTOROPS_USE_SSE
+    for (; i <= numSamples - 4; i += 4)
+    {
+        const __m128 x = _mm_loadu_ps (a + i);
+        _mm_storeu_ps (dest + i, _mm_add_ps (_mm_mul_ps (_mm_sub_ps (_mm_loadu_ps (b + i), x),
+                                                         _mm_loadu_ps (amounts + i)), x));
+    }
+#endif
+
+    for (; i < numSamples; ++i)
+        dest [i] = (b [i] - a [i]) * amounts [i] + a [i];
+}
+
+void VectorOps::add (float* dest, const float* src, const int numSamples)
+{
+    add (dest, dest, src, numSamples);
+}
+
+void VectorOps::add (float* dest, const float* src1, const float* src2, const int numSamples)
+{
+    int i = 0;
+
+#if JUCETICE_VECTOROPS_USE_SSE
+    for (; i <= numSamples - 4; i += 4)
+        _mm_storeu_ps (dest + i, _mm_add_ps (_mm_loadu_ps (src1 + i), _mm_loadu_ps (src2 + i)));
+#endif
+
+    for (; i < numSamples; ++i)
+        dest [i] = src1 [i] + src2 [i];
+}
+
+void VectorOps::abs (float* dest, const float* src, const int numSamples)
+{
+    int i = 0;
+
+#if JUCETICE_VECTOROPS_USE_SSE
+    const __m128 mask = absMask ();
+
+    for (; i <= numSamples - 4; i += 4)
+        _mm_storeu_ps (dest + i, _mm_and_ps (_mm_loadu_ps (src + i), mask));
+#endif
+
+    for (; i < numSamples; ++i)
+        dest [i] = fabsf (src [i]);
+}
+
+void VectorOps::absMax (float* dest, const float* src, const int numSamples)
+{
+    int i = 0;
+
+#if JUCETICE_VECTOROPS_USE_SSE
+    const __m128 mask = absMask ();
+
+    for (; i <= numSamples - 4; i += 4)
+        _mm_storeu_ps (dest + i, _mm_max_ps (_mm_loadu_ps (dest + i),
+                                             _mm_and_ps (_mm_loadu_ps (src + i), mask)));
+#endif
+
+    for (; i < numSamples; ++i)
+        dest [i] = jmax (dest [i], fabsf (src [i]));
+}
+
+void VectorOps::signedSqrt (float* dest, const float* src, const int numSamples)
+{
+    int i = 0;
+
+#if JUCETICE_VECTOROPS_USE_SSE
+    const __m128 mask = absMask ();
+
+    for (; i <= numSamples - 4; i += 4)
+    {
+        const __m128 x = _mm_loadu_ps (src + i);
+        const __m128 root = _mm_sqrt_ps (_mm_and_ps (x, mask));
+        _mm_storeu_ps (dest + i, _mm_or_ps (root, _mm_andnot_ps (mask, x)));
+    }
+#endif
+
+    for (; i < numSamples; ++i)
+        dest [i] = src [i] > 0.0f ? sqrtf (src [i]) : -sqrtf (-src [i]);
+}
+
+END_JUCE_NAMESPACE
@@ -0,0 +1,79 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2009 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU General Public License, as published by the Free Software Foundation;
+ either version 2 of the License, or (at your option) any later version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+
+#ifndef __JUCETICE_VECTOROPS_HEADER__
+#define __JUCETICE_VECTOROPS_HEADER__
+
+
+//==============================================================================
+/**
+    Block operations on float samples, done 4 samples at a time with sse.
+
+    These are the small loops that block based effects keep repeating: gains,
+    ramps and mixes applied to whole blocks. The sse versions are used when
+    the build targets sse, with a plain loop for the remaining samples, and
+    the results are the same as the plain loops since every sample goes
+    through the same operations in the same order.
+
+    The source and destination of an operation can be the same block.
+*/
+class VectorOps
+{
+public:
+
+    //==============================================================================
+    /** dest[i] = src[i] * gain */
+    static void multiply (float* dest, const float* src, const float gain, const int numSamples);
+
+    /** dest[i] = src[i] * gains[i] */
+    static void multiply (float* dest, const float* src, const float* gains, const int numSamples);
+
+    /** dest[i] = src[i] * gains[i] + add[i] */
+    static void multiplyAdd (float* dest, const float* src, const float* gains, const float* add, const int numSamples);
+
+    /** dest[i] = (b[i] - a[i]) * amounts[i] + a[i], a crossfade from a to b */
+    static void interpolate (float* dest, const float* a, const float* b, const float* amounts, const int numSamples);
+
+    /** dest[i] += src[i] */
+    static void add (float* dest, const float* src, const int numSamples);
+
+    /** dest[i] = src1[i] + src2[i] */
+    static void add (float* dest, const float* src1, const float* src2, const int numSamples);
+
+    /** dest[i] = fabs (src[i]) */
+    static void abs (float* dest, const float* src, const int numSamples);
+
+    /** dest[i] = jmax (dest[i], fabs (src[i])), which gives the peak of several channels */
+    static void absMax (float* dest, const float* src, const int numSamples);
+
+    /** dest[i] = sqrt (fabs (src[i])), with the sign of src[i] */
+    static void signedSqrt (float* dest, const float* src, const int numSamples);
+};
+
+
+#endif
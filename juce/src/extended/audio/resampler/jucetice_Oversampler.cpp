@@ -0,0 +1,322 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2009 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU General Public License, as published by the Free Software Foundation;
+ either version 2 of the License, or (at your option) any later version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+#include "../../../core/juce_StandardHeader.h"
+
+#if JUCE_INTEL && (JUCE_MSVC || defined (__SSE__))
+ #include <xmmintrin.h>
+ #define JUCETICE_OVERSAMPLER_USE_SSE 1
+#endif
+
+BEGIN_JUCE_NAMESPACE
+
+#include "jucetice_Oversampler.h"
+
+
+//==============================================================================
+// taps on each side of the centre of the halfband filters, which gives 47 taps
+// for the first 2x step and 23 for the second one
+static const int firstStageSideTaps = 12;
+static const int secondStageSideTaps = 6;
+
+//==============================================================================
+/*
+    A halfband filter h[] with 4 * sideTaps - 1 taps has 0.5 at its centre,
+    and zeros at every other tap from there, so it's a fir of 2 * sideTaps
+    taps (the even ones) in parallel with a plain delay (the centre one).
+*/
+static void designHalfband (float* coefficients, const int sideTaps)
+{
+    const int numTaps = sideTaps * 2;
+    const int centre = sideTaps * 2 - 1;
+    const double beta = 8.0;
+
+    double sum = 0.0;
+
+    for (int t = 0; t < numTaps; ++t)
+    {
+        const int offset = 2 * t - centre;
+        const double x = offset * 0.5 * double_Pi;
+        const double r = offset / (double) centre;
+
+        // kaiser window
+        double num = 1.0, den = 1.0, termNum = 1.0, termDen = 1.0;
+        const double a = beta * sqrt (jmax (0.0, 1.0 - r * r)) * 0.5;
+        const double b = beta * 0.5;
+
+        for (int k = 1; k < 32; ++k)
+        {
+            termNum *= (a / k) * (a / k);
+            termDen *= (b / k) * (b / k);
+            num += termNum;
+            den += termDen;
+        }
+
+        coefficients [t] = (float) (0.5 * sin (x) / x * num / den);
+        sum += coefficients [t];
+    }
+
+    // unity gain at dc, with the 0.5 of the centre tap
+    for (int t = 0; t < numTaps; ++t)
+        coefficients [t] = (float) (coefficients [t] * 0.5 / sum);
+}
+
+static inline float dotProduct (const float* window, const float* coefficients, const int numTaps)
+{
+#if JUCETICE_OVERSAMPLER_USE_SSE
+    __m128 acc = _mm_setzero_ps ();
+
+    // the number of taps is always a multiple of 4
+    for (int k = 0; k < numTaps; k += 4)
+        acc = _mm_add_ps (acc, _mm_mul_ps (_mm_loadu_ps (window + k), _mm_loadu_ps (coefficients + k)));
+
+    acc = _mm_add_ps (acc, _mm_movehl_ps (acc, acc));
+    acc = _mm_add_ss (acc, _mm_shuffle_ps (acc, acc, 1));
+
+    float sum;
+    _mm_store_ss (&sum, acc);
+    return sum;
+#else
+    float sum = 0.0f;
+
+    for (int k = 0; k < numTaps; ++k)
+        sum += window [k] * coefficients [k];
+
+    return sum;
+#endif
+}
+
+
+//==============================================================================
+/*
+    One 2x step for one channel. The coefficients are symmetric, so they
+    don't need reversing for the convolution.
+*/
+class OversamplerStage
+{
+public:
+
+    OversamplerStage (const float* coefficients_, const int sideTaps_, const int maxInputSamples)
+        : coefficients (coefficients_),
+          sideTaps (sideTaps_),
+          numTaps (sideTaps_ * 2),
+          history (sideTaps_ * 2 - 1)
+    {
+        upWork.calloc (history + maxInputSamples);
+        evenWork.calloc (history + maxInputSamples);
+        oddWork.calloc (sideTaps + maxInputSamples);
+        upGain.malloc (numTaps);
+
+        for (int t = 0; t < numTaps; ++t)
+            upGain [t] = coefficients [t] * 2.0f;
+    }
+
+    void reset ()
+    {
+        zeromem (upWork, sizeof (float) * history);
+        zeromem (evenWork, sizeof (float) * history);
+        zeromem (oddWork, sizeof (float) * sideTaps);
+    }
+
+    void upsample (const float* input, float* output, const int numSamples)
+    {
+        memcpy (upWork + history, input, sizeof (float) * numSamples);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            output [i * 2] = dotProduct (upWork + i, upGain, numTaps);
+            output [i * 2 + 1] = upWork [i + sideTaps];
+        }
+
+        memmove (upWork, upWork + numSamples, sizeof (float) * history);
+    }
+
+    void downsample (const float* input, float* output, const int numSamples)
+    {
+        float* const even = evenWork + history;
+        float* const odd = oddWork + sideTaps;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            even [i] = input [i * 2];
+            odd [i] = input [i * 2 + 1];
+        }
+
+        for (int i = 0; i < numSamples; ++i)
+            output [i] = dotProduct (evenWork + i, coefficients, numTaps) + 0.5f * oddWork [i];
+
+        memmove (evenWork, evenWork + numSamples, sizeof (float) * history);
+        memmove (oddWork, oddWork + numSamples, sizeof (float) * sideTaps);
+    }
+
+private:
+
+    const float* const coefficients;
+    const int sideTaps, numTaps, history;
+    HeapBlock <float> upWork, evenWork, oddWork, upGain;
+};
+
+
+//==============================================================================
+Oversampler::Oversampler (const int numChannels_,
+                          const int maxBlockSize_)
+    : numChannels (numChannels_),
+      maxBlockSize (maxBlockSize_),
+      factor (1)
+{
+    firstCoefficients.malloc (firstStageSideTaps * 2);
+    secondCoefficients.malloc (secondStageSideTaps * 2);
+    designHalfband (firstCoefficients, firstStageSideTaps);
+    designHalfband (secondCoefficients, secondStageSideTaps);
+
+    // for each channel, a block at 2x followed by one at 4x
+    buffers.calloc (numChannels * maxBlockSize * 6);
+    channels.calloc (numChannels + 1);
+    heldSamples.calloc (numChannels);
+
+    for (int i = 0; i < numChannels; ++i)
+    {
+        firstStages.add (new OversamplerStage (firstCoefficients, firstStageSideTaps, maxBlockSize));
+        secondStages.add (new OversamplerStage (secondCoefficients, secondStageSideTaps, maxBlockSize * 2));
+    }
+}
+
+Oversampler::~Oversampler ()
+{
+}
+
+//==============================================================================
+void Oversampler::setFactor (const int newFactor)
+{
+    jassert (newFactor == 1 || newFactor == 2 || newFactor == 4);
+
+    const int f = newFactor >= 4 ? 4 : (newFactor >= 2 ? 2 : 1);
+
+    if (f != factor)
+    {
+        factor = f;
+        reset ();
+    }
+}
+
+int Oversampler::getLatencyForFactor (const int factor)
+{
+    if (factor < 2)
+        return 0;
+
+    // both filters of a step add their delay at the higher rate, which is
+    // the centre of their taps
+    int latency = firstStageSideTaps * 2 - 1;
+
+    // the second step adds (secondStageSideTaps * 2 - 1) / 2 samples, and the
+    // sample held back in downsample() makes up the other half
+    if (factor >= 4)
+        latency += secondStageSideTaps;
+
+    return latency;
+}
+
+void Oversampler::reset ()
+{
+    for (int i = 0; i < numChannels; ++i)
+    {
+        firstStages.getUnchecked (i)->reset ();
+        secondStages.getUnchecked (i)->reset ();
+        heldSamples [i] = 0.0f;
+    }
+}
+
+//==============================================================================
+float* const* Oversampler::upsample (const float* const* input,
+                                     const int numChannelsToProcess,
+                                     const int numSamples)
+{
+    jassert (numSamples <= maxBlockSize);
+    jassert (numChannelsToProcess <= numChannels);
+
+    for (int i = 0; i < jmin (numChannels, numChannelsToProcess); ++i)
+    {
+        float* const twice = buffers + i * maxBlockSize * 6;
+        float* const fourTimes = twice + maxBlockSize * 2;
+
+        if (factor == 1)
+        {
+            memcpy (twice, input [i], sizeof (float) * numSamples);
+            channels [i] = twice;
+        }
+        else
+        {
+            firstStages.getUnchecked (i)->upsample (input [i], twice, numSamples);
+            channels [i] = twice;
+
+            if (factor == 4)
+            {
+                secondStages.getUnchecked (i)->upsample (twice, fourTimes, numSamples * 2);
+                channels [i] = fourTimes;
+            }
+        }
+    }
+
+    return channels;
+}
+
+void Oversampler::downsample (float* const* output,
+                              const int numChannelsToProcess,
+                              const int numSamples)
+{
+    jassert (numSamples <= maxBlockSize);
+
+    for (int i = 0; i < jmin (numChannels, numChannelsToProcess); ++i)
+    {
+        float* const twice = buffers + i * maxBlockSize * 6;
+        float* const fourTimes = twice + maxBlockSize * 2;
+
+        if (factor == 1)
+        {
+            memcpy (output [i], twice, sizeof (float) * numSamples);
+        }
+        else
+        {
+            if (factor == 4)
+            {
+                const int numTwice = numSamples * 2;
+                secondStages.getUnchecked (i)->downsample (fourTimes, twice, numTwice);
+
+                // delay by one sample at 2x, so the latency is a whole number
+                // of samples at the original rate
+                const float last = twice [numTwice - 1];
+                memmove (twice + 1, twice, sizeof (float) * (numTwice - 1));
+                twice [0] = heldSamples [i];
+                heldSamples [i] = last;
+            }
+
+            firstStages.getUnchecked (i)->downsample (twice, output [i], numSamples);
+        }
+    }
+}
+
+END_JUCE_NAMESPACE
@@ -0,0 +1,154 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2009 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU General Public License, as published by the Free Software Foundation;
+ either version 2 of the License, or (at your option) any later version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+#ifndef __JUCETICE_OVERSAMPLER_HEADER__
+#define __JUCETICE_OVERSAMPLER_HEADER__
+
+#include "../../../containers/juce_HeapBlock.h"
+#include "../../../containers/juce_OwnedArray.h"
+
+class OversamplerStage;
+
+
+//==============================================================================
+/**
+    Runs a nonlinear stage at 2 or 4 times the sample rate.
+
+    Saturators and limiters make harmonics above nyquist that fold back into
+    the audible band. Running them on an oversampled signal keeps those
+    harmonics above the original nyquist, where the downsampling filter
+    removes them.
+
+    Each 2x step is a polyphase halfband fir: half of its taps are zero, so
+    only the other half is computed, 4 taps at a time with sse where
+    available. 4x is two 2x steps, with a shorter filter for the second one.
+
+    @code
+        float* const* oversampled = oversampler.upsample (input, numChannels, numSamples);
+
+        // process numSamples * oversampler.getFactor () samples in place..
+
+        oversampler.downsample (output, numChannels, numSamples);
+    @endcode
+
+    Nothing is allocated after the constructor, so the factor can be changed
+    and blocks processed from the audio thread.
+*/
+class Oversampler
+{
+public:
+
+    //==============================================================================
+    /** Creates an oversampler
+
+        @param numChannels      the number of channels that will be processed
+        @param maxBlockSize     the largest number of samples that will be passed
+                                to upsample() at the original rate
+    */
+    Oversampler (const int numChannels,
+                 const int maxBlockSize);
+
+    /** Destructor */
+    ~Oversampler ();
+
+    //==============================================================================
+    /** Returns the number of channels this was created for */
+    int getNumChannels () const                     { return numChannels; }
+
+    /** Returns the largest block that can be processed at once */
+    int getMaxBlockSize () const                    { return maxBlockSize; }
+
+    //==============================================================================
+    /** Changes the oversampling factor, which can be 1, 2 or 4
+
+        This clears the filters if the factor changes.
+    */
+    void setFactor (const int newFactor);
+
+    /** Returns the current oversampling factor */
+    int getFactor () const                          { return factor; }
+
+    /** Returns the delay added by the filters, in samples at the original rate */
+    int getLatencySamples () const                  { return getLatencyForFactor (factor); }
+
+    /** Returns the delay an oversampler would add with a given factor
+
+        This is exact: with a factor of 4 the filters alone would delay by
+        half a sample more than a whole number, so downsample() pads them
+        with one more sample at twice the rate.
+    */
+    static int getLatencyForFactor (const int factor);
+
+    /** Clears the state of the filters */
+    void reset ();
+
+    //==============================================================================
+    /** Upsamples a block of some of the channels
+
+        The returned channels hold numSamples * getFactor () samples, and can be
+        processed in place before calling downsample(). With a factor of 1 the
+        input is just copied.
+
+        @param input        the channels to read numSamples from
+        @param numChannels  how many channels to upsample, up to getNumChannels()
+        @param numSamples   the number of samples, up to getMaxBlockSize()
+    */
+    float* const* upsample (const float* const* input,
+                            const int numChannels,
+                            const int numSamples);
+
+    /** Downsamples the channels returned by the last upsample() call
+
+        @param output       the channels to write numSamples to, at the original rate
+        @param numChannels  the same number of channels passed to upsample()
+        @param numSamples   the same number of samples passed to upsample()
+    */
+    void downsample (float* const* output,
+                     const int numChannels,
+                     const int numSamples);
+
+    //==============================================================================
+    juce_UseDebuggingNewOperator
+
+private:
+
+    const int numChannels;
+    const int maxBlockSize;
+    int factor;
+
+    HeapBlock <float> firstCoefficients, secondCoefficients;
+    OwnedArray <OversamplerStage> firstStages, secondStages;
+    HeapBlock <float> buffers;
+    HeapBlock <float*> channels;
+    HeapBlock <float> heldSamples;
+
+    Oversampler (const Oversampler&);
+    const Oversampler& operator= (const Oversampler&);
+};
+
+
+#endif
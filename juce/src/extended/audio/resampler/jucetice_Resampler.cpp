@@ -0,0 +1,738 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2009 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU General Public License, as published by the Free Software Foundation;
+ either version 2 of the License, or (at your option) any later version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+#include "../../../core/juce_StandardHeader.h"
+
+#if JUCE_INTEL && (JUCE_MSVC || defined (__SSE__))
+ #include <xmmintrin.h>
+ #define JUCETICE_RESAMPLER_USE_SSE 1
+#endif
+
+namespace libsamplerateNamespace
+{
+#if JUCETICE_INCLUDE_LIBSAMPLERATE_CODE
+  #include "../../dependancies/libsamplerate/samplerate.c"
+  #include "../../dependancies/libsamplerate/src_linear.c"
+  #include "../../dependancies/libsamplerate/src_sinc.c"
+  #include "../../dependancies/libsamplerate/src_zoh.c"
+
+  // don't leak the library config into what follows in the amalgamation
+  #undef MAX
+  #undef MIN
+  #undef VERSION
+  #undef PACKAGE
+  #undef PACKAGE_BUGREPORT
+  #undef PACKAGE_NAME
+  #undef PACKAGE_STRING
+  #undef PACKAGE_TARNAME
+  #undef PACKAGE_VERSION
+#else
+  #include <samplerate.h>
+#endif
+}
+
+BEGIN_JUCE_NAMESPACE
+
+#include "jucetice_Resampler.h"
+
+using namespace libsamplerateNamespace;
+
+//==============================================================================
+class ResamplerImpl
+{
+public:
+    virtual ~ResamplerImpl () {}
+
+    virtual void reset () = 0;
+
+    virtual int process (const float* const* input, const int numInput, int& numUsed,
+                         float* const* output, const int numOutput,
+                         const double ratio) = 0;
+
+    virtual int getNumInputSamplesNeeded (const int numOutput, const double ratio) const = 0;
+};
+
+
+//==============================================================================
+/**
+    Base for the resamplers computing each output from a window of the input.
+
+    The input is copied into a per channel history, which always keeps
+    maxHalfLength - 1 samples before the current position so the window can
+    grow when the ratio changes. The window for an output at position p
+    starts at floor (p) - halfLength + 1 and is 2 * halfLength long.
+*/
+class InterpolatingResampler : public ResamplerImpl
+{
+public:
+
+    InterpolatingResampler (const int numChannels_, const int maxHalfLength_)
+        : numChannels (numChannels_),
+          maxHalfLength (maxHalfLength_),
+          capacity (maxHalfLength_ * 4 + 1024)
+    {
+        history.calloc (numChannels * capacity);
+        reset ();
+    }
+
+    //==============================================================================
+    void reset ()
+    {
+        zeromem (history, numChannels * capacity * sizeof (float));
+
+        // prime the past with silence, so the first output lines up with the first input
+        numInHistory = maxHalfLength - 1;
+        position = maxHalfLength - 1;
+        inputToSkip = 0;
+    }
+
+    int process (const float* const* input, const int numInput, int& numUsed,
+                 float* const* output, const int numOutput,
+                 const double ratio)
+    {
+        prepareForRatio (ratio);
+
+        const int halfLength = getHalfLength ();
+        int used = 0, generated = 0;
+
+        while (generated < numOutput)
+        {
+            const int numThisTime = jmin (getNumOutputsAvailable (halfLength, ratio), numOutput - generated);
+
+            if (numThisTime > 0)
+            {
+                for (int ch = 0; ch < numChannels; ++ch)
+                    renderChannel (history + ch * capacity, position, ratio, output [ch] + generated, numThisTime);
+
+                position += numThisTime * ratio;
+                generated += numThisTime;
+                continue;
+            }
+
+            // the window runs past what we have, so take in more input
+            dropConsumedSamples ();
+
+            const int numSkipped = jmin (inputToSkip, numInput - used);
+            inputToSkip -= numSkipped;
+            used += numSkipped;
+
+            const int numToCopy = jmin (capacity - numInHistory, numInput - used);
+            if (numToCopy <= 0)
+                break;
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                memcpy (history + ch * capacity + numInHistory, input [ch] + used, numToCopy * sizeof (float));
+
+            numInHistory += numToCopy;
+            used += numToCopy;
+        }
+
+        numUsed = used;
+        return generated;
+    }
+
+    int getNumInputSamplesNeeded (const int numOutput, const double ratio) const
+    {
+        const int lastNeeded = (int) (position + (numOutput - 1) * ratio) + getHalfLength ();
+
+        return jmax (0, lastNeeded + 1 - numInHistory + inputToSkip);
+    }
+
+protected:
+
+    virtual void prepareForRatio (const double ratio) = 0;
+    virtual int getHalfLength () const = 0;
+
+    virtual void renderChannel (const float* samples, const double startPosition, const double ratio,
+                                float* dest, const int numSamples) = 0;
+
+    const int numChannels;
+    const int maxHalfLength;
+
+private:
+
+    int getNumOutputsAvailable (const int halfLength, const double ratio) const
+    {
+        // output i needs floor (position + i * ratio) + halfLength < numInHistory
+        const double room = numInHistory - halfLength - position;
+        if (room <= 0.0)
+            return 0;
+
+        int num = (int) ceil (room / ratio);
+
+        // the same expression the renderers use, so rounding can't read past the end
+        while (num > 0 && (int) (position + (num - 1) * ratio) + halfLength >= numInHistory)
+            --num;
+
+        return num;
+    }
+
+    void dropConsumedSamples ()
+    {
+        const int numToDrop = (int) position - (maxHalfLength - 1);
+        if (numToDrop <= 0)
+            return;
+
+        const int numToKeep = numInHistory - numToDrop;
+
+        if (numToKeep > 0)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                float* const samples = history + ch * capacity;
+                memmove (samples, samples + numToDrop, numToKeep * sizeof (float));
+            }
+
+            numInHistory = numToKeep;
+        }
+        else
+        {
+            // a big ratio jumped past samples we haven't even read yet
+            inputToSkip += -numToKeep;
+            numInHistory = 0;
+        }
+
+        position -= numToDrop;
+    }
+
+    HeapBlock <float> history;
+    const int capacity;
+    int numInHistory, inputToSkip;
+    double position;
+
+    InterpolatingResampler (const InterpolatingResampler&);
+    const InterpolatingResampler& operator= (const InterpolatingResampler&);
+};
+
+
+//==============================================================================
+class LinearResampler : public InterpolatingResampler
+{
+public:
+
+    LinearResampler (const int numChannels)
+        : InterpolatingResampler (numChannels, 1)
+    {
+    }
+
+protected:
+
+    void prepareForRatio (const double)                 {}
+    int getHalfLength () const                          { return 1; }
+
+    void renderChannel (const float* samples, const double startPosition, const double ratio,
+                        float* dest, const int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const double p = startPosition + i * ratio;
+            const int index = (int) p;
+            const float alpha = (float) (p - index);
+
+            dest [i] = samples [index] + alpha * (samples [index + 1] - samples [index]);
+        }
+    }
+};
+
+
+//==============================================================================
+/**
+    Windowed sinc interpolation from a table of precomputed phases.
+
+    The table holds numPhases + 1 rows of 2 * halfLength coefficients, one row
+    for each fractional position; an output is the dot product of the input
+    window with the two rows around its phase, mixed linearly. When
+    downsampling the cutoff follows the ratio, and the table is rebuilt in
+    place (no allocation) each time the ratio moves to another eighth of an
+    octave, with the window growing up to 128 taps to keep the transition
+    band sharp.
+*/
+class PolyphaseSincResampler : public InterpolatingResampler
+{
+public:
+
+    enum
+    {
+        numPhases = 256,
+        baseHalfLength = 16,
+        largestHalfLength = 64
+    };
+
+    PolyphaseSincResampler (const int numChannels)
+        : InterpolatingResampler (numChannels, largestHalfLength),
+          halfLength (baseHalfLength),
+          band (-1)
+    {
+        table.malloc ((numPhases + 1) * largestHalfLength * 2);
+        prepareForRatio (1.0);
+    }
+
+protected:
+
+    void prepareForRatio (const double ratio)
+    {
+        // upsampling keeps the cutoff just under the input nyquist
+        const int newBand = ratio <= 1.0 ? 0 : (int) ceil (log (ratio) / log (2.0) * 8.0 - 1.0e-9);
+
+        if (newBand != band)
+        {
+            band = newBand;
+            buildTable (pow (2.0, band / 8.0));
+        }
+    }
+
+    int getHalfLength () const                          { return halfLength; }
+
+    void renderChannel (const float* samples, const double startPosition, const double ratio,
+                        float* dest, const int numSamples)
+    {
+        const int numTaps = halfLength * 2;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const double p = startPosition + i * ratio;
+            const int index = (int) p;
+            const float phase = (float) ((p - index) * numPhases);
+            const int row = jmin ((int) phase, numPhases - 1);
+
+            const float* const window = samples + index - halfLength + 1;
+            const float* const c0 = table + row * numTaps;
+
+            float sum0, sum1;
+            dotProducts (window, c0, c0 + numTaps, numTaps, sum0, sum1);
+
+            dest [i] = sum0 + (phase - row) * (sum1 - sum0);
+        }
+    }
+
+private:
+
+    void buildTable (const double bandRatio)
+    {
+        halfLength = jlimit ((int) baseHalfLength, (int) largestHalfLength,
+                             ((roundDoubleToInt (baseHalfLength * bandRatio) + 1) / 2) * 2);
+
+        const int numTaps = halfLength * 2;
+        const double cutoff = 0.9 / bandRatio;
+
+        for (int row = 0; row <= numPhases; ++row)
+        {
+            const double fraction = row / (double) numPhases;
+            float* const coefficients = table + row * numTaps;
+            double sum = 0.0;
+
+            for (int k = 0; k < numTaps; ++k)
+            {
+                const double distance = (k - halfLength + 1) - fraction;
+                const double x = double_Pi * cutoff * distance;
+                const double t = double_Pi * distance / halfLength;
+
+                // blackman-harris window
+                const double window = 0.35875 + 0.48829 * cos (t) + 0.14128 * cos (2.0 * t) + 0.01168 * cos (3.0 * t);
+                const double value = cutoff * (fabs (x) < 1.0e-9 ? 1.0 : sin (x) / x) * window;
+
+                coefficients [k] = (float) value;
+                sum += value;
+            }
+
+            // unity gain at dc for every phase
+            const float normalise = (float) (1.0 / sum);
+            for (int k = 0; k < numTaps; ++k)
+                coefficients [k] *= normalise;
+        }
+    }
+
+    static void dotProducts (const float* window, const float* c0, const float* c1,
+                             const int numTaps, float& sum0, float& sum1)
+    {
+#if JUCETICE_RESAMPLER_USE_SSE
+        __m128 a0 = _mm_setzero_ps ();
+        __m128 a1 = _mm_setzero_ps ();
+
+        // the number of taps is always a multiple of 4
+        for (int k = 0; k < numTaps; k += 4)
+        {
+            const __m128 x = _mm_loadu_ps (window + k);
+            a0 = _mm_add_ps (a0, _mm_mul_ps (x, _mm_loadu_ps (c0 + k)));
+            a1 = _mm_add_ps (a1, _mm_mul_ps (x, _mm_loadu_ps (c1 + k)));
+        }
+
+        a0 = _mm_add_ps (a0, _mm_movehl_ps (a0, a0));
+        a0 = _mm_add_ss (a0, _mm_shuffle_ps (a0, a0, 1));
+        a1 = _mm_add_ps (a1, _mm_movehl_ps (a1, a1));
+        a1 = _mm_add_ss (a1, _mm_shuffle_ps (a1, a1, 1));
+
+        _mm_store_ss (&sum0, a0);
+        _mm_store_ss (&sum1, a1);
+#else
+        float s0 = 0.0f, s1 = 0.0f;
+
+        for (int k = 0; k < numTaps; ++k)
+        {
+            s0 += window [k] * c0 [k];
+            s1 += window [k] * c1 [k];
+        }
+
+        sum0 = s0;
+        sum1 = s1;
+#endif
+    }
+
+    HeapBlock <float> table;
+    int halfLength, band;
+};
+
+
+//==============================================================================
+class LibsamplerateResampler : public ResamplerImpl
+{
+public:
+
+    static LibsamplerateResampler* create (const int numChannels)
+    {
+        int error = 0;
+        SRC_STATE* const state = src_new (SRC_SINC_BEST_QUALITY, numChannels, &error);
+
+        return state != 0 ? new LibsamplerateResampler (state, numChannels) : 0;
+    }
+
+    ~LibsamplerateResampler ()
+    {
+        src_delete (state);
+    }
+
+    //==============================================================================
+    void reset ()
+    {
+        src_reset (state);
+    }
+
+    int process (const float* const* input, const int numInput, int& numUsed,
+                 float* const* output, const int numOutput,
+                 const double ratio)
+    {
+        int used = 0, generated = 0;
+
+        while (generated < numOutput)
+        {
+            const int numIn = jmin ((int) blockSize, numInput - used);
+            const int numOut = jmin ((int) blockSize, numOutput - generated);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                const float* const src = input [ch] + used;
+                float* dest = interleavedInput + ch;
+
+                for (int i = 0; i < numIn; ++i, dest += numChannels)
+                    *dest = src [i];
+            }
+
+            SRC_DATA data;
+            data.data_in = interleavedInput;
+            data.data_out = interleavedOutput;
+            data.input_frames = numIn;
+            data.output_frames = numOut;
+            data.end_of_input = 0;
+            data.src_ratio = 1.0 / ratio;
+
+            if (src_process (state, &data) != 0)
+                break;
+
+            const int numGenerated = (int) data.output_frames_gen;
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                const float* src = interleavedOutput + ch;
+                float* const dest = output [ch] + generated;
+
+                for (int i = 0; i < numGenerated; ++i, src += numChannels)
+                    dest [i] = *src;
+            }
+
+            used += (int) data.input_frames_used;
+            generated += numGenerated;
+
+            if (data.input_frames_used == 0 && numGenerated == 0)
+                break;
+        }
+
+        numUsed = used;
+        return generated;
+    }
+
+    int getNumInputSamplesNeeded (const int numOutput, const double ratio) const
+    {
+        return (int) ceil (numOutput * ratio) + 1;
+    }
+
+private:
+
+    enum { blockSize = 1024 };
+
+    LibsamplerateResampler (SRC_STATE* const state_, const int numChannels_)
+        : state (state_),
+          numChannels (numChannels_)
+    {
+        interleavedInput.malloc (numChannels * blockSize);
+        interleavedOutput.malloc (numChannels * blockSize);
+    }
+
+    SRC_STATE* const state;
+    const int numChannels;
+    HeapBlock <float> interleavedInput, interleavedOutput;
+};
+
+
+//==============================================================================
+Resampler::Resampler (const int numChannels_,
+                      const Quality quality_)
+    : numChannels (jmax (1, numChannels_)),
+      quality (quality_),
+      impl (0),
+      requestedRatio (1.0),
+      ratio (1.0)
+{
+    if (quality == bestSinc)
+        impl = LibsamplerateResampler::create (numChannels);
+
+    if (impl == 0)
+    {
+        if (quality == fastLinear)
+            impl = new LinearResampler (numChannels);
+        else
+            impl = new PolyphaseSincResampler (numChannels);
+    }
+}
+
+Resampler::~Resampler ()
+{
+    delete impl;
+}
+
+//==============================================================================
+void Resampler::setRatio (const double inputSamplesPerOutputSample)
+{
+    requestedRatio = jlimit (1.0 / 256.0, 256.0, inputSamplesPerOutputSample);
+
+    ratioUpdates.write (requestedRatio);
+}
+
+void Resampler::updateRatio ()
+{
+    if (ratioUpdates.update ())
+        ratio = ratioUpdates.getReadBuffer ();
+}
+
+//==============================================================================
+void Resampler::reset ()
+{
+    impl->reset ();
+}
+
+int Resampler::process (const float* const* input,
+                        const int numInputSamples,
+                        int& numInputSamplesUsed,
+                        float* const* output,
+                        const int numOutputSamples)
+{
+    updateRatio ();
+
+    return impl->process (input, numInputSamples, numInputSamplesUsed,
+                          output, numOutputSamples, ratio);
+}
+
+int Resampler::getNumInputSamplesNeeded (const int numOutputSamples)
+{
+    updateRatio ();
+
+    return impl->getNumInputSamplesNeeded (numOutputSamples, ratio);
+}
+
+//==============================================================================
+int Resampler::resampleBuffer (const AudioSampleBuffer& source,
+                               const double sourceSampleRate,
+                               AudioSampleBuffer& destination,
+                               const double destinationSampleRate,
+                               const Quality quality)
+{
+    jassert (sourceSampleRate > 0.0 && destinationSampleRate > 0.0);
+
+    const int numChannels = source.getNumChannels ();
+    const int numInput = source.getNumSamples ();
+    const double ratio = sourceSampleRate / destinationSampleRate;
+    const int numOutput = (int) ceil (numInput / ratio);
+
+    destination.setSize (numChannels, jmax (1, numOutput));
+    destination.clear ();
+
+    Resampler resampler (numChannels, quality);
+    resampler.setRatio (ratio);
+
+    // after the end we keep feeding silence, to flush out the filter tails
+    AudioSampleBuffer silence (numChannels, 1024);
+    silence.clear ();
+
+    HeapBlock <const float*> inputs (numChannels);
+    HeapBlock <float*> outputs (numChannels);
+
+    int inputPosition = 0, outputPosition = 0;
+
+    while (outputPosition < numOutput)
+    {
+        const bool hasInput = inputPosition < numInput;
+        const int numAvailable = hasInput ? numInput - inputPosition : silence.getNumSamples ();
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            inputs [ch] = hasInput ? source.getSampleData (ch, inputPosition) : silence.getSampleData (ch);
+            outputs [ch] = destination.getSampleData (ch, outputPosition);
+        }
+
+        int numUsed = 0;
+        const int numGenerated = resampler.process (inputs, numAvailable, numUsed,
+                                                    outputs, numOutput - outputPosition);
+
+        if (hasInput)
+            inputPosition += numUsed;
+
+        outputPosition += numGenerated;
+
+        if (numUsed == 0 && numGenerated == 0)
+            break;
+    }
+
+    return numOutput;
+}
+
+const StringArray Resampler::getQualityNames ()
+{
+    StringArray names;
+    names.add (T("Fast (linear)"));
+    names.add (T("Polyphase sinc"));
+    names.add (T("Best (libsamplerate)"));
+    return names;
+}
+
+
+//==============================================================================
+ResamplerAudioSource::ResamplerAudioSource (AudioSource* const inputSource,
+                                            const bool deleteInputWhenDeleted_,
+                                            const int numChannels_,
+                                            const Resampler::Quality quality)
+    : input (inputSource),
+      deleteInputWhenDeleted (deleteInputWhenDeleted_),
+      numChannels (jmax (1, numChannels_)),
+      resampler (numChannels_, quality),
+      buffer (numChannels, 512),
+      discarded (numChannels, 512),
+      bufferPos (0),
+      sampsInBuffer (0)
+{
+    jassert (input != 0);
+
+    inputChannels.malloc (numChannels);
+    outputChannels.malloc (numChannels);
+}
+
+ResamplerAudioSource::~ResamplerAudioSource ()
+{
+    if (deleteInputWhenDeleted)
+        delete input;
+}
+
+//==============================================================================
+void ResamplerAudioSource::setResamplingRatio (const double samplesInPerOutputSample)
+{
+    resampler.setRatio (samplesInPerOutputSample);
+}
+
+//==============================================================================
+void ResamplerAudioSource::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
+{
+    const int blockSize = jmax (32, samplesPerBlockExpected);
+
+    input->prepareToPlay (blockSize, sampleRate * resampler.getRatio ());
+
+    buffer.setSize (numChannels, blockSize + 32);
+    buffer.clear ();
+    discarded.setSize (numChannels, blockSize);
+
+    bufferPos = 0;
+    sampsInBuffer = 0;
+
+    resampler.reset ();
+}
+
+void ResamplerAudioSource::releaseResources ()
+{
+    input->releaseResources ();
+    buffer.setSize (numChannels, 0);
+}
+
+void ResamplerAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& info)
+{
+    const int numOutputs = info.buffer->getNumChannels ();
+    int numDone = 0;
+
+    while (numDone < info.numSamples)
+    {
+        if (bufferPos >= sampsInBuffer)
+        {
+            const int numWanted = jlimit (1, buffer.getNumSamples (),
+                                          resampler.getNumInputSamplesNeeded (info.numSamples - numDone));
+
+            AudioSourceChannelInfo readInfo;
+            readInfo.buffer = &buffer;
+            readInfo.startSample = 0;
+            readInfo.numSamples = numWanted;
+
+            input->getNextAudioBlock (readInfo);
+
+            bufferPos = 0;
+            sampsInBuffer = numWanted;
+        }
+
+        const int numThisTime = jmin (info.numSamples - numDone, discarded.getNumSamples ());
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            inputChannels [ch] = buffer.getSampleData (ch, bufferPos);
+            outputChannels [ch] = ch < numOutputs ? info.buffer->getSampleData (ch, info.startSample + numDone)
+                                                  : discarded.getSampleData (ch);
+        }
+
+        int numUsed = 0;
+        numDone += resampler.process (inputChannels, sampsInBuffer - bufferPos, numUsed,
+                                      outputChannels, numThisTime);
+        bufferPos += numUsed;
+    }
+
+    for (int ch = numChannels; ch < numOutputs; ++ch)
+        info.buffer->clear (ch, info.startSample, info.numSamples);
+}
+
+END_JUCE_NAMESPACE
@@ -0,0 +1,225 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2009 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU General Public License, as published by the Free Software Foundation;
+ either version 2 of the License, or (at your option) any later version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+#ifndef __JUCETICE_RESAMPLER_HEADER__
+#define __JUCETICE_RESAMPLER_HEADER__
+
+#include "../../../audio/audio_sources/juce_AudioSource.h"
+#include "../../../containers/juce_HeapBlock.h"
+#include "../../../text/juce_StringArray.h"
+#include "../../containers/jucetice_TripleBuffer.h"
+
+class ResamplerImpl;
+
+
+//==============================================================================
+/**
+    Streaming sample rate converter for any number of channels.
+
+    The ratio is the number of input samples consumed for each output sample,
+    as in ResamplingAudioSource, and it can change while running (varispeed):
+    setRatio() doesn't lock, and the new value is picked up by the next call
+    to process(). It is meant to be called by one thread at a time, which
+    can be a different one from the thread processing.
+
+    There are three quality tiers:
+    - fastLinear, linear interpolation, for previews and scrubbing
+    - polyphaseSinc, a 32 taps windowed sinc (more taps when downsampling)
+      read from a table of 256 phases, with the inner loop done 4 samples at
+      a time with sse where available
+    - bestSinc, libsamplerate's best sinc converter, for offline work
+
+    process() never allocates, so it can be used from the audio thread.
+
+    @see ResamplerAudioSource
+*/
+class Resampler
+{
+public:
+
+    //==============================================================================
+    enum Quality
+    {
+        fastLinear = 0,
+        polyphaseSinc,
+        bestSinc
+    };
+
+    //==============================================================================
+    /** Creates a resampler for a number of channels, with a ratio of 1 */
+    Resampler (const int numChannels,
+               const Quality quality = polyphaseSinc);
+
+    /** Destructor */
+    ~Resampler ();
+
+    //==============================================================================
+    /** Returns the number of channels this was created for */
+    int getNumChannels () const                         { return numChannels; }
+
+    /** Returns the quality tier this was created with */
+    Quality getQuality () const                         { return quality; }
+
+    //==============================================================================
+    /** Changes the number of input samples consumed for each output sample
+
+        Values above 1 lower the pitch of the input (downsampling), values
+        below 1 raise it. The ratio is clamped between 1/256 and 256.
+    */
+    void setRatio (const double inputSamplesPerOutputSample);
+
+    /** Returns the ratio last passed to setRatio */
+    double getRatio () const                            { return requestedRatio; }
+
+    //==============================================================================
+    /** Forgets any input that was buffered, as after a seek */
+    void reset ();
+
+    /** Converts a block
+
+        Consumes up to numInputSamples from the input channels and writes up to
+        numOutputSamples into the output ones, stopping when either runs out.
+        Both arrays must have getNumChannels() pointers.
+
+        @param numInputSamplesUsed  returns how much of the input was consumed
+        @returns                    the number of output samples written
+    */
+    int process (const float* const* input,
+                 const int numInputSamples,
+                 int& numInputSamplesUsed,
+                 float* const* output,
+                 const int numOutputSamples);
+
+    /** Returns how many input samples are needed to produce a number of outputs
+
+        This is an estimate with the latest ratio, which is exact for the
+        linear and polyphase tiers. Call it from the thread processing.
+    */
+    int getNumInputSamplesNeeded (const int numOutputSamples);
+
+    //==============================================================================
+    /** Converts a whole buffer from a sample rate to another, offline
+
+        The destination is resized to hold the full converted length, with the
+        tails of the filter flushed out.
+
+        @returns the number of samples in the converted buffer
+    */
+    static int resampleBuffer (const AudioSampleBuffer& source,
+                               const double sourceSampleRate,
+                               AudioSampleBuffer& destination,
+                               const double destinationSampleRate,
+                               const Quality quality = bestSinc);
+
+    /** Returns the names of the quality tiers, in the order of the enum */
+    static const StringArray getQualityNames ();
+
+    //==============================================================================
+    juce_UseDebuggingNewOperator
+
+private:
+
+    const int numChannels;
+    const Quality quality;
+    ResamplerImpl* impl;
+
+    TripleBuffer<double> ratioUpdates;
+    double requestedRatio, ratio;
+
+    void updateRatio ();
+
+    Resampler (const Resampler&);
+    const Resampler& operator= (const Resampler&);
+};
+
+
+//==============================================================================
+/**
+    An AudioSource that changes the sample rate of another one.
+
+    Works like ResamplingAudioSource, but with any number of channels, a
+    selectable quality and a ratio that can be changed from any thread
+    without locking.
+
+    @see Resampler
+*/
+class ResamplerAudioSource : public AudioSource
+{
+public:
+
+    //==============================================================================
+    /** Creates a ResamplerAudioSource for a given input source
+
+        @param inputSource              the input source to read from
+        @param deleteInputWhenDeleted   if true, the input source will be deleted when
+                                        this object is deleted
+        @param numChannels              the number of channels to convert
+        @param quality                  the resampler tier to use
+    */
+    ResamplerAudioSource (AudioSource* const inputSource,
+                          const bool deleteInputWhenDeleted,
+                          const int numChannels = 2,
+                          const Resampler::Quality quality = Resampler::polyphaseSinc);
+
+    /** Destructor */
+    ~ResamplerAudioSource ();
+
+    //==============================================================================
+    /** Changes the resampling ratio, in input samples per output sample
+
+        This can be called at any time, even while the source is running.
+    */
+    void setResamplingRatio (const double samplesInPerOutputSample);
+
+    /** Returns the value set by setResamplingRatio */
+    double getResamplingRatio () const                  { return resampler.getRatio (); }
+
+    //==============================================================================
+    void prepareToPlay (int samplesPerBlockExpected, double sampleRate);
+    void releaseResources ();
+    void getNextAudioBlock (const AudioSourceChannelInfo& bufferToFill);
+
+    //==============================================================================
+    juce_UseDebuggingNewOperator
+
+private:
+
+    AudioSource* const input;
+    const bool deleteInputWhenDeleted;
+    const int numChannels;
+    Resampler resampler;
+    AudioSampleBuffer buffer, discarded;
+    int bufferPos, sampsInBuffer;
+    HeapBlock <const float*> inputChannels;
+    HeapBlock <float*> outputChannels;
+
+    ResamplerAudioSource (const ResamplerAudioSource&);
+    const ResamplerAudioSource& operator= (const ResamplerAudioSource&);
+};
+
+
+#endif
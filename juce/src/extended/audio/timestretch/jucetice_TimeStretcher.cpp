@@ -0,0 +1,708 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2009 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU General Public License, as published by the Free Software Foundation;
+ either version 2 of the License, or (at your option) any later version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+
+#include "../../../core/juce_StandardHeader.h"
+
+#if JUCETICE_INCLUDE_RUBBERBAND_CODE
+ #include <cstddef>
+ #include <cstring>
+ #include <cstdlib>
+ #include <algorithm>
+
+ // the stretcher converts the pitch with libsamplerate, which the resampler compiles in
+ namespace libsamplerateNamespace
+ {
+  #if JUCETICE_INCLUDE_LIBSAMPLERATE_CODE
+   #include "../../dependancies/libsamplerate/samplerate.h"
+  #else
+   #include <samplerate.h>
+  #endif
+ }
+
+ // and its transforms are done by the shared RealFFT
+ BEGIN_JUCE_NAMESPACE
+  #include "../fft/jucetice_RealFFT.h"
+ END_JUCE_NAMESPACE
+
+ namespace RubberBand
+ {
+     using namespace libsamplerateNamespace;
+
+    #ifdef JUCE_NAMESPACE
+     typedef JUCE_NAMESPACE::RealFFT JuceticeRealFFT;
+     typedef JUCE_NAMESPACE::FFTBuffer JuceticeFFTBuffer;
+    #else
+     typedef ::RealFFT JuceticeRealFFT;
+     typedef ::FFTBuffer JuceticeFFTBuffer;
+    #endif
+ }
+
+ #define USE_JUCETICE_FFT 1
+ #include "../../dependancies/rubberband/RubberBandStretcher.cpp"
+ #include "../../dependancies/rubberband/StretcherImpl.cpp"
+ #include "../../dependancies/rubberband/StretcherProcess.cpp"
+ #include "../../dependancies/rubberband/StretcherChannelData.cpp"
+ #include "../../dependancies/rubberband/StretchCalculator.cpp"
+ #include "../../dependancies/rubberband/AudioCurve.cpp"
+ #include "../../dependancies/rubberband/ConstantAudioCurve.cpp"
+ #include "../../dependancies/rubberband/HighFrequencyAudioCurve.cpp"
+ #include "../../dependancies/rubberband/PercussiveAudioCurve.cpp"
+ #include "../../dependancies/rubberband/SilentAudioCurve.cpp"
+ #include "../../dependancies/rubberband/SpectralDifferenceAudioCurve.cpp"
+ #include "../../dependancies/rubberband/FFT.cpp"
+ #include "../../dependancies/rubberband/Resampler.cpp"
+ #include "../../dependancies/rubberband/Window.cpp"
+ #include "../../dependancies/rubberband/Thread.cpp"
+ #include "../../dependancies/rubberband/Profiler.cpp"
+ #include "../../dependancies/rubberband/sysutils.cpp"
+ #undef USE_JUCETICE_FFT
+#else
+ #include <rubberband/RubberBandStretcher.h>
+#endif
+
+BEGIN_JUCE_NAMESPACE
+
+#include "jucetice_TimeStretcher.h"
+#include "../../../threads/juce_ScopedLock.h"
+#include "../../../threads/juce_WaitableEvent.h"
+#include "../../../threads/juce_Thread.h"
+#include "../../../threads/juce_RealtimePolicy.h"
+#include "../../../core/juce_Singleton.h"
+#include "../../../core/juce_SystemStats.h"
+#include "../../../core/juce_Time.h"
+#include "../../../containers/juce_VoidArray.h"
+#include "../../../utilities/juce_DeletedAtShutdown.h"
+#include "../../../events/juce_Timer.h"
+
+
+//==============================================================================
+class TimeStretcherImpl
+{
+public:
+
+    TimeStretcherImpl (const int numChannels, const double sampleRate)
+        : stretcher ((size_t) jmax (1, roundDoubleToInt (sampleRate)),
+                     (size_t) numChannels,
+                     RubberBand::RubberBandStretcher::OptionProcessRealTime
+                        | RubberBand::RubberBandStretcher::OptionTransientsMixed
+                        | RubberBand::RubberBandStretcher::OptionThreadingNever,
+                     1.0, 1.0)
+    {
+        stretcher.setMaxProcessSize ((size_t) TimeStretcher::getMaxBlockSize ());
+    }
+
+    RubberBand::RubberBandStretcher stretcher;
+};
+
+
+//==============================================================================
+TimeStretcher::TimeStretcher (const int numChannels_,
+                              const double sampleRate_)
+    : numChannels (jmax (1, numChannels_)),
+      sampleRate (sampleRate_),
+      impl (new TimeStretcherImpl (jmax (1, numChannels_), sampleRate_)),
+      requestedRatio (1.0),
+      ratio (1.0)
+{
+}
+
+TimeStretcher::~TimeStretcher ()
+{
+    delete impl;
+}
+
+//==============================================================================
+void TimeStretcher::setTimeRatio (const double outputSamplesPerInputSample)
+{
+    requestedRatio = jlimit (1.0 / 8.0, 8.0, outputSamplesPerInputSample);
+
+    ratioUpdates.write (requestedRatio);
+}
+
+void TimeStretcher::updateRatio ()
+{
+    if (ratioUpdates.update () && ratioUpdates.getReadBuffer () != ratio)
+    {
+        ratio = ratioUpdates.getReadBuffer ();
+        impl->stretcher.setTimeRatio (ratio);
+    }
+}
+
+//==============================================================================
+void TimeStretcher::reset ()
+{
+    // RubberBand's own reset leaves some of the stretch state behind, which
+    // puts the output off by a few ms after a seek, so start from a new one
+    deleteAndZero (impl);
+    impl = new TimeStretcherImpl (numChannels, sampleRate);
+
+    if (ratioUpdates.update ())
+        ratio = ratioUpdates.getReadBuffer ();
+
+    impl->stretcher.setTimeRatio (ratio);
+}
+
+int TimeStretcher::getLatency () const
+{
+    return (int) impl->stretcher.getLatency ();
+}
+
+int TimeStretcher::getNumInputSamplesNeeded ()
+{
+    updateRatio ();
+
+    return (int) impl->stretcher.getSamplesRequired ();
+}
+
+void TimeStretcher::process (const float* const* input,
+                             const int numSamples)
+{
+    jassert (numSamples <= getMaxBlockSize ());
+
+    updateRatio ();
+
+    if (numSamples > 0)
+        impl->stretcher.process (input, (size_t) numSamples, false);
+}
+
+int TimeStretcher::getNumOutputsAvailable () const
+{
+    return jmax (0, impl->stretcher.available ());
+}
+
+int TimeStretcher::retrieve (float* const* output,
+                             const int numSamples)
+{
+    if (numSamples <= 0)
+        return 0;
+
+    return (int) impl->stretcher.retrieve (output, (size_t) numSamples);
+}
+
+
+//==============================================================================
+/*  The threads that all the TimeStretchAudioSources share.
+
+    This works like the read threads of BufferingAudioSource: each thread
+    picks the source that will run dry soonest, and a source is only
+    stretched by one thread at a time, which is what its stretchLock is for.
+    The audio thread never signals anything, so the threads look at the
+    rings again every few milliseconds.
+*/
+class TimeStretchScheduler  : public DeletedAtShutdown,
+                              private Timer
+{
+public:
+    TimeStretchScheduler()
+    {
+    }
+
+    ~TimeStretchScheduler()
+    {
+        stopThreads();
+        clearSingletonInstance();
+    }
+
+    juce_DeclareSingleton (TimeStretchScheduler, false)
+
+    /* Registers with the shared instance, creating it if needed.
+
+       The singleton lock is held so the timer can't delete the instance
+       between it being returned and the source being added.
+    */
+    static void addSourceToInstance (TimeStretchAudioSource* source)
+    {
+        const ScopedLock sl (_singletonLock);
+        getInstance()->addSource (source);
+    }
+
+    /* Unregisters from the shared instance, if there's still one */
+    static void removeSourceFromInstance (TimeStretchAudioSource* source)
+    {
+        const ScopedLock sl (_singletonLock);
+
+        if (_singletonInstance != 0)
+            _singletonInstance->removeSource (source);
+    }
+
+    void addSource (TimeStretchAudioSource* source)
+    {
+        const ScopedLock sl (lock);
+
+        if (! sources.contains ((void*) source))
+        {
+            sources.add ((void*) source);
+            startThreads();
+
+            stopTimer();
+        }
+
+        workAvailable.signal();
+    }
+
+    void removeSource (TimeStretchAudioSource* source)
+    {
+        {
+            const ScopedLock sl (lock);
+            sources.removeValue ((void*) source);
+
+            if (sources.size() == 0)
+                startTimer (5000);
+        }
+
+        // if a thread is still stretching it, wait until that's finished
+        const ScopedLock rl (source->stretchLock);
+    }
+
+private:
+    //==============================================================================
+    class StretchThread  : public Thread
+    {
+    public:
+        StretchThread (TimeStretchScheduler& owner_)
+            : Thread ("Time Stretch"),
+              owner (owner_)
+        {
+        }
+
+        void run()
+        {
+            RealtimePolicy::applyToCurrentThread (RealtimePolicy::graphWorkerThread);
+
+            while (! threadShouldExit())
+            {
+                if (! owner.stretchMostUrgentSource())
+                    owner.workAvailable.wait (5);
+            }
+        }
+
+    private:
+        TimeStretchScheduler& owner;
+
+        StretchThread (const StretchThread&);
+        const StretchThread& operator= (const StretchThread&);
+    };
+
+    VoidArray sources;
+    OwnedArray <StretchThread> threads;
+    CriticalSection lock;
+    WaitableEvent workAvailable;
+
+    void startThreads()
+    {
+        if (threads.size() == 0)
+        {
+            // unlike disk reads this is all cpu, so leave a core to the audio thread
+            const int numThreads = jlimit (1, 4, SystemStats::getNumCpus() - 1);
+
+            for (int i = 0; i < numThreads; ++i)
+            {
+                StretchThread* const t = new StretchThread (*this);
+                threads.add (t);
+                t->startThread (6);
+            }
+        }
+    }
+
+    void stopThreads()
+    {
+        for (int i = threads.size(); --i >= 0;)
+            threads.getUnchecked(i)->signalThreadShouldExit();
+
+        for (int i = threads.size(); --i >= 0;)
+        {
+            workAvailable.signal();
+            threads.getUnchecked(i)->stopThread (10000);
+        }
+
+        threads.clear();
+    }
+
+    bool stretchMostUrgentSource()
+    {
+        TimeStretchAudioSource* mostUrgent = 0;
+        bool moreWork = false;
+
+        {
+            const ScopedLock sl (lock);
+
+            double soonestUnderrun = 0;
+
+            for (int i = sources.size(); --i >= 0;)
+            {
+                TimeStretchAudioSource* const s = (TimeStretchAudioSource*) sources.getUnchecked (i);
+                const double secondsLeft = s->getSecondsUntilUnderrun();
+
+                if (secondsLeft >= 0)
+                {
+                    if (mostUrgent == 0 || secondsLeft < soonestUnderrun)
+                    {
+                        if (s->stretchLock.tryEnter())
+                        {
+                            if (mostUrgent != 0)
+                            {
+                                mostUrgent->stretchLock.exit();
+                                moreWork = true;
+                            }
+
+                            mostUrgent = s;
+                            soonestUnderrun = secondsLeft;
+                        }
+                    }
+                    else
+                    {
+                        moreWork = true;
+                    }
+                }
+            }
+        }
+
+        if (mostUrgent == 0)
+            return false;
+
+        if (moreWork)
+            workAvailable.signal();
+
+        const bool didStretch = mostUrgent->stretchNextChunk();
+        mostUrgent->stretchLock.exit();
+
+        return didStretch;
+    }
+
+    void timerCallback()
+    {
+        stopTimer();
+
+        // nobody can register while the singleton lock is held, so nothing
+        // can be added between checking the sources and deleting ourselves
+        const ScopedLock sl (_singletonLock);
+
+        bool isUnused;
+
+        {
+            const ScopedLock sl2 (lock);
+            isUnused = (sources.size() == 0);
+        }
+
+        if (isUnused)
+            deleteInstance();
+    }
+
+    TimeStretchScheduler (const TimeStretchScheduler&);
+    const TimeStretchScheduler& operator= (const TimeStretchScheduler&);
+};
+
+juce_ImplementSingleton (TimeStretchScheduler)
+
+
+//==============================================================================
+TimeStretchAudioSource::TimeStretchAudioSource (PositionableAudioSource* const source_,
+                                                const bool deleteSourceWhenDeleted_,
+                                                const int numChannels_,
+                                                const int numberOfSamplesToBuffer_)
+    : source (source_),
+      deleteSourceWhenDeleted (deleteSourceWhenDeleted_),
+      numChannels (jmax (1, numChannels_)),
+      numberOfSamplesToBuffer (jmax (4096, numberOfSamplesToBuffer_)),
+      sampleRate (44100.0),
+      requestedRatio (1.0),
+      isPrepared (false),
+      stretcher (0),
+      inputBuffer (jmax (1, numChannels_), 0),
+      outputBuffer (jmax (1, numChannels_), 0),
+      samplesToDiscard (0),
+      silenceToFeed (0),
+      seekRequested (1),
+      seekAcknowledged (0),
+      seekDrained (0),
+      seekTarget (0),
+      position (0),
+      samplesToSkip (0),
+      samplesDropped (0),
+      cpuLoad (0.0f)
+{
+    jassert (source_ != 0);
+}
+
+TimeStretchAudioSource::~TimeStretchAudioSource ()
+{
+    releaseResources ();
+
+    if (deleteSourceWhenDeleted)
+        delete source;
+}
+
+//==============================================================================
+void TimeStretchAudioSource::setTimeRatio (const double outputSamplesPerInputSample)
+{
+    requestedRatio = jlimit (1.0 / 8.0, 8.0, outputSamplesPerInputSample);
+
+    if (stretcher != 0)
+        stretcher->setTimeRatio (requestedRatio);
+}
+
+int TimeStretchAudioSource::getTotalLength () const
+{
+    return roundDoubleToInt (source->getTotalLength () * requestedRatio);
+}
+
+int TimeStretchAudioSource::getLatencySamples () const
+{
+    if (rings.size () == 0)
+        return 0;
+
+    return rings.getUnchecked (0)->getNumReady () + (stretcher != 0 ? stretcher->getLatency () : 0);
+}
+
+//==============================================================================
+void TimeStretchAudioSource::prepareToPlay (int samplesPerBlockExpected, double sampleRate_)
+{
+    releaseResources ();
+
+    source->prepareToPlay (TimeStretcher::getMaxBlockSize (), sampleRate_);
+
+    sampleRate = sampleRate_ > 0.0 ? sampleRate_ : 44100.0;
+
+    stretcher = new TimeStretcher (numChannels, sampleRate);
+    stretcher->setTimeRatio (requestedRatio);
+
+    inputBuffer.setSize (numChannels, TimeStretcher::getMaxBlockSize ());
+    outputBuffer.setSize (numChannels, 1024);
+
+    for (int i = 0; i < numChannels; ++i)
+        rings.add (new LockFreeQueue <float> (jmax (samplesPerBlockExpected * 2, numberOfSamplesToBuffer)));
+
+    // start from where the last seek asked, with empty rings
+    seekAcknowledged = seekDrained = seekRequested - 1;
+    isPrepared = true;
+
+    TimeStretchScheduler::addSourceToInstance (this);
+}
+
+void TimeStretchAudioSource::releaseResources ()
+{
+    if (! isPrepared)
+        return;
+
+    TimeStretchScheduler::removeSourceFromInstance (this);
+
+    isPrepared = false;
+
+    deleteAndZero (stretcher);
+    rings.clear ();
+    inputBuffer.setSize (numChannels, 0);
+    outputBuffer.setSize (numChannels, 0);
+
+    source->releaseResources ();
+}
+
+//==============================================================================
+void TimeStretchAudioSource::setNextReadPosition (int newPosition)
+{
+    position = jmax (0, newPosition);
+    samplesToSkip = 0;
+
+    seekTarget = position;
+    Atomic::storeRelease (seekRequested, seekRequested + 1);
+}
+
+void TimeStretchAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& info)
+{
+    // once the stretch thread has started again, what's left in the rings is stale
+    if (seekDrained != seekRequested
+         && Atomic::loadAcquire (seekAcknowledged) == seekRequested)
+    {
+        for (int i = rings.size (); --i >= 0;)
+        {
+            LockFreeQueue <float>* const ring = rings.getUnchecked (i);
+            ring->finishedRead (ring->getNumReady ());
+        }
+
+        Atomic::storeRelease (seekDrained, seekRequested);
+    }
+
+    int numReady = 0;
+
+    if (seekDrained == seekRequested && rings.size () > 0)
+    {
+        numReady = rings.getUnchecked (0)->getNumReady ();
+
+        for (int i = rings.size (); --i > 0;)
+            numReady = jmin (numReady, rings.getUnchecked (i)->getNumReady ());
+
+        // catch up with the time that was played as silence
+        const int numToSkip = jmin (numReady, samplesToSkip);
+
+        if (numToSkip > 0)
+        {
+            for (int i = rings.size (); --i >= 0;)
+                rings.getUnchecked (i)->finishedRead (numToSkip);
+
+            numReady -= numToSkip;
+            samplesToSkip -= numToSkip;
+        }
+    }
+
+    const int numToRead = jmin (numReady, info.numSamples);
+    const int numOutputs = info.buffer->getNumChannels ();
+
+    for (int ch = 0; ch < rings.size (); ++ch)
+    {
+        LockFreeQueue <float>* const ring = rings.getUnchecked (ch);
+
+        if (ch < numOutputs)
+            ring->pop (info.buffer->getSampleData (ch, info.startSample), numToRead);
+        else
+            ring->finishedRead (numToRead);
+    }
+
+    for (int ch = numChannels; ch < numOutputs; ++ch)
+        info.buffer->copyFrom (ch, info.startSample, *info.buffer, numChannels - 1, info.startSample, numToRead);
+
+    if (numToRead < info.numSamples)
+    {
+        const int numMissing = info.numSamples - numToRead;
+
+        info.buffer->clear (info.startSample + numToRead, numMissing);
+
+        // only count it when the threads were keeping up, not while they start over
+        if (seekDrained == seekRequested && samplesToSkip == 0 && numToRead > 0)
+            samplesDropped += numMissing;
+
+        // still playing at the same speed, so this much will be skipped later
+        samplesToSkip += numMissing;
+    }
+
+    position += info.numSamples;
+}
+
+//==============================================================================
+double TimeStretchAudioSource::getSecondsUntilUnderrun () const
+{
+    if (Atomic::loadAcquire (seekRequested) != seekAcknowledged)
+        return 0.0;
+
+    if (Atomic::loadAcquire (seekDrained) != seekAcknowledged)
+        return -1.0;
+
+    LockFreeQueue <float>* const ring = rings.getFirst ();
+
+    if (ring == 0 || ring->getFreeSpace () < outputBuffer.getNumSamples ())
+        return -1.0;
+
+    return ring->getNumReady () / sampleRate;
+}
+
+bool TimeStretchAudioSource::stretchNextChunk ()
+{
+    const int64 startTicks = Time::getHighResolutionTicks ();
+
+    const int request = Atomic::loadAcquire (seekRequested);
+
+    if (request != seekAcknowledged)
+    {
+        stretcher->reset ();
+
+        // the stretcher delays its output by its latency, and it doesn't stretch
+        // the first latency worth of input while it settles, so that is run
+        // through before the seek position and both are thrown away
+        const int latency = stretcher->getLatency ();
+        const int inputPosition = roundDoubleToInt (seekTarget / stretcher->getCurrentTimeRatio ()) - latency;
+
+        source->setNextReadPosition (jmax (0, inputPosition));
+        silenceToFeed = jmax (0, -inputPosition);
+        samplesToDiscard = latency * 2;
+
+        Atomic::storeRelease (seekAcknowledged, request);
+        return true;
+    }
+
+    // wait for the audio thread to throw away what it had
+    if (Atomic::loadAcquire (seekDrained) != seekAcknowledged)
+        return false;
+
+    const int numToWrite = jmin (rings.getFirst ()->getFreeSpace (), outputBuffer.getNumSamples ());
+    int numWritten = 0;
+
+    while (numWritten < numToWrite)
+    {
+        const int numAvailable = stretcher->getNumOutputsAvailable ();
+
+        if (numAvailable <= 0)
+        {
+            int numNeeded = jlimit (128, inputBuffer.getNumSamples (), stretcher->getNumInputSamplesNeeded ());
+
+            if (silenceToFeed > 0)
+            {
+                numNeeded = jmin (numNeeded, silenceToFeed);
+                silenceToFeed -= numNeeded;
+
+                inputBuffer.clear ();
+            }
+            else
+            {
+                AudioSourceChannelInfo info;
+                info.buffer = &inputBuffer;
+                info.startSample = 0;
+                info.numSamples = numNeeded;
+
+                source->getNextAudioBlock (info);
+            }
+
+            stretcher->process (inputBuffer.getArrayOfChannels (), numNeeded);
+            continue;
+        }
+
+        const int numRetrieved = stretcher->retrieve (outputBuffer.getArrayOfChannels (),
+                                                      jmin (numAvailable, numToWrite - numWritten));
+
+        if (numRetrieved <= 0)
+            break;
+
+        // what comes out before the seek position is the stretcher filling up
+        const int numDiscarded = jmin (samplesToDiscard, numRetrieved);
+        samplesToDiscard -= numDiscarded;
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            rings.getUnchecked (ch)->push (outputBuffer.getSampleData (ch, numDiscarded), numRetrieved - numDiscarded);
+
+        numWritten += numRetrieved - numDiscarded;
+    }
+
+    if (numWritten > 0)
+    {
+        const double secondsSpent = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks () - startTicks);
+        const float load = (float) (secondsSpent * sampleRate / numWritten);
+
+        cpuLoad = cpuLoad * 0.9f + load * 0.1f;
+    }
+
+    return numWritten > 0;
+}
+
+END_JUCE_NAMESPACE
@@ -0,0 +1,251 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2009 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU General Public License, as published by the Free Software Foundation;
+ either version 2 of the License, or (at your option) any later version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+
+#ifndef __JUCETICE_TIMESTRETCHER_HEADER__
+#define __JUCETICE_TIMESTRETCHER_HEADER__
+
+#include "../../../audio/audio_sources/juce_PositionableAudioSource.h"
+#include "../../../containers/juce_OwnedArray.h"
+#include "../../../threads/juce_CriticalSection.h"
+#include "../../containers/jucetice_LockFreeQueue.h"
+#include "../../containers/jucetice_TripleBuffer.h"
+
+class TimeStretcherImpl;
+
+
+//==============================================================================
+/**
+    Changes the duration of audio without changing its pitch.
+
+    This runs the bundled RubberBand stretcher in its real-time mode, so the
+    ratio can change while running: setTimeRatio() doesn't lock, and the new
+    value is picked up by the next call that processes. It is meant to be
+    called by one thread at a time, which can be a different one from the
+    thread processing.
+
+    Unlike the Resampler, stretching works on overlapping FFT frames, so it
+    is too expensive and too bursty to run on the audio thread: see
+    TimeStretchAudioSource for running it ahead of the playhead.
+
+    @see TimeStretchAudioSource
+*/
+class TimeStretcher
+{
+public:
+
+    //==============================================================================
+    /** Creates a stretcher for a number of channels, with a ratio of 1 */
+    TimeStretcher (const int numChannels,
+                   const double sampleRate);
+
+    /** Destructor */
+    ~TimeStretcher ();
+
+    //==============================================================================
+    /** Returns the number of channels this was created for */
+    int getNumChannels () const                         { return numChannels; }
+
+    //==============================================================================
+    /** Changes the number of output samples produced for each input sample
+
+        Values above 1 slow the input down, values below 1 speed it up. The
+        ratio is clamped between 1/8 and 8.
+    */
+    void setTimeRatio (const double outputSamplesPerInputSample);
+
+    /** Returns the ratio last passed to setTimeRatio */
+    double getTimeRatio () const                        { return requestedRatio; }
+
+    /** Returns the ratio the thread processing is using */
+    double getCurrentTimeRatio () const                 { return ratio; }
+
+    //==============================================================================
+    /** Forgets any input that was buffered, as after a seek
+
+        This allocates, so it shouldn't be called from the audio thread.
+    */
+    void reset ();
+
+    /** Returns how many samples at the start of the output, after a reset,
+        come before the first input sample and should be thrown away
+    */
+    int getLatency () const;
+
+    /** Returns how many input samples are needed before more output comes out */
+    int getNumInputSamplesNeeded ();
+
+    /** Feeds in a block, at most getMaxBlockSize samples long */
+    void process (const float* const* input,
+                  const int numSamples);
+
+    /** Returns the number of output samples that can be retrieved */
+    int getNumOutputsAvailable () const;
+
+    /** Takes up to numSamples of output, returns how many were written */
+    int retrieve (float* const* output,
+                  const int numSamples);
+
+    /** Returns the longest block process() takes */
+    static int getMaxBlockSize ()                       { return 1024; }
+
+    //==============================================================================
+    juce_UseDebuggingNewOperator
+
+private:
+
+    const int numChannels;
+    const double sampleRate;
+    TimeStretcherImpl* impl;
+
+    TripleBuffer<double> ratioUpdates;
+    double requestedRatio, ratio;
+
+    void updateRatio ();
+
+    TimeStretcher (const TimeStretcher&);
+    const TimeStretcher& operator= (const TimeStretcher&);
+};
+
+
+//==============================================================================
+/**
+    Time-stretches another source ahead of the playhead.
+
+    The stretching is done by a few background threads shared by all the
+    instances, which pick the source closest to running dry, like the read
+    threads of BufferingAudioSource. The results are handed to the audio
+    thread through a lock-free ring per channel, so getNextAudioBlock() and
+    setNextReadPosition() never lock or wait: after a seek, or when the
+    threads fall behind, it plays silence and skips ahead once the stretched
+    audio is there, so it keeps in time with the position it's given.
+
+    Positions are in output samples. A seek maps them back to the input with
+    the current ratio, so it assumes the ratio was the same since position 0.
+
+    @see TimeStretcher
+*/
+class TimeStretchAudioSource : public PositionableAudioSource
+{
+public:
+
+    //==============================================================================
+    /** Creates a TimeStretchAudioSource for a given input source
+
+        @param source                   the input source to read from
+        @param deleteSourceWhenDeleted  if true, the input source will be deleted when
+                                        this object is deleted
+        @param numChannels              the number of channels to stretch
+        @param numberOfSamplesToBuffer  the size of the lookahead, in output samples
+    */
+    TimeStretchAudioSource (PositionableAudioSource* const source,
+                            const bool deleteSourceWhenDeleted,
+                            const int numChannels = 2,
+                            const int numberOfSamplesToBuffer = 16384);
+
+    /** Destructor */
+    ~TimeStretchAudioSource ();
+
+    //==============================================================================
+    /** Changes the number of output samples produced for each input sample
+
+        This can be called at any time, from one thread at a time. The audio
+        already stretched ahead still plays at the old ratio, so the change is
+        heard after getLatencySamples().
+    */
+    void setTimeRatio (const double outputSamplesPerInputSample);
+
+    /** Returns the ratio last passed to setTimeRatio */
+    double getTimeRatio () const                        { return requestedRatio; }
+
+    //==============================================================================
+    /** Returns the time spent stretching, as a fraction of the time it played for */
+    float getCpuLoad () const                           { return cpuLoad; }
+
+    /** Returns how far ahead of the playhead the stretched audio is, in samples
+
+        This is the lookahead that is ready plus the latency of the stretcher,
+        and it is how long a change of ratio takes to be heard.
+    */
+    int getLatencySamples () const;
+
+    /** Returns the number of samples played as silence because the threads were late */
+    int getNumSamplesDropped () const                   { return samplesDropped; }
+
+    //==============================================================================
+    void prepareToPlay (int samplesPerBlockExpected, double sampleRate);
+    void releaseResources ();
+    void getNextAudioBlock (const AudioSourceChannelInfo& bufferToFill);
+
+    //==============================================================================
+    void setNextReadPosition (int newPosition);
+    int getNextReadPosition () const                    { return position; }
+    int getTotalLength () const;
+    bool isLooping () const                             { return source->isLooping (); }
+
+    //==============================================================================
+    juce_UseDebuggingNewOperator
+
+private:
+
+    friend class TimeStretchScheduler;
+
+    PositionableAudioSource* const source;
+    const bool deleteSourceWhenDeleted;
+    const int numChannels, numberOfSamplesToBuffer;
+    double sampleRate, requestedRatio;
+    bool isPrepared;
+
+    // used by the stretch thread, under stretchLock
+    TimeStretcher* stretcher;
+    AudioSampleBuffer inputBuffer, outputBuffer;
+    int samplesToDiscard, silenceToFeed;
+    CriticalSection stretchLock;
+
+    OwnedArray <LockFreeQueue <float> > rings;
+
+    // the seek handshake: the audio thread asks, the stretch thread starts
+    // again from seekTarget and acknowledges, then the audio thread throws
+    // away what was in the rings and says the stretch thread can refill them
+    int seekRequested, seekAcknowledged, seekDrained;
+    volatile int seekTarget;
+
+    // audio thread state
+    int position, samplesToSkip;
+    volatile int samplesDropped;
+
+    volatile float cpuLoad;
+
+    double getSecondsUntilUnderrun () const;
+    bool stretchNextChunk ();
+
+    TimeStretchAudioSource (const TimeStretchAudioSource&);
+    const TimeStretchAudioSource& operator= (const TimeStretchAudioSource&);
+};
+
+
+#endif
@@ -25,16 +25,22 @@
  ==============================================================================
 */
 
-#ifndef __JUCE_CIRCULARBUFFER_JUCEHEADER__
-#define __JUCE_CIRCULARBUFFER_JUCEHEADER__
+#ifndef __JUCETICE_CIRCULARBUFFER_HEADER__
+#define __JUCETICE_CIRCULARBUFFER_HEADER__
+
+
 
 
 //==============================================================================
 /*
     Implementation of a circular buffer
 
+    Keeps the history of the last <length> samples fed into it, for delay lines
+    and the like. It is meant to be used by one thread only: to move samples
+    between threads use LockFreeQueue instead.
+
     - <typename ElementType> specifies the samples type (i.e. use <float> for VST)
-    - The buffer is memory aligned for better performance
+    - The storage is rounded up to a power of two, so wrapping is a mask
 */
 template<typename ElementType>
 class CircularBuffer
@@ -44,26 +50,27 @@ public:
     //==============================================================================
     /** Constructor */
     CircularBuffer (uint32 length)
-        : _length (length)
+        : _length (length),
+          _firstFree (0)
     {
-        // allocate buffer (it will be at least int-aligned)
-        _buffer = (ElementType*)_aligned_malloc(_length * sizeof(ElementType), (sizeof(int) > sizeof(ElementType)) ? sizeof(int) : sizeof(ElementType));
-        // fills it w/zeros and init vars
-        memset(_buffer, 0, _length * sizeof(ElementType));
-        _firstFree = 0;
+        _mask = 1;
+        while (_mask < _length)
+            _mask <<= 1;
+
+        _buffer.calloc (_mask);
+        _mask -= 1;
     }
 
     /** Destructor */
     ~CircularBuffer()
     {
-        _aligned_free(_buffer);
     }
 
     //==============================================================================
     /** Fills the buffer with silence */
     void reset()
     {
-        memset(_buffer, 0, _length * sizeof(ElementType));
+        zeromem (_buffer, (_mask + 1) * sizeof (ElementType));
         _firstFree = 0;
     }
 
@@ -78,38 +85,27 @@ public:
     /** Feed in a new sample */
     void put (ElementType sample)
     {
-        // Copy the sample to the first free location
         _buffer[_firstFree] = sample;
-        // update feed position
-        _firstFree = (_firstFree + 1) % _length;
+        _firstFree = (_firstFree + 1) & _mask;
     }
 
     /** Feed in a new <block> of samples of length <length> */
-    void put (ElementType* block, uint32 length)
+    void put (const ElementType* block, uint32 length)
     {
-        // if it doesn't fit, take last _length samples
-        if(length > _length) {
-            length = _length;                    // limit the length to the buffer's length
-            block = &block[length - _length];    // start later, in order to get last <_length> samples
-        }
-
-        // if it has to be divided at the physical end of the buffer
-        if(_firstFree + length > _length)
-        {
-            // fill the end of the buffer
-            memcpy((_buffer + _firstFree), block, (_length - _firstFree) * sizeof(ElementType));
-            // restart filling from the beginning of the buffer
-            memcpy(_buffer, (block + _length - _firstFree), (length - _length + _firstFree) * sizeof(ElementType));
-            // update feed position
-            _firstFree = length - _length + _firstFree;
-        }
-        else
+        // if it doesn't fit, take the last samples only
+        const uint32 capacity = _mask + 1;
+        if (length > capacity)
         {
-            // Copy the entire block to the first free location
-            memcpy((_buffer + _firstFree), block, length * sizeof(ElementType));
-            // update feed position
-            _firstFree = _firstFree + length;
+            block += length - capacity;
+            length = capacity;
         }
+
+        // it may have to be divided at the physical end of the buffer
+        const uint32 size = jmin (length, capacity - _firstFree);
+        memcpy (_buffer + _firstFree, block, size * sizeof (ElementType));
+        memcpy (_buffer, block + size, (length - size) * sizeof (ElementType));
+
+        _firstFree = (_firstFree + length) & _mask;
     }
 
     //==============================================================================
@@ -120,55 +116,34 @@ public:
     */
     ElementType get (uint32 samplesBackward) const
     {
-        return _buffer[(_firstFree - samplesBackward - 1 + _length) % _length];
+        jassert (samplesBackward < _length);
+
+        return _buffer[(_firstFree - samplesBackward - 1) & _mask];
     }
 
     /** Fills <block> with the last <n> samples feeded into the buffer
         [out] <block> must have room for at least <n> samples
     */
-    void getLast (ElementType * block, uint32 n) const
+    void getLast (ElementType* block, uint32 n) const
     {
         // cannot give away more than we have!
-        n = (n < _length) ? n : _length;
-        int start = (_firstFree + (_length - n)) % _length;
-        int size = ((_length - start) < n) ? (_length - start) : n;
-        memcpy(block, &_buffer[start], size * sizeof(ElementType));
-        if(n - size)
-            memcpy(&block[size], &_buffer[(start + size) % _length], (n - size) * sizeof(ElementType));
+        n = jmin (n, _length);
+
+        const uint32 start = (_firstFree - n) & _mask;
+        const uint32 size = jmin (n, _mask + 1 - start);
+        memcpy (block, _buffer + start, size * sizeof (ElementType));
+        memcpy (block + size, _buffer, (n - size) * sizeof (ElementType));
     }
 
 private:
 
-#ifndef _aligned_malloc
-    static void* _aligned_malloc (size_t bytes, size_t alignment)
-    {
-        void *p1 ,*p2; // basic pointer needed for computation.
-
-        if((p1 =(void *) malloc(bytes + alignment + sizeof(size_t)))==NULL)
-            return NULL;
-
-        size_t addr=(size_t)p1+alignment+sizeof(size_t);
-
-        p2=(void *)(addr - (addr%alignment));
-
-        *((size_t *)p2-1)=(size_t)p1;
-
-        return p2;
-    }
-#endif
+    HeapBlock <ElementType> _buffer;    // the buffer
+    uint32 _length;                     // size of the history in samples
+    uint32 _mask;                       // size of the buffer minus one
+    uint32 _firstFree;                  // next feed location index
 
-#ifndef _aligned_free
-    static void _aligned_free (void *p)
-    {
-        /* Find the address stored by aligned_malloc ,"size_t" bytes above the
-           current pointer then free it using normal free routine provided by C. */
-        free((void *)(*((size_t *) p-1)));
-    }
-#endif
-
-    ElementType* _buffer;         // the buffer
-    uint32 _length;     // size of the buffer in samples
-    uint32 _firstFree;  // next feed location index
+    CircularBuffer (const CircularBuffer&);
+    const CircularBuffer& operator= (const CircularBuffer&);
 };
 
 
@@ -0,0 +1,508 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2009 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU General Public License, as published by the Free Software Foundation;
+ either version 2 of the License, or (at your option) any later version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+#ifndef __JUCETICE_LOCKFREEQUEUE_HEADER__
+#define __JUCETICE_LOCKFREEQUEUE_HEADER__
+
+#include "../../core/juce_Atomic.h"
+
+
+//==============================================================================
+/**
+    Helpers shared by the lock free containers.
+
+    Positions are free running counters: they are never wrapped, only masked
+    when used as an index, so the distance between two of them is always
+    right even after the counter overflows.
+*/
+class LockFreeQueueHelpers
+{
+public:
+    /** Size of the padding put between data touched by different threads. */
+    enum { cacheLineSize = 64 };
+
+    /** Rounds a capacity up to the next power of two (at least 2). */
+    static int roundUpCapacity (const int minimumCapacity)
+    {
+        int capacity = 2;
+        while (capacity < minimumCapacity)
+            capacity <<= 1;
+
+        return capacity;
+    }
+
+    /** Returns the number of items between two positions. */
+    static int distance (const int from, const int to)
+    {
+        return (int) ((unsigned int) to - (unsigned int) from);
+    }
+
+    /** Moves a position forward. */
+    static int advance (const int position, const int numItems)
+    {
+        return (int) ((unsigned int) position + (unsigned int) numItems);
+    }
+};
+
+
+//==============================================================================
+/**
+    A bounded single producer, single consumer queue.
+
+    One thread may push and one (other) thread may pop at the same time, without
+    locks and without ever blocking. The capacity is rounded up to a power of
+    two, so indexing is a mask instead of a modulo, and the reader and writer
+    positions live on separate cache lines together with a cached copy of the
+    other side's position, so the two threads only touch each other's memory
+    when the cached value says the queue looks full (or empty).
+
+    Besides single items, blocks can be pushed and popped in one go, or written
+    and read in place with prepareToWrite() / finishedWrite() and
+    prepareToRead() / finishedRead(), which hand out at most two contiguous
+    spans of the ring.
+
+    ElementType must be copyable and default constructible.
+
+    @see LockFreeMultiProducerQueue, TripleBuffer
+*/
+template <class ElementType>
+class LockFreeQueue
+{
+public:
+
+    //==============================================================================
+    /** Creates a queue that can hold at least minimumCapacity items. */
+    explicit LockFreeQueue (const int minimumCapacity)
+        : capacity (LockFreeQueueHelpers::roundUpCapacity (minimumCapacity)),
+          mask (capacity - 1),
+          writePosition (0),
+          cachedReadPosition (0),
+          readPosition (0),
+          cachedWritePosition (0)
+    {
+        buffer = new ElementType [capacity];
+    }
+
+    /** Destructor. */
+    ~LockFreeQueue()
+    {
+        delete[] buffer;
+    }
+
+    //==============================================================================
+    /** Returns the number of items the queue can hold. */
+    int getCapacity() const                 { return capacity; }
+
+    /** Returns the number of items waiting to be read.
+        Exact when called by the reader, a lower bound from any other thread.
+    */
+    int getNumReady() const
+    {
+        return LockFreeQueueHelpers::distance (Atomic::loadAcquire (readPosition),
+                                               Atomic::loadAcquire (writePosition));
+    }
+
+    /** Returns the number of items that can be pushed.
+        Exact when called by the writer, a lower bound from any other thread.
+    */
+    int getFreeSpace() const                { return capacity - getNumReady(); }
+
+    /** Returns true if there is nothing to read. */
+    bool isEmpty() const                    { return getNumReady() == 0; }
+
+    /** Returns true if nothing more can be pushed. */
+    bool isFull() const                     { return getNumReady() >= capacity; }
+
+    //==============================================================================
+    /** Adds an item. Writer thread only.
+        Returns false (and drops the item) if the queue is full.
+    */
+    bool push (const ElementType& item)
+    {
+        const int write = writePosition;
+
+        if (LockFreeQueueHelpers::distance (cachedReadPosition, write) >= capacity)
+        {
+            cachedReadPosition = Atomic::loadAcquire (readPosition);
+
+            if (LockFreeQueueHelpers::distance (cachedReadPosition, write) >= capacity)
+                return false;
+        }
+
+        buffer [write & mask] = item;
+        Atomic::storeRelease (writePosition, LockFreeQueueHelpers::advance (write, 1));
+        return true;
+    }
+
+    /** Adds as many of the given items as fit. Writer thread only.
+        Returns the number of items pushed, which are made visible to the
+        reader all at once.
+    */
+    int push (const ElementType* items, const int numItems)
+    {
+        ElementType* block1;
+        ElementType* block2;
+        int size1, size2;
+
+        const int numToWrite = prepareToWrite (numItems, block1, size1, block2, size2);
+
+        int i;
+        for (i = 0; i < size1; ++i)
+            block1[i] = items[i];
+
+        for (i = 0; i < size2; ++i)
+            block2[i] = items [size1 + i];
+
+        finishedWrite (numToWrite);
+        return numToWrite;
+    }
+
+    /** Returns the spans where up to numWanted items can be written. Writer thread only.
+
+        The first span starts at the next free slot; the second, if not empty,
+        starts at the beginning of the ring. Returns size1 + size2, which may
+        be less than numWanted. Call finishedWrite() once the slots are filled.
+    */
+    int prepareToWrite (const int numWanted,
+                        ElementType*& block1, int& size1,
+                        ElementType*& block2, int& size2)
+    {
+        const int write = writePosition;
+
+        int numFree = capacity - LockFreeQueueHelpers::distance (cachedReadPosition, write);
+        if (numFree < numWanted)
+        {
+            cachedReadPosition = Atomic::loadAcquire (readPosition);
+            numFree = capacity - LockFreeQueueHelpers::distance (cachedReadPosition, write);
+        }
+
+        return getSpans (write, jmax (0, jmin (numWanted, numFree)), block1, size1, block2, size2);
+    }
+
+    /** Publishes the items written after prepareToWrite(). Writer thread only. */
+    void finishedWrite (const int numWritten)
+    {
+        jassert (numWritten >= 0 && numWritten <= capacity - getNumReady());
+
+        Atomic::storeRelease (writePosition, LockFreeQueueHelpers::advance (writePosition, numWritten));
+    }
+
+    //==============================================================================
+    /** Removes the oldest item. Reader thread only.
+        Returns false (and leaves item alone) if the queue is empty.
+    */
+    bool pop (ElementType& item)
+    {
+        const int read = readPosition;
+
+        if (read == cachedWritePosition)
+        {
+            cachedWritePosition = Atomic::loadAcquire (writePosition);
+
+            if (read == cachedWritePosition)
+                return false;
+        }
+
+        item = buffer [read & mask];
+        Atomic::storeRelease (readPosition, LockFreeQueueHelpers::advance (read, 1));
+        return true;
+    }
+
+    /** Removes up to numItems of the oldest items. Reader thread only.
+        Returns the number of items copied into the array.
+    */
+    int pop (ElementType* items, const int numItems)
+    {
+        ElementType* block1;
+        ElementType* block2;
+        int size1, size2;
+
+        const int numToRead = prepareToRead (numItems, block1, size1, block2, size2);
+
+        int i;
+        for (i = 0; i < size1; ++i)
+            items[i] = block1[i];
+
+        for (i = 0; i < size2; ++i)
+            items [size1 + i] = block2[i];
+
+        finishedRead (numToRead);
+        return numToRead;
+    }
+
+    /** Returns the spans holding up to numWanted of the oldest items. Reader thread only.
+
+        Works like prepareToWrite(): call finishedRead() once the items have
+        been consumed, which gives their slots back to the writer.
+    */
+    int prepareToRead (const int numWanted,
+                       ElementType*& block1, int& size1,
+                       ElementType*& block2, int& size2)
+    {
+        const int read = readPosition;
+
+        int numReady = LockFreeQueueHelpers::distance (read, cachedWritePosition);
+        if (numReady < numWanted)
+        {
+            cachedWritePosition = Atomic::loadAcquire (writePosition);
+            numReady = LockFreeQueueHelpers::distance (read, cachedWritePosition);
+        }
+
+        return getSpans (read, jmax (0, jmin (numWanted, numReady)), block1, size1, block2, size2);
+    }
+
+    /** Releases the items read after prepareToRead(). Reader thread only. */
+    void finishedRead (const int numRead)
+    {
+        jassert (numRead >= 0 && numRead <= getNumReady());
+
+        Atomic::storeRelease (readPosition, LockFreeQueueHelpers::advance (readPosition, numRead));
+    }
+
+    //==============================================================================
+    /** Throws away everything in the queue.
+        Neither the reader nor the writer must be using it at the same time.
+    */
+    void reset()
+    {
+        writePosition = cachedReadPosition = readPosition = cachedWritePosition = 0;
+        Atomic::memoryBarrier();
+    }
+
+    //==============================================================================
+    juce_UseDebuggingNewOperator
+
+private:
+
+    int getSpans (const int position, const int numItems,
+                  ElementType*& block1, int& size1,
+                  ElementType*& block2, int& size2) const
+    {
+        const int start = position & mask;
+
+        block1 = buffer + start;
+        size1 = jmin (numItems, capacity - start);
+        block2 = buffer;
+        size2 = numItems - size1;
+
+        return numItems;
+    }
+
+    // read only after construction, shared by both threads
+    ElementType* buffer;
+    const int capacity, mask;
+    char padding0 [LockFreeQueueHelpers::cacheLineSize];
+
+    // touched by the writer
+    int writePosition, cachedReadPosition;
+    char padding1 [LockFreeQueueHelpers::cacheLineSize - 2 * sizeof (int)];
+
+    // touched by the reader
+    int readPosition, cachedWritePosition;
+    char padding2 [LockFreeQueueHelpers::cacheLineSize - 2 * sizeof (int)];
+
+    LockFreeQueue (const LockFreeQueue&);
+    const LockFreeQueue& operator= (const LockFreeQueue&);
+};
+
+
+//==============================================================================
+/**
+    A bounded multiple producer, single consumer queue.
+
+    Any number of threads may push at the same time, while a single thread pops.
+    Writers claim slots by moving the shared write position with a compare and
+    swap, then fill them and mark each one as published; the reader stops at
+    the first slot that hasn't been published yet, so items come out in the
+    order their slots were claimed. Pushing a block claims all of its slots
+    with one compare and swap.
+
+    Pushing never blocks, but a writer that gets preempted between claiming and
+    publishing holds back the reader until it carries on, so this is meant for
+    feeding the audio thread from the message/background threads (or the other
+    way round), not for fanning in from several realtime threads.
+
+    @see LockFreeQueue
+*/
+template <class ElementType>
+class LockFreeMultiProducerQueue
+{
+public:
+
+    //==============================================================================
+    /** Creates a queue that can hold at least minimumCapacity items. */
+    explicit LockFreeMultiProducerQueue (const int minimumCapacity)
+        : capacity (LockFreeQueueHelpers::roundUpCapacity (minimumCapacity)),
+          mask (capacity - 1),
+          writePosition (0),
+          readPosition (0)
+    {
+        cells = new Cell [capacity];
+
+        // a slot is published when its sequence equals its position + 1
+        for (int i = 0; i < capacity; ++i)
+            cells[i].sequence = i;
+    }
+
+    /** Destructor. */
+    ~LockFreeMultiProducerQueue()
+    {
+        delete[] cells;
+    }
+
+    //==============================================================================
+    /** Returns the number of items the queue can hold. */
+    int getCapacity() const                 { return capacity; }
+
+    /** Returns the number of slots claimed and not yet popped.
+        This includes slots that a writer is still filling.
+    */
+    int getNumReady() const
+    {
+        return LockFreeQueueHelpers::distance (Atomic::loadAcquire (readPosition),
+                                               Atomic::loadAcquire (writePosition));
+    }
+
+    /** Returns true if nothing has been pushed since the last pop. */
+    bool isEmpty() const                    { return getNumReady() == 0; }
+
+    //==============================================================================
+    /** Adds an item. Any thread.
+        Returns false (and drops the item) if the queue is full.
+    */
+    bool push (const ElementType& item)
+    {
+        return push (&item, 1) == 1;
+    }
+
+    /** Adds as many of the given items as fit, as one contiguous run. Any thread.
+        Returns the number of items pushed.
+    */
+    int push (const ElementType* items, const int numItems)
+    {
+        int start, numToWrite;
+
+        for (;;)
+        {
+            start = Atomic::loadAcquire (writePosition);
+
+            const int numFree = capacity - LockFreeQueueHelpers::distance (Atomic::loadAcquire (readPosition), start);
+            numToWrite = jmin (numItems, numFree);
+
+            if (numToWrite <= 0)
+                return 0;
+
+            if (Atomic::compareAndSwap (writePosition, LockFreeQueueHelpers::advance (start, numToWrite), start))
+                break;
+        }
+
+        for (int i = 0; i < numToWrite; ++i)
+        {
+            const int position = LockFreeQueueHelpers::advance (start, i);
+            Cell& cell = cells [position & mask];
+
+            cell.data = items[i];
+            Atomic::storeRelease (cell.sequence, LockFreeQueueHelpers::advance (position, 1));
+        }
+
+        return numToWrite;
+    }
+
+    //==============================================================================
+    /** Removes the oldest published item. Reader thread only.
+        Returns false if there is nothing ready.
+    */
+    bool pop (ElementType& item)
+    {
+        const int read = readPosition;
+        Cell& cell = cells [read & mask];
+
+        if (Atomic::loadAcquire (cell.sequence) != LockFreeQueueHelpers::advance (read, 1))
+            return false;
+
+        item = cell.data;
+
+        // the slot goes back to the writers only once readPosition moves past it
+        Atomic::storeRelease (readPosition, LockFreeQueueHelpers::advance (read, 1));
+        return true;
+    }
+
+    /** Removes up to numItems of the oldest published items. Reader thread only.
+        Returns the number of items copied into the array.
+    */
+    int pop (ElementType* items, const int numItems)
+    {
+        const int read = readPosition;
+        int numRead = 0;
+
+        while (numRead < numItems)
+        {
+            const int position = LockFreeQueueHelpers::advance (read, numRead);
+            Cell& cell = cells [position & mask];
+
+            if (Atomic::loadAcquire (cell.sequence) != LockFreeQueueHelpers::advance (position, 1))
+                break;
+
+            items [numRead++] = cell.data;
+        }
+
+        if (numRead > 0)
+            Atomic::storeRelease (readPosition, LockFreeQueueHelpers::advance (read, numRead));
+
+        return numRead;
+    }
+
+    //==============================================================================
+    juce_UseDebuggingNewOperator
+
+private:
+
+    struct Cell
+    {
+        int sequence;
+        ElementType data;
+    };
+
+    // read only after construction
+    Cell* cells;
+    const int capacity, mask;
+    char padding0 [LockFreeQueueHelpers::cacheLineSize];
+
+    // contended by the writers
+    int writePosition;
+    char padding1 [LockFreeQueueHelpers::cacheLineSize - sizeof (int)];
+
+    // written by the reader
+    int readPosition;
+    char padding2 [LockFreeQueueHelpers::cacheLineSize - sizeof (int)];
+
+    LockFreeMultiProducerQueue (const LockFreeMultiProducerQueue&);
+    const LockFreeMultiProducerQueue& operator= (const LockFreeMultiProducerQueue&);
+};
+
+
+#endif
@@ -0,0 +1,148 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2009 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU General Public License, as published by the Free Software Foundation;
+ either version 2 of the License, or (at your option) any later version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+#ifndef __JUCETICE_TRIPLEBUFFER_HEADER__
+#define __JUCETICE_TRIPLEBUFFER_HEADER__
+
+#include "jucetice_LockFreeQueue.h"
+
+
+//==============================================================================
+/**
+    Passes the latest value of something from one thread to another.
+
+    Unlike a queue, the reader never sees stale values piling up: it always gets
+    the most recent state the writer published, and a writer that publishes
+    faster than the reader reads simply overwrites the older states. Neither
+    side ever waits for the other.
+
+    There are three copies of the value: the writer owns one, the reader owns
+    one, and the third is the one in flight. Publishing swaps the writer's copy
+    with the one in flight, and the reader swaps its copy with it when it finds
+    something new there.
+
+    @code
+    // writer (e.g. the audio thread)
+    MeterState& state = meters.getWriteBuffer();
+    state.peak = ...;
+    meters.publish();
+
+    // reader (e.g. a timer on the message thread)
+    if (meters.update())
+        repaintWith (meters.getReadBuffer());
+    @endcode
+
+    @see LockFreeQueue
+*/
+template <class ElementType>
+class TripleBuffer
+{
+public:
+
+    //==============================================================================
+    /** Creates the buffer, with three default constructed values. */
+    TripleBuffer()
+        : shared (1),
+          writeIndex (0),
+          readIndex (2)
+    {
+    }
+
+    //==============================================================================
+    /** Returns the writer's copy, to be filled in before calling publish(). Writer thread only. */
+    ElementType& getWriteBuffer()                   { return values [writeIndex]; }
+
+    /** Hands the writer's copy over to the reader. Writer thread only.
+        After this call getWriteBuffer() returns a different copy, whose content
+        is an older state (or garbage), so it has to be filled in again.
+    */
+    void publish()
+    {
+        writeIndex = Atomic::exchange (shared, writeIndex | freshFlag) & indexMask;
+    }
+
+    /** Copies a value into the writer's copy and publishes it. Writer thread only. */
+    void write (const ElementType& newValue)
+    {
+        values [writeIndex] = newValue;
+        publish();
+    }
+
+    //==============================================================================
+    /** Picks up the last published value, if there is a new one. Reader thread only.
+        Returns true if getReadBuffer() changed.
+    */
+    bool update()
+    {
+        if ((Atomic::loadAcquire (shared) & freshFlag) == 0)
+            return false;
+
+        readIndex = Atomic::exchange (shared, readIndex) & indexMask;
+        return true;
+    }
+
+    /** Returns the reader's copy, as of the last update(). Reader thread only. */
+    const ElementType& getReadBuffer() const        { return values [readIndex]; }
+
+    /** Updates and copies out the latest value. Reader thread only.
+        Returns true if it was published after the previous read.
+    */
+    bool read (ElementType& result)
+    {
+        const bool isNew = update();
+        result = values [readIndex];
+        return isNew;
+    }
+
+    //==============================================================================
+    juce_UseDebuggingNewOperator
+
+private:
+
+    enum
+    {
+        indexMask = 3,
+        freshFlag = 4
+    };
+
+    ElementType values [3];
+
+    // index of the copy in flight, plus freshFlag when the reader hasn't seen it
+    int shared;
+    char padding0 [LockFreeQueueHelpers::cacheLineSize - sizeof (int)];
+
+    int writeIndex;
+    char padding1 [LockFreeQueueHelpers::cacheLineSize - sizeof (int)];
+
+    int readIndex;
+
+    TripleBuffer (const TripleBuffer&);
+    const TripleBuffer& operator= (const TripleBuffer&);
+};
+
+
+#endif
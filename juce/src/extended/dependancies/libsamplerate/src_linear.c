@@ -166,7 +166,7 @@ linear_set_converter (SRC_PRIVATE *psrc, int src_enum)
 		} ;
 
 	if (psrc->private_data == NULL)
-	{	linear = calloc (1, sizeof (*linear) + psrc->channels * sizeof (float)) ;
+	{	linear = (LINEAR_DATA*) calloc (1, sizeof (*linear) + psrc->channels * sizeof (float)) ;
 		if (linear == NULL)
 			return SRC_ERR_MALLOC_FAILED ;
 		psrc->private_data = linear ;
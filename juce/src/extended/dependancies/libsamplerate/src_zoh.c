@@ -157,7 +157,7 @@ zoh_set_converter (SRC_PRIVATE *psrc, int src_enum)
 		} ;
 
 	if (psrc->private_data == NULL)
-	{	zoh = calloc (1, sizeof (*zoh) + psrc->channels * sizeof (float)) ;
+	{	zoh = (ZOH_DATA*) calloc (1, sizeof (*zoh) + psrc->channels * sizeof (float)) ;
 		if (zoh == NULL)
 			return SRC_ERR_MALLOC_FAILED ;
 		psrc->private_data = zoh ;
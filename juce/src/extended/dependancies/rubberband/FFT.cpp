@@ -17,7 +17,11 @@
 #include "Profiler.h"
 
 //#define FFT_MEASUREMENT 1
+
+// when built inside jucetice, the simd RealFFT is used and kissfft isn't needed
+#ifndef USE_JUCETICE_FFT
 #define USE_KISSFFT 1
+#endif
 
 
 #ifdef HAVE_FFTW3
@@ -31,11 +35,13 @@
 
 #ifndef HAVE_FFTW3
 #ifndef USE_KISSFFT
+#ifndef USE_JUCETICE_FFT
 #ifndef USE_BUILTIN_FFT
 #error No FFT implementation selected!
 #endif
 #endif
 #endif
+#endif
 
 #include <cmath>
 #include <iostream>
@@ -862,6 +868,214 @@ private:
 
 #endif
 
+#ifdef USE_JUCETICE_FFT
+
+// JuceticeRealFFT and JuceticeFFTBuffer are typedefs of the jucetice
+// RealFFT and FFTBuffer, made by the file that includes this one
+class D_JuceticeFFT : public FFTImpl
+{
+public:
+    D_JuceticeFFT(int size) :
+        m_size(size),
+        m_fft(size),
+        m_fbuf(size),
+        m_fre(size/2 + 1),
+        m_fim(size/2 + 1),
+        m_frb(0),
+        m_drb(0)
+    {
+    }
+
+    ~D_JuceticeFFT() {
+        if (m_frb) delete[] m_frb;
+        if (m_drb) delete[] m_drb;
+    }
+
+    void initFloat() { }
+    void initDouble() { }
+
+    void forward(const double *R__ realIn, double *R__ realOut, double *R__ imagOut) {
+
+        for (int i = 0; i < m_size; ++i) {
+            m_fbuf[i] = float(realIn[i]);
+        }
+
+        m_fft.performForward(m_fbuf, m_fre, m_fim);
+
+        const int hs = m_size/2;
+
+        for (int i = 0; i <= hs; ++i) {
+            realOut[i] = m_fre[i];
+            imagOut[i] = m_fim[i];
+        }
+    }
+
+    void forwardPolar(const double *R__ realIn, double *R__ magOut, double *R__ phaseOut) {
+
+        for (int i = 0; i < m_size; ++i) {
+            m_fbuf[i] = float(realIn[i]);
+        }
+
+        m_fft.performForward(m_fbuf, m_fre, m_fim);
+
+        const int hs = m_size/2;
+
+        for (int i = 0; i <= hs; ++i) {
+            magOut[i] = sqrt(double(m_fre[i]) * double(m_fre[i]) +
+                             double(m_fim[i]) * double(m_fim[i]));
+        }
+
+        for (int i = 0; i <= hs; ++i) {
+            phaseOut[i] = atan2(double(m_fim[i]), double(m_fre[i]));
+        }
+    }
+
+    void forwardMagnitude(const double *R__ realIn, double *R__ magOut) {
+
+        for (int i = 0; i < m_size; ++i) {
+            m_fbuf[i] = float(realIn[i]);
+        }
+
+        m_fft.performForward(m_fbuf, m_fre, m_fim);
+
+        const int hs = m_size/2;
+
+        for (int i = 0; i <= hs; ++i) {
+            magOut[i] = sqrt(double(m_fre[i]) * double(m_fre[i]) +
+                             double(m_fim[i]) * double(m_fim[i]));
+        }
+    }
+
+    void forward(const float *R__ realIn, float *R__ realOut, float *R__ imagOut) {
+
+        m_fft.performForward(realIn, realOut, imagOut);
+    }
+
+    void forwardPolar(const float *R__ realIn, float *R__ magOut, float *R__ phaseOut) {
+
+        m_fft.performForward(realIn, m_fre, m_fim);
+
+        const int hs = m_size/2;
+
+        for (int i = 0; i <= hs; ++i) {
+            magOut[i] = sqrtf(m_fre[i] * m_fre[i] + m_fim[i] * m_fim[i]);
+        }
+
+        for (int i = 0; i <= hs; ++i) {
+            phaseOut[i] = atan2f(m_fim[i], m_fre[i]);
+        }
+    }
+
+    void forwardMagnitude(const float *R__ realIn, float *R__ magOut) {
+
+        m_fft.performForward(realIn, m_fre, m_fim);
+
+        const int hs = m_size/2;
+
+        for (int i = 0; i <= hs; ++i) {
+            magOut[i] = sqrtf(m_fre[i] * m_fre[i] + m_fim[i] * m_fim[i]);
+        }
+    }
+
+    void inverse(const double *R__ realIn, const double *R__ imagIn, double *R__ realOut) {
+
+        const int hs = m_size/2;
+
+        for (int i = 0; i <= hs; ++i) {
+            m_fre[i] = float(realIn[i]);
+            m_fim[i] = float(imagIn[i]);
+        }
+
+        m_fft.performInverse(m_fre, m_fim, m_fbuf);
+
+        for (int i = 0; i < m_size; ++i) {
+            realOut[i] = m_fbuf[i];
+        }
+    }
+
+    void inversePolar(const double *R__ magIn, const double *R__ phaseIn, double *R__ realOut) {
+
+        const int hs = m_size/2;
+
+        for (int i = 0; i <= hs; ++i) {
+            m_fre[i] = float(magIn[i] * cos(phaseIn[i]));
+            m_fim[i] = float(magIn[i] * sin(phaseIn[i]));
+        }
+
+        m_fft.performInverse(m_fre, m_fim, m_fbuf);
+
+        for (int i = 0; i < m_size; ++i) {
+            realOut[i] = m_fbuf[i];
+        }
+    }
+
+    void inverseCepstral(const double *R__ magIn, double *R__ cepOut) {
+
+        const int hs = m_size/2;
+
+        for (int i = 0; i <= hs; ++i) {
+            m_fre[i] = float(log(magIn[i] + 0.000001));
+            m_fim[i] = 0.0f;
+        }
+
+        m_fft.performInverse(m_fre, m_fim, m_fbuf);
+
+        for (int i = 0; i < m_size; ++i) {
+            cepOut[i] = m_fbuf[i];
+        }
+    }
+
+    void inverse(const float *R__ realIn, const float *R__ imagIn, float *R__ realOut) {
+
+        m_fft.performInverse(realIn, imagIn, realOut);
+    }
+
+    void inversePolar(const float *R__ magIn, const float *R__ phaseIn, float *R__ realOut) {
+
+        const int hs = m_size/2;
+
+        for (int i = 0; i <= hs; ++i) {
+            m_fre[i] = magIn[i] * cosf(phaseIn[i]);
+            m_fim[i] = magIn[i] * sinf(phaseIn[i]);
+        }
+
+        m_fft.performInverse(m_fre, m_fim, realOut);
+    }
+
+    void inverseCepstral(const float *R__ magIn, float *R__ cepOut) {
+
+        const int hs = m_size/2;
+
+        for (int i = 0; i <= hs; ++i) {
+            m_fre[i] = logf(magIn[i] + 0.000001f);
+            m_fim[i] = 0.0f;
+        }
+
+        m_fft.performInverse(m_fre, m_fim, cepOut);
+    }
+
+    float *getFloatTimeBuffer() {
+        if (!m_frb) m_frb = new float[m_size];
+        return m_frb;
+    }
+
+    double *getDoubleTimeBuffer() {
+        if (!m_drb) m_drb = new double[m_size];
+        return m_drb;
+    }
+
+private:
+    const int m_size;
+    JuceticeRealFFT m_fft;
+    JuceticeFFTBuffer m_fbuf;
+    JuceticeFFTBuffer m_fre;
+    JuceticeFFTBuffer m_fim;
+    float* m_frb;
+    double* m_drb;
+};
+
+#endif
+
 #ifdef USE_BUILTIN_FFT
 
 class D_Cross : public FFTImpl
@@ -1192,6 +1406,9 @@ FFT::FFT(int size, int debugLevel)
 #endif
 #ifdef HAVE_FFTW3
         m_method = 1;
+#endif
+#ifdef USE_JUCETICE_FFT
+        m_method = 4;
 #endif
     }
 
@@ -1240,6 +1457,24 @@ FFT::FFT(int size, int debugLevel)
         std::cerr << "FFT::FFT(" << size << "): ERROR: Fallback implementation not available!" << std::endl;
         abort();
 #endif
+#endif
+        break;
+
+    case 4:
+#ifdef USE_JUCETICE_FFT
+        if (debugLevel > 0) {
+            std::cerr << "FFT::FFT(" << size << "): using jucetice implementation"
+                      << std::endl;
+        }
+        d = new FFTs::D_JuceticeFFT(size);
+#else
+        std::cerr << "FFT::FFT(" << size << "): WARNING: Selected implemention not available" << std::endl;
+#ifdef USE_BUILTIN_FFT
+        d = new FFTs::D_Cross(size);
+#else
+        std::cerr << "FFT::FFT(" << size << "): ERROR: Fallback implementation not available!" << std::endl;
+        abort();
+#endif
 #endif
         break;
 
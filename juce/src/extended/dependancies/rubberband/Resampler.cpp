@@ -22,7 +22,7 @@
 #include <iostream>
 
 
-#include <samplerate.h>
+#include "../libsamplerate/samplerate.h"
 
 
 
@@ -823,6 +823,7 @@ RubberBandStretcher::Impl::study(const float *const *input, size_t samples, bool
 
             size_t got = inbuf.peek(cd.accumulator, m_windowSize);
             assert(final || got == m_windowSize);
+            (void)got;
 
             m_window->cut(cd.accumulator);
 
@@ -199,6 +199,7 @@ RubberBandStretcher::Impl::processChunks(size_t c, bool &any, bool &last)
         if (!cd.draining) {
             size_t got = cd.inbuf->peek(cd.fltbuf, m_windowSize);
             assert(got == m_windowSize || cd.inputSize >= 0);
+            (void)got;
             cd.inbuf->skip(m_increment);
             analyseChunk(c);
         }
@@ -230,6 +231,7 @@ RubberBandStretcher::Impl::processOneChunk()
         if (!cd.draining) {
             size_t got = cd.inbuf->peek(cd.fltbuf, m_windowSize);
             assert(got == m_windowSize || cd.inputSize >= 0);
+            (void)got;
             cd.inbuf->skip(m_increment);
             analyseChunk(c);
         }
@@ -106,9 +106,10 @@ void usleep(unsigned long usec)
 float *allocFloat(float *ptr, int count)
 {
     if (ptr) free((void *)ptr);
-    void *allocated;
+    void *allocated = 0;
 #ifndef _WIN32
-    if (!posix_memalign(&allocated, 16, count * sizeof(float)))
+    // posix_memalign returns zero on success, only fall back to malloc on failure
+    if (posix_memalign(&allocated, 16, count * sizeof(float)) != 0)
 #endif
         allocated = malloc(count * sizeof(float));
     for (int i = 0; i < count; ++i) ((float *)allocated)[i] = 0.f;
@@ -128,9 +129,10 @@ void freeFloat(float *ptr)
 double *allocDouble(double *ptr, int count)
 {
     if (ptr) free((void *)ptr);
-    void *allocated;
+    void *allocated = 0;
 #ifndef _WIN32
-    if (!posix_memalign(&allocated, 16, count * sizeof(double)))
+    // posix_memalign returns zero on success, only fall back to malloc on failure
+    if (posix_memalign(&allocated, 16, count * sizeof(double)) != 0)
 #endif
         allocated = malloc(count * sizeof(double));
     for (int i = 0; i < count; ++i) ((double *)allocated)[i] = 0.f;
@@ -255,7 +255,7 @@ void AudioParameter::setAudioPlugin (AudioPlugin* newPlugin, const int newIndex)
 }
 
 //==============================================================================
-void AudioParameter::handleAsyncUpdate ()
+void AudioParameter::notifyListeners ()
 {
     const ScopedLock sl (plugin->getParameterLock());
 
@@ -317,59 +317,81 @@ const String AudioParameter::defaultGetTextFunction (int partNumber, float value
 
 
 //==============================================================================
-juce_ImplementSingleton (AudioParameterThread);
+juce_ImplementSingleton (AudioParameterNotifier);
 
-AudioParameterThread::AudioParameterThread ()
-    : Thread ("AudioParameterThread"),
-      parameterChanges (8192),
+AudioParameterNotifier::AudioParameterNotifier ()
+    : dispatchingPlugin (0),
+      dispatchingThreadId (0),
       changeChecksPerSecond (50)
 {
-    startThread (6);
+    startTimer (1000 / changeChecksPerSecond);
 }
 
-AudioParameterThread::~AudioParameterThread ()
-{  
-    stopThread (5000);
+AudioParameterNotifier::~AudioParameterNotifier ()
+{
+    stopTimer ();
+
+    clearSingletonInstance ();
 }
 
-void AudioParameterThread::sendParameterChange (AudioParameter* parameter)
+void AudioParameterNotifier::addPlugin (AudioPlugin* plugin)
 {
-    parameterChanges.put (parameter);
-    
-    notify ();
+    const ScopedLock sl (lock);
+
+    plugins.addIfNotAlreadyThere (plugin);
 }
 
-int AudioParameterThread::getParametersChangeChecksPerSecond () const
+void AudioParameterNotifier::removePlugin (AudioPlugin* plugin)
 {
-    return changeChecksPerSecond;
+    const ScopedLock sl (lock);
+
+    plugins.removeValue (plugin);
+
+    // if another thread is dispatching its changes, wait for it to be done
+    while (dispatchingPlugin == plugin
+            && dispatchingThreadId != Thread::getCurrentThreadId ())
+    {
+        const ScopedUnlock ul (lock);
+        Thread::sleep (1);
+    }
 }
 
-void AudioParameterThread::setParametersChangeChecksPerSecond (const int howManyCheckPerSecond)
+int AudioParameterNotifier::getParametersChangeChecksPerSecond () const
 {
-    changeChecksPerSecond = jmax (1, jmin (100, howManyCheckPerSecond));   
+    return changeChecksPerSecond;
 }
 
-void AudioParameterThread::run()
+void AudioParameterNotifier::setParametersChangeChecksPerSecond (const int howManyCheckPerSecond)
 {
-    AudioParameter* parameter;
+    changeChecksPerSecond = jmax (1, jmin (100, howManyCheckPerSecond));
+
+    startTimer (1000 / changeChecksPerSecond);
+}
 
-    while (! threadShouldExit ())
+void AudioParameterNotifier::timerCallback ()
+{
+    // the lock is not held while the listeners are called, as they could
+    // take locks of their own, or add and remove plugins
+    for (int i = 0; ; ++i)
     {
-        int32 currentWaitTime = Time::getMillisecondCounter ();
-    
-        while (! parameterChanges.isEmpty ())
+        AudioPlugin* plugin;
+
         {
-            parameter = (AudioParameter*) parameterChanges.get ();
-            if (parameter)
-                parameter->triggerAsyncUpdate ();
-        }
+            const ScopedLock sl (lock);
 
-        currentWaitTime = 1000 / changeChecksPerSecond
-                        - (Time::getMillisecondCounter () - currentWaitTime);
+            if (i >= plugins.size ())
+                break;
+
+            plugin = plugins.getUnchecked (i);
+            dispatchingPlugin = plugin;
+            dispatchingThreadId = Thread::getCurrentThreadId ();
+        }
 
-//        wait (jmax (1, jmin (1000, currentWaitTime)));
+        plugin->dispatchParameterChanges ();
 
-        Thread::sleep (jmax (1, jmin (1000, currentWaitTime)));
+        const ScopedLock sl (lock);
+        dispatchingPlugin = 0;
+        dispatchingThreadId = 0;
     }
 }
     
@@ -31,11 +31,10 @@
 #include "../core/juce_Singleton.h"
 #include "../threads/juce_Thread.h"
 #include "../threads/juce_ScopedLock.h"
-#include "../events/juce_AsyncUpdater.h"
+#include "../events/juce_Timer.h"
 #include "../utilities/juce_DeletedAtShutdown.h"
 
 #include "utils/jucetice_FastDelegate.h"
-#include "containers/jucetice_LockFreeFifo.h"
 #include "audio/midi/jucetice_MidiAutomatorManager.h"
 
 #define AudioParameterUseMapping     0
@@ -44,7 +43,7 @@
 
 class AudioPlugin;
 class AudioParameter;
-class AudioParameterThread;
+class AudioParameterNotifier;
 class AudioProgram;
 
 
@@ -105,33 +104,39 @@ protected:
 
 //==============================================================================
 /**
-    The parameter updating thread
+    The parameter change notifier
 
-    It is a shared global static class that starts a global thread and updates
-    asyncronously the parameters and their attached listeners 
+    It is a shared global class that sweeps the changed parameters of every
+    plugin from the message thread, a fixed number of times per second.
 
+    Plugins only set a bit for every parameter that changes, from any thread,
+    so a burst of automation on the same parameter costs a single callback
+    to its listeners, and nothing is ever dropped.
+
+    @see AudioPlugin::markParameterChanged
 */
-class AudioParameterThread : public Thread,
-                             public DeletedAtShutdown
+class AudioParameterNotifier : private Timer,
+                               public DeletedAtShutdown
 {
 public:
 
     //==============================================================================
     /** Constructor */
-    AudioParameterThread ();
+    AudioParameterNotifier ();
 
     /** Destructor */
-    ~AudioParameterThread ();
+    ~AudioParameterNotifier ();
 
     //==============================================================================
-    /**
-        Set the current number of parameter update check per second
-     */
-    void sendParameterChange (AudioParameter* parameter);
+    /** Start sweeping the changed parameters of a plugin */
+    void addPlugin (AudioPlugin* plugin);
+
+    /** Stop sweeping a plugin, this is called when the plugin is deleted */
+    void removePlugin (AudioPlugin* plugin);
 
     //==============================================================================
     /**
-        Set the current number of parameter update check per second
+        Get the current number of parameter update check per second
      */
     int getParametersChangeChecksPerSecond () const;
 
@@ -141,21 +146,18 @@ public:
     void setParametersChangeChecksPerSecond (const int howManyCheckPerSecond);
 
     //==============================================================================
-    /**
-        The thread callback. Here we check for changes to parameters and trigger
-        async updates to  true if the specified output channel is part of a stereo pair
+    juce_DeclareSingleton (AudioParameterNotifier, true)
 
-        @see Thread
-    */
-    void run();
+private:
 
     //==============================================================================
-    juce_DeclareSingleton (AudioParameterThread, true)
-    
-private:
+    void timerCallback ();
 
-    LockFreeFifo<AudioParameter*> parameterChanges;
-    int changeChecksPerSecond;    
+    CriticalSection lock;
+    Array<AudioPlugin*> plugins;
+    AudioPlugin* volatile dispatchingPlugin;
+    Thread::ThreadID dispatchingThreadId;
+    int changeChecksPerSecond;
 };
 
 
@@ -164,8 +166,7 @@ private:
     This is a parameter mangler, which holds the real mangler and a set of
     functions to manipulate the real parameter.
 */
-class AudioParameter : public AsyncUpdater,
-                       public MidiAutomatable
+class AudioParameter : public MidiAutomatable
 {
 public:
 
@@ -336,7 +337,7 @@ public:
     /** @internal */
     void setAudioPlugin (AudioPlugin* newPlugin, const int newIndex);
     /** @internal */
-    void handleAsyncUpdate ();
+    void notifyListeners ();
     /** @internal */
     bool handleMidiMessage (const MidiMessage& message, int bindingNum);
 
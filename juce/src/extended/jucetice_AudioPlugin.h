@@ -37,7 +37,8 @@
 #include "../events/juce_ChangeBroadcaster.h"
 #include "../audio/midi/juce_MidiKeyboardState.h"
 #include "../audio/processors/juce_AudioProcessor.h"
-#include "containers/jucetice_LockFreeFifo.h"
+#include "../containers/juce_HeapBlock.h"
+#include "../core/juce_Atomic.h"
 
 
 //==============================================================================
@@ -59,17 +60,25 @@ public:
     //==============================================================================
     /** Constructor */
     AudioPlugin()
-        : currentProgram (0)
+        : changedParameters (0),
+          hasChangedParameters (0),
+          currentProgram (0)
     {
-        parameterThread = AudioParameterThread::getInstance ();
+        parameterNotifier = AudioParameterNotifier::getInstance ();
+        parameterNotifier->addPlugin (this);
     }
 
     /** Destructor */
     ~AudioPlugin()
     {
+        AudioParameterNotifier* const notifier = AudioParameterNotifier::getInstanceWithoutCreating ();
+
+        if (notifier != 0)
+            notifier->removePlugin (this);
+
         removeAllParameters ();
 
-        parameterThread = 0;
+        parameterNotifier = 0;
     }
 
     //==============================================================================
@@ -100,6 +109,33 @@ public:
     void setNumParameters (int numParameters)
     {
         parameters.insertMultiple (0, 0, numParameters);
+
+        const ScopedLock sl (parameterLock);
+
+        const int numWords = jmax (1, (parameters.size () + 31) / 32);
+
+        // markParameterChanged could be running on another thread, so a bigger
+        // set of bits is published in one go, and the old ones are only freed
+        // when the plugin is deleted
+        if (changedParameters == 0 || numWords > changedParameters [0])
+        {
+            HeapBlock <int>* const newSet = new HeapBlock <int> ();
+            newSet->calloc (numWords + 1);
+            (*newSet) [0] = numWords;
+            changedParameterSets.add (newSet);
+
+            int* const oldSet = changedParameters;
+
+            Atomic::memoryBarrier ();
+            changedParameters = *newSet;
+
+            // carry over what was flagged in the old set
+            if (oldSet != 0)
+            {
+                for (int word = 1; word <= oldSet [0]; ++word)
+                    Atomic::bitwiseOr ((*newSet) [word], Atomic::exchange (oldSet [word], 0));
+            }
+        }
     }
 
     /**
@@ -269,7 +305,7 @@ public:
         if (parameter)
         {
             parameter->setValue (newValue);
-            parameterThread->sendParameterChange (parameter);
+            markParameterChanged (index);
         }
     }
 
@@ -286,7 +322,7 @@ public:
         if (parameter)
         {
             parameter->setValueMapped (newValue);
-            parameterThread->sendParameterChange (parameter);
+            markParameterChanged (index);
         }
     }
 
@@ -303,6 +339,65 @@ public:
     {
         setParameterMapped (index, newValue);
         sendParamChangeMessageToListeners (index, getParameter (index));
+    }
+
+    //==============================================================================
+    /**
+        Flag a parameter as changed, so its listeners will be notified
+
+        This is safe to call from any thread, the audio one included: it only
+        sets a bit, and the notifier will call the listeners of every flagged
+        parameter once, the next time it sweeps this plugin.
+
+        @param index        the actual parameter index
+
+        @see AudioParameterNotifier
+    */
+    void markParameterChanged (const int index)
+    {
+        // the first word holds the number of words of bits that follow
+        int* const bits = changedParameters;
+
+        if (bits != 0 && ((unsigned int) index) < (unsigned int) (bits [0] * 32))
+        {
+            Atomic::bitwiseOr (bits [1 + (index >> 5)], 1 << (index & 31));
+            hasChangedParameters = 1;
+        }
+    }
+
+    /**
+        Notify the listeners of every parameter changed since the last call
+
+        @internal
+        This is called by the AudioParameterNotifier from the message thread.
+    */
+    void dispatchParameterChanges ()
+    {
+        if (Atomic::exchange ((int&) hasChangedParameters, 0) == 0)
+            return;
+
+        const ScopedLock sl (parameterLock);
+
+        int* const changed = changedParameters;
+
+        if (changed == 0)
+            return;
+
+        for (int word = 0; word < changed [0]; ++word)
+        {
+            unsigned int bits = (unsigned int) Atomic::exchange (changed [1 + word], 0);
+
+            for (int index = word * 32; bits != 0; ++index, bits >>= 1)
+            {
+                if ((bits & 1) != 0)
+                {
+                    AudioParameter* parameter = parameters [index];
+
+                    if (parameter)
+                        parameter->notifyListeners ();
+                }
+            }
+        }
     }
 
     //==============================================================================
@@ -469,7 +564,7 @@ public:
      */
     int getParametersChangeChecksPerSecond () const
     {
-        return parameterThread->getParametersChangeChecksPerSecond ();
+        return parameterNotifier->getParametersChangeChecksPerSecond ();
     }
 
     /**
@@ -477,7 +572,7 @@ public:
      */
     void setParametersChangeChecksPerSecond (const int howManyChecksPerSecond)
     {
-        parameterThread->setParametersChangeChecksPerSecond (howManyChecksPerSecond);
+        parameterNotifier->setParametersChangeChecksPerSecond (howManyChecksPerSecond);
     }
 
     //==============================================================================
@@ -545,7 +640,7 @@ public:
                         parameter->setControllerNumber (newMidiCC);
 
                         if (notifyParameterChange)
-                            parameterThread->sendParameterChange (parameter);
+                            markParameterChanged (newKey);
                     }
                 }
             }
@@ -897,7 +992,11 @@ protected:
 
     CriticalSection parameterLock;
     Array<AudioParameter*> parameters;
-    AudioParameterThread* parameterThread;
+    AudioParameterNotifier* parameterNotifier;
+
+    int* volatile changedParameters;
+    OwnedArray <HeapBlock <int> > changedParameterSets;
+    volatile int hasChangedParameters;
     
     Array<AudioProgram*> programs;
     int currentProgram;
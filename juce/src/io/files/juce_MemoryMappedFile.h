@@ -0,0 +1,93 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-9 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+
+#ifndef __JUCE_MEMORYMAPPEDFILE_JUCEHEADER__
+#define __JUCE_MEMORYMAPPEDFILE_JUCEHEADER__
+
+#include "juce_File.h"
+
+
+//==============================================================================
+/**
+    Maps the contents of a file into memory, read-only.
+
+    The data is paged in by the operating system when it's first touched, so
+    opening even a very big file is quick, and reading it doesn't need any
+    intermediate buffers or copies.
+
+    If the file can't be mapped (e.g. it doesn't exist, it's empty or it's too
+    big for the address space) then getData() will return 0.
+
+    @see FileInputStream
+*/
+class JUCE_API  MemoryMappedFile
+{
+public:
+    //==============================================================================
+    /** Maps a whole file into memory. */
+    MemoryMappedFile (const File& file);
+
+    /** Destructor. */
+    ~MemoryMappedFile();
+
+    //==============================================================================
+    /** Returns the file that was mapped. */
+    const File& getFile() const throw()             { return file; }
+
+    /** Returns the address of the first byte of the file, or 0 if it couldn't be mapped. */
+    const void* getData() const throw()             { return address; }
+
+    /** Returns the number of bytes that are mapped. */
+    int64 getSize() const throw()                   { return size; }
+
+    //==============================================================================
+    /** Tells the system that a range of the file is going to be read soon.
+
+        This just starts the paging in the background, so it won't block: it's
+        a good idea to call this ahead of a sequential read, e.g. with the next
+        block of audio that is going to be played.
+    */
+    void prefetch (int64 offset, int64 numBytes) const throw();
+
+    //==============================================================================
+    juce_UseDebuggingNewOperator
+
+private:
+    File file;
+    void* address;
+    int64 size;
+    void* fileHandle;
+    void* mappingHandle;
+
+    void openInternal();
+    void close();
+
+    MemoryMappedFile (const MemoryMappedFile&);
+    const MemoryMappedFile& operator= (const MemoryMappedFile&);
+};
+
+
+#endif   // __JUCE_MEMORYMAPPEDFILE_JUCEHEADER__
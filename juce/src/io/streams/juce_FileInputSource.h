@@ -47,6 +47,9 @@ public:
     InputStream* createInputStreamFor (const String& relatedItemPath);
     int64 hashCode() const;
 
+    /** Returns the file that this source refers to. */
+    const File& getFile() const throw()                 { return file; }
+
     //==============================================================================
     juce_UseDebuggingNewOperator
 
@@ -81,6 +81,7 @@
 #include "core/juce_Time.cpp"
 #include "containers/juce_BitArray.cpp"
 #include "containers/juce_MemoryBlock.cpp"
+#include "containers/juce_PropertyKey.cpp"
 #include "containers/juce_PropertySet.cpp"
 #include "containers/juce_Variant.cpp"
 #include "cryptography/juce_BlowFish.cpp"
@@ -93,6 +94,7 @@
 #include "io/files/juce_File.cpp"
 #include "io/files/juce_FileInputStream.cpp"
 #include "io/files/juce_FileOutputStream.cpp"
+#include "io/files/juce_MemoryMappedFile.cpp"
 #include "io/files/juce_FileSearchPath.cpp"
 #include "io/files/juce_NamedPipe.cpp"
 #include "io/files/juce_TemporaryFile.cpp"
@@ -113,12 +115,18 @@
 #include "text/juce_StringPairArray.cpp"
 #include "text/juce_XmlDocument.cpp"
 #include "text/juce_XmlElement.cpp"
+#include "text/juce_XmlPullParser.cpp"
+#include "text/juce_XmlStreamWriter.cpp"
 #include "threads/juce_InterProcessLock.cpp"
 #include "threads/juce_ReadWriteLock.cpp"
+#include "threads/juce_RealtimePolicy.cpp"
 #include "threads/juce_Thread.cpp"
 #include "threads/juce_ThreadPool.cpp"
 #include "threads/juce_TimeSliceThread.cpp"
 
+// only needs the core, so plugins that don't build the extended classes get it too
+#include "extended/audio/processors/jucetice_Denormals.cpp"
+
 #if ! JUCE_ONLY_BUILD_CORE_LIBRARY
 
 #include "containers/juce_ValueTree.cpp"
@@ -138,6 +146,7 @@
 #include "audio/audio_file_formats/juce_AudioFormat.cpp"
 #include "audio/audio_file_formats/juce_AudioFormatManager.cpp"
 #include "audio/audio_file_formats/juce_AudioSubsectionReader.cpp"
+#include "audio/audio_file_formats/juce_MemoryMappedAudioFormatReader.cpp"
 #include "audio/audio_file_formats/juce_AudioThumbnail.cpp"
 #include "audio/audio_file_formats/juce_AudioThumbnailCache.cpp"
 #include "audio/audio_file_formats/juce_QuickTimeAudioFormat.cpp"
@@ -339,6 +348,8 @@
 #include "extended/utils/jucetice_Serializable.cpp"
 #include "extended/audio/beat/jucetice_BeatDetector.cpp"
 #include "extended/audio/fft/jucetice_FFTWrapper.cpp"
+#include "extended/audio/fft/jucetice_RealFFT.cpp"
+#include "extended/audio/analysis/jucetice_AnalysisTap.cpp"
 #include "extended/audio/formats/jucetice_MADAudioFormat.cpp"
 #include "extended/audio/formats/jucetice_MPCAudioFormat.cpp"
 #include "extended/audio/lash/jucetice_LashManager.cpp"
@@ -354,6 +365,10 @@
 #include "extended/audio/osc/jucetice_OpenSoundMessage.cpp"
 #include "extended/audio/osc/jucetice_OpenSoundTimeTag.cpp"
 #include "extended/audio/processors/jucetice_AudioSourceProcessor.cpp"
+#include "extended/audio/processors/jucetice_VectorOps.cpp"
+#include "extended/audio/resampler/jucetice_Resampler.cpp"
+#include "extended/audio/resampler/jucetice_Oversampler.cpp"
+#include "extended/audio/timestretch/jucetice_TimeStretcher.cpp"
 #include "extended/database/jucetice_Sqlite.cpp"
 #include "extended/controls/jucetice_ImageSlider.cpp"
 #include "extended/controls/jucetice_ImageKnob.cpp"
@@ -47,6 +47,9 @@
 #ifndef __JUCE_OWNEDARRAY_JUCEHEADER__
  #include "containers/juce_OwnedArray.h"
 #endif
+#ifndef __JUCE_PROPERTYKEY_JUCEHEADER__
+ #include "containers/juce_PropertyKey.h"
+#endif
 #ifndef __JUCE_PROPERTYSET_JUCEHEADER__
  #include "containers/juce_PropertySet.h"
 #endif
@@ -158,6 +161,9 @@
 #ifndef __JUCE_FILESEARCHPATH_JUCEHEADER__
  #include "io/files/juce_FileSearchPath.h"
 #endif
+#ifndef __JUCE_MEMORYMAPPEDFILE_JUCEHEADER__
+ #include "io/files/juce_MemoryMappedFile.h"
+#endif
 #ifndef __JUCE_NAMEDPIPE_JUCEHEADER__
  #include "io/files/juce_NamedPipe.h"
 #endif
@@ -224,6 +230,12 @@
 #ifndef __JUCE_XMLELEMENT_JUCEHEADER__
  #include "text/juce_XmlElement.h"
 #endif
+#ifndef __JUCE_XMLPULLPARSER_JUCEHEADER__
+ #include "text/juce_XmlPullParser.h"
+#endif
+#ifndef __JUCE_XMLSTREAMWRITER_JUCEHEADER__
+ #include "text/juce_XmlStreamWriter.h"
+#endif
 #ifndef __JUCE_CRITICALSECTION_JUCEHEADER__
  #include "threads/juce_CriticalSection.h"
 #endif
@@ -236,6 +248,9 @@
 #ifndef __JUCE_READWRITELOCK_JUCEHEADER__
  #include "threads/juce_ReadWriteLock.h"
 #endif
+#ifndef __JUCE_REALTIMEPOLICY_JUCEHEADER__
+ #include "threads/juce_RealtimePolicy.h"
+#endif
 #ifndef __JUCE_SCOPEDLOCK_JUCEHEADER__
  #include "threads/juce_ScopedLock.h"
 #endif
@@ -260,5 +275,8 @@
 #ifndef __JUCE_WAITABLEEVENT_JUCEHEADER__
  #include "threads/juce_WaitableEvent.h"
 #endif
+#ifndef __JUCETICE_DENORMALS_HEADER__
+ #include "extended/audio/processors/jucetice_Denormals.h"
+#endif
 
 #endif
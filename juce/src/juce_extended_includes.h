@@ -60,6 +60,12 @@
 #ifndef __JUCETICE_FFTWRAPPER_HEADER__
  #include "extended/audio/fft/jucetice_FFTWrapper.h"
 #endif
+#ifndef __JUCETICE_REALFFT_HEADER__
+ #include "extended/audio/fft/jucetice_RealFFT.h"
+#endif
+#ifndef __JUCETICE_ANALYSISTAP_HEADER__
+ #include "extended/audio/analysis/jucetice_AnalysisTap.h"
+#endif
 #ifndef __JUCETICE_MPCAUDIOFORMAT_HEADER__
  #include "extended/audio/formats/jucetice_MADAudioFormat.h"
 #endif
@@ -105,6 +111,12 @@
 #ifndef __JUCETICE_AUDIOSOURCEPROCESSOR_HEADER__
  #include "extended/audio/processors/jucetice_AudioSourceProcessor.h"
 #endif
+#ifndef __JUCETICE_VECTOROPS_HEADER__
+ #include "extended/audio/processors/jucetice_VectorOps.h"
+#endif
+#ifndef __JUCETICE_PARAMETERRAMP_HEADER__
+ #include "extended/audio/processors/jucetice_ParameterRamp.h"
+#endif
 
 #ifndef __JUCETICE_SQLITE_HEADER__
  #include "extended/database/jucetice_Sqlite.h"
@@ -119,8 +131,11 @@
 #ifndef __JUCETICE_CIRCULARBUFFER_HEADER__
  #include "extended/containers/jucetice_CircularBuffer.h"
 #endif
-#ifndef __JUCETICE_LOCKFREEFIFO_HEADER__
- #include "extended/containers/jucetice_LockFreeFifo.h"
+#ifndef __JUCETICE_LOCKFREEQUEUE_HEADER__
+ #include "extended/containers/jucetice_LockFreeQueue.h"
+#endif
+#ifndef __JUCETICE_TRIPLEBUFFER_HEADER__
+ #include "extended/containers/jucetice_TripleBuffer.h"
 #endif
 #ifndef __JUCETICE_LOOKUPTABLE_HEADER__
  #include "extended/containers/jucetice_LookupTable.h"
@@ -128,6 +143,15 @@
 #ifndef __JUCETICE_SHAREDPOINTER_HEADER__
  #include "extended/containers/jucetice_SharedPointer.h"
 #endif
+#ifndef __JUCETICE_RESAMPLER_HEADER__
+ #include "extended/audio/resampler/jucetice_Resampler.h"
+#endif
+#ifndef __JUCETICE_OVERSAMPLER_HEADER__
+ #include "extended/audio/resampler/jucetice_Oversampler.h"
+#endif
+#ifndef __JUCETICE_TIMESTRETCHER_HEADER__
+ #include "extended/audio/timestretch/jucetice_TimeStretcher.h"
+#endif
 
 #ifndef __JUCETICE_FASTDELEGATES_HEADER__
  #include "extended/utils/jucetice_FastDelegate.h"
@@ -395,6 +395,58 @@ const String juce_getVolumeLabel (const String& filenameOnVolume,
 }
 
 
+//==============================================================================
+void MemoryMappedFile::openInternal()
+{
+    const int fd = open ((const char*) file.getFullPathName().toUTF8(), O_RDONLY, 00644);
+
+    if (fd != -1)
+    {
+        fileHandle = (void*) (pointer_sized_int) fd;
+
+        const int64 fileSize = file.getSize();
+
+        if (fileSize > 0 && (int64) (size_t) fileSize == fileSize)
+        {
+            void* const m = mmap (0, (size_t) fileSize, PROT_READ, MAP_SHARED, fd, 0);
+
+            if (m != MAP_FAILED)
+            {
+                address = m;
+                size = fileSize;
+            }
+        }
+    }
+}
+
+void MemoryMappedFile::close()
+{
+    if (address != 0)
+        munmap (address, (size_t) size);
+
+    if (fileHandle != 0)
+        ::close ((int) (pointer_sized_int) fileHandle);
+
+    address = 0;
+    size = 0;
+    fileHandle = 0;
+}
+
+void MemoryMappedFile::prefetch (int64 offset, int64 numBytes) const throw()
+{
+    if (address == 0)
+        return;
+
+    // madvise wants the start on a page boundary
+    const int64 pageSize = (int64) getpagesize();
+    const int64 start = jlimit ((int64) 0, size, offset) & ~(pageSize - 1);
+    const int64 end = jlimit ((int64) 0, size, offset + numBytes);
+
+    if (end > start)
+        madvise (((char*) address) + start, (size_t) (end - start), MADV_WILLNEED);
+}
+
+
 //==============================================================================
 void juce_runSystemCommand (const String& command)
 {
@@ -35,6 +35,7 @@
 BEGIN_JUCE_NAMESPACE
 
 #include "../io/files/juce_FileInputStream.h"
+#include "../io/files/juce_MemoryMappedFile.h"
 #include "../io/files/juce_FileOutputStream.h"
 #include "../core/juce_SystemStats.h"
 #include "../core/juce_Time.h"
@@ -58,6 +59,8 @@ BEGIN_JUCE_NAMESPACE
 #include "../events/juce_MessageManager.h"
 #include "../threads/juce_WaitableEvent.h"
 #include "../threads/juce_Process.h"
+#include "../threads/juce_RealtimePolicy.h"
+#include "../extended/containers/jucetice_LockFreeQueue.h"
 #include "../gui/components/filebrowser/juce_FileChooser.h"
 #include "../audio/devices/juce_MidiOutput.h"
 #include "../audio/devices/juce_MidiInput.h"
@@ -46,6 +46,7 @@ BEGIN_JUCE_NAMESPACE
 #include "../threads/juce_Thread.h"
 #include "../threads/juce_InterProcessLock.h"
 #include "../io/files/juce_FileInputStream.h"
+#include "../io/files/juce_MemoryMappedFile.h"
 #include "../io/files/juce_NamedPipe.h"
 #include "../io/network/juce_URL.h"
 #include "../core/juce_PlatformUtilities.h"
@@ -513,6 +513,8 @@ public:
 
     void run()
     {
+        RealtimePolicy::applyToCurrentThread (RealtimePolicy::audioThread);
+
         while (! threadShouldExit())
         {
             if (inputDevice != 0)
@@ -90,7 +90,10 @@ static snd_seq_t* iterateDevices (const bool forInput,
                                                                                        : (SND_SEQ_PORT_CAP_READ | SND_SEQ_PORT_CAP_SUBS_READ),
                                                                               SND_SEQ_PORT_TYPE_MIDI_GENERIC);
 
-                                            snd_seq_connect_from (seqHandle, portId, sourceClient, sourcePort);
+                                            if (forInput)
+                                                snd_seq_connect_from (seqHandle, portId, sourceClient, sourcePort);
+                                            else
+                                                snd_seq_connect_to (seqHandle, portId, sourceClient, sourcePort);
 
                                             returnedHandle = seqHandle;
                                         }
@@ -150,15 +153,35 @@ static snd_seq_t* createDevice (const bool forInput,
 }
 
 //==============================================================================
-class MidiOutputDevice
+// the sequencer's clocks run off the same kernel timers as the monotonic clock,
+// and reading it is done in the vdso, so the audio thread can call this
+static double getMonotonicSeconds() throw()
+{
+    struct timespec t;
+    clock_gettime (CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1.0e-9;
+}
+
+//==============================================================================
+class MidiOutputDevice  : public Thread
 {
 public:
     MidiOutputDevice (MidiOutput* const midiOutput_,
                       snd_seq_t* const seqHandle_)
-        :
+        : Thread (T("Juce MIDI Output")),
           midiOutput (midiOutput_),
           seqHandle (seqHandle_),
-          maxEventSize (16 * 1024)
+          maxEventSize (16 * 1024),
+          scheduled (scheduledQueueSize),
+          queueId (-1),
+          latency (0.0),
+          isAnchored (false),
+          anchorSample (0),
+          lastBlockStart (-1),
+          anchorTime (0.0),
+          anchorSampleRate (44100.0),
+          queueClockOffset (0.0),
+          nextClockCheck (0.0)
     {
         jassert (seqHandle != 0 && midiOutput != 0);
         snd_midi_event_new (maxEventSize, &midiParser);
@@ -166,35 +189,117 @@ public:
 
     ~MidiOutputDevice()
     {
+        stopScheduledOutput();
+
         snd_midi_event_free (midiParser);
         snd_seq_close (seqHandle);
     }
 
     void sendMessageNow (const MidiMessage& message)
     {
-        if (message.getRawDataSize() > maxEventSize)
+        const ScopedLock sl (outputLock);
+
+        outputEvent (message.getRawData(), message.getRawDataSize(), 0);
+        snd_seq_drain_output (seqHandle);
+    }
+
+    //==============================================================================
+    bool startScheduledOutput (const double latencySeconds)
+    {
+        stopScheduledOutput();
+
+        int newQueueId;
+
         {
-            maxEventSize = message.getRawDataSize();
-            snd_midi_event_free (midiParser);
-            snd_midi_event_new (maxEventSize, &midiParser);
+            const ScopedLock sl (outputLock);
+
+            newQueueId = snd_seq_alloc_named_queue (seqHandle, "Juce Midi Out Queue");
+
+            if (newQueueId < 0)
+                return false;
+
+            snd_seq_start_queue (seqHandle, newQueueId, 0);
+            snd_seq_drain_output (seqHandle);
         }
 
-        snd_seq_event_t event;
-        snd_seq_ev_clear (&event);
+        latency = jmax (0.0, latencySeconds);
+        isAnchored = false;
+        lastBlockStart = -1;
+        scheduled.reset();
 
-        snd_midi_event_encode (midiParser,
-                               message.getRawData(),
-                               message.getRawDataSize(),
-                               &event);
+        queueClockOffset = readQueueClockOffset (newQueueId);
+        nextClockCheck = getMonotonicSeconds() + 1.0;
 
-        snd_midi_event_reset_encode (midiParser);
+        {
+            // the audio thread starts pushing blocks as soon as it sees a queue,
+            // so the queue is only published once the state above is ready for them
+            const ScopedLock sl (outputLock);
+            queueId = newQueueId;
+        }
 
-        snd_seq_ev_set_source (&event, 0);
-        snd_seq_ev_set_subs (&event);
-        snd_seq_ev_set_direct (&event);
+        startThread (9);
+        return true;
+    }
 
-        snd_seq_event_output (seqHandle, &event);
-        snd_seq_drain_output (seqHandle);
+    void stopScheduledOutput()
+    {
+        stopThread (2000);
+
+        const ScopedLock sl (outputLock);
+
+        if (queueId >= 0)
+        {
+            // freeing the queue throws away whatever it hasn't played yet
+            snd_seq_stop_queue (seqHandle, queueId, 0);
+            snd_seq_drain_output (seqHandle);
+            snd_seq_free_queue (seqHandle, queueId);
+            queueId = -1;
+        }
+    }
+
+    // called by the audio thread: only touches the queue
+    bool scheduleBlockOfMessages (const MidiBuffer& buffer,
+                                  const int64 blockStartSample,
+                                  const double sampleRate) throw()
+    {
+        if (queueId < 0 || sampleRate <= 0)
+            return false;
+
+        ScheduledHeader header;
+        header.blockStart = blockStartSample;
+        header.blockTime = getMonotonicSeconds();
+        header.sampleRate = sampleRate;
+
+        bool allQueued = true;
+
+        MidiBuffer::Iterator i (buffer);
+        const uint8* data;
+        int numBytes, samplePosition;
+
+        while (i.getNextEvent (data, numBytes, samplePosition))
+        {
+            header.samplePosition = blockStartSample + samplePosition;
+            header.numBytes = numBytes;
+
+            if (! pushScheduled (header, data))
+                allQueued = false;
+        }
+
+        return allQueued;
+    }
+
+    //==============================================================================
+    void run()
+    {
+        RealtimePolicy::applyToCurrentThread (RealtimePolicy::midiOutputThread);
+
+        while (! threadShouldExit())
+        {
+            // the audio thread never signals, the queue is polled and the
+            // latency leaves room for this sleep
+            if (! sendScheduledEvents())
+                sleep (1);
+        }
     }
 
     juce_UseDebuggingNewOperator
@@ -204,6 +309,220 @@ private:
     snd_seq_t* const seqHandle;
     snd_midi_event_t* midiParser;
     int maxEventSize;
+    CriticalSection outputLock;
+
+    //==============================================================================
+    // the scheduled messages are stored in the queue as a header followed by the
+    // raw midi bytes, written and published in one go
+    struct ScheduledHeader
+    {
+        int64 samplePosition;
+        int64 blockStart;
+        double blockTime;
+        double sampleRate;
+        int numBytes;
+    };
+
+    enum { scheduledQueueSize = 64 * 1024 };
+
+    LockFreeQueue <uint8> scheduled;
+    MemoryBlock scratch;
+    int queueId;
+    double latency;
+
+    // the audio clock: the time of sample anchorSample, and the sequencer clock
+    bool isAnchored;
+    int64 anchorSample, lastBlockStart;
+    double anchorTime, anchorSampleRate;
+    double queueClockOffset, nextClockCheck;
+
+    //==============================================================================
+    bool pushScheduled (const ScheduledHeader& header, const uint8* const data) throw()
+    {
+        const int total = sizeof (ScheduledHeader) + header.numBytes;
+
+        uint8* block1;
+        uint8* block2;
+        int size1, size2;
+
+        if (scheduled.prepareToWrite (total, block1, size1, block2, size2) < total)
+            return false;
+
+        copyToSpans ((const uint8*) &header, sizeof (ScheduledHeader), 0, block1, size1, block2);
+        copyToSpans (data, header.numBytes, sizeof (ScheduledHeader), block1, size1, block2);
+
+        scheduled.finishedWrite (total);
+        return true;
+    }
+
+    static void copyToSpans (const uint8* source, const int numBytes, const int offset,
+                             uint8* const block1, const int size1, uint8* const block2) throw()
+    {
+        for (int i = 0; i < numBytes; ++i)
+        {
+            const int pos = offset + i;
+
+            if (pos < size1)
+                block1 [pos] = source[i];
+            else
+                block2 [pos - size1] = source[i];
+        }
+    }
+
+    static void copyFromSpans (uint8* dest, const int numBytes, const int offset,
+                               const uint8* const block1, const int size1, const uint8* const block2) throw()
+    {
+        for (int i = 0; i < numBytes; ++i)
+        {
+            const int pos = offset + i;
+            dest[i] = (pos < size1) ? block1 [pos] : block2 [pos - size1];
+        }
+    }
+
+    //==============================================================================
+    bool sendScheduledEvents()
+    {
+        bool sentAny = false;
+
+        for (;;)
+        {
+            uint8* block1;
+            uint8* block2;
+            int size1, size2;
+
+            if (scheduled.prepareToRead (sizeof (ScheduledHeader), block1, size1, block2, size2)
+                  < (int) sizeof (ScheduledHeader))
+                break;
+
+            ScheduledHeader header;
+            copyFromSpans ((uint8*) &header, sizeof (ScheduledHeader), 0, block1, size1, block2);
+
+            // a record is published whole, so its bytes are all there
+            const int total = sizeof (ScheduledHeader) + header.numBytes;
+            scheduled.prepareToRead (total, block1, size1, block2, size2);
+
+            scratch.ensureSize (header.numBytes);
+            copyFromSpans ((uint8*) scratch.getData(), header.numBytes, sizeof (ScheduledHeader),
+                           block1, size1, block2);
+
+            scheduled.finishedRead (total);
+
+            const double eventTime = getEventTime (header) - queueClockOffset;
+
+            snd_seq_real_time_t time;
+            time.tv_sec = (unsigned int) jmax (0.0, eventTime);
+            time.tv_nsec = (unsigned int) jlimit (0.0, 999999999.0, (jmax (0.0, eventTime) - time.tv_sec) * 1.0e9);
+
+            const ScopedLock sl (outputLock);
+            outputEvent ((const uint8*) scratch.getData(), header.numBytes, &time);
+            sentAny = true;
+        }
+
+        if (sentAny)
+        {
+            const ScopedLock sl (outputLock);
+            snd_seq_drain_output (seqHandle);
+        }
+
+        const double now = getMonotonicSeconds();
+
+        if (now >= nextClockCheck)
+        {
+            // the two clocks only drift apart slowly, so this is smoothed to
+            // keep the time it takes to read the queue status out of it
+            queueClockOffset += 0.1 * (readQueueClockOffset (queueId) - queueClockOffset);
+            nextClockCheck = now + 1.0;
+        }
+
+        return sentAny;
+    }
+
+    // works out when an event should play from its sample position: the block
+    // times are only used to steer the audio clock, so a late callback doesn't
+    // make its events late
+    double getEventTime (const ScheduledHeader& header)
+    {
+        if (header.blockStart != lastBlockStart)
+        {
+            lastBlockStart = header.blockStart;
+
+            const double expected = anchorTime + (header.blockStart - anchorSample) / anchorSampleRate;
+            const double error = header.blockTime - expected;
+
+            if (! isAnchored
+                 || header.sampleRate != anchorSampleRate
+                 || fabs (error) > 0.05)
+            {
+                isAnchored = true;
+                anchorSample = header.blockStart;
+                anchorTime = header.blockTime;
+                anchorSampleRate = header.sampleRate;
+            }
+            else
+            {
+                anchorTime += 0.02 * error;
+            }
+        }
+
+        return anchorTime + latency + (header.samplePosition - anchorSample) / anchorSampleRate;
+    }
+
+    double readQueueClockOffset (const int queue)
+    {
+        double offset = 0.0;
+        snd_seq_queue_status_t* status;
+
+        if (snd_seq_queue_status_malloc (&status) == 0)
+        {
+            const ScopedLock sl (outputLock);
+
+            const double before = getMonotonicSeconds();
+
+            if (queue >= 0 && snd_seq_get_queue_status (seqHandle, queue, status) == 0)
+            {
+                const double after = getMonotonicSeconds();
+                const snd_seq_real_time_t* const queueTime = snd_seq_queue_status_get_real_time (status);
+
+                offset = (before + after) * 0.5 - (queueTime->tv_sec + queueTime->tv_nsec * 1.0e-9);
+            }
+
+            snd_seq_queue_status_free (status);
+        }
+
+        return offset;
+    }
+
+    //==============================================================================
+    // sends straight away if time is null, otherwise on the queue at that time.
+    // The caller has to hold outputLock
+    void outputEvent (const uint8* const data, const int numBytes, const snd_seq_real_time_t* const time)
+    {
+        if (numBytes > maxEventSize)
+        {
+            maxEventSize = numBytes;
+            snd_midi_event_free (midiParser);
+            snd_midi_event_new (maxEventSize, &midiParser);
+        }
+
+        snd_seq_event_t event;
+        snd_seq_ev_clear (&event);
+
+        snd_midi_event_encode (midiParser, data, numBytes, &event);
+        snd_midi_event_reset_encode (midiParser);
+
+        snd_seq_ev_set_source (&event, 0);
+        snd_seq_ev_set_subs (&event);
+
+        if (time != 0 && queueId >= 0)
+            snd_seq_ev_schedule_real (&event, queueId, 0, time);
+        else
+            snd_seq_ev_set_direct (&event);
+
+        snd_seq_event_output (seqHandle, &event);
+    }
+
+    MidiOutputDevice (const MidiOutputDevice&);
+    const MidiOutputDevice& operator= (const MidiOutputDevice&);
 };
 
 const StringArray MidiOutput::getDevices()
@@ -259,6 +578,23 @@ void MidiOutput::reset()
 {
 }
 
+bool MidiOutput::startScheduledOutput (const double latencySeconds)
+{
+    return ((MidiOutputDevice*) internal)->startScheduledOutput (latencySeconds);
+}
+
+void MidiOutput::stopScheduledOutput()
+{
+    ((MidiOutputDevice*) internal)->stopScheduledOutput();
+}
+
+bool MidiOutput::scheduleBlockOfMessages (const MidiBuffer& buffer,
+                                          const int64 blockStartSample,
+                                          const double sampleRate) throw()
+{
+    return ((MidiOutputDevice*) internal)->scheduleBlockOfMessages (buffer, blockStartSample, sampleRate);
+}
+
 bool MidiOutput::getVolume (float& leftVol, float& rightVol)
 {
     return false;
@@ -296,6 +632,8 @@ public:
 
     void run()
     {
+        RealtimePolicy::applyToCurrentThread (RealtimePolicy::midiInputThread);
+
         const int maxEventSize = 16 * 1024;
         snd_midi_event_t* midiParser;
 
@@ -439,6 +777,9 @@ void MidiOutput::reset()    {}
 bool MidiOutput::getVolume (float&, float&)     { return false; }
 void MidiOutput::setVolume (float, float)       {}
 void MidiOutput::sendMessageNow (const MidiMessage&)    {}
+bool MidiOutput::startScheduledOutput (const double)    { return false; }
+void MidiOutput::stopScheduledOutput()                  {}
+bool MidiOutput::scheduleBlockOfMessages (const MidiBuffer&, const int64, const double) throw()     { return false; }
 
 MidiInput::MidiInput (const String& name_) : name (name_), internal (0)  {}
 MidiInput::~MidiInput() {}
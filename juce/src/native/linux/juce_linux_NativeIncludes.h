@@ -58,6 +58,8 @@
 #include <linux/if.h>
 #include <sys/sysinfo.h>
 #include <sys/file.h>
+#include <sys/mman.h>
+#include <malloc.h>
 #include <signal.h>
 
 /* Got a build error here? You'll need to install the freetype library...
@@ -137,7 +137,7 @@ void Thread::setCurrentThreadAffinityMask (const uint32 affinityMask)
        then you can just disable all this stuff by removing the SUPPORT_AFFINITIES macro
        from the linuxincludes.h file.
     */
-    sched_setaffinity (getpid(), sizeof (cpu_set_t), &affinity);
+    sched_setaffinity (0, sizeof (cpu_set_t), &affinity);
     sched_yield();
 
 #else
@@ -153,6 +153,108 @@ void Thread::yield()
     sched_yield();
 }
 
+//==============================================================================
+bool juce_setCurrentThreadRealtimePriority (const int priority, String& error)
+{
+    struct sched_param param;
+    zerostruct (param);
+    param.sched_priority = jlimit (sched_get_priority_min (SCHED_FIFO),
+                                   sched_get_priority_max (SCHED_FIFO),
+                                   priority);
+
+    const int result = pthread_setschedparam (pthread_self(), SCHED_FIFO, &param);
+
+    if (result != 0)
+    {
+        error = String (strerror (result));
+        return false;
+    }
+
+    return true;
+}
+
+bool juce_setCurrentThreadAffinity (const uint32 affinityMask, String& error)
+{
+#if SUPPORT_AFFINITIES
+    cpu_set_t affinity;
+    CPU_ZERO (&affinity);
+
+    for (int i = 0; i < 32; ++i)
+        if ((affinityMask & (1 << i)) != 0)
+            CPU_SET (i, &affinity);
+
+    if (sched_setaffinity (0, sizeof (cpu_set_t), &affinity) != 0)
+    {
+        error = String (strerror (errno));
+        return false;
+    }
+
+    return true;
+#else
+    error = T("affinities not supported");
+    return false;
+#endif
+}
+
+bool juce_lockProcessMemory (String& error)
+{
+    if (mlockall (MCL_CURRENT | MCL_FUTURE) != 0)
+    {
+        error = String (strerror (errno));
+        return false;
+    }
+
+    return true;
+}
+
+void juce_prefaultHeap (const int numBytes)
+{
+    // keep freed memory in the heap rather than giving it back to the system,
+    // and never serve big blocks from their own mappings, so the pages touched
+    // here stay mapped for the allocations that come later
+    mallopt (M_TRIM_THRESHOLD, -1);
+    mallopt (M_MMAP_MAX, 0);
+
+    char* const block = (char*) ::malloc (numBytes);
+
+    if (block != 0)
+    {
+        const int pageSize = (int) sysconf (_SC_PAGESIZE);
+
+        for (int i = 0; i < numBytes; i += pageSize)
+            ((volatile char*) block)[i] = 0;
+
+        ::free (block);
+    }
+}
+
+bool juce_getCurrentThreadScheduling (bool& isRealtime, int& priority, uint32& affinityMask)
+{
+    struct sched_param param;
+    int policy;
+
+    if (pthread_getschedparam (pthread_self(), &policy, &param) != 0)
+        return false;
+
+    isRealtime = (policy == SCHED_FIFO || policy == SCHED_RR);
+    priority = isRealtime ? param.sched_priority : 0;
+    affinityMask = 0;
+
+#if SUPPORT_AFFINITIES
+    cpu_set_t affinity;
+    CPU_ZERO (&affinity);
+
+    if (sched_getaffinity (0, sizeof (cpu_set_t), &affinity) != 0)
+        return false;
+
+    for (int i = 0; i < 32; ++i)
+        if (CPU_ISSET (i, &affinity))
+            affinityMask |= (1 << i);
+#endif
+
+    return true;
+}
+
 
 //==============================================================================
 // sets the process to 0=low priority, 1=normal, 2=high, 3=realtime
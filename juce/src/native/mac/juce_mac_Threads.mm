@@ -88,6 +88,53 @@ void Thread::yield()
     sched_yield();
 }
 
+//==============================================================================
+bool juce_setCurrentThreadRealtimePriority (const int /*priority*/, String& error)
+{
+    // xxx
+    error = T("not supported");
+    return false;
+}
+
+bool juce_setCurrentThreadAffinity (const uint32 /*affinityMask*/, String& error)
+{
+    error = T("not supported");
+    return false;
+}
+
+bool juce_lockProcessMemory (String& error)
+{
+    error = T("not supported");
+    return false;
+}
+
+void juce_prefaultHeap (const int numBytes)
+{
+    char* const block = (char*) ::malloc (numBytes);
+
+    if (block != 0)
+    {
+        for (int i = 0; i < numBytes; i += 4096)
+            ((volatile char*) block)[i] = 0;
+
+        ::free (block);
+    }
+}
+
+bool juce_getCurrentThreadScheduling (bool& isRealtime, int& priority, uint32& affinityMask)
+{
+    struct sched_param param;
+    int policy;
+
+    if (pthread_getschedparam (pthread_self(), &policy, &param) != 0)
+        return false;
+
+    isRealtime = (policy == SCHED_FIFO || policy == SCHED_RR);
+    priority = isRealtime ? param.sched_priority : 0;
+    affinityMask = 0;
+    return true;
+}
+
 void Thread::setCurrentThreadAffinityMask (const uint32 affinityMask)
 {
     // xxx
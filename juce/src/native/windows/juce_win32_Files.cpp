@@ -235,6 +235,57 @@ int64 juce_getFileSize (const String& fileName)
     return 0;
 }
 
+//==============================================================================
+void MemoryMappedFile::openInternal()
+{
+    HANDLE h = CreateFile (file.getFullPathName(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, 0,
+                           OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, 0);
+
+    if (h != INVALID_HANDLE_VALUE)
+    {
+        fileHandle = (void*) h;
+
+        const int64 fileSize = file.getSize();
+
+        if (fileSize > 0 && (int64) (size_t) fileSize == fileSize)
+        {
+            HANDLE m = CreateFileMapping (h, 0, PAGE_READONLY, 0, 0, 0);
+
+            if (m != 0)
+            {
+                mappingHandle = (void*) m;
+                address = MapViewOfFile (m, FILE_MAP_READ, 0, 0, 0);
+
+                if (address != 0)
+                    size = fileSize;
+            }
+        }
+    }
+}
+
+void MemoryMappedFile::close()
+{
+    if (address != 0)
+        UnmapViewOfFile (address);
+
+    if (mappingHandle != 0)
+        CloseHandle ((HANDLE) mappingHandle);
+
+    if (fileHandle != 0)
+        CloseHandle ((HANDLE) fileHandle);
+
+    address = 0;
+    size = 0;
+    mappingHandle = 0;
+    fileHandle = 0;
+}
+
+void MemoryMappedFile::prefetch (int64, int64) const throw()
+{
+    // there's no non-blocking way of doing this before Windows 8, but the
+    // file is opened for sequential scan so the cache manager reads ahead
+}
+
 //==============================================================================
 static int64 fileTimeToTime (const FILETIME* const ft)
 {
@@ -213,6 +213,57 @@ void Thread::yield()
     Sleep (0);
 }
 
+//==============================================================================
+bool juce_setCurrentThreadRealtimePriority (const int /*priority*/, String& error)
+{
+    // windows has no per-thread realtime priorities, the nearest is time critical
+    if (! SetThreadPriority (GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL))
+    {
+        error = T("SetThreadPriority failed");
+        return false;
+    }
+
+    return true;
+}
+
+bool juce_setCurrentThreadAffinity (const uint32 affinityMask, String& error)
+{
+    if (SetThreadAffinityMask (GetCurrentThread(), affinityMask) == 0)
+    {
+        error = T("SetThreadAffinityMask failed");
+        return false;
+    }
+
+    return true;
+}
+
+bool juce_lockProcessMemory (String& error)
+{
+    error = T("not supported");
+    return false;
+}
+
+void juce_prefaultHeap (const int numBytes)
+{
+    char* const block = (char*) ::malloc (numBytes);
+
+    if (block != 0)
+    {
+        for (int i = 0; i < numBytes; i += 4096)
+            ((volatile char*) block)[i] = 0;
+
+        ::free (block);
+    }
+}
+
+bool juce_getCurrentThreadScheduling (bool& isRealtime, int& priority, uint32& affinityMask)
+{
+    isRealtime = (GetThreadPriority (GetCurrentThread()) == THREAD_PRIORITY_TIME_CRITICAL);
+    priority = isRealtime ? THREAD_PRIORITY_TIME_CRITICAL : 0;
+    affinityMask = 0;
+    return true;
+}
+
 void JUCE_CALLTYPE Thread::sleep (const int millisecs)
 {
     if (millisecs >= 10)
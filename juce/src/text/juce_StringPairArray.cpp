@@ -33,14 +33,16 @@ BEGIN_JUCE_NAMESPACE
 
 //==============================================================================
 StringPairArray::StringPairArray (const bool ignoreCase_) throw()
-    : ignoreCase (ignoreCase_)
+    : ignoreCase (ignoreCase_),
+      numChanges (0)
 {
 }
 
 StringPairArray::StringPairArray (const StringPairArray& other) throw()
     : keys (other.keys),
       values (other.values),
-      ignoreCase (other.ignoreCase)
+      ignoreCase (other.ignoreCase),
+      numChanges (0)
 {
 }
 
@@ -52,6 +54,7 @@ const StringPairArray& StringPairArray::operator= (const StringPairArray& other)
 {
     keys = other.keys;
     values = other.values;
+    ++numChanges;
 
     return *this;
 }
@@ -99,6 +102,8 @@ void StringPairArray::set (const String& key,
         keys.add (key);
         values.add (value);
     }
+
+    ++numChanges;
 }
 
 void StringPairArray::addArray (const StringPairArray& other)
@@ -111,6 +116,7 @@ void StringPairArray::clear() throw()
 {
     keys.clear();
     values.clear();
+    ++numChanges;
 }
 
 void StringPairArray::remove (const String& key) throw()
@@ -122,11 +128,13 @@ void StringPairArray::remove (const int index) throw()
 {
     keys.remove (index);
     values.remove (index);
+    ++numChanges;
 }
 
 void StringPairArray::setIgnoresCase (const bool shouldIgnoreCase) throw()
 {
     ignoreCase = shouldIgnoreCase;
+    ++numChanges;
 }
 
 const String StringPairArray::getDescription() const
@@ -158,8 +158,14 @@ public:
     juce_UseDebuggingNewOperator
 
 private:
+    friend class PropertySet;
+
     StringArray keys, values;
     bool ignoreCase;
+
+    // counts the changes made by the public methods, so that PropertySet can
+    // tell when its index of the keys is out of date
+    int numChanges;
 };
 
 
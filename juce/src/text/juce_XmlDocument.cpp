@@ -453,8 +453,17 @@ void XmlDocument::readChildElements (XmlElement* parent) throw()
             if (input[1] == T('/'))
             {
                 // our close tag..
-                input = CharacterFunctions::find (input, T(">"));
-                ++input;
+                const tchar* const closeBracket = CharacterFunctions::find (input, T(">"));
+
+                if (closeBracket == 0)
+                {
+                    setLastError ("unmatched tags", false);
+                    outOfData = true;
+                    input += CharacterFunctions::length (input);
+                    break;
+                }
+
+                input = closeBracket + 1;
                 break;
             }
             else if (input[1] == T('!')
@@ -674,7 +683,8 @@ void XmlDocument::readEntity (String& result) throw()
                 ++input;
             }
 
-            ++input;
+            if (*input != 0)
+                ++input;
         }
         else if (input[0] >= T('0') && input[0] <= T('9'))
         {
@@ -682,7 +692,7 @@ void XmlDocument::readEntity (String& result) throw()
 
             while (input[0] != T(';'))
             {
-                if (++numChars > 12)
+                if (++numChars > 12 || input[0] == 0)
                 {
                     setLastError ("illegal escape sequence", true);
                     break;
@@ -692,7 +702,8 @@ void XmlDocument::readEntity (String& result) throw()
                 ++input;
             }
 
-            ++input;
+            if (*input != 0)
+                ++input;
         }
         else
         {
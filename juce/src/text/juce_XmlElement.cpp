@@ -477,6 +477,19 @@ XmlElement* XmlElement::getNextElementWithTagName (const tchar* const requiredTa
 
 
 //==============================================================================
+bool XmlElement::attributeNameMatches (const String& name, const tchar* const nameWanted) throw()
+{
+    // names are compared ignoring their case, so reject most of the mismatches
+    // on their first character before doing the full comparison
+    const tchar c1 = ((const tchar*) name) [0];
+    const tchar c2 = nameWanted [0];
+
+    if (c1 != c2 && CharacterFunctions::toLowerCase (c1) != CharacterFunctions::toLowerCase (c2))
+        return false;
+
+    return name.equalsIgnoreCase (nameWanted);
+}
+
 int XmlElement::getNumAttributes() const throw()
 {
     const XmlAttributeNode* att = attributes;
@@ -531,7 +544,7 @@ bool XmlElement::hasAttribute (const tchar* const attributeName) const throw()
 
     while (att != 0)
     {
-        if (att->name.equalsIgnoreCase (attributeName))
+        if (attributeNameMatches (att->name, attributeName))
             return true;
 
         att = att->next;
@@ -548,7 +561,7 @@ const String XmlElement::getStringAttribute (const tchar* const attributeName,
 
     while (att != 0)
     {
-        if (att->name.equalsIgnoreCase (attributeName))
+        if (attributeNameMatches (att->name, attributeName))
             return att->value;
 
         att = att->next;
@@ -564,7 +577,7 @@ int XmlElement::getIntAttribute (const tchar* const attributeName,
 
     while (att != 0)
     {
-        if (att->name.equalsIgnoreCase (attributeName))
+        if (attributeNameMatches (att->name, attributeName))
             return att->value.getIntValue();
 
         att = att->next;
@@ -580,7 +593,7 @@ double XmlElement::getDoubleAttribute (const tchar* const attributeName,
 
     while (att != 0)
     {
-        if (att->name.equalsIgnoreCase (attributeName))
+        if (attributeNameMatches (att->name, attributeName))
             return att->value.getDoubleValue();
 
         att = att->next;
@@ -596,7 +609,7 @@ bool XmlElement::getBoolAttribute (const tchar* const attributeName,
 
     while (att != 0)
     {
-        if (att->name.equalsIgnoreCase (attributeName))
+        if (attributeNameMatches (att->name, attributeName))
         {
             tchar firstChar = att->value[0];
 
@@ -624,7 +637,7 @@ bool XmlElement::compareAttribute (const tchar* const attributeName,
 
     while (att != 0)
     {
-        if (att->name.equalsIgnoreCase (attributeName))
+        if (attributeNameMatches (att->name, attributeName))
         {
             if (ignoreCase)
                 return att->value.equalsIgnoreCase (stringToCompareAgainst);
@@ -665,7 +678,7 @@ void XmlElement::setAttribute (const tchar* const attributeName,
 
         for (;;)
         {
-            if (att->name.equalsIgnoreCase (attributeName))
+            if (attributeNameMatches (att->name, attributeName))
             {
                 att->value = value;
                 break;
@@ -706,7 +719,7 @@ void XmlElement::removeAttribute (const tchar* const attributeName) throw()
 
     while (att != 0)
     {
-        if (att->name.equalsIgnoreCase (attributeName))
+        if (attributeNameMatches (att->name, attributeName))
         {
             if (lastAtt == 0)
                 attributes = att->next;
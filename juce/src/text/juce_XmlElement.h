@@ -678,6 +678,8 @@ public:
 
 private:
     friend class XmlDocument;
+    friend class XmlPullParser;
+    friend class XmlStreamWriter;
 
     String tagName;
     XmlElement* firstChildElement;
@@ -706,6 +708,8 @@ private:
                              const int indentationLevel,
                              const int lineWrapLength) const throw();
 
+    static bool attributeNameMatches (const String& name, const tchar* const nameWanted) throw();
+
     void getChildElementsAsArray (XmlElement**) const throw();
     void reorderChildElements (XmlElement** const, const int) throw();
 };
@@ -0,0 +1,1308 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-9 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#include "../core/juce_StandardHeader.h"
+
+BEGIN_JUCE_NAMESPACE
+
+
+#include "juce_XmlPullParser.h"
+#include "juce_XmlDocument.h"
+#include "../io/files/juce_FileInputStream.h"
+#include "../containers/juce_MemoryBlock.h"
+
+
+//==============================================================================
+static inline bool isXmlIdentifierByte (const int c) throw()
+{
+    return (c >= 'a' && c <= 'z')
+        || (c >= 'A' && c <= 'Z')
+        || (c >= '0' && c <= '9')
+        || c == '_' || c == '-' || c == ':' || c == '.'
+        || c >= 0x80; // any utf-8 sequence
+}
+
+static inline bool isXmlWhiteSpaceByte (const int c) throw()
+{
+    // the same characters as CharacterFunctions::isWhitespace()
+    return c == ' ' || (c >= 9 && c <= 13);
+}
+
+static bool entityNameIs (const char* const entity, const int length, const char* const name) throw()
+{
+    for (int i = 0; i < length; ++i)
+        if (name[i] == 0 || CharacterFunctions::toLowerCase (entity[i]) != name[i])
+            return false;
+
+    return name [length] == 0;
+}
+
+static const char* findBytes (const char* s, const char* const end, const char* const text) throw()
+{
+    const int length = (int) strlen (text);
+
+    for (; s + length <= end; ++s)
+        if (*s == text[0] && memcmp (s, text, length) == 0)
+            return s;
+
+    return 0;
+}
+
+// the same as XmlDocument::skipNextWhiteSpace(), which also skips comments and
+// processing instructions. Returns 0 if it runs out of text.
+static const char* skipXmlDocumentWhiteSpace (const char* s, const char* const end) throw()
+{
+    for (;;)
+    {
+        while (s < end && isXmlWhiteSpaceByte ((uint8) *s))
+            ++s;
+
+        if (s >= end)
+            return 0;
+
+        if (s + 3 < end && s[0] == '<' && s[1] == '!' && s[2] == '-' && s[3] == '-')
+        {
+            s = findBytes (s, end, "-->");
+
+            if (s == 0)
+                return 0;
+
+            s += 3;
+        }
+        else if (s + 1 < end && s[0] == '<' && s[1] == '?')
+        {
+            s = findBytes (s, end, "?>");
+
+            if (s == 0)
+                return 0;
+
+            s += 2;
+        }
+        else
+        {
+            return s;
+        }
+    }
+}
+
+// XmlDocument reads the text through String::fromUTF8(), which stops at a null and
+// decodes malformed sequences in its own way (some of them as ascii characters)
+static bool isPlainUTF8 (const uint8* s, const uint8* const end) throw()
+{
+    while (s < end)
+    {
+        const uint8 c = *s++;
+
+        if (c < 0x80)
+        {
+            if (c == 0)
+                return false;
+
+            continue;
+        }
+
+        int numExtraBytes;
+        uint8 lowestSecondByte = 0x80;
+
+        if (c >= 0xc2 && c < 0xe0)
+        {
+            numExtraBytes = 1;
+        }
+        else if (c >= 0xe0 && c < 0xf0)
+        {
+            numExtraBytes = 2;
+
+            if (c == 0xe0)
+                lowestSecondByte = 0xa0;
+        }
+        else if (c >= 0xf0 && c < 0xf8)
+        {
+            numExtraBytes = 3;
+
+            if (c == 0xf0)
+                lowestSecondByte = 0x90;
+        }
+        else
+        {
+            return false;
+        }
+
+        if (end - s < numExtraBytes || *s < lowestSecondByte)
+            return false;
+
+        for (int i = 0; i < numExtraBytes; ++i)
+            if ((s[i] & 0xc0) != 0x80)
+                return false;
+
+        s += numExtraBytes;
+    }
+
+    return true;
+}
+
+
+//==============================================================================
+XmlPullParser::XmlPullParser (const File& file)
+{
+    initialise();
+
+    mappedFile = new MemoryMappedFile (file);
+
+    if (mappedFile->getData() != 0 && mappedFile->getSize() < 0x7fffffff)
+    {
+        data = (const char*) mappedFile->getData();
+        dataEnd = (int) mappedFile->getSize();
+    }
+    else
+    {
+        // can't be mapped, so read it in chunks instead
+        mappedFile = 0;
+        source = file.createInputStream();
+        deleteSource = true;
+    }
+
+    skipByteOrderMark();
+}
+
+XmlPullParser::XmlPullParser (InputStream* const source_,
+                              const bool deleteSourceWhenDone)
+{
+    initialise();
+
+    source = source_;
+    deleteSource = deleteSourceWhenDone;
+
+    skipByteOrderMark();
+}
+
+XmlPullParser::XmlPullParser (const void* const data_,
+                              const int numBytes)
+{
+    initialise();
+
+    data = (const char*) data_;
+    dataEnd = jmax (0, numBytes);
+
+    skipByteOrderMark();
+}
+
+XmlPullParser::~XmlPullParser()
+{
+    if (deleteSource)
+        delete source;
+}
+
+void XmlPullParser::initialise()
+{
+    data = 0;
+    position = dataEnd = tokenStart = 0;
+
+    source = 0;
+    deleteSource = false;
+    bufferSize = 0;
+    sourceFinished = false;
+
+    tokenType = endOfDocument;
+    tagNameIndex = -1;
+    emptyElementPending = false;
+    ignoreEmptyTextElements = true;
+
+    numAttributes = numAllocatedAttributes = 0;
+    textStart = textLength = 0;
+    textIsCData = textHasEntities = false;
+    differsFromXmlDocument = false;
+
+    nameTableSize = 64;
+    nameTable.calloc (nameTableSize);
+    numNameBytes = numAllocatedNameBytes = 0;
+
+    scratchSize = 0;
+}
+
+void XmlPullParser::skipByteOrderMark()
+{
+    const int b0 = peek (0);
+    const int b1 = peek (1);
+
+    if ((b0 == 0xfe && b1 == 0xff) || (b0 == 0xff && b1 == 0xfe))
+    {
+        // utf-16 documents are rare enough to just be converted to utf-8 up-front
+        MemoryBlock utf16 (data + position, dataEnd - position);
+
+        if (source != 0)
+            source->readIntoMemoryBlock (utf16);
+
+        const String text (String::createStringFromData ((const char*) utf16.getData(), (int) utf16.getSize()));
+        const int numBytes = text.copyToUTF8 (0);
+
+        bufferSize = numBytes;
+        buffer.malloc (bufferSize);
+        text.copyToUTF8 ((uint8*) (char*) buffer, numBytes);
+
+        data = buffer;
+        position = tokenStart = 0;
+        dataEnd = numBytes - 1;
+        mappedFile = 0;
+        sourceFinished = true;
+    }
+    else if (b0 == 0xef && b1 == 0xbb && peek (2) == 0xbf)
+    {
+        position += 3;
+    }
+}
+
+void XmlPullParser::setEmptyTextElementsIgnored (const bool shouldBeIgnored) throw()
+{
+    ignoreEmptyTextElements = shouldBeIgnored;
+}
+
+//==============================================================================
+bool XmlPullParser::fill()
+{
+    if (source == 0 || sourceFinished)
+        return false;
+
+    if (bufferSize == 0)
+    {
+        bufferSize = 16384;
+        buffer.malloc (bufferSize);
+    }
+
+    // the current token has to stay in the buffer, anything before it can go
+    if (tokenStart > 0)
+    {
+        memmove (buffer, data + tokenStart, dataEnd - tokenStart);
+
+        position -= tokenStart;
+        dataEnd -= tokenStart;
+        tokenStart = 0;
+    }
+
+    if (dataEnd >= bufferSize)
+    {
+        bufferSize *= 2;
+        buffer.realloc (bufferSize);
+    }
+
+    data = buffer;
+
+    const int numRead = source->read (buffer + dataEnd, bufferSize - dataEnd);
+
+    if (numRead <= 0)
+    {
+        sourceFinished = true;
+        return false;
+    }
+
+    dataEnd += numRead;
+    return true;
+}
+
+inline int XmlPullParser::peek (const int offset)
+{
+    while (position + offset >= dataEnd)
+        if (! fill())
+            return -1;
+
+    return (uint8) data [position + offset];
+}
+
+bool XmlPullParser::matches (const char* const text)
+{
+    for (int i = 0; text[i] != 0; ++i)
+        if (peek (i) != (uint8) text[i])
+            return false;
+
+    return true;
+}
+
+bool XmlPullParser::skipPast (const char* const terminator, const bool keepToken)
+{
+    const int length = (int) strlen (terminator);
+
+    for (;;)
+    {
+        while (position + length <= dataEnd)
+        {
+            if (data [position] == terminator[0]
+                 && memcmp (data + position, terminator, length) == 0)
+            {
+                position += length;
+                return true;
+            }
+
+            ++position;
+        }
+
+        if (! keepToken)
+            tokenStart = position;
+
+        if (! fill())
+        {
+            position = dataEnd;
+            return false;
+        }
+    }
+}
+
+void XmlPullParser::skipWhiteSpace()
+{
+    for (;;)
+    {
+        while (position < dataEnd && isXmlWhiteSpaceByte ((uint8) data [position]))
+            ++position;
+
+        if (position < dataEnd || ! fill())
+            break;
+    }
+}
+
+int XmlPullParser::readName()
+{
+    const int nameStart = position - tokenStart;
+
+    for (;;)
+    {
+        while (position < dataEnd && isXmlIdentifierByte ((uint8) data [position]))
+            ++position;
+
+        if (position < dataEnd || ! fill())
+            break;
+    }
+
+    const int numBytes = position - tokenStart - nameStart;
+
+    if (numBytes <= 0)
+        return -1;
+
+    const char* const text = getTokenData (nameStart);
+    const int index = internName (text, numBytes);
+
+    for (int i = 0; i < numBytes; ++i)
+    {
+        if ((uint8) text[i] >= 0x80)
+        {
+            // any utf-8 is read as part of a name here, but XmlDocument only takes letters and digits
+            const String& name = names.getUnchecked (index)->name;
+
+            for (int j = 0; j < name.length(); ++j)
+                if (name[j] >= 0x80 && ! CharacterFunctions::isLetterOrDigit (name[j]))
+                    differsFromXmlDocument = true;
+
+            break;
+        }
+    }
+
+    return index;
+}
+
+//==============================================================================
+XmlPullParser::TokenType XmlPullParser::setError (const String& error)
+{
+    lastError = error;
+    numAttributes = 0;
+
+    return tokenType = parseError;
+}
+
+XmlPullParser::TokenType XmlPullParser::next()
+{
+    if (tokenType == parseError)
+        return parseError;
+
+    numAttributes = 0;
+
+    if (emptyElementPending)
+    {
+        // the end of an element like <a/>, which has the same name as its start
+        emptyElementPending = false;
+        openTags.removeLast();
+
+        return tokenType = endElement;
+    }
+
+    for (;;)
+    {
+        tokenStart = position;
+
+        const int c = peek (0);
+
+        if (c < 0)
+        {
+            if (openTags.size() > 0)
+                return setError ("unmatched tags");
+
+            return tokenType = endOfDocument;
+        }
+
+        if (c != '<')
+        {
+            if (readText())
+                return tokenType = text;
+
+            continue;
+        }
+
+        const int c1 = peek (1);
+
+        if (c1 == '/')
+        {
+            return readEndTag();
+        }
+        else if (c1 == '?')
+        {
+            if (! skipPast ("?>", false))
+                return setError ("unterminated processing instruction");
+        }
+        else if (c1 == '!')
+        {
+            if (matches ("<!--"))
+            {
+                if (! skipPast ("-->", false))
+                    return setError ("unterminated comment");
+            }
+            else if (matches ("<![CDATA["))
+            {
+                position += 9;
+                textStart = position - tokenStart;
+
+                if (! skipPast ("]]>", true))
+                    return setError ("unterminated CDATA section");
+
+                textLength = position - 3 - tokenStart - textStart;
+                textIsCData = true;
+                textHasEntities = false;
+
+                if (openTags.size() > 0)
+                    return tokenType = text;
+            }
+            else
+            {
+                // XmlDocument only expects these before the document element
+                if (openTags.size() > 0)
+                    differsFromXmlDocument = true;
+
+                if (! skipDeclaration())
+                    return setError ("unterminated declaration");
+            }
+        }
+        else
+        {
+            return readStartTag();
+        }
+    }
+}
+
+XmlPullParser::TokenType XmlPullParser::readStartTag()
+{
+    ++position;
+
+    int nameIndex = readName();
+
+    if (nameIndex < 0)
+    {
+        // no tag name - but allow for a gap after the '<' before giving an error
+        skipWhiteSpace();
+        nameIndex = readName();
+
+        if (nameIndex < 0)
+            return setError ("tag name missing");
+    }
+
+    for (;;)
+    {
+        skipWhiteSpace();
+
+        const int c = peek (0);
+
+        if (c == '>')
+        {
+            ++position;
+            break;
+        }
+
+        if (c == '/' && peek (1) == '>')
+        {
+            position += 2;
+            emptyElementPending = true;
+            break;
+        }
+
+        if (c < 0)
+            return setError ("unmatched tags");
+
+        const int attributeNameIndex = isXmlIdentifierByte (c) ? readName() : -1;
+
+        if (attributeNameIndex < 0)
+            return setError ("illegal character found in " + names.getUnchecked (nameIndex)->name
+                              + ": '" + (tchar) c + "'");
+
+        skipWhiteSpace();
+
+        if (peek (0) != '=')
+            return setError ("attribute value missing");
+
+        ++position;
+        skipWhiteSpace();
+
+        const int quote = peek (0);
+
+        if (quote != '"' && quote != '\'')
+            return setError ("attribute value missing");
+
+        ++position;
+
+        const int valueStart = position - tokenStart;
+        bool hasEntities = false;
+
+        for (;;)
+        {
+            while (position < dataEnd)
+            {
+                const char ch = data [position];
+
+                if (ch == (char) quote)
+                    break;
+
+                if (ch == '&')
+                    hasEntities = true;
+
+                ++position;
+            }
+
+            if (position < dataEnd || ! fill())
+                break;
+        }
+
+        if (position >= dataEnd)
+            return setError ("unmatched quotes");
+
+        if (numAttributes >= numAllocatedAttributes)
+        {
+            numAllocatedAttributes = jmax (16, numAllocatedAttributes * 2);
+            attributes.realloc (numAllocatedAttributes);
+        }
+
+        AttributeSpan& span = attributes [numAttributes++];
+        span.nameIndex = attributeNameIndex;
+        span.valueStart = valueStart;
+        span.valueLength = position - tokenStart - valueStart;
+        span.hasEntities = hasEntities;
+
+        ++position;
+    }
+
+    tagNameIndex = nameIndex;
+    openTags.add (nameIndex);
+
+    return tokenType = startElement;
+}
+
+XmlPullParser::TokenType XmlPullParser::readEndTag()
+{
+    position += 2;
+
+    skipWhiteSpace();
+    readName();
+    skipWhiteSpace();
+
+    if (peek (0) != '>' || openTags.size() == 0)
+        return setError ("unmatched tags");
+
+    ++position;
+
+    // like XmlDocument, this closes the innermost element whatever the name of the tag
+    tagNameIndex = openTags.getLast();
+    openTags.removeLast();
+
+    return tokenType = endElement;
+}
+
+bool XmlPullParser::readText()
+{
+    textStart = position - tokenStart;
+
+    bool hasEntities = false, onlyWhiteSpace = true;
+
+    for (;;)
+    {
+        while (position < dataEnd)
+        {
+            const char c = data [position];
+
+            if (c == '<')
+                break;
+
+            if (c == '&')
+            {
+                hasEntities = true;
+                onlyWhiteSpace = false;
+            }
+            else if (onlyWhiteSpace && ! isXmlWhiteSpaceByte ((uint8) c))
+            {
+                onlyWhiteSpace = false;
+            }
+
+            ++position;
+        }
+
+        if (position < dataEnd || ! fill())
+            break;
+    }
+
+    textLength = position - tokenStart - textStart;
+    textIsCData = false;
+    textHasEntities = hasEntities;
+
+    // text outside the document element is just ignored
+    if (openTags.size() == 0)
+        return false;
+
+    return ! (onlyWhiteSpace && ignoreEmptyTextElements);
+}
+
+bool XmlPullParser::skipDeclaration()
+{
+    int depth = 0;
+
+    for (;;)
+    {
+        const int c = peek (0);
+
+        if (c < 0)
+            return false;
+
+        ++position;
+
+        if (c == '<')
+        {
+            ++depth;
+        }
+        else if (c == '>')
+        {
+            if (--depth == 0)
+                return true;
+        }
+    }
+}
+
+//==============================================================================
+int XmlPullParser::internName (const char* const text, const int numBytes)
+{
+    int hash = (int) 2166136261u;
+
+    for (int i = 0; i < numBytes; ++i)
+        hash = (hash ^ (uint8) text[i]) * 16777619;
+
+    int slot = hash & (nameTableSize - 1);
+
+    for (;;)
+    {
+        const int index = nameTable [slot] - 1;
+
+        if (index < 0)
+            break;
+
+        const InternedName* const n = names.getUnchecked (index);
+
+        if (n->hash == hash
+             && n->numBytes == numBytes
+             && memcmp (nameBytes + n->offset, text, numBytes) == 0)
+            return index;
+
+        slot = (slot + 1) & (nameTableSize - 1);
+    }
+
+    // a new name..
+    if (numNameBytes + numBytes > numAllocatedNameBytes)
+    {
+        numAllocatedNameBytes = jmax (1024, (numNameBytes + numBytes) * 2);
+        nameBytes.realloc (numAllocatedNameBytes);
+    }
+
+    memcpy (nameBytes + numNameBytes, text, numBytes);
+
+    InternedName* const n = new InternedName();
+    n->hash = hash;
+    n->offset = numNameBytes;
+    n->numBytes = numBytes;
+    n->name = decode (text, numBytes, false);
+
+    numNameBytes += numBytes;
+    names.add (n);
+
+    if (names.size() * 2 > nameTableSize)
+    {
+        nameTableSize *= 2;
+        nameTable.calloc (nameTableSize);
+
+        for (int i = 0; i < names.size(); ++i)
+        {
+            slot = names.getUnchecked (i)->hash & (nameTableSize - 1);
+
+            while (nameTable [slot] != 0)
+                slot = (slot + 1) & (nameTableSize - 1);
+
+            nameTable [slot] = i + 1;
+        }
+    }
+    else
+    {
+        nameTable [slot] = names.size();
+    }
+
+    return names.size() - 1;
+}
+
+const String XmlPullParser::decode (const char* const text,
+                                    const int numBytes,
+                                    const bool expandEntities) const
+{
+    // nothing can decode to more characters than there are bytes
+    if (scratchSize <= numBytes)
+    {
+        scratchSize = numBytes + 1;
+        scratch.malloc (scratchSize);
+    }
+
+    juce_wchar* d = scratch;
+    int i = 0;
+
+    while (i < numBytes)
+    {
+        const uint8 c = (uint8) text [i++];
+
+        if (c < 0x80)
+        {
+            if (c == '&' && expandEntities)
+            {
+                int end = i;
+
+                while (end < numBytes && end - i < 12 && text [end] != ';')
+                    ++end;
+
+                if (end >= numBytes || text [end] != ';')
+                {
+                    // XmlDocument would look further ahead for the semicolon
+                    differsFromXmlDocument = true;
+                    *d++ = '&';
+                    continue;
+                }
+
+                const char* const entity = text + i;
+                const int length = end - i;
+                juce_wchar character = 0;
+
+                if (entityNameIs (entity, length, "amp"))
+                    character = '&';
+                else if (entityNameIs (entity, length, "quot"))
+                    character = '"';
+                else if (entityNameIs (entity, length, "apos"))
+                    character = '\'';
+                else if (entityNameIs (entity, length, "lt"))
+                    character = '<';
+                else if (entityNameIs (entity, length, "gt"))
+                    character = '>';
+                else if (length > 1 && entity[0] == '#')
+                {
+                    const bool isHex = (entity[1] == 'x' || entity[1] == 'X');
+
+                    if (isHex && length > 10)
+                        differsFromXmlDocument = true;
+
+                    for (int j = isHex ? 2 : 1; j < length; ++j)
+                    {
+                        const int digit = isHex ? CharacterFunctions::getHexDigitValue (entity[j])
+                                                : ((entity[j] >= '0' && entity[j] <= '9') ? entity[j] - '0' : -1);
+
+                        if (digit < 0)
+                        {
+                            character = 0;
+                            break;
+                        }
+
+                        character = character * (isHex ? 16 : 10) + digit;
+                    }
+                }
+
+                if (character == 0)
+                {
+                    // not one we know, so leave it as it is (XmlDocument would look it up in the DTD)
+                    differsFromXmlDocument = true;
+                    *d++ = '&';
+                    continue;
+                }
+
+                // (numbers this big overflow differently in XmlDocument)
+                if ((uint32) character > 0x10ffff)
+                    differsFromXmlDocument = true;
+
+                *d++ = character;
+                i = end + 1;
+            }
+            else
+            {
+                *d++ = c;
+            }
+        }
+        else
+        {
+            int numExtraBytes = 0;
+            juce_wchar n = c;
+
+            if ((c & 0xe0) == 0xc0)
+            {
+                numExtraBytes = 1;
+                n = c & 0x1f;
+            }
+            else if ((c & 0xf0) == 0xe0)
+            {
+                numExtraBytes = 2;
+                n = c & 0x0f;
+            }
+            else if ((c & 0xf8) == 0xf0)
+            {
+                numExtraBytes = 3;
+                n = c & 0x07;
+            }
+
+            for (int j = 0; j < numExtraBytes; ++j)
+            {
+                const uint8 nextByte = (i + j < numBytes) ? (uint8) text [i + j] : 0;
+
+                if ((nextByte & 0xc0) != 0x80)
+                {
+                    // not valid utf-8, so take the byte as latin-1
+                    n = c;
+                    numExtraBytes = 0;
+                    break;
+                }
+
+                n = (n << 6) | (nextByte & 0x3f);
+            }
+
+            *d++ = n;
+            i += numExtraBytes;
+        }
+    }
+
+    return String ((const juce_wchar*) scratch, (size_t) (d - scratch));
+}
+
+//==============================================================================
+const String& XmlPullParser::getTagName() const throw()
+{
+    return tagNameIndex >= 0 ? names.getUnchecked (tagNameIndex)->name
+                             : String::empty;
+}
+
+bool XmlPullParser::hasTagName (const tchar* const tagNameWanted) const throw()
+{
+    return tagNameIndex >= 0 && XmlElement::attributeNameMatches (names.getUnchecked (tagNameIndex)->name, tagNameWanted);
+}
+
+const String& XmlPullParser::getAttributeName (const int attributeIndex) const throw()
+{
+    if (((unsigned int) attributeIndex) < (unsigned int) numAttributes)
+        return names.getUnchecked (attributes [attributeIndex].nameIndex)->name;
+
+    return String::empty;
+}
+
+const String XmlPullParser::getAttributeValue (const int attributeIndex) const
+{
+    if (((unsigned int) attributeIndex) < (unsigned int) numAttributes)
+    {
+        const AttributeSpan& span = attributes [attributeIndex];
+        return decode (getTokenData (span.valueStart), span.valueLength, span.hasEntities);
+    }
+
+    return String::empty;
+}
+
+int XmlPullParser::indexOfAttribute (const tchar* const attributeName) const throw()
+{
+    for (int i = 0; i < numAttributes; ++i)
+        if (XmlElement::attributeNameMatches (names.getUnchecked (attributes[i].nameIndex)->name, attributeName))
+            return i;
+
+    return -1;
+}
+
+bool XmlPullParser::hasAttribute (const tchar* const attributeName) const throw()
+{
+    return indexOfAttribute (attributeName) >= 0;
+}
+
+const String XmlPullParser::getStringAttribute (const tchar* const attributeName,
+                                                const tchar* const defaultReturnValue) const
+{
+    const int index = indexOfAttribute (attributeName);
+
+    return index >= 0 ? getAttributeValue (index)
+                      : String (defaultReturnValue);
+}
+
+int XmlPullParser::getIntAttribute (const tchar* const attributeName,
+                                    const int defaultReturnValue) const
+{
+    const int index = indexOfAttribute (attributeName);
+
+    if (index < 0)
+        return defaultReturnValue;
+
+    const AttributeSpan& span = attributes [index];
+
+    if (span.hasEntities)
+        return getAttributeValue (index).getIntValue();
+
+    // parsed in place, the same way as String::getIntValue()
+    const char* t = getTokenData (span.valueStart);
+    const char* const end = t + span.valueLength;
+
+    while (t < end && isXmlWhiteSpaceByte ((uint8) *t))
+        ++t;
+
+    const bool isNegative = (t < end && *t == '-');
+    if (isNegative)
+        ++t;
+
+    int v = 0;
+
+    while (t < end && *t >= '0' && *t <= '9')
+        v = v * 10 + (*t++ - '0');
+
+    return isNegative ? -v : v;
+}
+
+double XmlPullParser::getDoubleAttribute (const tchar* const attributeName,
+                                          const double defaultReturnValue) const
+{
+    const int index = indexOfAttribute (attributeName);
+
+    if (index < 0)
+        return defaultReturnValue;
+
+    const AttributeSpan& span = attributes [index];
+
+    if (span.hasEntities || span.valueLength >= 64)
+        return getAttributeValue (index).getDoubleValue();
+
+    char number [64];
+    memcpy (number, getTokenData (span.valueStart), span.valueLength);
+    number [span.valueLength] = 0;
+
+    return CharacterFunctions::getDoubleValue (number);
+}
+
+bool XmlPullParser::getBoolAttribute (const tchar* const attributeName,
+                                      const bool defaultReturnValue) const
+{
+    const int index = indexOfAttribute (attributeName);
+
+    if (index < 0)
+        return defaultReturnValue;
+
+    const AttributeSpan& span = attributes [index];
+    const char* t = getTokenData (span.valueStart);
+    const char* const end = t + span.valueLength;
+
+    while (t < end && isXmlWhiteSpaceByte ((uint8) *t))
+        ++t;
+
+    const char firstChar = (t < end) ? *t : 0;
+
+    return firstChar == '1'
+        || firstChar == 't'
+        || firstChar == 'y'
+        || firstChar == 'T'
+        || firstChar == 'Y';
+}
+
+const String XmlPullParser::getText() const
+{
+    if (tokenType != text)
+        return String::empty;
+
+    return decode (getTokenData (textStart), textLength, textHasEntities && ! textIsCData);
+}
+
+//==============================================================================
+XmlElement* XmlPullParser::createElement() const
+{
+    XmlElement* const element = new XmlElement ((int) 0);
+    element->tagName = getTagName();
+
+    XmlElement::XmlAttributeNode* lastAttribute = 0;
+
+    for (int i = 0; i < numAttributes; ++i)
+    {
+        XmlElement::XmlAttributeNode* const newAttribute
+            = new XmlElement::XmlAttributeNode (names.getUnchecked (attributes[i].nameIndex)->name,
+                                                getAttributeValue (i));
+
+        if (lastAttribute == 0)
+            element->attributes = newAttribute;
+        else
+            lastAttribute->next = newAttribute;
+
+        lastAttribute = newAttribute;
+    }
+
+    return element;
+}
+
+XmlElement* XmlPullParser::createTextElement() const
+{
+    if (textIsCData)
+    {
+        XmlElement* const element = new XmlElement ((int) 0);
+        element->setText (getText());
+        return element;
+    }
+
+    // XmlDocument drops the whitespace at the start of a run of text, but not any
+    // that comes from an entity
+    const char* t = getTokenData (textStart);
+    int numBytes = textLength;
+
+    while (numBytes > 0)
+    {
+        const uint8 c = (uint8) *t;
+        int charBytes = 1;
+
+        if (c >= 0x80)
+            charBytes = jmin (numBytes, (c & 0xe0) == 0xc0 ? 2 : ((c & 0xf0) == 0xe0 ? 3 : 4));
+
+        if (! CharacterFunctions::isWhitespace (c < 0x80 ? (juce_wchar) c
+                                                          : decode (t, charBytes, false)[0]))
+            break;
+
+        t += charBytes;
+        numBytes -= charBytes;
+    }
+
+    if (numBytes == 0)
+        return 0;
+
+    const String content (decode (t, numBytes, textHasEntities));
+
+    XmlElement* const element = new XmlElement ((int) 0);
+
+    if (ignoreEmptyTextElements ? content.containsNonWhitespaceChars()
+                                : content.isNotEmpty())
+        element->setText (content);
+
+    return element;
+}
+
+XmlElement* XmlPullParser::readElement()
+{
+    if (tokenType != startElement)
+        return 0;
+
+    ScopedPointer <XmlElement> element (createElement());
+    XmlElement* lastChild = 0;
+
+    for (;;)
+    {
+        XmlElement* child = 0;
+
+        switch (next())
+        {
+        case startElement:
+            child = readElement();
+
+            if (child == 0)
+                return 0;
+
+            break;
+
+        case text:
+            child = createTextElement();
+
+            if (child == 0)
+                continue;
+
+            break;
+
+        case endElement:
+            return element.release();
+
+        default:
+            return 0;
+        }
+
+        // linked straight in, addChildElement would walk the whole list each time
+        if (lastChild == 0)
+            element->firstChildElement = child;
+        else
+            lastChild->nextElement = child;
+
+        lastChild = child;
+    }
+}
+
+bool XmlPullParser::skipElement()
+{
+    if (tokenType != startElement)
+        return false;
+
+    const int depth = openTags.size();
+
+    for (;;)
+    {
+        const TokenType t = next();
+
+        if (t == parseError || t == endOfDocument)
+            return false;
+
+        if (t == endElement && openTags.size() < depth)
+            return true;
+    }
+}
+
+int XmlPullParser::findDocumentElement() const
+{
+    // this follows XmlDocument::skipHeader() and readNextElement(), so that whatever
+    // comes before the document element is passed over in the same way
+    const char* const end = data + dataEnd;
+    const char* s = data + position;
+
+    const char* const xmlDeclaration = findBytes (s, end, "<?xml");
+
+    if (xmlDeclaration != 0)
+    {
+        s = findBytes (xmlDeclaration, end, "?>");
+
+        if (s == 0)
+            return -1;
+
+        s += 2;
+    }
+
+    s = skipXmlDocumentWhiteSpace (s, end);
+
+    if (s == 0)
+        return -1;
+
+    const char* const docType = findBytes (s, end, "<!DOCTYPE");
+
+    if (docType != 0)
+    {
+        s = docType + 9;
+        int depth = 1;
+
+        while (depth > 0)
+        {
+            if (s >= end)
+                return -1;
+
+            const char c = *s++;
+
+            if (c == '<')
+                ++depth;
+            else if (c == '>')
+                --depth;
+        }
+    }
+
+    s = skipXmlDocumentWhiteSpace (s, end);
+
+    if (s == 0)
+        return -1;
+
+    s = (const char*) memchr (s, '<', end - s);
+
+    return s != 0 ? (int) (s - data) : -1;
+}
+
+XmlElement* XmlPullParser::readDocumentElement()
+{
+    if (tokenType == parseError)
+        return 0;
+
+    // everything is read in first: matching XmlDocument needs to search the whole text
+    // for its header, and to be able to hand it the text if it has to
+    tokenStart = position;
+
+    while (fill())
+    {}
+
+    const int documentStart = position;
+    openTags.clearQuick();
+    emptyElementPending = false;
+    differsFromXmlDocument = ! isPlainUTF8 ((const uint8*) data + position, (const uint8*) data + dataEnd);
+
+    ScopedPointer <XmlElement> element;
+
+    if (! differsFromXmlDocument)
+    {
+        const int elementStart = findDocumentElement();
+
+        if (elementStart >= 0)
+        {
+            position = elementStart;
+
+            if (next() == startElement && tokenStart == elementStart)
+                element = readElement();
+        }
+    }
+
+    if (element != 0 && ! differsFromXmlDocument)
+        return element.release();
+
+    // something that XmlDocument reads in its own way, or an error that it might recover
+    // from, so it's given the document to parse instead
+    XmlDocument document (String::fromUTF8 ((const uint8*) data + documentStart, dataEnd - documentStart));
+    document.setEmptyTextElementsIgnored (ignoreEmptyTextElements);
+    element = document.getDocumentElement();
+
+    position = tokenStart = dataEnd;
+    numAttributes = 0;
+    tagNameIndex = -1;
+    openTags.clearQuick();
+    emptyElementPending = false;
+
+    if (element != 0)
+    {
+        lastError = String::empty;
+        tokenType = endOfDocument;
+    }
+    else
+    {
+        lastError = document.getLastParseError();
+
+        if (lastError.isEmpty())
+            lastError = "not enough input";
+
+        tokenType = parseError;
+    }
+
+    return element.release();
+}
+
+
+END_JUCE_NAMESPACE
@@ -0,0 +1,302 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-9 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_XMLPULLPARSER_JUCEHEADER__
+#define __JUCE_XMLPULLPARSER_JUCEHEADER__
+
+#include "juce_XmlElement.h"
+#include "../io/files/juce_File.h"
+#include "../io/files/juce_MemoryMappedFile.h"
+#include "../io/streams/juce_InputStream.h"
+#include "../containers/juce_Array.h"
+#include "../containers/juce_OwnedArray.h"
+#include "../containers/juce_HeapBlock.h"
+#include "../containers/juce_ScopedPointer.h"
+
+
+//==============================================================================
+/**
+    Reads an xml document one token at a time, without building a tree.
+
+    The parser works straight on the utf-8 bytes of the document, which can be
+    a memory-mapped file, a block of memory or an InputStream that's read in
+    chunks. Nothing is converted to a String until it's asked for: attribute
+    values can be read as numbers without allocating, and tag and attribute
+    names are interned, so each distinct name is only allocated once per
+    parser and all the elements built from it share the same String.
+
+    Any element can be turned into an XmlElement when the parser is on its
+    start tag, so a caller can skip or stream through the parts of a big
+    document it's not interested in and only build the ones it needs.
+
+    e.g.
+    @code
+
+    XmlPullParser parser (File ("session.xml"));
+
+    while (parser.next() == XmlPullParser::startElement)
+    {
+        if (parser.getTagName() == T("PLUGIN"))
+        {
+            const int id = parser.getIntAttribute (T("id"));
+            ScopedPointer <XmlElement> plugin (parser.readElement());
+            ..use the element
+        }
+    }
+
+    @endcode
+
+    The parser doesn't read DTDs, so apart from the predefined ones and the
+    character references, entities are left in the text as they are. (The
+    exception is readDocumentElement(), which hands documents like that over
+    to XmlDocument).
+
+    @see XmlStreamWriter, XmlDocument, XmlElement
+*/
+class JUCE_API  XmlPullParser
+{
+public:
+    //==============================================================================
+    /** The kinds of token returned by next(). */
+    enum TokenType
+    {
+        startElement,       /**< A start tag, the attributes can be read. */
+        endElement,         /**< An end tag, also returned after an empty element like <a/>. */
+        text,               /**< A section of text or CDATA inside an element. */
+        endOfDocument,      /**< There's nothing else to read. */
+        parseError          /**< The document is malformed, see getLastParseError(). */
+    };
+
+    //==============================================================================
+    /** Creates a parser that reads a file, memory-mapping it if possible. */
+    XmlPullParser (const File& file);
+
+    /** Creates a parser that reads a stream a chunk at a time.
+
+        If deleteSourceWhenDone is true, the stream will be deleted by the parser.
+    */
+    XmlPullParser (InputStream* const source,
+                   const bool deleteSourceWhenDone);
+
+    /** Creates a parser that reads a block of memory in place.
+
+        The data must stay valid for as long as the parser is used.
+    */
+    XmlPullParser (const void* const data,
+                   const int numBytes);
+
+    /** Destructor. */
+    ~XmlPullParser();
+
+    //==============================================================================
+    /** Reads the next token.
+
+        Comments, processing instructions and the doctype are skipped, and so
+        are the whitespace-only sections of text unless setEmptyTextElementsIgnored()
+        was called with false.
+    */
+    TokenType next();
+
+    /** Returns the kind of token that the last call to next() found. */
+    TokenType getTokenType() const throw()                  { return tokenType; }
+
+    /** Returns the number of elements that are open, including the current one
+        if it's a start tag.
+    */
+    int getDepth() const throw()                            { return openTags.size(); }
+
+    /** Returns the tag name of the current start or end tag. */
+    const String& getTagName() const throw();
+
+    /** Returns true if the current start tag has the given name, ignoring its case. */
+    bool hasTagName (const tchar* const tagNameWanted) const throw();
+
+    //==============================================================================
+    /** Returns the number of attributes of the current start tag. */
+    int getNumAttributes() const throw()                    { return numAttributes; }
+
+    /** Returns the name of one of the attributes of the current start tag. */
+    const String& getAttributeName (const int attributeIndex) const throw();
+
+    /** Returns the value of one of the attributes of the current start tag. */
+    const String getAttributeValue (const int attributeIndex) const;
+
+    /** Returns the index of an attribute of the current start tag, or -1.
+
+        Like in XmlElement, names are compared ignoring their case.
+    */
+    int indexOfAttribute (const tchar* const attributeName) const throw();
+
+    /** Returns true if the current start tag has an attribute with this name. */
+    bool hasAttribute (const tchar* const attributeName) const throw();
+
+    /** Returns the value of an attribute as a string, or the default if it's not there. */
+    const String getStringAttribute (const tchar* const attributeName,
+                                     const tchar* const defaultReturnValue = 0) const;
+
+    /** Returns the value of an attribute as an integer, without creating a String for it. */
+    int getIntAttribute (const tchar* const attributeName,
+                         const int defaultReturnValue = 0) const;
+
+    /** Returns the value of an attribute as a double, without creating a String for it. */
+    double getDoubleAttribute (const tchar* const attributeName,
+                               const double defaultReturnValue = 0.0) const;
+
+    /** Returns the value of an attribute as a boolean, like XmlElement::getBoolAttribute(). */
+    bool getBoolAttribute (const tchar* const attributeName,
+                           const bool defaultReturnValue = false) const;
+
+    //==============================================================================
+    /** Returns the contents of the current text token. */
+    const String getText() const;
+
+    //==============================================================================
+    /** Builds an XmlElement out of the current start tag and everything up to its end tag.
+
+        After this the parser is on the end tag of the element. It returns 0 if
+        the parser wasn't on a start tag or if there was a parse error.
+
+        The text elements are made the same way XmlDocument makes them, so the
+        whitespace at the start of each run of text is left out.
+
+        @returns    a new XmlElement which the caller will need to delete
+    */
+    XmlElement* readElement();
+
+    /** Skips the current element and its children, leaving the parser on its end tag.
+
+        Returns false if the parser wasn't on a start tag or if there was an error.
+    */
+    bool skipElement();
+
+    /** Reads the whole document and builds its outer element.
+
+        This is meant for a new parser that hasn't read anything yet, and it
+        returns the same tree as XmlDocument::getDocumentElement() would. The
+        rest of the input is read into memory first, so a stream isn't parsed
+        in chunks here.
+
+        Wherever XmlDocument's behaviour differs from a plain reading of the
+        text, it's matched: whitespace at the start of a run of text is dropped,
+        and a whitespace-only run is dropped even if empty text elements aren't
+        being ignored. If the document contains anything else that XmlDocument
+        reads in its own way - entities that need the DTD, unquoted attribute
+        values, declarations inside elements, bytes that aren't valid utf-8, or
+        a syntax error that it may recover from - the whole document is parsed
+        with an XmlDocument instead, so such documents are parsed more slowly
+        but not differently.
+
+        @returns    a new XmlElement which the caller will need to delete, or
+                    null if there was an error.
+    */
+    XmlElement* readDocumentElement();
+
+    //==============================================================================
+    /** Returns the error that stopped the parser, or an empty string. */
+    const String& getLastParseError() const throw()         { return lastError; }
+
+    /** Sets whether whitespace-only sections of text are skipped, as they are by default. */
+    void setEmptyTextElementsIgnored (const bool shouldBeIgnored) throw();
+
+    //==============================================================================
+    juce_UseDebuggingNewOperator
+
+private:
+    struct InternedName
+    {
+        int hash, offset, numBytes;
+        String name;
+    };
+
+    struct AttributeSpan
+    {
+        int nameIndex, valueStart, valueLength;
+        bool hasEntities;
+    };
+
+    // the window of the document being parsed, and the start of the current token in it
+    const char* data;
+    int position, dataEnd, tokenStart;
+
+    ScopedPointer <MemoryMappedFile> mappedFile;
+    InputStream* source;
+    bool deleteSource;
+    HeapBlock <char> buffer;
+    int bufferSize;
+    bool sourceFinished;
+
+    TokenType tokenType;
+    int tagNameIndex;
+    bool emptyElementPending, ignoreEmptyTextElements;
+    Array <int> openTags;
+
+    HeapBlock <AttributeSpan> attributes;
+    int numAttributes, numAllocatedAttributes;
+
+    int textStart, textLength;
+    bool textIsCData, textHasEntities;
+
+    // set when something was found that XmlDocument would read differently
+    mutable bool differsFromXmlDocument;
+
+    OwnedArray <InternedName> names;
+    HeapBlock <int> nameTable;
+    int nameTableSize;
+    HeapBlock <char> nameBytes;
+    int numNameBytes, numAllocatedNameBytes;
+
+    mutable HeapBlock <juce_wchar> scratch;
+    mutable int scratchSize;
+
+    String lastError;
+
+    void initialise();
+    void skipByteOrderMark();
+    bool fill();
+    int peek (const int offset);
+    bool matches (const char* const text);
+    bool skipPast (const char* const terminator, const bool keepToken);
+    void skipWhiteSpace();
+    int readName();
+    TokenType readStartTag();
+    TokenType readEndTag();
+    bool readText();
+    bool skipDeclaration();
+    TokenType setError (const String& error);
+
+    int internName (const char* const text, const int numBytes);
+    const String decode (const char* const text, const int numBytes, const bool expandEntities) const;
+    const char* getTokenData (const int offset) const throw()    { return data + tokenStart + offset; }
+
+    XmlElement* createElement() const;
+    XmlElement* createTextElement() const;
+    int findDocumentElement() const;
+
+    XmlPullParser (const XmlPullParser&);
+    const XmlPullParser& operator= (const XmlPullParser&);
+};
+
+
+#endif   // __JUCE_XMLPULLPARSER_JUCEHEADER__
@@ -0,0 +1,385 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-9 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#include "../core/juce_StandardHeader.h"
+
+BEGIN_JUCE_NAMESPACE
+
+
+#include "juce_XmlStreamWriter.h"
+
+
+//==============================================================================
+// the characters that XmlElement writes as they are, everything else is escaped
+static inline bool isUnescapedXmlChar (const juce_wchar character) throw()
+{
+    if ((character >= 'a' && character <= 'z')
+         || (character >= 'A' && character <= 'Z')
+         || (character >= '0' && character <= '9'))
+        return true;
+
+    return character > 0 && character < 128
+            && strchr (" .,;:-()_+=?!'#@[]/\\*%~{}", (int) character) != 0;
+}
+
+
+//==============================================================================
+XmlStreamWriter::XmlStreamWriter (OutputStream& output_,
+                                  const bool allOnOneLine_)
+    : output (output_),
+      allOnOneLine (allOnOneLine_),
+      startTagOpen (false),
+      numBuffered (0)
+{
+}
+
+XmlStreamWriter::~XmlStreamWriter()
+{
+    // all the elements should have been closed before the writer is deleted
+    jassert (openTags.size() == 0);
+
+    flushBuffer();
+}
+
+void XmlStreamWriter::flush()
+{
+    flushBuffer();
+    output.flush();
+}
+
+//==============================================================================
+void XmlStreamWriter::flushBuffer()
+{
+    if (numBuffered > 0)
+    {
+        output.write (buffer, numBuffered);
+        numBuffered = 0;
+    }
+}
+
+void XmlStreamWriter::writeBuffered (const char* const data, const int numBytes)
+{
+    if (numBuffered + numBytes > bufferSize)
+    {
+        flushBuffer();
+
+        if (numBytes > bufferSize)
+        {
+            output.write (data, numBytes);
+            return;
+        }
+    }
+
+    memcpy (buffer + numBuffered, data, numBytes);
+    numBuffered += numBytes;
+}
+
+inline void XmlStreamWriter::writeByte (const char byte)
+{
+    if (numBuffered >= bufferSize)
+        flushBuffer();
+
+    buffer [numBuffered++] = byte;
+}
+
+void XmlStreamWriter::writeSpaces (int numSpaces)
+{
+    while (--numSpaces >= 0)
+        writeByte (' ');
+}
+
+void XmlStreamWriter::writeNumber (const int64 number)
+{
+    char digits [24];
+    char* d = digits + sizeof (digits);
+    uint64 n = (uint64) (number < 0 ? -number : number);
+
+    do
+    {
+        *--d = (char) ('0' + (int) (n % 10));
+        n /= 10;
+    }
+    while (n > 0);
+
+    if (number < 0)
+        *--d = '-';
+
+    writeBuffered (d, (int) (digits + sizeof (digits) - d));
+}
+
+void XmlStreamWriter::writeName (const String& name)
+{
+    const juce_wchar* t = (const juce_wchar*) name;
+
+    while (*t != 0)
+    {
+        const juce_wchar c = *t++;
+
+        if (c < 0x80)
+        {
+            writeByte ((char) c);
+        }
+        else
+        {
+            uint8 utf8 [8];
+            const int numBytes = String::charToString (c).copyToUTF8 (utf8, sizeof (utf8)) - 1;
+            writeBuffered ((const char*) utf8, numBytes);
+        }
+    }
+}
+
+void XmlStreamWriter::writeEscaped (const String& text, const bool changeNewLines)
+{
+    const juce_wchar* t = (const juce_wchar*) text;
+
+    for (;;)
+    {
+        const juce_wchar character = *t++;
+
+        if (character == 0)
+            break;
+
+        if (isUnescapedXmlChar (character))
+        {
+            writeByte ((char) character);
+            continue;
+        }
+
+        switch (character)
+        {
+        case '&':
+            writeBuffered ("&amp;", 5);
+            break;
+
+        case '"':
+            writeBuffered ("&quot;", 6);
+            break;
+
+        case '>':
+            writeBuffered ("&gt;", 4);
+            break;
+
+        case '<':
+            writeBuffered ("&lt;", 4);
+            break;
+
+        case '\n':
+            if (changeNewLines)
+                writeBuffered ("&#10;", 5);
+            else
+                writeByte ('\n');
+
+            break;
+
+        case '\r':
+            if (changeNewLines)
+                writeBuffered ("&#13;", 5);
+            else
+                writeByte ('\r');
+
+            break;
+
+        default:
+            writeBuffered ("&#", 2);
+            writeNumber ((int64) (unsigned int) character);
+            writeByte (';');
+            break;
+        }
+    }
+}
+
+//==============================================================================
+void XmlStreamWriter::writeHeader (const tchar* const encodingType)
+{
+    // the header has to come first..
+    jassert (openTags.size() == 0);
+
+    writeBuffered ("<?xml version=\"1.0\" encoding=\"", 30);
+    writeName (encodingType);
+
+    if (allOnOneLine)
+        writeBuffered ("\"?> ", 4);
+    else
+        writeBuffered ("\"?>\r\n\r\n", 7);
+}
+
+void XmlStreamWriter::startContent (const bool isElement)
+{
+    const int index = openTags.size() - 1;
+    const int flags = contentFlags.getUnchecked (index);
+
+    if (startTagOpen)
+    {
+        writeByte ('>');
+        startTagOpen = false;
+    }
+
+    if (! allOnOneLine)
+    {
+        if (isElement)
+        {
+            // child elements go on their own lines..
+            if ((flags & hasContent) == 0 || (flags & lastContentWasText) != 0)
+                writeBuffered ("\r\n", 2);
+        }
+        else if ((flags & hasContent) != 0 && (flags & lastContentWasText) == 0)
+        {
+            // ..and text that follows one of them is indented like them
+            writeSpaces (index * 2 + 2);
+        }
+    }
+
+    contentFlags.set (index, isElement ? (hasContent | hasChildElements)
+                                       : (flags | hasContent | lastContentWasText));
+}
+
+void XmlStreamWriter::startElement (const String& tagName)
+{
+    // the tag name mustn't be empty, or it'll look like a text element!
+    jassert (tagName.containsNonWhitespaceChars());
+
+    if (openTags.size() > 0)
+        startContent (true);
+
+    if (! allOnOneLine)
+        writeSpaces (openTags.size() * 2);
+
+    writeByte ('<');
+    writeName (tagName);
+
+    openTags.add (tagName);
+    contentFlags.add (0);
+    startTagOpen = true;
+}
+
+void XmlStreamWriter::writeAttribute (const tchar* const attributeName,
+                                      const String& value)
+{
+    // attributes can only be written straight after startElement()
+    jassert (startTagOpen);
+
+    writeByte (' ');
+    writeName (attributeName);
+    writeBuffered ("=\"", 2);
+    writeEscaped (value, true);
+    writeByte ('"');
+}
+
+void XmlStreamWriter::writeAttribute (const tchar* const attributeName,
+                                      const int value)
+{
+    jassert (startTagOpen);
+
+    writeByte (' ');
+    writeName (attributeName);
+    writeBuffered ("=\"", 2);
+    writeNumber (value);
+    writeByte ('"');
+}
+
+void XmlStreamWriter::writeAttribute (const tchar* const attributeName,
+                                      const double value)
+{
+    writeAttribute (attributeName, String (value));
+}
+
+void XmlStreamWriter::writeText (const String& text)
+{
+    // text has to be inside an element
+    jassert (openTags.size() > 0);
+
+    if (openTags.size() > 0)
+    {
+        startContent (false);
+        writeEscaped (text, false);
+    }
+}
+
+void XmlStreamWriter::endElement()
+{
+    // more elements were ended than were started
+    jassert (openTags.size() > 0);
+
+    const int index = openTags.size() - 1;
+
+    if (index < 0)
+        return;
+
+    const int flags = contentFlags.getUnchecked (index);
+
+    if (startTagOpen)
+    {
+        writeBuffered ("/>", 2);
+        startTagOpen = false;
+    }
+    else
+    {
+        if (! allOnOneLine && (flags & hasChildElements) != 0)
+        {
+            if ((flags & lastContentWasText) != 0)
+                writeBuffered ("\r\n", 2);
+
+            writeSpaces (index * 2);
+        }
+
+        writeBuffered ("</", 2);
+        writeName (openTags [index]);
+        writeByte ('>');
+    }
+
+    if (! allOnOneLine)
+        writeBuffered ("\r\n", 2);
+
+    openTags.remove (index);
+    contentFlags.removeLast();
+}
+
+void XmlStreamWriter::writeElement (const XmlElement& element)
+{
+    if (element.isTextElement())
+    {
+        writeText (element.getText());
+        return;
+    }
+
+    startElement (element.tagName);
+
+    for (const XmlElement::XmlAttributeNode* att = element.attributes; att != 0; att = att->next)
+    {
+        writeByte (' ');
+        writeName (att->name);
+        writeBuffered ("=\"", 2);
+        writeEscaped (att->value, true);
+        writeByte ('"');
+    }
+
+    for (const XmlElement* child = element.firstChildElement; child != 0; child = child->nextElement)
+        writeElement (*child);
+
+    endElement();
+}
+
+
+END_JUCE_NAMESPACE
@@ -0,0 +1,164 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-9 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_XMLSTREAMWRITER_JUCEHEADER__
+#define __JUCE_XMLSTREAMWRITER_JUCEHEADER__
+
+#include "juce_XmlElement.h"
+#include "juce_StringArray.h"
+#include "../io/streams/juce_OutputStream.h"
+#include "../containers/juce_Array.h"
+
+
+//==============================================================================
+/**
+    Writes an xml document to a stream as it's being generated.
+
+    Elements are written as soon as they're started, so a big document never
+    has to exist as a tree of XmlElements or as one big String. The output
+    goes through a small buffer, so the stream sees a few large writes rather
+    than one call per character.
+
+    e.g.
+    @code
+
+    FileOutputStream out (file);
+    XmlStreamWriter writer (out);
+
+    writer.startElement (T("ANIMALS"));
+
+        writer.startElement (T("GIRAFFE"));
+        writer.writeAttribute (T("name"), T("nigel"));
+        writer.writeAttribute (T("age"), 10);
+        writer.endElement();
+
+    writer.endElement();
+
+    @endcode
+
+    Text is escaped in the same way as by XmlElement, and writeElement() can
+    mix in existing elements: on one line the output is the same as
+    XmlElement::createDocument().
+
+    @see XmlPullParser, XmlElement
+*/
+class JUCE_API  XmlStreamWriter
+{
+public:
+    //==============================================================================
+    /** Creates a writer for a stream.
+
+        The stream must stay valid until the writer has been deleted.
+
+        @param output           the stream to write to
+        @param allOnOneLine     if true, no newlines or indentation are added
+    */
+    XmlStreamWriter (OutputStream& output,
+                     const bool allOnOneLine = false);
+
+    /** Destructor.
+
+        This flushes what is still buffered, all the elements should have been
+        closed by now.
+    */
+    ~XmlStreamWriter();
+
+    //==============================================================================
+    /** Writes the <?xml?> declaration, which must come before anything else. */
+    void writeHeader (const tchar* const encodingType = T("UTF-8"));
+
+    /** Opens a new element, as a child of the current one. */
+    void startElement (const String& tagName);
+
+    /** Adds an attribute to the element that was just started.
+
+        This can only be called right after startElement(), before any text or
+        child elements are written.
+    */
+    void writeAttribute (const tchar* const attributeName,
+                         const String& value);
+
+    /** Adds an integer attribute to the element that was just started. */
+    void writeAttribute (const tchar* const attributeName,
+                         const int value);
+
+    /** Adds a floating point attribute to the element that was just started. */
+    void writeAttribute (const tchar* const attributeName,
+                         const double value);
+
+    /** Writes a section of text inside the current element. */
+    void writeText (const String& text);
+
+    /** Closes the current element. */
+    void endElement();
+
+    /** Writes an element and all its children, as a child of the current one. */
+    void writeElement (const XmlElement& element);
+
+    //==============================================================================
+    /** Returns the number of elements that have been started and not ended. */
+    int getDepth() const throw()                            { return openTags.size(); }
+
+    /** Passes whatever is buffered to the stream, and flushes it. */
+    void flush();
+
+    //==============================================================================
+    juce_UseDebuggingNewOperator
+
+private:
+    enum
+    {
+        bufferSize = 8192,
+
+        hasContent = 1,
+        hasChildElements = 2,
+        lastContentWasText = 4
+    };
+
+    OutputStream& output;
+    const bool allOnOneLine;
+    bool startTagOpen;
+
+    StringArray openTags;
+    Array <int> contentFlags;
+
+    char buffer [bufferSize];
+    int numBuffered;
+
+    void writeBuffered (const char* const data, const int numBytes);
+    void writeByte (const char byte);
+    void writeSpaces (int numSpaces);
+    void writeNumber (const int64 number);
+    void writeName (const String& name);
+    void writeEscaped (const String& text, const bool changeNewLines);
+    void startContent (const bool isElement);
+    void flushBuffer();
+
+    XmlStreamWriter (const XmlStreamWriter&);
+    const XmlStreamWriter& operator= (const XmlStreamWriter&);
+};
+
+
+#endif   // __JUCE_XMLSTREAMWRITER_JUCEHEADER__
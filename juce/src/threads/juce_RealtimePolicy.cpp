@@ -0,0 +1,207 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-9 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#include "../core/juce_StandardHeader.h"
+
+BEGIN_JUCE_NAMESPACE
+
+
+#include "juce_RealtimePolicy.h"
+#include "juce_ScopedLock.h"
+#include "../core/juce_Logger.h"
+
+
+//==============================================================================
+// these are implemented in the platform specific code
+bool juce_setCurrentThreadRealtimePriority (const int priority, String& error);
+bool juce_setCurrentThreadAffinity (const uint32 affinityMask, String& error);
+bool juce_lockProcessMemory (String& error);
+void juce_prefaultHeap (const int numBytes);
+bool juce_getCurrentThreadScheduling (bool& isRealtime, int& priority, uint32& affinityMask);
+
+//==============================================================================
+static bool policyEnabled = false;
+
+// midi input sits above the audio thread so incoming events are timestamped
+// as they arrive, the disk threads sit below everything that makes sound
+static int rolePriorities [RealtimePolicy::numThreadRoles] = { 70, 65, 40, 75, 60, 0 };
+static uint32 roleAffinities [RealtimePolicy::numThreadRoles] = { 0, 0, 0, 0, 0, 0 };
+
+static int stackPrefaultSize = 64 * 1024;
+
+static CriticalSection rejectedLock;
+static StringArray rejectedPolicies;
+
+static void addRejectedPolicy (const String& who, const String& what, const String& error)
+{
+    const String message (who + T(": ") + what + T(" rejected (") + error + T(")"));
+
+    const ScopedLock sl (rejectedLock);
+
+    if (! rejectedPolicies.contains (message))
+    {
+        Logger::writeToLog (message);
+        rejectedPolicies.add (message);
+    }
+}
+
+static void prefaultStack (const int numBytes)
+{
+    volatile char page [4096];
+
+    for (int i = 0; i < (int) sizeof (page); i += 512)
+        page[i] = 0;
+
+    if (numBytes > (int) sizeof (page))
+        prefaultStack (numBytes - (int) sizeof (page));
+
+    // keeps this frame alive until the deeper ones have been touched
+    page[0] = 1;
+}
+
+//==============================================================================
+const String RealtimePolicy::getRoleName (const ThreadRole role)
+{
+    switch (role)
+    {
+        case audioThread:       return T("audio");
+        case graphWorkerThread: return T("graph");
+        case diskThread:        return T("disk");
+        case midiInputThread:   return T("midi");
+        case midiOutputThread:  return T("midi_out");
+        case guiThread:         return T("gui");
+        default:                break;
+    }
+
+    return String::empty;
+}
+
+void RealtimePolicy::setEnabled (const bool shouldBeEnabled)
+{
+    policyEnabled = shouldBeEnabled;
+}
+
+bool RealtimePolicy::isEnabled()
+{
+    return policyEnabled;
+}
+
+void RealtimePolicy::setRolePriority (const ThreadRole role, const int realtimePriority)
+{
+    jassert (role >= 0 && role < numThreadRoles);
+
+    rolePriorities [role] = jlimit (0, 99, realtimePriority);
+}
+
+int RealtimePolicy::getRolePriority (const ThreadRole role)
+{
+    jassert (role >= 0 && role < numThreadRoles);
+
+    return rolePriorities [role];
+}
+
+void RealtimePolicy::setRoleAffinity (const ThreadRole role, const uint32 affinityMask)
+{
+    jassert (role >= 0 && role < numThreadRoles);
+
+    roleAffinities [role] = affinityMask;
+}
+
+uint32 RealtimePolicy::getRoleAffinity (const ThreadRole role)
+{
+    jassert (role >= 0 && role < numThreadRoles);
+
+    return roleAffinities [role];
+}
+
+void RealtimePolicy::setStackPrefaultSize (const int numBytes)
+{
+    stackPrefaultSize = jmax (0, numBytes);
+}
+
+//==============================================================================
+bool RealtimePolicy::applyToCurrentThread (const ThreadRole role)
+{
+    jassert (role >= 0 && role < numThreadRoles);
+
+    if (! policyEnabled)
+        return true;
+
+    bool ok = true;
+    String error;
+
+    const int priority = rolePriorities [role];
+
+    if (priority > 0 && ! juce_setCurrentThreadRealtimePriority (priority, error))
+    {
+        addRejectedPolicy (getRoleName (role), T("SCHED_FIFO priority ") + String (priority), error);
+        ok = false;
+    }
+
+    const uint32 affinityMask = roleAffinities [role];
+
+    if (affinityMask != 0 && ! juce_setCurrentThreadAffinity (affinityMask, error))
+    {
+        addRejectedPolicy (getRoleName (role), T("cpu affinity 0x") + String::toHexString ((int) affinityMask), error);
+        ok = false;
+    }
+
+    if (stackPrefaultSize > 0)
+        prefaultStack (stackPrefaultSize);
+
+    return ok;
+}
+
+bool RealtimePolicy::lockMemory (const int heapBytesToPrefault)
+{
+    String error;
+
+    if (! juce_lockProcessMemory (error))
+    {
+        addRejectedPolicy (T("memory"), T("mlockall"), error);
+        return false;
+    }
+
+    if (heapBytesToPrefault > 0)
+        juce_prefaultHeap (heapBytesToPrefault);
+
+    return true;
+}
+
+//==============================================================================
+const StringArray RealtimePolicy::getRejectedPolicies()
+{
+    const ScopedLock sl (rejectedLock);
+
+    return rejectedPolicies;
+}
+
+bool RealtimePolicy::getCurrentThreadScheduling (bool& isRealtime, int& priority, uint32& affinityMask)
+{
+    return juce_getCurrentThreadScheduling (isRealtime, priority, affinityMask);
+}
+
+
+END_JUCE_NAMESPACE
@@ -0,0 +1,172 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-9 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_REALTIMEPOLICY_JUCEHEADER__
+#define __JUCE_REALTIMEPOLICY_JUCEHEADER__
+
+#include "../text/juce_StringArray.h"
+
+
+//==============================================================================
+/**
+    Holds the scheduling and memory policy of the process' time critical threads.
+
+    Each kind of thread is given a role, and the policy keeps a realtime priority
+    and a cpu affinity mask for every role. The threads call applyToCurrentThread()
+    when they start, so the policy is set up in one place (usually from the
+    application's settings) instead of being scattered across the threads.
+
+    On linux a role's priority is a SCHED_FIFO priority, 1 to 99. A role with a
+    priority of 0 stays on the normal scheduler. Nothing is changed until the
+    policy is enabled, so by default the threads keep their usual scheduling.
+
+    Requests that the kernel rejects (usually because the user has no rtprio or
+    memlock limits) don't stop the threads running, they are collected and can
+    be listed with getRejectedPolicies().
+
+    e.g. @code
+    RealtimePolicy::setRolePriority (RealtimePolicy::audioThread, 70);
+    RealtimePolicy::setRoleAffinity (RealtimePolicy::audioThread, 1 << 1);
+    RealtimePolicy::setEnabled (true);
+    RealtimePolicy::lockMemory (4 * 1024 * 1024);
+
+    ...and in the audio thread:
+
+    void run()
+    {
+        RealtimePolicy::applyToCurrentThread (RealtimePolicy::audioThread);
+        ...
+    @endcode
+
+    @see Thread, Process
+*/
+class JUCE_API  RealtimePolicy
+{
+public:
+    //==============================================================================
+    /** The roles a thread can have. */
+    enum ThreadRole
+    {
+        audioThread = 0,        /**< the thread calling the audio callback. */
+        graphWorkerThread,      /**< threads doing dsp work for the audio graph. */
+        diskThread,             /**< threads streaming audio from or to disk. */
+        midiInputThread,        /**< threads reading and timestamping midi input. */
+        midiOutputThread,       /**< threads handing scheduled midi output to the driver. */
+        guiThread,              /**< the message thread. */
+
+        numThreadRoles
+    };
+
+    /** Returns a short lowercase name for a role, like "audio" or "disk". */
+    static const String getRoleName (const ThreadRole role);
+
+    //==============================================================================
+    /** Turns the policy on or off.
+
+        While it's off, applyToCurrentThread() does nothing.
+    */
+    static void setEnabled (const bool shouldBeEnabled);
+
+    /** Returns true if the policy is applied to the threads. */
+    static bool isEnabled();
+
+    /** Sets the realtime priority of a role.
+
+        @param role                 the role to change
+        @param realtimePriority     1 to 99 to run the role's threads with SCHED_FIFO,
+                                    or 0 to leave them on the normal scheduler
+    */
+    static void setRolePriority (const ThreadRole role, const int realtimePriority);
+
+    /** Returns the realtime priority of a role, or 0 if it isn't realtime. */
+    static int getRolePriority (const ThreadRole role);
+
+    /** Sets the cpus a role's threads can run on.
+
+        Bit n of the mask stands for cpu n. A mask of 0 leaves the threads free
+        to run on any cpu.
+    */
+    static void setRoleAffinity (const ThreadRole role, const uint32 affinityMask);
+
+    /** Returns the affinity mask of a role, 0 if it can run anywhere. */
+    static uint32 getRoleAffinity (const ThreadRole role);
+
+    /** Sets how much of their stack the threads touch when the policy is applied.
+
+        Touching the stack up front means the pages are mapped (and locked, if
+        lockMemory() was called) before the thread starts its time critical work,
+        instead of faulting the first time a deep call needs them.
+    */
+    static void setStackPrefaultSize (const int numBytes);
+
+    //==============================================================================
+    /** Applies the policy of a role to the thread that calls it.
+
+        The realtime priority, the affinity and the stack prefaulting are done
+        in that order. Anything the kernel rejects is added to the list returned
+        by getRejectedPolicies().
+
+        @returns false if some of the policy couldn't be applied
+    */
+    static bool applyToCurrentThread (const ThreadRole role);
+
+    /** Locks the process' memory and prefaults some heap.
+
+        All the pages mapped now or later are locked in memory, so the audio
+        threads can't be stalled by paging. A block of heap is then allocated and
+        touched, and kept by the allocator once freed, so the first allocations
+        made afterwards don't have to grow the heap.
+
+        @returns false if the memory couldn't be locked
+    */
+    static bool lockMemory (const int heapBytesToPrefault);
+
+    //==============================================================================
+    /** Returns a description of each request the kernel rejected.
+
+        e.g. "audio: SCHED_FIFO priority 70 rejected (Operation not permitted)"
+    */
+    static const StringArray getRejectedPolicies();
+
+    /** Reads back the scheduling of the calling thread.
+
+        This is what the kernel reports, so it can be used to check a policy
+        really was applied.
+
+        @param isRealtime       set to true if the thread runs with SCHED_FIFO or SCHED_RR
+        @param priority         the thread's realtime priority, or 0
+        @param affinityMask     the cpus the thread can run on
+        @returns false if the scheduling can't be read on this platform
+    */
+    static bool getCurrentThreadScheduling (bool& isRealtime, int& priority, uint32& affinityMask);
+
+private:
+    RealtimePolicy();
+    RealtimePolicy (const RealtimePolicy&);
+    const RealtimePolicy& operator= (const RealtimePolicy&);
+};
+
+
+#endif   // __JUCE_REALTIMEPOLICY_JUCEHEADER__
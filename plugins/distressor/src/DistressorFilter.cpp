@@ -40,12 +40,17 @@ AudioProcessor* JUCE_CALLTYPE createPluginFilter()
 
 //==============================================================================
 DistressorFilter::DistressorFilter()
+    : thr (1.0f), rat (0.0f), att (1.0f), rel (0.0f),
+      trim (1.0f), lthr (0.0f), xthr (0.0f), xrat (0.0f),
+      mode (0),
+      parametersChanged (true)
 {
 	Pars = new OppressorParMan();
 }
 
 DistressorFilter::~DistressorFilter()
 {
+    delete Pars;
 }
 
 //==============================================================================
@@ -68,6 +73,12 @@ void DistressorFilter::setParameter (int index, float newValue)
 {
 	if (Pars->getParameter(index) != newValue) {Pars->setParameter(index,newValue);}
 
+    // the coefficients are worked out by the audio thread, at the next block
+    parametersChanged = true;
+}
+
+void DistressorFilter::updateCoefficients()
+{
 	//calcs here
     mode=0;
     thr = (float)pow(10.f, 2.f * Pars->getParameter(OppressorParMan::thresh) - 2.f);
@@ -89,6 +100,8 @@ void DistressorFilter::setParameter (int index, float newValue)
     } 
 
     if(rat<0.0f && thr<0.1f) rat *= thr*15.f;
+
+    kernel.setCoefficients (thr, rat, trim, att, rel, lthr, mode);
 }
 
 const String DistressorFilter::getParameterName (int index)
@@ -143,7 +156,16 @@ bool DistressorFilter::producesMidi() const
 //==============================================================================
 void DistressorFilter::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
-    // do your pre-playback setup stuff here..
+    parametersChanged = false;
+    updateCoefficients();
+
+    // 1.5ms of lookahead for the limiter
+    const int numChannels = jmax (1, getNumInputChannels(), getNumOutputChannels());
+
+    kernel.prepare (numChannels, roundDoubleToInt (sampleRate * 0.0015));
+    setLatencySamples (kernel.getLookahead());
+
+    channels.malloc (numChannels);
 }
 
 void DistressorFilter::releaseResources()
@@ -152,77 +174,32 @@ void DistressorFilter::releaseResources()
     // spare memory, etc.
 }
 
-void DistressorFilter::oppressor(AudioSampleBuffer* buffer, AudioSampleBuffer* out, int sampleFrames)
+void DistressorFilter::oppressor (AudioSampleBuffer& buffer, int sampleFrames)
 {
-	float *in1 = buffer->getSampleData (0);
-	float *in2 = buffer->getSampleData (1);
-	float *out1 = out->getSampleData (0);
-	float *out2 = out->getSampleData (1);
-
-	float a, b, i, j, g, e=env, e2=env2, ra=rat, re=(1.f-rel), at=att;
-	float tr=trim, th=thr, lth=lthr; // , xth=xthr;  
-	
-	--in1;	
-	--in2;	
-	--out1;
-	--out2;
-
-	if(mode) //comp/gate/lim
-	{
-		if(lth==0.f) lth=1000.f;
-		while(--sampleFrames >= 0)
-		{
-			a = *++in1;
-			b = *++in2;
-
-			i = (a<0.f)? -a : a;
-			j = (b<0.f)? -b : b;
-			i = (j>i)? j : i;
-
-			e = (i>e)? e + at * (i - e) : e * re;
-			e2 = (i>e)? i : e2 * re; //ir;
-
-			g = (e>th)? tr / (1.f + ra * ((e/th) - 1.f)) : tr;
-
-			if(g<0.f) g=0.f; 
-			if(g*e2>lth) g = lth/e2; //limit 
-
-			//  ge = (e>xth)? ge + ga - ga * ge : ge * xrat; //gate
-
-			*++out1 = a * (g);	
-			*++out2 = b * (g);	
-		}
-	}
-	else //compressor only
-	{
-		while(--sampleFrames >= 0)
-		{
-		a = *++in1;
-		b = *++in2;
-
-		i = (a<0.f)? -a : a;
-		j = (b<0.f)? -b : b;
-		i = (j>i)? j : i; //get peak level
-
-		e = (i>e)? e + at * (i - e) : e * re; //envelope
-		g = (e>th)? tr / (1.f + ra * ((e/th) - 1.f)) : tr; //gain
-
-		*++out1 = a * (g); //vca
-		*++out2 = b * (g);	
-		}
-	}
+    const int numChannels = jmin (buffer.getNumChannels(), kernel.getNumChannels());
+
+    if (parametersChanged)
+    {
+        parametersChanged = false;
+        updateCoefficients();
+    }
 
-	if(e <1.0e-10) env =0.f; else env =e;
-	if(e2<1.0e-10) env2=0.f; else env2=e2;
-	// if(ge<1.0e-10) genv=0.f; else genv=ge;
+    for (int pos = 0; pos < sampleFrames; pos += DistressorKernel::maxBlockSize)
+    {
+        const int numSamples = jmin ((int) DistressorKernel::maxBlockSize, sampleFrames - pos);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            channels [ch] = buffer.getSampleData (ch, pos);
+
+        kernel.process (channels, numChannels, numSamples);
+    }
 }
 
 void DistressorFilter::processBlock (AudioSampleBuffer& buffer,
                                    MidiBuffer& midiMessages)
 {
-   AudioSampleBuffer inputBuffer(buffer);
-   oppressor(&inputBuffer, &buffer, buffer.getNumSamples());
-   
+    // processed in place, nothing is allocated here
+    oppressor (buffer, buffer.getNumSamples());
 
     // for each of our input channels, we'll attenuate its level by the
     // amount that our volume parameter is set to.
@@ -27,11 +27,15 @@
 #define DEMOJUCEPLUGINFILTER_H
 
 #include "OppressorParameters.h"
+#include "DistressorKernel.h"
 
 //==============================================================================
 /**
     A compressor with some distortion.
 
+    The detector runs a little ahead of the audio, which is delayed by the
+    lookahead time, so the limiter can pull the gain down before a peak gets
+    to the output. The delay is reported as the plugin latency.
 */
 class DistressorFilter  : public AudioProcessor,
                         public ChangeBroadcaster
@@ -83,7 +87,7 @@ public:
 
     //==============================================================================
 	void initToDefault();
-	void oppressor (AudioSampleBuffer* buffer, AudioSampleBuffer* out, int sampleFrames);
+	void oppressor (AudioSampleBuffer& buffer, int sampleFrames);
 
     //==============================================================================
     juce_UseDebuggingNewOperator
@@ -99,8 +103,15 @@ private:
 
 protected:
 
-	float thr, rat, env, env2, att, rel, trim, lthr, xthr, xrat;
+	void updateCoefficients();
+
+	float thr, rat, att, rel, trim, lthr, xthr, xrat;
 	int mode;
+	volatile bool parametersChanged;
+
+	// the signal path, and the channel pointers it's given, both allocated in prepareToPlay
+	DistressorKernel kernel;
+	HeapBlock <float*> channels;
 };
 
 #endif
@@ -0,0 +1,286 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-9 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef DISTRESSORKERNEL_H
+#define DISTRESSORKERNEL_H
+
+//==============================================================================
+/**
+    The signal path of the Distressor, without the plugin around it.
+
+    A peak detector drives a static gain curve and a limiter, and the audio
+    is delayed by a lookahead time. The gains are held at their lowest over
+    lookahead + 1 samples and then averaged over the lookahead, so each gain
+    is reached by the time its own sample comes out of the delay, and the
+    limiter fades in before a peak instead of stepping on it.
+
+    Everything is allocated by prepare(), process() only works in the blocks
+    it already has, so it can run on the audio thread.
+*/
+class DistressorKernel
+{
+public:
+	//==============================================================================
+	enum
+	{
+		maxBlockSize = 256,
+		maxLookahead = 512
+	};
+
+	DistressorKernel()
+		: thr (1.0f), rat (0.0f), trim (1.0f), att (1.0f), rel (0.0f), lthr (0.0f),
+		  mode (0), env (0.0f), env2 (0.0f),
+		  numChannels (0), lookahead (1),
+		  wedgeStart (0), wedgeSize (0), sampleCount (0),
+		  historyPosition (0), gainSum (0.0)
+	{
+		peaks.malloc (maxBlockSize);
+		envelopes.malloc (maxBlockSize);
+		gains.malloc (maxBlockSize);
+		delayed.malloc (maxBlockSize + maxLookahead);
+		wedgeGains.malloc (maxLookahead + 1);
+		wedgeTimes.malloc (maxLookahead + 1);
+		gainHistory.calloc (maxLookahead);
+	}
+
+	//==============================================================================
+	/** Sets the curve, with the values the plugin works out from its parameters
+
+		A limit of 0 turns the limiter off.
+	*/
+	void setCoefficients (const float threshold, const float ratio, const float outputGain,
+	                      const float attack, const float release, const float limit, const int mode_)
+	{
+		thr = threshold;
+		rat = ratio;
+		trim = outputGain;
+		att = attack;
+		rel = release;
+		lthr = limit;
+		mode = mode_;
+	}
+
+	/** Clears the state and sets the channels and lookahead for the next blocks
+
+		This allocates the delay lines, so call it before playback starts.
+	*/
+	void prepare (const int numChannels_, const int lookahead_)
+	{
+		numChannels = jmax (1, numChannels_);
+		lookahead = jlimit (1, (int) maxLookahead, lookahead_);
+
+		delayLines.calloc (numChannels * lookahead);
+
+		env = env2 = 0.0f;
+
+		// start with the history full of the resting gain, so nothing fades in
+		for (int i = 0; i < lookahead; ++i)
+			gainHistory[i] = trim;
+
+		historyPosition = 0;
+		gainSum = trim * (double) lookahead;
+
+		wedgeStart = wedgeSize = 0;
+		sampleCount = 0;
+	}
+
+	/** Returns the delay added to the audio, in samples */
+	int getLookahead() const                    { return lookahead; }
+
+	/** Returns the number of channels passed to prepare() */
+	int getNumChannels() const                  { return numChannels; }
+
+	//==============================================================================
+	/** Processes up to maxBlockSize samples of up to getNumChannels() channels in place */
+	void process (float** channels, const int numChannelsToProcess, const int numSamples)
+	{
+		jassert (numSamples <= maxBlockSize);
+		jassert (numChannelsToProcess <= numChannels);
+
+		int k, ch;
+
+		// peak level of all the channels
+		for (k = 0; k < numSamples; ++k)
+			peaks[k] = fabsf (channels[0][k]);
+
+		for (ch = 1; ch < numChannelsToProcess; ++ch)
+		{
+			const float* const x = channels[ch];
+
+			for (k = 0; k < numSamples; ++k)
+			{
+				const float j = fabsf (x[k]);
+				peaks[k] = (j > peaks[k]) ? j : peaks[k];
+			}
+		}
+
+		// the envelopes are recurrences, so they are followed one sample at a time
+		float e=env, e2=env2, re=(1.f-rel), at=att;
+
+		if(mode) //comp/gate/lim
+		{
+			for (k = 0; k < numSamples; ++k)
+			{
+				const float i = peaks[k];
+
+				e = (i>e)? e + at * (i - e) : e * re;
+				e2 = (i>e)? i : e2 * re; //ir;
+
+				envelopes[k] = e;
+				peaks[k] = e2;
+			}
+		}
+		else //compressor only
+		{
+			for (k = 0; k < numSamples; ++k)
+			{
+				const float i = peaks[k];
+
+				e = (i>e)? e + at * (i - e) : e * re; //envelope
+				envelopes[k] = e;
+			}
+		}
+
+		if(e <1.0e-10) env =0.f; else env =e;
+		if(e2<1.0e-10) env2=0.f; else env2=e2;
+
+		// static gain curve, branch free so the compiler can vectorise it
+		const float ra=rat, tr=trim, th=thr, lth=(lthr==0.f) ? 1000.f : lthr;
+
+		for (k = 0; k < numSamples; ++k)
+		{
+			const float ek = envelopes[k];
+			gains[k] = (ek>th)? tr / (1.f + ra * ((ek/th) - 1.f)) : tr; //gain
+		}
+
+		if(mode)
+		{
+			for (k = 0; k < numSamples; ++k)
+			{
+				float g = gains[k];
+				const float e2k = peaks[k];
+
+				g = (g<0.f) ? 0.f : g;
+				gains[k] = (g*e2k>lth) ? lth/e2k : g; //limit
+			}
+		}
+
+		holdAndAverage (numSamples);
+
+		// vca, on the audio delayed by the lookahead
+		for (ch = 0; ch < numChannelsToProcess; ++ch)
+		{
+			float* const x = channels[ch];
+			float* const delayLine = delayLines + ch * lookahead;
+
+			memcpy (delayed, delayLine, lookahead * sizeof (float));
+			memcpy (delayed + lookahead, x, numSamples * sizeof (float));
+
+			for (k = 0; k < numSamples; ++k)
+				x[k] = delayed[k] * gains[k];
+
+			memcpy (delayLine, delayed + numSamples, lookahead * sizeof (float));
+		}
+
+		// the summed gain drifts slowly with rounding, so rebuild it now and then
+		gainSum = 0.0;
+		for (k = 0; k < lookahead; ++k)
+			gainSum += gainHistory[k];
+	}
+
+	//==============================================================================
+	juce_UseDebuggingNewOperator
+
+private:
+	/*
+		Holds the lowest gain of the last lookahead + 1 samples, then averages it
+		over the lookahead: the gain is already down by the time a peak comes out
+		of the delay line, and it gets there smoothly.
+
+		The lowest gain comes from a queue of rising gains in a ring. The oldest
+		one is dropped before the new one goes in, so the ring never holds more
+		than holdLength gains.
+	*/
+	void holdAndAverage (const int numSamples)
+	{
+		const int holdLength = lookahead + 1;
+		const double scale = 1.0 / lookahead;
+
+		for (int k = 0; k < numSamples; ++k)
+		{
+			const float g = gains[k];
+
+			if (wedgeSize > 0 && sampleCount - wedgeTimes[wedgeStart] >= (unsigned int) holdLength)
+			{
+				wedgeStart = (wedgeStart + 1) % holdLength;
+				--wedgeSize;
+			}
+
+			while (wedgeSize > 0 && wedgeGains[(wedgeStart + wedgeSize - 1) % holdLength] >= g)
+				--wedgeSize;
+
+			const int back = (wedgeStart + wedgeSize++) % holdLength;
+			wedgeGains[back] = g;
+			wedgeTimes[back] = sampleCount++;
+
+			const float held = wedgeGains[wedgeStart];
+			gainSum += held - gainHistory[historyPosition];
+			gainHistory[historyPosition] = held;
+
+			if (++historyPosition >= lookahead)
+				historyPosition = 0;
+
+			gains[k] = (float) (gainSum * scale);
+		}
+	}
+
+	float thr, rat, trim, att, rel, lthr;
+	int mode;
+	float env, env2;
+
+	int numChannels, lookahead;
+
+	// lookahead delay lines, one after the other, the oldest samples first
+	HeapBlock <float> delayLines;
+
+	// scratch space for one block
+	HeapBlock <float> peaks, envelopes, gains, delayed;
+
+	// the lowest gain over the lookahead, kept as a queue of rising gains
+	HeapBlock <float> wedgeGains;
+	HeapBlock <unsigned int> wedgeTimes;
+	int wedgeStart, wedgeSize;
+	unsigned int sampleCount;
+
+	// the held gains, averaged over the lookahead so the limiter fades in before a peak
+	HeapBlock <float> gainHistory;
+	int historyPosition;
+	double gainSum;
+
+	DistressorKernel (const DistressorKernel&);
+	const DistressorKernel& operator= (const DistressorKernel&);
+};
+
+#endif
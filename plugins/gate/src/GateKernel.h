@@ -0,0 +1,209 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library - "Jules' Utility Class Extensions"
+   Copyright 2004-9 by Raw Material Software Ltd.
+
+  ------------------------------------------------------------------------------
+
+   JUCE can be redistributed and/or modified under the terms of the GNU General
+   Public License (Version 2), as published by the Free Software Foundation.
+   A copy of the license is included in the JUCE distribution, or can be found
+   online at www.gnu.org/licenses.
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+  ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.rawmaterialsoftware.com/juce for more information.
+
+  ==============================================================================
+*/
+
+#ifndef GATEKERNEL_H
+#define GATEKERNEL_H
+
+#include "adsr.h"
+
+//==============================================================================
+/**
+   The signal path of the gate, without the plugin around it.
+
+   The envelope is retriggered each time the tick worked out from the song
+   position changes, and multiplies a mix of the input and some noise. The
+   work is done a block at a time: the envelope is rendered a segment at a
+   time between the ticks, and only the samples near the next tick have the
+   tick formula worked out.
+*/
+class GateKernel
+{
+public:
+   //==============================================================================
+   enum { maxBlockSize = 256 };
+
+   /** Creates a kernel, the noise starts from the given seed */
+   GateKernel (const uint32 noiseSeed_)
+   :
+      prevBeat(-1),
+      noiseSeed(noiseSeed_)
+   {
+      zeromem(&adsrState, sizeof(adsrState));
+
+      envelope.malloc (maxBlockSize);
+      noiseBuffer.malloc (maxBlockSize);
+   }
+
+   //==============================================================================
+   /** Makes the next rolling block trigger the envelope */
+   void stop() { prevBeat = -1; }
+
+   /** Returns true while the envelope isn't idle */
+   bool isGateOpen() const {return adsrState.state != ADSR_IDLE;};
+
+   //==============================================================================
+   /** Gates some channels in place
+
+      @param rolling          false if the transport is stopped, the envelope then just runs out
+      @param ppq              the song position of the first sample, in quarter notes
+      @param beatsPerSample   how far the position moves with each sample
+      @param attackSamples    the attack of the envelope
+      @param decaySamples     the decay of the envelope
+      @param noiseLevel       how much noise to mix in
+      @param dryLevel         how much of the input to mix in
+   */
+   void process (float** channels, const int numChannels, const int numSamples,
+                 const bool rolling, const double ppqPosition, const double beatsPerSample,
+                 const int numerator, const int denominator, const double ticksPerBar,
+                 const unsigned attackSamples, const unsigned decaySamples,
+                 const float noiseLevel, const float dryLevel)
+   {
+      double ppq = ppqPosition;
+
+      for (int start = 0; start < numSamples; start += maxBlockSize)
+      {
+         const int chunkSize = jmin((int) maxBlockSize, numSamples - start);
+
+         // render the envelope a segment at a time, retriggering it where the tick changes
+         int sample = 0;
+
+         while (sample < chunkSize)
+         {
+            int segmentEnd = chunkSize;
+
+            if (rolling)
+            {
+               const double tick = ppqToTick(ppq, numerator, denominator, ticksPerBar);
+
+               if (prevBeat != tick)
+               {
+                  adsr_trigger(&adsrState, attackSamples, decaySamples, 0, 0);
+                  prevBeat = tick;
+               }
+
+               segmentEnd = sample + samplesUntilNextTick(ppq, beatsPerSample, tick, chunkSize - sample,
+                                                          numerator, denominator, ticksPerBar);
+            }
+
+            adsr_render(&adsrState, envelope + sample, segmentEnd - sample);
+            sample = segmentEnd;
+         }
+
+         for (int channel = 0; channel < numChannels; ++channel)
+         {
+            float* sampleData = channels[channel] + start;
+            fillNoise(noiseBuffer, chunkSize);
+
+            for (int i = 0; i < chunkSize; ++i)
+               sampleData[i] = envelope[i] * (noiseBuffer[i] * noiseLevel + sampleData[i] * dryLevel);
+         }
+      }
+
+      if (! rolling)
+         prevBeat = -1; // ensure we get the first tick when we restart
+   }
+
+   //==============================================================================
+   /** Returns the tick a song position falls in */
+   static double ppqToTick (const double ppq, const int numerator, const int denominator, const double ticksPerBar)
+   {
+      const int ppqPerBar = jmax(1, numerator * 4 / jmax(1, denominator)); // aka beats per bar
+      const double beats  = (ppq / ppqPerBar) * numerator; // total beats, and fraction
+
+      return (double) ((int) ((beats / ppqPerBar) * ticksPerBar));
+   }
+
+   //==============================================================================
+   juce_UseDebuggingNewOperator
+
+private:
+   int samplesUntilNextTick (double& ppq, const double beatsPerSample, const double tick, const int maxSamples,
+                             const int numerator, const int denominator, const double ticksPerBar) const
+   {
+      const int ppqPerBar = jmax(1, numerator * 4 / jmax(1, denominator));
+      const double ticksPerPpq = (numerator * ticksPerBar) / (ppqPerBar * (double) ppqPerBar);
+
+      if (beatsPerSample <= 0 || ticksPerPpq <= 0)
+      {
+         ppq += maxSamples * beatsPerSample;
+         return maxSamples;
+      }
+
+      // the position is advanced one sample at a time, like the host would, so the
+      // steps land on the same samples. The straight line tells where the next
+      // tick is, so only the last couple of samples need their tick checking
+      const double nextTick = (ppq * ticksPerPpq >= 0) ? tick + 1 : tick;
+      const double guess = ceil((nextTick / ticksPerPpq - ppq) / beatsPerSample) - 2;
+      const int numToSkip = (guess >= maxSamples) ? maxSamples : (int) jmax(0.0, guess);
+
+      double position = ppq;
+      int numSamples = 0;
+
+      for (; numSamples < numToSkip; ++numSamples)
+         position += beatsPerSample;
+
+      if (ppqToTick(position, numerator, denominator, ticksPerBar) != tick)
+      {
+         position = ppq; // the guess was too far, go through them all
+         numSamples = 0;
+      }
+
+      while (numSamples < maxSamples && ppqToTick(position, numerator, denominator, ticksPerBar) == tick)
+      {
+         position += beatsPerSample;
+         ++numSamples;
+      }
+
+      ppq = position;
+      return numSamples;
+   }
+
+   void fillNoise (float* dest, const int numSamples)
+   {
+      uint32 seed = noiseSeed;
+
+      for (int i = 0; i < numSamples; ++i)
+      {
+         seed = seed * 1664525 + 1013904223;
+         dest[i] = 0.5f - seed * (1.0f / 4294967296.0f);
+      }
+
+      noiseSeed = seed;
+   }
+
+   adsr_t adsrState;
+   double prevBeat;
+
+   // the envelope and noise for one chunk, so the gate works a block at a time
+   HeapBlock <float> envelope, noiseBuffer;
+
+   // a per instance generator, rand() is shared and slow
+   uint32 noiseSeed;
+
+   GateKernel (const GateKernel&);
+   const GateKernel& operator= (const GateKernel&);
+};
+
+#endif
@@ -61,29 +61,6 @@ AudioProcessor* JUCE_CALLTYPE createPluginFilter()
     return new JiveGateFilter();
 }
 
-void ppqToBarBeatTick(const double ppq, const int numerator, const int denominator, const double ticksPerBar, int& bar, int& beat, double& tick)
-{
-   bar = 0;
-   beat = 0;
-   tick = 0;
-
-//    if (numerator == 0 || denominator == 0)
-//        return T("1|1|0");
-
-    const int ppqPerBar = (numerator * 4 / denominator); // aka beats per bar
-//    const double beats  = (fmod (ppq, ppqPerBar) / ppqPerBar) * numerator;
-    const double beats  = (ppq / ppqPerBar) * numerator; // total beats, and fraction
-
-    bar       = ((int) ppq) / ppqPerBar + 1;
-    beat      = ((int) beats) + 1;
-//    tick     = ((int) (fmod (beats * ppqPerBar, 1.0) * 960.0));
-    tick     = ((int) ((beats / ppqPerBar) * ticksPerBar));
-
-//    String s;
-//    s << bar << T('|') << beat << T('|') << ticks;
-//    return s;
-}
-
 //==============================================================================
 JiveGateFilter::JiveGateFilter()
 :
@@ -93,9 +70,10 @@ JiveGateFilter::JiveGateFilter()
    release(0.2),
    noise(0.3),
    sampleRate(44100),
-   gateRate(1)
+   gateRate(1),
+   kernel((uint32) Random::getSystemRandom().nextInt()),
+   maxChannels(0)
 {
-    zeromem(&adsrState, sizeof(adsrState));
 }
 
 JiveGateFilter::~JiveGateFilter()
@@ -130,8 +108,9 @@ float JiveGateFilter::getParameter (int index)
 
 double JiveGateFilter::rateParamToTicksPerBar()
 {
-      int index = round(gateRate * sizeof(GateNotes)/sizeof(GateNotes[0])-1);
-      return GateNotes[int(index)];
+      const int numNotes = sizeof(GateNotes)/sizeof(GateNotes[0]);
+      int index = round(gateRate * numNotes-1);
+      return GateNotes[jlimit(0, numNotes - 1, index)];
 }
 
 void JiveGateFilter::setParameter (int index, float newValue)
@@ -226,8 +205,10 @@ bool JiveGateFilter::producesMidi() const
 void JiveGateFilter::prepareToPlay (double sampleRate_, int samplesPerBlock)
 {
    sampleRate = sampleRate_;
-   bar = 0; beat = 0; 
-   prevBeat = -1;
+   kernel.stop();
+
+   maxChannels = getNumInputChannels();
+   channels.malloc (jmax(1, maxChannels));
 }
 
 void JiveGateFilter::releaseResources()
@@ -240,9 +221,10 @@ void JiveGateFilter::processBlock (AudioSampleBuffer& buffer,
                                    MidiBuffer& midiMessages)
 {
    AudioPlayHead::CurrentPositionInfo pos;
+   zeromem(&pos, sizeof(pos));
 
    bool rolling = false;
-   double ppqPosition = 0, tick = 0;
+   double ppqPosition = 0;
    double beatsPerSample = 0;
    if (getPlayHead() != 0 && getPlayHead()->getCurrentPosition(pos))
    {
@@ -254,34 +236,22 @@ void JiveGateFilter::processBlock (AudioSampleBuffer& buffer,
       }
    }
 
-   // for each sample
-   for (int sample = 0; sample < buffer.getNumSamples(); sample++)
-   { 
-      bool trig = false;
-      
-      // perform any triggers
-      if (rolling)
-      {
-         ppqToBarBeatTick(ppqPosition, pos.timeSigNumerator, pos.timeSigDenominator, rateParamToTicksPerBar(), bar, beat, tick);
-         if (prevBeat != tick)
-         {   
-            trig = true;
-            adsr_trigger(&adsrState, logifyEnvelopeParameter(attack) * sampleRate, fudgeReleaseTime() * sampleRate, 0, 0);
-            //std::cerr << "trigger!" << std::endl;
-         }
-      }
+   // these only change once per block
+   const double ticksPerBar = rateParamToTicksPerBar();
+   const unsigned attackSamples = (unsigned) (logifyEnvelopeParameter(attack) * sampleRate);
+   const unsigned decaySamples = (unsigned) (fudgeReleaseTime() * sampleRate);
+   const float noiseLevel = (float) noise;
+   const float dryLevel = (float) ((1.0 - noise) / 2.0);
 
-      adsr_process(&adsrState);
-      
-      for (int channel = 0; channel < getNumInputChannels(); ++channel)
-      {     
-         float* sampleData = buffer.getSampleData(channel);
-         sampleData[sample] = adsrState.env * ((0.5 - rand() / static_cast<float>(RAND_MAX)) * (noise) + sampleData[sample] * (1.0 - noise) / 2.0);
-      }
-      
-      ppqPosition += beatsPerSample;
-      prevBeat = rolling ? tick : -1; // ensure we get the first tick when we restart
-   }
+   const int numChannels = jmin(maxChannels, getNumInputChannels(), buffer.getNumChannels());
+
+   for (int channel = 0; channel < numChannels; ++channel)
+      channels[channel] = buffer.getSampleData(channel);
+
+   kernel.process(channels, numChannels, buffer.getNumSamples(),
+                  rolling, ppqPosition, beatsPerSample,
+                  pos.timeSigNumerator, pos.timeSigDenominator, ticksPerBar,
+                  attackSamples, decaySamples, noiseLevel, dryLevel);
 }
 
 //==============================================================================
@@ -26,7 +26,7 @@
 #ifndef DEMOJUCEPLUGINFILTER_H
 #define DEMOJUCEPLUGINFILTER_H
 
-#include "adsr.h"
+#include "GateKernel.h"
 
 //==============================================================================
 /**
@@ -137,9 +137,8 @@ private:
    double rateParamToTicksPerBar();
    double fudgeReleaseTime() {return logifyEnvelopeParameter(release) * 0.5;};
    double logifyEnvelopeParameter(double p);
-   bool isGateOpen() {return adsrState.state != ADSR_IDLE;};
+   bool isGateOpen() {return kernel.isGateOpen();};
 
-   adsr_t adsrState; 
    double attack;
 //   double decay;
 //   double sustain;
@@ -148,8 +147,12 @@ private:
    int sampleRate;
    double gateRate;
 
-   int bar, beat;
-   double prevBeat;
+   // the envelope and noise, worked out a block at a time
+   GateKernel kernel;
+
+   // the channels passed to the kernel, allocated in prepareToPlay
+   HeapBlock <float*> channels;
+   int maxChannels;
 };
 
 #endif
@@ -96,6 +96,80 @@ inline static float adsr_process(adsr_t *adsr)
 }
 
 
+/* fills dest with the next n values of a segment that moves towards target:
+ * the same curve as calling env += coef*(target - env) n times, worked out as
+ * four interleaved geometric series so the loop has no dependency */
+inline static float adsr_fill_segment(float *dest, unsigned n, float env,
+	float target, float coef)
+{
+	const float r = 1.f-coef;
+	const float r4 = (r*r)*(r*r);
+	float d = env - target;
+	float p0, p1, p2, p3;
+	unsigned i = 0;
+
+	if(n == 0)
+		return env;
+
+	/* well below ADSR_SILENCE, stop before the series goes denormal */
+	if(fabsf(d) < 1.0e-10f)
+		d = 0.f;
+
+	p0 = d*r;
+	p1 = p0*r;
+	p2 = p1*r;
+	p3 = p2*r;
+
+	for(; i+4 <= n; i += 4)
+	{
+		dest[i] = target + p0;
+		dest[i+1] = target + p1;
+		dest[i+2] = target + p2;
+		dest[i+3] = target + p3;
+
+		p0 *= r4;
+		p1 *= r4;
+		p2 *= r4;
+		p3 *= r4;
+	}
+
+	if(i < n) dest[i++] = target + p0;
+	if(i < n) dest[i++] = target + p1;
+	if(i < n) dest[i++] = target + p2;
+
+	return dest[n-1];
+}
+
+
+/* renders the next n samples of the envelope, the same as calling
+ * adsr_process n times, one segment at a time */
+inline static void adsr_render(adsr_t *adsr, float *dest, unsigned n)
+{
+	while(n > 0)
+	{
+		unsigned len = n;
+
+		if(adsr->state == ADSR_ATTACK)
+		{
+			if(adsr->s >= adsr->time)
+			{
+				adsr->env_target = adsr->sustain;
+				adsr->coef = adsr->d_coef;
+				adsr->time = adsr->d_time;
+			}
+
+			if(adsr->s < adsr->time && adsr->time - adsr->s < len)
+				len = adsr->time - adsr->s;
+		}
+
+		adsr->env = adsr_fill_segment(dest, len, adsr->env, adsr->env_target, adsr->coef);
+		adsr->s += len;
+		dest += len;
+		n -= len;
+	}
+}
+
+
 #endif /* ADSR_H */
 
 
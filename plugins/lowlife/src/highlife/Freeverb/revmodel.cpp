@@ -4,8 +4,14 @@
 // http://www.dreampoint.co.uk
 // This code is public domain
 
+#include "../StandardHeader.h"
 #include "revmodel.hpp"
 
+#if defined(__SSE__) || (defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64)))
+ #include <xmmintrin.h>
+ #define FREEVERB_USE_SSE 1
+#endif
+
 revmodel::revmodel()
 {
 	wet=0.0f; width=0.0f; // Tie the components to their buffers
@@ -68,33 +74,187 @@ void revmodel::mute()
 
 void revmodel::processreplace(float *inputL, float *inputR, float *outputL, float *outputR, long numsamples, int skip,float const f_dry,float const f_wet)
 {
-	float outL,outR,input;
-	
-	for(int s=0;s<numsamples;s++)
+	// Same as running the combs and allpasses one sample at a time,
+	// but each filter goes through a whole block in one loop
+
+	// The feedback decays towards zero for ever, so let the cpu flush it
+	// rather than go through denormals, which are very slow on x86
+	const ScopedDenormalsMode flush(true);
+
+	while(numsamples > 0)
 	{
-		outL = outR = 0;
-		input = (inputL[s] + inputR[s]) * gain;
-			
+		int const n = (numsamples < combblocksize) ? (int)numsamples : combblocksize;
+		int s;
+
+		for(s=0;s<n;s++)
+			blockinput[s] = (inputL[s] + inputR[s]) * gain;
+
 		// Accumulate comb filters in parallel
-		for(int i=0; i<numcombs; i++)
-		{
-			outL += combL[i].process(input);
-			outR += combR[i].process(input);
-		}
-			
+		processcombs(n);
+
 		// Feed through allpasses in series
 		for(int i=0; i<numallpasses; i++)
 		{
-			outL = allpassL[i].process(outL);
-			outR = allpassR[i].process(outR);
+			processallpass(allpassL[i],blockL,n);
+			processallpass(allpassR[i],blockR,n);
 		}
-			
+
 		// Calculate output REPLACING anything already there
-		outputL[s]=(outL*wet1+outR*wet2)*f_wet+inputL[s]*f_dry;
-		outputR[s]=(outR*wet1+outL*wet2)*f_wet+inputR[s]*f_dry;
+		for(s=0;s<n;s++)
+		{
+			outputL[s]=(blockL[s]*wet1+blockR[s]*wet2)*f_wet+inputL[s]*f_dry;
+			outputR[s]=(blockR[s]*wet1+blockL[s]*wet2)*f_wet+inputR[s]*f_dry;
+		}
+
+		inputL += n;
+		inputR += n;
+		outputL += n;
+		outputR += n;
+		numsamples -= n;
 	}
 }
 
+void revmodel::processcombs(int numsamples)
+{
+	int c, s;
+
+#if FREEVERB_USE_SSE
+	// The 8 left combs then the 8 right ones run side by side, 4 per vector
+	comb *filters[numcombs*2];
+	__m128 store[4], damp1[4], damp2[4], feedback[4];
+	float lanes[numcombs*2];
+
+	for(c=0; c<numcombs; c++)
+	{
+		filters[c] = combL + c;
+		filters[c+numcombs] = combR + c;
+	}
+
+	for(c=0; c<4; c++)
+	{
+		comb **f = filters + c*4;
+
+		store[c] = _mm_setr_ps(f[0]->filterstore, f[1]->filterstore, f[2]->filterstore, f[3]->filterstore);
+		damp1[c] = _mm_setr_ps(f[0]->damp1, f[1]->damp1, f[2]->damp1, f[3]->damp1);
+		damp2[c] = _mm_setr_ps(f[0]->damp2, f[1]->damp2, f[2]->damp2, f[3]->damp2);
+		feedback[c] = _mm_setr_ps(f[0]->feedback, f[1]->feedback, f[2]->feedback, f[3]->feedback);
+	}
+
+	for(s=0; s<numsamples;)
+	{
+		// Go as far as the first comb that has to wrap
+		int n = numsamples - s;
+		float *buf[numcombs*2];
+
+		for(c=0; c<numcombs*2; c++)
+		{
+			if(filters[c]->bufsize - filters[c]->bufidx < n)
+				n = filters[c]->bufsize - filters[c]->bufidx;
+
+			buf[c] = filters[c]->buffer + filters[c]->bufidx;
+		}
+
+		for(int i=0; i<n; i++, s++)
+		{
+			__m128 const input = _mm_set1_ps(blockinput[s]);
+			__m128 const out0 = _mm_setr_ps(buf[0][i], buf[1][i], buf[2][i], buf[3][i]);
+			__m128 const out1 = _mm_setr_ps(buf[4][i], buf[5][i], buf[6][i], buf[7][i]);
+			__m128 const out2 = _mm_setr_ps(buf[8][i], buf[9][i], buf[10][i], buf[11][i]);
+			__m128 const out3 = _mm_setr_ps(buf[12][i], buf[13][i], buf[14][i], buf[15][i]);
+
+			store[0] = _mm_add_ps(_mm_mul_ps(out0,damp2[0]),_mm_mul_ps(store[0],damp1[0]));
+			store[1] = _mm_add_ps(_mm_mul_ps(out1,damp2[1]),_mm_mul_ps(store[1],damp1[1]));
+			store[2] = _mm_add_ps(_mm_mul_ps(out2,damp2[2]),_mm_mul_ps(store[2],damp1[2]));
+			store[3] = _mm_add_ps(_mm_mul_ps(out3,damp2[3]),_mm_mul_ps(store[3],damp1[3]));
+
+			_mm_storeu_ps(lanes,_mm_add_ps(input,_mm_mul_ps(store[0],feedback[0])));
+			_mm_storeu_ps(lanes+4,_mm_add_ps(input,_mm_mul_ps(store[1],feedback[1])));
+			_mm_storeu_ps(lanes+8,_mm_add_ps(input,_mm_mul_ps(store[2],feedback[2])));
+			_mm_storeu_ps(lanes+12,_mm_add_ps(input,_mm_mul_ps(store[3],feedback[3])));
+
+			for(c=0; c<numcombs*2; c++)
+				buf[c][i] = lanes[c];
+
+			__m128 sumL = _mm_add_ps(out0,out1);
+			__m128 sumR = _mm_add_ps(out2,out3);
+			sumL = _mm_add_ps(sumL,_mm_movehl_ps(sumL,sumL));
+			sumR = _mm_add_ps(sumR,_mm_movehl_ps(sumR,sumR));
+			_mm_store_ss(blockL+s,_mm_add_ss(sumL,_mm_shuffle_ps(sumL,sumL,1)));
+			_mm_store_ss(blockR+s,_mm_add_ss(sumR,_mm_shuffle_ps(sumR,sumR,1)));
+		}
+
+		for(c=0; c<numcombs*2; c++)
+		{
+			filters[c]->bufidx += n;
+			if(filters[c]->bufidx>=filters[c]->bufsize) filters[c]->bufidx=0;
+		}
+	}
+
+	for(c=0; c<4; c++)
+	{
+		_mm_storeu_ps(lanes,store[c]);
+
+		for(int i=0; i<4; i++)
+			filters[c*4+i]->filterstore = lanes[i];
+	}
+#else
+	for(s=0; s<numsamples; s++)
+	{
+		float outL = 0, outR = 0;
+
+		for(c=0; c<numcombs; c++)
+		{
+			outL += combL[c].process(blockinput[s]);
+			outR += combR[c].process(blockinput[s]);
+		}
+
+		blockL[s] = outL;
+		blockR[s] = outR;
+	}
+#endif
+}
+
+void revmodel::processallpass(allpass& filter, float *samples, int numsamples)
+{
+	// Between wraps the buffer is read and written in order and nothing
+	// is read back until a whole buffer later, so samples can go 4 at a time
+	int idx = filter.bufidx;
+
+	while(numsamples > 0)
+	{
+		int const n = (numsamples < filter.bufsize-idx) ? numsamples : filter.bufsize-idx;
+		float *buf = filter.buffer + idx;
+		int s = 0;
+
+#if FREEVERB_USE_SSE
+		__m128 const feedback = _mm_set1_ps(filter.feedback);
+
+		for(; s+4<=n; s+=4)
+		{
+			__m128 const input = _mm_loadu_ps(samples+s);
+			__m128 const bufout = _mm_loadu_ps(buf+s);
+			_mm_storeu_ps(samples+s,_mm_sub_ps(bufout,input));
+			_mm_storeu_ps(buf+s,_mm_add_ps(input,_mm_mul_ps(bufout,feedback)));
+		}
+#endif
+
+		for(; s<n; s++)
+		{
+			float const input = samples[s];
+			float const bufout = buf[s];
+			samples[s] = -input + bufout;
+			buf[s] = input + (bufout*filter.feedback);
+		}
+
+		samples += n;
+		numsamples -= n;
+		idx += n;
+		if(idx>=filter.bufsize) idx = 0;
+	}
+
+	filter.bufidx = idx;
+}
+
 void revmodel::update()
 {
 	// Recalculate internal values after parameter change
@@ -27,6 +27,8 @@ public:
 	float	getwidth();
 private:
 	void	update();
+	void	processcombs(int numsamples);
+	void	processallpass(allpass& filter, float *samples, int numsamples);
 private:
 	float	gain;
 	float	roomsize,roomsize1;
@@ -74,6 +76,11 @@ private:
 	float	bufallpassR3[allpasstuningR3];
 	float	bufallpassL4[allpasstuningL4];
 	float	bufallpassR4[allpasstuningR4];
+
+	// Block buffers
+	float	blockinput[combblocksize];
+	float	blockL[combblocksize];
+	float	blockR[combblocksize];
 };
 
 #endif//_revmodel_
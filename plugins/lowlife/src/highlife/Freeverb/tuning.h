@@ -22,6 +22,9 @@ const float initialwidth	= 1;
 const float initialmode		= 0;
 const int	stereospread	= 23;
 
+// Samples processed at a time by each stage of the reverb
+const int	combblocksize	= 256;
+
 // These values assume 44.1KHz sample rate
 // they will probably be OK for 48KHz sample rate
 // but would need scaling for 96KHz (or other) sample rates.
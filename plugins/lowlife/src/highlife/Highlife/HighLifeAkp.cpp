@@ -227,11 +227,11 @@ void CHighLife::akp_import (const File& file)
 						char wavpath[MAX_PATH];
 						sprintf (wavpath, "%s.wav", paz->sample_name);
 
-						// alloc new zone and load the sample in it
+						// alloc new zone and queue its sample, it's loaded once the keygroups are parsed
 						File waveFile = file.getParentDirectory ().getChildFile (wavpath);
 						
 						HIGHLIFE_ZONE* phz=tool_alloc_zone(pprg);
-						tool_load_sample (phz, waveFile);
+						tool_queue_sample (phz, waveFile);
 
 						// parse kloc and kzone info
 						phz->lo_input_range.midi_key=pak->kloc.low_note;
@@ -258,5 +258,8 @@ void CHighLife::akp_import (const File& file)
 	
 	// leave critical section
 	set_suspended (0);
+
+	// the keygroups play as their samples come in
+	tool_decode_queued (file);
 }
 
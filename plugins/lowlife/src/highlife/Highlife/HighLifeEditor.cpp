@@ -64,7 +64,10 @@ public:
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 CHighLifeEditor::CHighLifeEditor (CHighLife *effect)
     : AudioProcessorEditor(effect),
-      fx (effect)
+      fx (effect),
+      load_progress (0.0f),
+      load_painted (0.0f),
+      loading (false)
 {
     // define look and feel
     static HighlifeLookAndFeel laf;
@@ -251,6 +254,9 @@ CHighLifeEditor::CHighLifeEditor (CHighLife *effect)
     // set size
     setSize (K_EDITOR_WIDTH, K_EDITOR_HEIGHT + K_EDITOR_KEY_HEIGHT);
     
+    // follow the imports
+    fx->sample_pool->add_listener (this);
+
     // start timer
     startTimer (1000 / 25);
 }
@@ -262,6 +268,8 @@ CHighLifeEditor::~CHighLifeEditor()
 
     stopTimer ();
 
+    fx->sample_pool->remove_listener (this);
+
 	deleteAndZero (midi_keyboard);
 
     menu_file.removeChangeListener (this);
@@ -313,22 +321,26 @@ void CHighLifeEditor::resized ()
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 void CHighLifeEditor::mouseDown (const MouseEvent &e)
 {
-    gui_mouse_down (e.x, e.y, e);
+    if (! loading)
+        gui_mouse_down (e.x, e.y, e);
 }
 
 void CHighLifeEditor::mouseMove (const MouseEvent &e)
 {
-    gui_mouse_move (e.x, e.y, e);
+    if (! loading)
+        gui_mouse_move (e.x, e.y, e);
 }
 
 void CHighLifeEditor::mouseDrag (const MouseEvent &e)
 {
-    gui_mouse_move (e.x, e.y, e);
+    if (! loading)
+        gui_mouse_move (e.x, e.y, e);
 }
 
 void CHighLifeEditor::mouseUp (const MouseEvent &e)
 {
-    gui_mouse_up (e.x, e.y, e);
+    if (! loading)
+        gui_mouse_up (e.x, e.y, e);
 }
 
 void CHighLifeEditor::mouseWheelMove (const MouseEvent &e, float wheelX, float wheelY)
@@ -342,6 +354,15 @@ void CHighLifeEditor::paint (Graphics &g)
 	             0, 0, getWidth(), getHeight(),
 	             0, 0, getWidth(), getHeight());
 
+    if (loading)
+    {
+        // only the progress, the programs are being replaced
+        char buf[256];
+        sprintf (buf, "Importing... %.1f%%", load_painted * 100.0f);
+        gui_paint_fnt (&g, 120, 103, buf, 26);
+        return;
+    }
+
     gui_paint(&g);
 
     fx->gui_recent_update=true;
@@ -349,14 +370,39 @@ void CHighLifeEditor::paint (Graphics &g)
 
 void CHighLifeEditor::timerCallback ()
 {
-    gui_timer ();
+    bool const was_loading = loading;
+    loading = fx->sample_pool->is_loading (fx);
+
+    if (loading)
+    {
+        if (! was_loading || load_painted != load_progress)
+        {
+            load_painted = load_progress;
+            repaint ();
+        }
+    }
+    else if (was_loading)
+    {
+        repaint ();
+    }
+    else
+    {
+        gui_timer ();
+    }
+}
+
+void CHighLifeEditor::sample_pool_progress (CSampleLoader* ploader, const File& file, float const progress)
+{
+    // called on the loading thread, the timer picks it up
+    if (ploader == fx)
+        load_progress = progress;
 }
 
 void CHighLifeEditor::changeListenerCallback (void *objectThatHasChanged)
 {
     CGuiMenu* menu = (CGuiMenu*) objectThatHasChanged;
 
-    if (menu)
+    if (menu && ! loading)
         gui_command (menu->GetResult());
 }
 
@@ -42,6 +42,7 @@
 
 // ddsp includes
 #include "HighLifeGuiMenu.h"
+#include "HighLifeSamplePool.h"
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 class CHighLife;
@@ -54,7 +55,8 @@ class CHighLife;
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 class CHighLifeEditor : public AudioProcessorEditor,
                         public ChangeListener,
-                        public Timer
+                        public Timer,
+                        public CSamplePoolListener
 {
 public:
 
@@ -71,6 +73,7 @@ public:
     virtual void 	paint (Graphics &g);
     virtual void 	timerCallback ();
     virtual void    resized ();
+    virtual void    sample_pool_progress (CSampleLoader* ploader, const File& file, float const progress);
 
 public:
 	bool gui_verify_coord (int x, int y, int zx, int zy, int cx, int cy);
@@ -109,6 +112,11 @@ public:
 
 	CHighLife*	    fx;
 
+	// background import, the programs are left alone until it's done
+	volatile float  load_progress;
+	float           load_painted;
+	bool            loading;
+
     // keyboard
 	MidiKeyboardComponent* midi_keyboard;
 
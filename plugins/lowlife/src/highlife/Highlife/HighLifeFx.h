@@ -40,6 +40,62 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 #include "../Freeverb/revmodel.hpp"
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// level under which a send effect input or tail is taken as silence (-120 dB)
+#define FX_SILENCE	1.0e-6f
+
+// samples it takes for a feedback loop to fade under FX_SILENCE
+inline int fx_get_tail_samples(float const delay_samples,float const feedback)
+{
+	int repeats=1;
+
+	if(feedback>0.0f && feedback<1.0f)
+		repeats+=(int)ceilf(logf(FX_SILENCE)/logf(feedback));
+
+	return int(delay_samples*float(repeats));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+class CFxSend
+{
+public:
+	CFxSend()
+	{
+		idle_samples=0;
+	}
+
+	// looks at the send buffers of a block, returns false once they have been
+	// silent for longer than the effect tail, so the effect can be skipped
+	bool update(float const* pl,float const* pr,int const numsamples,int const tail_samples)
+	{
+		float peak=0.0f;
+
+		for(int s=0;s<numsamples;s++)
+		{
+			float const l=fabsf(pl[s]);
+			float const r=fabsf(pr[s]);
+			peak=(l>peak)?l:peak;
+			peak=(r>peak)?r:peak;
+		}
+
+		if(peak>FX_SILENCE)
+		{
+			idle_samples=0;
+			return true;
+		}
+
+		// the block still carries the tail if the silence started less than a tail ago
+		if(idle_samples>=tail_samples)
+			return false;
+
+		idle_samples+=numsamples;
+		return true;
+	}
+
+public:
+	int idle_samples;
+};
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 class CFxSimpleFilter
 {
@@ -411,6 +467,11 @@ public:
 	{
 	}
 
+	int GetTailSamples(float const f_fdb)
+	{
+		return fx_get_tail_samples(float(MAX_CHO_SIZE),f_fdb*0.95f);
+	}
+
 	void ProcessBuffer(float* pl,float* pr,int const numsamples,float const f_del,float const f_fdb,float const f_rat,float const f_mod,float const scale)
 	{
 		float const f_chr_del=f_del*float(MAX_CHO_SIZE)*0.5f;
@@ -502,11 +563,10 @@ public:
 		counter++;
 	}
 
-	void ProcessBuffer(float* pl,float* pr,int const numsamples,float const f_del,float const f_fdb,int const i_cross,int const i_sync,float const f_sam,float const f_bpm)
+	int GetDelaySamples(float const f_del,int const i_sync,float const f_sam,float const f_bpm)
 	{
 		// some useful contants
 		float const f_tic_sam=(f_sam*15.0f)/f_bpm;
-		float const f_feedbck=f_fdb*0.95f;
 		float const	f_max_del_tks=4.0f;
 
 		// calculate delay time
@@ -524,6 +584,19 @@ public:
 		if(i_delay<256)i_delay=256;
 		if(i_delay>MAX_DEL_SIZE)i_delay=MAX_DEL_SIZE;
 
+		return i_delay;
+	}
+
+	int GetTailSamples(float const f_del,float const f_fdb,int const i_sync,float const f_sam,float const f_bpm)
+	{
+		return fx_get_tail_samples(float(GetDelaySamples(f_del,i_sync,f_sam,f_bpm)),f_fdb*0.95f);
+	}
+
+	void ProcessBuffer(float* pl,float* pr,int const numsamples,float const f_del,float const f_fdb,int const i_cross,int const i_sync,float const f_sam,float const f_bpm)
+	{
+		float const f_feedbck=f_fdb*0.95f;
+		int const i_delay=GetDelaySamples(f_del,i_sync,f_sam,f_bpm);
+
 		// delay process
 		for(int s=0;s<numsamples;s++)
 		{
@@ -685,6 +758,13 @@ public:
 	{
 	}
 
+	int GetTailSamples(float const f_roo)
+	{
+		// the longest comb, fading with the room size feedback, then the allpasses
+		int const i_allpasses=allpasstuningR1+allpasstuningR2+allpasstuningR3+allpasstuningR4;
+		return fx_get_tail_samples(float(combtuningR8),f_roo*scaleroom+offsetroom)+i_allpasses;
+	}
+
 	void ProcessBuffer(float* pl,float* pr,int const numsamples,float const f_roo,float const f_wid,float const f_dam)
 	{
 		reverb.setroomsize(f_roo);
@@ -39,6 +39,104 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 #include "../LibGig/gig.h"
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// A gig file kept open while the samples of its zones are read
+class CHighLifeGigLibrary : public CHighLifeLibrary
+{
+public:
+    CHighLifeGigLibrary (const File& file)
+    {
+        riff = new RIFF::File ((const char*) file.getFullPathName ());
+        gig  = new gig::File (riff);
+
+        // the samples are told apart by their place in the file
+        for (gig::Sample* sample = gig->GetFirstSample(); sample; sample = gig->GetNextSample())
+            samples.add (sample);
+    }
+
+    ~CHighLifeGigLibrary ()
+    {
+        delete gig;
+        delete riff;
+    }
+
+    void library_decode (CHighLife* phl, HIGHLIFE_ZONE* pz, int const region)
+    {
+        gig::Sample* sample = samples [region];
+
+        // read sample 
+        long needed_size = sample->BitDepth == 24 ?  sample->SamplesTotal * sample->Channels * sizeof(int)
+                                                  :  sample->SamplesTotal * sample->FrameSize;
+
+        uint8_t* pWave  = new uint8_t[needed_size];
+        int* pIntWave = (int*) pWave;
+        short* pShortWave = (short*) pWave;
+
+        {
+            // libgig reads through the one file handle, the conversions can go at the same time
+            const ScopedLock sl (read_lock);
+
+            if (sample->Compressed) {
+                printf ("compressed sample \n");
+
+                gig::buffer_t decompressionBuffer;
+                decompressionBuffer.Size = 0;
+                unsigned long decompressionBufferSize = 0;
+            
+                decompressionBuffer = gig::Sample::CreateDecompressionBuffer (sample->SamplesTotal);
+                decompressionBufferSize = sample->SamplesTotal;
+                sample->Read (pWave, sample->SamplesTotal, &decompressionBuffer);
+                gig::Sample::DestroyDecompressionBuffer (decompressionBuffer);
+            } else {
+                printf ("uncompressed sample \n");
+
+                sample->Read (pWave, sample->SamplesTotal);
+            }
+        }
+    
+        if (pWave && sample->SamplesTotal > 0)
+        {
+            phl->tool_alloc_wave (pz, sample->Channels, sample->SamplesTotal);
+
+            if (sample->BitDepth == 24)
+            {
+                int n = sample->SamplesTotal * sample->Channels;
+                for (int i = n - 1 ; i >= 0 ; i--) {
+                    // pIntWave[i] = pWave[i * 3] << 8 | pWave[i * 3 + 1] << 16 | pWave[i * 3 + 2] << 24;
+                    pIntWave[i] = pWave[i * 3] | pWave[i * 3 + 1] << 8 | pWave[i * 3 + 2] << 16;
+                }
+            
+                const float scale = 1.0f / 0x7fffffff;
+                for (int c = 0; c < sample->Channels; c++) {
+                    for (int s = 0; s < sample->SamplesTotal; s++) {
+                        pz->ppwavedata[c][s + WAVE_PAD] = scale * float (pIntWave[s]);
+                    }
+                }
+            }
+            else
+            {
+                const float scale = 1.0f / 0x7fff;
+                for (int c = 0; c < sample->Channels; c++) {
+                    for (int s = 0; s < sample->SamplesTotal; s++) {
+                        pz->ppwavedata[c][s + WAVE_PAD] = scale * float (pShortWave[s]);
+                    }
+                }
+            }
+
+            pz->sample_rate = sample->SamplesPerSecond;
+        }
+
+        delete[] pWave;
+    }
+
+    RIFF::File* riff;
+    gig::File*  gig;
+
+    // the regions are the indices of the samples
+    Array <gig::Sample*> samples;
+    CriticalSection read_lock;
+};
+
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 void CHighLife::gig_import (const File& file)
@@ -46,8 +144,8 @@ void CHighLife::gig_import (const File& file)
 	// enter critical section
 	set_suspended (1);
 
-    RIFF::File* riff = new RIFF::File ((const char*) file.getFullPathName ());
-    gig::File*  gig  = new gig::File (riff);
+    ReferenceCountedObjectPtr <CHighLifeGigLibrary> library = new CHighLifeGigLibrary (file);
+    gig::File* gig = library->gig;
 
     int p = 0;
 
@@ -184,62 +282,13 @@ void CHighLife::gig_import (const File& file)
                 }
                 pz->res_group = iGroup;
 
-                // read sample 
-                long needed_size = sample->BitDepth == 24 ?  sample->SamplesTotal * sample->Channels * sizeof(int)
-                                                          :  sample->SamplesTotal * sample->FrameSize;
-
-                uint8_t* pWave  = new uint8_t[needed_size];
-                int* pIntWave = (int*) pWave;
-                short* pShortWave = (short*) pWave;
-
-                if (sample->Compressed) {
-                    printf ("compressed sample \n");
-
-                    gig::buffer_t decompressionBuffer;
-                    decompressionBuffer.Size = 0;
-                    unsigned long decompressionBufferSize = 0;
-                    
-                    decompressionBuffer = gig::Sample::CreateDecompressionBuffer (sample->SamplesTotal);
-                    decompressionBufferSize = sample->SamplesTotal;
-                    sample->Read (pWave, sample->SamplesTotal, &decompressionBuffer);
-                    gig::Sample::DestroyDecompressionBuffer (decompressionBuffer);
-                } else {
-                    printf ("uncompressed sample \n");
-
-                    sample->Read (pWave, sample->SamplesTotal);
-                }
-                
-                if (pWave && sample->SamplesTotal > 0)
-                {
-                    tool_alloc_wave (pz, sample->Channels, sample->SamplesTotal);
+                // the sample data is read once the instruments are imported, and it's shared by
+                // all the zones that load it
+                pz->sample_rate = sample->SamplesPerSecond;
 
-                    if (sample->BitDepth == 24)
-                    {
-                        int n = sample->SamplesTotal * sample->Channels;
-                        for (int i = n - 1 ; i >= 0 ; i--) {
-                            // pIntWave[i] = pWave[i * 3] << 8 | pWave[i * 3 + 1] << 16 | pWave[i * 3 + 2] << 24;
-                            pIntWave[i] = pWave[i * 3] | pWave[i * 3 + 1] << 8 | pWave[i * 3 + 2] << 16;
-                        }
-                        
-                        const float scale = 1.0f / 0x7fffffff;
-                        for (int c = 0; c < sample->Channels; c++) {
-                            for (int s = 0; s < sample->SamplesTotal; s++) {
-                                pz->ppwavedata[c][s + WAVE_PAD] = scale * float (pIntWave[s]);
-                            }
-                        }
-                    }
-                    else
-                    {
-                        const float scale = 1.0f / 0x7fff;
-                        for (int c = 0; c < sample->Channels; c++) {
-                            for (int s = 0; s < sample->SamplesTotal; s++) {
-                                pz->ppwavedata[c][s + WAVE_PAD] = scale * float (pShortWave[s]);
-                            }
-                        }
-                    }
-                    
-                    delete[] pWave;
-                }
+                tool_queue_region (pz, library, library->samples.indexOf (sample),
+                                   T("gig ") + String (library->samples.indexOf (sample)),
+                                   file, sample->SamplesPerSecond);
             }
 
             region = instrument->GetNextRegion();
@@ -256,8 +305,8 @@ void CHighLife::gig_import (const File& file)
 	// enter critical section
     set_suspended (0);
 
-    delete gig;
-    delete riff;
+	// the zones play as their samples come in
+	tool_decode_queued (file);
 }
 
 
@@ -113,8 +113,26 @@ void CHighLife::plug_load_program(int const index,CMemStreamIn* pmi)
       while (fileChar != 0);
       tool_delete_wave (pz);
       if (strlen(pz->path) > 0)
+      {
+         // the saved markers are at the rate the zone was converted to
+         HIGHLIFE_ZONE const saved = *pz;
+
          tool_load_sample(pz, File(pz->path));
 
+         if (pz->num_samples > 0 && saved.sample_rate > 0)
+         {
+            double const scale = double (pz->sample_rate) / double (saved.sample_rate);
+
+            pz->loop_start = jlimit (0, pz->num_samples, roundDoubleToInt (saved.loop_start * scale));
+            pz->loop_end = jlimit (0, pz->num_samples, roundDoubleToInt (saved.loop_end * scale));
+
+            pz->num_cues = saved.num_cues;
+
+            for (int p = 0; p < saved.num_cues; p++)
+               pz->cue_pos[p] = jlimit (0, pz->num_samples, roundDoubleToInt (saved.cue_pos[p] * scale));
+         }
+      }
+
 #else //JUST_SAVE_FILE_PATHS
 		// allocate channels
 		pz->ppwavedata=new float*[pz->num_channels];
@@ -190,25 +208,26 @@ void CHighLife::plug_block_process(float **outputs,int const block_samples,bool
 	tool_init_dsp_buffer(mixer_buffer[0],block_samples,0);
 	tool_init_dsp_buffer(mixer_buffer[1],block_samples,0);
 	
-	// fx chorus buffer clear
+	// fx send buffers clear, with true silence so idle effects can be spotted
+	// (they get skipped long before their tails could decay into denormals)
 	if(pprog->efx_chr)
 	{
-		tool_init_dsp_buffer(fxchr_buffer[0],block_samples,1);
-		tool_init_dsp_buffer(fxchr_buffer[1],block_samples,1);
+		tool_init_dsp_buffer(fxchr_buffer[0],block_samples,0);
+		tool_init_dsp_buffer(fxchr_buffer[1],block_samples,0);
 	}
 	
 	// fx delay buffer clear
 	if(pprog->efx_del)
 	{
-		tool_init_dsp_buffer(fxdel_buffer[0],block_samples,1);
-		tool_init_dsp_buffer(fxdel_buffer[1],block_samples,1);
+		tool_init_dsp_buffer(fxdel_buffer[0],block_samples,0);
+		tool_init_dsp_buffer(fxdel_buffer[1],block_samples,0);
 	}
 	
 	// fx reverb buffer clear
 	if(pprog->efx_rev)
 	{
-		tool_init_dsp_buffer(fxrev_buffer[0],block_samples,1);
-		tool_init_dsp_buffer(fxrev_buffer[1],block_samples,1);
+		tool_init_dsp_buffer(fxrev_buffer[0],block_samples,0);
+		tool_init_dsp_buffer(fxrev_buffer[1],block_samples,0);
 	}
 
 	// get sample rate and sequencer tempo
@@ -263,8 +282,8 @@ void CHighLife::plug_block_process(float **outputs,int const block_samples,bool
 		}
 	}
 
-	// efx chorus process and mix
-	if(pprog->efx_chr)
+	// efx chorus process and mix, unless its input has been silent for longer than its tail
+	if(pprog->efx_chr && fx_chr_send.update(fxchr_buffer[0],fxchr_buffer[1],block_samples,fx_cho.GetTailSamples(pprog->efx_chr_fdb)))
 	{
 		fx_cho.ProcessBuffer(fxchr_buffer[0],fxchr_buffer[1],block_samples,pprog->efx_chr_del,pprog->efx_chr_fdb,pprog->efx_chr_rat,pprog->efx_chr_mod,44100.0f/f_sample_rate);
 		tool_mix_dsp_buffer(fxchr_buffer[0],mixer_buffer[0],block_samples);
@@ -272,7 +291,7 @@ void CHighLife::plug_block_process(float **outputs,int const block_samples,bool
 	}
 	
 	// efx delay process and mix
-	if(pprog->efx_del)
+	if(pprog->efx_del && fx_del_send.update(fxdel_buffer[0],fxdel_buffer[1],block_samples,fx_del.GetTailSamples(pprog->efx_del_del,pprog->efx_del_fdb,pprog->efx_del_syn,getSampleRate(),f_tempo)))
 	{
 		fx_del.ProcessBuffer(fxdel_buffer[0],fxdel_buffer[1],block_samples,pprog->efx_del_del,pprog->efx_del_fdb,pprog->efx_del_cro,pprog->efx_del_syn,getSampleRate(),f_tempo);
 		tool_mix_dsp_buffer(fxdel_buffer[0],mixer_buffer[0],block_samples);
@@ -280,7 +299,7 @@ void CHighLife::plug_block_process(float **outputs,int const block_samples,bool
 	}
 
 	// efx reverb process and mix
-	if(pprog->efx_rev)
+	if(pprog->efx_rev && fx_rev_send.update(fxrev_buffer[0],fxrev_buffer[1],block_samples,fx_rev.GetTailSamples(pprog->efx_rev_roo)))
 	{
 		fx_rev.ProcessBuffer(fxrev_buffer[0],fxrev_buffer[1],block_samples,pprog->efx_rev_roo,pprog->efx_rev_wid,pprog->efx_rev_dam);
 		tool_mix_dsp_buffer(fxrev_buffer[0],mixer_buffer[0],block_samples);
@@ -379,6 +398,7 @@ void CHighLife::plug_note_on(uint8 const key,uint8 const vel)
 
 	// update keyboard state
 	user_keyb_sta[key]=1;
+	user_keyb_plays[key]++;
 
 	// store last key and velocity
 	user_last_key=midi_state.midi_key;
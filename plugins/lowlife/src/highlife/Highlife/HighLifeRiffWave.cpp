@@ -46,7 +46,7 @@ CRiffWave::~CRiffWave(void)
 	delete[] psmpl_loop;
 }
 
-int CRiffWave::ReadWave(char const* pfilename)
+int CRiffWave::ReadWave(char const* pfilename,bool const read_data)
 {
 	FILE* pfile=fopen(pfilename,"rb");
 
@@ -107,8 +107,17 @@ int CRiffWave::ReadWave(char const* pfilename)
 		case 'atad':
 			fread(&chk_size,sizeof(unsigned long),1,pfile);
 			snd_buffer_length=chk_size;
-			psnd_buffer=new char[chk_size];
-			fread(psnd_buffer,sizeof(char),chk_size,pfile);
+
+			// the caller may read the samples some other way
+			if(read_data)
+			{
+				psnd_buffer=new char[chk_size];
+				fread(psnd_buffer,sizeof(char),chk_size,pfile);
+			}
+			else
+			{
+				fseek(pfile,chk_size,SEEK_CUR);
+			}
 			break;
 		
 			// sample chunk
@@ -88,7 +88,7 @@ public:
 	~CRiffWave(void);
 
 public:
-	int						ReadWave(char const* pfilename);
+	int						ReadWave(char const* pfilename,bool const read_data=true);
 	DDSP_RIFF_WAVE_FRMT*	GetFormat(void);
 	DDSP_RIFF_WAVE_SMPL*	GetSample(void);
 	DDSP_RIFF_WAVE_LOOP*	GetLoop(long const index);
@@ -50,6 +50,9 @@ void CHighLife::sed_sel_vol_change(float const a,float const b)
 		// get zone
 		HIGHLIFE_ZONE* pz=&pprg->pzones[user_sed_zone];
 
+		// work on a wave of the zone's own, not on a shared one
+		tool_unshare_wave(pz);
+
 		if(user_sed_sel_len>0)
 		{
 			float const f_step=(b-a)/float(user_sed_sel_len);
@@ -139,6 +142,9 @@ void CHighLife::sed_sel_1st_order_iir(float const fc)
 		// get zone
 		HIGHLIFE_ZONE* pz=&pprg->pzones[user_sed_zone];
 
+		// work on a wave of the zone's own, not on a shared one
+		tool_unshare_wave(pz);
+
 		if(user_sed_sel_len>0)
 		{
 			// filter each channel
@@ -169,6 +175,9 @@ void CHighLife::sed_sel_dc_remove(void)
 		// get zone
 		HIGHLIFE_ZONE* pz=&pprg->pzones[user_sed_zone];
 
+		// work on a wave of the zone's own, not on a shared one
+		tool_unshare_wave(pz);
+
 		if(user_sed_sel_len>0)
 		{
 			// dc block each channel
@@ -222,6 +231,9 @@ void CHighLife::sed_sel_reverse(void)
 		// get zone
 		HIGHLIFE_ZONE* pz=&pprg->pzones[user_sed_zone];
 
+		// work on a wave of the zone's own, not on a shared one
+		tool_unshare_wave(pz);
+
 		if(user_sed_sel_len>0)
 		{
 			// filter each channel
@@ -253,6 +265,9 @@ void CHighLife::sed_sel_rectify(void)
 		// get zone
 		HIGHLIFE_ZONE* pz=&pprg->pzones[user_sed_zone];
 
+		// work on a wave of the zone's own, not on a shared one
+		tool_unshare_wave(pz);
+
 		if(user_sed_sel_len>0)
 		{
 			// filter each channel
@@ -283,6 +298,9 @@ void CHighLife::sed_sel_mathdrive(int const mode)
 		// get zone
 		HIGHLIFE_ZONE* pz=&pprg->pzones[user_sed_zone];
 
+		// work on a wave of the zone's own, not on a shared one
+		tool_unshare_wave(pz);
+
 		if(user_sed_sel_len>0)
 		{
 			// filter each channel
@@ -355,6 +373,9 @@ void CHighLife::sed_sel_cut(void)
 		// get zone
 		HIGHLIFE_ZONE* pz=&pprg->pzones[user_sed_zone];
 
+		// work on a wave of the zone's own, not on a shared one
+		tool_unshare_wave(pz);
+
 		if(user_sed_sel_len>0)
 		{
 			// enter critical section
@@ -452,6 +473,9 @@ void CHighLife::sed_sel_paste(void)
 		// get zone
 		HIGHLIFE_ZONE* pz=&pprg->pzones[user_sed_zone];
 
+		// work on a wave of the zone's own, not on a shared one
+		tool_unshare_wave(pz);
+
 		// verify we have clip data
 		if(user_clip_sample_size>0 && user_clip_sample_channels>0)
 		{
@@ -538,6 +562,9 @@ void CHighLife::sed_sel_trim(void)
 		// get zone
 		HIGHLIFE_ZONE* pz=&pprg->pzones[user_sed_zone];
 
+		// work on a wave of the zone's own, not on a shared one
+		tool_unshare_wave(pz);
+
 		if(user_sed_sel_len>0)
 		{
 			// enter critical section
@@ -754,8 +781,11 @@ void CHighLife::sed_time_stretch (double const pitchShift, double const timeRati
         
         fclose (pfout);
 
-        // allocate the new wave
-        tool_alloc_wave (pz, pz->num_channels, countOut);
+        // replace the old wave, which may be shared
+        int const num_channels = pz->num_channels;
+
+        tool_delete_wave (pz);
+        tool_alloc_wave (pz, num_channels, countOut);
 	    pfout = fopen ((const char*) tempFile.getFullPathName (), "rb");
 
 	    for (int s = 0; s < pz->num_samples; s++)
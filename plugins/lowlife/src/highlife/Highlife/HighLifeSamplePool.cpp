@@ -0,0 +1,508 @@
+/*-
+ * Copyright (c) discoDSP
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 4. All advertising materials mentioning features or use of this software
+ *    must display the following acknowledgement:
+ *        This product includes software developed by discoDSP
+ *        http://www.discodsp.com/ and contributors.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// HighLife Sample Pool Implementation                                                                                                 //
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include "HighLifeSamplePool.h"
+#include "HighLifeVoice.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static CriticalSection	pool_instance_lock;
+static CSamplePool*		ppool_instance=NULL;
+static int				pool_num_instances=0;
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+struct SAMPLE_POOL_KEY_ORDER
+{
+	static int compareElements(const SAMPLE_POOL_WAVE* pa,const SAMPLE_POOL_WAVE* pb)
+	{
+		return pa->key.compare(pb->key);
+	}
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+struct SAMPLE_POOL_PRIORITY_ORDER
+{
+	static int compareElements(const CSampleDecoder* pa,const CSampleDecoder* pb)
+	{
+		if(pa->priority>pb->priority)
+			return -1;
+
+		return pa->priority<pb->priority ? 1 : 0;
+	}
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+class CSampleDecodeJob : public ThreadPoolJob
+{
+public:
+	CSampleDecodeJob(CSampleDecoder* pdecoder_,int& num_done_,WaitableEvent& done_)
+		: ThreadPoolJob (T("HighLife Sample Decoder")),
+		  pdecoder(pdecoder_),
+		  num_done(num_done_),
+		  done(done_)
+	{
+	}
+
+	JobStatus runJob()
+	{
+		pdecoder->sample_decoder_run();
+
+		Atomic::increment(num_done);
+		done.signal();
+
+		return jobHasFinished;
+	}
+
+private:
+	CSampleDecoder*	pdecoder;
+	int&			num_done;
+	WaitableEvent&	done;
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+CSamplePool::CSamplePool()
+	: Thread ("HighLife Sample Loader"),
+	  num_allocations(0),
+	  num_decodes(0),
+	  num_bytes(0),
+	  prunning_loader(NULL),
+	  pdecoding_threads(NULL),
+	  num_regions_done(0),
+	  cancel_running(false)
+{
+}
+
+CSamplePool::~CSamplePool()
+{
+	// the instances have cancelled their loads by now, so the thread is idle
+	signalThreadShouldExit();
+	notify();
+	stopThread(5000);
+	delete pdecoding_threads;
+
+	// and they have released their zones
+	jassert(waves.size()==0);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+CSamplePool* CSamplePool::attach()
+{
+	const ScopedLock sl(pool_instance_lock);
+
+	if(ppool_instance==NULL)
+		ppool_instance=new CSamplePool();
+
+	pool_num_instances++;
+
+	return ppool_instance;
+}
+
+void CSamplePool::detach()
+{
+	const ScopedLock sl(pool_instance_lock);
+
+	jassert(pool_num_instances>0);
+
+	if(--pool_num_instances<=0)
+	{
+		delete ppool_instance;
+		ppool_instance=NULL;
+		pool_num_instances=0;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+const String CSamplePool::make_key(const File& file,const String& region)
+{
+	return file.getFullPathName()
+	       +T("|")+String(file.getLastModificationTime().toMilliseconds())
+	       +T("|")+region;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+float** CSamplePool::acquire(const String& key,int& num_channels,int& num_samples,int& sample_rate)
+{
+	const ScopedLock sl(wave_lock);
+
+	SAMPLE_POOL_WAVE probe;
+	probe.key=key;
+
+	SAMPLE_POOL_KEY_ORDER order;
+	int const index=waves.indexOfSorted(order,&probe);
+
+	if(index<0)
+		return NULL;
+
+	SAMPLE_POOL_WAVE* pwave=waves.getUnchecked(index);
+	pwave->num_refs++;
+
+	num_channels=pwave->num_channels;
+	num_samples=pwave->num_samples;
+	sample_rate=pwave->sample_rate;
+
+	return pwave->ppwavedata;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+float** CSamplePool::publish(const String& key,float** ppwavedata,int& num_channels,int& num_samples,int& sample_rate)
+{
+	if(ppwavedata==NULL)
+		return NULL;
+
+	const ScopedLock sl(wave_lock);
+
+	// counted even when it's thrown away below, it was decoded all the same
+	num_decodes++;
+
+	SAMPLE_POOL_WAVE decoded;
+	decoded.ppwavedata=ppwavedata;
+	decoded.num_channels=num_channels;
+
+	// somebody was quicker, use theirs
+	float** ppexisting=acquire(key,num_channels,num_samples,sample_rate);
+
+	if(ppexisting!=NULL)
+	{
+		free_wave(&decoded);
+
+		return ppexisting;
+	}
+
+	SAMPLE_POOL_WAVE* pwave=new SAMPLE_POOL_WAVE;
+	pwave->key=key;
+	pwave->ppwavedata=ppwavedata;
+	pwave->num_channels=num_channels;
+	pwave->num_samples=num_samples;
+	pwave->sample_rate=sample_rate;
+	pwave->num_refs=1;
+
+	SAMPLE_POOL_KEY_ORDER order;
+	waves.addSorted(order,pwave);
+
+	num_allocations++;
+	num_bytes+=int64(num_channels)*int64(num_samples+WAVE_PAD*2)*sizeof(float);
+
+	return ppwavedata;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool CSamplePool::release(float** ppwavedata)
+{
+	if(ppwavedata==NULL)
+		return false;
+
+	const ScopedLock sl(wave_lock);
+
+	int const index=index_of_wave(ppwavedata);
+
+	if(index<0)
+		return false;
+
+	SAMPLE_POOL_WAVE* pwave=waves.getUnchecked(index);
+
+	if(--pwave->num_refs<=0)
+	{
+		num_bytes-=int64(pwave->num_channels)*int64(pwave->num_samples+WAVE_PAD*2)*sizeof(float);
+
+		free_wave(pwave);
+		waves.remove(index);
+	}
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+float** CSamplePool::unshare(float** ppwavedata,int const num_channels,int const num_samples)
+{
+	const ScopedLock sl(wave_lock);
+
+	int const index=index_of_wave(ppwavedata);
+
+	if(index<0)
+		return ppwavedata;
+
+	SAMPLE_POOL_WAVE* pwave=waves.getUnchecked(index);
+
+	// the only user takes the wave over, without copying it
+	if(pwave->num_refs==1)
+	{
+		num_bytes-=int64(pwave->num_channels)*int64(pwave->num_samples+WAVE_PAD*2)*sizeof(float);
+
+		pwave->ppwavedata=NULL;
+		waves.remove(index);
+
+		return ppwavedata;
+	}
+
+	int const num_pad_samples=num_samples+(WAVE_PAD*2);
+
+	float** ppcopy=new float*[num_channels];
+
+	for(int c=0;c<num_channels;c++)
+	{
+		ppcopy[c]=new float[num_pad_samples];
+		memcpy(ppcopy[c],ppwavedata[c],num_pad_samples*sizeof(float));
+	}
+
+	pwave->num_refs--;
+
+	return ppcopy;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int CSamplePool::get_num_waves()
+{
+	const ScopedLock sl(wave_lock);
+	return waves.size();
+}
+
+int CSamplePool::get_num_allocations()
+{
+	const ScopedLock sl(wave_lock);
+	return num_allocations;
+}
+
+int CSamplePool::get_num_decodes()
+{
+	const ScopedLock sl(wave_lock);
+	return num_decodes;
+}
+
+int64 CSamplePool::get_num_bytes()
+{
+	const ScopedLock sl(wave_lock);
+	return num_bytes;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int CSamplePool::index_of_wave(float** ppwavedata) const
+{
+	for(int w=waves.size();--w>=0;)
+	{
+		if(waves.getUnchecked(w)->ppwavedata==ppwavedata)
+			return w;
+	}
+
+	return -1;
+}
+
+void CSamplePool::free_wave(SAMPLE_POOL_WAVE* pwave)
+{
+	for(int c=0;c<pwave->num_channels && pwave->ppwavedata;c++)
+		delete[] pwave->ppwavedata[c];
+
+	delete[] pwave->ppwavedata;
+	pwave->ppwavedata=NULL;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void CSamplePool::load_in_background(CSampleLoader* ploader,const File& file)
+{
+	{
+		const ScopedLock sl(job_lock);
+
+		SAMPLE_POOL_JOB* pjob=new SAMPLE_POOL_JOB;
+		pjob->ploader=ploader;
+		pjob->file=file;
+		jobs.add(pjob);
+	}
+
+	if(!isThreadRunning())
+		startThread(3);
+
+	notify();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool CSamplePool::is_loading(CSampleLoader* ploader)
+{
+	const ScopedLock sl(job_lock);
+
+	if(prunning_loader==ploader)
+		return true;
+
+	for(int j=0;j<jobs.size();j++)
+	{
+		if(jobs.getUnchecked(j)->ploader==ploader)
+			return true;
+	}
+
+	return false;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void CSamplePool::wait_for_loads(CSampleLoader* ploader)
+{
+	// a loader waiting for itself would never return
+	if(Thread::getCurrentThreadId()==getThreadId())
+		return;
+
+	while(is_loading(ploader))
+		job_done.wait(20);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void CSamplePool::cancel_loads(CSampleLoader* ploader)
+{
+	{
+		const ScopedLock sl(job_lock);
+
+		for(int j=jobs.size();--j>=0;)
+		{
+			if(jobs.getUnchecked(j)->ploader==ploader)
+				jobs.remove(j);
+		}
+
+		// and stop decoding the library it's loading
+		if(prunning_loader==ploader)
+			cancel_running=true;
+	}
+
+	wait_for_loads(ploader);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void CSamplePool::decode_in_parallel(CSampleLoader* ploader,const File& file,OwnedArray <CSampleDecoder>& decoders)
+{
+	int const num_decoders=decoders.size();
+
+	if(num_decoders==0)
+		return;
+
+	if(pdecoding_threads==NULL)
+	{
+		// as many threads as cpus, below the audio like the loading thread
+		pdecoding_threads=new ThreadPool(jmax(1,SystemStats::getNumCpus()));
+		pdecoding_threads->setThreadPriorities(3);
+	}
+
+	// the threads take the jobs in the order they were added
+	SAMPLE_POOL_PRIORITY_ORDER order;
+	decoders.sort(order,true);
+
+	OwnedArray <CSampleDecodeJob> decode_jobs;
+	num_regions_done=0;
+
+	for(int d=0;d<num_decoders;d++)
+	{
+		CSampleDecodeJob* pjob=new CSampleDecodeJob(decoders.getUnchecked(d),num_regions_done,region_done);
+		decode_jobs.add(pjob);
+		pdecoding_threads->addJob(pjob);
+	}
+
+	int num_reported=0;
+
+	while(num_reported<num_decoders && !cancel_running && !threadShouldExit())
+	{
+		region_done.wait(50);
+
+		int const num_done=num_regions_done;
+
+		if(num_done!=num_reported)
+		{
+			num_reported=num_done;
+			report_progress(ploader,file,float(num_done)/float(num_decoders));
+		}
+	}
+
+	// drop the regions that haven't started if the load was cancelled, and wait for the running ones
+	pdecoding_threads->removeAllJobs(false,-1);
+
+	decode_jobs.clear();
+	decoders.clear();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void CSamplePool::report_progress(CSampleLoader* ploader,const File& file,float const progress)
+{
+	const ScopedLock sl(listener_lock);
+
+	for(int l=listeners.size();--l>=0;)
+		listeners.getUnchecked(l)->sample_pool_progress(ploader,file,progress);
+}
+
+void CSamplePool::add_listener(CSamplePoolListener* plistener)
+{
+	const ScopedLock sl(listener_lock);
+	listeners.addIfNotAlreadyThere(plistener);
+}
+
+void CSamplePool::remove_listener(CSamplePoolListener* plistener)
+{
+	const ScopedLock sl(listener_lock);
+	listeners.removeValue(plistener);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void CSamplePool::run()
+{
+	while(!threadShouldExit())
+	{
+		SAMPLE_POOL_JOB* pjob=NULL;
+
+		{
+			const ScopedLock sl(job_lock);
+
+			if(jobs.size()>0)
+			{
+				pjob=jobs.getUnchecked(0);
+				jobs.remove(0,false);
+				prunning_loader=pjob->ploader;
+				cancel_running=false;
+			}
+		}
+
+		if(pjob==NULL)
+		{
+			wait(-1);
+			continue;
+		}
+
+		report_progress(pjob->ploader,pjob->file,0.0f);
+		pjob->ploader->sample_loader_run(pjob->file);
+		report_progress(pjob->ploader,pjob->file,1.0f);
+
+		{
+			const ScopedLock sl(job_lock);
+			prunning_loader=NULL;
+		}
+
+		delete pjob;
+		job_done.signal();
+	}
+}
@@ -0,0 +1,214 @@
+/*-
+ * Copyright (c) discoDSP
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 4. All advertising materials mentioning features or use of this software
+ *    must display the following acknowledgement:
+ *        This product includes software developed by discoDSP
+ *        http://www.discodsp.com/ and contributors.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// HighLife Sample Pool Header                                                                                                         //
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#ifndef __HIGHLIFE_SAMPLE_POOL_HEADER_H__
+#define __HIGHLIFE_SAMPLE_POOL_HEADER_H__
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include "../StandardHeader.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Something that loads files on the loading thread of the pool, like a HighLife instance importing a program
+class CSampleLoader
+{
+public:
+	virtual ~CSampleLoader() {}
+
+	// called on the loading thread for each file queued with CSamplePool::load_in_background
+	virtual void sample_loader_run(const File& file)=0;
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Gets told how far the loads of the pool have got
+class CSamplePoolListener
+{
+public:
+	virtual ~CSamplePoolListener() {}
+
+	// called on the loading thread, with a progress from 0 to 1 which is 1 once the file is done
+	virtual void sample_pool_progress(CSampleLoader* ploader,const File& file,float const progress)=0;
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Decodes the wave of one region of a library, on one of the decoding threads of the pool
+class CSampleDecoder
+{
+public:
+	CSampleDecoder() : priority(0.0f) {}
+	virtual ~CSampleDecoder() {}
+
+	// called on a decoding thread, while the other regions of the library are decoded on the others
+	virtual void sample_decoder_run()=0;
+
+	// the regions with the highest priority are decoded first
+	float priority;
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+struct SAMPLE_POOL_WAVE
+{
+	// file path, modification time and region the wave was decoded from
+	String	key;
+
+	// padded wavedata, as tool_alloc_wave makes it
+	float**	ppwavedata;
+	int		num_channels;
+	int		num_samples;
+	int		sample_rate;
+
+	// zones using it, in all the instances
+	int		num_refs;
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// The waves decoded from files, shared by all the HighLife instances of the process.
+//
+// A wave is published under a key made of the file, its modification time and the part of the file it
+// came from, and from then on the zones loading the same key just take a reference to it. Waves in the
+// pool are never changed: an edit first gets a copy of its own with unshare(). The last reference frees
+// the wave, so the pool never holds memory that no zone uses.
+//
+// The pool also runs one loading thread for the whole process, so two instances importing the same
+// library one after the other decode it only once, and the second one just collects the references.
+// A loader imports the structure of a library on it and then hands the regions over to the decoding
+// threads, one per cpu, which decode them at the same time, most wanted first.
+//
+// Each instance attaches to the pool when it's created and detaches once its zones are freed, and
+// the pool is deleted with the last one.
+class CSamplePool : private Thread
+{
+public:
+	// returns the pool of the process, creating it for the first instance
+	static CSamplePool* attach();
+
+	// called by each instance that attached, the last one deletes the pool
+	static void detach();
+
+public:
+	// builds the key of a wave decoded from a region of a file
+	static const String make_key(const File& file,const String& region);
+
+	// returns the wave stored under a key with one more reference, or NULL if it hasn't been loaded
+	float** acquire(const String& key,int& num_channels,int& num_samples,int& sample_rate);
+
+	// hands a wave that was just decoded over to the pool, with one reference. if another loader has
+	// published the same key in the meantime, the wave passed in is freed and the existing one is
+	// returned instead, with its sizes
+	float** publish(const String& key,float** ppwavedata,int& num_channels,int& num_samples,int& sample_rate);
+
+	// drops a reference to a wave, the last one frees it. returns false if the wave isn't in the pool
+	bool release(float** ppwavedata);
+
+	// returns a wave that the caller owns and can change: the same one if it isn't in the pool or if
+	// nothing else uses it (it's then taken out of the pool), a copy of it otherwise
+	float** unshare(float** ppwavedata,int const num_channels,int const num_samples);
+
+	// statistics: the waves held, the waves ever kept, the waves ever handed to publish() (kept or not)
+	// and the bytes held
+	int	  get_num_waves();
+	int	  get_num_allocations();
+	int	  get_num_decodes();
+	int64 get_num_bytes();
+
+public:
+	// queues a file to be loaded by a loader on the loading thread
+	void load_in_background(CSampleLoader* ploader,const File& file);
+
+	// returns true while a loader has files queued or loading
+	bool is_loading(CSampleLoader* ploader);
+
+	// waits until the files queued for a loader are loaded
+	void wait_for_loads(CSampleLoader* ploader);
+
+	// removes the files queued for a loader and waits for the one it's loading, if any
+	void cancel_loads(CSampleLoader* ploader);
+
+	// decodes the regions of a library on the decoding threads, the ones with the highest priority first,
+	// and deletes the decoders. called by a loader on the loading thread once it has imported the structure
+	// of the library, it reports the progress as the regions are done and returns when they all are, or as
+	// soon as the loads of the loader are cancelled
+	void decode_in_parallel(CSampleLoader* ploader,const File& file,OwnedArray <CSampleDecoder>& decoders);
+
+	// called by the loaders as they go, passed on to the listeners
+	void report_progress(CSampleLoader* ploader,const File& file,float const progress);
+
+	void add_listener(CSamplePoolListener* plistener);
+	void remove_listener(CSamplePoolListener* plistener);
+
+	juce_UseDebuggingNewOperator
+
+private:
+	struct SAMPLE_POOL_JOB
+	{
+		CSampleLoader*	ploader;
+		File			file;
+	};
+
+	CSamplePool();
+	~CSamplePool();
+
+	void run();
+	int  index_of_wave(float** ppwavedata) const;
+	void free_wave(SAMPLE_POOL_WAVE* pwave);
+
+	// waves sorted by key
+	CriticalSection			wave_lock;
+	OwnedArray <SAMPLE_POOL_WAVE> waves;
+	int						num_allocations;
+	int						num_decodes;
+	int64					num_bytes;
+
+	// background loads
+	CriticalSection			job_lock;
+	OwnedArray <SAMPLE_POOL_JOB> jobs;
+	CSampleLoader*			prunning_loader;
+	WaitableEvent			job_done;
+
+	// regions being decoded for the running loader
+	ThreadPool*				pdecoding_threads;
+	WaitableEvent			region_done;
+	int						num_regions_done;
+	bool volatile			cancel_running;
+
+	CriticalSection			listener_lock;
+	Array <CSamplePoolListener*> listeners;
+
+	CSamplePool (const CSamplePool&);
+	const CSamplePool& operator= (const CSamplePool&);
+};
+
+#endif
@@ -41,6 +41,57 @@
 
 #include "../FluidSynth/src/fluid_defsfont.h"
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// A soundfont kept loaded while the samples of its zones are copied out
+class CHighLifeSf2Library : public CHighLifeLibrary
+{
+public:
+	CHighLifeSf2Library (const File& file)
+	{
+		sfont = new_fluid_defsfont ();
+		fluid_defsfont_load (sfont, (const char*) file.getFullPathName ());
+	}
+
+	~CHighLifeSf2Library ()
+	{
+		delete_fluid_defsfont (sfont);
+	}
+
+	void library_decode (CHighLife* phl, HIGHLIFE_ZONE* pz, int const region)
+	{
+		fluid_sample_t* sample = samples [region];
+
+		const int num_samples = sample->end - sample->start;
+
+		// copy over sample data (could be optimized)
+		if (num_samples > 0)
+		{
+			phl->tool_alloc_wave (pz, 1, num_samples);
+/*                            
+			fluid_defsfont_load_sampledata_into (sfont, 
+												 sample->start,
+												 num_samples,
+												 pz->ppwavedata,
+												 0,
+												 num_samples,
+												 WAVE_PAD);
+*/
+			const float scale = 1.0f / 32768.0f;
+			for (int s = 0; s < num_samples; s++)
+			{
+				pz->ppwavedata[0][s + WAVE_PAD] = float (sample->data[sample->start + s]) * scale;
+			}
+
+			pz->sample_rate = sample->samplerate;
+		}
+	}
+
+	fluid_defsfont_t* sfont;
+
+	// the samples used by the zones, the regions are their indices
+	Array <fluid_sample_t*> samples;
+};
+
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 void CHighLife::sf2_import(const File& file)
@@ -48,11 +99,9 @@ void CHighLife::sf2_import(const File& file)
 	// enter critical section
 	set_suspended (1);
 
-    fluid_defsfont_t* sfont = new_fluid_defsfont ();
-    fluid_defsfont_load (sfont, (const char*) file.getFullPathName ());
-    fluid_defsfont_load_sampledata (sfont);
+    ReferenceCountedObjectPtr <CHighLifeSf2Library> library = new CHighLifeSf2Library (file);
 
-    fluid_defpreset_t* preset = sfont->preset;
+    fluid_defpreset_t* preset = library->sfont->preset;
 
     int p = 0;
 
@@ -229,24 +278,17 @@ void CHighLife::sf2_import(const File& file)
 					    pz->loop_end = loopend;
 				    }
 
-                    // copy over sample data (could be optimized)
+                    // the sample data is copied out once the presets are imported, and it's shared
+                    // by all the zones that load it
                     if (num_samples > 0)
                     {
-                        tool_alloc_wave (pz, 1, num_samples);
-/*                            
-                        fluid_defsfont_load_sampledata_into (sfont, 
-                                                             sample->start,
-                                                             num_samples,
-                                                             pz->ppwavedata,
-                                                             0,
-                                                             num_samples,
-                                                             WAVE_PAD);
-*/
-                        const float scale = 1.0f / 32768.0f;
-                        for (int s = 0; s < num_samples; s++)
-                        {
-                            pz->ppwavedata[0][s + WAVE_PAD] = float (sample->data[sample->start + s]) * scale;
-                        }
+                        pz->sample_rate = sample->samplerate;
+
+                        library->samples.addIfNotAlreadyThere (sample);
+
+                        tool_queue_region (pz, library, library->samples.indexOf (sample),
+                                           T("sf2 ") + String (sample->start) + T("-") + String (sample->end),
+                                           file, sample->samplerate);
                     }
                 
                 } while ((realzone = realzone->next) != 0);
@@ -261,14 +303,15 @@ void CHighLife::sf2_import(const File& file)
     }
     while ((preset = preset->next) != 0);
 
-    delete_fluid_defsfont (sfont);
-
 	// sample editor should adapt
 	user_sed_adapt=1;
 	user_sed_zone=0;
 
 	// enter critical section
     set_suspended (0);
+
+	// the zones play as their samples come in
+	tool_decode_queued (file);
 }
 
 
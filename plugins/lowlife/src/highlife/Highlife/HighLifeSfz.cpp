@@ -198,9 +198,9 @@ void CHighLife::sfz_import(const File& file)
 											wavefilename[fc]=0;
 									}
 
-									// load sample
+									// queue the sample, it's loaded once the regions are parsed
                                     File waveFile = file.getParentDirectory().getChildFile (wavefilename);
-									tool_load_sample (pz, waveFile);
+									tool_queue_sample (pz, waveFile);
 								}
 								else if(strncmp(word,"lokey",5)==0)			// lokey
 								{
@@ -471,6 +471,9 @@ void CHighLife::sfz_import(const File& file)
 
 	// enter critical section
     set_suspended (0);
+
+	// the regions play as their samples come in
+	tool_decode_queued (file);
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
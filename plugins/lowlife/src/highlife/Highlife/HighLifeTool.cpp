@@ -38,6 +38,13 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 #include "Highlife.h"
 
+// the juce extended classes aren't built into the plugin, so the resampler is pulled on its own
+#if ! JUCE_BUILD_EXT_CLASSES
+BEGIN_JUCE_NAMESPACE
+#include "src/extended/audio/resampler/jucetice_Resampler.h"
+END_JUCE_NAMESPACE
+#endif
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 void CHighLife::tool_init_rtpar(RTPAR* pp,float const value)
 {
@@ -223,12 +230,17 @@ void CHighLife::tool_init_bank(void)
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 void CHighLife::tool_delete_wave(HIGHLIFE_ZONE* pz)
 {
-	// delete channels wavedata
-	for(int c=0;c<pz->num_channels && pz->ppwavedata;c++)
-		delete[] pz->ppwavedata[c];
+	// waves shared from the pool are freed by it, with their last reference
+	if(!sample_pool->release(pz->ppwavedata))
+	{
+		// delete channels wavedata
+		for(int c=0;c<pz->num_channels && pz->ppwavedata;c++)
+			delete[] pz->ppwavedata[c];
+
+		// delete channels
+		delete[] pz->ppwavedata;
+	}
 
-	// delete channels
-	delete[] pz->ppwavedata;
 	pz->ppwavedata=NULL;
 
 	// zero samples and zero channels
@@ -378,6 +390,44 @@ void CHighLife::tool_alloc_wave(HIGHLIFE_ZONE* pz,int const num_channels,int con
 	}
 }
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool CHighLife::tool_acquire_wave(HIGHLIFE_ZONE* pz,const String& key)
+{
+	int num_channels=0;
+	int num_samples=0;
+	int sample_rate=0;
+
+	// get a reference to the wave if any instance has loaded it already
+	float** ppwavedata=sample_pool->acquire(key,num_channels,num_samples,sample_rate);
+
+	if(ppwavedata==NULL)
+		return false;
+
+	tool_delete_wave(pz);
+
+	pz->ppwavedata=ppwavedata;
+	pz->num_channels=num_channels;
+	pz->num_samples=num_samples;
+	pz->sample_rate=sample_rate;
+
+	return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void CHighLife::tool_publish_wave(HIGHLIFE_ZONE* pz,const String& key)
+{
+	// hand the decoded wave over to the pool, so the next zones loading it can share it
+	if(pz->ppwavedata!=NULL && pz->num_samples>0)
+		pz->ppwavedata=sample_pool->publish(key,pz->ppwavedata,pz->num_channels,pz->num_samples,pz->sample_rate);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void CHighLife::tool_unshare_wave(HIGHLIFE_ZONE* pz)
+{
+	// the waves in the pool don't change, so edits get a wave of the zone's own
+	pz->ppwavedata=sample_pool->unshare(pz->ppwavedata,pz->num_channels,pz->num_samples);
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 void CHighLife::tool_load_sample (HIGHLIFE_ZONE* pz, const File& file)
 {
@@ -387,6 +437,43 @@ void CHighLife::tool_load_sample (HIGHLIFE_ZONE* pz, const File& file)
 	// format zone path
 	sprintf (pz->path, (const char*) file.getFullPathName ());
 
+	// waves converted to the host rate are shared by the zones of all the instances
+	int const host_rate=(int)getSampleRate();
+	String const key=CSamplePool::make_key(file,T("wave ")+String(host_rate));
+
+	bool const is_wav=file.getFileExtension ().compareIgnoreCase (T(".wav")) == 0;
+
+	if (is_wav && tool_acquire_wave (pz, key))
+	{
+		// only the sampler chunks are read again, their markers are then
+		// moved to the rate the shared wave was converted to
+		int const num_samples=pz->num_samples;
+		int const sample_rate=pz->sample_rate;
+
+		wav_load_info (pz, file);
+		tool_resample_markers (pz, num_samples, sample_rate);
+
+		pz->num_samples=num_samples;
+	}
+	else
+	{
+		tool_decode_sample (pz, file);
+
+		// convert to the host rate, so the voices only have to pitch
+		if(host_rate>0 && pz->num_samples>0 && pz->sample_rate!=host_rate)
+			tool_resample_zone(pz,host_rate);
+
+		tool_publish_wave (pz, key);
+	}
+
+	// analyze and set num ticks (for synchro)
+   if (pz->mp_num_ticks == 0) // only guess ticks if not already specified
+      pz->mp_num_ticks = tool_get_num_bars (pz->num_samples, pz->sample_rate) * 16;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void CHighLife::tool_decode_sample (HIGHLIFE_ZONE* pz, const File& file)
+{
 	// check file extension and open preferred format
 	if (file.getFileExtension ().compareIgnoreCase (T(".wav")) == 0)
 	{
@@ -394,6 +481,8 @@ void CHighLife::tool_load_sample (HIGHLIFE_ZONE* pz, const File& file)
 		wav_load (pz, file);
 	}
 #if 0
+	// these decode through global buffers and the same temp file, so they'd have
+	// to take a lock before running on the decoding threads of the pool
 	else if(file.getFileExtension ().compareIgnoreCase (T(".mp3")) == 0)
 	{
 		// mp3 file
@@ -410,10 +499,56 @@ void CHighLife::tool_load_sample (HIGHLIFE_ZONE* pz, const File& file)
 		raw_load (pz, file);
 	}
 #endif
+}
 
-	// analyze and set num ticks (for synchro)
-   if (pz->mp_num_ticks == 0) // only guess ticks if not already specified
-      pz->mp_num_ticks = tool_get_num_bars (pz->num_samples, pz->sample_rate) * 16;
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void CHighLife::tool_resample_zone (HIGHLIFE_ZONE* pz, int const target_rate)
+{
+	if(pz->ppwavedata==NULL || pz->num_samples<=0 || pz->sample_rate<=0 || target_rate<=0)
+		return;
+
+	// convert the wave, without the pads
+	HeapBlock <float*> psource(pz->num_channels);
+
+	for(int c=0;c<pz->num_channels;c++)
+		psource[c]=pz->ppwavedata[c]+WAVE_PAD;
+
+	AudioSampleBuffer source(psource,pz->num_channels,pz->num_samples);
+	AudioSampleBuffer dest(pz->num_channels,1);
+
+	int const num_samples=Resampler::resampleBuffer(source,pz->sample_rate,dest,target_rate,Resampler::bestSinc);
+
+	if(num_samples<=0)
+		return;
+
+	// swap in the converted wave
+	int const num_channels=pz->num_channels;
+
+	tool_delete_wave(pz);
+	tool_alloc_wave(pz,num_channels,num_samples);
+
+	for(int c=0;c<num_channels;c++)
+		memcpy(pz->ppwavedata[c]+WAVE_PAD,dest.getSampleData(c),num_samples*sizeof(float));
+
+	// and move the markers to the same place in the new wave
+	tool_resample_markers(pz,num_samples,target_rate);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void CHighLife::tool_resample_markers (HIGHLIFE_ZONE* pz, int const num_samples, int const target_rate)
+{
+	if(pz->sample_rate>0 && target_rate>0)
+	{
+		double const scale=double(target_rate)/double(pz->sample_rate);
+
+		pz->loop_start=jlimit(0,num_samples,roundDoubleToInt(pz->loop_start*scale));
+		pz->loop_end=jlimit(0,num_samples,roundDoubleToInt(pz->loop_end*scale));
+
+		for(int p=0;p<pz->num_cues;p++)
+			pz->cue_pos[p]=jlimit(0,num_samples,roundDoubleToInt(pz->cue_pos[p]*scale));
+	}
+
+	pz->sample_rate=target_rate;
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -536,30 +671,208 @@ void CHighLife::tool_program_import_dlg()
     {
         File file = myChooser.getResult ();
 
+        // libraries take a while, so they're imported on the loading thread of the pool
         if (file.existsAsFile ())
-        {
-	        if (file.getFileExtension ().compareIgnoreCase (T(".akp")) == 0)
-	        {
-		        akp_import(file);
-	        }
-	        else if(file.getFileExtension ().compareIgnoreCase (T(".sfz")) == 0)
-	        {
-		        sfz_import(file);
-	        }
-	        else if(file.getFileExtension ().compareIgnoreCase (T(".sf2")) == 0)
-	        {
-		        sf2_import (file);
-	        }
-	        else if(file.getFileExtension ().compareIgnoreCase (T(".gig")) == 0)
-	        {
-		        gig_import (file);
-	        }
-	        else if(file.getFileExtension ().compareIgnoreCase (T(".dls")) == 0)
-	        {
-		        dls_import (file);
-	        }
+            sample_pool->load_in_background (this, file);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void CHighLife::tool_program_import (const File& file)
+{
+    if (file.getFileExtension ().compareIgnoreCase (T(".akp")) == 0)
+    {
+        akp_import(file);
+    }
+    else if(file.getFileExtension ().compareIgnoreCase (T(".sfz")) == 0)
+    {
+        sfz_import(file);
+    }
+    else if(file.getFileExtension ().compareIgnoreCase (T(".sf2")) == 0)
+    {
+        sf2_import (file);
+    }
+    else if(file.getFileExtension ().compareIgnoreCase (T(".gig")) == 0)
+    {
+        gig_import (file);
+    }
+    else if(file.getFileExtension ().compareIgnoreCase (T(".dls")) == 0)
+    {
+        dls_import (file);
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void CHighLifeDecoder::sample_decoder_run()
+{
+	phl->tool_decode_region(this);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void CHighLife::tool_queue_sample (HIGHLIFE_ZONE* pz, const File& file)
+{
+	// format zone path
+	sprintf (pz->path, (const char*) file.getFullPathName ());
+
+	// the markers of a wav are read now, so the program can override them, the samples once it's imported
+	int sample_rate=0;
+
+	if (file.getFileExtension ().compareIgnoreCase (T(".wav")) == 0)
+	{
+		wav_load_info (pz, file);
+
+		sample_rate=pz->sample_rate;
+		pz->num_samples=0;
+	}
+
+	tool_queue_region (pz, NULL, 0, T("wave"), file, sample_rate);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void CHighLife::tool_queue_region (HIGHLIFE_ZONE* pz, CHighLifeLibrary* plibrary, int const region, const String& key, const File& file, int const sample_rate)
+{
+	for(int p=0;p<NUM_PROGRAMS;p++)
+	{
+		HIGHLIFE_PROGRAM* pprg=&highlife_program[p];
+
+		if(pz>=pprg->pzones && pz<pprg->pzones+pprg->num_zones)
+		{
+			CHighLifeDecoder* pd=new CHighLifeDecoder;
+			pd->phl=this;
+			pd->program=p;
+			pd->zone=int(pz-pprg->pzones);
+			pd->zone_path=pz->path;
+			pd->zone_name=pz->name;
+
+			// the waves are shared once converted to the host rate, so that's part of the key
+			pd->key=CSamplePool::make_key(file,key+T(" ")+String((int)getSampleRate()));
+			pd->file=file;
+			pd->plibrary=plibrary;
+			pd->region=region;
+			pd->sample_rate=sample_rate;
+
+			import_decoders.add(pd);
+			break;
+		}
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void CHighLife::tool_weigh_keys (float* pkey_weight)
+{
+	// weigh each key by how close it is to the keys played the most, and to middle c
+	for(int k=0;k<128;k++)
+	{
+		pkey_weight[k]=0.0f;
+
+		for(int j=0;j<128;j++)
+		{
+			int const plays=user_keyb_plays[j]+(j==0x3c);
+
+			if(plays>0)
+				pkey_weight[k]+=float(plays)/float(1+abs(j-k));
+		}
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+float CHighLife::tool_get_zone_priority (HIGHLIFE_ZONE* pz, float const* pkey_weight)
+{
+	// a zone is as wanted as the most wanted key it plays
+	int const lo_key=jlimit(0,127,pz->lo_input_range.midi_key);
+	int const hi_key=jlimit(lo_key,127,pz->hi_input_range.midi_key);
+
+	float priority=0.0f;
+
+	for(int k=lo_key;k<=hi_key;k++)
+		priority=jmax(priority,pkey_weight[k]);
+
+	return priority;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void CHighLife::tool_decode_queued (const File& file)
+{
+	float key_weight[128];
+	tool_weigh_keys(key_weight);
+
+	// so the zones around the keys being played sound first
+	for(int d=0;d<import_decoders.size();d++)
+	{
+		CHighLifeDecoder* pd=(CHighLifeDecoder*)import_decoders.getUnchecked(d);
+		HIGHLIFE_PROGRAM* pprg=&highlife_program[pd->program];
+
+		if(pd->zone<pprg->num_zones)
+			pd->priority=tool_get_zone_priority(&pprg->pzones[pd->zone],key_weight);
+	}
+
+	// the notes of a zone play as soon as its wave is in
+	sample_pool->decode_in_parallel (this, file, import_decoders);
+	import_decoders.clear();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void CHighLife::tool_decode_region (CHighLifeDecoder* pd)
+{
+	// decoded into a zone of its own, without stopping the audio
+	HIGHLIFE_ZONE wave;
+	tool_init_zone(&wave);
+
+	int source_rate=pd->sample_rate;
+
+	// waves can only be shared when the rate of the file is known, to move the markers
+	if(source_rate<=0 || !tool_acquire_wave(&wave,pd->key))
+	{
+		if(pd->plibrary!=NULL)
+			pd->plibrary->library_decode(this,&wave,pd->region);
+		else
+			tool_decode_sample(&wave,pd->file);
+
+		if(source_rate<=0)
+			source_rate=wave.sample_rate;
+
+		// convert to the host rate, so the voices only have to pitch
+		int const host_rate=(int)getSampleRate();
+
+		if(host_rate>0 && wave.num_samples>0 && wave.sample_rate!=host_rate)
+			tool_resample_zone(&wave,host_rate);
+
+		tool_publish_wave(&wave,pd->key);
+	}
+
+	bool installed=false;
+
+	crs_lock();
+
+	HIGHLIFE_PROGRAM* pprg=&highlife_program[pd->program];
+
+	if(wave.num_samples>0 && pd->zone<pprg->num_zones)
+	{
+		HIGHLIFE_ZONE* pz=&pprg->pzones[pd->zone];
+
+		// the zone may have been deleted or loaded again while its wave was decoding
+		if(pz->ppwavedata==NULL && pz->num_samples==0 && pd->zone_path==String(pz->path) && pd->zone_name==String(pz->name))
+		{
+			pz->ppwavedata=wave.ppwavedata;
+			pz->num_channels=wave.num_channels;
+
+			// the markers were imported at the rate of the file
+			pz->sample_rate=source_rate;
+			tool_resample_markers(pz,wave.num_samples,wave.sample_rate);
+			pz->num_samples=wave.num_samples;
+
+			// analyze and set num ticks (for synchro)
+			if(pz->mp_num_ticks==0)
+				pz->mp_num_ticks=tool_get_num_bars(pz->num_samples,pz->sample_rate)*16;
+
+			installed=true;
 		}
 	}
+
+	crs_unlock();
+
+	if(!installed)
+		tool_delete_wave(&wave);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
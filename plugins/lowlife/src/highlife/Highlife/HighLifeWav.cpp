@@ -46,9 +46,69 @@ struct WA24
 	char  byte_msb;
 };
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static void wav_load_chunks (HIGHLIFE_ZONE* pz, CRiffWave& rw)
+{
+	pz->loop_end=pz->num_samples;
+
+	// parse 'smpl' chunk
+	if(rw.has_smpl)
+	{
+		// set loop if any
+		if(rw.GetSample()->cSampleLoops>=1)
+		{
+			pz->loop_mode=1;
+			pz->loop_start=rw.GetLoop(0)->dwStart;
+			pz->loop_end=(rw.GetLoop(0)->dwEnd+1);
+		}
+
+		// set unity note
+		pz->midi_root_key=rw.GetSample()->dwMIDIUnityNote;
+	}
+
+	// parse 'inst' chunk
+	if(rw.has_inst)
+	{
+		pz->lo_input_range.midi_key=rw.GetInstrument()->LowNote;
+		pz->hi_input_range.midi_key=rw.GetInstrument()->HighNote;
+		pz->lo_input_range.midi_vel=rw.GetInstrument()->LowVelocity;
+		pz->hi_input_range.midi_vel=rw.GetInstrument()->HighVelocity;
+		pz->midi_root_key=rw.GetInstrument()->UnshiftedNote;
+		pz->midi_fine_tune=rw.GetInstrument()->FineTune;
+		pz->mp_gain=rw.GetInstrument()->Gain;
+	}
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 void CHighLife::wav_load (HIGHLIFE_ZONE* pz, const File& file)
 {
+	// decode the samples straight out of a memory-mapped file if possible
+	WavAudioFormat wav_format;
+	ScopedPointer <MemoryMappedAudioFormatReader> reader (wav_format.createMemoryMappedReader (file));
+
+	if(reader!=0 && reader->lengthInSamples>0)
+	{
+		tool_alloc_wave(pz,reader->numChannels,(int)reader->lengthInSamples);
+		pz->sample_rate=(int)reader->sampleRate;
+
+		HeapBlock <float*> pdest(pz->num_channels);
+
+		for(int ch=0;ch<pz->num_channels;ch++)
+			pdest[ch]=pz->ppwavedata[ch]+WAVE_PAD;
+
+		reader->readFloat(pdest,pz->num_channels,0,pz->num_samples,false);
+
+		// the sampler chunks still come from the riff parser, which can skip the data now
+		CRiffWave rw;
+
+		pz->loop_end=pz->num_samples;
+
+		if(rw.ReadWave((const char*) file.getFullPathName (),false))
+			wav_load_chunks(pz,rw);
+
+		return;
+	}
+
 	CRiffWave rw;
 
 	if(rw.ReadWave((const char*) file.getFullPathName ()))
@@ -61,34 +121,9 @@ void CHighLife::wav_load (HIGHLIFE_ZONE* pz, const File& file)
 			// process 'fmt' chunk
 			tool_alloc_wave(pz,rw.GetFormat()->wChannels,rw.GetDataLength()/(rw.GetFormat()->wChannels*(nbits/8)));
 			pz->sample_rate=rw.GetFormat()->dwSamplesPerSec;
-			pz->loop_end=pz->num_samples;
-			
-			// parse 'smpl' chunk
-			if(rw.has_smpl)
-			{
-				// set loop if any
-				if(rw.GetSample()->cSampleLoops>=1)
-				{
-					pz->loop_mode=1;
-					pz->loop_start=rw.GetLoop(0)->dwStart;
-					pz->loop_end=(rw.GetLoop(0)->dwEnd+1);
-				}
-
-				// set unity note
-				pz->midi_root_key=rw.GetSample()->dwMIDIUnityNote;
-			}
 
-			// parse 'inst' chunk
-			if(rw.has_inst)
-			{
-				pz->lo_input_range.midi_key=rw.GetInstrument()->LowNote;
-				pz->hi_input_range.midi_key=rw.GetInstrument()->HighNote;
-				pz->lo_input_range.midi_vel=rw.GetInstrument()->LowVelocity;
-				pz->hi_input_range.midi_vel=rw.GetInstrument()->HighVelocity;			
-				pz->midi_root_key=rw.GetInstrument()->UnshiftedNote;
-				pz->midi_fine_tune=rw.GetInstrument()->FineTune;
-				pz->mp_gain=rw.GetInstrument()->Gain;
-			}
+			// parse 'smpl' and 'inst' chunks
+			wav_load_chunks(pz,rw);
 
 			// process data chunk
 			unsigned char*	ps08bits=(unsigned char*)rw.GetData();
@@ -133,6 +168,40 @@ void CHighLife::wav_load (HIGHLIFE_ZONE* pz, const File& file)
 	}
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void CHighLife::wav_load_info (HIGHLIFE_ZONE* pz, const File& file)
+{
+	// reads what wav_load sets apart from the wavedata, for a wave shared from the pool. the sizes come
+	// from the same reader wav_load decodes with, the riff parser reads its chunk ids as longs and so
+	// only gets them right where those are 32 bits
+	WavAudioFormat wav_format;
+	ScopedPointer <MemoryMappedAudioFormatReader> reader (wav_format.createMemoryMappedReader (file));
+
+	CRiffWave rw;
+
+	if(reader!=0 && reader->lengthInSamples>0)
+	{
+		pz->num_samples=(int)reader->lengthInSamples;
+		pz->sample_rate=(int)reader->sampleRate;
+		pz->loop_end=pz->num_samples;
+
+		if(rw.ReadWave((const char*) file.getFullPathName (),false))
+			wav_load_chunks(pz,rw);
+	}
+	else if(rw.ReadWave((const char*) file.getFullPathName (),false))
+	{
+		int const frame_size=rw.GetFormat()->wChannels*(rw.GetFormat()->wBitsPerSample/8);
+
+		if(frame_size>0)
+			pz->num_samples=rw.GetDataLength()/frame_size;
+
+		pz->sample_rate=rw.GetFormat()->dwSamplesPerSec;
+
+		// parse 'smpl' and 'inst' chunks
+		wav_load_chunks(pz,rw);
+	}
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 void CHighLife::wav_export()
 {
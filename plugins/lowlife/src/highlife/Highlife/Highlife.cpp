@@ -42,6 +42,9 @@
 //==============================================================================
 CHighLife::CHighLife ()
 {
+	// share the waves of the instances already loaded
+	sample_pool=CSamplePool::attach();
+
 	// call all sounds off
 	plug_all_sounds_off();
 
@@ -74,6 +77,9 @@ CHighLife::CHighLife ()
 	user_delta_y_accum=0;
 	user_master_volume=1.0f;
 
+	for(int k=0;k<128;k++)
+		user_keyb_plays[k]=0;
+
 	// reset sample editor
 	user_sed_manual=0;
 	user_sed_zone=0;
@@ -120,6 +126,9 @@ CHighLife::CHighLife ()
 
 CHighLife::~CHighLife ()
 {
+	// stop importing in the background
+	sample_pool->cancel_loads(this);
+
 	// reset memstream out allocating object
 	ms_out.Reset();
 
@@ -128,6 +137,9 @@ CHighLife::~CHighLife ()
 
 	// reset clipboard
 	sed_clipboard_reset();
+
+	// all the zones are free now
+	CSamplePool::detach();
 }
 
 //==============================================================================
@@ -341,6 +353,9 @@ void CHighLife::processBlock (AudioSampleBuffer& output, MidiBuffer& midiMessage
 //==============================================================================
 void CHighLife::getStateInformation (MemoryBlock& destData)
 {
+	// let a background import finish first
+	sample_pool->wait_for_loads(this);
+
 	// clear mem stream allocator
 	ms_out.Reset();
 
@@ -363,6 +378,9 @@ void CHighLife::getStateInformation (MemoryBlock& destData)
 
 void CHighLife::setStateInformation (const void* data, int sizeInBytes)
 {	
+	// the programs are about to be replaced, so drop the imports that are still queued
+	sample_pool->cancel_loads(this);
+
 	// mem stream in
 	CMemStreamIn ms_in (data, sizeInBytes);
 
@@ -380,6 +398,12 @@ void CHighLife::setStateInformation (const void* data, int sizeInBytes)
 	}
 }
 
+//==============================================================================
+void CHighLife::sample_loader_run (const File& file)
+{
+	tool_program_import (file);
+}
+
 //==============================================================================
 MidiKeyboardState* CHighLife::getKeyboardstate ()
 {
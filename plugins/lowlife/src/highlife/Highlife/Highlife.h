@@ -59,13 +59,52 @@
 
 // highlife includes
 #include "HighLifeRiffWave.h"
+#include "HighLifeSamplePool.h"
 #include "HighLifeVoice.h"
 #include "HighLifeEditor.h"
 #include "HighLifeFx.h"
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+class CHighLife;
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// An open library file that the waves of an import are decoded from, kept open by the decoders of its zones
+class CHighLifeLibrary : public ReferenceCountedObject
+{
+public:
+	// decodes a region of the library into the wave of a zone, called on the decoding threads
+	virtual void library_decode(CHighLife* phl,HIGHLIFE_ZONE* pz,int const region)=0;
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Decodes the wave of a zone of an imported program, once the program has been imported
+class CHighLifeDecoder : public CSampleDecoder
+{
+public:
+	void sample_decoder_run();
+
+	CHighLife*	phl;
+
+	// the zone the wave goes to, and what it was called when it was imported
+	int			program;
+	int			zone;
+	String		zone_path;
+	String		zone_name;
+
+	// where the wave comes from: a region of a library, or a sample file
+	String		key;
+	File		file;
+	ReferenceCountedObjectPtr <CHighLifeLibrary> plibrary;
+	int			region;
+
+	// rate of the wave in the file, 0 when it's only known once decoded
+	int			sample_rate;
+};
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 class CHighLife : public AudioProcessor,
-                  public ChangeBroadcaster
+                  public ChangeBroadcaster,
+                  public CSampleLoader
 {
 public:
 
@@ -105,6 +144,8 @@ public:
     AudioProcessorEditor* createEditor();
     MidiKeyboardState* getKeyboardstate ();
 
+    void sample_loader_run (const File& file);
+
     juce_UseDebuggingNewOperator
 
 public:
@@ -133,12 +174,25 @@ public:
 	void tool_init_program(HIGHLIFE_PROGRAM* pprg);
 	void tool_init_bank(void);
 	void tool_delete_wave(HIGHLIFE_ZONE* pz);
+	bool tool_acquire_wave(HIGHLIFE_ZONE* pz,const String& key);
+	void tool_publish_wave(HIGHLIFE_ZONE* pz,const String& key);
+	void tool_unshare_wave(HIGHLIFE_ZONE* pz);
 	void tool_add_zone(HIGHLIFE_PROGRAM* pprg);
 	void tool_delete_zone(HIGHLIFE_PROGRAM* pprg,int const zone_index);
 	void tool_delete_all_zones(HIGHLIFE_PROGRAM* pprg);
 	void tool_load_sample(HIGHLIFE_ZONE* pz,const File& file);
+	void tool_decode_sample(HIGHLIFE_ZONE* pz,const File& file);
+	void tool_resample_zone(HIGHLIFE_ZONE* pz,int const target_rate);
+	void tool_resample_markers(HIGHLIFE_ZONE* pz,int const num_samples,int const target_rate);
 	void tool_sample_import_dlg();
 	void tool_program_import_dlg();
+	void tool_program_import(const File& file);
+	void tool_queue_sample(HIGHLIFE_ZONE* pz,const File& file);
+	void tool_queue_region(HIGHLIFE_ZONE* pz,CHighLifeLibrary* plibrary,int const region,const String& key,const File& file,int const sample_rate);
+	void tool_weigh_keys(float* pkey_weight);
+	float tool_get_zone_priority(HIGHLIFE_ZONE* pz,float const* pkey_weight);
+	void tool_decode_queued(const File& file);
+	void tool_decode_region(CHighLifeDecoder* pd);
 	void tool_sample_browse_dlg(HIGHLIFE_ZONE* pz);
 	int	 tool_get_num_bars(int const num_samples,int const sample_rate);
 	void tool_init_dsp_buffer(float* pbuf,int const numsamples,int dfix);
@@ -160,6 +214,7 @@ public:
 public:
     void mp3_load (HIGHLIFE_ZONE* pz, const File& file);
 	void wav_load (HIGHLIFE_ZONE* pz, const File& file);
+	void wav_load_info (HIGHLIFE_ZONE* pz, const File& file);
 	void ogg_load (HIGHLIFE_ZONE* pz, const File& file);
 	void raw_load (HIGHLIFE_ZONE* pz, const File& file);
 
@@ -203,10 +258,17 @@ public:
 	CriticalSection critical_section;
 	int     suspended_state;
 
+	// waves shared with the other instances
+	CSamplePool* sample_pool;
+
+	// zones of the import being loaded whose waves are decoded once it's done
+	OwnedArray <CSampleDecoder> import_decoders;
+
 	// user gui vars
 	int		user_gui_page;
 	int		user_last_key;
 	int		user_keyb_sta[128];
+	int		user_keyb_plays[128];
 	int		user_pressed;
 	int		user_program;
 	float	user_master_volume;
@@ -264,6 +326,9 @@ public:
 	CFxChorus		fx_cho;
 	CFxDelay		fx_del;
 	CFxReverb		fx_rev;
+	CFxSend			fx_chr_send;
+	CFxSend			fx_del_send;
+	CFxSend			fx_rev_send;
 	CFxPhaser		fx_phs_l;
 	CFxPhaser		fx_phs_r;
 	CFxCompressor	fx_cmp_l;
@@ -10,3 +10,8 @@
 
 #include "juce_AppConfig.h"
 #include "../../../../juce_amalgamated.cpp"
+
+// the highlife sample import converts the waves with the jucetice resampler
+#if ! JUCE_BUILD_EXT_CLASSES
+ #include "../../../juce/src/extended/audio/resampler/jucetice_Resampler.cpp"
+#endif
@@ -0,0 +1,76 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2009 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU General Public License, as published by the Free Software Foundation;
+ either version 2 of the License, or (at your option) any later version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+
+#include "TestsHeader.h"
+
+//==============================================================================
+/*
+    Counts the heap allocations of the whole test program.
+
+    malloc, calloc and realloc are replaced by versions that count the call
+    and pass it on to the c library, which also catches operator new and the
+    juce HeapBlock. This relies on glibc exporting its own entry points.
+*/
+#if defined (__GLIBC__)
+
+static volatile int numAllocations = 0;
+
+extern "C"
+{
+    void* __libc_malloc (size_t size);
+    void* __libc_calloc (size_t num, size_t size);
+    void* __libc_realloc (void* block, size_t size);
+
+    void* malloc (size_t size)
+    {
+        ++numAllocations;
+        return __libc_malloc (size);
+    }
+
+    void* calloc (size_t num, size_t size)
+    {
+        ++numAllocations;
+        return __libc_calloc (num, size);
+    }
+
+    void* realloc (void* block, size_t size)
+    {
+        ++numAllocations;
+        return __libc_realloc (block, size);
+    }
+}
+
+bool canCountAllocations()      { return true; }
+int getNumAllocations()         { return numAllocations; }
+
+#else
+
+bool canCountAllocations()      { return false; }
+int getNumAllocations()         { return 0; }
+
+#endif
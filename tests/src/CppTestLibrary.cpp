@@ -0,0 +1,54 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2009 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU General Public License, as published by the Free Software Foundation;
+ either version 2 of the License, or (at your option) any later version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+//==============================================================================
+/*
+    The bundled cpptest, built as a single unit.
+
+    Its sources expect the standard headers to be already there, so they
+    are included before it.
+*/
+#include <list>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <numeric>
+#include <cstring>
+#include <cstdio>
+#include <sys/time.h>
+
+#include "collectoroutput.cpp"
+#include "compileroutput.cpp"
+#include "htmloutput.cpp"
+#include "missing.cpp"
+#include "source.cpp"
+#include "suite.cpp"
+#include "textoutput.cpp"
+#include "time.cpp"
+#include "utils.cpp"
@@ -0,0 +1,44 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2009 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU General Public License, as published by the Free Software Foundation;
+ either version 2 of the License, or (at your option) any later version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+
+//==============================================================================
+/*
+    The whole of juce, built for the HighLife tests.
+
+    HighLife is an AudioProcessor, so it needs more than the core part the
+    other tests link against. The plugin's own config comes first, like in
+    its juce_LibrarySource.cpp, and the makefile turns off the audio device
+    libraries that aren't needed to run it.
+*/
+#include "juce_AppConfig.h"
+#include "juce_amalgamated_template.cpp"
+
+// the highlife sample import converts the waves with the jucetice resampler
+#if ! JUCE_BUILD_EXT_CLASSES
+ #include "extended/audio/resampler/jucetice_Resampler.cpp"
+#endif
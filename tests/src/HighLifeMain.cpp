@@ -0,0 +1,96 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2009 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU General Public License, as published by the Free Software Foundation;
+ either version 2 of the License, or (at your option) any later version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+
+#include "TestsHeader.h"
+
+#include <fstream>
+
+//==============================================================================
+// the suites that need a whole HighLife instance, and so the whole of juce
+Test::Suite* createHighLifeImportTests();
+Test::Suite* createHighLifeImportBenchmarks();
+
+
+//==============================================================================
+static void printUsage()
+{
+    printf ("usage: highlife [--benchmarks] [--html file]\n");
+    printf ("  runs the HighLife unit tests, or the benchmarks, and returns non zero on failures\n");
+}
+
+int main (int argc, char* argv[])
+{
+    bool runBenchmarks = false;
+    String htmlFile;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const String arg (argv [i]);
+
+        if (arg == T("--benchmarks"))
+            runBenchmarks = true;
+        else if (arg == T("--html") && i + 1 < argc)
+            htmlFile = argv [++i];
+        else
+        {
+            printUsage();
+            return 2;
+        }
+    }
+
+    // HighLife broadcasts its changes, which needs the message manager. It
+    // runs without a display too
+    initialiseJuce_GUI();
+
+    Test::Suite suites;
+
+    if (runBenchmarks)
+        suites.add (createHighLifeImportBenchmarks());
+    else
+        suites.add (createHighLifeImportTests());
+
+    bool passed;
+
+    if (htmlFile.isNotEmpty())
+    {
+        Test::HtmlOutput output;
+        passed = suites.run (output);
+
+        std::ofstream stream ((const char*) htmlFile);
+        output.generate (stream, true, runBenchmarks ? "highlife benchmarks" : "highlife tests");
+    }
+    else
+    {
+        Test::TextOutput output (Test::TextOutput::Verbose);
+        passed = suites.run (output);
+    }
+
+    shutdownJuce_GUI();
+
+    return passed ? 0 : 1;
+}
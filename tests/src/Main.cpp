@@ -0,0 +1,148 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2009 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU General Public License, as published by the Free Software Foundation;
+ either version 2 of the License, or (at your option) any later version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+#include "TestsHeader.h"
+
+#include <fstream>
+
+//==============================================================================
+// every suite file exposes a function creating its tests, and some of them
+// a second one creating their benchmarks
+Test::Suite* createLockFreeQueueTests();
+Test::Suite* createLockFreeQueueBenchmarks();
+Test::Suite* createPropertySetTests();
+Test::Suite* createPropertySetBenchmarks();
+Test::Suite* createRealFFTTests();
+Test::Suite* createRealFFTBenchmarks();
+Test::Suite* createOversamplerTests();
+Test::Suite* createOversamplerBenchmarks();
+Test::Suite* createVectorOpsTests();
+Test::Suite* createVectorOpsBenchmarks();
+Test::Suite* createMidiOutputTests();
+Test::Suite* createMidiOutputBenchmarks();
+Test::Suite* createDistressorTests();
+Test::Suite* createGateTests();
+Test::Suite* createGateBenchmarks();
+Test::Suite* createOverdoseTests();
+Test::Suite* createOverdoseBenchmarks();
+Test::Suite* createOppressorTests();
+Test::Suite* createOppressorBenchmarks();
+Test::Suite* createDetunerTests();
+Test::Suite* createDetunerBenchmarks();
+Test::Suite* createHighLifeFxTests();
+Test::Suite* createHighLifeFxBenchmarks();
+Test::Suite* createHighLifeSamplePoolTests();
+Test::Suite* createXmlPullParserTests();
+Test::Suite* createXmlPullParserBenchmarks();
+Test::Suite* createRealtimePolicyTests();
+
+
+//==============================================================================
+static void printUsage()
+{
+    printf ("usage: tests [--benchmarks] [--html file]\n");
+    printf ("  runs the unit tests, or the benchmarks, and returns non zero on failures\n");
+}
+
+int main (int argc, char* argv[])
+{
+    bool runBenchmarks = false;
+    String htmlFile;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const String arg (argv [i]);
+
+        if (arg == T("--benchmarks"))
+            runBenchmarks = true;
+        else if (arg == T("--html") && i + 1 < argc)
+            htmlFile = argv [++i];
+        else
+        {
+            printUsage();
+            return 2;
+        }
+    }
+
+    initialiseJuce_NonGUI();
+
+    Test::Suite suites;
+
+    if (runBenchmarks)
+    {
+        suites.add (createLockFreeQueueBenchmarks());
+        suites.add (createPropertySetBenchmarks());
+        suites.add (createRealFFTBenchmarks());
+        suites.add (createOversamplerBenchmarks());
+        suites.add (createVectorOpsBenchmarks());
+        suites.add (createMidiOutputBenchmarks());
+        suites.add (createGateBenchmarks());
+        suites.add (createOverdoseBenchmarks());
+        suites.add (createOppressorBenchmarks());
+        suites.add (createDetunerBenchmarks());
+        suites.add (createHighLifeFxBenchmarks());
+        suites.add (createXmlPullParserBenchmarks());
+    }
+    else
+    {
+        suites.add (createLockFreeQueueTests());
+        suites.add (createPropertySetTests());
+        suites.add (createRealFFTTests());
+        suites.add (createOversamplerTests());
+        suites.add (createVectorOpsTests());
+        suites.add (createMidiOutputTests());
+        suites.add (createDistressorTests());
+        suites.add (createGateTests());
+        suites.add (createOverdoseTests());
+        suites.add (createOppressorTests());
+        suites.add (createDetunerTests());
+        suites.add (createHighLifeFxTests());
+        suites.add (createHighLifeSamplePoolTests());
+        suites.add (createXmlPullParserTests());
+        suites.add (createRealtimePolicyTests());
+    }
+
+    bool passed;
+
+    if (htmlFile.isNotEmpty())
+    {
+        Test::HtmlOutput output;
+        passed = suites.run (output);
+
+        std::ofstream stream ((const char*) htmlFile);
+        output.generate (stream, true, runBenchmarks ? "benchmarks" : "tests");
+    }
+    else
+    {
+        Test::TextOutput output (Test::TextOutput::Verbose);
+        passed = suites.run (output);
+    }
+
+    shutdownJuce_NonGUI();
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,71 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2009 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU General Public License, as published by the Free Software Foundation;
+ either version 2 of the License, or (at your option) any later version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+#ifndef __JUCETICE_TESTSHEADER_HEADER__
+#define __JUCETICE_TESTSHEADER_HEADER__
+
+//==============================================================================
+/*
+    Common header of the unit tests and benchmarks.
+
+    The tests link against the core part of juce only (see JuceCoreLibrary.cpp),
+    every suite compiles the rest of what it needs straight from the sources.
+    The HighLife ones run whole instances, so they're a program of their own
+    built with all of juce (see HighLifeLibrary.cpp).
+*/
+#include "juce.h"
+#include "cpptest.h"
+
+#include <stdio.h>
+
+
+//==============================================================================
+/** Prints a line of benchmark results, so they line up in the output */
+inline void printBenchmarkResult (const char* name, const double seconds, const double items, const char* itemName)
+{
+    printf ("\n  %-48s %10.3f ms %14.1f %s/s\n", name, seconds * 1000.0, items / jmax (1.0e-9, seconds), itemName);
+    fflush (stdout);
+}
+
+/** Returns a high resolution time stamp in seconds */
+inline double getBenchmarkTime()
+{
+    return Time::getMillisecondCounterHiRes() * 0.001;
+}
+
+//==============================================================================
+/** Returns false if the allocations can't be counted on this platform */
+bool canCountAllocations();
+
+/** Returns the number of heap allocations made so far, by any thread
+
+    Compare two readings around the code that must not allocate.
+*/
+int getNumAllocations();
+
+
+#endif
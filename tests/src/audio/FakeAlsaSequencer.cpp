@@ -0,0 +1,182 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2009 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU General Public License, as published by the Free Software Foundation;
+ either version 2 of the License, or (at your option) any later version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+
+#include "../TestsHeader.h"
+#include "FakeAlsaSequencer.h"
+
+#include <time.h>
+
+
+//==============================================================================
+struct _snd_seq { int unused; };
+struct _snd_midi_event { int unused; };
+struct _snd_seq_queue_status { snd_seq_real_time_t time; };
+
+namespace FakeAlsaSequencerState
+{
+    static _snd_seq sequencer;
+    static _snd_midi_event parser;
+    static double queueStart = 0.0;
+
+    static CriticalSection eventsLock;
+    static Array <FakeSequencerEvent> events;
+}
+
+using namespace FakeAlsaSequencerState;
+
+double getFakeSequencerClock()
+{
+    timespec t;
+    clock_gettime (CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1.0e-9;
+}
+
+double getFakeSequencerQueueStart()
+{
+    return queueStart;
+}
+
+int getNumFakeSequencerEvents()
+{
+    const ScopedLock sl (eventsLock);
+    return events.size();
+}
+
+const FakeSequencerEvent getFakeSequencerEvent (const int index)
+{
+    const ScopedLock sl (eventsLock);
+    return events.getReference (index);
+}
+
+void clearFakeSequencerEvents()
+{
+    const ScopedLock sl (eventsLock);
+    events.clear();
+}
+
+
+//==============================================================================
+extern "C"
+{
+
+int snd_seq_open (snd_seq_t** seq, const char*, int, int)               { *seq = &sequencer; return 0; }
+int snd_seq_close (snd_seq_t*)                                          { return 0; }
+int snd_seq_set_client_name (snd_seq_t*, const char*)                   { return 0; }
+int snd_seq_create_simple_port (snd_seq_t*, const char*, unsigned int, unsigned int) { return 0; }
+int snd_seq_connect_from (snd_seq_t*, int, int, int)                    { return 0; }
+int snd_seq_connect_to (snd_seq_t*, int, int, int)                      { return 0; }
+
+// there are no other clients to list
+int snd_seq_system_info_malloc (snd_seq_system_info_t**)                { return -1; }
+void snd_seq_system_info_free (snd_seq_system_info_t*)                  {}
+int snd_seq_system_info (snd_seq_t*, snd_seq_system_info_t*)            { return -1; }
+int snd_seq_system_info_get_cur_clients (const snd_seq_system_info_t*)  { return 0; }
+int snd_seq_client_info_malloc (snd_seq_client_info_t**)                { return -1; }
+void snd_seq_client_info_free (snd_seq_client_info_t*)                  {}
+int snd_seq_query_next_client (snd_seq_t*, snd_seq_client_info_t*)     { return -1; }
+int snd_seq_client_info_get_num_ports (const snd_seq_client_info_t*)    { return 0; }
+int snd_seq_client_info_get_client (const snd_seq_client_info_t*)       { return 0; }
+const char* snd_seq_client_info_get_name (snd_seq_client_info_t*)       { return ""; }
+int snd_seq_port_info_malloc (snd_seq_port_info_t**)                    { return -1; }
+void snd_seq_port_info_free (snd_seq_port_info_t*)                      {}
+void snd_seq_port_info_set_client (snd_seq_port_info_t*, int)           {}
+void snd_seq_port_info_set_port (snd_seq_port_info_t*, int)             {}
+int snd_seq_query_next_port (snd_seq_t*, snd_seq_port_info_t*)         { return -1; }
+unsigned int snd_seq_port_info_get_capability (const snd_seq_port_info_t*) { return 0; }
+int snd_seq_port_info_get_port (const snd_seq_port_info_t*)             { return 0; }
+
+int snd_seq_alloc_named_queue (snd_seq_t*, const char*)                 { return 1; }
+int snd_seq_free_queue (snd_seq_t*, int)                                { return 0; }
+
+int snd_seq_control_queue (snd_seq_t*, int, int type, int, snd_seq_event_t*)
+{
+    if (type == SND_SEQ_EVENT_START)
+        queueStart = getFakeSequencerClock();
+
+    return 0;
+}
+
+int snd_seq_queue_status_malloc (snd_seq_queue_status_t** status)      { *status = new _snd_seq_queue_status(); return 0; }
+void snd_seq_queue_status_free (snd_seq_queue_status_t* status)        { delete status; }
+
+int snd_seq_get_queue_status (snd_seq_t*, int, snd_seq_queue_status_t* status)
+{
+    // a syscall's worth of delay on either side of the reading
+    const timespec syscall = { 0, 20000 };
+    nanosleep (&syscall, 0);
+
+    const double t = getFakeSequencerClock() - queueStart;
+    status->time.tv_sec = (unsigned int) t;
+    status->time.tv_nsec = (unsigned int) ((t - (unsigned int) t) * 1.0e9);
+
+    nanosleep (&syscall, 0);
+    return 0;
+}
+
+const snd_seq_real_time_t* snd_seq_queue_status_get_real_time (const snd_seq_queue_status_t* status)
+{
+    return &status->time;
+}
+
+int snd_seq_event_output (snd_seq_t*, snd_seq_event_t* ev)
+{
+    FakeSequencerEvent e;
+    memcpy (e.data, ev->data, sizeof (e.data));
+    e.isDirect = (ev->queue == SND_SEQ_QUEUE_DIRECT);
+    e.queueTime = ev->time.time.tv_sec + ev->time.time.tv_nsec * 1.0e-9;
+    e.handedOverAt = getFakeSequencerClock();
+
+    const ScopedLock sl (eventsLock);
+    events.add (e);
+    return 0;
+}
+
+int snd_seq_drain_output (snd_seq_t*)                                   { return 0; }
+int snd_seq_event_input (snd_seq_t*, snd_seq_event_t**)                 { return -1; }
+int snd_seq_event_input_pending (snd_seq_t*, int)                       { return 0; }
+int snd_seq_free_event (snd_seq_event_t*)                               { return 0; }
+int snd_seq_nonblock (snd_seq_t*, int)                                  { return 0; }
+int snd_seq_poll_descriptors_count (snd_seq_t*, short)                  { return 0; }
+int snd_seq_poll_descriptors (snd_seq_t*, struct pollfd*, unsigned int, short) { return 0; }
+
+// the encoder only has to carry the raw bytes through
+int snd_midi_event_new (size_t, snd_midi_event_t** p)                   { *p = &parser; return 0; }
+void snd_midi_event_free (snd_midi_event_t*)                            {}
+void snd_midi_event_reset_encode (snd_midi_event_t*)                    {}
+void snd_midi_event_reset_decode (snd_midi_event_t*)                    {}
+long snd_midi_event_decode (snd_midi_event_t*, unsigned char*, long, const snd_seq_event_t*) { return 0; }
+
+long snd_midi_event_encode (snd_midi_event_t*, const unsigned char* buf, long count, snd_seq_event_t* ev)
+{
+    for (long i = 0; i < count && i < (long) sizeof (ev->data); ++i)
+        ev->data [i] = buf [i];
+
+    return count;
+}
+
+}
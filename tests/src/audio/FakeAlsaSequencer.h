@@ -0,0 +1,159 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2009 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU General Public License, as published by the Free Software Foundation;
+ either version 2 of the License, or (at your option) any later version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+
+#ifndef __JUCETICE_FAKEALSASEQUENCER_HEADER__
+#define __JUCETICE_FAKEALSASEQUENCER_HEADER__
+
+//==============================================================================
+/*
+    A stand-in for the part of the alsa-lib sequencer api that juce_linux_Midi.cpp
+    uses, so the midi output can be tested without a sound card or the sequencer
+    kernel module.
+
+    Include it instead of <alsa/asoundlib.h>. Nothing is played: every event the
+    output hands over is recorded with the queue time it was scheduled at, and
+    the queue clock runs on CLOCK_MONOTONIC from the moment it is started.
+*/
+#include <string.h>
+#include <poll.h>
+
+extern "C"
+{
+    typedef struct _snd_seq snd_seq_t;
+    typedef struct _snd_midi_event snd_midi_event_t;
+    typedef struct _snd_seq_system_info snd_seq_system_info_t;
+    typedef struct _snd_seq_client_info snd_seq_client_info_t;
+    typedef struct _snd_seq_port_info snd_seq_port_info_t;
+    typedef struct _snd_seq_queue_status snd_seq_queue_status_t;
+
+    typedef struct snd_seq_real_time { unsigned int tv_sec, tv_nsec; } snd_seq_real_time_t;
+    typedef struct snd_seq_addr { unsigned char client, port; } snd_seq_addr_t;
+
+    typedef struct snd_seq_event
+    {
+        unsigned char type, flags, tag, queue;
+        union { unsigned int tick; snd_seq_real_time_t time; } time;
+        snd_seq_addr_t source, dest;
+        unsigned char data [12];
+    } snd_seq_event_t;
+
+    #define SND_SEQ_OPEN_OUTPUT             1
+    #define SND_SEQ_OPEN_INPUT              2
+    #define SND_SEQ_PORT_CAP_READ           (1 << 0)
+    #define SND_SEQ_PORT_CAP_WRITE          (1 << 1)
+    #define SND_SEQ_PORT_CAP_SUBS_READ      (1 << 5)
+    #define SND_SEQ_PORT_CAP_SUBS_WRITE     (1 << 6)
+    #define SND_SEQ_PORT_TYPE_MIDI_GENERIC  (1 << 1)
+    #define SND_SEQ_PORT_TYPE_APPLICATION   (1 << 20)
+    #define SND_SEQ_QUEUE_DIRECT            253
+    #define SND_SEQ_ADDRESS_SUBSCRIBERS     254
+    #define SND_SEQ_TIME_STAMP_REAL         (1 << 0)
+    #define SND_SEQ_EVENT_START             30
+    #define SND_SEQ_EVENT_STOP              32
+
+    #define snd_seq_ev_clear(ev)            memset (ev, 0, sizeof (snd_seq_event_t))
+    #define snd_seq_ev_set_source(ev, p)    ((ev)->source.port = (p))
+    #define snd_seq_ev_set_subs(ev)         ((ev)->dest.client = SND_SEQ_ADDRESS_SUBSCRIBERS, (ev)->dest.port = 253)
+    #define snd_seq_ev_set_direct(ev)       ((ev)->queue = SND_SEQ_QUEUE_DIRECT)
+    #define snd_seq_ev_schedule_real(ev, q, relative, rtime) \
+                                            ((ev)->flags |= SND_SEQ_TIME_STAMP_REAL, (ev)->time.time = *(rtime), (ev)->queue = (q))
+    #define snd_seq_start_queue(seq, q, ev) snd_seq_control_queue (seq, q, SND_SEQ_EVENT_START, 0, ev)
+    #define snd_seq_stop_queue(seq, q, ev)  snd_seq_control_queue (seq, q, SND_SEQ_EVENT_STOP, 0, ev)
+
+    int snd_seq_open (snd_seq_t**, const char*, int, int);
+    int snd_seq_close (snd_seq_t*);
+    int snd_seq_set_client_name (snd_seq_t*, const char*);
+    int snd_seq_create_simple_port (snd_seq_t*, const char*, unsigned int, unsigned int);
+    int snd_seq_connect_from (snd_seq_t*, int, int, int);
+    int snd_seq_connect_to (snd_seq_t*, int, int, int);
+    int snd_seq_system_info_malloc (snd_seq_system_info_t**);
+    void snd_seq_system_info_free (snd_seq_system_info_t*);
+    int snd_seq_system_info (snd_seq_t*, snd_seq_system_info_t*);
+    int snd_seq_system_info_get_cur_clients (const snd_seq_system_info_t*);
+    int snd_seq_client_info_malloc (snd_seq_client_info_t**);
+    void snd_seq_client_info_free (snd_seq_client_info_t*);
+    int snd_seq_query_next_client (snd_seq_t*, snd_seq_client_info_t*);
+    int snd_seq_client_info_get_num_ports (const snd_seq_client_info_t*);
+    int snd_seq_client_info_get_client (const snd_seq_client_info_t*);
+    const char* snd_seq_client_info_get_name (snd_seq_client_info_t*);
+    int snd_seq_port_info_malloc (snd_seq_port_info_t**);
+    void snd_seq_port_info_free (snd_seq_port_info_t*);
+    void snd_seq_port_info_set_client (snd_seq_port_info_t*, int);
+    void snd_seq_port_info_set_port (snd_seq_port_info_t*, int);
+    int snd_seq_query_next_port (snd_seq_t*, snd_seq_port_info_t*);
+    unsigned int snd_seq_port_info_get_capability (const snd_seq_port_info_t*);
+    int snd_seq_port_info_get_port (const snd_seq_port_info_t*);
+    int snd_seq_alloc_named_queue (snd_seq_t*, const char*);
+    int snd_seq_free_queue (snd_seq_t*, int);
+    int snd_seq_control_queue (snd_seq_t*, int, int, int, snd_seq_event_t*);
+    int snd_seq_queue_status_malloc (snd_seq_queue_status_t**);
+    void snd_seq_queue_status_free (snd_seq_queue_status_t*);
+    int snd_seq_get_queue_status (snd_seq_t*, int, snd_seq_queue_status_t*);
+    const snd_seq_real_time_t* snd_seq_queue_status_get_real_time (const snd_seq_queue_status_t*);
+    int snd_seq_event_output (snd_seq_t*, snd_seq_event_t*);
+    int snd_seq_drain_output (snd_seq_t*);
+    int snd_seq_event_input (snd_seq_t*, snd_seq_event_t**);
+    int snd_seq_event_input_pending (snd_seq_t*, int);
+    int snd_seq_free_event (snd_seq_event_t*);
+    int snd_seq_nonblock (snd_seq_t*, int);
+    int snd_seq_poll_descriptors_count (snd_seq_t*, short);
+    int snd_seq_poll_descriptors (snd_seq_t*, struct pollfd*, unsigned int, short);
+    int snd_midi_event_new (size_t, snd_midi_event_t**);
+    void snd_midi_event_free (snd_midi_event_t*);
+    long snd_midi_event_encode (snd_midi_event_t*, const unsigned char*, long, snd_seq_event_t*);
+    long snd_midi_event_decode (snd_midi_event_t*, unsigned char*, long, const snd_seq_event_t*);
+    void snd_midi_event_reset_encode (snd_midi_event_t*);
+    void snd_midi_event_reset_decode (snd_midi_event_t*);
+}
+
+
+//==============================================================================
+/** An event the output handed to the fake sequencer */
+struct FakeSequencerEvent
+{
+    unsigned char data [3];
+    bool isDirect;          // sent straight away, not through the queue
+    double queueTime;       // seconds on the queue clock it was scheduled for
+    double handedOverAt;    // CLOCK_MONOTONIC seconds when it was handed over
+};
+
+/** Returns CLOCK_MONOTONIC in seconds, the clock the fake queue runs on */
+double getFakeSequencerClock();
+
+/** Returns the CLOCK_MONOTONIC time at which the queue was started */
+double getFakeSequencerQueueStart();
+
+/** Returns the events recorded so far, in the order they were handed over */
+int getNumFakeSequencerEvents();
+const FakeSequencerEvent getFakeSequencerEvent (const int index);
+
+/** Forgets the recorded events */
+void clearFakeSequencerEvents();
+
+
+#endif
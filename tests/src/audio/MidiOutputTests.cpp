@@ -0,0 +1,304 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2009 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU General Public License, as published by the Free Software Foundation;
+ either version 2 of the License, or (at your option) any later version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+
+#include "../TestsHeader.h"
+#include "FakeAlsaSequencer.h"
+
+#include <math.h>
+
+// the scheduled output is compiled straight from the linux sources, on top of
+// the fake sequencer instead of <alsa/asoundlib.h>
+BEGIN_JUCE_NAMESPACE
+#include "audio/devices/juce_MidiOutput.h"
+#include "audio/devices/juce_MidiInput.h"
+#include "audio/midi/juce_MidiBuffer.h"
+#include "audio/midi/juce_MidiMessage.h"
+#include "threads/juce_RealtimePolicy.h"
+#include "extended/containers/jucetice_LockFreeQueue.h"
+#define JUCE_INCLUDED_FILE 1
+#undef JUCE_ALSA
+#define JUCE_ALSA 1
+#include "native/linux/juce_linux_Midi.cpp"
+#undef JUCE_ALSA
+#undef JUCE_INCLUDED_FILE
+END_JUCE_NAMESPACE
+
+
+//==============================================================================
+namespace MidiOutputTestHelpers
+{
+    static const double sampleRate = 48000.0;
+    static const int blockSize = 256;
+    static const int eventsPerBlock = 2;
+
+    // how late the audio callbacks wake up, at most
+    static const double callbackJitter = 0.003;
+
+    // what MidiOutputPlugin asks for
+    static const double latency = 2.0 * blockSize / sampleRate;
+
+    static void sleepUntil (const double time)
+    {
+        const double delay = time - getFakeSequencerClock();
+
+        if (delay > 0)
+        {
+            timespec t;
+            t.tv_sec = (time_t) delay;
+            t.tv_nsec = (long) ((delay - t.tv_sec) * 1.0e9);
+            nanosleep (&t, 0);
+        }
+    }
+
+    /** The spread of timing errors, around their mean */
+    struct Jitter
+    {
+        Jitter() : num (0), sum (0), sumSquares (0), minimum (1.0e9), maximum (-1.0e9) {}
+
+        void add (const double error)
+        {
+            ++num;
+            sum += error;
+            sumSquares += error * error;
+            minimum = jmin (minimum, error);
+            maximum = jmax (maximum, error);
+        }
+
+        double getOffset() const    { return sum / jmax (1, num); }
+        double getRms() const       { return sqrt (jmax (0.0, sumSquares / jmax (1, num) - getOffset() * getOffset())); }
+        double getWorst() const     { return jmax (maximum - getOffset(), getOffset() - minimum); }
+
+        int num;
+        double sum, sumSquares, minimum, maximum;
+    };
+
+    /** Plays blocks through a looped back output the way an audio callback would
+
+        The device clock says each block is due on time, but the callback wakes
+        up late by a random amount. The events are compared with the time of
+        their sample position plus the latency.
+    */
+    class Loopback
+    {
+    public:
+        Loopback()
+            : numEvents (0), numScheduled (0), numDirect (0), numDuplicated (0),
+              numWrongData (0), numHandedOverLate (0), numAllocations (0)
+        {
+        }
+
+        bool run (const int numBlocks, const int numSettlingBlocks)
+        {
+            clearFakeSequencerEvents();
+
+            ScopedPointer <MidiOutput> output (MidiOutput::createNewDevice (T("loopback")));
+
+            if (output == 0 || ! output->startScheduledOutput (latency))
+                return false;
+
+            Random random (1234);
+            Array <int64> intended;
+            Array <double> callbackTimes;
+            MidiBuffer buffer;
+            buffer.ensureSize (eventsPerBlock * 8);
+
+            const double startTime = getFakeSequencerClock() + 0.01;
+
+            for (int n = 0; n < numBlocks; ++n)
+            {
+                sleepUntil (startTime + (double) n * blockSize / sampleRate
+                              + callbackJitter * random.nextDouble());
+
+                const double callbackTime = getFakeSequencerClock();
+
+                buffer.clear();
+
+                for (int e = 0; e < eventsPerBlock; ++e)
+                {
+                    const int id = intended.size();
+                    const int offset = random.nextInt (blockSize);
+                    const uint8 data[] = { 0x90, (uint8) (id & 0x7f), (uint8) ((id >> 7) & 0x7f) };
+
+                    buffer.addEvent (data, 3, offset);
+                    intended.add ((int64) n * blockSize + offset);
+                    callbackTimes.add (callbackTime);
+                }
+
+                const int allocationsBefore = getNumAllocations();
+                output->scheduleBlockOfMessages (buffer, (int64) n * blockSize, sampleRate);
+                numAllocations += getNumAllocations() - allocationsBefore;
+            }
+
+            // let the sender thread hand over the last blocks
+            Thread::sleep (roundDoubleToInt (1000.0 * latency) + 100);
+            output->stopScheduledOutput();
+            output = 0;
+
+            numEvents = intended.size();
+            Array <bool> delivered;
+            delivered.insertMultiple (0, false, numEvents);
+
+            for (int i = 0; i < getNumFakeSequencerEvents(); ++i)
+            {
+                const FakeSequencerEvent e (getFakeSequencerEvent (i));
+
+                if (e.isDirect)
+                {
+                    ++numDirect;
+                    continue;
+                }
+
+                const int id = e.data[1] | (e.data[2] << 7);
+
+                if (e.data[0] != 0x90 || id >= numEvents)
+                {
+                    ++numWrongData;
+                    continue;
+                }
+
+                if (delivered [id])
+                    ++numDuplicated;
+
+                delivered.set (id, true);
+                ++numScheduled;
+
+                const double wanted = startTime + intended [id] / sampleRate + latency;
+                const double playedAt = getFakeSequencerQueueStart() + e.queueTime;
+
+                if (e.handedOverAt > playedAt)
+                    ++numHandedOverLate;
+
+                // what sendMessageNow from the callback does: out at the callback, offset ignored
+                sentNow.add (callbackTimes [id] - (wanted - latency));
+
+                if (intended [id] >= (int64) numSettlingBlocks * blockSize)
+                    scheduled.add (playedAt - wanted);
+            }
+
+            return true;
+        }
+
+        int numEvents, numScheduled, numDirect, numDuplicated, numWrongData, numHandedOverLate, numAllocations;
+        Jitter sentNow, scheduled;
+    };
+}
+
+using namespace MidiOutputTestHelpers;
+
+
+//==============================================================================
+class MidiOutputTests  : public Test::Suite
+{
+public:
+    MidiOutputTests()
+    {
+        TEST_ADD (MidiOutputTests::scheduledEventsFollowTheirSamplePositions)
+        TEST_ADD (MidiOutputTests::schedulingDoesNotAllocate)
+    }
+
+private:
+    void scheduledEventsFollowTheirSamplePositions()
+    {
+        Loopback loopback;
+        TEST_ASSERT (loopback.run (600, 200));
+
+        // every event goes out once, through the queue
+        TEST_ASSERT (loopback.numScheduled == loopback.numEvents);
+        TEST_ASSERT (loopback.numDirect == 0);
+        TEST_ASSERT (loopback.numDuplicated == 0);
+        TEST_ASSERT (loopback.numWrongData == 0);
+
+        // the latency covers the sender thread's polling, but nothing can cover a
+        // machine that stalls every thread for a few milliseconds now and then
+        TEST_ASSERT (loopback.numHandedOverLate <= loopback.numEvents / 100);
+
+        // the late callbacks don't show in the times the events are played at,
+        // sending them from the callback would put them off by a block and more.
+        // The clock follows the callbacks, so it runs late by their average delay
+        const String message (T("jitter rms ") + String (loopback.scheduled.getRms() * 1000.0, 3)
+                                + T(" ms, worst ") + String (loopback.scheduled.getWorst() * 1000.0, 3)
+                                + T(" ms, offset ") + String (loopback.scheduled.getOffset() * 1000.0, 3) + T(" ms"));
+
+        TEST_ASSERT_MSG (loopback.scheduled.getRms() < 0.0005, (const char*) message);
+        TEST_ASSERT_MSG (loopback.scheduled.getWorst() < 0.002, (const char*) message);
+        TEST_ASSERT_MSG (fabs (loopback.scheduled.getOffset()) < callbackJitter, (const char*) message);
+        TEST_ASSERT_MSG (loopback.scheduled.getRms() < loopback.sentNow.getRms() * 0.5, (const char*) message);
+    }
+
+    void schedulingDoesNotAllocate()
+    {
+        if (! canCountAllocations())
+            return;
+
+        Loopback loopback;
+        TEST_ASSERT (loopback.run (50, 0));
+        TEST_ASSERT (loopback.numAllocations == 0);
+    }
+};
+
+//==============================================================================
+class MidiOutputBenchmarks  : public Test::Suite
+{
+public:
+    MidiOutputBenchmarks()
+    {
+        TEST_ADD (MidiOutputBenchmarks::loopbackJitter)
+    }
+
+private:
+    static void printJitter (const char* name, const Jitter& jitter)
+    {
+        printf ("\n  %-40s %6d events   offset %7.3f ms   rms %6.3f ms   worst %6.3f ms",
+                name, jitter.num, jitter.getOffset() * 1000.0, jitter.getRms() * 1000.0, jitter.getWorst() * 1000.0);
+        fflush (stdout);
+    }
+
+    void loopbackJitter()
+    {
+        Loopback loopback;
+        TEST_ASSERT (loopback.run (1500, 200));
+
+        printf ("\n  %d samples @ %.0f Hz, callbacks up to %.1f ms late, latency %.2f ms",
+                blockSize, sampleRate, callbackJitter * 1000.0, latency * 1000.0);
+        printJitter ("sendMessageNow from the callback", loopback.sentNow);
+        printJitter ("scheduled, after the first 200 blocks", loopback.scheduled);
+        printf ("\n  handed to the queue after their time: %d\n", loopback.numHandedOverLate);
+    }
+};
+
+
+//==============================================================================
+Test::Suite* createMidiOutputTests()
+{
+    return new MidiOutputTests();
+}
+
+Test::Suite* createMidiOutputBenchmarks()
+{
+    return new MidiOutputBenchmarks();
+}
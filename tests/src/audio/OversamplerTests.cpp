@@ -0,0 +1,322 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2009 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU General Public License, as published by the Free Software Foundation;
+ either version 2 of the License, or (at your option) any later version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+
+
+#include "../TestsHeader.h"
+
+BEGIN_JUCE_NAMESPACE
+#include "extended/audio/resampler/jucetice_Oversampler.h"
+END_JUCE_NAMESPACE
+
+#include <math.h>
+
+
+//==============================================================================
+namespace OversamplerTestHelpers
+{
+    static const double sampleRate = 44100.0;
+
+    /** Fills a buffer with a sine, starting at sample position 'start' */
+    static void fillWithSine (float* data, const int numSamples, const double frequency, const int start = 0)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            data [i] = (float) (0.8 * sin ((start + i) * 2.0 * double_Pi * frequency / sampleRate));
+    }
+
+    /** Runs channels through upsample() and downsample() in uneven blocks */
+    static void runRoundTrip (Oversampler& oversampler, float** input, float** output,
+                              const int numChannels, const int numSamples)
+    {
+        const int blockSizes[] = { 64, 37, 256, 1, 100 };
+        int pos = 0, block = 0;
+
+        while (pos < numSamples)
+        {
+            const int num = jmin (blockSizes [block++ % numElementsInArray (blockSizes)],
+                                  oversampler.getMaxBlockSize(), numSamples - pos);
+
+            const float* in [8];
+            float* out [8];
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                in [ch] = input [ch] + pos;
+                out [ch] = output [ch] + pos;
+            }
+
+            oversampler.upsample (in, numChannels, num);
+            oversampler.downsample (out, numChannels, num);
+            pos += num;
+        }
+    }
+
+    /** Returns the largest difference between the output and the input moved by the latency */
+    static double getErrorAgainstDelayedInput (const float* input, const float* output,
+                                               const int numSamples, const int latency)
+    {
+        double maxError = 0.0;
+
+        // skip the first samples, where the filters are still filling
+        for (int i = latency + 64; i < numSamples; ++i)
+            maxError = jmax (maxError, (double) fabsf (output [i] - input [i - latency]));
+
+        return maxError;
+    }
+}
+
+using namespace OversamplerTestHelpers;
+
+
+//==============================================================================
+class OversamplerTests  : public Test::Suite
+{
+public:
+    OversamplerTests()
+    {
+        TEST_ADD (OversamplerTests::factorOneIsACopy)
+        TEST_ADD (OversamplerTests::roundTripIsDelayedByTheLatency)
+        TEST_ADD (OversamplerTests::channelsAreKeptApart)
+        TEST_ADD (OversamplerTests::upsampledSignalKeepsItsLevel)
+        TEST_ADD (OversamplerTests::harmonicsAboveNyquistAreRemoved)
+        TEST_ADD (OversamplerTests::resetClearsTheFilters)
+    }
+
+private:
+    enum { numSamples = 8192 };
+
+    void factorOneIsACopy()
+    {
+        Oversampler oversampler (1, 256);
+        HeapBlock <float> input (numSamples), output (numSamples);
+        float* in = input;
+        float* out = output;
+
+        fillWithSine (input, numSamples, 1000.0);
+        runRoundTrip (oversampler, &in, &out, 1, numSamples);
+
+        TEST_ASSERT (oversampler.getLatencySamples() == 0);
+        TEST_ASSERT (memcmp (input, output, sizeof (float) * numSamples) == 0);
+    }
+
+    void roundTripIsDelayedByTheLatency()
+    {
+        const double frequencies[] = { 100.0, 1000.0, 5000.0, 10000.0 };
+
+        for (int factor = 2; factor <= 4; factor *= 2)
+        {
+            for (int f = 0; f < numElementsInArray (frequencies); ++f)
+            {
+                Oversampler oversampler (1, 256);
+                oversampler.setFactor (factor);
+
+                HeapBlock <float> input (numSamples), output (numSamples);
+                float* in = input;
+                float* out = output;
+
+                fillWithSine (input, numSamples, frequencies [f]);
+                runRoundTrip (oversampler, &in, &out, 1, numSamples);
+
+                // a latency that's off by half a sample would give an error of
+                // 0.1 at 1kHz, and far more above that
+                const double error = getErrorAgainstDelayedInput (input, output, numSamples,
+                                                                  Oversampler::getLatencyForFactor (factor));
+
+                TEST_ASSERT_MSG (error < 5.0e-4, (const char*) ("factor " + String (factor) + " at "
+                                                                 + String (frequencies [f]) + "Hz, error " + String (error)));
+            }
+        }
+
+        TEST_ASSERT (Oversampler::getLatencyForFactor (2) == 23);
+        TEST_ASSERT (Oversampler::getLatencyForFactor (4) == 29);
+    }
+
+    void channelsAreKeptApart()
+    {
+        Oversampler oversampler (3, 128);
+        oversampler.setFactor (4);
+
+        HeapBlock <float> input (numSamples * 3), output (numSamples * 3);
+        float* in[] = { input, input + numSamples, input + numSamples * 2 };
+        float* out[] = { output, output + numSamples, output + numSamples * 2 };
+
+        fillWithSine (in [0], numSamples, 440.0);
+        zeromem (in [1], sizeof (float) * numSamples);
+        fillWithSine (in [2], numSamples, 3000.0);
+
+        runRoundTrip (oversampler, in, out, 3, numSamples);
+
+        for (int ch = 0; ch < 3; ++ch)
+            TEST_ASSERT (getErrorAgainstDelayedInput (in [ch], out [ch], numSamples, oversampler.getLatencySamples()) < 5.0e-4);
+
+        float silentPeak = 0.0f;
+        for (int i = 0; i < numSamples; ++i)
+            silentPeak = jmax (silentPeak, fabsf (out [1][i]));
+
+        TEST_ASSERT (silentPeak == 0.0f);
+    }
+
+    void upsampledSignalKeepsItsLevel()
+    {
+        for (int factor = 2; factor <= 4; factor *= 2)
+        {
+            Oversampler oversampler (1, 256);
+            oversampler.setFactor (factor);
+
+            HeapBlock <float> input (256);
+            float peak = 0.0f;
+
+            for (int pos = 0; pos < numSamples; pos += 256)
+            {
+                fillWithSine (input, 256, 1000.0, pos);
+
+                const float* in = input;
+                float* const* up = oversampler.upsample (&in, 1, 256);
+
+                if (pos >= 1024)
+                    for (int i = 0; i < 256 * factor; ++i)
+                        peak = jmax (peak, fabsf (up [0][i]));
+            }
+
+            TEST_ASSERT_MSG (fabsf (peak - 0.8f) < 0.005f, (const char*) ("factor " + String (factor) + ", peak " + String (peak)));
+        }
+    }
+
+    void harmonicsAboveNyquistAreRemoved()
+    {
+        // a tone written straight into the oversampled signal, above the
+        // original nyquist, must not fold back into the output
+        for (int factor = 2; factor <= 4; factor *= 2)
+        {
+            Oversampler oversampler (1, 256);
+            oversampler.setFactor (factor);
+
+            HeapBlock <float> input (256), output (256);
+            zeromem (input, sizeof (float) * 256);
+
+            const double frequency = sampleRate * 0.75;
+            float peak = 0.0f;
+
+            for (int pos = 0; pos < numSamples; pos += 256)
+            {
+                const float* in = input;
+                float* out = output;
+                float* const* up = oversampler.upsample (&in, 1, 256);
+
+                for (int i = 0; i < 256 * factor; ++i)
+                    up [0][i] = (float) sin ((pos * factor + i) * 2.0 * double_Pi * frequency / (sampleRate * factor));
+
+                oversampler.downsample (&out, 1, 256);
+
+                if (pos >= 1024)
+                    for (int i = 0; i < 256; ++i)
+                        peak = jmax (peak, fabsf (output [i]));
+            }
+
+            TEST_ASSERT_MSG (peak < 0.001f, (const char*) ("factor " + String (factor) + ", folded peak " + String (peak)));
+        }
+    }
+
+    void resetClearsTheFilters()
+    {
+        Oversampler oversampler (1, 256);
+        oversampler.setFactor (4);
+
+        HeapBlock <float> input (256), output (256);
+        const float* in = input;
+        float* out = output;
+
+        fillWithSine (input, 256, 1000.0);
+        oversampler.upsample (&in, 1, 256);
+        oversampler.downsample (&out, 1, 256);
+
+        oversampler.reset();
+        zeromem (input, sizeof (float) * 256);
+        oversampler.upsample (&in, 1, 256);
+        oversampler.downsample (&out, 1, 256);
+
+        float peak = 0.0f;
+        for (int i = 0; i < 256; ++i)
+            peak = jmax (peak, fabsf (output [i]));
+
+        TEST_ASSERT (peak == 0.0f);
+    }
+};
+
+
+//==============================================================================
+class OversamplerBenchmarks  : public Test::Suite
+{
+public:
+    OversamplerBenchmarks()
+    {
+        TEST_ADD (OversamplerBenchmarks::roundTrips)
+    }
+
+private:
+    void roundTrips()
+    {
+        const int blockSize = 256, numBlocks = 4000;
+
+        for (int factor = 1; factor <= 4; factor *= 2)
+        {
+            Oversampler oversampler (2, blockSize);
+            oversampler.setFactor (factor);
+
+            HeapBlock <float> input (blockSize * 2), output (blockSize * 2);
+            const float* in[] = { input, input + blockSize };
+            float* out[] = { output, output + blockSize };
+
+            fillWithSine (input, blockSize * 2, 1000.0);
+
+            const double start = getBenchmarkTime();
+
+            for (int n = 0; n < numBlocks; ++n)
+            {
+                oversampler.upsample (in, 2, blockSize);
+                oversampler.downsample (out, 2, blockSize);
+            }
+
+            const double time = getBenchmarkTime() - start;
+
+            printBenchmarkResult ((const char*) ("Oversampler " + String (factor) + "x, stereo up + down"),
+                                  time, (double) numBlocks * blockSize, "frames");
+        }
+    }
+};
+
+
+//==============================================================================
+Test::Suite* createOversamplerTests()
+{
+    return new OversamplerTests();
+}
+
+Test::Suite* createOversamplerBenchmarks()
+{
+    return new OversamplerBenchmarks();
+}
@@ -0,0 +1,328 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2009 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU General Public License, as published by the Free Software Foundation;
+ either version 2 of the License, or (at your option) any later version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+
+#include "../TestsHeader.h"
+
+BEGIN_JUCE_NAMESPACE
+#include "extended/audio/fft/jucetice_RealFFT.h"
+END_JUCE_NAMESPACE
+
+extern "C"
+{
+#include "extended/dependancies/kissfft/kiss_fftr.h"
+}
+
+#include <math.h>
+
+
+//==============================================================================
+namespace RealFFTTestHelpers
+{
+    /** Fills a buffer with the same noise on every run */
+    static void fillWithNoise (float* data, const int numSamples, const int seed)
+    {
+        Random random (seed);
+
+        for (int i = 0; i < numSamples; ++i)
+            data [i] = random.nextFloat() * 2.0f - 1.0f;
+    }
+
+    /** Compares a spectrum with a direct DFT computed in double precision
+
+        Sizes above 4096 are only checked on a spread of 257 bins, the direct
+        transform of all of them would take minutes.
+
+        @returns the rms error of the bins, relative to their rms level
+    */
+    static double getErrorAgainstDFT (const float* input, const int size, const float* real, const float* imag)
+    {
+        HeapBlock <double> cosines (size), sines (size);
+
+        for (int i = 0; i < size; ++i)
+        {
+            cosines [i] = cos (-2.0 * double_Pi * i / size);
+            sines [i] = sin (-2.0 * double_Pi * i / size);
+        }
+
+        const int numBins = size / 2 + 1;
+        const int binStep = size > 4096 ? jmax (1, (numBins - 1) / 256) : 1;
+        double errorSquared = 0.0, levelSquared = 0.0;
+
+        for (int k = 0; k < numBins; k += binStep)
+        {
+            double sumReal = 0.0, sumImag = 0.0;
+            int index = 0;
+
+            for (int n = 0; n < size; ++n)
+            {
+                sumReal += input [n] * cosines [index];
+                sumImag += input [n] * sines [index];
+                index = (index + k) & (size - 1);
+            }
+
+            const double dr = real [k] - sumReal, di = imag [k] - sumImag;
+            errorSquared += dr * dr + di * di;
+            levelSquared += sumReal * sumReal + sumImag * sumImag;
+        }
+
+        return sqrt (errorSquared / jmax (1.0e-30, levelSquared));
+    }
+
+    /** Returns the largest difference between a signal and a rebuilt one scaled by the size */
+    static double getRoundTripError (const float* input, const float* output, const int size)
+    {
+        double maxError = 0.0;
+
+        for (int i = 0; i < size; ++i)
+            maxError = jmax (maxError, fabs (output [i] / size - (double) input [i]));
+
+        return maxError;
+    }
+}
+
+using namespace RealFFTTestHelpers;
+
+
+//==============================================================================
+class RealFFTTests  : public Test::Suite
+{
+public:
+    RealFFTTests()
+    {
+        TEST_ADD (RealFFTTests::forwardMatchesADirectDFT)
+        TEST_ADD (RealFFTTests::inverseRebuildsTheInput)
+        TEST_ADD (RealFFTTests::batchedChannelsMatchSingleOnes)
+        TEST_ADD (RealFFTTests::impulseHasAFlatSpectrum)
+    }
+
+private:
+    void forwardMatchesADirectDFT()
+    {
+        for (int size = 2; size <= 65536; size *= 2)
+        {
+            RealFFT fft (size);
+            FFTBuffer input (size), real (fft.getNumBins()), imag (fft.getNumBins());
+
+            fillWithNoise (input, size, size);
+            fft.performForward (input, real, imag);
+
+            const double error = getErrorAgainstDFT (input, size, real, imag);
+            TEST_ASSERT_MSG (error <= 1.4e-7, (const char*) ("size " + String (size) + ", error " + String (error)));
+        }
+    }
+
+    void inverseRebuildsTheInput()
+    {
+        for (int size = 2; size <= 65536; size *= 2)
+        {
+            RealFFT fft (size);
+            FFTBuffer input (size), real (fft.getNumBins()), imag (fft.getNumBins()), output (size);
+
+            fillWithNoise (input, size, size + 1);
+            fft.performForward (input, real, imag);
+            fft.performInverse (real, imag, output);
+
+            const double error = getRoundTripError (input, output, size);
+            TEST_ASSERT_MSG (error <= 1.0e-6, (const char*) ("size " + String (size) + ", error " + String (error)));
+        }
+    }
+
+    void batchedChannelsMatchSingleOnes()
+    {
+        const int numChannels = 3;
+
+        for (int size = 2; size <= 65536; size *= 4)
+        {
+            RealFFT fft (size);
+            const int numBins = fft.getNumBins();
+
+            OwnedArray <FFTBuffer> inputs, reals, imags, outputs, singleReals, singleImags;
+            const float* inputPointers [numChannels];
+            float* realPointers [numChannels];
+            float* imagPointers [numChannels];
+            float* outputPointers [numChannels];
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                inputs.add (new FFTBuffer (size));
+                reals.add (new FFTBuffer (numBins));
+                imags.add (new FFTBuffer (numBins));
+                outputs.add (new FFTBuffer (size));
+                singleReals.add (new FFTBuffer (numBins));
+                singleImags.add (new FFTBuffer (numBins));
+
+                fillWithNoise (*inputs [ch], size, size * 10 + ch);
+                fft.performForward (*inputs [ch], *singleReals [ch], *singleImags [ch]);
+
+                inputPointers [ch] = *inputs [ch];
+                realPointers [ch] = *reals [ch];
+                imagPointers [ch] = *imags [ch];
+                outputPointers [ch] = *outputs [ch];
+            }
+
+            fft.performForward (inputPointers, realPointers, imagPointers, numChannels);
+            fft.performInverse (realPointers, imagPointers, outputPointers, numChannels);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                const double error = getErrorAgainstDFT (*inputs [ch], size, *reals [ch], *imags [ch]);
+                TEST_ASSERT_MSG (error <= 1.4e-7, (const char*) ("size " + String (size) + ", error " + String (error)));
+
+                double difference = 0.0;
+
+                for (int k = 0; k < numBins; ++k)
+                    difference = jmax (difference, (double) fabs ((*reals [ch])[k] - (*singleReals [ch])[k])
+                                                    + fabs ((*imags [ch])[k] - (*singleImags [ch])[k]));
+
+                TEST_ASSERT (difference <= 1.0e-3 * sqrt ((double) size));
+                TEST_ASSERT (getRoundTripError (*inputs [ch], *outputs [ch], size) <= 1.0e-6);
+            }
+        }
+    }
+
+    void impulseHasAFlatSpectrum()
+    {
+        const int size = 1024;
+        RealFFT fft (size);
+        FFTBuffer input (size), real (fft.getNumBins()), imag (fft.getNumBins());
+
+        input [0] = 1.0f;
+        fft.performForward (input, real, imag);
+
+        bool isFlat = true;
+
+        for (int k = 0; k < fft.getNumBins(); ++k)
+            isFlat = isFlat && fabs (real [k] - 1.0f) < 1.0e-6f && fabs (imag [k]) < 1.0e-6f;
+
+        TEST_ASSERT (isFlat);
+    }
+};
+
+
+//==============================================================================
+class RealFFTBenchmarks  : public Test::Suite
+{
+public:
+    RealFFTBenchmarks()
+    {
+        TEST_ADD (RealFFTBenchmarks::realFFTAgainstKissFFT)
+        TEST_ADD (RealFFTBenchmarks::batchedAgainstSingleChannels)
+    }
+
+private:
+    void realFFTAgainstKissFFT()
+    {
+        for (int size = 64; size <= 65536; size *= 4)
+        {
+            const int numPasses = jmax (20, 8000000 / size);
+
+            RealFFT fft (size);
+            FFTBuffer input (size), real (fft.getNumBins()), imag (fft.getNumBins()), output (size);
+            fillWithNoise (input, size, size);
+
+            double start = getBenchmarkTime();
+
+            for (int i = 0; i < numPasses; ++i)
+            {
+                fft.performForward (input, real, imag);
+                fft.performInverse (real, imag, output);
+            }
+
+            const double realFFTTime = getBenchmarkTime() - start;
+
+            kiss_fftr_cfg forward = kiss_fftr_alloc (size, 0, 0, 0);
+            kiss_fftr_cfg inverse = kiss_fftr_alloc (size, 1, 0, 0);
+            HeapBlock <kiss_fft_cpx> spectrum (fft.getNumBins());
+
+            start = getBenchmarkTime();
+
+            for (int i = 0; i < numPasses; ++i)
+            {
+                kiss_fftr (forward, input, spectrum);
+                kiss_fftri (inverse, spectrum, output);
+            }
+
+            const double kissFFTTime = getBenchmarkTime() - start;
+
+            free (forward);
+            free (inverse);
+
+            printBenchmarkResult ((const char*) ("RealFFT forward + inverse, size " + String (size)), realFFTTime, numPasses, "passes");
+            printBenchmarkResult ((const char*) ("kissfft forward + inverse, size " + String (size)), kissFFTTime, numPasses, "passes");
+        }
+    }
+
+    void batchedAgainstSingleChannels()
+    {
+        for (int size = 64; size <= 65536; size *= 4)
+        {
+            const int numPasses = jmax (20, 8000000 / size);
+
+            RealFFT fft (size);
+            const int numBins = fft.getNumBins();
+            FFTBuffer input1 (size), input2 (size), real1 (numBins), imag1 (numBins), real2 (numBins), imag2 (numBins);
+            fillWithNoise (input1, size, size);
+            fillWithNoise (input2, size, size + 1);
+
+            const float* inputs [2] = { input1, input2 };
+            float* reals [2] = { real1, real2 };
+            float* imags [2] = { imag1, imag2 };
+
+            double start = getBenchmarkTime();
+
+            for (int i = 0; i < numPasses; ++i)
+            {
+                fft.performForward (input1, real1, imag1);
+                fft.performForward (input2, real2, imag2);
+            }
+
+            const double singleTime = getBenchmarkTime() - start;
+            start = getBenchmarkTime();
+
+            for (int i = 0; i < numPasses; ++i)
+                fft.performForward (inputs, reals, imags, 2);
+
+            const double batchedTime = getBenchmarkTime() - start;
+
+            printBenchmarkResult ((const char*) ("2 single forwards, size " + String (size)), singleTime, numPasses, "passes");
+            printBenchmarkResult ((const char*) ("batched forward of 2, size " + String (size)), batchedTime, numPasses, "passes");
+        }
+    }
+};
+
+
+//==============================================================================
+Test::Suite* createRealFFTTests()
+{
+    return new RealFFTTests();
+}
+
+Test::Suite* createRealFFTBenchmarks()
+{
+    return new RealFFTBenchmarks();
+}
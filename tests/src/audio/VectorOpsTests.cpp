@@ -0,0 +1,270 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2009 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU General Public License, as published by the Free Software Foundation;
+ either version 2 of the License, or (at your option) any later version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+
+
+#include "../TestsHeader.h"
+
+BEGIN_JUCE_NAMESPACE
+#include "extended/audio/processors/jucetice_VectorOps.h"
+#include "extended/audio/processors/jucetice_ParameterRamp.h"
+END_JUCE_NAMESPACE
+
+#include <math.h>
+
+
+//==============================================================================
+namespace VectorOpsTestHelpers
+{
+    /** Fills a buffer with the same noise on every run */
+    static void fillWithNoise (float* data, const int numSamples, const int seed)
+    {
+        Random random (seed);
+
+        for (int i = 0; i < numSamples; ++i)
+            data [i] = random.nextFloat() * 2.0f - 1.0f;
+    }
+
+    static bool areIdentical (const float* a, const float* b, const int numSamples)
+    {
+        return memcmp (a, b, sizeof (float) * numSamples) == 0;
+    }
+}
+
+using namespace VectorOpsTestHelpers;
+
+
+//==============================================================================
+class VectorOpsTests  : public Test::Suite
+{
+public:
+    VectorOpsTests()
+    {
+        TEST_ADD (VectorOpsTests::operationsMatchPlainLoops)
+        TEST_ADD (VectorOpsTests::operationsWorkInPlace)
+        TEST_ADD (VectorOpsTests::rampReachesItsTarget)
+        TEST_ADD (VectorOpsTests::rampBlocksMatchSingleValues)
+    }
+
+private:
+    enum { maxSize = 67 };
+
+    void operationsMatchPlainLoops()
+    {
+        HeapBlock <float> a (maxSize + 3), b (maxSize + 3), c (maxSize + 3), expected (maxSize), result (maxSize);
+        bool allMatch = true;
+
+        // every length up to a few sse blocks, from aligned and unaligned starts
+        for (int offset = 0; offset < 3; ++offset)
+        {
+            const float* const x = a + offset;
+            const float* const y = b + offset;
+            const float* const z = c + offset;
+
+            fillWithNoise (a, maxSize + 3, offset);
+            fillWithNoise (b, maxSize + 3, offset + 10);
+            fillWithNoise (c, maxSize + 3, offset + 20);
+
+            for (int n = 0; n <= maxSize; ++n)
+            {
+                int i;
+
+                for (i = 0; i < n; ++i) expected [i] = x [i] * 0.3f;
+                VectorOps::multiply (result, x, 0.3f, n);
+                allMatch = allMatch && areIdentical (result, expected, n);
+
+                for (i = 0; i < n; ++i) expected [i] = x [i] * y [i];
+                VectorOps::multiply (result, x, y, n);
+                allMatch = allMatch && areIdentical (result, expected, n);
+
+                for (i = 0; i < n; ++i) expected [i] = x [i] * y [i] + z [i];
+                VectorOps::multiplyAdd (result, x, y, z, n);
+                allMatch = allMatch && areIdentical (result, expected, n);
+
+                for (i = 0; i < n; ++i) expected [i] = (y [i] - x [i]) * z [i] + x [i];
+                VectorOps::interpolate (result, x, y, z, n);
+                allMatch = allMatch && areIdentical (result, expected, n);
+
+                for (i = 0; i < n; ++i) expected [i] = x [i] + y [i];
+                VectorOps::add (result, x, y, n);
+                allMatch = allMatch && areIdentical (result, expected, n);
+
+                for (i = 0; i < n; ++i) expected [i] = fabsf (x [i]);
+                VectorOps::abs (result, x, n);
+                allMatch = allMatch && areIdentical (result, expected, n);
+
+                for (i = 0; i < n; ++i) expected [i] = jmax (expected [i], fabsf (y [i]));
+                VectorOps::absMax (result, y, n);
+                allMatch = allMatch && areIdentical (result, expected, n);
+
+                for (i = 0; i < n; ++i) expected [i] = x [i] > 0.0f ? sqrtf (x [i]) : -sqrtf (-x [i]);
+                VectorOps::signedSqrt (result, x, n);
+                allMatch = allMatch && areIdentical (result, expected, n);
+            }
+        }
+
+        TEST_ASSERT (allMatch);
+    }
+
+    void operationsWorkInPlace()
+    {
+        HeapBlock <float> a (maxSize), b (maxSize), expected (maxSize);
+
+        fillWithNoise (a, maxSize, 1);
+        fillWithNoise (b, maxSize, 2);
+
+        for (int i = 0; i < maxSize; ++i)
+            expected [i] = a [i] + b [i];
+
+        VectorOps::add (a, b, maxSize);
+        TEST_ASSERT (areIdentical (a, expected, maxSize));
+
+        for (int i = 0; i < maxSize; ++i)
+            expected [i] = a [i] * b [i];
+
+        VectorOps::multiply (a, a, b, maxSize);
+        TEST_ASSERT (areIdentical (a, expected, maxSize));
+    }
+
+    void rampReachesItsTarget()
+    {
+        ParameterRamp ramp (1.0f);
+        ramp.setRampLength (100);
+        ramp.setTarget (2.0f);
+
+        float values [150];
+        ramp.getNextValues (values, 150);
+
+        TEST_ASSERT (values [0] == 1.0f);
+        TEST_ASSERT (fabsf (values [50] - 1.5f) < 1.0e-5f);
+        TEST_ASSERT (values [100] == 2.0f);
+        TEST_ASSERT (values [149] == 2.0f);
+        TEST_ASSERT (! ramp.isRamping());
+
+        bool rising = true;
+        for (int i = 1; i <= 100; ++i)
+            rising = rising && values [i] > values [i - 1];
+
+        TEST_ASSERT (rising);
+
+        ramp.setTarget (0.0f);
+        ramp.setValue (0.5f);
+        TEST_ASSERT (! ramp.isRamping());
+        TEST_ASSERT (ramp.getNextValue() == 0.5f);
+    }
+
+    void rampBlocksMatchSingleValues()
+    {
+        ParameterRamp single (0.0f), blocks (0.0f);
+        single.setRampLength (77);
+        blocks.setRampLength (77);
+
+        HeapBlock <float> expected (300), result (300);
+        const int targetChanges[] = { 0, 40, 90, 200 };
+        int next = 0;
+
+        for (int i = 0; i < 300; ++i)
+        {
+            if (next < numElementsInArray (targetChanges) && targetChanges [next] == i)
+                single.setTarget ((float) ++next);
+
+            expected [i] = single.getNextValue();
+        }
+
+        // the same target changes, at the start of uneven blocks
+        next = 0;
+        for (int pos = 0; pos < 300;)
+        {
+            blocks.setTarget ((float) ++next);
+
+            const int end = next < numElementsInArray (targetChanges) ? targetChanges [next] : 300;
+            blocks.getNextValues (result + pos, end - pos);
+            pos = end;
+        }
+
+        TEST_ASSERT (areIdentical (expected, result, 300));
+    }
+};
+
+
+//==============================================================================
+class VectorOpsBenchmarks  : public Test::Suite
+{
+public:
+    VectorOpsBenchmarks()
+    {
+        TEST_ADD (VectorOpsBenchmarks::operationsAgainstPlainLoops)
+    }
+
+private:
+    enum { blockSize = 256, numBlocks = 20000 };
+
+    void operationsAgainstPlainLoops()
+    {
+        HeapBlock <float> a (blockSize), b (blockSize), c (blockSize), result (blockSize);
+
+        fillWithNoise (a, blockSize, 1);
+        fillWithNoise (b, blockSize, 2);
+        fillWithNoise (c, blockSize, 3);
+
+        double start = getBenchmarkTime();
+
+        for (int n = 0; n < numBlocks; ++n)
+        {
+            for (int i = 0; i < blockSize; ++i)
+                result [i] = (b [i] - a [i]) * c [i] + a [i];
+
+            a [n & (blockSize - 1)] = result [0];
+        }
+
+        const double plainTime = getBenchmarkTime() - start;
+        start = getBenchmarkTime();
+
+        for (int n = 0; n < numBlocks; ++n)
+        {
+            VectorOps::interpolate (result, a, b, c, blockSize);
+            a [n & (blockSize - 1)] = result [0];
+        }
+
+        const double vectorTime = getBenchmarkTime() - start;
+
+        printBenchmarkResult ("crossfade, plain loop", plainTime, (double) numBlocks * blockSize, "samples");
+        printBenchmarkResult ("crossfade, VectorOps::interpolate", vectorTime, (double) numBlocks * blockSize, "samples");
+    }
+};
+
+
+//==============================================================================
+Test::Suite* createVectorOpsTests()
+{
+    return new VectorOpsTests();
+}
+
+Test::Suite* createVectorOpsBenchmarks()
+{
+    return new VectorOpsBenchmarks();
+}
@@ -0,0 +1,487 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2009 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU General Public License, as published by the Free Software Foundation;
+ either version 2 of the License, or (at your option) any later version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+#include "../TestsHeader.h"
+
+#include "extended/containers/jucetice_LockFreeQueue.h"
+#include "extended/containers/jucetice_TripleBuffer.h"
+#include "extended/containers/jucetice_CircularBuffer.h"
+
+
+//==============================================================================
+namespace LockFreeQueueTestHelpers
+{
+    /** Pushes a counting sequence, in blocks of changing size */
+    class SequenceWriter  : public Thread
+    {
+    public:
+        SequenceWriter (LockFreeQueue <int>& queue_, const int numItems_, const bool inPlace_)
+            : Thread ("Queue writer"),
+              queue (queue_),
+              numItems (numItems_),
+              inPlace (inPlace_)
+        {
+        }
+
+        void run()
+        {
+            int next = 0, blockSize = 1;
+
+            while (next < numItems && ! threadShouldExit())
+            {
+                const int numWanted = jmin (blockSize, numItems - next);
+
+                if (inPlace)
+                {
+                    int *block1, *block2, size1, size2;
+                    const int numReady = queue.prepareToWrite (numWanted, block1, size1, block2, size2);
+
+                    for (int i = 0; i < size1; ++i)
+                        block1 [i] = next++;
+
+                    for (int i = 0; i < size2; ++i)
+                        block2 [i] = next++;
+
+                    queue.finishedWrite (numReady);
+                }
+                else
+                {
+                    int block [64];
+
+                    for (int i = 0; i < numWanted; ++i)
+                        block [i] = next + i;
+
+                    next += queue.push (block, numWanted);
+                }
+
+                if (queue.isFull())
+                    Thread::yield();
+
+                blockSize = (blockSize % 61) + 3;
+            }
+        }
+
+    private:
+        LockFreeQueue <int>& queue;
+        const int numItems;
+        const bool inPlace;
+    };
+
+    /** Pushes the item number of one producer, tagged with its id */
+    class TaggedWriter  : public Thread
+    {
+    public:
+        TaggedWriter (LockFreeMultiProducerQueue <int>& queue_, const int id_, const int numItems_)
+            : Thread ("Queue writer"),
+              queue (queue_),
+              id (id_),
+              numItems (numItems_)
+        {
+        }
+
+        void run()
+        {
+            int next = 0;
+
+            while (next < numItems && ! threadShouldExit())
+            {
+                // mix single items and blocks, so both paths race each other
+                if ((next & 7) == 0)
+                {
+                    if (queue.push ((id << 24) | next))
+                        ++next;
+                    else
+                        Thread::yield();
+                }
+                else
+                {
+                    int block [5];
+                    const int numWanted = jmin (5, numItems - next);
+
+                    for (int i = 0; i < numWanted; ++i)
+                        block [i] = (id << 24) | (next + i);
+
+                    const int numPushed = queue.push (block, numWanted);
+                    next += numPushed;
+
+                    if (numPushed == 0)
+                        Thread::yield();
+                }
+            }
+        }
+
+    private:
+        LockFreeMultiProducerQueue <int>& queue;
+        const int id, numItems;
+    };
+
+    struct Snapshot
+    {
+        int first, second, third;
+    };
+
+    /** Publishes snapshots whose fields always agree with each other */
+    class SnapshotWriter  : public Thread
+    {
+    public:
+        SnapshotWriter (TripleBuffer <Snapshot>& buffer_, const int numSnapshots_)
+            : Thread ("Snapshot writer"),
+              buffer (buffer_),
+              numSnapshots (numSnapshots_)
+        {
+        }
+
+        void run()
+        {
+            for (int i = 1; i <= numSnapshots && ! threadShouldExit(); ++i)
+            {
+                Snapshot& s = buffer.getWriteBuffer();
+                s.first = i;
+                s.second = i * 2;
+                s.third = i * 3;
+                buffer.publish();
+            }
+        }
+
+    private:
+        TripleBuffer <Snapshot>& buffer;
+        const int numSnapshots;
+    };
+}
+
+using namespace LockFreeQueueTestHelpers;
+
+
+//==============================================================================
+class LockFreeQueueTests  : public Test::Suite
+{
+public:
+    LockFreeQueueTests()
+    {
+        TEST_ADD (LockFreeQueueTests::capacityIsRoundedUp)
+        TEST_ADD (LockFreeQueueTests::singleItemsKeepTheirOrder)
+        TEST_ADD (LockFreeQueueTests::spansWrapAroundTheRing)
+        TEST_ADD (LockFreeQueueTests::blocksSurviveAConcurrentReader)
+        TEST_ADD (LockFreeQueueTests::inPlaceBlocksSurviveAConcurrentReader)
+        TEST_ADD (LockFreeQueueTests::multipleProducersKeepTheirOwnOrder)
+        TEST_ADD (LockFreeQueueTests::tripleBufferNeverTearsASnapshot)
+        TEST_ADD (LockFreeQueueTests::circularBufferKeepsTheTailOfLongBlocks)
+    }
+
+private:
+    void capacityIsRoundedUp()
+    {
+        LockFreeQueue <int> queue (1000);
+        TEST_ASSERT (queue.getCapacity() == 1024);
+        TEST_ASSERT (queue.isEmpty());
+
+        int pushed = 0;
+        while (queue.push (pushed))
+            ++pushed;
+
+        TEST_ASSERT (pushed == 1024);
+        TEST_ASSERT (queue.isFull());
+        TEST_ASSERT (queue.getFreeSpace() == 0);
+    }
+
+    void singleItemsKeepTheirOrder()
+    {
+        LockFreeQueue <int> queue (8);
+        int value = -1;
+
+        TEST_ASSERT (! queue.pop (value));
+
+        // go round the ring a few times, so the positions wrap
+        for (int i = 0; i < 100; ++i)
+        {
+            TEST_ASSERT (queue.push (i));
+            TEST_ASSERT (queue.push (i + 1000));
+            TEST_ASSERT (queue.pop (value) && value == i);
+            TEST_ASSERT (queue.pop (value) && value == i + 1000);
+        }
+
+        TEST_ASSERT (queue.isEmpty());
+    }
+
+    void spansWrapAroundTheRing()
+    {
+        LockFreeQueue <int> queue (8);
+        int items [8] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+
+        TEST_ASSERT (queue.push (items, 6) == 6);
+        TEST_ASSERT (queue.pop (items, 5) == 5);
+
+        int *block1, *block2, size1, size2;
+        TEST_ASSERT (queue.prepareToWrite (7, block1, size1, block2, size2) == 7);
+        TEST_ASSERT (size1 == 2 && size2 == 5);
+        TEST_ASSERT (block2 < block1);
+        queue.finishedWrite (0);
+
+        // a full block doesn't fit anymore, it's trimmed to the free space
+        TEST_ASSERT (queue.push (items, 8) == 7);
+        TEST_ASSERT (queue.getNumReady() == 8);
+
+        TEST_ASSERT (queue.prepareToRead (8, block1, size1, block2, size2) == 8);
+        TEST_ASSERT (size1 == 3 && size2 == 5);
+        TEST_ASSERT (block1 [0] == 5 && block1 [1] == 0 && block2 [4] == 6);
+        queue.finishedRead (8);
+
+        TEST_ASSERT (queue.isEmpty());
+    }
+
+    void checkSequence (const bool inPlace)
+    {
+        const int numItems = 1000000;
+        LockFreeQueue <int> queue (1000);
+        SequenceWriter writer (queue, numItems, inPlace);
+        writer.startThread();
+
+        int expected = 0, numWrong = 0, blockSize = 13;
+        const uint32 timeout = Time::getMillisecondCounter() + 30000;
+
+        while (expected < numItems && Time::getMillisecondCounter() < timeout)
+        {
+            int *block1, *block2, size1, size2;
+            const int numRead = queue.prepareToRead (blockSize, block1, size1, block2, size2);
+
+            for (int i = 0; i < size1; ++i)
+                numWrong += (block1 [i] != expected++) ? 1 : 0;
+
+            for (int i = 0; i < size2; ++i)
+                numWrong += (block2 [i] != expected++) ? 1 : 0;
+
+            queue.finishedRead (numRead);
+            blockSize = (blockSize % 47) + 5;
+
+            if (numRead == 0)
+                Thread::yield();
+        }
+
+        writer.stopThread (1000);
+
+        TEST_ASSERT (expected == numItems);
+        TEST_ASSERT (numWrong == 0);
+    }
+
+    void blocksSurviveAConcurrentReader()
+    {
+        checkSequence (false);
+    }
+
+    void inPlaceBlocksSurviveAConcurrentReader()
+    {
+        checkSequence (true);
+    }
+
+    void multipleProducersKeepTheirOwnOrder()
+    {
+        const int numWriters = 4, numItemsEach = 250000;
+        LockFreeMultiProducerQueue <int> queue (256);
+
+        OwnedArray <TaggedWriter> writers;
+        for (int i = 0; i < numWriters; ++i)
+            writers.add (new TaggedWriter (queue, i, numItemsEach));
+
+        for (int i = 0; i < numWriters; ++i)
+            writers[i]->startThread();
+
+        int last [numWriters] = { -1, -1, -1, -1 };
+        int numRead = 0, numWrong = 0;
+        const uint32 timeout = Time::getMillisecondCounter() + 30000;
+
+        while (numRead < numWriters * numItemsEach && Time::getMillisecondCounter() < timeout)
+        {
+            int block [13];
+            const int n = queue.pop (block, 13);
+
+            for (int i = 0; i < n; ++i)
+            {
+                const int id = block [i] >> 24;
+                const int value = block [i] & 0xffffff;
+
+                if (id < 0 || id >= numWriters || value != last [id] + 1)
+                    ++numWrong;
+                else
+                    last [id] = value;
+            }
+
+            numRead += n;
+
+            if (n == 0)
+                Thread::yield();
+        }
+
+        for (int i = 0; i < numWriters; ++i)
+            writers[i]->stopThread (1000);
+
+        TEST_ASSERT (numRead == numWriters * numItemsEach);
+        TEST_ASSERT (numWrong == 0);
+        TEST_ASSERT (queue.isEmpty());
+    }
+
+    void tripleBufferNeverTearsASnapshot()
+    {
+        const int numSnapshots = 200000;
+        TripleBuffer <Snapshot> buffer;
+        SnapshotWriter writer (buffer, numSnapshots);
+        writer.startThread();
+
+        int lastSeen = 0, numTorn = 0, numBackwards = 0;
+        const uint32 timeout = Time::getMillisecondCounter() + 30000;
+
+        while (lastSeen < numSnapshots && Time::getMillisecondCounter() < timeout)
+        {
+            Snapshot s;
+
+            if (buffer.read (s))
+            {
+                numTorn += (s.second != s.first * 2 || s.third != s.first * 3) ? 1 : 0;
+                numBackwards += (s.first < lastSeen) ? 1 : 0;
+                lastSeen = s.first;
+            }
+            else
+            {
+                Thread::yield();
+            }
+        }
+
+        writer.stopThread (1000);
+
+        TEST_ASSERT (lastSeen == numSnapshots);
+        TEST_ASSERT (numTorn == 0);
+        TEST_ASSERT (numBackwards == 0);
+
+        Snapshot s;
+        TEST_ASSERT (! buffer.read (s));
+    }
+
+    void circularBufferKeepsTheTailOfLongBlocks()
+    {
+        CircularBuffer <float> buffer (5);
+        float block [9] = { 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+
+        buffer.put (block, 9);
+        TEST_ASSERT (buffer.get (0) == 9.0f);
+        TEST_ASSERT (buffer.get (4) == 5.0f);
+
+        float last [5];
+        buffer.getLast (last, 5);
+        TEST_ASSERT (last [0] == 5.0f && last [4] == 9.0f);
+
+        buffer.put (10.0f);
+        TEST_ASSERT (buffer.get (0) == 10.0f && buffer.get (4) == 6.0f);
+    }
+};
+
+
+//==============================================================================
+class LockFreeQueueBenchmarks  : public Test::Suite
+{
+public:
+    LockFreeQueueBenchmarks()
+    {
+        TEST_ADD (LockFreeQueueBenchmarks::singleProducerThroughput)
+        TEST_ADD (LockFreeQueueBenchmarks::multiProducerThroughput)
+    }
+
+private:
+    void singleProducerThroughput()
+    {
+        const int numItems = 20000000;
+
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            LockFreeQueue <int> queue (4096);
+            SequenceWriter writer (queue, numItems, pass != 0);
+
+            const double start = getBenchmarkTime();
+            writer.startThread();
+
+            int numRead = 0, block [64];
+            while (numRead < numItems)
+            {
+                const int n = queue.pop (block, 64);
+                numRead += n;
+
+                if (n == 0)
+                    Thread::yield();
+            }
+
+            const double elapsed = getBenchmarkTime() - start;
+            writer.stopThread (1000);
+
+            printBenchmarkResult (pass == 0 ? "spsc push/pop blocks" : "spsc in place blocks",
+                                  elapsed, numItems, "items");
+            TEST_ASSERT (numRead == numItems);
+        }
+    }
+
+    void multiProducerThroughput()
+    {
+        const int numWriters = 4, numItemsEach = 2000000;
+        LockFreeMultiProducerQueue <int> queue (4096);
+
+        OwnedArray <TaggedWriter> writers;
+        for (int i = 0; i < numWriters; ++i)
+            writers.add (new TaggedWriter (queue, i, numItemsEach));
+
+        const double start = getBenchmarkTime();
+
+        for (int i = 0; i < numWriters; ++i)
+            writers[i]->startThread();
+
+        int numRead = 0, block [64];
+        while (numRead < numWriters * numItemsEach)
+        {
+            const int n = queue.pop (block, 64);
+            numRead += n;
+
+            if (n == 0)
+                Thread::yield();
+        }
+
+        const double elapsed = getBenchmarkTime() - start;
+
+        for (int i = 0; i < numWriters; ++i)
+            writers[i]->stopThread (1000);
+
+        printBenchmarkResult ("mpsc 4 producers", elapsed, numRead, "items");
+        TEST_ASSERT (numRead == numWriters * numItemsEach);
+    }
+};
+
+
+//==============================================================================
+Test::Suite* createLockFreeQueueTests()
+{
+    return new LockFreeQueueTests();
+}
+
+Test::Suite* createLockFreeQueueBenchmarks()
+{
+    return new LockFreeQueueBenchmarks();
+}
@@ -0,0 +1,255 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2009 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU General Public License, as published by the Free Software Foundation;
+ either version 2 of the License, or (at your option) any later version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+
+#include "../TestsHeader.h"
+
+
+//==============================================================================
+namespace PropertySetTestHelpers
+{
+    /** The names of the properties every jive plugin keeps */
+    static const tchar* const pluginKeyNames[] =
+    {
+        T("wOpen"), T("wPage"), T("wXpos"), T("wYpos"), T("wWsize"), T("wHsize"), T("wMidiKey"),
+        T("gLock"), T("gColour"), T("gSel"), T("gXpos"), T("gYpos"), T("gWsize"), T("gHsize"),
+        T("gInstanceName"), T("pPdir"), T("mLbl"), T("mIdx"), T("mNrw"), T("mPeak"), T("mMon"),
+        T("wPreferGeneric"), T("renderStem"), T("inputFiltChan"), T("outputFiltChan")
+    };
+
+    static const int numPluginKeys = numElementsInArray (pluginKeyNames);
+}
+
+using namespace PropertySetTestHelpers;
+
+
+//==============================================================================
+class PropertySetTests  : public Test::Suite
+{
+public:
+    PropertySetTests()
+    {
+        TEST_ADD (PropertySetTests::stringAndInternedKeysFindTheSameValues)
+        TEST_ADD (PropertySetTests::keysCanIgnoreTheirCase)
+        TEST_ADD (PropertySetTests::directEditsAreNoticed)
+        TEST_ADD (PropertySetTests::manyKeysGrowTheIndex)
+        TEST_ADD (PropertySetTests::fallbackIsUsedForMissingKeys)
+    }
+
+private:
+    void stringAndInternedKeysFindTheSameValues()
+    {
+        PropertySet set (false);
+        const PropertyKey xpos (T("gXpos")), name (T("gInstanceName")), gain (T("gain")), locked (T("gLock"));
+
+        set.setValue (T("gXpos"), 120);
+        set.setValue (name, T("Synth"));
+        set.setValue (gain, 0.5);
+        set.setValue (locked, true);
+
+        TEST_ASSERT (set.getIntValue (xpos) == 120);
+        TEST_ASSERT (set.getIntValue (T("gXpos")) == 120);
+        TEST_ASSERT (set.getValue (T("gInstanceName")) == T("Synth"));
+        TEST_ASSERT (set.getDoubleValue (T("gain")) == 0.5);
+        TEST_ASSERT (set.getBoolValue (T("gLock")));
+        TEST_ASSERT (set.getBoolValue (locked));
+
+        // the cached numbers follow the value whichever way it's changed
+        set.setValue (T("gXpos"), T("64"));
+        TEST_ASSERT (set.getIntValue (xpos) == 64);
+        TEST_ASSERT (set.getDoubleValue (xpos) == 64.0);
+
+        set.removeValue (xpos);
+        TEST_ASSERT (! set.containsKey (T("gXpos")));
+        TEST_ASSERT (set.getIntValue (xpos, -1) == -1);
+        TEST_ASSERT (set.getValue (name) == T("Synth"));
+
+        // a key that's different only by its case is a different key here
+        TEST_ASSERT (! set.containsKey (T("GAIN")));
+        TEST_ASSERT (! set.containsKey (PropertyKey (T("GAIN"))));
+    }
+
+    void keysCanIgnoreTheirCase()
+    {
+        PropertySet set (true);
+
+        set.setValue (T("Volume"), 3);
+        set.setValue (PropertyKey (T("VOLUME")), 4);
+
+        TEST_ASSERT (set.getAllProperties().size() == 1);
+        TEST_ASSERT (set.getIntValue (T("volume")) == 4);
+        TEST_ASSERT (set.getIntValue (PropertyKey (T("vOlUmE"))) == 4);
+        TEST_ASSERT (PropertyKey::hashName (T("Volume"), true) == PropertyKey::hashName (T("vOLUME"), true));
+    }
+
+    void directEditsAreNoticed()
+    {
+        PropertySet set (false);
+        const PropertyKey first (T("first")), second (T("second")), third (T("third"));
+
+        set.setValue (first, 1);
+        set.setValue (second, 2);
+        set.setValue (third, 3);
+        TEST_ASSERT (set.getIntValue (third) == 3);
+
+        StringPairArray& all = set.getAllProperties();
+
+        // removing the first one moves the others down, the index must not point past the end
+        all.remove (0);
+        TEST_ASSERT (set.getIntValue (third, -1) == 3);
+        TEST_ASSERT (set.getIntValue (first, -1) == -1);
+
+        // changed and added through the array, after the index has been rebuilt
+        all.set (T("second"), T("20"));
+        all.set (T("fourth"), T("4"));
+        TEST_ASSERT (set.getIntValue (second) == 20);
+        TEST_ASSERT (set.getIntValue (T("fourth")) == 4);
+
+        all.clear();
+        TEST_ASSERT (! set.containsKey (second));
+    }
+
+    void manyKeysGrowTheIndex()
+    {
+        PropertySet set (false);
+
+        for (int i = 0; i < 2000; ++i)
+            set.setValue (T("key") + String (i), i);
+
+        bool allFound = true;
+
+        for (int i = 0; i < 2000; ++i)
+            allFound = allFound && set.getIntValue (T("key") + String (i), -1) == i;
+
+        TEST_ASSERT (allFound);
+
+        for (int i = 0; i < 2000; i += 2)
+            set.removeValue (T("key") + String (i));
+
+        for (int i = 0; i < 2000; ++i)
+            allFound = allFound && set.getIntValue (T("key") + String (i), -1) == ((i & 1) != 0 ? i : -1);
+
+        TEST_ASSERT (allFound);
+    }
+
+    void fallbackIsUsedForMissingKeys()
+    {
+        PropertySet defaults (false), set (false);
+        const PropertyKey colour (T("gColour"));
+
+        defaults.setValue (colour, T("0xff808080"));
+        set.setFallbackPropertySet (&defaults);
+
+        TEST_ASSERT (set.getValue (colour) == T("0xff808080"));
+        TEST_ASSERT (set.getValue (T("gColour")) == T("0xff808080"));
+
+        set.setValue (colour, T("0xff000000"));
+        TEST_ASSERT (set.getValue (colour) == T("0xff000000"));
+    }
+};
+
+
+//==============================================================================
+class PropertySetBenchmarks  : public Test::Suite
+{
+public:
+    PropertySetBenchmarks()
+    {
+        TEST_ADD (PropertySetBenchmarks::pluginPropertyLookups)
+    }
+
+private:
+    enum { numPasses = 40000 };
+
+    void pluginPropertyLookups()
+    {
+        PropertySet set (false);
+        StringPairArray plain (false);
+        OwnedArray <PropertyKey> keys;
+        StringArray names;
+
+        for (int i = 0; i < numPluginKeys; ++i)
+        {
+            names.add (pluginKeyNames [i]);
+            keys.add (new PropertyKey (pluginKeyNames [i]));
+            set.setValue (names [i], i);
+            plain.set (names [i], String (i));
+        }
+
+        const double numLookups = (double) numPasses * numPluginKeys;
+        int total = 0;
+
+        // what a lookup used to cost: a linear search of the keys, then parsing the value
+        double start = getBenchmarkTime();
+
+        for (int n = 0; n < numPasses; ++n)
+            for (int i = 0; i < numPluginKeys; ++i)
+                total += plain.getValue (names [i], String::empty).getIntValue();
+
+        const double plainTime = getBenchmarkTime() - start;
+        start = getBenchmarkTime();
+
+        for (int n = 0; n < numPasses; ++n)
+            for (int i = 0; i < numPluginKeys; ++i)
+                total += set.getIntValue (names [i]);
+
+        const double stringKeyTime = getBenchmarkTime() - start;
+        start = getBenchmarkTime();
+
+        for (int n = 0; n < numPasses; ++n)
+            for (int i = 0; i < numPluginKeys; ++i)
+                total += set.getIntValue (*keys.getUnchecked (i));
+
+        const double internedKeyTime = getBenchmarkTime() - start;
+        start = getBenchmarkTime();
+
+        for (int n = 0; n < numPasses; ++n)
+            for (int i = 0; i < numPluginKeys; ++i)
+                set.setValue (*keys.getUnchecked (i), n + i);
+
+        const double setTime = getBenchmarkTime() - start;
+
+        TEST_ASSERT (total != 0);
+
+        printBenchmarkResult ("StringPairArray search + parse (25 keys)", plainTime, numLookups, "lookups");
+        printBenchmarkResult ("PropertySet getIntValue, String key", stringKeyTime, numLookups, "lookups");
+        printBenchmarkResult ("PropertySet getIntValue, PropertyKey", internedKeyTime, numLookups, "lookups");
+        printBenchmarkResult ("PropertySet setValue (int), PropertyKey", setTime, numLookups, "changes");
+    }
+};
+
+
+//==============================================================================
+Test::Suite* createPropertySetTests()
+{
+    return new PropertySetTests();
+}
+
+Test::Suite* createPropertySetBenchmarks()
+{
+    return new PropertySetBenchmarks();
+}
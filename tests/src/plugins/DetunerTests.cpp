@@ -0,0 +1,330 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2009 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU General Public License, as published by the Free Software Foundation;
+ either version 2 of the License, or (at your option) any later version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+
+
+#include "../TestsHeader.h"
+
+BEGIN_JUCE_NAMESPACE
+#include "extended/audio/processors/jucetice_VectorOps.h"
+#include "extended/audio/processors/jucetice_ParameterRamp.h"
+#include "../../../apps/jive/src/model/plugins/effects/DetunerKernel.h"
+END_JUCE_NAMESPACE
+
+#include <math.h>
+
+
+//==============================================================================
+namespace DetunerTestHelpers
+{
+    enum { sampleRate = 44100, numSamples = 65536, hostBlockSize = 300, bufferLength = 4096 };
+
+    /** The Detuner as it was before it worked a block at a time, one stereo
+        frame at a time with the coefficients worked out by recalc()
+    */
+    class PerSampleDetuner
+    {
+    public:
+        PerSampleDetuner (const float* parameters)
+            : buflen (0), pos0 (0), pos1 (0.0f), pos2 (0.0f)
+        {
+            zeromem (buf, sizeof (buf));
+
+            semi = 3.0f * parameters[0] * parameters[0] * parameters[0];
+            dpos2 = (float)pow(1.0594631f, semi);
+            dpos1 = 1.0f / dpos2;
+
+            wet = (float)pow(10.0f, 2.0f * parameters[2] - 1.0f);
+            dry = wet - wet * parameters[1] * parameters[1];
+            wet = (wet + wet - wet * parameters[1]) * parameters[1];
+
+            int tmp = 1 << (8 + (int)(4.9f * parameters[3]));
+
+            if(tmp!=buflen) //recalculate crossfade window
+            {
+              buflen = tmp;
+
+              int i; //hanning half-overlap-and-add
+              double p=0.0, dp=6.28318530718/buflen;
+              for(i=0;i<buflen;i++) { win[i] = (float)(0.5 - 0.5 * cos(p)); p+=dp; }
+            }
+        }
+
+        void process (float** channels, int sampleFrames)
+        {
+          float *in1 = channels [0];
+          float *in2 = channels [1];
+          float *out1 = channels [0];
+          float *out2 = channels [1];
+          float a, b, c, d;
+          float x, w=wet, y=dry, p1=pos1, p1f, d1=dpos1;
+          float                  p2=pos2,      d2=dpos2;
+          int  p0=pos0, p1i, p2i;
+          int  l=buflen-1, lh=buflen>>1;
+          float lf = (float)buflen;
+
+          --in1;
+          --in2;
+          --out1;
+          --out2;
+          while(--sampleFrames >= 0)
+          {
+            a = *++in1;
+            b = *++in2;
+
+            c = y * a;
+            d = y * b;
+
+            --p0 &= l;
+            *(buf + p0) = w * (a + b);      //input
+
+            p1 -= d1;
+            if(p1<0.0f) p1 += lf;           //output
+            p1i = (int)p1;
+            p1f = p1 - (float)p1i;
+            a = *(buf + p1i);
+            ++p1i &= l;
+            a += p1f * (*(buf + p1i) - a);  //linear interpolation
+
+            p2i = (p1i + lh) & l;           //180-degree ouptut
+            b = *(buf + p2i);
+            ++p2i &= l;
+            b += p1f * (*(buf + p2i) - b);  //linear interpolation
+
+            p2i = (p1i - p0) & l;           //crossfade
+            x = *(win + p2i);
+            c += b + x * (a - b);
+
+            p2 -= d2;  //repeat for downwards shift - can't see a more efficient way?
+            if(p2<0.0f) p2 += lf;           //output
+            p1i = (int)p2;
+            p1f = p2 - (float)p1i;
+            a = *(buf + p1i);
+            ++p1i &= l;
+            a += p1f * (*(buf + p1i) - a);  //linear interpolation
+
+            p2i = (p1i + lh) & l;           //180-degree ouptut
+            b = *(buf + p2i);
+            ++p2i &= l;
+            b += p1f * (*(buf + p2i) - b);  //linear interpolation
+
+            p2i = (p1i - p0) & l;           //crossfade
+            x = *(win + p2i);
+            d += b + x * (a - b);
+
+            *++out1 = c;
+            *++out2 = d;
+          }
+          pos0=p0; pos1=p1; pos2=p2;
+        }
+
+    private:
+        float buf [bufferLength], win [bufferLength];
+        int  buflen;
+        float semi;
+        int  pos0;
+        float pos1, dpos1;
+        float pos2, dpos2;
+        float wet, dry;
+    };
+
+    /** fine, mix, output and chunk: the middle of everything, a big detune
+        in short chunks, and a small one mostly wet in the longest chunks
+    */
+    static const float parameterSets[][4] =
+    {
+        { 0.5f, 0.5f, 0.5f, 0.5f },
+        { 0.9f, 0.3f, 0.6f, 0.1f },
+        { 0.2f, 0.8f, 0.4f, 1.0f }
+    };
+
+    static void prepareKernel (DetunerKernel& kernel, const float* parameters)
+    {
+        kernel.prepare (sampleRate);
+        kernel.setParameters (parameters[0], parameters[1], parameters[2], parameters[3]);
+        kernel.skipRamps();
+    }
+
+    static void fillInput (float** channels, const int total)
+    {
+        for (int i = 0; i < total; ++i)
+        {
+            channels [0][i] = 0.8f * sinf (i * 0.01f) * sinf (i * 0.0001f);
+            channels [1][i] = 0.7f * sinf (i * 0.013f + 1.0f);
+        }
+    }
+
+    /** Runs stereo channels through a detuner in place, in the blocks a host would use */
+    static void process (PerSampleDetuner& detuner, float** channels, const int total)
+    {
+        for (int pos = 0; pos < total; pos += hostBlockSize)
+        {
+            float* chunk[] = { channels [0] + pos, channels [1] + pos };
+            detuner.process (chunk, jmin ((int) hostBlockSize, total - pos));
+        }
+    }
+
+    static void process (DetunerKernel& kernel, float** channels, const int total)
+    {
+        for (int pos = 0; pos < total; pos += hostBlockSize)
+        {
+            float* chunk[] = { channels [0] + pos, channels [1] + pos };
+            kernel.process (chunk, chunk, 2, jmin ((int) hostBlockSize, total - pos));
+        }
+    }
+}
+
+using namespace DetunerTestHelpers;
+
+
+//==============================================================================
+class DetunerTests  : public Test::Suite
+{
+public:
+    DetunerTests()
+    {
+        TEST_ADD (DetunerTests::kernelMatchesPerSampleDetuner)
+        TEST_ADD (DetunerTests::processingDoesNotAllocate)
+    }
+
+private:
+    void kernelMatchesPerSampleDetuner()
+    {
+        HeapBlock <float> expectedLeft (numSamples), expectedRight (numSamples), left (numSamples), right (numSamples);
+        float* expected[] = { expectedLeft, expectedRight };
+        float* channels[] = { left, right };
+
+        for (int set = 0; set < numElementsInArray (parameterSets); ++set)
+        {
+            ScopedPointer <PerSampleDetuner> reference (new PerSampleDetuner (parameterSets [set]));
+            DetunerKernel kernel (2);
+            prepareKernel (kernel, parameterSets [set]);
+
+            fillInput (expected, numSamples);
+            fillInput (channels, numSamples);
+
+            process (*reference, expected, numSamples);
+            process (kernel, channels, numSamples);
+
+            // with the parameters held still, splitting the loop doesn't change a bit
+            TEST_ASSERT_MSG (memcmp (left, expectedLeft, sizeof (float) * numSamples) == 0
+                              && memcmp (right, expectedRight, sizeof (float) * numSamples) == 0,
+                             (const char*) ("parameter set " + String (set)));
+        }
+    }
+
+    void processingDoesNotAllocate()
+    {
+        if (! canCountAllocations())
+            return;
+
+        DetunerKernel kernel (2);
+        prepareKernel (kernel, parameterSets [0]);
+
+        HeapBlock <float> left (numSamples), right (numSamples);
+        float* channels[] = { left, right };
+        fillInput (channels, numSamples);
+
+        const int allocationsBefore = getNumAllocations();
+
+        process (kernel, channels, numSamples);
+        prepareKernel (kernel, parameterSets [1]);
+        kernel.reset();
+        process (kernel, channels, numSamples);
+
+        TEST_ASSERT (getNumAllocations() == allocationsBefore);
+    }
+};
+
+
+//==============================================================================
+class DetunerBenchmarks  : public Test::Suite
+{
+public:
+    DetunerBenchmarks()
+    {
+        TEST_ADD (DetunerBenchmarks::perSampleAgainstKernel)
+    }
+
+private:
+    enum { total = 1 << 18, numPasses = 10 };
+
+    /** Times a few seconds of music-like input, streamed through like a track */
+    template <class DetunerType>
+    static double timeDetuner (DetunerType& detuner, float** channels)
+    {
+        double elapsed = 0;
+
+        for (int n = 0; n < numPasses; ++n)
+        {
+            fillInput (channels, total);
+
+            const double start = getBenchmarkTime();
+            process (detuner, channels, total);
+            elapsed += getBenchmarkTime() - start;
+        }
+
+        return elapsed;
+    }
+
+    void perSampleAgainstKernel()
+    {
+        HeapBlock <float> left (total), right (total);
+        float* channels[] = { left, right };
+
+        double perSampleTime = 0, kernelTime = 0;
+
+        // best of a few interleaved runs, so the two see the same machine
+        for (int run = 0; run < 3; ++run)
+        {
+            ScopedPointer <PerSampleDetuner> reference (new PerSampleDetuner (parameterSets [0]));
+            DetunerKernel kernel (2);
+            prepareKernel (kernel, parameterSets [0]);
+
+            const double t1 = timeDetuner (*reference, channels);
+            const double t2 = timeDetuner (kernel, channels);
+
+            perSampleTime = (run == 0) ? t1 : jmin (perSampleTime, t1);
+            kernelTime = (run == 0) ? t2 : jmin (kernelTime, t2);
+        }
+
+        printBenchmarkResult ("detuner, per sample", perSampleTime, (double) numPasses * total, "frames");
+        printBenchmarkResult ("detuner, kernel", kernelTime, (double) numPasses * total, "frames");
+    }
+};
+
+
+//==============================================================================
+Test::Suite* createDetunerTests()
+{
+    return new DetunerTests();
+}
+
+Test::Suite* createDetunerBenchmarks()
+{
+    return new DetunerBenchmarks();
+}
@@ -0,0 +1,202 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2009 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU General Public License, as published by the Free Software Foundation;
+ either version 2 of the License, or (at your option) any later version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+
+
+#include "../TestsHeader.h"
+
+BEGIN_JUCE_NAMESPACE
+#include "../../../plugins/distressor/src/DistressorKernel.h"
+END_JUCE_NAMESPACE
+
+#include <math.h>
+
+
+//==============================================================================
+namespace DistressorTestHelpers
+{
+    enum { numSamples = 44100, lookahead = 66 };
+
+    /** The test signals, all of them going above the limit */
+    static float getSample (const int i, const int kind)
+    {
+        switch (kind)
+        {
+            case 0:  return (i > 10000 ? 0.9f : 0.2f) * sinf (i * 0.05f);                // a sine that jumps up
+            case 1:  return 0.95f * expf (-(i % 3000) * 0.0005f) * ((i & 1) ? 1.0f : -1.0f); // decaying, at nyquist
+            case 2:  return (i % 2000) == 0 ? 1.0f : 0.6f * expf (-(i % 2000) * 0.002f);   // clicks on a decay
+            default: return 0.9f * expf (-(i % 5000) * 0.0003f);                        // slow decays
+        }
+    }
+
+    static const int numKinds = 4;
+
+    /** Sets up a kernel as the plugin does, with only the limiter working */
+    static void prepareLimiter (DistressorKernel& kernel, const int numChannels, const float limit)
+    {
+        kernel.setCoefficients (1.0f, 0.0f, 1.0f, 0.01f, 0.0001f, limit, 1);
+        kernel.prepare (numChannels, lookahead);
+    }
+
+    /** Runs channels through a kernel in blocks of a given size */
+    static void process (DistressorKernel& kernel, float** channels, const int numChannels,
+                         const int total, const int blockSize)
+    {
+        float* chunk [8];
+
+        for (int pos = 0; pos < total; pos += blockSize)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+                chunk [ch] = channels [ch] + pos;
+
+            kernel.process (chunk, numChannels, jmin (blockSize, total - pos));
+        }
+    }
+}
+
+using namespace DistressorTestHelpers;
+
+
+//==============================================================================
+class DistressorTests  : public Test::Suite
+{
+public:
+    DistressorTests()
+    {
+        TEST_ADD (DistressorTests::limiterHoldsTheCeiling)
+        TEST_ADD (DistressorTests::quietAudioIsOnlyDelayed)
+        TEST_ADD (DistressorTests::blockSizeDoesNotChangeTheOutput)
+        TEST_ADD (DistressorTests::processingDoesNotAllocate)
+    }
+
+private:
+    void limiterHoldsTheCeiling()
+    {
+        for (int kind = 0; kind < numKinds; ++kind)
+        {
+            DistressorKernel kernel;
+            prepareLimiter (kernel, 2, 0.5f);
+
+            HeapBlock <float> left (numSamples), right (numSamples);
+            float* channels[] = { left, right };
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                left [i] = getSample (i, kind);
+                right [i] = -0.8f * left [i];
+            }
+
+            process (kernel, channels, 2, numSamples, DistressorKernel::maxBlockSize);
+
+            float peak = 0.0f;
+            for (int i = 0; i < numSamples; ++i)
+                peak = jmax (peak, fabsf (left [i]), fabsf (right [i]));
+
+            TEST_ASSERT_MSG (peak <= 0.5f * 1.00001f, (const char*) ("signal " + String (kind) + ", peak " + String (peak, 6)));
+        }
+    }
+
+    void quietAudioIsOnlyDelayed()
+    {
+        DistressorKernel kernel;
+        prepareLimiter (kernel, 1, 0.5f);
+
+        HeapBlock <float> input (4096), output (4096);
+        float* channels[] = { output };
+
+        for (int i = 0; i < 4096; ++i)
+            input [i] = output [i] = 0.3f * sinf (i * 0.05f);
+
+        process (kernel, channels, 1, 4096, 100);
+
+        TEST_ASSERT (kernel.getLookahead() == lookahead);
+
+        double maxError = 0.0;
+        for (int i = 0; i < lookahead; ++i)
+            maxError = jmax (maxError, (double) fabsf (output [i]));
+
+        for (int i = lookahead; i < 4096; ++i)
+            maxError = jmax (maxError, (double) fabsf (output [i] - input [i - lookahead]));
+
+        TEST_ASSERT_MSG (maxError < 1.0e-6, (const char*) ("error " + String (maxError)));
+    }
+
+    void blockSizeDoesNotChangeTheOutput()
+    {
+        DistressorKernel whole, small;
+        prepareLimiter (whole, 1, 0.5f);
+        prepareLimiter (small, 1, 0.5f);
+
+        HeapBlock <float> a (numSamples), b (numSamples);
+        float* channelA[] = { a };
+        float* channelB[] = { b };
+
+        for (int i = 0; i < numSamples; ++i)
+            a [i] = b [i] = getSample (i, 2);
+
+        process (whole, channelA, 1, numSamples, DistressorKernel::maxBlockSize);
+        process (small, channelB, 1, numSamples, 31);
+
+        // the sum of the gains is rebuilt at the end of each block, which
+        // changes the rounding a little
+        double maxError = 0.0;
+        for (int i = 0; i < numSamples; ++i)
+            maxError = jmax (maxError, (double) fabsf (a [i] - b [i]));
+
+        TEST_ASSERT_MSG (maxError < 1.0e-6, (const char*) ("error " + String (maxError)));
+    }
+
+    void processingDoesNotAllocate()
+    {
+        if (! canCountAllocations())
+            return;
+
+        DistressorKernel kernel;
+        prepareLimiter (kernel, 2, 0.5f);
+
+        HeapBlock <float> left (numSamples), right (numSamples);
+        float* channels[] = { left, right };
+
+        for (int i = 0; i < numSamples; ++i)
+            left [i] = right [i] = getSample (i, 0);
+
+        const int allocationsBefore = getNumAllocations();
+
+        process (kernel, channels, 2, numSamples, DistressorKernel::maxBlockSize);
+        kernel.setCoefficients (0.1f, 2.0f, 1.5f, 0.05f, 0.001f, 0.0f, 0);
+        process (kernel, channels, 2, numSamples, 64);
+
+        TEST_ASSERT (getNumAllocations() == allocationsBefore);
+    }
+};
+
+
+//==============================================================================
+Test::Suite* createDistressorTests()
+{
+    return new DistressorTests();
+}
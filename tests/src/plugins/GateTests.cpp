@@ -0,0 +1,341 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2009 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU General Public License, as published by the Free Software Foundation;
+ either version 2 of the License, or (at your option) any later version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+
+#include "../TestsHeader.h"
+
+BEGIN_JUCE_NAMESPACE
+#include "../../../plugins/gate/src/GateKernel.h"
+END_JUCE_NAMESPACE
+
+#include <math.h>
+#include <stdlib.h>
+
+
+//==============================================================================
+namespace GateTestHelpers
+{
+    enum { sampleRate = 44100, attackSamples = 200, decaySamples = 5000 };
+
+    /** The gate as it was before it worked a block at a time, one sample at
+        a time with the tick worked out for each of them
+    */
+    class PerSampleGate
+    {
+    public:
+        PerSampleGate()
+            : prevBeat (-1)
+        {
+            zeromem (&adsrState, sizeof (adsrState));
+        }
+
+        void process (float** channels, const int numChannels, const int numSamples,
+                      const bool rolling, double ppqPosition, const double beatsPerSample,
+                      const int numerator, const int denominator, const double ticksPerBar,
+                      const float noise)
+        {
+            double tick = 0;
+
+            for (int sample = 0; sample < numSamples; ++sample)
+            {
+                if (rolling)
+                {
+                    const int ppqPerBar = (numerator * 4 / denominator);
+                    const double beats = (ppqPosition / ppqPerBar) * numerator;
+                    tick = (int) ((beats / ppqPerBar) * ticksPerBar);
+
+                    if (prevBeat != tick)
+                        adsr_trigger (&adsrState, attackSamples, decaySamples, 0, 0);
+                }
+
+                adsr_process (&adsrState);
+
+                for (int channel = 0; channel < numChannels; ++channel)
+                {
+                    float* sampleData = channels [channel];
+                    sampleData [sample] = adsrState.env * ((0.5 - rand() / (float) RAND_MAX) * noise
+                                                            + sampleData [sample] * (1.0 - noise) / 2.0);
+                }
+
+                ppqPosition += beatsPerSample;
+                prevBeat = rolling ? tick : -1;
+            }
+        }
+
+    private:
+        adsr_t adsrState;
+        double prevBeat;
+    };
+
+    /** How the transport moves while a test runs */
+    struct Song
+    {
+        double bpm, startPpq, ticksPerBar;
+        int numerator, denominator;
+        int stopStart, stopEnd;  // the transport is stopped for the blocks starting in this range
+
+        double getBeatsPerSample() const    { return (1.0 / sampleRate) * (60.0 / bpm); }
+        bool isRolling (const int pos) const { return pos < stopStart || pos >= stopEnd; }
+    };
+
+    static void fillInput (float** channels, const int numChannels, const int numSamples)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < numSamples; ++i)
+                channels [ch][i] = sinf (i * 0.01f * (ch + 1));
+    }
+
+    /** Runs a gate over some channels in blocks, as the plugin's host would */
+    template <class GateType>
+    static void processSong (GateType& gate, float** channels, const int numChannels,
+                             const int total, const int blockSize, const Song& song)
+    {
+        float* chunk [8];
+
+        for (int pos = 0; pos < total; pos += blockSize)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+                chunk [ch] = channels [ch] + pos;
+
+            const bool rolling = song.isRolling (pos);
+            const double ppq = rolling ? song.startPpq + pos * song.getBeatsPerSample() : 0.0;
+
+            process (gate, chunk, numChannels, jmin (blockSize, total - pos), rolling, ppq, song);
+        }
+    }
+
+    static void process (PerSampleGate& gate, float** channels, const int numChannels, const int numSamples,
+                         const bool rolling, const double ppq, const Song& song)
+    {
+        gate.process (channels, numChannels, numSamples, rolling, ppq, rolling ? song.getBeatsPerSample() : 0.0,
+                      song.numerator, song.denominator, song.ticksPerBar, 0.0f);
+    }
+
+    static void process (GateKernel& gate, float** channels, const int numChannels, const int numSamples,
+                         const bool rolling, const double ppq, const Song& song)
+    {
+        gate.process (channels, numChannels, numSamples, rolling, ppq, rolling ? song.getBeatsPerSample() : 0.0,
+                      song.numerator, song.denominator, song.ticksPerBar,
+                      attackSamples, decaySamples, 0.0f, 0.5f);
+    }
+}
+
+using namespace GateTestHelpers;
+
+
+//==============================================================================
+class GateTests  : public Test::Suite
+{
+public:
+    GateTests()
+    {
+        TEST_ADD (GateTests::outputMatchesPerSampleGate)
+        TEST_ADD (GateTests::stoppingLetsTheEnvelopeRunOut)
+        TEST_ADD (GateTests::oddTimeSignaturesAreSafe)
+        TEST_ADD (GateTests::processingDoesNotAllocate)
+    }
+
+private:
+    void outputMatchesPerSampleGate()
+    {
+        const int numSamples = sampleRate * 10;
+        const int blockSizes[] = { 64, 256, 1024, 1000 };
+
+        const Song songs[] =
+        {
+            { 120.0, 0.0, 16.0, 4, 4, numSamples, numSamples },
+            { 123.0, -0.3, 16.0, 4, 4, numSamples, numSamples },
+            { 97.0, 5.25, 12.0, 3, 4, numSamples, numSamples },
+            { 140.0, 1.0, 24.0, 6, 8, sampleRate * 3, sampleRate * 5 }
+        };
+
+        HeapBlock <float> a0 (numSamples), a1 (numSamples), b0 (numSamples), b1 (numSamples);
+        float* expected[] = { a0, a1 };
+        float* actual[] = { b0, b1 };
+
+        for (int s = 0; s < numElementsInArray (songs); ++s)
+        {
+            for (int b = 0; b < numElementsInArray (blockSizes); ++b)
+            {
+                fillInput (expected, 2, numSamples);
+                fillInput (actual, 2, numSamples);
+
+                PerSampleGate reference;
+                GateKernel kernel (1);
+
+                processSong (reference, expected, 2, numSamples, blockSizes [b], songs [s]);
+                processSong (kernel, actual, 2, numSamples, blockSizes [b], songs [s]);
+
+                // the envelope segments are summed as series rather than step by step, so
+                // the rounding differs by around 1e-5; a trigger a sample late is off by 4e-3
+                double maxError = 0.0;
+                for (int ch = 0; ch < 2; ++ch)
+                    for (int i = 0; i < numSamples; ++i)
+                        maxError = jmax (maxError, (double) fabsf (expected [ch][i] - actual [ch][i]));
+
+                TEST_ASSERT_MSG (maxError < 1.0e-4, (const char*) ("song " + String (s) + ", block " + String (blockSizes [b])
+                                                                    + ", error " + String (maxError)));
+            }
+        }
+    }
+
+    void stoppingLetsTheEnvelopeRunOut()
+    {
+        const Song song = { 120.0, 0.0, 4.0, 4, 4, 0, 0 };
+        HeapBlock <float> data (256);
+        float* channels[] = { data };
+
+        GateKernel kernel (1);
+        TEST_ASSERT (! kernel.isGateOpen());
+
+        zeromem (data, sizeof (float) * 256);
+        process (kernel, channels, 1, 256, true, 0.0, song);
+        TEST_ASSERT (kernel.isGateOpen());
+
+        // with the transport stopped nothing triggers, the decay just carries on
+        for (int i = 0; i < 400; ++i)
+        {
+            for (int j = 0; j < 256; ++j)
+                data [j] = 1.0f;
+
+            process (kernel, channels, 1, 256, false, 0.0, song);
+        }
+
+        TEST_ASSERT (data [255] < 1.0e-6f);
+
+        // starting again at the same place triggers it again
+        for (int j = 0; j < 256; ++j)
+            data [j] = 1.0f;
+
+        process (kernel, channels, 1, 256, true, 0.0, song);
+        TEST_ASSERT (data [255] > 0.1f);
+    }
+
+    void oddTimeSignaturesAreSafe()
+    {
+        // a numerator smaller than a quarter of the denominator used to make the bar zero long
+        TEST_ASSERT (GateKernel::ppqToTick (3.0, 1, 8, 16.0) == 48.0);
+        TEST_ASSERT (GateKernel::ppqToTick (0.5, 4, 0, 16.0) == GateKernel::ppqToTick (0.5, 4, 1, 16.0));
+
+        const Song song = { 120.0, 0.0, 16.0, 1, 8, 0, 0 };
+        HeapBlock <float> data (1024);
+        float* channels[] = { data };
+
+        fillInput (channels, 1, 1024);
+
+        GateKernel kernel (1);
+        process (kernel, channels, 1, 1024, true, 0.0, song);
+
+        for (int i = 0; i < 1024; ++i)
+            TEST_ASSERT (fabsf (data [i]) <= 1.0f);
+    }
+
+    void processingDoesNotAllocate()
+    {
+        if (! canCountAllocations())
+            return;
+
+        const int numSamples = sampleRate;
+        const Song song = { 120.0, 0.0, 16.0, 4, 4, sampleRate / 2, sampleRate / 2 + 4096 };
+
+        HeapBlock <float> left (numSamples), right (numSamples);
+        float* channels[] = { left, right };
+        fillInput (channels, 2, numSamples);
+
+        GateKernel kernel (1);
+        const int allocationsBefore = getNumAllocations();
+
+        processSong (kernel, channels, 2, numSamples, 1024, song);
+
+        TEST_ASSERT (getNumAllocations() == allocationsBefore);
+    }
+};
+
+
+//==============================================================================
+class GateBenchmarks  : public Test::Suite
+{
+public:
+    GateBenchmarks()
+    {
+        TEST_ADD (GateBenchmarks::gateBlocks)
+    }
+
+private:
+    template <class GateType>
+    static double timeGate (GateType& gate, float** channels, const int numSamples, const int blockSize, const Song& song)
+    {
+        const double start = getBenchmarkTime();
+        processSong (gate, channels, 2, numSamples, blockSize, song);
+        return getBenchmarkTime() - start;
+    }
+
+    void gateBlocks()
+    {
+        const int numSamples = sampleRate * 20;
+        const int blockSizes[] = { 64, 256, 1024 };
+        const Song song = { 123.0, 0.0, 16.0, 4, 4, numSamples, numSamples };
+
+        HeapBlock <float> left (numSamples), right (numSamples);
+        float* channels[] = { left, right };
+
+        for (int b = 0; b < numElementsInArray (blockSizes); ++b)
+        {
+            double perSampleTime = 0, kernelTime = 0;
+
+            // best of a few interleaved runs, so the two see the same machine
+            for (int run = 0; run < 3; ++run)
+            {
+                PerSampleGate reference;
+                GateKernel kernel (1);
+
+                fillInput (channels, 2, numSamples);
+                const double t1 = timeGate (reference, channels, numSamples, blockSizes [b], song);
+                fillInput (channels, 2, numSamples);
+                const double t2 = timeGate (kernel, channels, numSamples, blockSizes [b], song);
+
+                perSampleTime = (run == 0) ? t1 : jmin (perSampleTime, t1);
+                kernelTime = (run == 0) ? t2 : jmin (kernelTime, t2);
+            }
+
+            printBenchmarkResult ("gate, per sample, blocks of " + String (blockSizes [b]), perSampleTime, numSamples, "frames");
+            printBenchmarkResult ("gate, kernel, blocks of " + String (blockSizes [b]), kernelTime, numSamples, "frames");
+        }
+    }
+};
+
+
+//==============================================================================
+Test::Suite* createGateTests()
+{
+    return new GateTests();
+}
+
+Test::Suite* createGateBenchmarks()
+{
+    return new GateBenchmarks();
+}
@@ -0,0 +1,429 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2009 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU General Public License, as published by the Free Software Foundation;
+ either version 2 of the License, or (at your option) any later version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+
+#include "../TestsHeader.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+// the sizes HighLife builds its effects with, see Highlife.h
+#define MAX_DEL_SIZE        65536
+#define MAX_CHO_SIZE        4096
+
+#include "../../../plugins/lowlife/src/highlife/Highlife/HighLifeLfo.h"
+#include "../../../plugins/lowlife/src/highlife/Highlife/HighLifeFx.h"
+
+
+//==============================================================================
+namespace HighLifeFxTestHelpers
+{
+    enum { sampleRate = 44100 };
+
+    /** Freeverb as it was before it worked by blocks: every comb and allpass
+        run for each sample, through the filters' own process() calls
+    */
+    class PerSampleReverb
+    {
+    public:
+        PerSampleReverb (const float roomSize, const float damp, const float width)
+        {
+            const int combSizes[] = { combtuningL1, combtuningL2, combtuningL3, combtuningL4,
+                                      combtuningL5, combtuningL6, combtuningL7, combtuningL8 };
+            const int allpassSizes[] = { allpasstuningL1, allpasstuningL2, allpasstuningL3, allpasstuningL4 };
+
+            for (int i = 0; i < numcombs; ++i)
+            {
+                setUp (combL [i], combBuffers [i * 2], combSizes [i]);
+                setUp (combR [i], combBuffers [i * 2 + 1], combSizes [i] + stereospread);
+            }
+
+            for (int i = 0; i < numallpasses; ++i)
+            {
+                allpassBuffers [i * 2].calloc (allpassSizes [i]);
+                allpassBuffers [i * 2 + 1].calloc (allpassSizes [i] + stereospread);
+                allpassL [i].setbuffer (allpassBuffers [i * 2], allpassSizes [i]);
+                allpassR [i].setbuffer (allpassBuffers [i * 2 + 1], allpassSizes [i] + stereospread);
+                allpassL [i].setfeedback (0.5f);
+                allpassR [i].setfeedback (0.5f);
+            }
+
+            for (int i = 0; i < numcombs; ++i)
+            {
+                combL [i].setfeedback (roomSize * scaleroom + offsetroom);
+                combR [i].setfeedback (roomSize * scaleroom + offsetroom);
+                combL [i].setdamp (damp * scaledamp);
+                combR [i].setdamp (damp * scaledamp);
+            }
+
+            const float wet = 1.0f * scalewet;
+            wet1 = wet * (width / 2 + 0.5f);
+            wet2 = wet * ((1 - width) / 2);
+        }
+
+        void process (const float* inputL, const float* inputR, float* outputL, float* outputR, const int numSamples)
+        {
+            for (int s = 0; s < numSamples; ++s)
+            {
+                float outL = 0, outR = 0;
+                const float input = (inputL [s] + inputR [s]) * fixedgain;
+
+                for (int i = 0; i < numcombs; ++i)
+                {
+                    outL += combL [i].process (input);
+                    outR += combR [i].process (input);
+                }
+
+                for (int i = 0; i < numallpasses; ++i)
+                {
+                    outL = allpassL [i].process (outL);
+                    outR = allpassR [i].process (outR);
+                }
+
+                outputL [s] = outL * wet1 + outR * wet2;
+                outputR [s] = outR * wet1 + outL * wet2;
+            }
+        }
+
+    private:
+        static void setUp (comb& filter, HeapBlock <float>& buffer, const int size)
+        {
+            buffer.calloc (size);
+            filter.setbuffer (buffer, size);
+        }
+
+        comb combL [numcombs], combR [numcombs];
+        allpass allpassL [numallpasses], allpassR [numallpasses];
+        HeapBlock <float> combBuffers [numcombs * 2], allpassBuffers [numallpasses * 2];
+        float wet1, wet2;
+    };
+
+    /** Notes with silence between them, like a send bus gets */
+    static void fillBursts (float* left, float* right, const int numSamples, const int period, const int length)
+    {
+        srand (1);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            left [i] = (i % period < length) ? (rand() / (float) RAND_MAX - 0.5f) : 0.0f;
+            right [i] = left [i] * 0.5f + ((i % period < length) ? 0.1f * sinf (i * 0.01f) : 0.0f);
+        }
+    }
+
+    static bool isDenormal (const float f)
+    {
+        return f != 0.0f && fabsf (f) < 1.17549435e-38f;
+    }
+}
+
+using namespace HighLifeFxTestHelpers;
+
+
+//==============================================================================
+class HighLifeFxTests  : public Test::Suite
+{
+public:
+    HighLifeFxTests()
+    {
+        TEST_ADD (HighLifeFxTests::reverbMatchesPerSampleFreeverb)
+        TEST_ADD (HighLifeFxTests::reverbTailDoesNotGoDenormal)
+        TEST_ADD (HighLifeFxTests::sendStopsAfterTheTail)
+        TEST_ADD (HighLifeFxTests::reverbTailFitsItsEstimate)
+    }
+
+private:
+    void reverbMatchesPerSampleFreeverb()
+    {
+        const int numSamples = sampleRate * 5;
+        const int blockSizes[] = { 64, 256, 1000, 1024 };
+
+        HeapBlock <float> inL (numSamples), inR (numSamples), expectedL (numSamples), expectedR (numSamples),
+                          actualL (numSamples), actualR (numSamples);
+
+        fillBursts (inL, inR, numSamples, 20000, 3000);
+
+        for (int b = 0; b < numElementsInArray (blockSizes); ++b)
+        {
+            PerSampleReverb* const reference = new PerSampleReverb (0.8f, 0.3f, 0.7f);
+            revmodel* const reverb = new revmodel();
+            reverb->setroomsize (0.8f);
+            reverb->setdamp (0.3f);
+            reverb->setwidth (0.7f);
+            reverb->setwet (1.0f);
+
+            for (int pos = 0; pos < numSamples; pos += blockSizes [b])
+            {
+                const int num = jmin (blockSizes [b], numSamples - pos);
+                reference->process (inL + pos, inR + pos, expectedL + pos, expectedR + pos, num);
+                reverb->processreplace (inL + pos, inR + pos, actualL + pos, actualR + pos, num, 1, 0.0f, 1.0f);
+            }
+
+            delete reference;
+            delete reverb;
+
+            // the combs are summed across the lanes in a different order,
+            // so only the last bits differ
+            double maxError = 0.0, peak = 0.0;
+            for (int i = 0; i < numSamples; ++i)
+            {
+                maxError = jmax (maxError, (double) fabsf (expectedL [i] - actualL [i]), (double) fabsf (expectedR [i] - actualR [i]));
+                peak = jmax (peak, (double) fabsf (expectedL [i]));
+            }
+
+            TEST_ASSERT (peak > 0.1);
+            TEST_ASSERT_MSG (maxError < peak * 1.0e-5, (const char*) ("block " + String (blockSizes [b]) + ", error "
+                                                                      + String (maxError) + " at peak " + String (peak)));
+        }
+    }
+
+    void reverbTailDoesNotGoDenormal()
+    {
+        // a small room fades fast, so its tail gets to the denormals in a few seconds
+        revmodel* const reverb = new revmodel();
+        reverb->setroomsize (0.0f);
+        reverb->setdamp (0.0f);
+        reverb->setwet (1.0f);
+
+        float left [256], right [256];
+        int numDenormals = 0;
+
+        for (int block = 0; block < sampleRate * 20 / 256; ++block)
+        {
+            for (int i = 0; i < 256; ++i)
+                left [i] = right [i] = (block == 0 && i == 0) ? 1.0f : 0.0f;
+
+            reverb->processreplace (left, right, left, right, 256, 1, 0.0f, 1.0f);
+
+            for (int i = 0; i < 256; ++i)
+                numDenormals += (isDenormal (left [i]) ? 1 : 0) + (isDenormal (right [i]) ? 1 : 0);
+        }
+
+        delete reverb;
+
+        TEST_ASSERT_MSG (numDenormals == 0, (const char*) (String (numDenormals) + " denormal samples"));
+    }
+
+    void sendStopsAfterTheTail()
+    {
+        const int tail = 1000;
+        float buffer [64], silence [64];
+
+        for (int i = 0; i < 64; ++i)
+        {
+            buffer [i] = (i == 10) ? 0.5f : 0.0f;
+            silence [i] = 0.0f;
+        }
+
+        CFxSend send;
+        TEST_ASSERT (send.update (buffer, silence, 64, tail));
+
+        // it carries on for the tail, at most a block over
+        int numSamples = 0;
+        while (send.update (silence, silence, 64, tail) && numSamples < tail * 2)
+            numSamples += 64;
+
+        TEST_ASSERT (numSamples >= tail && numSamples <= tail + 64);
+        TEST_ASSERT (! send.update (silence, silence, 64, tail));
+
+        // something quiet but not silent wakes it up
+        buffer [10] = FX_SILENCE * 2;
+        TEST_ASSERT (send.update (silence, buffer, 64, tail));
+
+        // and the feedback really is under the silence level after the tail
+        const float feedback = 0.9f;
+        const int delay = 100;
+        TEST_ASSERT (powf (feedback, (float) (fx_get_tail_samples ((float) delay, feedback) / delay - 1)) < FX_SILENCE);
+    }
+
+    void reverbTailFitsItsEstimate()
+    {
+        const float roomSizes[] = { 0.0f, 0.5f, 1.0f };
+
+        for (int r = 0; r < numElementsInArray (roomSizes); ++r)
+        {
+            CFxReverb* const reverb = new CFxReverb();
+            CFxSend send;
+
+            const int tail = reverb->GetTailSamples (roomSizes [r]);
+            float left [256], right [256];
+            float lastPeak = 1.0f;
+
+            for (int block = 0; block < 4000; ++block)
+            {
+                for (int i = 0; i < 256; ++i)
+                    left [i] = right [i] = (block < 4) ? 0.5f * sinf (i * 0.1f) : 0.0f;
+
+                if (! send.update (left, right, 256, tail))
+                    break;
+
+                reverb->ProcessBuffer (left, right, 256, roomSizes [r], 1.0f, 0.0f);
+
+                lastPeak = 0.0f;
+                for (int i = 0; i < 256; ++i)
+                    lastPeak = jmax (lastPeak, fabsf (left [i]), fabsf (right [i]));
+            }
+
+            delete reverb;
+
+            // by the time the send is skipped its output has gone quiet
+            TEST_ASSERT_MSG (lastPeak < 1.0e-4f, (const char*) ("room " + String (roomSizes [r]) + ", last peak " + String (lastPeak)));
+        }
+    }
+};
+
+
+//==============================================================================
+class HighLifeFxBenchmarks  : public Test::Suite
+{
+public:
+    HighLifeFxBenchmarks()
+    {
+        TEST_ADD (HighLifeFxBenchmarks::reverbBlocks)
+        TEST_ADD (HighLifeFxBenchmarks::sendBus)
+    }
+
+private:
+    void reverbBlocks()
+    {
+        const int numSamples = sampleRate * 10;
+        const int blockSizes[] = { 64, 256, 1024 };
+
+        HeapBlock <float> inL (numSamples), inR (numSamples), outL (numSamples), outR (numSamples);
+        fillBursts (inL, inR, numSamples, 20000, 3000);
+
+        for (int b = 0; b < numElementsInArray (blockSizes); ++b)
+        {
+            double perSampleTime = 0, blockTime = 0;
+
+            // best of a few interleaved runs, so the two see the same machine
+            for (int run = 0; run < 3; ++run)
+            {
+                PerSampleReverb* const reference = new PerSampleReverb (0.8f, 0.3f, 1.0f);
+                revmodel* const reverb = new revmodel();
+                reverb->setroomsize (0.8f);
+                reverb->setdamp (0.3f);
+                reverb->setwet (1.0f);
+
+                double start = getBenchmarkTime();
+                for (int pos = 0; pos < numSamples; pos += blockSizes [b])
+                    reference->process (inL + pos, inR + pos, outL + pos, outR + pos, jmin (blockSizes [b], numSamples - pos));
+
+                const double t1 = getBenchmarkTime() - start;
+
+                start = getBenchmarkTime();
+                for (int pos = 0; pos < numSamples; pos += blockSizes [b])
+                    reverb->processreplace (inL + pos, inR + pos, outL + pos, outR + pos, jmin (blockSizes [b], numSamples - pos), 1, 0.0f, 1.0f);
+
+                const double t2 = getBenchmarkTime() - start;
+
+                perSampleTime = (run == 0) ? t1 : jmin (perSampleTime, t1);
+                blockTime = (run == 0) ? t2 : jmin (blockTime, t2);
+
+                delete reference;
+                delete reverb;
+            }
+
+            printBenchmarkResult ("freeverb, per sample, blocks of " + String (blockSizes [b]), perSampleTime, numSamples, "frames");
+            printBenchmarkResult ("freeverb, by blocks, blocks of " + String (blockSizes [b]), blockTime, numSamples, "frames");
+        }
+    }
+
+    /** A reverb and a delay send where the notes stop after two seconds, run
+        always (as before) and skipped once the sends are silent
+    */
+    double runSendBus (const int blockSize, const bool skipIdle)
+    {
+        const int numSamples = sampleRate * 20;
+        CFxReverb* const reverb = new CFxReverb();
+        CFxDelay* const delay = new CFxDelay();
+        CFxSend reverbSend, delaySend;
+
+        const int reverbTail = reverb->GetTailSamples (0.5f);
+        const int delayTail = delay->GetTailSamples (0.3f, 0.5f, 0, (float) sampleRate, 120.0f);
+
+        HeapBlock <float> revL (blockSize), revR (blockSize), delL (blockSize), delR (blockSize);
+        double total = 0;
+
+        for (int pos = 0; pos < numSamples; pos += blockSize)
+        {
+            for (int i = 0; i < blockSize; ++i)
+            {
+                const int n = pos + i;
+                revL [i] = delL [i] = (n < sampleRate * 2 && n % 11025 < 2000) ? 0.3f * sinf (n * 0.05f) : 0.0f;
+                revR [i] = delR [i] = revL [i] * 0.7f;
+            }
+
+            const double start = getBenchmarkTime();
+
+            if (! skipIdle || reverbSend.update (revL, revR, blockSize, reverbTail))
+                reverb->ProcessBuffer (revL, revR, blockSize, 0.5f, 1.0f, 0.3f);
+
+            if (! skipIdle || delaySend.update (delL, delR, blockSize, delayTail))
+                delay->ProcessBuffer (delL, delR, blockSize, 0.3f, 0.5f, 0, 0, (float) sampleRate, 120.0f);
+
+            total += getBenchmarkTime() - start;
+        }
+
+        delete reverb;
+        delete delay;
+        return total;
+    }
+
+    void sendBus()
+    {
+        const int blockSizes[] = { 64, 256, 1024 };
+
+        for (int b = 0; b < numElementsInArray (blockSizes); ++b)
+        {
+            double alwaysTime = 0, skippingTime = 0;
+
+            for (int run = 0; run < 3; ++run)
+            {
+                const double t1 = runSendBus (blockSizes [b], false);
+                const double t2 = runSendBus (blockSizes [b], true);
+
+                alwaysTime = (run == 0) ? t1 : jmin (alwaysTime, t1);
+                skippingTime = (run == 0) ? t2 : jmin (skippingTime, t2);
+            }
+
+            printBenchmarkResult ("send bus, always on, blocks of " + String (blockSizes [b]), alwaysTime, sampleRate * 20, "frames");
+            printBenchmarkResult ("send bus, idle skipped, blocks of " + String (blockSizes [b]), skippingTime, sampleRate * 20, "frames");
+        }
+    }
+};
+
+
+//==============================================================================
+Test::Suite* createHighLifeFxTests()
+{
+    return new HighLifeFxTests();
+}
+
+Test::Suite* createHighLifeFxBenchmarks()
+{
+    return new HighLifeFxBenchmarks();
+}
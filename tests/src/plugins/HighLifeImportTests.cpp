@@ -0,0 +1,449 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2009 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU General Public License, as published by the Free Software Foundation;
+ either version 2 of the License, or (at your option) any later version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+
+// the plugin's own config goes before juce, like in the plugin
+#include "../../../plugins/lowlife/src/highlife/Highlife/Highlife.h"
+#include "../TestsHeader.h"
+
+#include <math.h>
+
+
+//==============================================================================
+namespace HighLifeImportTestHelpers
+{
+    /** A bank written the way sampler libraries come: a 16 bit stereo wav at
+        44.1 kHz for each key and velocity layer, and the sfz mapping them.
+        It's deleted with the object.
+    */
+    class GeneratedBank
+    {
+    public:
+        GeneratedBank (const String& name, const int lowestKey_, const int highestKey_,
+                       const int numLayers_, const int numFrames)
+            : lowestKey (lowestKey_), highestKey (highestKey_), numLayers (numLayers_)
+        {
+            folder = File::getSpecialLocation (File::tempDirectory).getNonexistentChildFile (name, String::empty, false);
+            folder.createDirectory();
+
+            WavAudioFormat wav;
+            HeapBlock <int> left (numFrames), right (numFrames);
+            String sfz;
+
+            for (int key = lowestKey; key <= highestKey; ++key)
+            {
+                for (int layer = 0; layer < numLayers; ++layer)
+                {
+                    const String fileName (String (key) + "_" + String (layer) + ".wav");
+
+                    // a decaying tone, a little different for each region
+                    const double step = 440.0 * pow (2.0, (key - 69) / 12.0) * 2.0 * double_Pi / 44100.0;
+                    const double level = (layer + 1) / (double) numLayers;
+
+                    for (int i = 0; i < numFrames; ++i)
+                    {
+                        const double sample = level * exp (-3.0 * i / numFrames) * sin (i * step);
+                        left [i] = roundDoubleToInt (sample * 0x3fffffff);
+                        right [i] = -left [i];
+                    }
+
+                    AudioFormatWriter* const writer
+                        = wav.createWriterFor (folder.getChildFile (fileName).createOutputStream(), 44100.0, 2, 16, StringPairArray(), 0);
+
+                    const int* channels[] = { left, right, 0 };
+                    writer->write (channels, numFrames);
+                    delete writer;
+
+                    // the importer takes the rest of the line as the name, so the sample has one of its own
+                    sfz << "<region> lokey=" << key << " hikey=" << key
+                        << " lovel=" << (layer * 128 / numLayers) << " hivel=" << ((layer + 1) * 128 / numLayers - 1)
+                        << " pitch_keycenter=" << key << "\nsample=" << fileName << "\n";
+                }
+            }
+
+            file = folder.getChildFile (name + ".sfz");
+            file.replaceWithText (sfz);
+        }
+
+        ~GeneratedBank()
+        {
+            folder.deleteRecursively();
+        }
+
+        const File& getFile() const             { return file; }
+        int getNumRegions() const               { return (highestKey - lowestKey + 1) * numLayers; }
+
+        const int lowestKey, highestKey, numLayers;
+
+    private:
+        File folder, file;
+    };
+
+    /** An instance as a host would have it, set to a rate the waves get converted to */
+    static CHighLife* createInstance (const double sampleRate)
+    {
+        CHighLife* const instance = new CHighLife();
+        instance->setPlayConfigDetails (0, 2, sampleRate, 512);
+        return instance;
+    }
+
+    /** Imports a bank into the current program of an instance, on the loading
+        thread of the pool like the import menu does, and waits for its waves
+    */
+    static void importBank (CHighLife* const instance, const File& file)
+    {
+        instance->sample_pool->load_in_background (instance, file);
+        instance->sample_pool->wait_for_loads (instance);
+    }
+
+    static HIGHLIFE_PROGRAM& getProgram (CHighLife* const instance)
+    {
+        return instance->highlife_program [instance->user_program];
+    }
+
+    /** Returns the lowest key of the zone that would be decoded first, weighed like an import does */
+    static int getMostWantedKey (CHighLife* const instance)
+    {
+        float keyWeights [128];
+        instance->tool_weigh_keys (keyWeights);
+
+        const HIGHLIFE_PROGRAM& program = getProgram (instance);
+        int mostWanted = -1;
+        float highestPriority = -1.0f;
+
+        for (int z = 0; z < program.num_zones; ++z)
+        {
+            const float priority = instance->tool_get_zone_priority (&program.pzones [z], keyWeights);
+
+            if (priority > highestPriority)
+            {
+                highestPriority = priority;
+                mostWanted = program.pzones [z].lo_input_range.midi_key;
+            }
+        }
+
+        return mostWanted;
+    }
+}
+
+using namespace HighLifeImportTestHelpers;
+
+
+//==============================================================================
+class HighLifeImportTests  : public Test::Suite
+{
+public:
+    HighLifeImportTests()
+    {
+        TEST_ADD (HighLifeImportTests::importingTwiceAllocatesOnce)
+        TEST_ADD (HighLifeImportTests::otherRatesGetTheirOwnWaves)
+        TEST_ADD (HighLifeImportTests::missingSamplesLeaveTheirZonesEmpty)
+        TEST_ADD (HighLifeImportTests::playedKeysAreDecodedFirst)
+    }
+
+private:
+    void importingTwiceAllocatesOnce()
+    {
+        GeneratedBank bank ("highlife import", 48, 59, 2, 4000);
+
+        // held for the whole test, so the pool outlives the instances
+        CSamplePool* const pool = CSamplePool::attach();
+        const int allocationsBefore = pool->get_num_allocations();
+        const int decodesBefore = pool->get_num_decodes();
+
+        CHighLife* const first = createInstance (48000.0);
+        CHighLife* const second = createInstance (48000.0);
+
+        importBank (first, bank.getFile());
+
+        const HIGHLIFE_PROGRAM& a = getProgram (first);
+        TEST_ASSERT (a.num_zones == bank.getNumRegions());
+
+        bool allLoaded = true;
+        for (int z = 0; z < a.num_zones; ++z)
+            allLoaded = allLoaded && a.pzones [z].ppwavedata != 0
+                                  && a.pzones [z].num_channels == 2
+                                  && abs (a.pzones [z].num_samples - 4000 * 48000 / 44100) <= 1;
+
+        TEST_ASSERT (allLoaded);
+        TEST_ASSERT (pool->get_num_decodes() - decodesBefore == bank.getNumRegions());
+        TEST_ASSERT (pool->get_num_allocations() - allocationsBefore == bank.getNumRegions());
+        TEST_ASSERT (pool->get_num_waves() == bank.getNumRegions());
+
+        const int64 bytes = pool->get_num_bytes();
+
+        // the second instance only takes references to the waves of the first
+        importBank (second, bank.getFile());
+
+        const HIGHLIFE_PROGRAM& b = getProgram (second);
+        TEST_ASSERT (b.num_zones == a.num_zones);
+
+        bool allShared = true;
+        for (int z = 0; z < jmin (a.num_zones, b.num_zones); ++z)
+            allShared = allShared && b.pzones [z].ppwavedata == a.pzones [z].ppwavedata
+                                  && b.pzones [z].num_samples == a.pzones [z].num_samples;
+
+        // without decoding them again, or the pool would only drop the copies afterwards
+        TEST_ASSERT (allShared);
+        TEST_ASSERT (pool->get_num_decodes() - decodesBefore == bank.getNumRegions());
+        TEST_ASSERT (pool->get_num_allocations() - allocationsBefore == bank.getNumRegions());
+        TEST_ASSERT (pool->get_num_waves() == bank.getNumRegions());
+        TEST_ASSERT (pool->get_num_bytes() == bytes);
+
+        // so does the first one loading it again
+        importBank (first, bank.getFile());
+
+        TEST_ASSERT (getProgram (first).pzones [0].ppwavedata == b.pzones [0].ppwavedata);
+        TEST_ASSERT (pool->get_num_decodes() - decodesBefore == bank.getNumRegions());
+        TEST_ASSERT (pool->get_num_allocations() - allocationsBefore == bank.getNumRegions());
+
+        // the waves go with the last instance using them
+        delete first;
+        TEST_ASSERT (pool->get_num_waves() == bank.getNumRegions());
+
+        delete second;
+        TEST_ASSERT (pool->get_num_waves() == 0);
+        TEST_ASSERT (pool->get_num_bytes() == 0);
+
+        CSamplePool::detach();
+    }
+
+    void otherRatesGetTheirOwnWaves()
+    {
+        GeneratedBank bank ("highlife rates", 60, 63, 1, 2000);
+
+        CSamplePool* const pool = CSamplePool::attach();
+        const int allocationsBefore = pool->get_num_allocations();
+
+        CHighLife* const first = createInstance (48000.0);
+        CHighLife* const second = createInstance (96000.0);
+
+        importBank (first, bank.getFile());
+        importBank (second, bank.getFile());
+
+        // the waves are converted to the rate of the host, so they can't be shared across rates
+        TEST_ASSERT (getProgram (first).pzones [0].ppwavedata != getProgram (second).pzones [0].ppwavedata);
+        TEST_ASSERT (pool->get_num_allocations() - allocationsBefore == bank.getNumRegions() * 2);
+        TEST_ASSERT (pool->get_num_waves() == bank.getNumRegions() * 2);
+
+        delete first;
+        delete second;
+
+        TEST_ASSERT (pool->get_num_waves() == 0);
+        CSamplePool::detach();
+    }
+
+    void missingSamplesLeaveTheirZonesEmpty()
+    {
+        GeneratedBank bank ("highlife missing", 60, 63, 1, 2000);
+        bank.getFile().getSiblingFile ("61_0.wav").deleteFile();
+
+        CSamplePool* const pool = CSamplePool::attach();
+        CHighLife* const instance = createInstance (48000.0);
+
+        importBank (instance, bank.getFile());
+
+        // the zone keeps its place in the program, just without a wave
+        const HIGHLIFE_PROGRAM& program = getProgram (instance);
+        TEST_ASSERT (program.num_zones == bank.getNumRegions());
+
+        int numEmpty = 0;
+        for (int z = 0; z < program.num_zones; ++z)
+        {
+            if (program.pzones [z].ppwavedata == 0 && program.pzones [z].num_samples == 0)
+            {
+                TEST_ASSERT (program.pzones [z].lo_input_range.midi_key == 61);
+                ++numEmpty;
+            }
+        }
+
+        TEST_ASSERT (numEmpty == 1);
+        TEST_ASSERT (pool->get_num_waves() == bank.getNumRegions() - 1);
+
+        delete instance;
+        CSamplePool::detach();
+    }
+
+    void playedKeysAreDecodedFirst()
+    {
+        GeneratedBank bank ("highlife priority", 48, 72, 1, 100);
+
+        CHighLife* const instance = createInstance (48000.0);
+        importBank (instance, bank.getFile());
+
+        // nothing played yet, middle c goes first
+        TEST_ASSERT (getMostWantedKey (instance) == 60);
+
+        // then the keys played the most, and the ones around them
+        instance->user_keyb_plays [69] = 4;
+        TEST_ASSERT (getMostWantedKey (instance) == 69);
+
+        float keyWeights [128];
+        instance->tool_weigh_keys (keyWeights);
+        TEST_ASSERT (keyWeights [69] > keyWeights [68] && keyWeights [68] > keyWeights [48]);
+
+        delete instance;
+    }
+};
+
+
+//==============================================================================
+class HighLifeImportBenchmarks  : public Test::Suite
+{
+public:
+    HighLifeImportBenchmarks()
+    {
+        TEST_ADD (HighLifeImportBenchmarks::importLargeBank)
+    }
+
+private:
+    enum { lowestKey = 21, highestKey = 108, numLayers = 2, playedKey = 69, numFrames = 6000 };
+
+    /** Notes when all the zones of a key got their waves, as the pool reports each region done */
+    class KeyWatcher  : public CSamplePoolListener
+    {
+    public:
+        KeyWatcher (CHighLife* const instance_, const int key_)
+            : instance (instance_), key (key_), playableTime (0)
+        {
+        }
+
+        void sample_pool_progress (CSampleLoader* loader, const File&, const float)
+        {
+            if (loader != instance || playableTime > 0)
+                return;
+
+            int numZones = 0, numLoaded = 0;
+
+            instance->crs_lock();
+
+            const HIGHLIFE_PROGRAM& program = getProgram (instance);
+
+            for (int z = 0; z < program.num_zones; ++z)
+            {
+                const HIGHLIFE_ZONE& zone = program.pzones [z];
+
+                if (zone.lo_input_range.midi_key <= key && key <= zone.hi_input_range.midi_key)
+                {
+                    ++numZones;
+
+                    if (zone.num_samples > 0)
+                        ++numLoaded;
+                }
+            }
+
+            instance->crs_unlock();
+
+            if (numZones > 0 && numLoaded == numZones)
+                playableTime = Time::getMillisecondCounterHiRes();
+        }
+
+        CHighLife* const instance;
+        const int key;
+        double playableTime;
+    };
+
+    /** Imports the bank into a new instance, returning when a4 could be played and when the bank
+        was in, in seconds. With another instance holding the bank, the waves are only collected
+    */
+    void timeImport (const File& bank, const bool a4Played, const bool shared,
+                     double& playableTime, double& wholeTime)
+    {
+        CSamplePool* const pool = CSamplePool::attach();
+        CHighLife* const holder = shared ? createInstance (48000.0) : 0;
+
+        if (holder != 0)
+            importBank (holder, bank);
+
+        CHighLife* const instance = createInstance (48000.0);
+
+        if (a4Played)
+            instance->user_keyb_plays [playedKey] = 8;
+
+        KeyWatcher watcher (instance, playedKey);
+        pool->add_listener (&watcher);
+
+        const double start = Time::getMillisecondCounterHiRes();
+        importBank (instance, bank);
+        const double end = Time::getMillisecondCounterHiRes();
+
+        pool->remove_listener (&watcher);
+
+        playableTime = ((watcher.playableTime > 0 ? watcher.playableTime : end) - start) * 0.001;
+        wholeTime = (end - start) * 0.001;
+
+        delete instance;
+        delete holder;
+
+        TEST_ASSERT (pool->get_num_waves() == 0);
+        CSamplePool::detach();
+    }
+
+    void importLargeBank()
+    {
+        GeneratedBank bank ("highlife benchmark", lowestKey, highestKey, numLayers, numFrames);
+
+        const char* const names[] = { "nothing played", "a4 played", "shared with another instance" };
+        const bool a4Played[] = { false, true, false };
+        const bool shared[] = { false, false, true };
+        double bestPlayable [3], bestWhole [3], playable, whole;
+
+        // the first import warms the allocator and the file cache up, then the best of a few interleaved runs
+        timeImport (bank.getFile(), false, false, playable, whole);
+
+        for (int run = 0; run < 3; ++run)
+        {
+            for (int i = 0; i < 3; ++i)
+            {
+                timeImport (bank.getFile(), a4Played [i], shared [i], playable, whole);
+
+                bestPlayable [i] = (run == 0) ? playable : jmin (bestPlayable [i], playable);
+                bestWhole [i] = (run == 0) ? whole : jmin (bestWhole [i], whole);
+            }
+        }
+
+        printf ("\n  %d cpus, %d regions of %d frames from 44.1 to 48 kHz", SystemStats::getNumCpus(), bank.getNumRegions(), (int) numFrames);
+
+        for (int i = 0; i < 3; ++i)
+        {
+            printBenchmarkResult (String (names [i]) + ", a4 playable", bestPlayable [i], 1, "a4");
+            printBenchmarkResult (String (names [i]) + ", whole bank", bestWhole [i], bank.getNumRegions(), "regions");
+        }
+    }
+};
+
+
+//==============================================================================
+Test::Suite* createHighLifeImportTests()
+{
+    return new HighLifeImportTests();
+}
+
+Test::Suite* createHighLifeImportBenchmarks()
+{
+    return new HighLifeImportBenchmarks();
+}
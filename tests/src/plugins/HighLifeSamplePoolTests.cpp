@@ -0,0 +1,411 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2009 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU General Public License, as published by the Free Software Foundation;
+ either version 2 of the License, or (at your option) any later version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+
+#include "../TestsHeader.h"
+#include "../../../plugins/lowlife/src/highlife/Highlife/HighLifeSamplePool.h"
+#include "../../../plugins/lowlife/src/highlife/Highlife/HighLifeVoice.h"
+
+
+//==============================================================================
+namespace SamplePoolTestHelpers
+{
+    enum { numRegions = 200 };
+
+    static int numDecodes = 0;
+
+    /** Does what the importers do for a region: takes the wave from the pool,
+        or decodes it (here, makes it up) and publishes it
+    */
+    static float** loadRegion (CSamplePool* pool, const File& file, const int region)
+    {
+        const String key (CSamplePool::make_key (file, "sf2 " + String (region)));
+        int numChannels, numSamples, sampleRate;
+
+        float** wave = pool->acquire (key, numChannels, numSamples, sampleRate);
+
+        if (wave != 0)
+            return wave;
+
+        Atomic::increment (numDecodes);
+
+        numChannels = 2;
+        numSamples = 1000 + region;
+        sampleRate = 44100;
+
+        wave = new float* [numChannels];
+
+        for (int c = 0; c < numChannels; ++c)
+        {
+            wave [c] = new float [numSamples + WAVE_PAD * 2];
+
+            for (int s = 0; s < numSamples + WAVE_PAD * 2; ++s)
+                wave [c][s] = (float) region;
+        }
+
+        return pool->publish (key, wave, numChannels, numSamples, sampleRate);
+    }
+
+    static void deleteWave (float** wave, const int numChannels)
+    {
+        for (int c = 0; c < numChannels; ++c)
+            delete[] wave [c];
+
+        delete[] wave;
+    }
+
+    /** An instance loading a whole library on a thread of its own */
+    class LoadingThread  : public Thread
+    {
+    public:
+        LoadingThread (CSamplePool* pool_, const File& file_)
+            : Thread ("pool test"), pool (pool_), file (file_)
+        {
+        }
+
+        void run()
+        {
+            for (int r = 0; r < numRegions; ++r)
+                waves [r] = loadRegion (pool, file, r);
+        }
+
+        CSamplePool* pool;
+        File file;
+        float** waves [numRegions];
+    };
+
+    /** An instance importing a library on the loading thread of the pool */
+    class Loader  : public CSampleLoader
+    {
+    public:
+        Loader (CSamplePool* pool_) : pool (pool_), numRuns (0) {}
+
+        void sample_loader_run (const File& file)
+        {
+            for (int r = 0; r < numRegions; ++r)
+            {
+                waves.add (loadRegion (pool, file, r));
+                pool->report_progress (this, file, (r + 1) / (float) numRegions);
+            }
+
+            ++numRuns;
+        }
+
+        CSamplePool* pool;
+        Array <float**> waves;
+        int numRuns;
+    };
+
+    class ProgressListener  : public CSamplePoolListener
+    {
+    public:
+        ProgressListener() : numCalls (0), lastProgress (0) {}
+
+        void sample_pool_progress (CSampleLoader*, const File&, float const progress)
+        {
+            ++numCalls;
+            lastProgress = progress;
+        }
+
+        int numCalls;
+        float lastProgress;
+    };
+
+    /** A region decoded on the decoding threads, which remembers when it ran */
+    class Decoder  : public CSampleDecoder
+    {
+    public:
+        Decoder (int& numRuns_, int& runIndex_, const float priority_, const int sleepMs_, WaitableEvent& started_)
+            : numRuns (numRuns_), runIndex (runIndex_), sleepMs (sleepMs_), started (started_)
+        {
+            priority = priority_;
+        }
+
+        void sample_decoder_run()
+        {
+            started.signal();
+
+            if (sleepMs > 0)
+                Thread::sleep (sleepMs);
+
+            runIndex = Atomic::incrementAndReturn (numRuns) - 1;
+        }
+
+        int& numRuns;
+        int& runIndex;
+        const int sleepMs;
+        WaitableEvent& started;
+    };
+
+    /** Imports a library by handing its regions to the decoding threads */
+    class ParallelLoader  : public CSampleLoader
+    {
+    public:
+        ParallelLoader (CSamplePool* pool_, const int sleepMs_ = 0)
+            : pool (pool_), sleepMs (sleepMs_), numDecoded (0)
+        {
+        }
+
+        void sample_loader_run (const File& file)
+        {
+            OwnedArray <CSampleDecoder> decoders;
+
+            // one region is wanted more than all the others
+            for (int r = 0; r < numRegions; ++r)
+            {
+                runIndices [r] = -1;
+                decoders.add (new Decoder (numDecoded, runIndices [r], r == topRegion ? 100.0f : (float) (r % 7), sleepMs, started));
+            }
+
+            pool->decode_in_parallel (this, file, decoders);
+        }
+
+        enum { topRegion = 123 };
+
+        CSamplePool* pool;
+        const int sleepMs;
+        int numDecoded;
+        int runIndices [numRegions];
+        WaitableEvent started;
+    };
+}
+
+using namespace SamplePoolTestHelpers;
+
+
+//==============================================================================
+class HighLifeSamplePoolTests  : public Test::Suite
+{
+public:
+    HighLifeSamplePoolTests()
+    {
+        TEST_ADD (HighLifeSamplePoolTests::secondInstanceAllocatesNothing)
+        TEST_ADD (HighLifeSamplePoolTests::racingLoadsAllocateOnce)
+        TEST_ADD (HighLifeSamplePoolTests::unshareCopiesSharedWaves)
+        TEST_ADD (HighLifeSamplePoolTests::backgroundLoadsRunOnce)
+        TEST_ADD (HighLifeSamplePoolTests::regionsAreDecodedInParallel)
+        TEST_ADD (HighLifeSamplePoolTests::cancelStopsTheDecode)
+    }
+
+private:
+    void secondInstanceAllocatesNothing()
+    {
+        CSamplePool* const pool = CSamplePool::attach();
+        CSamplePool* const pool2 = CSamplePool::attach();
+        TEST_ASSERT (pool == pool2);
+
+        const File library ("/banks/piano.sf2");
+        float** first [numRegions];
+        float** second [numRegions];
+
+        numDecodes = 0;
+        const int allocationsBefore = pool->get_num_allocations();
+
+        for (int r = 0; r < numRegions; ++r)
+            first [r] = loadRegion (pool, library, r);
+
+        const int64 bytes = pool->get_num_bytes();
+
+        for (int r = 0; r < numRegions; ++r)
+            second [r] = loadRegion (pool2, library, r);
+
+        bool allShared = true;
+        for (int r = 0; r < numRegions; ++r)
+            allShared = allShared && (first [r] == second [r]);
+
+        TEST_ASSERT (allShared);
+        TEST_ASSERT (numDecodes == numRegions);
+        TEST_ASSERT (pool->get_num_allocations() - allocationsBefore == numRegions);
+        TEST_ASSERT (pool->get_num_bytes() == bytes);
+        TEST_ASSERT (bytes == numRegions * (int64) 2 * (1000 + WAVE_PAD * 2) * sizeof (float)
+                                + (int64) 2 * (numRegions * (numRegions - 1) / 2) * sizeof (float));
+
+        // a different file, or the same one changed since, is another wave
+        TEST_ASSERT (CSamplePool::make_key (library, "sf2 1") != CSamplePool::make_key (File ("/banks/organ.sf2"), "sf2 1"));
+
+        // the first instance going leaves the waves to the second, the last release frees them
+        for (int r = 0; r < numRegions; ++r)
+            TEST_ASSERT (pool->release (first [r]));
+
+        TEST_ASSERT (pool->get_num_waves() == numRegions);
+
+        for (int r = 0; r < numRegions; ++r)
+            TEST_ASSERT (pool->release (second [r]));
+
+        TEST_ASSERT (pool->get_num_waves() == 0);
+        TEST_ASSERT (pool->get_num_bytes() == 0);
+
+        CSamplePool::detach();
+        CSamplePool::detach();
+    }
+
+    void racingLoadsAllocateOnce()
+    {
+        CSamplePool* const pool = CSamplePool::attach();
+        const File library ("/banks/strings.sf2");
+
+        numDecodes = 0;
+        const int allocationsBefore = pool->get_num_allocations();
+
+        LoadingThread first (pool, library), second (pool, library);
+        first.startThread();
+        second.startThread();
+        first.waitForThreadToExit (-1);
+        second.waitForThreadToExit (-1);
+
+        bool allShared = true;
+        for (int r = 0; r < numRegions; ++r)
+            allShared = allShared && (first.waves [r] == second.waves [r]);
+
+        // both may have decoded a region, but only one copy gets kept
+        TEST_ASSERT (allShared);
+        TEST_ASSERT (pool->get_num_allocations() - allocationsBefore == numRegions);
+        TEST_ASSERT (pool->get_num_waves() == numRegions);
+
+        for (int r = 0; r < numRegions; ++r)
+        {
+            pool->release (first.waves [r]);
+            pool->release (second.waves [r]);
+        }
+
+        TEST_ASSERT (pool->get_num_waves() == 0);
+        CSamplePool::detach();
+    }
+
+    void unshareCopiesSharedWaves()
+    {
+        CSamplePool* const pool = CSamplePool::attach();
+        const File library ("/banks/piano.sf2");
+
+        float** const a = loadRegion (pool, library, 0);
+        float** const b = loadRegion (pool, library, 0);
+
+        // shared, so the editor gets a copy and the other zone keeps the original
+        float** const edited = pool->unshare (a, 2, 1000);
+        TEST_ASSERT (edited != a);
+        TEST_ASSERT (edited [1][WAVE_PAD] == 0.0f && edited [1][WAVE_PAD + 999] == 0.0f);
+
+        // on its own, it's taken over without a copy and leaves the pool
+        float** const sole = pool->unshare (b, 2, 1000);
+        TEST_ASSERT (sole == b);
+        TEST_ASSERT (! pool->release (sole));
+        TEST_ASSERT (pool->get_num_waves() == 0);
+
+        // something that was never in the pool is the caller's already
+        float** const own = pool->unshare (edited, 2, 1000);
+        TEST_ASSERT (own == edited);
+
+        deleteWave (edited, 2);
+        deleteWave (sole, 2);
+
+        CSamplePool::detach();
+    }
+
+    void backgroundLoadsRunOnce()
+    {
+        CSamplePool* const pool = CSamplePool::attach();
+        const File library ("/banks/drums.sf2");
+
+        Loader first (pool), second (pool);
+        ProgressListener listener;
+        pool->add_listener (&listener);
+
+        numDecodes = 0;
+        const int allocationsBefore = pool->get_num_allocations();
+
+        pool->load_in_background (&first, library);
+        pool->load_in_background (&second, library);
+        pool->wait_for_loads (&first);
+        pool->wait_for_loads (&second);
+
+        TEST_ASSERT (! pool->is_loading (&first) && ! pool->is_loading (&second));
+        TEST_ASSERT (first.numRuns == 1 && second.numRuns == 1);
+        TEST_ASSERT (numDecodes == numRegions);
+        TEST_ASSERT (pool->get_num_allocations() - allocationsBefore == numRegions);
+        TEST_ASSERT (listener.numCalls == (numRegions + 2) * 2); // the pool adds 0 and 1 around each load
+        TEST_ASSERT (listener.lastProgress == 1.0f);
+
+        pool->remove_listener (&listener);
+
+        for (int i = 0; i < first.waves.size(); ++i)
+        {
+            pool->release (first.waves [i]);
+            pool->release (second.waves [i]);
+        }
+
+        TEST_ASSERT (pool->get_num_waves() == 0);
+        CSamplePool::detach();
+    }
+
+    void regionsAreDecodedInParallel()
+    {
+        CSamplePool* const pool = CSamplePool::attach();
+        const File library ("/banks/choir.gig");
+
+        ParallelLoader loader (pool);
+        ProgressListener listener;
+        pool->add_listener (&listener);
+
+        pool->load_in_background (&loader, library);
+        pool->wait_for_loads (&loader);
+
+        TEST_ASSERT (loader.numDecoded == numRegions);
+        TEST_ASSERT (listener.numCalls > 0);
+        TEST_ASSERT (listener.lastProgress == 1.0f);
+
+        // the threads start on the most wanted regions
+        TEST_ASSERT (loader.runIndices [ParallelLoader::topRegion] >= 0
+                      && loader.runIndices [ParallelLoader::topRegion] < jmax (1, SystemStats::getNumCpus()));
+
+        pool->remove_listener (&listener);
+        CSamplePool::detach();
+    }
+
+    void cancelStopsTheDecode()
+    {
+        CSamplePool* const pool = CSamplePool::attach();
+
+        ParallelLoader loader (pool, 2);
+        pool->load_in_background (&loader, File ("/banks/choir.gig"));
+
+        // the regions take 2 ms each, so cancelling as the first starts leaves most of them
+        TEST_ASSERT (loader.started.wait (10000));
+        pool->cancel_loads (&loader);
+
+        TEST_ASSERT (! pool->is_loading (&loader));
+        TEST_ASSERT (loader.numDecoded > 0 && loader.numDecoded < numRegions);
+
+        CSamplePool::detach();
+    }
+};
+
+
+//==============================================================================
+Test::Suite* createHighLifeSamplePoolTests()
+{
+    return new HighLifeSamplePoolTests();
+}
@@ -0,0 +1,332 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2009 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU General Public License, as published by the Free Software Foundation;
+ either version 2 of the License, or (at your option) any later version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+
+
+#include "../TestsHeader.h"
+
+#if JUCE_INTEL && (JUCE_MSVC || defined (__SSE__))
+ #include <xmmintrin.h>
+#endif
+
+BEGIN_JUCE_NAMESPACE
+#include "extended/audio/processors/jucetice_VectorOps.h"
+#include "extended/audio/processors/jucetice_ParameterRamp.h"
+#include "extended/audio/resampler/jucetice_Oversampler.h"
+#include "../../../apps/jive/src/model/plugins/effects/OppressorKernel.h"
+END_JUCE_NAMESPACE
+
+#include <math.h>
+
+
+//==============================================================================
+namespace OppressorTestHelpers
+{
+    enum { sampleRate = 44100, numSamples = 65536, hostBlockSize = 300 };
+
+    /** The Oppressor as it was before it worked a block at a time, one stereo
+        frame at a time with the coefficients worked out by setParameter()
+    */
+    class PerSampleOppressor
+    {
+    public:
+        PerSampleOppressor (const float* parameters)
+            : env (0.0f), env2 (0.0f)
+        {
+            mode=0;
+            thr = (float)pow(10.f, 2.f * parameters[0] - 2.f);
+            rat = 2.5f * parameters[1] - 0.5f;
+            if(rat>1.0) { rat = 1.f + 16.f*(rat-1.f) * (rat - 1.f); mode = 1; }
+            if(rat<0.0) { rat = 0.6f*rat; mode=1; }
+            trim = (float)pow(10.f, 2.f * parameters[2]); //was  - 1.f);
+            att = (float)pow(10.f, -0.002f - 2.f * parameters[3]);
+            rel = (float)pow(10.f, -2.f - 3.f * parameters[4]);
+
+            if(parameters[5]>0.98)
+            {
+               lthr = 0.f; //limiter
+            }
+            else
+            {
+               lthr = 0.99f*(float)pow(10.0f,int(30.0*parameters[5] - 20.0)/20.f);
+               mode = 1;
+            }
+
+            if(rat<0.0f && thr<0.1f) rat *= thr*15.f;
+        }
+
+        void process (float** channels, int sampleFrames)
+        {
+            float *in1 = channels [0];
+            float *in2 = channels [1];
+            float *out1 = channels [0];
+            float *out2 = channels [1];
+
+            float a, b, i, j, g, e=env, e2=env2, ra=rat, re=(1.f-rel), at=att;
+            float tr=trim, th=thr, lth=lthr;
+
+            --in1;
+            --in2;
+            --out1;
+            --out2;
+
+            if(mode) //comp/gate/lim
+            {
+                if(lth==0.f) lth=1000.f;
+                while(--sampleFrames >= 0)
+                {
+                    a = *++in1;
+                    b = *++in2;
+
+                    i = (a<0.f)? -a : a;
+                    j = (b<0.f)? -b : b;
+                    i = (j>i)? j : i;
+
+                    e = (i>e)? e + at * (i - e) : e * re;
+                    e2 = (i>e)? i : e2 * re; //ir;
+
+                    g = (e>th)? tr / (1.f + ra * ((e/th) - 1.f)) : tr;
+
+                    if(g<0.f) g=0.f;
+                    if(g*e2>lth) g = lth/e2; //limit
+
+                    *++out1 = a * (g);
+                    *++out2 = b * (g);
+                }
+            }
+            else //compressor only
+            {
+                while(--sampleFrames >= 0)
+                {
+                    a = *++in1;
+                    b = *++in2;
+
+                    i = (a<0.f)? -a : a;
+                    j = (b<0.f)? -b : b;
+                    i = (j>i)? j : i; //get peak level
+
+                    e = (i>e)? e + at * (i - e) : e * re; //envelope
+                    g = (e>th)? tr / (1.f + ra * ((e/th) - 1.f)) : tr; //gain
+
+                    *++out1 = a * (g); //vca
+                    *++out2 = b * (g);
+                }
+            }
+
+            if(e <1.0e-10) env =0.f; else env =e;
+            if(e2<1.0e-10) env2=0.f; else env2=e2;
+        }
+
+    private:
+        float thr, rat, env, env2, att, rel, trim, lthr;
+        int mode;
+    };
+
+    /** thresh, ratio, level, attack, release and limiter: the compressor alone,
+        a steep ratio with the limiter, and a negative ratio gating the quiet parts
+    */
+    static const float parameterSets[][6] =
+    {
+        { 0.5f, 0.4f, 0.3f, 0.2f, 0.3f, 1.0f },
+        { 0.3f, 0.8f, 0.2f, 0.1f, 0.5f, 0.6f },
+        { 0.4f, 0.1f, 0.25f, 0.3f, 0.2f, 1.0f }
+    };
+
+    static void prepareKernel (OppressorKernel& kernel, const float* parameters, const int factor)
+    {
+        kernel.prepare (sampleRate, factor);
+        kernel.setParameters (parameters[0], parameters[1], parameters[2],
+                              parameters[3], parameters[4], parameters[5]);
+        kernel.skipRamps();
+    }
+
+    static void fillInput (float** channels, const int total)
+    {
+        for (int i = 0; i < total; ++i)
+        {
+            channels [0][i] = 0.8f * sinf (i * 0.01f) * sinf (i * 0.0001f);
+            channels [1][i] = 0.7f * sinf (i * 0.013f + 1.0f);
+        }
+    }
+
+    /** Runs stereo channels through a compressor in place, in the blocks a host would use */
+    static void process (PerSampleOppressor& oppressor, float** channels, const int total)
+    {
+        for (int pos = 0; pos < total; pos += hostBlockSize)
+        {
+            float* chunk[] = { channels [0] + pos, channels [1] + pos };
+            oppressor.process (chunk, jmin ((int) hostBlockSize, total - pos));
+        }
+    }
+
+    static void process (OppressorKernel& kernel, float** channels, const int total)
+    {
+        for (int pos = 0; pos < total; pos += hostBlockSize)
+        {
+            float* chunk[] = { channels [0] + pos, channels [1] + pos };
+            kernel.process (chunk, chunk, 2, jmin ((int) hostBlockSize, total - pos));
+        }
+    }
+}
+
+using namespace OppressorTestHelpers;
+
+
+//==============================================================================
+class OppressorTests  : public Test::Suite
+{
+public:
+    OppressorTests()
+    {
+        TEST_ADD (OppressorTests::kernelMatchesPerSampleOppressor)
+        TEST_ADD (OppressorTests::processingDoesNotAllocate)
+    }
+
+private:
+    void kernelMatchesPerSampleOppressor()
+    {
+        HeapBlock <float> expectedLeft (numSamples), expectedRight (numSamples), left (numSamples), right (numSamples);
+        float* expected[] = { expectedLeft, expectedRight };
+        float* channels[] = { left, right };
+
+        for (int set = 0; set < numElementsInArray (parameterSets); ++set)
+        {
+            PerSampleOppressor reference (parameterSets [set]);
+            OppressorKernel kernel (2);
+            prepareKernel (kernel, parameterSets [set], 1);
+
+            fillInput (expected, numSamples);
+            fillInput (channels, numSamples);
+
+            process (reference, expected, numSamples);
+            process (kernel, channels, numSamples);
+
+            // with the parameters held still, splitting the loop doesn't change a bit
+            TEST_ASSERT_MSG (memcmp (left, expectedLeft, sizeof (float) * numSamples) == 0
+                              && memcmp (right, expectedRight, sizeof (float) * numSamples) == 0,
+                             (const char*) ("parameter set " + String (set)));
+        }
+    }
+
+    void processingDoesNotAllocate()
+    {
+        if (! canCountAllocations())
+            return;
+
+        OppressorKernel kernel (2);
+        prepareKernel (kernel, parameterSets [0], 1);
+
+        HeapBlock <float> left (numSamples), right (numSamples);
+        float* channels[] = { left, right };
+        fillInput (channels, numSamples);
+
+        const int allocationsBefore = getNumAllocations();
+
+        process (kernel, channels, numSamples);
+        prepareKernel (kernel, parameterSets [1], 4);
+        process (kernel, channels, numSamples);
+
+        TEST_ASSERT (getNumAllocations() == allocationsBefore);
+    }
+};
+
+
+//==============================================================================
+class OppressorBenchmarks  : public Test::Suite
+{
+public:
+    OppressorBenchmarks()
+    {
+        TEST_ADD (OppressorBenchmarks::perSampleAgainstKernel)
+    }
+
+private:
+    enum { total = 1 << 18, numPasses = 10, numFactors = 3 };
+
+    /** Times a few seconds of music-like input, streamed through like a track */
+    template <class OppressorType>
+    static double timeOppressor (OppressorType& oppressor, float** channels)
+    {
+        double elapsed = 0;
+
+        for (int n = 0; n < numPasses; ++n)
+        {
+            fillInput (channels, total);
+
+            const double start = getBenchmarkTime();
+            process (oppressor, channels, total);
+            elapsed += getBenchmarkTime() - start;
+        }
+
+        return elapsed;
+    }
+
+    void perSampleAgainstKernel()
+    {
+        const int factors [numFactors] = { 1, 2, 4 };
+
+        HeapBlock <float> left (total), right (total);
+        float* channels[] = { left, right };
+
+        double perSampleTime = 0, kernelTimes [numFactors];
+
+        // best of a few interleaved runs, so they all see the same machine
+        for (int run = 0; run < 3; ++run)
+        {
+            PerSampleOppressor reference (parameterSets [1]);
+            const double t = timeOppressor (reference, channels);
+            perSampleTime = (run == 0) ? t : jmin (perSampleTime, t);
+
+            for (int f = 0; f < numFactors; ++f)
+            {
+                OppressorKernel kernel (2);
+                prepareKernel (kernel, parameterSets [1], factors [f]);
+
+                const double kernelTime = timeOppressor (kernel, channels);
+                kernelTimes [f] = (run == 0) ? kernelTime : jmin (kernelTimes [f], kernelTime);
+            }
+        }
+
+        printBenchmarkResult ("oppressor, per sample", perSampleTime, (double) numPasses * total, "frames");
+
+        for (int f = 0; f < numFactors; ++f)
+            printBenchmarkResult ("oppressor, kernel, " + String (factors [f]) + "x oversampled",
+                                  kernelTimes [f], (double) numPasses * total, "frames");
+    }
+};
+
+
+//==============================================================================
+Test::Suite* createOppressorTests()
+{
+    return new OppressorTests();
+}
+
+Test::Suite* createOppressorBenchmarks()
+{
+    return new OppressorBenchmarks();
+}
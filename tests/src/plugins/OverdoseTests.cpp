@@ -0,0 +1,283 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2009 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU General Public License, as published by the Free Software Foundation;
+ either version 2 of the License, or (at your option) any later version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+
+
+#include "../TestsHeader.h"
+
+BEGIN_JUCE_NAMESPACE
+#include "extended/audio/processors/jucetice_VectorOps.h"
+#include "extended/audio/processors/jucetice_ParameterRamp.h"
+#include "extended/audio/resampler/jucetice_Oversampler.h"
+#include "../../../apps/jive/src/model/plugins/effects/OverdoseKernel.h"
+END_JUCE_NAMESPACE
+
+#include <math.h>
+
+
+//==============================================================================
+namespace OverdoseTestHelpers
+{
+    enum { sampleRate = 44100, numSamples = 65536, hostBlockSize = 300 };
+
+    /** The Overdose as it was before it worked a block at a time, one stereo
+        frame at a time with the coefficients worked out by setParameter()
+    */
+    class PerSampleOverdose
+    {
+    public:
+        PerSampleOverdose (const float* parameters)
+            : drive (parameters[0]), filt1 (0.0f), filt2 (0.0f)
+        {
+            filt = (float)pow(10.0,-1.6 * parameters[1]);
+            gainer = (float)pow(10.0f, 2.0f * parameters[2] - 1.0f);
+        }
+
+        void process (float** channels, int sampleFrames)
+        {
+            float *in1 = channels [0];
+            float *in2 = channels [1];
+            float *out1 = channels [0];
+            float *out2 = channels [1];
+
+            float a, b, c, d;
+            float i=drive, g=gainer, aa, bb;
+            float f=filt, fa=filt1, fb=filt2;
+
+            --in1;
+            --in2;
+            --out1;
+            --out2;
+            while(--sampleFrames >= 0)
+            {
+                a = *++in1;
+                b = *++in2;
+
+                aa = (a>0.0f)? (float)sqrt(a) : (float)-sqrt(-a); //overdrive
+                bb = (b>0.0f)? (float)sqrt(b) : (float)-sqrt(-b);
+
+                fa = fa + f * (i*(aa-a) + a - fa);                //filter
+                fb = fb + f * (i*(bb-b) + b - fb);
+
+                c = fa * g;
+                d = fb * g;
+
+                *++out1 = c;
+                *++out2 = d;
+            }
+
+            if(fabs(fa)>1.0e-10) filt1 = fa; else filt1 = 0.0f; //catch denormals
+            if(fabs(fb)>1.0e-10) filt2 = fb; else filt2 = 0.0f;
+        }
+
+    private:
+        float drive, filt, gainer, filt1, filt2;
+    };
+
+    /** drive, muffle and output: a bit of everything, all drive and no muffle,
+        and a heavy muffle on a light drive
+    */
+    static const float parameterSets[][3] =
+    {
+        { 0.5f, 0.3f, 0.5f },
+        { 1.0f, 0.0f, 0.6f },
+        { 0.2f, 0.8f, 0.4f }
+    };
+
+    static void prepareKernel (OverdoseKernel& kernel, const float* parameters, const int factor)
+    {
+        kernel.prepare (sampleRate, factor);
+        kernel.setParameters (parameters[0], parameters[1], parameters[2]);
+        kernel.skipRamps();
+    }
+
+    static void fillInput (float** channels, const int total)
+    {
+        for (int i = 0; i < total; ++i)
+        {
+            channels [0][i] = 0.8f * sinf (i * 0.01f) * sinf (i * 0.0001f);
+            channels [1][i] = 0.7f * sinf (i * 0.013f + 1.0f);
+        }
+    }
+
+    /** Runs stereo channels through an overdrive in place, in the blocks a host would use */
+    static void process (PerSampleOverdose& overdose, float** channels, const int total)
+    {
+        for (int pos = 0; pos < total; pos += hostBlockSize)
+        {
+            float* chunk[] = { channels [0] + pos, channels [1] + pos };
+            overdose.process (chunk, jmin ((int) hostBlockSize, total - pos));
+        }
+    }
+
+    static void process (OverdoseKernel& kernel, float** channels, const int total)
+    {
+        for (int pos = 0; pos < total; pos += hostBlockSize)
+        {
+            float* chunk[] = { channels [0] + pos, channels [1] + pos };
+            kernel.process (chunk, chunk, 2, jmin ((int) hostBlockSize, total - pos));
+        }
+    }
+}
+
+using namespace OverdoseTestHelpers;
+
+
+//==============================================================================
+class OverdoseTests  : public Test::Suite
+{
+public:
+    OverdoseTests()
+    {
+        TEST_ADD (OverdoseTests::kernelMatchesPerSampleOverdose)
+        TEST_ADD (OverdoseTests::processingDoesNotAllocate)
+    }
+
+private:
+    void kernelMatchesPerSampleOverdose()
+    {
+        HeapBlock <float> expectedLeft (numSamples), expectedRight (numSamples), left (numSamples), right (numSamples);
+        float* expected[] = { expectedLeft, expectedRight };
+        float* channels[] = { left, right };
+
+        for (int set = 0; set < numElementsInArray (parameterSets); ++set)
+        {
+            PerSampleOverdose reference (parameterSets [set]);
+            OverdoseKernel kernel (2);
+            prepareKernel (kernel, parameterSets [set], 1);
+
+            fillInput (expected, numSamples);
+            fillInput (channels, numSamples);
+
+            process (reference, expected, numSamples);
+            process (kernel, channels, numSamples);
+
+            // with the parameters held still, splitting the loop doesn't change a bit
+            TEST_ASSERT_MSG (memcmp (left, expectedLeft, sizeof (float) * numSamples) == 0
+                              && memcmp (right, expectedRight, sizeof (float) * numSamples) == 0,
+                             (const char*) ("parameter set " + String (set)));
+        }
+    }
+
+    void processingDoesNotAllocate()
+    {
+        if (! canCountAllocations())
+            return;
+
+        OverdoseKernel kernel (2);
+        prepareKernel (kernel, parameterSets [0], 1);
+
+        HeapBlock <float> left (numSamples), right (numSamples);
+        float* channels[] = { left, right };
+        fillInput (channels, numSamples);
+
+        const int allocationsBefore = getNumAllocations();
+
+        process (kernel, channels, numSamples);
+        prepareKernel (kernel, parameterSets [1], 4);
+        process (kernel, channels, numSamples);
+
+        TEST_ASSERT (getNumAllocations() == allocationsBefore);
+    }
+};
+
+
+//==============================================================================
+class OverdoseBenchmarks  : public Test::Suite
+{
+public:
+    OverdoseBenchmarks()
+    {
+        TEST_ADD (OverdoseBenchmarks::perSampleAgainstKernel)
+    }
+
+private:
+    enum { total = 1 << 18, numPasses = 10, numFactors = 3 };
+
+    /** Times a few seconds of music-like input, streamed through like a track */
+    template <class OverdoseType>
+    static double timeOverdose (OverdoseType& overdose, float** channels)
+    {
+        double elapsed = 0;
+
+        for (int n = 0; n < numPasses; ++n)
+        {
+            fillInput (channels, total);
+
+            const double start = getBenchmarkTime();
+            process (overdose, channels, total);
+            elapsed += getBenchmarkTime() - start;
+        }
+
+        return elapsed;
+    }
+
+    void perSampleAgainstKernel()
+    {
+        const int factors [numFactors] = { 1, 2, 4 };
+
+        HeapBlock <float> left (total), right (total);
+        float* channels[] = { left, right };
+
+        double perSampleTime = 0, kernelTimes [numFactors];
+
+        // best of a few interleaved runs, so they all see the same machine
+        for (int run = 0; run < 3; ++run)
+        {
+            PerSampleOverdose reference (parameterSets [0]);
+            const double t = timeOverdose (reference, channels);
+            perSampleTime = (run == 0) ? t : jmin (perSampleTime, t);
+
+            for (int f = 0; f < numFactors; ++f)
+            {
+                OverdoseKernel kernel (2);
+                prepareKernel (kernel, parameterSets [0], factors [f]);
+
+                const double kernelTime = timeOverdose (kernel, channels);
+                kernelTimes [f] = (run == 0) ? kernelTime : jmin (kernelTimes [f], kernelTime);
+            }
+        }
+
+        printBenchmarkResult ("overdose, per sample", perSampleTime, (double) numPasses * total, "frames");
+
+        for (int f = 0; f < numFactors; ++f)
+            printBenchmarkResult ("overdose, kernel, " + String (factors [f]) + "x oversampled",
+                                  kernelTimes [f], (double) numPasses * total, "frames");
+    }
+};
+
+
+//==============================================================================
+Test::Suite* createOverdoseTests()
+{
+    return new OverdoseTests();
+}
+
+Test::Suite* createOverdoseBenchmarks()
+{
+    return new OverdoseBenchmarks();
+}
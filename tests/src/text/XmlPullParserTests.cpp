@@ -0,0 +1,490 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2009 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU General Public License, as published by the Free Software Foundation;
+ either version 2 of the License, or (at your option) any later version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+
+#include "../TestsHeader.h"
+
+
+//==============================================================================
+namespace XmlPullParserTestHelpers
+{
+    /** A stream handing out a few bytes at a time, to cross every buffer boundary */
+    class TrickleInputStream  : public InputStream
+    {
+    public:
+        TrickleInputStream (const char* data_, const int size_)
+            : data (data_), size (size_), position (0)
+        {
+        }
+
+        int64 getTotalLength()                  { return size; }
+        bool isExhausted()                      { return position >= size; }
+        int64 getPosition()                     { return position; }
+        bool setPosition (int64 newPosition)    { position = (int) newPosition; return true; }
+
+        int read (void* destBuffer, int maxBytesToRead)
+        {
+            const int numBytes = jmin (maxBytesToRead, 7, size - position);
+            memcpy (destBuffer, data + position, numBytes);
+            position += numBytes;
+            return numBytes;
+        }
+
+    private:
+        const char* data;
+        int size, position;
+    };
+
+    /** Compares two trees, including the order of the attributes and of the text elements */
+    static bool areIdentical (const XmlElement* a, const XmlElement* b)
+    {
+        if (a == 0 || b == 0)
+            return a == b;
+
+        if (a->getTagName() != b->getTagName()
+             || a->getNumAttributes() != b->getNumAttributes()
+             || a->getNumChildElements() != b->getNumChildElements())
+            return false;
+
+        for (int i = 0; i < a->getNumAttributes(); ++i)
+            if (a->getAttributeName (i) != b->getAttributeName (i)
+                 || a->getAttributeValue (i) != b->getAttributeValue (i))
+                return false;
+
+        const XmlElement* childA = a->getFirstChildElement();
+        const XmlElement* childB = b->getFirstChildElement();
+
+        while (childA != 0)
+        {
+            if (! areIdentical (childA, childB))
+                return false;
+
+            childA = childA->getNextElement();
+            childB = childB->getNextElement();
+        }
+
+        return true;
+    }
+
+    //==============================================================================
+    /** Makes random documents out of the syntax where XmlDocument has its own ways */
+    class RandomDocument
+    {
+    public:
+        RandomDocument (const int seed)
+            : random (seed)
+        {
+            if (oneIn (10))
+                text << "\xef\xbb\xbf";
+
+            if (oneIn (2))
+                text << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>";
+
+            addSpaces();
+
+            if (oneIn (4))
+                text << "<!-- header -->";
+
+            if (oneIn (5))
+                text << "<!DOCTYPE doc [ <!ENTITY e \"expanded\"> <!ENTITY t \"<x a='1'/>\"> ]>";
+
+            addSpaces();
+            addElement (0);
+            addSpaces();
+
+            if (oneIn (20))
+            {
+                // cut short anywhere, even inside a tag or an entity
+                text = text.substring (0, random.nextInt (text.length()));
+            }
+        }
+
+        String text;
+
+    private:
+        Random random;
+
+        bool oneIn (const int n)    { return random.nextInt (n) == 0; }
+
+        const char* pick (const char* const* items, const int numItems)
+        {
+            return items [random.nextInt (numItems)];
+        }
+
+        void addSpaces()
+        {
+            static const char* const spaces[] = { "", "", " ", "\n", "\r\n  ", "\t", "\n\n    " };
+            text << pick (spaces, numElementsInArray (spaces));
+        }
+
+        void addCharacters (const bool isAttribute)
+        {
+            static const char* const pieces[] = { "a", "text", " ", "  ", "\n", "\t", "x y", "\xc3\xa9",
+                                                  "&amp;", "&lt;", "&GT;", "&quot;", "&apos;", "&#65;", "&#x42;",
+                                                  "&#32;", "&#x9;", "&e;", "&t;", "&unknown;", "& ", "&#12a;",
+                                                  "&#x;", "&#0;", "&#x110000;", ">", "]]", "'", "\"" };
+
+            const int numPieces = random.nextInt (5);
+
+            for (int i = 0; i < numPieces; ++i)
+            {
+                const String piece (String::fromUTF8 ((const uint8*) pick (pieces, numElementsInArray (pieces))));
+
+                if (isAttribute && (piece == T("'") || piece == T("\"")))
+                    continue;
+
+                text << piece;
+            }
+        }
+
+        void addElement (const int depth)
+        {
+            static const char* const names[] = { "a", "b", "PLUGIN", "x:y", "na-me.1", "\xc3\xa9t\xc3\xa9" };
+            const String name (String::fromUTF8 ((const uint8*) pick (names, numElementsInArray (names))));
+
+            text << "<" << name;
+
+            const int numAttributes = random.nextInt (4);
+
+            for (int i = 0; i < numAttributes; ++i)
+            {
+                text << (oneIn (8) ? "" : " ") << "att" << i;
+
+                if (oneIn (6))
+                    text << " ";
+
+                text << "=";
+
+                if (oneIn (6))
+                    text << " ";
+
+                if (oneIn (25))
+                {
+                    // unquoted, which XmlDocument stops reading the tag at
+                    text << "unquoted";
+                }
+                else
+                {
+                    const char* const quote = oneIn (3) ? "'" : "\"";
+                    text << quote;
+                    addCharacters (true);
+                    text << quote;
+                }
+            }
+
+            if (oneIn (5))
+            {
+                text << (oneIn (2) ? "/>" : " />");
+                return;
+            }
+
+            text << ">";
+
+            const int numChildren = depth < 4 ? random.nextInt (6) : 0;
+
+            for (int i = 0; i < numChildren; ++i)
+            {
+                switch (random.nextInt (7))
+                {
+                    case 0:     addElement (depth + 1); break;
+                    case 1:     text << "<![CDATA[" << (oneIn (2) ? " <raw> &amp; " : "") << "]]>"; break;
+                    case 2:     text << "<!-- a comment -->"; break;
+                    case 3:     text << "<?pi data?>"; break;
+                    case 4:     addSpaces(); break;
+                    default:    addCharacters (false); break;
+                }
+            }
+
+            text << "</" << (oneIn (40) ? String ("wrong") : name) << ">";
+        }
+    };
+
+    /** Parses a document both ways and returns true if the trees are the same */
+    static bool parsesLikeXmlDocument (const String& document, const bool ignoreEmptyTextElements, const bool useStream)
+    {
+        const int numBytes = document.copyToUTF8 (0) - 1;
+        HeapBlock <char> utf8 (numBytes + 1);
+        document.copyToUTF8 ((uint8*) (char*) utf8, numBytes + 1);
+
+        XmlDocument xmlDocument (String::fromUTF8 ((const uint8*) (char*) utf8, numBytes));
+        xmlDocument.setEmptyTextElementsIgnored (ignoreEmptyTextElements);
+        const ScopedPointer <XmlElement> expected (xmlDocument.getDocumentElement());
+
+        TrickleInputStream stream (utf8, numBytes);
+        ScopedPointer <XmlPullParser> parser (useStream ? new XmlPullParser (&stream, false)
+                                                        : new XmlPullParser (utf8, numBytes));
+        parser->setEmptyTextElementsIgnored (ignoreEmptyTextElements);
+        const ScopedPointer <XmlElement> result (parser->readDocumentElement());
+
+        return areIdentical (expected, result)
+                && (result != 0 || parser->getLastParseError().isNotEmpty());
+    }
+
+    //==============================================================================
+    /** Makes a session-like tree, 1200 plugins give about 10000 nodes */
+    static XmlElement* createSession (const int numPlugins)
+    {
+        XmlElement* const session = new XmlElement (T("JOSTSESSION"));
+        XmlElement* const track = new XmlElement (T("TRACK"));
+        session->addChildElement (track);
+
+        for (int i = 0; i < numPlugins; ++i)
+        {
+            XmlElement* const plugin = new XmlElement (T("PLUGIN"));
+            plugin->setAttribute (T("id"), i);
+            plugin->setAttribute (T("name"), String ("Plugin <") + String (i) + "> & \"co\" " + String::charToString (0xe9));
+            plugin->setAttribute (T("x"), i * 0.5);
+            plugin->setAttribute (T("gain"), 0.75);
+            plugin->setAttribute (T("muted"), i & 1);
+
+            for (int j = 0; j < 8; ++j)
+            {
+                XmlElement* const parameter = new XmlElement (T("PARAM"));
+                parameter->setAttribute (T("index"), j);
+                parameter->setAttribute (T("value"), j / 7.0);
+                plugin->addChildElement (parameter);
+            }
+
+            if (i % 100 == 0)
+                plugin->addTextElement (T("some text\nwith lines & <stuff>"));
+
+            track->addChildElement (plugin);
+        }
+
+        return session;
+    }
+
+    static int countNodes (const XmlElement* e)
+    {
+        int total = 1;
+
+        forEachXmlChildElement (*e, child)
+            total += countNodes (child);
+
+        return total;
+    }
+}
+
+using namespace XmlPullParserTestHelpers;
+
+
+//==============================================================================
+class XmlPullParserTests  : public Test::Suite
+{
+public:
+    XmlPullParserTests()
+    {
+        TEST_ADD (XmlPullParserTests::randomDocumentsMatchXmlDocument)
+        TEST_ADD (XmlPullParserTests::writtenSessionsReadBackTheSame)
+        TEST_ADD (XmlPullParserTests::leadingTextWhiteSpaceIsDropped)
+        TEST_ADD (XmlPullParserTests::unterminatedCloseTagIsAnError)
+    }
+
+private:
+    void randomDocumentsMatchXmlDocument()
+    {
+        int numDifferent = 0;
+        String firstDifferent;
+
+        for (int i = 0; i < 3000; ++i)
+        {
+            const RandomDocument document (i);
+
+            if (! parsesLikeXmlDocument (document.text, (i & 1) == 0, (i & 2) != 0))
+                if (numDifferent++ == 0)
+                    firstDifferent = document.text;
+        }
+
+        TEST_ASSERT_MSG (numDifferent == 0, (const char*) (String (numDifferent) + " different, like: " + firstDifferent));
+    }
+
+    void writtenSessionsReadBackTheSame()
+    {
+        const ScopedPointer <XmlElement> session (createSession (200));
+
+        for (int allOnOneLine = 0; allOnOneLine < 2; ++allOnOneLine)
+        {
+            MemoryOutputStream output;
+
+            {
+                XmlStreamWriter writer (output, allOnOneLine != 0);
+                writer.writeHeader();
+                writer.writeElement (*session);
+            }
+
+            XmlPullParser parser (output.getData(), (int) output.getDataSize());
+            const ScopedPointer <XmlElement> result (parser.readDocumentElement());
+
+            // indenting adds whitespace after the text elements, so only the single line version reads back exactly
+            TEST_ASSERT (allOnOneLine == 0 || areIdentical (session, result));
+            TEST_ASSERT (parsesLikeXmlDocument (String::fromUTF8 ((const uint8*) output.getData(), (int) output.getDataSize()), true, true));
+        }
+    }
+
+    void leadingTextWhiteSpaceIsDropped()
+    {
+        const char* const document = "<a>  \n  first  <b/>&#32;second<!-- c -->\n  third  </a>";
+
+        XmlPullParser parser (document, (int) strlen (document));
+        const ScopedPointer <XmlElement> result (parser.readDocumentElement());
+
+        TEST_ASSERT (result != 0 && result->getNumChildElements() == 4);
+
+        if (result != 0 && result->getNumChildElements() == 4)
+        {
+            TEST_ASSERT (result->getChildElement (0)->getText() == T("first  "));
+            TEST_ASSERT (result->getChildElement (2)->getText() == T(" second"));
+            TEST_ASSERT (result->getChildElement (3)->getText() == T("third  "));
+        }
+    }
+
+    void unterminatedCloseTagIsAnError()
+    {
+        const char* const document = "<a><b></b></a";
+
+        XmlPullParser parser (document, (int) strlen (document));
+        const ScopedPointer <XmlElement> result (parser.readDocumentElement());
+
+        TEST_ASSERT (result == 0 && parser.getLastParseError().isNotEmpty());
+        TEST_ASSERT (parsesLikeXmlDocument (document, true, false));
+    }
+};
+
+
+//==============================================================================
+class XmlPullParserBenchmarks  : public Test::Suite
+{
+public:
+    XmlPullParserBenchmarks()
+    {
+        TEST_ADD (XmlPullParserBenchmarks::parseSession)
+        TEST_ADD (XmlPullParserBenchmarks::writeSession)
+    }
+
+private:
+    enum { numPasses = 10 };
+
+    void parseSession()
+    {
+        const ScopedPointer <XmlElement> session (createSession (1200));
+        const int numNodes = countNodes (session);
+
+        MemoryOutputStream output;
+
+        {
+            XmlStreamWriter writer (output);
+            writer.writeHeader();
+            writer.writeElement (*session);
+        }
+
+        const char* const data = (const char*) output.getData();
+        const int numBytes = (int) output.getDataSize();
+
+        double start = getBenchmarkTime();
+
+        for (int i = 0; i < numPasses; ++i)
+        {
+            XmlDocument document (String::fromUTF8 ((const uint8*) data, numBytes));
+            const ScopedPointer <XmlElement> result (document.getDocumentElement());
+            TEST_ASSERT (result != 0);
+        }
+
+        const double documentTime = getBenchmarkTime() - start;
+        start = getBenchmarkTime();
+
+        for (int i = 0; i < numPasses; ++i)
+        {
+            XmlPullParser parser (data, numBytes);
+            const ScopedPointer <XmlElement> result (parser.readDocumentElement());
+            TEST_ASSERT (result != 0);
+        }
+
+        const double treeTime = getBenchmarkTime() - start;
+        start = getBenchmarkTime();
+        int total = 0;
+
+        for (int i = 0; i < numPasses; ++i)
+        {
+            XmlPullParser parser (data, numBytes);
+
+            while (parser.next() != XmlPullParser::endOfDocument)
+                if (parser.getTokenType() == XmlPullParser::startElement)
+                    total += parser.getIntAttribute (T("index")) + parser.getIntAttribute (T("id"));
+        }
+
+        const double pullTime = getBenchmarkTime() - start;
+        TEST_ASSERT (total > 0);
+
+        const String nodes (" (" + String (numNodes) + " nodes)");
+        printBenchmarkResult ((const char*) ("XmlDocument to tree" + nodes), documentTime, numPasses * numNodes, "nodes");
+        printBenchmarkResult ((const char*) ("XmlPullParser to tree" + nodes), treeTime, numPasses * numNodes, "nodes");
+        printBenchmarkResult ((const char*) ("XmlPullParser tokens only" + nodes), pullTime, numPasses * numNodes, "nodes");
+    }
+
+    void writeSession()
+    {
+        const ScopedPointer <XmlElement> session (createSession (1200));
+        const int numNodes = countNodes (session);
+
+        double start = getBenchmarkTime();
+
+        for (int i = 0; i < numPasses; ++i)
+        {
+            const String text (session->createDocument (String::empty));
+            TEST_ASSERT (text.isNotEmpty());
+        }
+
+        const double documentTime = getBenchmarkTime() - start;
+        start = getBenchmarkTime();
+
+        for (int i = 0; i < numPasses; ++i)
+        {
+            MemoryOutputStream output (65536, 65536);
+            XmlStreamWriter writer (output);
+            writer.writeHeader();
+            writer.writeElement (*session);
+        }
+
+        const double writerTime = getBenchmarkTime() - start;
+
+        const String nodes (" (" + String (numNodes) + " nodes)");
+        printBenchmarkResult ((const char*) ("XmlElement::createDocument" + nodes), documentTime, numPasses * numNodes, "nodes");
+        printBenchmarkResult ((const char*) ("XmlStreamWriter" + nodes), writerTime, numPasses * numNodes, "nodes");
+    }
+};
+
+
+//==============================================================================
+Test::Suite* createXmlPullParserTests()
+{
+    return new XmlPullParserTests();
+}
+
+Test::Suite* createXmlPullParserBenchmarks()
+{
+    return new XmlPullParserBenchmarks();
+}
@@ -0,0 +1,220 @@
+/*
+ ==============================================================================
+
+ This file is part of the JUCETICE project - Copyright 2009 by Lucio Asnaghi.
+
+ JUCETICE is based around the JUCE library - "Jules' Utility Class Extensions"
+ Copyright 2007 by Julian Storer.
+
+ ------------------------------------------------------------------------------
+
+ JUCE and JUCETICE can be redistributed and/or modified under the terms of
+ the GNU General Public License, as published by the Free Software Foundation;
+ either version 2 of the License, or (at your option) any later version.
+
+ JUCE and JUCETICE are distributed in the hope that they will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with JUCE and JUCETICE; if not, visit www.gnu.org/licenses or write to
+ Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ Boston, MA 02111-1307 USA
+
+ ==============================================================================
+*/
+
+
+#include "../TestsHeader.h"
+
+#if JUCE_LINUX
+ #include <sys/mman.h>
+#endif
+
+
+//==============================================================================
+namespace RealtimePolicyTestHelpers
+{
+    /** A thread that takes a role and reads back what the kernel gave it */
+    class RoleThread  : public Thread
+    {
+    public:
+        RoleThread (const RealtimePolicy::ThreadRole role_)
+            : Thread ("realtime policy test"),
+              role (role_), applied (false), isRealtime (false), priority (-1), affinityMask (0)
+        {
+        }
+
+        void run()
+        {
+            applied = RealtimePolicy::applyToCurrentThread (role);
+            RealtimePolicy::getCurrentThreadScheduling (isRealtime, priority, affinityMask);
+        }
+
+        void runAndWait()
+        {
+            startThread();
+            waitForThreadToExit (-1);
+        }
+
+        const RealtimePolicy::ThreadRole role;
+        bool applied, isRealtime;
+        int priority;
+        uint32 affinityMask;
+    };
+
+    /** Puts the policy back as the tests found it */
+    class ScopedPolicy
+    {
+    public:
+        ScopedPolicy()
+        {
+            for (int i = 0; i < RealtimePolicy::numThreadRoles; ++i)
+            {
+                priorities [i] = RealtimePolicy::getRolePriority ((RealtimePolicy::ThreadRole) i);
+                affinities [i] = RealtimePolicy::getRoleAffinity ((RealtimePolicy::ThreadRole) i);
+            }
+
+            wasEnabled = RealtimePolicy::isEnabled();
+        }
+
+        ~ScopedPolicy()
+        {
+            for (int i = 0; i < RealtimePolicy::numThreadRoles; ++i)
+            {
+                RealtimePolicy::setRolePriority ((RealtimePolicy::ThreadRole) i, priorities [i]);
+                RealtimePolicy::setRoleAffinity ((RealtimePolicy::ThreadRole) i, affinities [i]);
+            }
+
+            RealtimePolicy::setEnabled (wasEnabled);
+        }
+
+    private:
+        int priorities [RealtimePolicy::numThreadRoles];
+        uint32 affinities [RealtimePolicy::numThreadRoles];
+        bool wasEnabled;
+    };
+
+    static bool hasRejection (const String& start)
+    {
+        const StringArray rejected (RealtimePolicy::getRejectedPolicies());
+
+        for (int i = 0; i < rejected.size(); ++i)
+            if (rejected [i].startsWith (start))
+                return true;
+
+        return false;
+    }
+}
+
+using namespace RealtimePolicyTestHelpers;
+
+
+//==============================================================================
+class RealtimePolicyTests  : public Test::Suite
+{
+public:
+    RealtimePolicyTests()
+    {
+        TEST_ADD (RealtimePolicyTests::disabledPolicyChangesNothing)
+        TEST_ADD (RealtimePolicyTests::rolesGetTheirScheduling)
+        TEST_ADD (RealtimePolicyTests::rejectionsAreReportedOnce)
+        TEST_ADD (RealtimePolicyTests::memoryGetsLockedOrReported)
+    }
+
+private:
+    void disabledPolicyChangesNothing()
+    {
+        ScopedPolicy restore;
+        RealtimePolicy::setEnabled (false);
+        RealtimePolicy::setRolePriority (RealtimePolicy::audioThread, 70);
+
+        RoleThread thread (RealtimePolicy::audioThread);
+        thread.runAndWait();
+
+        TEST_ASSERT (thread.applied);
+        TEST_ASSERT (! thread.isRealtime);
+        TEST_ASSERT (thread.priority == 0);
+        TEST_ASSERT (thread.affinityMask != 0);
+    }
+
+    void rolesGetTheirScheduling()
+    {
+        ScopedPolicy restore;
+        RealtimePolicy::setRolePriority (RealtimePolicy::audioThread, 70);
+        RealtimePolicy::setRoleAffinity (RealtimePolicy::audioThread, 1);
+        RealtimePolicy::setRolePriority (RealtimePolicy::diskThread, 40);
+        RealtimePolicy::setRolePriority (RealtimePolicy::midiInputThread, 75);
+        RealtimePolicy::setRolePriority (RealtimePolicy::guiThread, 0);
+        RealtimePolicy::setEnabled (true);
+
+        const RealtimePolicy::ThreadRole roles[] = { RealtimePolicy::audioThread, RealtimePolicy::diskThread,
+                                                     RealtimePolicy::midiInputThread, RealtimePolicy::guiThread };
+
+        for (int i = 0; i < numElementsInArray (roles); ++i)
+        {
+            RoleThread thread (roles [i]);
+            thread.runAndWait();
+
+            const int wanted = RealtimePolicy::getRolePriority (roles [i]);
+            const String name (RealtimePolicy::getRoleName (roles [i]));
+
+            if (thread.applied)
+            {
+                // what the kernel really set, read back from the thread itself
+                TEST_ASSERT_MSG (thread.isRealtime == (wanted > 0), (const char*) name);
+                TEST_ASSERT_MSG (thread.priority == wanted, (const char*) (name + " got " + String (thread.priority)));
+
+                if (RealtimePolicy::getRoleAffinity (roles [i]) != 0)
+                    TEST_ASSERT_MSG (thread.affinityMask == RealtimePolicy::getRoleAffinity (roles [i]), (const char*) name);
+            }
+            else
+            {
+                // without the rights, each refusal must be there for the user to see
+                TEST_ASSERT_MSG (hasRejection (name + T(": ")), (const char*) name);
+                TEST_ASSERT (! thread.isRealtime);
+            }
+        }
+    }
+
+    void rejectionsAreReportedOnce()
+    {
+        ScopedPolicy restore;
+        RealtimePolicy::setRolePriority (RealtimePolicy::audioThread, 70);
+        RealtimePolicy::setEnabled (true);
+
+        RoleThread first (RealtimePolicy::audioThread);
+        first.runAndWait();
+
+        const int numRejected = RealtimePolicy::getRejectedPolicies().size();
+
+        RoleThread second (RealtimePolicy::audioThread);
+        second.runAndWait();
+
+        TEST_ASSERT (second.applied == first.applied);
+        TEST_ASSERT (RealtimePolicy::getRejectedPolicies().size() == numRejected);
+    }
+
+    void memoryGetsLockedOrReported()
+    {
+        if (RealtimePolicy::lockMemory (1024 * 1024))
+        {
+#if JUCE_LINUX
+            // the rest of the tests don't need it
+            munlockall();
+#endif
+        }
+        else
+        {
+            TEST_ASSERT (hasRejection (T("memory: mlockall")));
+        }
+    }
+};
+
+
+//==============================================================================
+Test::Suite* createRealtimePolicyTests()
+{
+    return new RealtimePolicyTests();
+}